@@ -0,0 +1,399 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "analysis.h"
+
+// See analysis.h for what this is for.
+//
+// HOW THE TRANSFORM IS DONE. N real samples are packed into N / 2 complex ones — even samples as the
+// real part, odd as the imaginary — and put through a complex FFT of half the size, which is then split
+// back into the spectrum of the real input. That halves the work against transforming N complex values
+// with zero imaginary parts, and is where most of a real FFT's advantage comes from.
+//
+// The complex FFT is Stockham's autosort form, radix 4, decimation in frequency, with one radix-2 stage
+// at the end when the size is an odd power of two. Autosort means each stage reads one buffer and
+// writes the other, and the result comes out in natural order, with no bit-reversal pass. Radix 4 does
+// a quarter fewer multiplies than radix 2 and half as many passes over memory. In every stage after the
+// first the inner loop runs along contiguous elements of the separate real and imaginary arrays, the
+// shape a compiler turns into vector code without being asked.
+
+#define ANALYSIS_TWO_PI    (6.283185307179586476925286766559)
+
+static float * alloc_floats(uint32_t count) {
+    return (float *)calloc((size_t)count, sizeof(float));
+}
+
+void analysis_fft_free(tAnalysisFft * fft) {
+    if (fft == NULL) {
+        return;
+    }
+    free(fft->window);
+    free(fft->twiddleRe);
+    free(fft->twiddleIm);
+    free(fft->splitRe);
+    free(fft->splitIm);
+    free(fft->spectrumIm);
+
+    for (uint32_t b = 0; b < 2; b++) {
+        free(fft->workRe[b]);
+        free(fft->workIm[b]);
+    }
+    memset(fft, 0, sizeof(*fft));
+}
+
+bool analysis_fft_init(tAnalysisFft * fft, uint32_t size, tAnalysisWindow window) {
+    uint32_t half = size / 2;
+    double   sum  = 0.0;
+
+    memset(fft, 0, sizeof(*fft));
+
+    if ((size < ANALYSIS_FFT_MIN) || (size > ANALYSIS_FFT_MAX) || ((size & (size - 1)) != 0)) {
+        return false;
+    }
+    fft->size       = size;
+    fft->bins       = half + 1;
+    fft->window     = alloc_floats(size);
+    fft->twiddleRe  = alloc_floats(half);
+    fft->twiddleIm  = alloc_floats(half);
+    fft->splitRe    = alloc_floats(half + 1);
+    fft->splitIm    = alloc_floats(half + 1);
+    fft->spectrumIm = alloc_floats(half + 1);
+
+    for (uint32_t b = 0; b < 2; b++) {
+        fft->workRe[b] = alloc_floats(half);
+        fft->workIm[b] = alloc_floats(half);
+    }
+
+    if (  (fft->window == NULL) || (fft->twiddleRe == NULL) || (fft->twiddleIm == NULL)
+       || (fft->splitRe == NULL) || (fft->splitIm == NULL) || (fft->spectrumIm == NULL)
+       || (fft->workRe[0] == NULL) || (fft->workIm[0] == NULL)
+       || (fft->workRe[1] == NULL) || (fft->workIm[1] == NULL)) {
+        analysis_fft_free(fft);
+        return false;
+    }
+
+    // Tables in double, stored as float: worked out from the angle each time rather than by repeated
+    // rotation, so a 32k table is as accurate at its end as at its start.
+    for (uint32_t k = 0; k < half; k++) {
+        double angle = -ANALYSIS_TWO_PI * (double)k / (double)half;
+
+        fft->twiddleRe[k] = (float)cos(angle);
+        fft->twiddleIm[k] = (float)sin(angle);
+    }
+
+    for (uint32_t k = 0; k <= half; k++) {
+        double angle = -ANALYSIS_TWO_PI * (double)k / (double)size;
+
+        fft->splitRe[k] = (float)cos(angle);
+        fft->splitIm[k] = (float)sin(angle);
+    }
+
+    // Periodic windows — the form for spectral analysis, where the frame is one period of something
+    // that repeats, rather than the symmetric form a filter design uses.
+    for (uint32_t i = 0; i < size; i++) {
+        double x = ANALYSIS_TWO_PI * (double)i / (double)size;
+        double w = 1.0;
+
+        switch (window) {
+            case eAnalysisWindowHann: {
+                w = 0.5 - (0.5 * cos(x));
+                break;
+            }
+            case eAnalysisWindowBlackmanHarris: {
+                w = 0.35875 - (0.48829 * cos(x)) + (0.14128 * cos(2.0 * x)) - (0.01168 * cos(3.0 * x));
+                break;
+            }
+            default: {
+                w = 1.0;
+                break;
+            }
+        }
+        fft->window[i] = (float)w;
+        sum           += w;
+    }
+    fft->coherentGain = (float)(sum / (double)size);
+
+    return true;
+}
+
+// The half-size complex transform, on workRe/Im[0]. Returns the buffer index the result ended up in.
+static uint32_t fft_complex(tAnalysisFft * fft) {
+    const uint32_t count  = fft->size / 2;
+    const float *  wRe    = fft->twiddleRe;
+    const float *  wIm    = fft->twiddleIm;
+    uint32_t       from   = 0;
+    uint32_t       n      = count;    // the length of each sub-transform at this stage
+    uint32_t       stride = 1;        // how many of them are interleaved: n * stride == count throughout
+
+    // RADIX-4 STAGES. Sub-transform q of length n is x[q + stride * p], p = 0 .. n - 1. One stage
+    // splits each into four of length n / 4, twiddled by W_n^p = W_count^(p * stride), and writes them
+    // out already in the order the next stage wants.
+    while (n >= 4) {
+        const uint32_t quarter = n / 4;
+        const float *  xr      = fft->workRe[from];
+        const float *  xi      = fft->workIm[from];
+        float *        yr      = fft->workRe[from ^ 1U];
+        float *        yi      = fft->workIm[from ^ 1U];
+
+        for (uint32_t p = 0; p < quarter; p++) {
+            const float w1r = wRe[p * stride];
+            const float w1i = wIm[p * stride];
+            const float w2r = wRe[2 * p * stride];
+            const float w2i = wIm[2 * p * stride];
+            const float w3r = wRe[3 * p * stride];
+            const float w3i = wIm[3 * p * stride];
+            const float * ar = xr + (stride * p);
+            const float * ai = xi + (stride * p);
+            const float * br = ar + (stride * quarter);
+            const float * bi = ai + (stride * quarter);
+            const float * cr = br + (stride * quarter);
+            const float * ci = bi + (stride * quarter);
+            const float * dr = cr + (stride * quarter);
+            const float * di = ci + (stride * quarter);
+            float *       y0r = yr + (stride * 4 * p);
+            float *       y0i = yi + (stride * 4 * p);
+            float *       y1r = y0r + stride;
+            float *       y1i = y0i + stride;
+            float *       y2r = y1r + stride;
+            float *       y2i = y1i + stride;
+            float *       y3r = y2r + stride;
+            float *       y3i = y2i + stride;
+
+            for (uint32_t q = 0; q < stride; q++) {
+                const float apcR = ar[q] + cr[q];
+                const float apcI = ai[q] + ci[q];
+                const float amcR = ar[q] - cr[q];
+                const float amcI = ai[q] - ci[q];
+                const float bpdR = br[q] + dr[q];
+                const float bpdI = bi[q] + di[q];
+                // -j (b - d): the forward transform's quarter turn.
+                const float jbmdR = bi[q] - di[q];
+                const float jbmdI = dr[q] - br[q];
+                const float s1R   = amcR + jbmdR;
+                const float s1I   = amcI + jbmdI;
+                const float s2R   = apcR - bpdR;
+                const float s2I   = apcI - bpdI;
+                const float s3R   = amcR - jbmdR;
+                const float s3I   = amcI - jbmdI;
+
+                y0r[q] = apcR + bpdR;
+                y0i[q] = apcI + bpdI;
+                y1r[q] = (s1R * w1r) - (s1I * w1i);
+                y1i[q] = (s1R * w1i) + (s1I * w1r);
+                y2r[q] = (s2R * w2r) - (s2I * w2i);
+                y2i[q] = (s2R * w2i) + (s2I * w2r);
+                y3r[q] = (s3R * w3r) - (s3I * w3i);
+                y3i[q] = (s3R * w3i) + (s3I * w3r);
+            }
+        }
+        n      /= 4;
+        stride *= 4;
+        from   ^= 1U;
+    }
+
+    // A LAST RADIX-2 STAGE for an odd power of two: the twiddle is 1 by now.
+    if (n == 2) {
+        const float * xr = fft->workRe[from];
+        const float * xi = fft->workIm[from];
+        float *       yr = fft->workRe[from ^ 1U];
+        float *       yi = fft->workIm[from ^ 1U];
+
+        for (uint32_t q = 0; q < stride; q++) {
+            yr[q]          = xr[q] + xr[q + stride];
+            yi[q]          = xi[q] + xi[q + stride];
+            yr[q + stride] = xr[q] - xr[q + stride];
+            yi[q + stride] = xi[q] - xi[q + stride];
+        }
+        from ^= 1U;
+    }
+
+    return from;
+}
+
+// Packs, transforms and splits. window may be NULL.
+static void fft_real(tAnalysisFft * fft, const float * in, uint32_t stride, const float * window, float * re, float * im) {
+    const uint32_t half = fft->size / 2;
+    float *        zr   = fft->workRe[0];
+    float *        zi   = fft->workIm[0];
+    uint32_t       from = 0;
+
+    if (window == NULL) {
+        for (uint32_t k = 0; k < half; k++) {
+            zr[k] = in[(2 * k) * stride];
+            zi[k] = in[((2 * k) + 1) * stride];
+        }
+    } else {
+        for (uint32_t k = 0; k < half; k++) {
+            zr[k] = in[(2 * k) * stride] * window[2 * k];
+            zi[k] = in[((2 * k) + 1) * stride] * window[(2 * k) + 1];
+        }
+    }
+    from = fft_complex(fft);
+    zr   = fft->workRe[from];
+    zi   = fft->workIm[from];
+
+    // THE SPLIT. With Z the transform of the packed input, E and O those of the even and odd samples:
+    //     E[k] = (Z[k] + conj Z[M - k]) / 2,    O[k] = -j (Z[k] - conj Z[M - k]) / 2
+    // and the real input's transform is X[k] = E[k] + W_N^k O[k], for k = 0 .. M with Z[M] = Z[0].
+    for (uint32_t k = 0; k <= half; k++) {
+        const uint32_t a  = (k == half) ? 0 : k;
+        const uint32_t b  = (k == 0) ? 0 : (half - k);
+        const float    er = 0.5f * (zr[a] + zr[b]);
+        const float    ei = 0.5f * (zi[a] - zi[b]);
+        const float    dr = 0.5f * (zi[a] + zi[b]);
+        const float    di = 0.5f * (zr[b] - zr[a]);
+
+        re[k] = er + ((fft->splitRe[k] * dr) - (fft->splitIm[k] * di));
+        im[k] = ei + ((fft->splitRe[k] * di) + (fft->splitIm[k] * dr));
+    }
+}
+
+void analysis_fft_real(tAnalysisFft * fft, const float * in, uint32_t stride, float * re, float * im) {
+    fft_real(fft, in, stride, NULL, re, im);
+}
+
+void analysis_spectrum_db(tAnalysisFft * fft, const float * in, uint32_t stride, float * db) {
+    const uint32_t half  = fft->size / 2;
+    // A full-scale sine puts N / 2 times its amplitude in its bin, times the window's mean; DC and
+    // Nyquist have no mirror image and get all N.
+    const float    scale = 2.0f / ((float)fft->size * fft->coherentGain);
+    float *        re    = db;    // the real parts go through db[] on their way to being levels
+    float *        im    = fft->spectrumIm;
+
+    fft_real(fft, in, stride, fft->window, re, im);
+
+    for (uint32_t k = 0; k <= half; k++) {
+        float mag = sqrtf((re[k] * re[k]) + (im[k] * im[k])) * scale;
+        float lvl = 0.0f;
+
+        if ((k == 0) || (k == half)) {
+            mag *= 0.5f;
+        }
+        lvl   = (mag > 0.0f) ? (20.0f * log10f(mag)) : ANALYSIS_FLOOR_DB;
+        db[k] = (lvl > ANALYSIS_FLOOR_DB) ? lvl : ANALYSIS_FLOOR_DB;
+    }
+}
+
+bool analysis_peak_hold_init(tAnalysisPeakHold * hold, uint32_t bins, float holdSeconds, float fallDbPerSecond) {
+    memset(hold, 0, sizeof(*hold));
+    hold->level   = alloc_floats(bins);
+    hold->holding = alloc_floats(bins);
+
+    if ((hold->level == NULL) || (hold->holding == NULL)) {
+        analysis_peak_hold_free(hold);
+        return false;
+    }
+    hold->bins            = bins;
+    hold->holdSeconds     = holdSeconds;
+    hold->fallDbPerSecond = fallDbPerSecond;
+
+    for (uint32_t k = 0; k < bins; k++) {
+        hold->level[k] = ANALYSIS_FLOOR_DB;
+    }
+
+    return true;
+}
+
+void analysis_peak_hold_free(tAnalysisPeakHold * hold) {
+    if (hold == NULL) {
+        return;
+    }
+    free(hold->level);
+    free(hold->holding);
+    memset(hold, 0, sizeof(*hold));
+}
+
+void analysis_peak_hold_update(tAnalysisPeakHold * hold, const float * db, float seconds) {
+    for (uint32_t k = 0; k < hold->bins; k++) {
+        if (db[k] >= hold->level[k]) {
+            hold->level[k]   = db[k];
+            hold->holding[k] = hold->holdSeconds;
+        } else if (hold->holding[k] > 0.0f) {
+            hold->holding[k] -= seconds;
+        } else {
+            hold->level[k] -= hold->fallDbPerSecond * seconds;
+
+            if (hold->level[k] < db[k]) {
+                hold->level[k] = db[k];
+            }
+        }
+    }
+}
+
+uint32_t analysis_find_peaks(const float * db, uint32_t bins, float binHz, float floorDb,
+                             tAnalysisPeak * peaks, uint32_t maxPeaks) {
+    uint32_t found = 0;
+
+    if (maxPeaks == 0) {
+        return 0;
+    }
+
+    for (uint32_t k = 1; (k + 1) < bins; k++) {
+        tAnalysisPeak peak  = {0};
+        float         a     = db[k - 1];
+        float         b     = db[k];
+        float         c     = db[k + 1];
+        float         curve = a - (2.0f * b) + c;
+        float         delta = 0.0f;
+        uint32_t      at    = 0;
+
+        if ((b <= floorDb) || (b < a) || (b <= c)) {
+            continue;
+        }
+
+        // The parabola through the three levels, and its vertex: within half a bin of k.
+        if (curve < 0.0f) {
+            delta = 0.5f * (a - c) / curve;
+        }
+        peak.hz = ((float)k + delta) * binHz;
+        peak.db = b - (0.25f * (a - c) * delta);
+
+        // Kept sorted, loudest first: an insertion into a list of at most maxPeaks.
+        at = (found < maxPeaks) ? found : maxPeaks;
+
+        while ((at > 0) && (peaks[at - 1].db < peak.db)) {
+            if (at < maxPeaks) {
+                peaks[at] = peaks[at - 1];
+            }
+            at--;
+        }
+
+        if (at < maxPeaks) {
+            peaks[at] = peak;
+
+            if (found < maxPeaks) {
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,106 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ANALYSIS_H__
+#define __ANALYSIS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// SPECTRA OF WHAT THE ENGINE IS PLAYING.
+//
+// The reading end of the engine's analysis tap (sound_engine_analysis_read() in soundEngine.h): a real
+// FFT, a window, a peak hold and a peak finder. Nothing in here knows about the engine, so the same
+// code serves the UI, a headless render and tools/fftbench.c, which checks it against sines of known
+// frequency and level.
+//
+// None of it is for the audio thread. analysis_fft_init() allocates; everything else works in the
+// buffers it set up and is as fast as the compiler can make a plain loop — the butterflies run over
+// separate real and imaginary arrays, contiguous in the inner loop, which is the layout that
+// auto-vectorises. One tAnalysisFft per caller: it carries its own scratch.
+//
+// Levels are in dB relative to full scale, with the window's gain taken out, so a full-scale sine reads
+// 0 dB at its frequency whatever the window and the size.
+
+typedef enum {
+    eAnalysisWindowRect = 0,       // no window: exact for a sine on a bin, a smear for anything else
+    eAnalysisWindowHann,           // the general-purpose choice
+    eAnalysisWindowBlackmanHarris  // 4-term, side lobes below -92 dB, for looking at a noise floor
+} tAnalysisWindow;
+
+#define ANALYSIS_FFT_MIN     (16U)
+#define ANALYSIS_FFT_MAX     (1U << 20)
+#define ANALYSIS_FLOOR_DB    (-200.0f)    // what a bin with nothing in it reads
+
+typedef struct {
+    uint32_t size;         // N real samples in, a power of two
+    uint32_t bins;         // N / 2 + 1 out, DC to Nyquist
+    float    coherentGain; // the window's mean, taken out of every level
+    float *  window;       // [size]
+    float *  twiddleRe;    // W_M^k for the half-size complex transform, [size / 2]
+    float *  twiddleIm;
+    float *  splitRe;      // W_N^k for splitting its result into the real one, [size / 2 + 1]
+    float *  splitIm;
+    float *  workRe[2];    // Stockham ping-pong, [size / 2] each
+    float *  workIm[2];
+    float *  spectrumIm;   // analysis_spectrum_db()'s imaginary parts, [size / 2 + 1]
+} tAnalysisFft;
+
+// size must be a power of two from ANALYSIS_FFT_MIN to ANALYSIS_FFT_MAX. Returns false, leaving
+// nothing to free, on a bad size or a failed allocation.
+bool analysis_fft_init(tAnalysisFft * fft, uint32_t size, tAnalysisWindow window);
+void analysis_fft_free(tAnalysisFft * fft);
+
+// The plain transform, unwindowed and unscaled: re/im[k] for k = 0 .. size / 2, as a textbook DFT
+// would give them. in[] is read at in[i * stride], so one channel of an interleaved buffer can be
+// passed as it is.
+void analysis_fft_real(tAnalysisFft * fft, const float * in, uint32_t stride, float * re, float * im);
+
+// Windowed, transformed and converted: db[k] for k = 0 .. size / 2, in dBFS, ANALYSIS_FLOOR_DB at
+// the least. Bin k is at k * rate / size Hz.
+void analysis_spectrum_db(tAnalysisFft * fft, const float * in, uint32_t stride, float * db);
+
+// THE PEAK HOLD: per bin, the highest level seen, held for holdSeconds and then falling at
+// fallDbPerSecond until the live level catches it — the display every analyser has.
+typedef struct {
+    uint32_t bins;
+    float    holdSeconds;
+    float    fallDbPerSecond;
+    float *  level;        // [bins], what to draw
+    float *  holding;      // [bins], seconds of hold left
+} tAnalysisPeakHold;
+
+bool analysis_peak_hold_init(tAnalysisPeakHold * hold, uint32_t bins, float holdSeconds, float fallDbPerSecond);
+void analysis_peak_hold_free(tAnalysisPeakHold * hold);
+
+// db[] as analysis_spectrum_db() left it; seconds is the time since the last update.
+void analysis_peak_hold_update(tAnalysisPeakHold * hold, const float * db, float seconds);
+
+// The spectrum's strongest peaks, loudest first, each refined between bins by fitting a parabola
+// through the peak bin and its neighbours — for a Hann window that puts a sine's frequency to a few
+// hundredths of a bin. Only local maxima above floorDb count. Returns how many were found.
+typedef struct {
+    float hz;
+    float db;
+} tAnalysisPeak;
+
+uint32_t analysis_find_peaks(const float * db, uint32_t bins, float binHz, float floorDb,
+                             tAnalysisPeak * peaks, uint32_t maxPeaks);
+
+#endif // __ANALYSIS_H__
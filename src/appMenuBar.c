@@ -44,6 +44,7 @@ extern "C" {
 #include "midiInput.h"
 #include "alertDialog.h"
 #include "menus.h"
+#include "protocol.h"
 #include <unistd.h>
 
 #include "appMenuBar.h"
@@ -272,7 +273,7 @@ static void action_send_ctrl_snapshot(int index) {
     (void)index;
     msg.cmd  = eMsgCmdSendCtrlSnapshot;
     msg.slot = gSlot;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 static void action_open_perf_settings(int index) {
@@ -594,6 +595,19 @@ static void action_select_output_level(int index) {
 #endif // G2_VST3_BUILD
 
 
+// Variation crossfade, in milliseconds. 0 is off: a switch lands as fast as any edit does.
+static const uint32_t kVariationCrossfades[]                                  = {0, 50, 100, 250, 500, 1000, 2000};
+
+#ifndef G2_VST3_BUILD    // needs the application's audio-device and MIDI-input layers
+
+static void action_select_variation_crossfade(int index) {
+    if ((index >= 0) && (index < (int)(sizeof(kVariationCrossfades) / sizeof(kVariationCrossfades[0])))) {
+        audio_output_select_variation_crossfade_ms(kVariationCrossfades[index]);
+    }
+}
+#endif // G2_VST3_BUILD
+
+
 #ifndef G2_VST3_BUILD    // needs the application's audio-device and MIDI-input layers
 
 static void action_select_buffer_frames(int index) {
@@ -896,6 +910,34 @@ void open_experimental_menu(tCoord anchor) {
             };
         }
 
+        // Variation crossfade. A switch that jumps is right for playing variations as presets, and
+        // wrong for using them as scenes mid-phrase, where a cutoff leaping an octave is a click.
+        {
+            static tMenuItem fades[(sizeof(kVariationCrossfades) / sizeof(kVariationCrossfades[0])) + 1];
+            static char      fadeLabel[(sizeof(kVariationCrossfades) / sizeof(kVariationCrossfades[0]))][24];
+            uint32_t         n = 0;
+
+            for (n = 0; n < (sizeof(kVariationCrossfades) / sizeof(kVariationCrossfades[0])); n++) {
+                const char * mark = (audio_output_variation_crossfade_ms() == kVariationCrossfades[n]) ? "* " : "  ";
+
+                if (kVariationCrossfades[n] == 0) {
+                    snprintf(fadeLabel[n], sizeof(fadeLabel[n]), "%sOff", mark);
+                } else {
+                    snprintf(fadeLabel[n], sizeof(fadeLabel[n]), "%s%u ms", mark, (unsigned)kVariationCrossfades[n]);
+                }
+                fades[n] = (tMenuItem){
+                    fadeLabel[n], (tRgb)RGB_GREY_3, action_select_variation_crossfade, n, NULL, 0, 0.0
+                };
+            }
+
+            fades[n]   = (tMenuItem){
+                NULL, (tRgb)RGB_BLACK, NULL, 0, NULL, 0, 0.0
+            };
+            items[i++] = (tMenuItem){
+                "Variation Crossfade", (tRgb)RGB_GREY_3, NULL, 0, fades, 0, 0.0
+            };
+        }
+
         // A stereo device has nothing to choose. Multi-column past eight, or a 32-output interface
         // runs off the bottom of the screen.
         if (channels > 2) {
@@ -35,6 +35,7 @@ extern "C" {
 #include "prefs.h"
 #include "audioOutput.h"
 #include "soundEngine.h"
+#include "rtLog.h"
 
 // A HAL output AudioUnit rather than the default-output one. The difference is the whole point: the
 // default-output unit always follows the system's chosen device and cannot be pointed anywhere else,
@@ -53,6 +54,8 @@ extern "C" {
 #define PREF_KEY_CHANNEL     "audioOutputFirstChannel"   // superseded; read once to migrate
 #define PREF_KEY_BUFFER      "audioOutputBufferFrames"
 #define PREF_KEY_LEVEL       "audioOutputLevelDb"
+#define PREF_KEY_CROSSFADE   "audioOutputVariationCrossfadeMs"
+#define MAX_CROSSFADE_MS     (10000)   // sound_engine_set_variation_crossfade()'s own limit
 
 typedef struct {
     AudioObjectID id;
@@ -83,6 +86,13 @@ static uint32_t     gBufferFrames                 = 0;
 // working value; this owns the persistence.
 static int32_t      gLevelDb                      = 0;
 
+// How long a variation switch glides for, in milliseconds. Kept here for the same reason as the level.
+static uint32_t     gCrossfadeMs                  = 0;
+
+// Whether the device's render thread has claimed its rt_log ring. Per thread, so a device change
+// that brings a new render thread claims again.
+static _Thread_local bool gAudioThreadLogs        = false;
+
 // Reads a CFString device property into a plain C buffer.
 static void device_string_property(AudioObjectID device, AudioObjectPropertySelector selector,
                                    char * out, size_t outSize) {
@@ -304,6 +314,13 @@ void audio_output_load_settings(void) {
     }
     sound_engine_set_output_level_db((double)gLevelDb);
 
+    gCrossfadeMs  = (uint32_t)prefs_get_int(PREF_KEY_CROSSFADE, 0);
+
+    if (gCrossfadeMs > MAX_CROSSFADE_MS) {
+        gCrossfadeMs = MAX_CROSSFADE_MS;
+    }
+    sound_engine_set_variation_crossfade((double)gCrossfadeMs * 1.0e-3);
+
     if (prefs_has_key(PREF_KEY_LEFT) == true) {
         gLeftChannel  = (uint32_t)prefs_get_int(PREF_KEY_LEFT, 0);
         gRightChannel = (uint32_t)prefs_get_int(PREF_KEY_RIGHT, 1);
@@ -379,6 +396,19 @@ void audio_output_select_level_db(int32_t db) {
     sound_engine_set_output_level_db((double)db);
 }
 
+uint32_t audio_output_variation_crossfade_ms(void) {
+    return gCrossfadeMs;
+}
+
+void audio_output_select_variation_crossfade_ms(uint32_t ms) {
+    if (ms > MAX_CROSSFADE_MS) {
+        ms = MAX_CROSSFADE_MS;
+    }
+    gCrossfadeMs = ms;
+    prefs_set_int(PREF_KEY_CROSSFADE, (long)ms);
+    sound_engine_set_variation_crossfade((double)ms * 1.0e-3);
+}
+
 void audio_output_select_buffer_frames(uint32_t frames) {
     gBufferFrames = frames;
     prefs_set_int(PREF_KEY_BUFFER, (long)frames);
@@ -410,6 +440,13 @@ static OSStatus render_callback(void *                       inRefCon,
     (void)inTimeStamp;
     (void)inBusNumber;
 
+    // The device's own thread, not one of ours, so it is claimed here, on the first callback only;
+    // rtLog gives the ring back when CoreAudio ends the thread.
+    if (gAudioThreadLogs == false) {
+        gAudioThreadLogs = true;
+        (void)rt_log_register_thread("audio");
+    }
+
     if ((ioData == NULL) || (ioData->mNumberBuffers == 0)) {
         return noErr;
     }
@@ -92,6 +92,11 @@ uint32_t audio_output_selected_device_channels(void);
 int32_t audio_output_level_db(void);
 void audio_output_select_level_db(int32_t db);
 
+// How long a variation switch glides from the old settings to the new, in milliseconds, 0 (the
+// default) to 10000 — see sound_engine_set_variation_crossfade(). Remembered like the level.
+uint32_t audio_output_variation_crossfade_ms(void);
+void audio_output_select_variation_crossfade_ms(uint32_t ms);
+
 uint32_t audio_output_buffer_frames(void);
 void audio_output_select_buffer_frames(uint32_t frames);
 
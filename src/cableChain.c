@@ -27,6 +27,7 @@ extern "C" {
 #include "dataBase.h"
 #include "moduleResourcesAccess.h"
 #include "globalVars.h"
+#include "protocol.h"
 #include "cableChain.h"
 
 void cable_send_message(uint32_t cmd, uint32_t slot, uint32_t location, tCableKey * key, uint32_t colour) {
@@ -42,7 +43,7 @@ void cable_send_message(uint32_t cmd, uint32_t slot, uint32_t location, tCableKe
     messageContent.cableData.linkType             = key->linkType;
     messageContent.cableData.colour               = colour;
 
-    msg_send(&gToUsbThread, &messageContent);
+    send_usb_command(&messageContent);
 }
 
 // The from-end of a cable carries its own direction in the link type; the to-end is always
@@ -879,7 +879,7 @@ static bool handle_cable_reroute(tCoord coord, uint32_t slot, uint32_t location)
         msg.cableData.moduleToIndex        = oldKeys[c].moduleToIndex;
         msg.cableData.connectorToIoIndex   = oldKeys[c].connectorToIoCount;
         msg.cableData.linkType             = oldKeys[c].linkType;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         delete_cable(oldKeys[c]);
     }
 
@@ -910,7 +910,7 @@ static bool handle_cable_reroute(tCoord coord, uint32_t slot, uint32_t location)
         msg.cableData.connectorToIoIndex   = newKeys[c].connectorToIoCount;
         msg.cableData.linkType             = newKeys[c].linkType;
         msg.cableData.colour               = cable.colour;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     // Topology changed at both ends, so both chains are re-derived — see the note in the connect
@@ -1003,7 +1003,7 @@ bool handle_cable_connect(tCoord coord, uint32_t slot, uint32_t location) {
                 messageContent.cableData.connectorToIoIndex   = cableKey.connectorToIoCount;
                 messageContent.cableData.linkType             = cableKey.linkType;
                 messageContent.cableData.colour               = cable.colour;
-                msg_send(&gToUsbThread, &messageContent);
+                send_usb_command(&messageContent);
 
                 // The to-end is always an input, so this needs no database lookup — which also
                 // keeps it safe if write_cable() found no free slot
@@ -26,6 +26,7 @@ extern "C" {
 #include "globalVars.h"
 #include "dataBase.h"
 #include "moduleResourcesAccess.h"
+#include "rtLog.h"
 
 tModule gModule[MAX_SLOTS][locationMax][MAX_NUM_MODULES] = {0};
 
@@ -59,14 +60,16 @@ void write_module(tModuleKey key, tModule * module) {
 
     if ((key.slot < MAX_SLOTS) && (key.location < (uint32_t)locationMax) && (key.index < MAX_NUM_MODULES)) {
         gModule[key.slot][key.location][key.index] = *module;
+        gModuleLayoutGeneration[key.slot]++;
     } else {
-        LOG_ERROR("Module key out of bounds slot=%u location=%u index=%u\n", key.slot, key.location, key.index);
+        RT_LOG_ERROR("Module key out of bounds slot=%u location=%u index=%u\n", key.slot, key.location, key.index);
     }
 }
 
 void delete_module(tModuleKey key) {
     if ((key.slot < MAX_SLOTS) && (key.location < (uint32_t)locationMax) && (key.index < MAX_NUM_MODULES)) {
         memset(&gModule[key.slot][key.location][key.index], 0, sizeof(tModule));
+        gModuleLayoutGeneration[key.slot]++;
     }
 }
 
@@ -77,6 +80,7 @@ void database_delete_modules_by_slot(uint32_t slot) {
                 memset(&gModule[slot][location][index], 0, sizeof(tModule));
             }
         }
+        gModuleLayoutGeneration[slot]++;
     }
 }
 
@@ -108,8 +112,15 @@ bool slot_has_modules(uint32_t slot) {
 
 void database_clear_modules(void) {
     memset(gModule, 0, sizeof(gModule));
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        gModuleLayoutGeneration[slot]++;
+    }
 }
 
+// dump_modules() and dump_cables() keep plain LOG_DEBUG. Nothing calls them; they are for calling by
+// hand from a debugger, on whatever thread is stopped, and their lines carry more arguments than the
+// RT_LOG_MAX_ARGS an rt_log entry holds.
 void dump_modules(void) {
     uint32_t count = 0;
 
@@ -172,7 +183,7 @@ void write_cable(tCableKey key, tCable * cable) {
             }
         }
 
-        LOG_ERROR("write_cable: no free slot slot=%u location=%u\n", key.slot, key.location);
+        RT_LOG_ERROR("write_cable: no free slot slot=%u location=%u\n", key.slot, key.location);
     }
 }
 
@@ -282,7 +293,7 @@ void set_patch_name_from_filename(uint32_t slot, const char * filepath) {
     }
     COPY_STRING(gGlobalSettings.slot[slot].patchName, patchName);
 
-    LOG_DEBUG("Patch name from file: '%s'\n", patchName);
+    RT_LOG_DEBUG("Patch name from file: '%s'\n", patchName);
 }
 
 // A brand-new, empty patch. Moved here from mouseHandle.c, where its own comment asked where it
@@ -61,7 +61,7 @@
 // timestamp is left over from an earlier drag), neither of which should teleport the canvas.
 #define DRAG_SCROLL_MAX_STEP_MS    (50.0)
 
-//#define ENABLE_USB_LOG    // Uncomment to enable USB message logging to ~/G2_usb.log
+//#define ENABLE_USB_LOG    // Uncomment to enable USB message logging to ~/G2_usb.bin; tools/usblogdecode.c reads it
 
 // TEMPORARY debug aid — mouse crosshair for validating button hit points.
 // Compiled in for Debug builds only, so it can never reach a release .dmg, and
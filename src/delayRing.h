@@ -0,0 +1,101 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DELAY_RING_H__
+#define __DELAY_RING_H__
+
+#include <stdint.h>
+
+// The sound engine's delay-line arithmetic, on its own so that tools/delaybench.c can time and check
+// exactly the code the engine runs rather than a copy of it. Header-only and inline because every
+// call is per sample inside the engine's inner loop; there is nothing here worth a call.
+//
+// A RING IS A POWER OF TWO LONG and indexed with a mask. The lines used to wrap with `%`, which is an
+// integer division on every read and every write — the single most expensive instruction in the
+// delay's loop, spent on arithmetic a mask does in one cycle. Rounding a length up to a power of two
+// costs some memory; see each ring's definition in soundEngine.c for what it was sized to cover.
+//
+// The write position is the NEXT sample to be written, so it also holds the OLDEST sample in the
+// ring until it is overwritten. A read happens before the write of the same sample, which is what
+// makes a delay of N read back exactly N samples ago. Delays are in samples and must lie in
+// [1, mask - 1]; the caller clamps, because it is the caller that knows what the dial meant.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sample `delay` whole samples behind the write position.
+static inline double delay_ring_tap(const float * ring, uint32_t mask, uint32_t write, uint32_t delay) {
+    return (double)ring[(write - delay) & mask];
+}
+
+static inline void delay_ring_write(float * ring, uint32_t mask, uint32_t * write, double value) {
+    ring[*write] = (float)value;
+    *write       = (*write + 1) & mask;
+}
+
+// LINEAR READ, for a delay that MOVES — the chorus sweep. Cheap, and it follows a moving delay
+// without lag or state, which is what a sweep needs. Its cost is a gentle lowpass that is strongest
+// at half a sample, where it is a two-tap average, harmless in a dry/wet blend that is heard once.
+// Truncating instead, as the chorus used to, steps the delay a whole sample at a time; at the
+// sweep's rate that is a buzz of small discontinuities under the chorus rather than a pitch glide.
+static inline double delay_ring_read_linear(const float * ring, uint32_t mask, uint32_t write, double delay) {
+    uint32_t whole = (uint32_t)delay;
+    double   frac  = delay - (double)whole;
+    double   a     = (double)ring[(write - whole) & mask];
+    double   b     = (double)ring[(write - whole - 1U) & mask];
+
+    return a + (frac * (b - a));
+}
+
+// ALLPASS READ, for a delay that sits still or moves slowly inside a FEEDBACK LOOP — the Delay
+// modules. A first-order Thiran allpass: flat magnitude at every frequency, so it does not dull the
+// repeats. The linear read would: its lowpass is applied again on every trip round the loop, and at
+// Feedback 127, which the instrument holds indefinitely, the top end would drain away repeat by
+// repeat purely as a side effect of where the knob happened to land between two samples.
+//
+// `state` is the previous output; one per line, cleared with the line.
+//
+// THE FRACTION IS KEPT IN [0.1, 1.1) by borrowing a whole sample. Near a fraction of zero the
+// coefficient approaches 1, the pole sits almost on the unit circle at Nyquist, and a change of
+// delay rings for a long time; a tenth of a sample keeps the pole well inside.
+static inline double delay_ring_read_allpass(const float * ring, uint32_t mask, uint32_t write, double delay,
+                                             double * state) {
+    uint32_t whole = (uint32_t)delay;
+    double   frac  = delay - (double)whole;
+    double   eta   = 0.0;
+    double   out   = 0.0;
+
+    if ((frac < 0.1) && (whole > 1U)) {
+        whole--;
+        frac += 1.0;
+    }
+    eta    = (1.0 - frac) / (1.0 + frac);
+    out    = (eta * (double)ring[(write - whole) & mask])
+             + (double)ring[(write - whole - 1U) & mask]
+             - (eta * *state);
+    *state = out;
+    return out;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -38,6 +38,8 @@ extern "C" {
 #include "graphics.h"
 #include "prefs.h"
 #include "deviceSync.h"
+#include "usbComms.h"
+#include "rtLog.h"
 
 // Does this queued command change the patch the G2 holds? Queries, view state and whole-file
 // operations do not: replaying them would be pointless rather than wrong, and counting them as
@@ -78,7 +80,9 @@ uint32_t device_sync_drain_offline_edits(void) {
     uint32_t        slotMask       = 0;
     uint32_t        discarded      = 0;
 
-    while (msg_receive(&gToUsbThread, eRcvPoll, &messageContent) == EXIT_SUCCESS) {
+    // Through the USB thread's command stage, which may be holding commands taken off the queue
+    // before the link went down.
+    while (usb_comms_next_command(&messageContent) == true) {
         discarded++;
 
         if (command_changes_patch(messageContent.cmd) && (messageContent.slot < MAX_SLOTS)) {
@@ -88,8 +92,8 @@ uint32_t device_sync_drain_offline_edits(void) {
     }
 
     if (discarded > 0) {
-        LOG_DEBUG("Discarded %u queued command(s) from the offline period, dirty slot mask 0x%x\n",
-                  discarded, slotMask);
+        RT_LOG_DEBUG("Discarded %u queued command(s) from the offline period, dirty slot mask 0x%x\n",
+                     discarded, slotMask);
     }
     return slotMask;
 }
@@ -97,6 +101,9 @@ uint32_t device_sync_drain_offline_edits(void) {
 // Recovery files are the app's own, not the user's, so they live in the app's folder rather than
 // among real patches in whatever directory was last browsed. The dialog quotes the path, which is
 // the only time anyone needs to know where it is.
+//
+// Everything from here down runs on the UI thread, from the conflict dialog and Save As, so it logs
+// with plain LOG_*; only the drain above is on the USB thread.
 #define RECOVERY_KEEP    (10u)  // Newest N kept; older ones pruned on each write
 
 // What the last write produced, so a subsequent explicit Save As can retire the automatic copy it
@@ -48,6 +48,7 @@ tModuleDragging         gModuleDrag
 tSelection              gSelection                                               = {0};
 tRubberBand             gRubberBand                                              = {0};
 _Atomic uint32_t        gPatchGeneration[MAX_SLOTS]                              = {0};
+_Atomic uint32_t        gModuleLayoutGeneration[MAX_SLOTS]                       = {0};
 tClipboard              gClipboard                                               = {0};
 tMessageQueue           gToUsbThread                                             = {0};
 tMessageQueue           gToGuiThread                                             = {0};
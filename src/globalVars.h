@@ -59,6 +59,10 @@ extern tRubberBand             gRubberBand;
 // selection_validate(). Atomic because patches arrive on the USB thread and this is read on the
 // render thread, which is also why the selection is not simply cleared at the point of the load.
 extern _Atomic uint32_t        gPatchGeneration[MAX_SLOTS];
+// BUMPED WHENEVER A MODULE IS ADDED TO OR REMOVED FROM A SLOT one at a time, by the database itself —
+// the edits gPatchGeneration does not see. Together the two say a slot's set of modules may have
+// changed; the USB thread's LED and meter decode plans are rebuilt on either. See indicatorPlan.h.
+extern _Atomic uint32_t        gModuleLayoutGeneration[MAX_SLOTS];
 extern tClipboard              gClipboard;
 extern tMessageQueue           gToUsbThread; // GUI thread -> USB thread (commands); USB thread blocks on it
 extern tMessageQueue           gToGuiThread; // USB thread -> GUI thread (results); poll-drained in the render loop
@@ -82,6 +82,7 @@ extern "C" {
 #include "virtualKeyboard.h"
 #include "patchAdjuster.h"
 #include "soundEngine.h"
+#include "analysis.h"
 #include "paramOverlay.h"
 #include <strings.h>
 
@@ -376,7 +377,7 @@ void read_file_into_memory_and_process(const char * filepath) {
         msg.cmd                = eMsgCmdLoadFile;
         msg.patchFileData.slot = slot;
         COPY_STRING(msg.patchFileData.filePath, filepath);
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         device_op_begin("Loading...");
         return;
     }
@@ -694,7 +695,7 @@ static void resolve_offline_conflict(uint32_t slotMask, bool pushToDevice) {
     msg.cmd                          = eMsgCmdResolveOfflineEdits;
     msg.offlineEditData.slotMask     = slotMask;
     msg.offlineEditData.pushToDevice = pushToDevice;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     undo_clear();
     wake_glfw();
@@ -768,7 +769,7 @@ static void on_file_saved(const char * path) {
                 tMessageContent msg = {0};
                 msg.cmd = eMsgCmdSavePerfFile;
                 COPY_STRING(msg.patchFileData.filePath, path);
-                msg_send(&gToUsbThread, &msg);
+                send_usb_command(&msg);
                 device_op_begin("Saving...");
             } else {
                 write_perf_to_file(path);
@@ -781,7 +782,7 @@ static void on_file_saved(const char * path) {
             msg.cmd                = eMsgCmdSavePatchFile;
             msg.patchFileData.slot = slot;
             COPY_STRING(msg.patchFileData.filePath, path);
-            msg_send(&gToUsbThread, &msg);
+            send_usb_command(&msg);
             device_op_begin("Saving...");
             set_patch_name_from_filename(slot, path);
         } else {
@@ -833,7 +834,7 @@ static void on_store_confirmed(bool confirmed) {
     msg.bankLocationPerfData.bank     = gStorePeekBank;
     msg.bankLocationPerfData.location = gStorePeekLocation;
     msg.bankLocationPerfData.isPerf   = gStorePeekIsPerf;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // Same shape as on_store_confirmed above, but for Delete — target comes from
@@ -848,7 +849,7 @@ static void on_delete_confirmed(bool confirmed) {
     msg.bankLocationPerfData.bank     = gDeletePeekBank;
     msg.bankLocationPerfData.location = gDeletePeekLocation;
     msg.bankLocationPerfData.isPerf   = gDeletePeekIsPerf;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // Same shape as on_store_confirmed/on_delete_confirmed above, but for Load — target comes from
@@ -863,7 +864,7 @@ static void on_load_confirmed(bool confirmed) {
     msg.bankLocationPerfData.bank     = gLoadPeekBank;
     msg.bankLocationPerfData.location = gLoadPeekLocation;
     msg.bankLocationPerfData.isPerf   = gLoadPeekIsPerf;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // Fires once the user has confirmed past the file-found warning built from a
@@ -877,7 +878,7 @@ static void on_synth_restore_confirmed(bool confirmed) {
         return;
     }
     msg.cmd = eMsgCmdApplySynthSettingsRestore;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // Busy state for in-flight whole-slot device ops (load/save/new patch). Set when the op is enqueued,
@@ -2352,6 +2353,14 @@ static void render_frame(void) {
 //   SELECT <VA|FX> <n> — select one module by index; SELECT NONE clears
 //   SNDSTATUS         — what the sound engine's status line currently reads
 //   SNDDUMP           — the resolved chain, the parameters read, and the peak level since last read
+//   SNDPROF [ON|OFF]  — switch the engine's per-node profiler on or off; bare, the table counted since
+//                       the last read: module, kind, % of callback, ns per voice-sample
+//   SNDTIMING [RESET [<pct>]] — callback time percentiles, worst, and deadline misses since the engine
+//                       started or the last RESET; pct sets what share of the buffer period is a miss
+//   SNDTAP OUT|OFF|<VA|FX> <n> — point the engine's analysis tap at the output, at one module of the
+//                       current slot, or nowhere
+//   SNDSPECTRUM [<2048-32768>] — the strongest peaks in the tap's latest frames, left channel, Hann
+//                       window: frequency and dBFS, loudest first
 //   NOTE <n>|OFF      — play/release a note on the sound engine (LOCAL engine, not the G2)
 //   DEVSET <VA|FX> <index> <param> <value> — as SET, but SENT TO THE G2. This is what lets the
 //                       measurement harness step one parameter on the hardware while its audio output
@@ -2773,7 +2782,7 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
 
         msg.cmd  = eMsgCmdWritePatch;
         msg.slot = gSlot;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         backdoor_write_result("OK\n");
     } else if (strcmp(cmd, "SET") == 0) {
         // SET <VA|FX> <index> <param> <value> — set a param's value in the
@@ -2901,7 +2910,7 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
             msg.cmd                        = eMsgCmdDeassignKnob;
             msg.slot                       = gSlot;
             msg.knobDeassignData.knobIndex = knobIndex;
-            msg_send(&gToUsbThread, &msg);
+            send_usb_command(&msg);
             memset(&msg, 0, sizeof(msg));
         }
         gKnobArray[gSlot].knob[knobIndex].assigned    = true;
@@ -2915,7 +2924,7 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
         msg.knobAssignData.moduleKey                  = module->key;
         msg.knobAssignData.paramIndex                 = param;
         msg.knobAssignData.knobIndex                  = knobIndex;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
 
         synthlib_request_redraw();
         backdoor_write_result("OK\n");
@@ -2978,7 +2987,7 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
         msg.playNoteData.note     = note;
         msg.playNoteData.velocity = velocity;
         msg.playNoteData.on       = (state[0] == 'o') && (state[1] == 'n');
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         backdoor_write_result("OK\n");
     } else if (strcmp(cmd, "DUMP") == 0) {
         char dump[16384];
@@ -3187,7 +3196,7 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
         msg.cmd                = eMsgCmdSavePatchFile;
         msg.patchFileData.slot = gSlot;
         strncpy(msg.patchFileData.filePath, arg, sizeof(msg.patchFileData.filePath) - 1);
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         backdoor_write_result("OK\n");
     } else if (strcmp(cmd, "NOTE") == 0) {
         // NOTE <midi note> plays, NOTE OFF releases. The last thing that needed a mouse to test the
@@ -3207,17 +3216,139 @@ static void backdoor_dispatch(const char * cmd, const char * arg) {
         sound_engine_note(note, true);
         backdoor_write_result("OK\n");
     } else if (strcmp(cmd, "SNDDUMP") == 0) {
-        char text[8400] = {0};
+        char text[12600] = {0};
 
         snprintf(text, sizeof(text), "OK\n%s", sound_engine_debug_text());
         backdoor_write_result(text);
+    } else if (strcmp(cmd, "SNDPROF") == 0) {
+        char text[4200] = {0};
+
+        if (strncasecmp(arg, "ON", 2) == 0) {
+            sound_engine_set_profiling(true);
+            backdoor_write_result("OK\n");
+            return;
+        }
+
+        if (strncasecmp(arg, "OFF", 3) == 0) {
+            sound_engine_set_profiling(false);
+            backdoor_write_result("OK\n");
+            return;
+        }
+
+        if (arg[0] != '\0') {
+            backdoor_write_result("ERROR: expected 'SNDPROF', 'SNDPROF ON' or 'SNDPROF OFF'\n");
+            return;
+        }
+        snprintf(text, sizeof(text), "OK\n%s", sound_engine_profile_text());
+        backdoor_write_result(text);
     } else if (strcmp(cmd, "SNDSTATUS") == 0) {
         // Reads back what the Experimental menu would show, so a test can assert on why the engine
         // is or is not making a sound without taking a screenshot of a menu.
-        char text[160] = {0};
+        char text[200] = {0};
 
         snprintf(text, sizeof(text), "OK\n%s\n", sound_engine_status_text());
         backdoor_write_result(text);
+    } else if (strcmp(cmd, "SNDTIMING") == 0) {
+        tSoundEngineTiming timing    = {0};
+        struct timespec    now       = {0};
+        char               text[400] = {0};
+        uint32_t           percent   = 0;
+
+        if (strncasecmp(arg, "RESET", 5) == 0) {
+            if ((sscanf(arg + 5, "%u", &percent) == 1) && ((percent < 1) || (percent > 1000))) {
+                backdoor_write_result("ERROR: expected 'SNDTIMING RESET [<1-1000 %>]'\n");
+                return;
+            }
+            sound_engine_timing_reset(percent);
+            backdoor_write_result("OK\n");
+            return;
+        }
+        sound_engine_timing_stats(&timing);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        snprintf(text, sizeof(text),
+                 "OK\ncallbacks %llu, period %.1f us\n"
+                 "p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n"
+                 "over %u%% of period: %llu, last %.1f s ago\n",
+                 (unsigned long long)timing.callbacks, timing.periodUs,
+                 timing.p50Us, timing.p90Us, timing.p99Us, timing.p999Us, timing.maxUs,
+                 (unsigned)timing.missPercent, (unsigned long long)timing.misses,
+                 (timing.lastMissSeconds > 0.0)
+                 ? (((double)now.tv_sec + ((double)now.tv_nsec / 1.0e9)) - timing.lastMissSeconds) : 0.0);
+        backdoor_write_result(text);
+    } else if (strcmp(cmd, "SNDTAP") == 0) {
+        char     locName[8] = {0};
+        uint32_t index      = 0;
+
+        if (strncasecmp(arg, "OFF", 3) == 0) {
+            sound_engine_set_analysis_tap(eAnalysisTapOff, 0, 0, 0);
+            backdoor_write_result("OK\n");
+            return;
+        }
+
+        if (strncasecmp(arg, "OUT", 3) == 0) {
+            sound_engine_set_analysis_tap(eAnalysisTapOutput, 0, 0, 0);
+            backdoor_write_result("OK\n");
+            return;
+        }
+
+        if (sscanf(arg, "%7s %u", locName, &index) != 2) {
+            backdoor_write_result("ERROR: expected 'SNDTAP OUT', 'SNDTAP OFF' or 'SNDTAP <VA|FX> <index>'\n");
+            return;
+        }
+        sound_engine_set_analysis_tap(eAnalysisTapModule, gSlot,
+                                      (strncasecmp(locName, "FX", 2) == 0) ? (uint32_t)locationFx : (uint32_t)locationVa,
+                                      index);
+        backdoor_write_result("OK\n");
+    } else if (strcmp(cmd, "SNDSPECTRUM") == 0) {
+        // The newest `size` frames the tap has, rather than whatever a cursor has reached: a test
+        // asks what is sounding now.
+        tAnalysisFft  fft       = {0};
+        tAnalysisPeak peaks[8]  = {{0}};
+        char          text[600] = {0};
+        float *       frames    = NULL;
+        float *       db        = NULL;
+        uint32_t      size      = 8192;
+        uint32_t      found     = 0;
+        uint64_t      cursor    = 0;
+        double        rate      = sound_engine_analysis_rate();
+        int           used      = 0;
+
+        if (  ((arg[0] != '\0') && (sscanf(arg, "%u", &size) != 1))
+           || (size < 2048) || (size > 32768) || ((size & (size - 1)) != 0)) {
+            backdoor_write_result("ERROR: expected 'SNDSPECTRUM [<2048|4096|8192|16384|32768>]'\n");
+            return;
+        }
+        cursor = sound_engine_analysis_position();
+
+        if ((cursor < size) || (rate <= 0.0)) {
+            backdoor_write_result("ERROR: the tap has not collected that many frames (SNDTAP OUT first?)\n");
+            return;
+        }
+        cursor -= size;
+
+        if (analysis_fft_init(&fft, size, eAnalysisWindowHann) == false) {
+            backdoor_write_result("ERROR: out of memory\n");
+            return;
+        }
+        frames = malloc((size_t)size * 2 * sizeof(float));
+        db     = malloc((size_t)fft.bins * sizeof(float));
+
+        if ((frames != NULL) && (db != NULL) && (sound_engine_analysis_read(&cursor, frames, size) == size)) {
+            analysis_spectrum_db(&fft, frames, 2, db);
+            found = analysis_find_peaks(db, fft.bins, (float)(rate / (double)size), -100.0f, peaks, 8);
+            used  = snprintf(text, sizeof(text), "OK\n%u peaks, %u frames at %.0f Hz\n", found, size, rate);
+
+            for (uint32_t p = 0; (p < found) && (used < ((int)sizeof(text) - 40)); p++) {
+                used += snprintf(text + used, sizeof(text) - (size_t)used, "  %9.2f Hz  %6.1f dB\n",
+                                 peaks[p].hz, peaks[p].db);
+            }
+            backdoor_write_result(text);
+        } else {
+            backdoor_write_result("ERROR: the tap overran the read; try again\n");
+        }
+        free(frames);
+        free(db);
+        analysis_fft_free(&fft);
     } else if (strcmp(cmd, "SCROLL") == 0) {
         double xFraction = 0.0;
         double yFraction = 0.0;
@@ -3313,6 +3444,11 @@ void do_graphics_loop(void) {
         // apps. See synthlibPopups.h.
         synthlib_popups_tick();
 
+        // Offline, the local engine stands in for the G2's LED and meter reports. Checked every pass,
+        // so the last one after the engine stops is what turns them dark.
+        if ((gCommsState != eCommsOnLine) && (sound_engine_apply_meters(gSlot) == true)) {
+            synthlib_request_redraw();
+        }
         reDraw = synthlib_consume_redraw();
 
         if (reDraw == true) {
@@ -3343,6 +3479,8 @@ void do_graphics_loop(void) {
             glfwWaitEventsTimeout(0.05); // tick while busy so the device-op safety timeout can fire even with no events
         } else if (virtual_keyboard_wants_ticks()) {
             glfwWaitEventsTimeout(0.02); // Repeat is running — glfwWaitEvents() would stall it until the next input event
+        } else if ((gCommsState != eCommsOnLine) && (sound_engine_active() == true)) {
+            glfwWaitEventsTimeout(1.0 / 30.0); // the offline meters' rate — see sound_engine_apply_meters()
         } else if (backdoor_enabled()) {
             glfwWaitEventsTimeout(0.1);  // poll cadence for the backdoor command file — only when enabled (owner's normal launch keeps full idle-sleep below)
         } else {
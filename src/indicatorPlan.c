@@ -0,0 +1,189 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "rtLog.h"
+#include "types.h"
+#include "dataBase.h"
+#include "moduleResourcesAccess.h"
+#include "globalVars.h"
+#include "indicatorPlan.h"
+
+// See indicatorPlan.h.
+
+static tIndicatorPlan gPlan[MAX_SLOTS];
+static uint64_t       gBuilds = 0;
+
+static uint32_t meters_for(tModuleType type) {
+    switch (gModuleProperties[type].volumeType) {
+        case volumeTypeMono:
+        case volumeTypeCompress:
+        case volumeTypeSequencer:
+            return 1;
+
+        case volumeTypeStereo:
+            return 2;
+
+        case volumeTypeQuad:
+            return 4;
+
+        default:
+            return 0;
+    }
+}
+
+static void add_meter_step(tIndicatorPlan * plan, uint8_t width, uint8_t leds, void * dest) {
+    if (plan->meterCount < INDICATOR_MAX_METER_STEPS) {
+        plan->meter[plan->meterCount++] = (tIndicatorStep){plan->meterBits, width, leds, dest};
+    }
+    plan->meterBits += 16;    // every entry is 16 bits on the wire, whatever is taken from it
+}
+
+void indicator_plan_build(tIndicatorPlan * plan, uint32_t slot) {
+    memset(plan, 0, sizeof(*plan));
+
+    if (slot >= MAX_SLOTS) {
+        return;
+    }
+
+    // The order both streams are in: VA, then FX, each by module index — see parse_led_data() for
+    // where that comes from.
+    for (int32_t location = locationVa; location >= locationFx; location--) {
+        for (uint32_t k = 0; k < MAX_NUM_MODULES; k++) {
+            tModuleKey key    = {slot, (uint32_t)location, k};
+            tModule *  module = get_module(key);
+
+            if (module == NULL) {
+                continue;
+            }
+
+            // The volume stream: the meters, then one entry for a multi-bit LED group — see
+            // parse_volume_indicator() for why a group belongs to this stream and not the LED one.
+            uint32_t meters       = meters_for(module->type);
+            uint32_t multiBitLeds = module_multibit_led_count(module->type);
+
+            for (uint32_t i = 0; i < meters; i++) {
+                add_meter_step(plan, 8, 0, &module->volume.value[i]);
+            }
+
+            if (multiBitLeds > 0) {
+                add_meter_step(plan, 16, (uint8_t)((multiBitLeds < MAX_LEDS_PER_MODULE) ? multiBitLeds : MAX_LEDS_PER_MODULE),
+                               (void *)module->led.value);
+            }
+
+            // The LED stream: one index per LED, the module's consecutive. Past LED_STREAM_SIZE the
+            // G2 reports nothing, so the plan stops there.
+            uint32_t leds = module_led_count(module->type);
+
+            if (leds > MAX_LEDS_PER_MODULE) {
+                // The module still consumes all of its indices, so the ones after it stay in step;
+                // only the surplus is dropped. Said once per plan rather than once per message.
+                RT_LOG_ERROR("Module type %u has %u LEDs, MAX_LEDS_PER_MODULE is %u — storing the first %u\n",
+                             module->type, leds, MAX_LEDS_PER_MODULE, MAX_LEDS_PER_MODULE);
+                EXIT_IN_DEBUG();
+            }
+
+            for (uint32_t l = 0; (l < leds) && (plan->ledCount < LED_STREAM_SIZE); l++) {
+                void * dest = (l < MAX_LEDS_PER_MODULE) ? (void *)&module->led.value[l] : NULL;
+
+                plan->led[plan->ledCount] = (tIndicatorStep){plan->ledCount * 2, 2, 0, dest};
+                plan->ledCount++;
+            }
+        }
+    }
+    plan->built = true;
+}
+
+const tIndicatorPlan * indicator_plan_for_slot(uint32_t slot) {
+    if (slot >= MAX_SLOTS) {
+        return NULL;
+    }
+    tIndicatorPlan * plan             = &gPlan[slot];
+    uint32_t         patchGeneration  = gPatchGeneration[slot];
+    uint32_t         layoutGeneration = gModuleLayoutGeneration[slot];
+
+    // Read before building, so a change that lands during the build is seen by the next message.
+    if ((plan->built == false) || (plan->patchGeneration != patchGeneration)
+        || (plan->layoutGeneration != layoutGeneration)) {
+        indicator_plan_build(plan, slot);
+        plan->patchGeneration  = patchGeneration;
+        plan->layoutGeneration = layoutGeneration;
+        gBuilds++;
+    }
+    return plan;
+}
+
+void indicator_plan_decode_meters(const tIndicatorPlan * plan, const uint8_t * data, uint32_t dataBytes) {
+    for (uint32_t s = 0; s < plan->meterCount; s++) {
+        const tIndicatorStep * step = &plan->meter[s];
+        uint32_t               at   = step->bitOffset / 8;    // every entry starts on a byte
+
+        if ((at + 2) > dataBytes) {
+            break;    // a short message: the steps after this are beyond it too
+        }
+
+        if (step->width == 8) {
+            *(uint32_t *)step->dest = data[at];
+        } else {
+            // The two top flag bits say the value IS a bit set; the reference only spreads it a bit at
+            // a time when both are present (and only for groups under twelve LEDs, which all of these
+            // are). Anything else is some other encoding we have not had to decode, so show nothing
+            // rather than show nonsense.
+            _Atomic uint32_t * led   = step->dest;
+            uint32_t           value = (uint32_t)data[at] | ((uint32_t)data[at + 1] << 8);
+
+            for (uint32_t l = 0; l < step->leds; l++) {
+                led[l] = ((value & 0x3000) == 0x3000) ? ((value >> l) & 1) : 0;
+            }
+        }
+    }
+}
+
+void indicator_plan_decode_leds(const tIndicatorPlan * plan, uint32_t startIndex, const uint8_t * data,
+                                uint32_t dataBytes) {
+    // Four to a byte, lowest bits first, the message's first value being stream index startIndex.
+    for (uint32_t i = startIndex; i < plan->ledCount; i++) {
+        const tIndicatorStep * step   = &plan->led[i];
+        uint32_t               offset = step->bitOffset - (startIndex * 2);
+
+        if ((offset / 8) >= dataBytes) {
+            break;
+        }
+
+        if (step->dest != NULL) {
+            *(_Atomic uint32_t *)step->dest = (data[offset / 8] >> (offset % 8)) & 0x3;
+        }
+    }
+}
+
+uint64_t indicator_plan_builds(void) {
+    return gBuilds;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __INDICATOR_PLAN_H__
+#define __INDICATOR_PLAN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "defs.h"
+#include "types.h"
+
+// THE LED AND METER DECODE PLAN: where every value in the G2's two indicator streams goes, worked out
+// once per module layout instead of once per message.
+//
+// Both streams are positional. A volume message (0x3a) is one 16-bit entry per meter, plus one per
+// multi-bit LED group, for every module in the slot that has either, VA then FX, in index order; an
+// LED message (0x39) is 2-bit values, one per LED, in the same module order. Nothing in either says
+// which module a value belongs to. parse_volume_indicator() and parse_led_data() used to find out by
+// walking all 128 indices of both areas and looking up each module's type, for every message, for
+// every slot — many times a second, to place a few dozen values.
+//
+// A plan is that walk done once: a flat list of steps in stream order, each a bit offset into the
+// message's data, a width, and where the value goes —
+//
+//   width 8    a meter: the entry's low byte into volume.value[]; the high byte is unused
+//   width 16   a multi-bit LED group: the whole entry, whose bits are the group's LEDs
+//   width 2    one LED into led.value[]
+//
+// — so decoding is a loop over the steps with no search and no lookup. A step with no destination is
+// a value the stream carries that the module has no room for; it is skipped, keeping the rest in step.
+//
+// A slot's plan is rebuilt, on its next message, whenever gPatchGeneration or
+// gModuleLayoutGeneration for the slot has moved: a patch arrived, the slot was cleared, or a module
+// was added or deleted. Destinations point into the module database, whose storage never moves.
+//
+// USB thread only, like the parsers it serves. tools/ledbench.c checks the plans against the walk
+// they replaced and times both.
+
+#define INDICATOR_MAX_METER_STEPS    (2U * MAX_NUM_MODULES * 5U)    // both areas, four meters and a group each
+
+typedef struct {
+    uint32_t bitOffset;    // into the data, which starts after the start-index byte
+    uint8_t  width;        // 8, 16 or 2 — see above
+    uint8_t  leds;         // width 16: how many LEDs the group's bits drive
+    void *   dest;         // uint32_t volume.value[i], or the first _Atomic uint32_t led.value[]; NULL skips
+} tIndicatorStep;
+
+typedef struct {
+    bool           built;
+    uint32_t       patchGeneration;                     // what the two counters were when it was built
+    uint32_t       layoutGeneration;
+    uint32_t       meterCount;
+    uint32_t       meterBits;                           // how much of a volume message the steps cover
+    tIndicatorStep meter[INDICATOR_MAX_METER_STEPS];
+    uint32_t       ledCount;                            // LEDs in the slot, up to LED_STREAM_SIZE
+    tIndicatorStep led[LED_STREAM_SIZE];                // led[i] is stream index i
+} tIndicatorPlan;
+
+// Builds slot's plan from the module database as it is now.
+void indicator_plan_build(tIndicatorPlan * plan, uint32_t slot);
+
+// slot's plan, rebuilt first if its modules may have changed since it was built. NULL for a bad slot.
+const tIndicatorPlan * indicator_plan_for_slot(uint32_t slot);
+
+// A volume message: data is what follows its start index, dataBytes how much of it there is. Steps
+// the message is too short for are left as they were.
+void indicator_plan_decode_meters(const tIndicatorPlan * plan, const uint8_t * data, uint32_t dataBytes);
+
+// An LED message: startIndex is its first LED's stream index, data the packed values that follow.
+void indicator_plan_decode_leds(const tIndicatorPlan * plan, uint32_t startIndex, const uint8_t * data,
+                                uint32_t dataBytes);
+
+// How many plans indicator_plan_for_slot() has built, ever.
+uint64_t indicator_plan_builds(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __INDICATOR_PLAN_H__
@@ -35,6 +35,7 @@ extern "C" {
 #include "mouseHandle.h"
 #include "soundEngine.h"
 #include "midiInput.h"
+#include "rtLog.h"
 #include "main.h"
 
 static void signal_handler(int sigraised) {
@@ -72,6 +73,8 @@ static int init_signals(void) {
 
 int main(int argc, char ** argv) {
     init_signals();
+    // Before any thread that logs through a ring exists: the audio callback and the USB thread.
+    rt_log_start();
 
     init_database();
     init_module_resource_cache();
@@ -105,6 +108,7 @@ int main(int argc, char ** argv) {
     midi_input_stop();
 
     clean_up_graphics();
+    rt_log_stop();
 
     exit(EXIT_SUCCESS);
 }
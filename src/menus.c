@@ -41,6 +41,7 @@ extern "C" {
 #include "selection.h"
 #include "undo.h"
 #include "cableChain.h"
+#include "soundEngine.h"
 
 // ── Synth settings action targets ──────────────────────────────────────────
 
@@ -60,7 +61,7 @@ void send_synth_settings_msg(void) {
     tMessageContent msg = {0};
 
     msg.cmd = eMsgCmdWriteSynthSettings;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 static void action_setting_u8(int index) {
@@ -77,7 +78,7 @@ void send_perf_settings_msg(void) {
     tMessageContent msg = {0};
 
     msg.cmd = eMsgCmdWritePerfSettings;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 void send_master_clock_run(uint32_t running) {
@@ -85,7 +86,7 @@ void send_master_clock_run(uint32_t running) {
 
     msg.cmd                        = eMsgCmdSetMasterClockRun;
     msg.masterClockRunData.running = running;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 static void action_perf_setting_u8(int index) {
@@ -104,7 +105,7 @@ static void send_patch_setting_param(uint32_t slot, uint32_t moduleIndex, uint32
     msg.paramData.param     = paramIndex;
     msg.paramData.value     = value;
     msg.paramData.variation = 0;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 static void action_patch_setting_u8(int index) {
@@ -142,7 +143,7 @@ static void send_patch_descr_update(uint32_t slot) {
 
     messageContent.cmd  = eMsgCmdWritePatchDescr;
     messageContent.slot = slot;
-    msg_send(&gToUsbThread, &messageContent);
+    send_usb_command(&messageContent);
 }
 
 static void action_set_patch_type(int index) {
@@ -212,7 +213,8 @@ static void action_copy_variation(int index) {
     msg.slot                            = slot;
     msg.copyVariationData.fromVariation = sourceVariation;
     msg.copyVariationData.toVariation   = targetVariation;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
+    sound_engine_lane_edited(slot, targetVariation);
 
     gContextMenu.active                 = false;
     synthlib_request_redraw();
@@ -644,7 +646,7 @@ static void action_set_module_colour(int index) {
     messageContent.moduleColourData.moduleKey = module->key;
     messageContent.moduleColourData.colour    = module->colour;
 
-    msg_send(&gToUsbThread, &messageContent);
+    send_usb_command(&messageContent);
 }
 
 static void action_rename_morph_label(int index) {
@@ -789,7 +791,7 @@ int32_t create_module_at(tModuleType type, uint32_t column, uint32_t row, bool s
     COPY_STRING(messageContent.moduleData.name, module.name);
 
     if (syncToDevice) {
-        msg_send(&gToUsbThread, &messageContent); // push to the G2; backdoor/test callers pass false to stay local-only
+        send_usb_command(&messageContent); // push to the G2; backdoor/test callers pass false to stay local-only
     }
     write_module(module.key, &module);
 
@@ -874,7 +876,7 @@ static void action_assign_knob(int index) {
         msg.cmd                                    = eMsgCmdDeassignKnob;
         msg.slot                                   = slot;
         msg.knobDeassignData.knobIndex             = targetKnob;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
     }
 
@@ -883,7 +885,7 @@ static void action_assign_knob(int index) {
         msg.cmd                                      = eMsgCmdDeassignKnob;
         msg.slot                                     = slot;
         msg.knobDeassignData.knobIndex               = (uint32_t)existingKnob;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
     }
     gKnobArray[slot].knob[targetKnob].assigned    = true;
@@ -897,7 +899,7 @@ static void action_assign_knob(int index) {
     msg.knobAssignData.moduleKey                  = gMenuContext.moduleKey;
     msg.knobAssignData.paramIndex                 = paramIndex;
     msg.knobAssignData.knobIndex                  = targetKnob;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     tKnob targetAfter   = gKnobArray[slot].knob[targetKnob];
     tKnob existingAfter = hasSecond ? gKnobArray[slot].knob[existingKnob] : (tKnob){
@@ -973,7 +975,7 @@ static void action_deassign_knob(int index) {
         msg.cmd                                   = eMsgCmdDeassignKnob;
         msg.slot                                  = slot;
         msg.knobDeassignData.knobIndex            = (uint32_t)knobIndex;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         tKnob after  = gKnobArray[slot].knob[knobIndex];
         undo_push_knob(slot, (uint32_t)knobIndex, &before, &after, -1, NULL, NULL);
     }
@@ -1001,7 +1003,7 @@ static void action_assign_global_knob(int index) {
         gGlobalKnobArray[targetKnob].assigned = false;
         msg.cmd                               = eMsgCmdDeassignGlobalKnob;
         msg.globalKnobDeassignData.knobIndex  = targetKnob;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
     }
 
@@ -1009,7 +1011,7 @@ static void action_assign_global_knob(int index) {
         gGlobalKnobArray[existingKnob].assigned = false;
         msg.cmd                                 = eMsgCmdDeassignGlobalKnob;
         msg.globalKnobDeassignData.knobIndex    = (uint32_t)existingKnob;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
     }
     gGlobalKnobArray[targetKnob].assigned    = true;
@@ -1025,7 +1027,7 @@ static void action_assign_global_knob(int index) {
     msg.globalKnobAssignData.moduleIndex     = moduleIndex;
     msg.globalKnobAssignData.paramIndex      = paramIndex;
     msg.globalKnobAssignData.knobIndex       = targetKnob;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     undo_commit_global_knob_edit();
     gContextMenu.active                      = false;
@@ -1046,7 +1048,7 @@ static void action_deassign_global_knob(int index) {
         gGlobalKnobArray[knobIndex].assigned = false;
         msg.cmd                              = eMsgCmdDeassignGlobalKnob;
         msg.globalKnobDeassignData.knobIndex = (uint32_t)knobIndex;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
     undo_commit_global_knob_edit();
     gContextMenu.active = false;
@@ -1128,7 +1130,7 @@ void assign_midi_cc_to_param(uint32_t slot, tModuleKey moduleKey, uint32_t param
         msg.cmd                       = eMsgCmdDeassignMidiCC;
         msg.slot                      = slot;
         msg.midiCCDeassignData.midiCC = targetCC;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
     }
     paramEntry                      = find_controller_for_param(slot, location, moduleIndex, paramIndex);
@@ -1152,7 +1154,7 @@ void assign_midi_cc_to_param(uint32_t slot, tModuleKey moduleKey, uint32_t param
     msg.midiCCAssignData.moduleKey  = moduleKey;
     msg.midiCCAssignData.paramIndex = paramIndex;
     msg.midiCCAssignData.midiCC     = targetCC;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     undo_commit_midi_cc_edit();
     synthlib_request_redraw();
@@ -1191,7 +1193,7 @@ void clear_assignments_for_module(tModuleKey key) {
         msg.cmd                        = eMsgCmdDeassignKnob;
         msg.slot                       = slot;
         msg.knobDeassignData.knobIndex = i;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     // Performance-wide, so the entry's own slotIndex decides whether it belongs to this module.
@@ -1211,7 +1213,7 @@ void clear_assignments_for_module(tModuleKey key) {
         };
         msg.cmd                              = eMsgCmdDeassignGlobalKnob;
         msg.globalKnobDeassignData.knobIndex = i;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     // Walked BACKWARDS because remove_controller_entry() closes the gap by moving the last entry
@@ -1231,7 +1233,7 @@ void clear_assignments_for_module(tModuleKey key) {
         msg.cmd                       = eMsgCmdDeassignMidiCC;
         msg.slot                      = slot;
         msg.midiCCDeassignData.midiCC = midiCC;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 }
 
@@ -1343,7 +1345,7 @@ static void send_whole_patch(uint32_t slot) {
 
     msg.cmd  = eMsgCmdWritePatch;
     msg.slot = slot;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // Assigns the lowest CC number not already in use. -1 when all 128 are taken.
@@ -1549,7 +1551,7 @@ static void action_deassign_midi_cc(int index) {
         msg.cmd                       = eMsgCmdDeassignMidiCC;
         msg.slot                      = slot;
         msg.midiCCDeassignData.midiCC = cc;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
     undo_commit_midi_cc_edit();  // Pushes nothing if the click landed on an unassigned param
     gContextMenu.active = false;
@@ -33,6 +33,7 @@ extern "C" {
 #include "synthlibDefs.h"
 #include "globalVars.h"
 #include "msgQueue.h"
+#include "protocol.h"
 #include "prefs.h"
 #include "midiInput.h"
 #include "synthlibGlobals.h"
@@ -117,7 +118,7 @@ static void send_note_to_synth(uint8_t note, uint8_t velocity, bool on) {
     msg.playNoteData.note     = note;
     msg.playNoteData.velocity = velocity;
     msg.playNoteData.on       = on;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 static void note_on(uint8_t note, uint8_t velocity) {
@@ -86,7 +86,7 @@ static void send_master_clock_bpm(uint32_t bpm) {
 
     messageContent.cmd                    = eMsgCmdSetMasterClockBPM;
     messageContent.masterClockBPMData.bpm = bpm;
-    msg_send(&gToUsbThread, &messageContent);
+    send_usb_command(&messageContent);
 }
 
 // THE MODIFIER SEAM'S APPLICATION END IS ONE CALL PER EVENT, and both the translation and the
@@ -857,7 +857,7 @@ void cursor_pos(tCoord coord) {
         //gPatchDescr[slot].voiceCount = value + 1; // Note G2 won't let me set less than a value of 1, can't set to zero for zero based
         //messageContent.cmd           = eMsgCmdWritePatchDescr;
         // messageContent.slot          = slot;
-        // msg_send(&gToUsbThread, &messageContent);
+        // send_usb_command(&messageContent);
     } else if (handle_tempo_drag_motion(xCoord, yCoord, x, y)) {
         // The tempo dial and the performance-settings tempo dial — see sTempoDragTargets.
     } else if (handle_patch_param_drag_motion(gSlot, xCoord, yCoord, x, y)) {
@@ -1108,7 +1108,7 @@ void key_callback(int key, int scancode, int action, int mods) {
                 tMessageContent msg     = {0};
                 msg.cmd                                    = eMsgCmdWritePatch;
                 msg.slot                                   = gPatchNotesEdit.slot;
-                msg_send(&gToUsbThread, &msg);
+                send_usb_command(&msg);
             } else if (key == GLFW_KEY_ENTER || key == GLFW_KEY_KP_ENTER) {
                 if (len < PATCH_NOTES_SIZE) {
                     memmove(&gPatchNotesEdit.buffer[cursorPos + 1],
@@ -1180,7 +1180,7 @@ void key_callback(int key, int scancode, int action, int mods) {
                 messageContent.cmd    = eMsgCmdSetPatchName;
                 messageContent.slot   = pnSlot;
                 COPY_STRING(messageContent.patchName.name, gGlobalSettings.slot[pnSlot].patchName);
-                msg_send(&gToUsbThread, &messageContent);
+                send_usb_command(&messageContent);
                 undo_push_patch_name(pnSlot, oldPatchName, gPatchNameEdit.buffer);
             } else if (key == GLFW_KEY_ESCAPE) {
                 // Cancel — discard edits
@@ -1231,7 +1231,7 @@ void key_callback(int key, int scancode, int action, int mods) {
                     msg.slot                      = gModuleNameEdit.moduleKey.slot;
                     msg.moduleLabelData.moduleKey = gModuleNameEdit.moduleKey;
                     COPY_STRING(msg.moduleLabelData.name, gModuleNameEdit.buffer);
-                    msg_send(&gToUsbThread, &msg);
+                    send_usb_command(&msg);
                     undo_push_module_name(gModuleNameEdit.moduleKey, oldName, gModuleNameEdit.buffer);
                 }
             } else if (key == GLFW_KEY_ESCAPE) {
@@ -1310,7 +1310,7 @@ void key_callback(int key, int scancode, int action, int mods) {
                     msg.paramLabelData.moduleKey  = gParamNameEdit.moduleKey;
                     msg.paramLabelData.paramIndex = pi;
                     COPY_STRING(msg.paramLabelData.name, gParamNameEdit.buffer);
-                    msg_send(&gToUsbThread, &msg);
+                    send_usb_command(&msg);
                     undo_push_param_name(gParamNameEdit.moduleKey, pi, li,
                                          oldName, oldSet,
                                          gParamNameEdit.buffer, true);
@@ -1394,7 +1394,7 @@ void key_callback(int key, int scancode, int action, int mods) {
                 COPY_STRING(gGlobalSettings.perfName, gPerfNameEdit.buffer);
                 tMessageContent messageContent = {0};
                 messageContent.cmd   = eMsgCmdWritePerfName;
-                msg_send(&gToUsbThread, &messageContent);
+                send_usb_command(&messageContent);
                 undo_push_perf_name(oldPerfName, gPerfNameEdit.buffer);
             } else if (key == GLFW_KEY_ESCAPE) {
                 gPerfNameEdit.active = false;
@@ -151,7 +151,7 @@ bool handle_patch_notes_mouse(tCoord coord, tMouseButton mouseButton) {
 
             msg.cmd                                    = eMsgCmdWritePatch;
             msg.slot                                   = gPatchNotesEdit.slot;
-            msg_send(&gToUsbThread, &msg);
+            send_usb_command(&msg);
         } else if (wasDiscardPressed && within_rectangle(coord, gPatchNotesDiscardRect)) {
             origLen                   = strlen(gPatchNotesEdit.original);
             memset(gPatchNotesEdit.buffer, 0, sizeof(gPatchNotesEdit.buffer));
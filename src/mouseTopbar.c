@@ -51,6 +51,7 @@ extern "C" {
 #include "mouseTopbar.h"
 #include "undo.h"
 #include "canvasDrag.h"
+#include "soundEngine.h"
 
 static void handle_button(tTopbarControlId controlId) {
     uint32_t slot = gSlot;
@@ -79,6 +80,7 @@ static void handle_button(tTopbarControlId controlId) {
                 break;
             }
             gPatchDescr[slot].activeVariation      = variation;
+            sound_engine_select_variation(slot, variation);   // heard now, not at the next redraw
 
             set_exclusive_button_highlight(topbarVariation1Id, topbarVariationInitId, controlId);
 
@@ -86,7 +88,7 @@ static void handle_button(tTopbarControlId controlId) {
             messageContent.cmd                     = eMsgCmdSelectVariation;
             messageContent.slot                    = slot;
             messageContent.variationData.variation = variation;
-            msg_send(&gToUsbThread, &messageContent);
+            send_usb_command(&messageContent);
 
             break;
         }
@@ -103,7 +105,7 @@ static void handle_button(tTopbarControlId controlId) {
             messageContent.cmd           = eMsgCmdSelectSlot;
             messageContent.slot          = slot;
             messageContent.slotData.slot = slot;
-            msg_send(&gToUsbThread, &messageContent);
+            send_usb_command(&messageContent);
 
             set_exclusive_button_highlight(topbarSlotAId, topbarSlotDId, controlId);
             set_exclusive_button_highlight(topbarVariation1Id, topbarVariationInitId,
@@ -225,7 +227,7 @@ bool handle_topbar_left_up(tCoord coord, uint32_t slot) {
                 synthlib_request_redraw();
                 messageContent.cmd  = eMsgCmdWritePatchDescr;
                 messageContent.slot = slot;
-                msg_send(&gToUsbThread, &messageContent);
+                send_usb_command(&messageContent);
                 found               = true;
                 break;
             }
@@ -269,7 +271,7 @@ bool handle_topbar_left_up(tCoord coord, uint32_t slot) {
                 messageContent.cmd       = eMsgCmdWriteModePatch;
                 gGlobalSettings.perfMode = 0;
             }
-            msg_send(&gToUsbThread, &messageContent);
+            send_usb_command(&messageContent);
             found = true;
         }
     }
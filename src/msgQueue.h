@@ -110,7 +110,9 @@ typedef enum {
     eMsgCmdRestoreEverything,
     eMsgCmdSetMutationLock,
     eMsgCmdPlayNote,
-    eMsgCmdSendCtrlSnapshot
+    eMsgCmdSendCtrlSnapshot,
+    eMsgCmdBeginBatch,           // no data: the commands up to eMsgCmdEndBatch are one edit (see send_batch_begin())
+    eMsgCmdEndBatch
     //eMsgCmdReloadAllPatchData
 } eMsgCmd;
 
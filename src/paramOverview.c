@@ -126,12 +126,12 @@ static void move_assignment(uint32_t from, uint32_t to) {
         if (gGlobalKnobArray[to].assigned) {
             msg.cmd                              = eMsgCmdDeassignGlobalKnob;
             msg.globalKnobDeassignData.knobIndex = to;
-            msg_send(&gToUsbThread, &msg);
+            send_usb_command(&msg);
             memset(&msg, 0, sizeof(msg));
         }
         msg.cmd                              = eMsgCmdDeassignGlobalKnob;
         msg.globalKnobDeassignData.knobIndex = from;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         memset(&msg, 0, sizeof(msg));
 
         gGlobalKnobArray[to]                 = moving;
@@ -145,7 +145,7 @@ static void move_assignment(uint32_t from, uint32_t to) {
         msg.globalKnobAssignData.moduleIndex = moving.moduleIndex;
         msg.globalKnobAssignData.paramIndex  = moving.paramIndex;
         msg.globalKnobAssignData.knobIndex   = to;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
 
         undo_commit_global_knob_edit();
     } else {
@@ -164,7 +164,7 @@ static void move_assignment(uint32_t from, uint32_t to) {
 
         msg.cmd                     = eMsgCmdWritePatch;
         msg.slot                    = slot;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
     synthlib_request_redraw();
 }
@@ -38,6 +38,8 @@ extern "C" {
 #include "dataBase.h"
 #include "moduleResourcesAccess.h"
 #include "msgQueue.h"
+#include "rtLog.h"
+#include "soundEngine.h"   // sound_engine_lane_edited() — every local parameter write ends up here
 #include "globalVars.h"
 #include "undo.h"   // undo_push_param_change() — the linked-variation fan-out records one entry per variation
 
@@ -60,7 +62,7 @@ extern "C" {
 // device parameters lack is a table row to draw them with — they are stored, just not shown.
 //
 // Recorded to ~/G2_param_count_mismatch.log in APPEND mode, the point being to outlive the session
-// it happened in (usbLog.c opens with "w" and is gated behind ENABLE_USB_LOG, so it is no use here).
+// it happened in (usbLog.c is gated behind ENABLE_USB_LOG, so it is no use here).
 // Once per module type per session, so a patch full of the same offender writes one line, not one
 // per instance. USB-thread only, which is what makes the plain static safe.
 static void record_param_count_mismatch(tModuleType moduleType, uint32_t deviceCount, uint32_t tableCount) {
@@ -98,7 +100,8 @@ void read_clavia_string(uint8_t * buff, uint32_t * bitPos, char * name, int name
     int i = 0;
 
     if (nameSize != CLAVIA_NAME_SIZE + 1) {
-        LOG_ERROR("Called with invalid size of %d\n", nameSize);
+        RT_LOG_ERROR("Called with invalid size of %d\n", nameSize);
+        rt_log_flush();
         exit(1);
     }
     pthread_mutex_lock(&gStringCopyMutex);
@@ -251,7 +254,7 @@ void parse_module_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
         key.index                   = read_bit_stream(buff, subOffset, 8);
 
         if ((key.location >= (uint32_t)locationMax) || (key.index >= MAX_NUM_MODULES)) {
-            LOG_ERROR("Module key out of bounds location=%u index=%u\n", key.location, key.index);
+            RT_LOG_ERROR("Module key out of bounds location=%u index=%u\n", key.location, key.index);
             break;
         }
         module                      = get_module_slot(key.slot, key.location, key.index);
@@ -272,9 +275,9 @@ void parse_module_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
         // took the whole editor down, in Release as well as Debug, and — LOG_MODULE_DATA being
         // compiled out in every configuration — did it without printing anything at all.
         if (module->modeCount > MAX_NUM_MODES) {
-            LOG_ERROR("Module type %u reports %u modes, MAX_NUM_MODES is %u — storing the first %u\n",
-                      module->type, module->modeCount, MAX_NUM_MODES, MAX_NUM_MODES);
-            EXIT_IN_DEBUG();
+            RT_LOG_ERROR("Module type %u reports %u modes, MAX_NUM_MODES is %u — storing the first %u\n",
+                         module->type, module->modeCount, MAX_NUM_MODES, MAX_NUM_MODES);
+            RT_LOG_EXIT_IN_DEBUG();
         }
         // The connector array is static per module type, and the sound engine's cable lookups read
         // it. Fill it here rather than leaving it to the renderer, so a patch parsed with no GUI
@@ -442,7 +445,7 @@ void parse_param_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
     // load. write_param_list() writes 9/10 even when empty, so this is about what we READ, not what
     // we produce.
     if ((moduleCount > 0) && (numVariations != 9) && (numVariations != 10)) {
-        LOG_ERROR("parse_param_list: unexpected Variation Count %u (expected 9 or 10)\n", numVariations);
+        RT_LOG_ERROR("parse_param_list: unexpected Variation Count %u (expected 9 or 10)\n", numVariations);
     }
 
     if (numVariations > 10) {
@@ -457,12 +460,13 @@ void parse_param_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
         LOG_MODULE_DATA("  variation list param count = %u\n", paramCount);
 
         if (paramCount >= MAX_NUM_PARAMETERS) {
-            LOG_ERROR("MAX_NUM_PARAMETERS needs increasing to >= %u\n", paramCount + 1);
+            RT_LOG_ERROR("MAX_NUM_PARAMETERS needs increasing to >= %u\n", paramCount + 1);
+            rt_log_flush();
             exit(1);
         }
 
         if ((key.location >= (uint32_t)locationMax) || (key.index >= MAX_NUM_MODULES)) {
-            LOG_ERROR("parse_param_list: key out of bounds location=%u index=%u\n", key.location, key.index);
+            RT_LOG_ERROR("parse_param_list: key out of bounds location=%u index=%u\n", key.location, key.index);
             break;
         }
         tModule * module = get_module_slot(key.slot, key.location, key.index);
@@ -476,7 +480,7 @@ void parse_param_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
         // correct is worse than no check, because it trains you to ignore the one that isn't.
         if ((module->type != moduleTypeUnknown0) && (module_device_param_count(module->type) > 0)) {
             if (paramCount != module_device_param_count(module->type)) {
-                LOG_ERROR("Incorrect number of parameters on module %u %s count from G2 = %u, our structures = %u\n", module->type, gModuleProperties[module->type].name, paramCount, module_device_param_count(module->type));
+                RT_LOG_ERROR("Incorrect number of parameters on module %u %s count from G2 = %u, our structures = %u\n", module->type, gModuleProperties[module->type].name, paramCount, module_device_param_count(module->type));
                 record_param_count_mismatch(module->type, paramCount, module_device_param_count(module->type));
             }
         }
@@ -489,7 +493,7 @@ void parse_param_list(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
             }
 
             if (j != variation) {
-                LOG_WARNING("loop var %u != variation %u\n", j, variation);
+                RT_LOG_WARNING("loop var %u != variation %u\n", j, variation);
             }
 
             for (k = 0; k < paramCount; k++) {
@@ -628,7 +632,7 @@ void parse_morph_params(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
                 if (morph < NUM_MORPHS) {
                     module->param[variation][paramIndex].morphRange[morph] = (uint8_t)range;
                 } else {
-                    LOG_ERROR("morph index %u out of range\n", morph);
+                    RT_LOG_ERROR("morph index %u out of range\n", morph);
                 }
             }
         }
@@ -724,7 +728,7 @@ void parse_knobs(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
     // The G2 always sends exactly KNOB_COUNT (120) entries; guard against
     // malformed data sending more than we have storage for.
     if (knobCount > MAX_NUM_KNOBS) {
-        LOG_ERROR("parse_knobs: knobCount %u exceeds KNOB_COUNT %u\n", knobCount, MAX_NUM_KNOBS);
+        RT_LOG_ERROR("parse_knobs: knobCount %u exceeds KNOB_COUNT %u\n", knobCount, MAX_NUM_KNOBS);
         knobCount = MAX_NUM_KNOBS;
     }
     // Clear the list before repopulating
@@ -748,7 +752,7 @@ void parse_global_knobs(uint8_t * buff, uint32_t * bitPos) {
     LOG_MODULE_DATA("  Global knob count %u\n", knobCount);
 
     if (knobCount > MAX_NUM_KNOBS) {
-        LOG_ERROR("parse_global_knobs: count %u exceeds %u\n", knobCount, MAX_NUM_KNOBS);
+        RT_LOG_ERROR("parse_global_knobs: count %u exceeds %u\n", knobCount, MAX_NUM_KNOBS);
         knobCount = MAX_NUM_KNOBS;
     }
     memset(gGlobalKnobArray, 0, sizeof(gGlobalKnobArray));
@@ -814,7 +818,7 @@ void parse_controllers(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
     LOG_MODULE_DATA("  Controller Count %u\n", controllerCount);
 
     if (controllerCount > MAX_NUM_CONTROLLERS) {
-        LOG_ERROR("Controller count %u exceeds MAX_NUM_CONTROLLERS %u\n", controllerCount, MAX_NUM_CONTROLLERS);
+        RT_LOG_ERROR("Controller count %u exceeds MAX_NUM_CONTROLLERS %u\n", controllerCount, MAX_NUM_CONTROLLERS);
         controllerCount = MAX_NUM_CONTROLLERS;
     }
 
@@ -839,7 +843,7 @@ void parse_controllers(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
                 module->param[0][paramIndex].midiCC    = gControllerArray[slot].controller[i].midiCC;
                 module->param[0][paramIndex].hasMidiCC = true;
             } else {
-                LOG_ERROR("Controller paramIndex %u out of range for module %u\n", paramIndex, key.index);
+                RT_LOG_ERROR("Controller paramIndex %u out of range for module %u\n", paramIndex, key.index);
             }
         }
     }
@@ -899,7 +903,7 @@ void parse_param_names(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
         LOG_MODULE_DATA("Module index      %d\n", key.index);
 
         if ((key.location >= (uint32_t)locationMax) || (key.index >= MAX_NUM_MODULES)) {
-            LOG_ERROR("parse_param_names: key out of bounds location=%u index=%u\n", key.location, key.index);
+            RT_LOG_ERROR("parse_param_names: key out of bounds location=%u index=%u\n", key.location, key.index);
             break;
         }
         tModule * module = get_module_slot(key.slot, key.location, key.index);
@@ -945,8 +949,8 @@ void parse_param_names(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
             // cosmetic. If it is ever wanted it wants the reference editor's reader, not a guess from
             // a single capture.
             if (isString != 1) {
-                LOG_DEBUG("param names: module %u record type %u is not a name list, skipping its %u bytes\n",
-                          key.index, isString, moduleLength);
+                RT_LOG_DEBUG("param names: module %u record type %u is not a name list, skipping its %u bytes\n",
+                             key.index, isString, moduleLength);
                 break;
             }
 
@@ -958,18 +962,19 @@ void parse_param_names(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
             // too: if this ever fires again it should be answerable from one capture.
             if ((paramLength > 0) && ((j + (int)(paramLength - 1)) > (int)moduleLength)) {
                 uint32_t dumpStart        = BIT_TO_BYTE(entryStart);
-                char     dump[3 * 24 + 1] = {0};
+                char     dump[2][3 * 12 + 1] = {{0}};     // two lines: an rt_log entry holds 64 bytes of %s
 
                 for (uint32_t d = 0; d < 24; d++) {
-                    snprintf(&dump[d * 3], 4, "%02x ", buff[dumpStart + d]);
+                    snprintf(&dump[d / 12][(d % 12) * 3], 4, "%02x ", buff[dumpStart + d]);
                 }
 
-                LOG_ERROR("param name payload %u overruns module section (%d of %u used), stopping\n",
-                          paramLength - 1, j, moduleLength);
-                LOG_ERROR("  module index %u, entry started at byte %u, isString %u paramIndex %u\n",
-                          key.index, dumpStart, isString, paramIndex);
-                LOG_ERROR("  bytes from there: %s\n", dump);
-                EXIT_IN_DEBUG();
+                RT_LOG_ERROR("param name payload %u overruns module section (%d of %u used), stopping\n",
+                             paramLength - 1, j, moduleLength);
+                RT_LOG_ERROR("  module index %u, entry started at byte %u, isString %u paramIndex %u\n",
+                             key.index, dumpStart, isString, paramIndex);
+                RT_LOG_ERROR("  bytes from there: %s\n", dump[0]);
+                RT_LOG_ERROR("                    %s\n", dump[1]);
+                RT_LOG_EXIT_IN_DEBUG();
                 break;
             }
             LOG_MODULE_DATA("Param name: ");
@@ -990,18 +995,18 @@ void parse_param_names(uint32_t slot, uint8_t * buff, uint32_t * subOffset) {
                 if (module == NULL) {
                     // A name for a module the patch never declared. The section still has to be
                     // stepped over; storing it has nowhere to go.
-                    LOG_WARNING("param names for absent module index %u, skipping\n", key.index);
+                    RT_LOG_WARNING("param names for absent module index %u, skipping\n", key.index);
                     skipParam = true;
                 } else if (numLabels > MAX_NUM_LABELS) {
-                    LOG_ERROR("numLabels %u exceeds maximum %u for param %u, skipping\n", numLabels, MAX_NUM_LABELS, paramIndex);
-                    EXIT_IN_DEBUG();
+                    RT_LOG_ERROR("numLabels %u exceeds maximum %u for param %u, skipping\n", numLabels, MAX_NUM_LABELS, paramIndex);
+                    RT_LOG_EXIT_IN_DEBUG();
                     skipParam = true;
                 } else if (paramIndex >= MAX_NUM_PARAMETERS) {
-                    LOG_WARNING("paramIndex %u exceeds maximum %u, skipping\n", paramIndex, MAX_NUM_PARAMETERS);
+                    RT_LOG_WARNING("paramIndex %u exceeds maximum %u, skipping\n", paramIndex, MAX_NUM_PARAMETERS);
                     skipParam = true;
                 } else if (sizeof(module->paramName[0]) < (numLabels * PROTOCOL_PARAM_NAME_SIZE)) {
-                    LOG_ERROR("paramName array too small for %u labels, skipping\n", numLabels);
-                    EXIT_IN_DEBUG();
+                    RT_LOG_ERROR("paramName array too small for %u labels, skipping\n", numLabels);
+                    RT_LOG_EXIT_IN_DEBUG();
                     skipParam = true;
                 }
 
@@ -1291,7 +1296,7 @@ void store_patch_notes(uint32_t slot, uint8_t * buff, uint32_t * bitPos, uint32_
     notesSize             = count;
 
     if (notesSize > sizeof(gPatchNotes[0]) - 1) {
-        LOG_ERROR("Patch notes size %u exceeds limit\n", notesSize);
+        RT_LOG_ERROR("Patch notes size %u exceeds limit\n", notesSize);
         notesSize = (uint32_t)(sizeof(gPatchNotes[0]) - 1);
     }
     gPatchNotesSize[slot] = 0;
@@ -1355,25 +1360,25 @@ int parse_synth_settings(uint8_t * buff, int length) {
     read_bit_stream(buff, &bitPos, 7);
     gSynthSettings.pedalGain         = read_bit_stream(buff, &bitPos, 8);
 
-    LOG_DEBUG("Name=%s\n",
-              gSynthSettings.name);
-    LOG_DEBUG("MIDI chan A=%u B=%u C=%u D=%u Global=%u SysexID=%u\n",
-              gSynthSettings.midiChanSlot[0], gSynthSettings.midiChanSlot[1],
-              gSynthSettings.midiChanSlot[2], gSynthSettings.midiChanSlot[3],
-              gSynthSettings.globalChan, gSynthSettings.sysexId);
-    LOG_DEBUG("LocalOn=%u MemProt=%u ProgRcv=%u ProgSnd=%u CtrlRcv=%u CtrlSnd=%u\n",
-              gSynthSettings.localOn, gSynthSettings.memoryProtect,
-              gSynthSettings.progChangeRcv, gSynthSettings.progChangeSnd,
-              gSynthSettings.controllersRcv, gSynthSettings.controllersSnd);
-    LOG_DEBUG("SendClock=%u ReceiveClock=%u TuneCent=%d TuneSemi=%d OctShift=%d ShiftActive=%u\n",
-              gSynthSettings.sendClock, gSynthSettings.receiveClock,
-              gSynthSettings.tuneCent, gSynthSettings.tuneSemi,
-              gSynthSettings.globalOctaveShift, gSynthSettings.globalShiftActive);
-    LOG_DEBUG("PedalPol=%u PedalGain=%u PerfMode=%u PerfBank=%u PerfLoc=%u\n",
-              gSynthSettings.pedalPolarity, gSynthSettings.pedalGain,
-              gGlobalSettings.perfMode, gSynthSettings.perfBank, gSynthSettings.perfLocation);
-    LOG_DEBUG("Patch Sort Mode=%u Perf Sort Mode=%u\n",
-              gSynthSettings.patchSortMode, gSynthSettings.perfSortMode);
+    RT_LOG_DEBUG("Name=%s\n",
+                 gSynthSettings.name);
+    RT_LOG_DEBUG("MIDI chan A=%u B=%u C=%u D=%u Global=%u SysexID=%u\n",
+                 gSynthSettings.midiChanSlot[0], gSynthSettings.midiChanSlot[1],
+                 gSynthSettings.midiChanSlot[2], gSynthSettings.midiChanSlot[3],
+                 gSynthSettings.globalChan, gSynthSettings.sysexId);
+    RT_LOG_DEBUG("LocalOn=%u MemProt=%u ProgRcv=%u ProgSnd=%u CtrlRcv=%u CtrlSnd=%u\n",
+                 gSynthSettings.localOn, gSynthSettings.memoryProtect,
+                 gSynthSettings.progChangeRcv, gSynthSettings.progChangeSnd,
+                 gSynthSettings.controllersRcv, gSynthSettings.controllersSnd);
+    RT_LOG_DEBUG("SendClock=%u ReceiveClock=%u TuneCent=%d TuneSemi=%d OctShift=%d ShiftActive=%u\n",
+                 gSynthSettings.sendClock, gSynthSettings.receiveClock,
+                 gSynthSettings.tuneCent, gSynthSettings.tuneSemi,
+                 gSynthSettings.globalOctaveShift, gSynthSettings.globalShiftActive);
+    RT_LOG_DEBUG("PedalPol=%u PedalGain=%u PerfMode=%u PerfBank=%u PerfLoc=%u\n",
+                 gSynthSettings.pedalPolarity, gSynthSettings.pedalGain,
+                 gGlobalSettings.perfMode, gSynthSettings.perfBank, gSynthSettings.perfLocation);
+    RT_LOG_DEBUG("Patch Sort Mode=%u Perf Sort Mode=%u\n",
+                 gSynthSettings.patchSortMode, gSynthSettings.perfSortMode);
 
     return EXIT_SUCCESS;
 }
@@ -1387,7 +1392,7 @@ int parse_performance_settings(uint8_t * buff, int length) {
     }
     memset(gGlobalSettings.perfName, 0, sizeof(gGlobalSettings.perfName));
     read_clavia_string(buff, &bitPos, gGlobalSettings.perfName, sizeof(gGlobalSettings.perfName));
-    LOG_DEBUG("Performance Name     = '%s'\n", gGlobalSettings.perfName);
+    RT_LOG_DEBUG("Performance Name     = '%s'\n", gGlobalSettings.perfName);
 
     uint32_t keyboardRangeEnab = 0;
     uint32_t rangeEnable       = 0;
@@ -1396,20 +1401,20 @@ int parse_performance_settings(uint8_t * buff, int length) {
     read_bit_stream(buff, &bitPos, 8);                                           // Regular val of 17?
     read_bit_stream(buff, &bitPos, 8);
     keyboardRangeEnab                  = read_bit_stream(buff, &bitPos, 8);      // Regular val of 82 for standard mode and 87 for performance mode? Seen 0x74 for standard an 0x80 for perf too. Seems to be keyboard range enabled!
-    LOG_DEBUG("Keyboard Range Enab  = %u\n", keyboardRangeEnab);
+    RT_LOG_DEBUG("Keyboard Range Enab  = %u\n", keyboardRangeEnab);
     read_bit_stream(buff, &bitPos, 8);
     read_bit_stream(buff, &bitPos, 4);
     gGlobalSettings.selectedSlot       = read_bit_stream(buff, &bitPos, 2);
-    LOG_DEBUG("SelectedSlot         = %u\n", gGlobalSettings.selectedSlot);
+    RT_LOG_DEBUG("SelectedSlot         = %u\n", gGlobalSettings.selectedSlot);
     read_bit_stream(buff, &bitPos, 2);
     rangeEnable                        = read_bit_stream(buff, &bitPos, 8);
-    LOG_DEBUG("RangeEnable          = %u\n", rangeEnable);
+    RT_LOG_DEBUG("RangeEnable          = %u\n", rangeEnable);
     gGlobalSettings.masterClock        = read_bit_stream(buff, &bitPos, 8);  // This is used whether we're in performance mode or not. It's shared with non-perf mode
-    LOG_DEBUG("MasterClock          = %u\n", gGlobalSettings.masterClock);
+    RT_LOG_DEBUG("MasterClock          = %u\n", gGlobalSettings.masterClock);
     keyboardSplit                      = read_bit_stream(buff, &bitPos, 8);
-    LOG_DEBUG("KeyboardSplit        = %u\n", keyboardSplit);
+    RT_LOG_DEBUG("KeyboardSplit        = %u\n", keyboardSplit);
     gGlobalSettings.masterClockRunning = read_bit_stream(buff, &bitPos, 8);
-    LOG_DEBUG("MasterClockRun       = %u\n", gGlobalSettings.masterClockRunning);
+    RT_LOG_DEBUG("MasterClockRun       = %u\n", gGlobalSettings.masterClockRunning);
     read_bit_stream(buff, &bitPos, 8);
     read_bit_stream(buff, &bitPos, 8);
 
@@ -1422,15 +1427,15 @@ int parse_performance_settings(uint8_t * buff, int length) {
         read_bit_stream(buff, &bitPos, 8); // Patch index
         gPerfSettings.slot[i].rangeLower      = (uint8_t)read_bit_stream(buff, &bitPos, 8);
         gPerfSettings.slot[i].rangeUpper      = (uint8_t)read_bit_stream(buff, &bitPos, 8);
-        LOG_DEBUG("Slot %d:\n", i);
-        LOG_DEBUG("  PatchName         = '%s'\n", gGlobalSettings.slot[i].patchName);
-        LOG_DEBUG("  Active            = %u\n", gGlobalSettings.slot[i].enabled);
-        LOG_DEBUG("  Key               = %u\n", gPerfSettings.slot[i].keyboardEnabled);
-        LOG_DEBUG("  Hold              = %u\n", gPerfSettings.slot[i].holdEnabled);
-        LOG_DEBUG("  BankIndex         = %u\n", 0);
-        LOG_DEBUG("  PatchIndex        = %u\n", 0);
-        LOG_DEBUG("  RangeLower        = %u\n", gPerfSettings.slot[i].rangeLower);
-        LOG_DEBUG("  RangeUpper        = %u\n", gPerfSettings.slot[i].rangeUpper);
+        RT_LOG_DEBUG("Slot %d:\n", i);
+        RT_LOG_DEBUG("  PatchName         = '%s'\n", gGlobalSettings.slot[i].patchName);
+        RT_LOG_DEBUG("  Active            = %u\n", gGlobalSettings.slot[i].enabled);
+        RT_LOG_DEBUG("  Key               = %u\n", gPerfSettings.slot[i].keyboardEnabled);
+        RT_LOG_DEBUG("  Hold              = %u\n", gPerfSettings.slot[i].holdEnabled);
+        RT_LOG_DEBUG("  BankIndex         = %u\n", 0);
+        RT_LOG_DEBUG("  PatchIndex        = %u\n", 0);
+        RT_LOG_DEBUG("  RangeLower        = %u\n", gPerfSettings.slot[i].rangeLower);
+        RT_LOG_DEBUG("  RangeUpper        = %u\n", gPerfSettings.slot[i].rangeUpper);
 
         read_bit_stream(buff, &bitPos, 8);
         read_bit_stream(buff, &bitPos, 8);
@@ -1479,15 +1484,15 @@ int parse_midi_cc(uint8_t * buff, int length, uint32_t slot) {
         // every sample seen so far, so nothing distinguishes them. It is logged rather than used.
         // If it is the slot, the sentinel records below will carry 1, 2 and 3.
         if (ccNumVal > 127) {
-            LOG_DEBUG("MIDI CC: slot %u none (first byte 0x%02x, value 0x%02x)\n",
-                      target, first, ccNumVal);
+            RT_LOG_DEBUG("MIDI CC: slot %u none (first byte 0x%02x, value 0x%02x)\n",
+                         target, first, ccNumVal);
         } else if (target < MAX_SLOTS) {
             gLastDeviceMidiChan[target] = (int32_t)first;
             atomic_store(&gLastDeviceMidiCC[target], (int32_t)ccNumVal);
             gDeviceMidiCCCount++;
-            LOG_INFO("MIDI CC %u %s slot %u (first byte 0x%02x)\n", ccNumVal,
-                     (gMidiCCSolicited == true) ? "last seen by" : "received from synth on",
-                     target, first);
+            RT_LOG_INFO("MIDI CC %u %s slot %u (first byte 0x%02x)\n", ccNumVal,
+                        (gMidiCCSolicited == true) ? "last seen by" : "received from synth on",
+                        target, first);
         }
         record++;
 
@@ -1525,7 +1530,7 @@ int parse_patch_version(uint8_t * buff, int length) {
     } else {
         return EXIT_FAILURE;
     }
-    LOG_DEBUG("Parsed patch version slot %u = 0x%02x or %u\n", slot, version, version);
+    RT_LOG_DEBUG("Parsed patch version slot %u = 0x%02x or %u\n", slot, version, version);
     return EXIT_SUCCESS;
 }
 
@@ -1557,19 +1562,19 @@ int parse_patch(uint32_t slot, uint8_t * buff, int length) {
             // message that ends mid-header would read past `length` — the same mismatch between
             // guard and body that made parse_midi_cc() silently wrong.
             if ((BIT_TO_BYTE(bitOffset) + 2) > (uint32_t)length) {
-                LOG_ERROR("parse_patch: truncated header for type 0x%02x, aborting\n", type);
+                RT_LOG_ERROR("parse_patch: truncated header for type 0x%02x, aborting\n", type);
                 return EXIT_FAILURE;
             }
             count = (int16_t)read_bit_stream(buff, &bitOffset, 16);
 
             if (count < 0) {
-                LOG_ERROR("parse_patch: negative count %d for type 0x%02x, aborting\n", count, type);
+                RT_LOG_ERROR("parse_patch: negative count %d for type 0x%02x, aborting\n", count, type);
                 return EXIT_FAILURE;
             }
 
             if (BIT_TO_BYTE(bitOffset) + count > length) {
-                LOG_ERROR("parse_patch: count %d for type 0x%02x would exceed buffer length %d, aborting\n",
-                          count, type, length);
+                RT_LOG_ERROR("parse_patch: count %d for type 0x%02x would exceed buffer length %d, aborting\n",
+                             count, type, length);
                 return EXIT_FAILURE;
             }
         }
@@ -1604,7 +1609,7 @@ int parse_patch(uint32_t slot, uint8_t * buff, int length) {
 
             case SUB_RESPONSE_PATCH_DESCRIPTION:
             {
-                LOG_DEBUG("Patch Descr\n");
+                RT_LOG_DEBUG("Patch Descr\n");
                 parse_patch_descr(slot, buff, &subOffset);
                 break;
             }
@@ -1622,17 +1627,17 @@ int parse_patch(uint32_t slot, uint8_t * buff, int length) {
                 break;
 
             case SUB_RESPONSE_CURRENT_NOTE_2:
-                LOG_DEBUG("Current note 2\n");
+                RT_LOG_DEBUG("Current note 2\n");
                 store_note2(slot, buff, &subOffset, (uint32_t)count);
                 break;
 
             case SUB_RESPONSE_PATCH_NOTES:
-                LOG_DEBUG("Patch notes\n");
+                RT_LOG_DEBUG("Patch notes\n");
                 store_patch_notes(slot, buff, &subOffset, (uint32_t)count);
                 break;
 
             default:
-                LOG_DEBUG("Unprocessed type 0x%02x\n", type);
+                RT_LOG_DEBUG("Unprocessed type 0x%02x\n", type);
                 break;
         }
         bitOffset += SIGNED_BYTE_TO_BIT(count);
@@ -1659,7 +1664,7 @@ int parse_perf(uint8_t * buff, int length) {
     headerType                         = (uint8_t)read_bit_stream(buff, &bitOffset, 8);
 
     if (headerType != 0x11) {
-        LOG_ERROR("parse_perf: expected perf header 0x11, got 0x%02x\n", headerType);
+        RT_LOG_ERROR("parse_perf: expected perf header 0x11, got 0x%02x\n", headerType);
         return EXIT_FAILURE;
     }
     read_bit_stream(buff, &bitOffset, 8);                                    // unknown (0x00)
@@ -1681,7 +1686,7 @@ int parse_perf(uint8_t * buff, int length) {
     for (slot = 0; slot < MAX_SLOTS; slot++) {
         read_clavia_string(buff, &bitOffset, gGlobalSettings.slot[slot].patchName, sizeof(gGlobalSettings.slot[slot].patchName));
 
-        LOG_DEBUG("Slot %u name '%s'\n", slot, gGlobalSettings.slot[slot].patchName);
+        RT_LOG_DEBUG("Slot %u name '%s'\n", slot, gGlobalSettings.slot[slot].patchName);
         enabled                            = (uint8_t)read_bit_stream(buff, &bitOffset, 8); // IsSlotEnabled
         gGlobalSettings.slot[slot].enabled = enabled;
 
@@ -1712,18 +1717,18 @@ int parse_perf(uint8_t * buff, int length) {
         if (type != SUB_RESPONSE_SEL_PARAM_PAGE) {
             // See parse_patch(): the guard covers the type byte only, the count is two more.
             if ((BIT_TO_BYTE(bitOffset) + 2) > (uint32_t)length) {
-                LOG_ERROR("parse_perf: truncated header for type 0x%02x, aborting\n", type);
+                RT_LOG_ERROR("parse_perf: truncated header for type 0x%02x, aborting\n", type);
                 return EXIT_FAILURE;
             }
             count = (int16_t)read_bit_stream(buff, &bitOffset, 16);
 
             if (count < 0) {
-                LOG_ERROR("parse_perf: negative count %d for type 0x%02x, aborting\n", count, type);
+                RT_LOG_ERROR("parse_perf: negative count %d for type 0x%02x, aborting\n", count, type);
                 return EXIT_FAILURE;
             }
 
             if (BIT_TO_BYTE(bitOffset) + count > length) {
-                LOG_ERROR("parse_perf: count %d for type 0x%02x exceeds buffer, aborting\n", count, type);
+                RT_LOG_ERROR("parse_perf: count %d for type 0x%02x exceeds buffer, aborting\n", count, type);
                 return EXIT_FAILURE;
             }
         }
@@ -1789,7 +1794,7 @@ int parse_perf(uint8_t * buff, int length) {
                 break;
 
             default:
-                LOG_DEBUG("parse_perf: unprocessed type 0x%02x slot %u\n", type, currentSlot);
+                RT_LOG_DEBUG("parse_perf: unprocessed type 0x%02x slot %u\n", type, currentSlot);
                 break;
         }
         bitOffset += SIGNED_BYTE_TO_BIT(count);
@@ -1797,6 +1802,27 @@ int parse_perf(uint8_t * buff, int length) {
     return EXIT_SUCCESS;
 }
 
+// THE ONE WAY A COMMAND REACHES THE USB THREAD: queued on gToUsbThread, then the thread woken. It
+// sleeps when idle (see the end of state_handler() in usbComms.c) and only wakes for the G2 or for
+// this, so a command queued with a bare msg_send() would sit there until the G2 next said something.
+//
+// The wake is registered rather than called so this file still links where there is no USB thread —
+// the plug-in and the tools, where it stays NULL. start_usb_thread() registers it before the thread
+// exists, on the thread that goes on to run the UI, so every sender sees it.
+static void (*usb_command_wake_func_ptr)(void) = NULL;
+
+void register_usb_command_wake_cb(void ( *func_ptr )(void)) {
+    usb_command_wake_func_ptr = func_ptr;
+}
+
+void send_usb_command(const tMessageContent * command) {
+    msg_send(&gToUsbThread, command);
+
+    if (usb_command_wake_func_ptr != NULL) {
+        usb_command_wake_func_ptr();
+    }
+}
+
 void send_module_move_msg(tModule * module) {
     tMessageContent messageContent = {0};
     uint32_t        slot           = gSlot;
@@ -1806,7 +1832,26 @@ void send_module_move_msg(tModule * module) {
     messageContent.moduleData.moduleKey = module->key;
     messageContent.moduleData.row       = module->row;
     messageContent.moduleData.column    = module->column;
-    msg_send(&gToUsbThread, &messageContent);
+    send_usb_command(&messageContent);
+}
+
+// Brackets an edit that goes out as many commands — a paste, undoing one — so the USB thread sends
+// all of them inside one stop/start window rather than pausing and resuming the G2 around each. The
+// markers carry nothing and change nothing; a window that runs out of time before the end marker
+// simply closes, and what is left goes out as it would have anyway. See send_batch_window() in
+// usbComms.c.
+void send_batch_begin(void) {
+    tMessageContent messageContent = {0};
+
+    messageContent.cmd = eMsgCmdBeginBatch;
+    send_usb_command(&messageContent);
+}
+
+void send_batch_end(void) {
+    tMessageContent messageContent = {0};
+
+    messageContent.cmd = eMsgCmdEndBatch;
+    send_usb_command(&messageContent);
 }
 
 void send_param_value(uint32_t slot, tModuleKey moduleKey, uint32_t paramIdx, uint32_t variation, uint32_t value) {
@@ -1818,7 +1863,8 @@ void send_param_value(uint32_t slot, tModuleKey moduleKey, uint32_t paramIdx, ui
     msg.paramData.param     = paramIdx;
     msg.paramData.variation = variation;
     msg.paramData.value     = value;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
+    sound_engine_lane_edited(slot, variation);
 }
 
 // Fans a parameter value out to every LINKED variation (see variation_is_linked() in globalVars.h)
@@ -1877,7 +1923,8 @@ void send_param_morph(uint32_t slot, tModuleKey moduleKey, uint32_t paramIdx, ui
     msg.paramMorphData.value      = value;
     msg.paramMorphData.negative   = 0;
     msg.paramMorphData.variation  = variation;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
+    sound_engine_lane_edited(slot, variation);
 }
 
 void send_mode_value(uint32_t slot, tModuleKey moduleKey, uint32_t modeIdx, uint32_t value) {
@@ -1888,7 +1935,7 @@ void send_mode_value(uint32_t slot, tModuleKey moduleKey, uint32_t modeIdx, uint
     msg.modeData.moduleKey = moduleKey;
     msg.modeData.mode      = modeIdx;
     msg.modeData.value     = value;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // SUB_COMMAND_SET_MUTATION_LOCK (0x90) - see its comment in defs.h. Confirmed on real hardware.
@@ -1899,7 +1946,7 @@ void send_mutation_lock_value(uint32_t slot, tModuleKey moduleKey, uint32_t lock
     msg.slot                             = slot;
     msg.moduleMutationLockData.moduleKey = moduleKey;
     msg.moduleMutationLockData.locked    = locked;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 void send_custom_data_value(uint32_t slot, tModuleKey moduleKey) {
@@ -1930,7 +1977,7 @@ void send_custom_data_value(uint32_t slot, tModuleKey moduleKey) {
         paramIdx++;
     }
 
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 void update_module_up_rates(void) {
@@ -1998,7 +2045,7 @@ void update_module_up_rates(void) {
             messageContent.slot                 = slot;
             messageContent.moduleData.moduleKey = module->key;
             messageContent.moduleData.upRate    = module->upRate;
-            msg_send(&gToUsbThread, &messageContent);
+            send_usb_command(&messageContent);
 
             // Retroactively recolour any cable already attached to one of this module's OUTPUTS,
             // matching the original editor's bandwidth-change molecule generation
@@ -2040,7 +2087,7 @@ void update_module_up_rates(void) {
                         cableMsg.cableData.connectorToIoIndex   = cable->key.connectorToIoCount;
                         cableMsg.cableData.linkType             = cable->key.linkType;
                         cableMsg.cableData.colour               = (uint32_t)newColour;
-                        msg_send(&gToUsbThread, &cableMsg);
+                        send_usb_command(&cableMsg);
                     }
                 }
             }
@@ -2123,6 +2170,12 @@ void write_perf_header(uint8_t * buff, uint32_t * bitPos) {
 // to a normal .pch2/.prf2 file's binary body (confirmed by diffing captured responses against
 // real sample files of both types), so it's written verbatim — no re-serialization or CRC
 // recompute needed. typeLabel is "Patch" or "Performance", matching the file's own "Type=" line.
+//
+// This and read_bank_upload_file() below run on the USB thread, during a bank backup or restore,
+// and log with plain LOG_ERROR where the parse above uses RT_LOG_*. Deliberately: each is a blocking
+// fopen/fread/fwrite on that same thread, so a log line that waits on stdio costs nothing the file
+// access has not already cost, and the full path — usually longer than the 64 bytes of %s an rt_log
+// entry keeps — is the useful part of the message.
 void write_bank_upload_file(const char * filepath, const char * typeLabel, const uint8_t * content, uint32_t contentLen) {
     FILE * file         = NULL;
     char   charBuff[64] = {0};
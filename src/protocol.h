@@ -61,7 +61,17 @@ void midi_cc_parse_set_solicited(bool solicited);
 int parse_patch_version(uint8_t * buff, int length);
 int parse_patch(uint32_t slot, uint8_t * buff, int length);
 int parse_perf(uint8_t * buff, int length);
+
+// Queues a command for the G2 and wakes the USB thread to send it. Every command goes this way, never
+// through msg_send(&gToUsbThread, ...) directly — see the definition.
+void send_usb_command(const tMessageContent * command);
+void register_usb_command_wake_cb(void ( *func_ptr )(void));
 void send_module_move_msg(tModule * module);
+
+// Around a bulk edit's commands, so they reach the G2 inside one stop/start window. The first end closes
+// the window, so do not nest them.
+void send_batch_begin(void);
+void send_batch_end(void);
 void send_param_value(uint32_t slot, tModuleKey moduleKey, uint32_t paramIdx, uint32_t variation, uint32_t value);
 
 // Call after send_param_value() at a USER edit, with the same arguments: repeats the write into
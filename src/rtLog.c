@@ -0,0 +1,488 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+
+#include "sysIncludes.h"
+#include "rtLog.h"
+
+// See rtLog.h for what this is for.
+
+#define RT_LOG_RINGS          (8U)      // the audio callback, the USB thread, and room for a host's extras
+#define RT_LOG_ENTRIES        (256U)    // per ring; a power of two, so the indices wrap with a mask
+#define RT_LOG_LINE           (512U)
+#define RT_LOG_DRAIN_NS       (20000000L)
+#define RT_LOG_NAME           (16U)
+#define RT_LOG_NO_STRING      (UINT64_MAX)
+
+typedef struct {
+    const char * format;
+    uint64_t     nanos;                         // CLOCK_MONOTONIC when it was posted
+    uint8_t      level;
+    uint8_t      argCount;
+    uint8_t      stringsUsed;
+    uint64_t     arg[RT_LOG_MAX_ARGS];          // raw bits; %s holds an offset into strings
+    char         strings[RT_LOG_STRING_BYTES];
+} tRtLogEntry;
+
+// ONE WRITER, ONE READER. head is advanced only by the thread that owns the ring, tail only by the
+// drainer; each reads the other's with acquire so the entry behind it is complete.
+typedef struct {
+    _Atomic bool     claimed;
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+    _Atomic uint64_t dropped;
+    uint64_t         reported;                  // drainer only: the dropped count it last said
+    char             name[RT_LOG_NAME];
+    tRtLogEntry      entry[RT_LOG_ENTRIES];
+} tRtLogRing;
+
+static tRtLogRing            gRing[RT_LOG_RINGS];
+static _Thread_local int32_t gThreadRing   = -1;
+static pthread_mutex_t       gDrainerMutex = PTHREAD_MUTEX_INITIALIZER;   // start and stop only
+static pthread_t             gDrainer;
+static uint32_t              gDrainerUsers = 0;
+static _Atomic bool          gDrainerRun   = false;
+static pthread_mutex_t       gDrainMutex   = PTHREAD_MUTEX_INITIALIZER;   // one drain at a time
+
+// A ring given back when its thread exits, for threads that are not ours to stop: a host's audio
+// threads come and go with its thread pool, and without this each one that had ever rendered kept
+// its ring until there were none left. The key's value is the ring's index plus one.
+static pthread_key_t         gExitKey;
+static pthread_once_t        gExitKeyOnce  = PTHREAD_ONCE_INIT;
+static bool                  gExitKeyMade  = false;
+
+static void release_at_exit(void * ring);
+
+static void make_exit_key(void) {
+    gExitKeyMade = (pthread_key_create(&gExitKey, release_at_exit) == 0);
+}
+
+static uint64_t now_nanos(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+bool rt_log_register_thread(const char * name) {
+    if (gThreadRing >= 0) {
+        return true;
+    }
+
+    for (uint32_t r = 0; r < RT_LOG_RINGS; r++) {
+        bool expected = false;
+
+        if (atomic_compare_exchange_strong(&gRing[r].claimed, &expected, true) == true) {
+            snprintf(gRing[r].name, sizeof(gRing[r].name), "%s", (name != NULL) ? name : "rt");
+            gThreadRing = (int32_t)r;
+
+            (void)pthread_once(&gExitKeyOnce, make_exit_key);
+
+            if (gExitKeyMade == true) {
+                (void)pthread_setspecific(gExitKey, (void *)(intptr_t)(r + 1));
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+bool rt_log_thread_is_registered(void) {
+    return gThreadRing >= 0;
+}
+
+uint64_t rt_log_dropped(void) {
+    uint64_t total = 0;
+
+    for (uint32_t r = 0; r < RT_LOG_RINGS; r++) {
+        total += atomic_load(&gRing[r].dropped);
+    }
+    return total;
+}
+
+// Where a conversion specification's conversion character is, and its length modifier, so the post
+// and the drain agree on what each argument is without either of them knowing the call site.
+typedef struct {
+    const char * end;        // one past the conversion character
+    char         conversion;
+    uint32_t     longs;      // 0, 1 (l) or 2 (ll, j, z, t — all 64-bit here)
+    uint32_t     stars;      // '*' widths and precisions, each an int argument of its own
+    bool         longDouble; // L: read as long double, kept as double
+} tRtLogSpec;
+
+static tRtLogSpec parse_spec(const char * percent) {
+    tRtLogSpec   spec = {0};
+    const char * p    = percent + 1;
+
+    while ((*p != '\0') && (strchr("-+ #0123456789.*", *p) != NULL)) {
+        spec.stars += (*p == '*') ? 1U : 0U;
+        p++;
+    }
+
+    while ((*p != '\0') && (strchr("hlLjzt", *p) != NULL)) {
+        spec.longs      += (*p == 'l') ? 1U : ((*p == 'j') || (*p == 'z') || (*p == 't')) ? 2U : 0U;
+        spec.longDouble  = spec.longDouble || (*p == 'L');
+        p++;
+    }
+    spec.conversion = *p;
+    spec.end        = (*p != '\0') ? (p + 1) : p;
+    return spec;
+}
+
+void rt_log_post(tRtLogLevel level, const char * format, ...) {
+    tRtLogRing *  ring  = NULL;
+    tRtLogEntry * entry = NULL;
+    uint32_t      head  = 0;
+    va_list       args;
+
+    if (gThreadRing < 0) {
+        return;
+    }
+    ring = &gRing[gThreadRing];
+    head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    if ((head - atomic_load_explicit(&ring->tail, memory_order_acquire)) >= RT_LOG_ENTRIES) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    entry              = &ring->entry[head & (RT_LOG_ENTRIES - 1U)];
+    entry->format      = format;
+    entry->nanos       = now_nanos();
+    entry->level       = (uint8_t)level;
+    entry->argCount    = 0;
+    entry->stringsUsed = 0;
+
+    // Walk the format only far enough to pull each argument with the type it was passed as. Anything
+    // past RT_LOG_MAX_ARGS is left unread, and the drain prints it as "?".
+    va_start(args, format);
+
+    for (const char * p = strchr(format, '%'); (p != NULL) && (entry->argCount < RT_LOG_MAX_ARGS); p = strchr(p, '%')) {
+        tRtLogSpec spec = parse_spec(p);
+
+        p = spec.end;
+
+        if ((spec.conversion == '%') || (spec.conversion == '\0')) {
+            continue;
+        }
+
+        for (uint32_t s = 0; (s < spec.stars) && (entry->argCount < RT_LOG_MAX_ARGS); s++) {
+            entry->arg[entry->argCount++] = (uint64_t)(int64_t)va_arg(args, int);
+        }
+
+        if (entry->argCount >= RT_LOG_MAX_ARGS) {
+            break;
+        }
+
+        switch (spec.conversion) {
+            case 'd':
+            case 'i':
+            case 'c':
+            {
+                entry->arg[entry->argCount++] = (spec.longs == 0) ? (uint64_t)(int64_t)va_arg(args, int)
+                                                : (spec.longs == 1) ? (uint64_t)(int64_t)va_arg(args, long)
+                                                : (uint64_t)va_arg(args, long long);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                double value = (spec.longDouble == true) ? (double)va_arg(args, long double) : va_arg(args, double);
+
+                memcpy(&entry->arg[entry->argCount++], &value, sizeof(value));
+                break;
+            }
+            case 's':
+            {
+                const char * text  = va_arg(args, const char *);
+                size_t       room  = RT_LOG_STRING_BYTES - entry->stringsUsed;
+                size_t       bytes = 0;
+
+                if ((text == NULL) || (room < 2)) {
+                    entry->arg[entry->argCount++] = RT_LOG_NO_STRING;
+                    break;
+                }
+
+                while ((bytes < (room - 1)) && (text[bytes] != '\0')) {
+                    entry->strings[entry->stringsUsed + bytes] = text[bytes];
+                    bytes++;
+                }
+                entry->strings[entry->stringsUsed + bytes] = '\0';
+                entry->arg[entry->argCount++]              = entry->stringsUsed;
+                entry->stringsUsed                         = (uint8_t)(entry->stringsUsed + bytes + 1);
+                break;
+            }
+            case 'p':
+            case 'n':
+            {
+                entry->arg[entry->argCount++] = (uint64_t)(uintptr_t)va_arg(args, void *);
+                break;
+            }
+            default:
+            {
+                // u, x, X, o, and anything unrecognised, which is at least read at the right width.
+                entry->arg[entry->argCount++] = (spec.longs == 0) ? (uint64_t)va_arg(args, unsigned int)
+                                                : (spec.longs == 1) ? (uint64_t)va_arg(args, unsigned long)
+                                                : (uint64_t)va_arg(args, unsigned long long);
+                break;
+            }
+        }
+    }
+    va_end(args);
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// One entry back into text. Each conversion is formatted by snprintf from its own specification, with
+// the argument cast back to what the post read it as; a '*' is replaced by the number it stood for.
+static void format_entry(const tRtLogEntry * entry, char * line, size_t size) {
+    const char * p    = entry->format;
+    size_t       used = 0;
+    uint32_t     next = 0;
+
+    while ((*p != '\0') && (used < (size - 1))) {
+        tRtLogSpec spec    = {0};
+        char       one[32] = {0};
+        size_t     oneUsed = 0;
+        int        written = 0;
+        uint64_t   arg     = 0;
+
+        if (*p != '%') {
+            line[used++] = *p++;
+            continue;
+        }
+        spec = parse_spec(p);
+
+        if (spec.conversion == '%') {
+            line[used++] = '%';
+            p            = spec.end;
+            continue;
+        }
+
+        // The specification, with each '*' spelled out.
+        for (const char * s = p; (s < spec.end) && (oneUsed < (sizeof(one) - 12)); s++) {
+            if (*s == '*') {
+                oneUsed += (size_t)snprintf(one + oneUsed, sizeof(one) - oneUsed, "%d",
+                                            (next < entry->argCount) ? (int)(int64_t)entry->arg[next] : 0);
+                next++;
+            } else if (strchr("hlLjzt", *s) == NULL) {
+                one[oneUsed++] = *s;       // length modifiers go: the argument is passed at full width
+            }
+        }
+        one[oneUsed] = '\0';
+        p            = spec.end;
+
+        if ((next >= entry->argCount) || (spec.conversion == 'n')) {
+            written = snprintf(line + used, size - used, "?");
+        } else {
+            arg = entry->arg[next++];
+
+            // The specification has lost its length modifier, so put one back that matches what is
+            // being passed.
+            switch (spec.conversion) {
+                case 'd':
+                case 'i':
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o':
+                {
+                    char   wide[40] = {0};
+                    size_t stem     = strlen(one) - 1;
+
+                    snprintf(wide, sizeof(wide), "%.*sll%c", (int)stem, one, spec.conversion);
+                    written = ((spec.conversion == 'd') || (spec.conversion == 'i'))
+                              ? snprintf(line + used, size - used, wide, (long long)arg)
+                              : snprintf(line + used, size - used, wide, (unsigned long long)arg);
+                    break;
+                }
+                case 'c':
+                {
+                    written = snprintf(line + used, size - used, one, (int)(int64_t)arg);
+                    break;
+                }
+                case 's':
+                {
+                    written = snprintf(line + used, size - used, one,
+                                       (arg == RT_LOG_NO_STRING) ? "(null)" : &entry->strings[arg]);
+                    break;
+                }
+                case 'p':
+                {
+                    written = snprintf(line + used, size - used, one, (void *)(uintptr_t)arg);
+                    break;
+                }
+                default:
+                {
+                    double value = 0.0;
+
+                    memcpy(&value, &arg, sizeof(value));
+                    written = snprintf(line + used, size - used, one, value);
+                    break;
+                }
+            }
+        }
+
+        if (written > 0) {
+            used = ((used + (size_t)written) < size) ? (used + (size_t)written) : (size - 1);
+        }
+    }
+    line[used] = '\0';
+}
+
+static void emit(tRtLogLevel level, const char * line) {
+    switch (level) {
+        case eRtLogDebug:
+        {
+            LOG_DEBUG("%s", line);
+            break;
+        }
+        case eRtLogDebugDirect:
+        {
+            LOG_DEBUG_DIRECT("%s", line);
+            break;
+        }
+        case eRtLogInfo:
+        {
+            LOG_INFO("%s", line);
+            break;
+        }
+        case eRtLogWarning:
+        {
+            LOG_WARNING("%s", line);
+            break;
+        }
+        default:
+        {
+            LOG_ERROR("%s", line);
+            break;
+        }
+    }
+}
+
+// Everything waiting, ring by ring. Entries from different threads come out grouped by thread rather
+// than interleaved in time; each line is formatted as its thread posted it, which is the order that
+// matters for reading one thread's story.
+static void drain(void) {
+    char line[RT_LOG_LINE];
+
+    pthread_mutex_lock(&gDrainMutex);
+
+    for (uint32_t r = 0; r < RT_LOG_RINGS; r++) {
+        tRtLogRing * ring    = &gRing[r];
+        uint32_t     tail    = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint32_t     head    = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t     dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+
+        while (tail != head) {
+            const tRtLogEntry * entry = &ring->entry[tail & (RT_LOG_ENTRIES - 1U)];
+
+            format_entry(entry, line, sizeof(line));
+            emit((tRtLogLevel)entry->level, line);
+            tail++;
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+        }
+
+        if (dropped != ring->reported) {
+            LOG_ERROR("rt log: %llu entries from the %s thread dropped on a full ring\n",
+                      (unsigned long long)(dropped - ring->reported), ring->name);
+            ring->reported = dropped;
+        }
+    }
+    pthread_mutex_unlock(&gDrainMutex);
+}
+
+void rt_log_flush(void) {
+    drain();
+}
+
+void rt_log_unregister_thread(void) {
+    if (gThreadRing < 0) {
+        return;
+    }
+
+    if (gExitKeyMade == true) {
+        (void)pthread_setspecific(gExitKey, NULL);
+    }
+    drain();
+    atomic_store(&gRing[gThreadRing].claimed, false);
+    gThreadRing = -1;
+}
+
+// The thread-exit half of the above, for a thread that never called it. By the ring's index rather
+// than gThreadRing, which is the exiting thread's and may already be gone.
+static void release_at_exit(void * ring) {
+    int32_t r = (int32_t)(intptr_t)ring - 1;
+
+    if ((r >= 0) && (r < (int32_t)RT_LOG_RINGS)) {
+        drain();
+        atomic_store(&gRing[r].claimed, false);
+    }
+}
+
+static void * drainer_thread(void * unused) {
+    (void)unused;
+
+    while (atomic_load(&gDrainerRun) == true) {
+        struct timespec pause = {0, RT_LOG_DRAIN_NS};
+
+        drain();
+        (void)nanosleep(&pause, NULL);
+    }
+    drain();
+    return NULL;
+}
+
+void rt_log_start(void) {
+    pthread_mutex_lock(&gDrainerMutex);
+
+    if (gDrainerUsers++ == 0) {
+        atomic_store(&gDrainerRun, true);
+
+        if (pthread_create(&gDrainer, NULL, drainer_thread, NULL) != 0) {
+            // Not fatal: the rings fill, the entries are counted as dropped, and nothing waits.
+            LOG_ERROR("rt log: no drainer thread, real-time log entries will be dropped\n");
+            atomic_store(&gDrainerRun, false);
+        }
+    }
+    pthread_mutex_unlock(&gDrainerMutex);
+}
+
+void rt_log_stop(void) {
+    pthread_mutex_lock(&gDrainerMutex);
+
+    if ((gDrainerUsers > 0) && (--gDrainerUsers == 0) && (atomic_load(&gDrainerRun) == true)) {
+        atomic_store(&gDrainerRun, false);
+        pthread_join(gDrainer, NULL);
+    }
+    pthread_mutex_unlock(&gDrainerMutex);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,125 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RT_LOG_H__
+#define __RT_LOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "defs.h"
+#include "synthlibDefs.h"
+
+// LOGGING FROM A THREAD THAT MUST NOT WAIT.
+//
+// LOG_DEBUG and friends format and write on the spot, through stdio, which takes a lock. On the audio
+// thread that lock can be held by the UI thread halfway through a line of its own, and the callback
+// then waits on a lower-priority thread — priority inversion, heard as a dropout that only happens
+// with logging on. The USB thread has the same problem in a milder form: a slow write stalls the
+// message it was about to read.
+//
+// So a thread that registers here gets a ring of its own, and the RT_LOG_* macros below, called from
+// it, only copy the format string's address, the time and up to RT_LOG_MAX_ARGS raw arguments into
+// the ring. A drainer thread at ordinary priority formats them and hands each line to the matching
+// LOG_* macro, so it lands wherever LOG_* output always has. Called from any thread that has NOT
+// registered, RT_LOG_* is LOG_* and nothing more, so a function shared between threads can use them
+// freely.
+//
+// Each ring has one writer and one reader and no locks. A full ring DROPS the entry and counts it;
+// the drainer reports the count. A real-time thread never waits for its log.
+//
+// THE FORMAT STRING MUST OUTLIVE THE DRAIN — in practice, a literal, which is what every call site
+// has. %s arguments are copied into the entry, up to RT_LOG_STRING_BYTES between them, so a name out
+// of a buffer that is about to change is safe. %n is not supported.
+//
+// The LOG_* macros themselves are SynthLib's and stay as they are; routing is done by using the
+// RT_LOG_* forms at the call sites that can run on a registered thread.
+
+#define RT_LOG_MAX_ARGS        (6)
+#define RT_LOG_STRING_BYTES    (64)
+
+typedef enum {
+    eRtLogDebug = 0,
+    eRtLogDebugDirect,
+    eRtLogInfo,
+    eRtLogWarning,
+    eRtLogError,
+} tRtLogLevel;
+
+// Starts the drainer. Counted: each start needs its stop, and the drainer runs while any are
+// outstanding — a plug-in host can have several instances, each starting and stopping it on its own
+// schedule. The last stop drains what is left before returning.
+void rt_log_start(void);
+void rt_log_stop(void);
+
+// Claims a ring for the calling thread. False if every ring is taken, in which case the thread's
+// RT_LOG_* calls stay plain LOG_* calls. The first call on a thread installs a thread-exit hook, and
+// that can allocate, so a callback on a thread it did not create keeps a thread-local flag and calls
+// this once per thread rather than on every entry.
+//
+// The ring is given back when the thread exits, whether or not it unregisters first.
+bool rt_log_register_thread(const char * name);
+
+// Gives the calling thread's ring back, for a thread about to exit. Entries still in it are drained
+// first. A thread that can stop its own loop calls this; a host's or the device's threads are left to
+// the thread-exit hook.
+void rt_log_unregister_thread(void);
+
+bool rt_log_thread_is_registered(void);
+
+// The queueing half of RT_LOG_*. Call through the macros.
+void rt_log_post(tRtLogLevel level, const char * format, ...) __attribute__((format(printf, 2, 3)));
+
+// Entries dropped on a full ring since start, across every thread.
+uint64_t rt_log_dropped(void);
+
+// Drains every ring now, on the calling thread, and returns once it is done. For a thread about to
+// exit() with its last words still queued: it takes the drain lock and writes, so it waits exactly as
+// LOG_* would, and is never for a path that carries on.
+void rt_log_flush(void);
+
+#define RT_LOG_ROUTE(level, plain, ...)               \
+    do {                                              \
+        if (rt_log_thread_is_registered() == true) {  \
+            rt_log_post((level), __VA_ARGS__);        \
+        } else {                                      \
+            plain(__VA_ARGS__);                       \
+        }                                             \
+    } while (0)
+
+// Compiled out with LOG_DEBUG, as SynthLib's is, so a Release build keeps no trace of them.
+#ifdef ENABLE_LOG_DEBUG
+#define RT_LOG_DEBUG(...)           RT_LOG_ROUTE(eRtLogDebug, LOG_DEBUG, __VA_ARGS__)
+#define RT_LOG_DEBUG_DIRECT(...)    RT_LOG_ROUTE(eRtLogDebugDirect, LOG_DEBUG_DIRECT, __VA_ARGS__)
+#else
+#define RT_LOG_DEBUG(...)           ((void)0)
+#define RT_LOG_DEBUG_DIRECT(...)    ((void)0)
+#endif
+#define RT_LOG_INFO(...)            RT_LOG_ROUTE(eRtLogInfo, LOG_INFO, __VA_ARGS__)
+#define RT_LOG_WARNING(...)         RT_LOG_ROUTE(eRtLogWarning, LOG_WARNING, __VA_ARGS__)
+#define RT_LOG_ERROR(...)           RT_LOG_ROUTE(eRtLogError, LOG_ERROR, __VA_ARGS__)
+
+// EXIT_IN_DEBUG() for a function whose error lines are RT_LOG_*: the exit would otherwise beat the
+// drainer to them, and the one line saying why the editor stopped would never be printed.
+#ifdef DEBUG
+#define RT_LOG_EXIT_IN_DEBUG()      do { rt_log_flush(); exit(1); } while (0)
+#else
+#define RT_LOG_EXIT_IN_DEBUG()      ((void)0)
+#endif
+
+#endif // __RT_LOG_H__
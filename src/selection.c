@@ -264,7 +264,7 @@ void delete_module_and_cables(tModuleKey key) {
         if ((cable->key.moduleToIndex != key.index) && (orphanedCount < MAX_NUM_CABLES)) {
             orphaned[orphanedCount++] = cable_chain_to_node(cable);
         }
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
         delete_cable(cable->key);
     }
 
@@ -296,7 +296,7 @@ void delete_module_and_cables(tModuleKey key) {
     msg.cmd                  = eMsgCmdDeleteModule;
     msg.slot                 = slot;
     msg.moduleData.moduleKey = key;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     delete_module(key);
 }
 
@@ -620,6 +620,9 @@ void paste_snapshot(uint32_t slot, uint32_t location,
                     tClipboardCable * cables, uint32_t cableCount) {
     uint32_t indexMap[MAX_NUM_MODULES] = {0};
 
+    // Every module, value, label, shove and cable below is one command to the G2; send them as one
+    // edit so the device is paused once for the lot rather than once each.
+    send_batch_begin();
     selection_clear();
 
     for (uint32_t ci = 0; ci < moduleCount; ci++) {
@@ -661,7 +664,7 @@ void paste_snapshot(uint32_t slot, uint32_t location,
         }
 
         COPY_STRING(msg.moduleData.name, cm->name);
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
 
         write_module(module.key, &module);
 
@@ -694,7 +697,7 @@ void paste_snapshot(uint32_t slot, uint32_t location,
                         nmsg.paramLabelData.moduleKey  = module.key;
                         nmsg.paramLabelData.paramIndex = p;
                         COPY_STRING(nmsg.paramLabelData.name, cm->paramName[p][l]);
-                        msg_send(&gToUsbThread, &nmsg);
+                        send_usb_command(&nmsg);
                     }
                 }
             }
@@ -743,10 +746,11 @@ void paste_snapshot(uint32_t slot, uint32_t location,
         msg.cableData.linkType             = cc->linkType;
         msg.cableData.moduleToIndex        = newTo;
         msg.cableData.connectorToIoIndex   = cc->toIoCount;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     update_module_up_rates();
+    send_batch_end();
     synthlib_request_redraw();
 }
 
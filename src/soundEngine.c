@@ -27,6 +27,19 @@ extern "C" {
 #include <pthread.h>
 #include <time.h>
 
+// Only for giving the FX pipeline thread the same real-time class CoreAudio gives its own — see
+// fx_make_realtime(). Everything else in here is plain C.
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+// Only for the profiler's cycle counter — see profile_ticks().
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 #include "defs.h"
 #include "synthlibDefs.h"
 #include "types.h"
@@ -39,6 +52,8 @@ extern "C" {
 #include "audioOutput.h"
 #include "midiInput.h"
 #include "soundEngine.h"
+#include "delayRing.h"
+#include "rtLog.h"
 
 // See soundEngine.h for what this does and does not attempt.
 
@@ -497,6 +512,11 @@ typedef struct {
     // everything in the FX Area, for the three module kinds that own a shared delay buffer wherever
     // they sit, and for anything downstream of one of those. See mark_post_mix_nodes().
     bool postMix;
+
+    // What the module shows on its face, for the engine's own meters when no G2 is connected: its
+    // volume meter, if it has one, and whether it has an LED. See METERS.
+    tVolumeType meter;
+    bool        led;
 } tEngineNode;
 
 // A patch can hold more than one Out module — SimpleLead has two, a Voice Area output carrying the
@@ -520,6 +540,16 @@ typedef struct {
     double      bendSemitones; // 0 when the patch has bend switched off
     uint64_t    topology;      // changes shape => the audio thread resets its per-node state
     uint32_t    voiceCount;    // how many voices this patch may sound at once, 1 for Mono/Legato
+    // Performance settings, so the audio thread can route a note without reading gPerfSettings
+    // itself. A patch-mode snapshot takes every key at unity gain.
+    double      slotGain;      // the patch's Volume dial, and its mute, as a gain
+    bool        keyboard;      // the slot takes notes from the keyboard at all
+    uint32_t    keyLow;        // the slot's key range, inclusive, when the performance has one on
+    uint32_t    keyHigh;
+    // The nodes with a meter or an LED to drive, by the half of the render that sees their output:
+    // [0] the Voice Area, as the summed voices, [1] everything after the mix. See METERS.
+    uint32_t    meterCount[2];
+    uint8_t     meterNode[2][MAX_ENGINE_NODES];
     tEngineNode node[MAX_ENGINE_NODES];
 } tSoundEngineParams;
 
@@ -529,8 +559,22 @@ typedef struct {
 // side ever blocks, and the audio thread never waits on the UI thread. A plain pair of buffers
 // would not do: the UI can publish twice while one audio buffer is being filled, which is long
 // enough to land back on the buffer the audio thread is mid-copy of.
-static tSoundEngineParams gParams           = {0};
-static _Atomic uint32_t   gParamsSeq        = 0;
+//
+// ONE SNAPSHOT PER VARIATION, NOT PER SLOT. Every variation of a slot is resolved whenever the slot is
+// built — a lane each — and the audio thread reads the lane gLaneSelect names. Selecting a variation
+// is then that one store (sound_engine_select_variation()) and nothing else: no graph walk, no
+// parameter resolution, no publish, and the sound changes on the next buffer rather than after the
+// next redraw has rebuilt the slot. Each lane has its own sequence, so publishing one never tears a
+// read of another.
+static tSoundEngineParams gParams[MAX_SLOTS][NUM_VARIATIONS]    = {0};
+static _Atomic uint32_t   gParamsSeq[MAX_SLOTS][NUM_VARIATIONS] = {0};
+static _Atomic uint32_t   gLaneSelect[MAX_SLOTS]                = {0};
+
+// What the audio thread is playing for a slot, for the UI side's readers. Not a copy: the UI thread is
+// the only writer, so it can read its own lanes in place.
+static const tSoundEngineParams * playing_params(uint32_t slot) {
+    return &gParams[slot][atomic_load_explicit(&gLaneSelect[slot], memory_order_relaxed)];
+}
 
 // SERIALISES WRITERS ONLY. The audio thread never takes this — it is the seqlock's reader and stays
 // lock-free, so there is no priority inversion to worry about.
@@ -548,6 +592,54 @@ static pthread_mutex_t    gParamsWriteMutex = PTHREAD_MUTEX_INITIALIZER;
 
 #define PARAMS_READ_ATTEMPTS    (4)   // then keep last good — a retry loop must not spin in audio
 
+// See sound_engine_set_snapshot_check(). The checksum is written inside the seqlock's write section,
+// so a reader takes it under the same sequence as the snapshot it describes.
+static _Atomic bool       gSnapshotCheck                          = false;
+static uint64_t           gParamsCheck[MAX_SLOTS][NUM_VARIATIONS] = {0};
+static _Atomic uint64_t   gTornSnapshots                          = 0;
+static _Atomic uint64_t   gStaleSnapshots                         = 0;
+
+// THE UI SIDE'S BOOKKEEPING FOR THE LANES, under gParamsWriteMutex. gLanesBuilt is false until every
+// lane of the slot has been resolved at least once; gLaneStale has a bit set for each lane that may
+// no longer match the patch and has not been rebuilt yet; gLaneRefresh is the next lane to bring up
+// to date on a call that found nothing else to do — see sound_engine_update_from_patch(). gLaneBuilds
+// counts every lane resolved from the patch, which is how a test shows that switching variations
+// resolves none; an idle slot's empty lanes are not counted.
+//
+// gLaneEdited is not under the mutex: sound_engine_lane_edited() sets a bit in it from whichever
+// thread wrote the parameter, and the next update takes the bits. gLaneStale is only written under
+// the mutex, but is atomic so that sound_engine_select_variation() can tell a current lane without
+// taking it.
+static bool               gLanesBuilt[MAX_SLOTS]                  = {false};
+static _Atomic uint32_t   gLaneStale[MAX_SLOTS]                   = {0};
+static _Atomic uint32_t   gLaneEdited[MAX_SLOTS]                  = {0};
+static uint32_t           gLaneRefresh[MAX_SLOTS]                 = {0};
+static _Atomic uint64_t   gLaneBuilds                             = 0;
+
+// THE CROSSFADE between one variation and the next, and how far through it each slot is. Zero seconds
+// is no crossfade at all: the lanes meet through the ordinary parameter smoothing, as any edit does.
+// The fade state is the audio thread's own; NO_LANE_SEEN is a slot that has not played since the
+// engine was primed, whose first lane is where it starts rather than a switch to fade into.
+#define NO_LANE_SEEN    (UINT32_MAX)
+
+static _Atomic uint32_t   gCrossfadeMicros                        = 0;
+static uint32_t           gSeenLane[MAX_SLOTS]                    = {0};
+static uint64_t           gFadeFramesLeft[MAX_SLOTS]              = {0};
+
+// FNV-1a over the snapshot's bytes, padding and all — the reader hashes the exact bytes it copied, so
+// it compares like with like. Never 0, which read_params() takes to mean "no checksum yet".
+static uint64_t snapshot_checksum(const tSoundEngineParams * params) {
+    const uint8_t * bytes = (const uint8_t *)params;
+    uint64_t        hash  = 0xcbf29ce484222325ULL;
+    size_t          i     = 0;
+
+    for (i = 0; i < sizeof(*params); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return (hash != 0) ? hash : 1;
+}
+
 // Note events queue up here rather than being a single "current note" the audio thread samples once
 // per buffer. Two things were wrong with that: the note only took effect at a buffer boundary, which
 // is audible jitter at any sensible buffer size, and if two events landed inside one buffer only the
@@ -606,6 +698,7 @@ typedef enum {
     eStatusNoSource,
     eStatusChainTooDeep,
     eStatusBypassed,
+    eStatusSlotDisabled,      // a performance with the slot on screen switched off
     eStatusPlaying,
 } tSoundEngineStatus;
 
@@ -624,6 +717,52 @@ static uint32_t           gPlayingCount               = 0; // how many modules a
 // and having one rate throughout means nothing has to know it is happening.
 #define ENGINE_OVERSAMPLE    (2)
 
+// THE SAMPLE TYPE. g2_sample_t is what AUDIO travels in between the nodes — the per-node value
+// table, the voice sums, the output pairs, the two decimators and the FX pipeline's hand-off — and
+// G2_ENGINE_SINGLE_PRECISION picks float or double for it at build time. The default is double,
+// which is what the engine has always been, so an ordinary build sounds exactly as it did. A float
+// build halves the bytes the render loop moves and lets the decimators' multiply-adds go twice as
+// wide; tools/precision.c renders every test patch in both and reports how far apart they land.
+//
+// WHAT STAYS DOUBLE in both builds is STATE THAT INTEGRATES — anything whose error is fed back and
+// added to, sample after sample, rather than being made fresh each time:
+//
+//   - Phase accumulators (oscillators, LFOs, the chorus and reverb LFOs). At 96 kHz a float phase
+//     increment has a relative error near 1e-7 per step, which for a low note is a pitch error of
+//     about a cent and a drift between voices that should beat in time.
+//   - Filter integrators. The ladder's coefficient is about 1e-3 for a low cutoff, so float state
+//     loses roughly ten bits to the update before resonance amplifies what is left.
+//   - Delay feedback and the reverb's damping and loop state. At Feedback 127 an error added on one
+//     trip round is still there on the thousandth.
+//   - Envelope level and progress, and parameter smoothing. A slow envelope's per-sample step is
+//     about 1e-6, sixteen float ulps at full level, so a long release would visibly stair-step.
+//
+// Delay rings are float in both builds and always were: a sample is stored once and read back once,
+// so its rounding does not compound. Only values that are MADE each sample and then consumed follow
+// the build's choice.
+//
+// WHY NO SHIPPED BUILD TURNS IT ON. With the integrating state double either way, the float build
+// changes the traffic between nodes and not the arithmetic inside them, and tools/bench has not shown
+// that to be worth a second sound: SimpleLead at 48 kHz took 0.72 to 0.90 of the double build's time
+// (best of five, 1 to 32 voices) and ExpAudio 1.00 to 1.03, on a host whose runs vary by more than
+// that from one to the next. And the two builds do not agree to the bit: tools/precision puts most of
+// its takes 110 to 128 dB below their peak apart and DelayLevel's first rig 90, which nobody hears,
+// but ioosc's rig — two oscillators with another cabled into their pitch and FM inputs — only 67 dB,
+// because a rounding in the modulator becomes a phase error in what it modulates. Every shipped build
+// would need its own golden references, and a patch bounced from the app and from the plug-in would
+// no longer null against itself. So double stays the one sound and the reference; the switch is here
+// for measuring on the machine that matters, and a build that shows a clear gain there is the time to
+// ship it.
+#ifndef G2_ENGINE_SINGLE_PRECISION
+#define G2_ENGINE_SINGLE_PRECISION    (0)
+#endif
+
+#if G2_ENGINE_SINGLE_PRECISION
+typedef float  g2_sample_t;
+#else
+typedef double g2_sample_t;
+#endif
+
 // The tempo a clock-synced module works to. The engine does not run the patch's master clock, so
 // anything set to Clk needs a reference; 120 BPM is the obvious one and makes 1/4 exactly half a
 // second. See the delay's Clk branch — this is a stand-in, not the hardware's tempo.
@@ -654,8 +793,8 @@ typedef struct {
     double   fade;         // 1.0 normally; driven to 0 to retire a voice that will not stop on its own
 } tVoice;
 
-static tVoice             gVoice[MAX_VOICES] = {0};
-static uint64_t           gVoiceClock        = 0;
+static tVoice             gVoice[MAX_SLOTS][MAX_VOICES] = {0};
+static uint64_t           gVoiceClock[MAX_SLOTS]        = {0};
 
 // Published for the note stack, which has to know whether to release the note it was given or to
 // fall back to the newest one still held. An atomic rather than a look into the parameter snapshot:
@@ -670,12 +809,44 @@ static _Atomic uint32_t   gEngineVoices      = 1;
 // buffer in a hundred is plainly audible and would vanish into a mean.
 static _Atomic uint32_t   gLoadPercent       = 0;
 
-static void reset_voices(void);
+// CALLBACK TIMING. gLoadPercent keeps only the worst buffer, so it cannot say whether that buffer was
+// one in a million or the shape of every tenth; this keeps them all. Bucket b covers durations up to
+// 2^(b/4) x 256 ns, a quarter-octave apiece — 256 ns to about 4 s — which is fine enough to read a
+// percentile to within 19 % and cheap enough to find with one count-leading-zeros. Written by the
+// audio thread only, with relaxed adds; read and cleared from anywhere.
+#define TIMING_MIN_SHIFT          (8U)                      // 256 ns: the lowest bucket's upper edge
+#define TIMING_STEPS_PER_OCTAVE   (4U)
+
+static _Atomic uint64_t   gTimingBucket[SOUND_ENGINE_TIMING_BUCKETS];
+static _Atomic uint64_t   gTimingMaxNanos    = 0;
+static _Atomic uint64_t   gTimingPeriodNanos = 0;
+static _Atomic uint64_t   gTimingMisses      = 0;
+static _Atomic uint64_t   gTimingLastMiss    = 0;         // CLOCK_MONOTONIC ns
+static _Atomic uint32_t   gTimingMissPercent = 100;
+
+static void reset_voices(uint32_t slot);
+static void fx_pipeline_open(void);
+static void fx_pipeline_close(void);
 static uint32_t voice_count_for_patch(uint32_t slot);
 
-static double             gVibratoPhase      = 0.0;
-static tSoundEngineParams gLastGoodParams    = {0};
-static uint64_t           gSeenTopology      = 0;
+static double             gVibratoPhase[MAX_SLOTS]   = {0};
+static tSoundEngineParams gLastGoodParams[MAX_SLOTS] = {0};
+static uint64_t           gSeenTopology[MAX_SLOTS]   = {0};
+
+// ── SLOTS ───────────────────────────────────────────────────────────────────────────────────────
+//
+// EVERY PIECE OF AUDIO STATE BELOW IS HELD ONCE PER SLOT, which is what lets a performance play all
+// four of its patches at once the way the instrument does. In patch mode only the slot being edited
+// is built and the other three sit idle; in performance mode each enabled slot has its own snapshot,
+// voices, delay lines and reverb, and they sum into the one output stage.
+//
+// Every step function takes the slot it is working on as its first argument. It was briefly a
+// file-level "current slot" instead, like gSlot on the UI side, but the FX pipeline runs one slot's FX
+// Area on its own thread while the audio thread renders voices, and one global cannot point at two
+// slots at once.
+// Each slot's snapshot for the buffer being rendered. Static rather than on the audio thread's
+// stack, which four copies of the whole graph would overrun on some hosts. Audio thread only.
+static tSoundEngineParams gRenderParams[MAX_SLOTS];
 
 // Per-node state, indexed by node position. Carried across snapshots while the topology signature
 // holds, so turning a knob does not restart the oscillator or reopen the envelope.
@@ -721,11 +892,11 @@ static uint64_t           gSeenTopology      = 0;
 // transition width, not the oversampling factor, is what governs the result.
 #define OUT_DECIMATE_TAPS    (64)
 
-static double   gOutDecimate[OUT_DECIMATE_TAPS];
-static double   gOutHistory[4][OUT_DECIMATE_TAPS];   // [pair*2 + channel]; one shared cursor, see the render loop
+static g2_sample_t gOutDecimate[OUT_DECIMATE_TAPS];
+static g2_sample_t gOutHistory[4][OUT_DECIMATE_TAPS];   // [pair*2 + channel]; one shared cursor, see the render loop
 static uint32_t gOutHistoryPos = 0;
 
-static double   gOscDecimate[OSC_DECIMATE_TAPS];
+static g2_sample_t gOscDecimate[OSC_DECIMATE_TAPS];
 
 // ── PER-VOICE NODE STATE ────────────────────────────────────────────────────────────────────────
 //
@@ -745,15 +916,15 @@ static double   gOscDecimate[OSC_DECIMATE_TAPS];
 // FLOAT, not double, and for the same reason the tap count came down: at eight voices this array is
 // walked a few million times a second and the loop is bound by how fast it can be read rather than
 // by the arithmetic. Halving the bytes halves that. The accumulation is still done in double.
-static float    gOscHistory[MAX_VOICES][MAX_ENGINE_NODES][OSC_DECIMATE_TAPS];
-static uint32_t gOscHistoryPos[MAX_VOICES][MAX_ENGINE_NODES];
+static float    gOscHistory[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES][OSC_DECIMATE_TAPS];
+static uint32_t gOscHistoryPos[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
 
-static double   gPhase[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gLfoLastPhase[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gLfoTarget[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gLfoHeld[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gSuperPhase[MAX_VOICES][MAX_ENGINE_NODES][2];
-static double   gLadder[MAX_VOICES][MAX_ENGINE_NODES][LADDER_POLES];
+static double   gPhase[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gLfoLastPhase[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gLfoTarget[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gLfoHeld[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gSuperPhase[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES][2];
+static double   gLadder[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES][LADDER_POLES];
 
 // Delay memory. Held as float rather than double purely for size — half a second per line at any
 // sensible rate, four lines, is enough for the delays a patch normally has and keeps this under a
@@ -762,30 +933,34 @@ static double   gLadder[MAX_VOICES][MAX_ENGINE_NODES][LADDER_POLES];
 // Long enough for the longest range the Time dial offers (2.7 s), at the INTERNAL rate. It used to
 // be a flat 48000, i.e. one second at 48 kHz — so the top of the dial was silently truncated to
 // well under half the delay it promised.
-// 2.8 s at 48 kHz, times the oversampling — integer arithmetic so it stays a constant expression an
-// array can be sized with.
-#define DELAY_LINE_SAMPLES    (134400 * ENGINE_OVERSAMPLE)
-static float    gDelayLine[MAX_DELAY_LINES][DELAY_LINE_SAMPLES];
-static uint32_t gDelayWrite[MAX_DELAY_LINES];
-static double   gDelayDamp[MAX_DELAY_LINES];
-static double   gDelayHp[MAX_DELAY_LINES];   // the HP's lowpass half; the filter is x - this
+// A POWER OF TWO, for the mask in delayRing.h: 2^18 is 2.73 s at 96 kHz, the 2.7 s Range with a
+// little over 30 ms to spare. It was 2.8 s exactly (134400 * ENGINE_OVERSAMPLE), which rounded up
+// would have been 2^19 and twice the memory for a tenth of a second nothing on the dial reaches.
+#define DELAY_LINE_SAMPLES    (1U << 18)
+#define DELAY_LINE_MASK       (DELAY_LINE_SAMPLES - 1U)
+static float    gDelayLine[MAX_SLOTS][MAX_DELAY_LINES][DELAY_LINE_SAMPLES];
+static uint32_t gDelayWrite[MAX_SLOTS][MAX_DELAY_LINES];
+static double   gDelayAllpass[MAX_SLOTS][MAX_DELAY_LINES];   // the fractional read's state
+static double   gDelayDamp[MAX_SLOTS][MAX_DELAY_LINES];
+static double   gDelayHp[MAX_SLOTS][MAX_DELAY_LINES];   // the HP's lowpass half; the filter is x - this
 
 // The chorus's own short sweep, plus its LFO phase. TWO LINES PER NODE: the instrument runs left and
 // right through the same algorithm with their LFOs in ANTIPHASE, so one phase accumulator serves
 // both — the right channel simply reads it half a cycle along. See chorus_step().
-#define CHORUS_SAMPLES     (2048 * ENGINE_OVERSAMPLE)
+#define CHORUS_SAMPLES     (2048 * ENGINE_OVERSAMPLE)   // a power of two: masked, see delayRing.h
+#define CHORUS_MASK        (CHORUS_SAMPLES - 1U)
 #define CHORUS_CHANNELS    (2)
-static float    gChorusLine[MAX_ENGINE_NODES][CHORUS_CHANNELS][CHORUS_SAMPLES];
-static uint32_t gChorusWrite[MAX_ENGINE_NODES][CHORUS_CHANNELS];
-static double   gChorusLfo[MAX_ENGINE_NODES];
+static float    gChorusLine[MAX_SLOTS][MAX_ENGINE_NODES][CHORUS_CHANNELS][CHORUS_SAMPLES];
+static uint32_t gChorusWrite[MAX_SLOTS][MAX_ENGINE_NODES][CHORUS_CHANNELS];
+static double   gChorusLfo[MAX_SLOTS][MAX_ENGINE_NODES];
 
 // Pulse: the countdown still to run, and the previous input, so a rising edge can be seen. Per voice,
 // because the gate is fired by that voice's own envelope.
-static uint32_t gPulseCount[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gPulsePrev[MAX_VOICES][MAX_ENGINE_NODES];
+static uint32_t gPulseCount[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gPulsePrev[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
 
 // Compressor gain-reduction state, one per node.
-static double   gCompEnv[MAX_VOICES][MAX_ENGINE_NODES];
+static double   gCompEnv[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
 
 // A Schroeder reverb: eight combs into three allpasses. One reverb is modelled; any further ones pass
 // their input through, which is what a patch with two of them would mostly sound like anyway.
@@ -1040,6 +1215,30 @@ typedef enum {
 
 #define RV_LINES    (8)
 
+// THE EIGHT LINES AS ONE VALUE. Everything the tank does to a line it does to all eight at once and
+// in the same way — the reads, the damping, the mix — so they are held as eight float lanes and the
+// compiler issues one vector instruction where there were eight scalar ones: an AVX register on
+// x86-64, a pair of NEON registers on Apple silicon. GCC/Clang vector extensions rather than either
+// platform's intrinsics, so there is one kernel and no #ifdef per instruction set.
+//
+// FLOAT, where the tank used to run its filters in double. The delay memory was ALREADY float, so
+// every trip round the loop was rounded to float regardless. Measured against the double build with
+// tools/render, all four rooms at Time 127: the difference is -127 dB of the response's own energy
+// at worst, and its largest single sample -132 dB below the response's peak.
+//
+// NEVER PASSED BY VALUE. A 32-byte vector as a function argument changes the calling convention on
+// x86-64 without AVX and GCC warns about it (-Wpsabi, an error under -Werror); reverb_step() keeps
+// them in locals and globals and hands helpers a pointer.
+typedef float   tRvLanes __attribute__((vector_size(RV_LINES * sizeof(float))));
+typedef int32_t tRvLaneIndex __attribute__((vector_size(RV_LINES * sizeof(int32_t))));
+
+// Lanes rearranged by a constant pattern — one spelling for each compiler, the same operation.
+#if defined(__clang__)
+#define RV_SHUFFLE(x, ...)    __builtin_shufflevector((x), (x), __VA_ARGS__)
+#else
+#define RV_SHUFFLE(x, ...)    __builtin_shuffle((x), (tRvLaneIndex){__VA_ARGS__})
+#endif
+
 // MODULATION DEPTH, in samples at 96 kHz, and the rate each line sweeps it at.
 //
 // A TANK WITH FIXED DELAYS HAS FIXED MODES, and fixed modes ring -- that is what a metallic reverb
@@ -1077,7 +1276,16 @@ static const double kRvModHz[RV_LINES] = {
     0.61, 0.73, 0.89, 1.03, 1.19, 1.31, 1.47, 1.61
 };
 
-static double       gRvLfo[RV_LINES];
+// THE SWEEPS ARE A RECURSIVE QUADRATURE OSCILLATOR, not a phase and a cos() per line per channel —
+// sixteen transcendental calls a sample, for sine waves that a rotation produces with four
+// multiplies each. Cosine and sine together, so the right channel's quarter-cycle offset is the
+// sine read negated rather than a second evaluation: cos(x + pi/2) = -sin(x).
+//
+// In double, and renormalised every sample. A rotation in finite precision drifts in amplitude; the
+// first-order correction (3 - c*c - s*s) / 2 pulls it back each step at the cost of two multiplies,
+// and the double keeps the phase walk far below anything the sweep's few samples of depth could show.
+static double       gRvLfoCos[MAX_SLOTS][RV_LINES];
+static double       gRvLfoSin[MAX_SLOTS][RV_LINES];
 #define RV_DIFFUSERS    (6)
 
 // EIGHT LINES IN PARALLEL, EACH WITH AN ALLPASS IN FRONT OF IT, MIXED INTO ONE ANOTHER.
@@ -1126,7 +1334,11 @@ static const double   kRvTapFrac[RV_OUTTAPS]    = {
     0.83, 0.59, 0.89, 0.67, 0.13, 0.37, 0.11, 0.41
 };
 
-static uint32_t       gRvAddr[eRvSpanCount + 1];
+static uint32_t       gRvAddr[MAX_SLOTS][eRvSpanCount + 1];
+// The room the layout above was built for, per slot. REVERB_TYPE_COUNT forces the reset in
+// reverb_step() on the first call — it used to be a static inside that function, which was fine while
+// there was only ever one reverb running.
+static uint32_t       gRvLastType[MAX_SLOTS] = {[0 ... (MAX_SLOTS - 1)] = REVERB_TYPE_COUNT};
 
 // THE RECOVERED LENGTHS ARE ALREADY IN 96 kHz SAMPLES — that is the rate the instrument's tank runs
 // at and the rate every recovered figure is quoted in. They must NOT be multiplied by
@@ -1149,22 +1361,47 @@ static uint32_t       gRvAddr[eRvSpanCount + 1];
 #define RV_MEM_SHIFT    (17)
 #define RV_MEM          (1u << RV_MEM_SHIFT)
 
-static float          gRvMem[REVERB_CHANNELS][RV_MEM];
-static uint32_t       gRvCur[REVERB_CHANNELS];
-static double         gRvDamp[REVERB_CHANNELS][RV_LINES];
+static float          gRvMem[MAX_SLOTS][REVERB_CHANNELS][RV_MEM];
+static uint32_t       gRvCur[MAX_SLOTS][REVERB_CHANNELS];
+static tRvLanes       gRvDamp[MAX_SLOTS][REVERB_CHANNELS];
 
 // The low band the upper half of the dial subtracts, and the pole that defines it. Roughly 400 Hz
 // at 96 kHz — low enough that taking some of it out reads as "brighter" rather than "thinner".
 #define RV_LOW_A    (0.9744)
-static double         gRvLow[REVERB_CHANNELS][RV_LINES];
+static tRvLanes       gRvLow[MAX_SLOTS][REVERB_CHANNELS];
 
 // The two input poles. MEASURED, not chosen: the instrument's reverb is far darker than what goes
 // into it, and this is the filter that makes it so -- see the fit by REVERB_INPUT_LP_HZ.
-static double         gRevInLp[REVERB_CHANNELS];
-static double         gRevInLp2[REVERB_CHANNELS];
-static double         gRevInLp3[REVERB_CHANNELS];
-static double         gRevInLp4[REVERB_CHANNELS];
-static double         gRvLoop[REVERB_CHANNELS][RV_LINES];
+static double         gRevInLp[MAX_SLOTS][REVERB_CHANNELS];
+static double         gRevInLp2[MAX_SLOTS][REVERB_CHANNELS];
+static double         gRevInLp3[MAX_SLOTS][REVERB_CHANNELS];
+static double         gRevInLp4[MAX_SLOTS][REVERB_CHANNELS];
+static tRvLanes       gRvLoop[MAX_SLOTS][REVERB_CHANNELS];
+
+// WHAT ONLY CHANGES WHEN A DIAL OR THE RATE DOES, worked out then and not every sample. This used to
+// be recomputed per sample — eight pow() for the decay gains, two more for the damping, three exp()
+// per channel for the input filter, sixteen tap addresses through a double multiply — and together
+// those were most of what the reverb cost. Each is keyed on exactly what it depends on, so a dial
+// being turned is followed at once and a still one costs a comparison.
+typedef struct {
+    double   rate;                                // gSampleRate the layout and rates were built for
+    double   timeSeconds;                         // what `gain` was worked out for
+    double   brightness;                          // what the damping pair was worked out for
+    float    dampLo;
+    float    dampHi;
+    double   inA1;                                // the input filter's fixed poles
+    double   inA2;
+    double   inA4;
+    double   lfoCos[RV_LINES];                    // one sample's rotation, per line
+    double   lfoSin[RV_LINES];
+    tRvLanes gain;                                // per-line decay, with the Hadamard's 1/sqrt(8)
+    uint32_t tapAt[REVERB_CHANNELS][RV_OUTTAPS];  // output tap addresses, spread included
+} tRvCoeffs;
+
+static tRvCoeffs      gRvCoeff[MAX_SLOTS];
+
+// Below this a filter state is zero; see the input filter in reverb_step().
+#define RV_FLUSH    (1e-30)
 
 // [room type][channel], in samples at the base rate. NOT scaled by kReverbTypeScale — see above.
 static const uint32_t kReverbPreDelay[REVERB_TYPE_COUNT][REVERB_CHANNELS] = {
@@ -1215,9 +1452,9 @@ static const uint32_t kReverbPreDelay[REVERB_TYPE_COUNT][REVERB_CHANNELS] = {
 // already there. Dropping those instead would have cost a decibel at 4 kHz, where the match is
 // already good.
 #define REVERB_INPUT_LP4_HZ    (12000.0)
-static float    gPreDelay[REVERB_CHANNELS][REVERB_PREDELAY_MAX];
-static uint32_t gPreDelayPos[REVERB_CHANNELS];
-static double   gEnvLevel[MAX_VOICES][MAX_ENGINE_NODES];
+static float    gPreDelay[MAX_SLOTS][REVERB_CHANNELS][REVERB_PREDELAY_MAX];
+static uint32_t gPreDelayPos[MAX_SLOTS][REVERB_CHANNELS];
+static double   gEnvLevel[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
 // Linear 0..1 through the current segment, and the level it started from. Shaping this rather than
 // the step keeps a segment's DURATION exactly what its dial says, whatever curve it draws.
 // PARAMETER SMOOTHING. The G2 runs its modulation at 24 kHz (manual p.71 — "modules can process and
@@ -1231,28 +1468,31 @@ static double   gEnvLevel[MAX_VOICES][MAX_ENGINE_NODES];
 // The time constant is short enough not to lag a deliberate move and long enough to bridge the gap
 // between frames.
 #define PARAM_SMOOTH_SECONDS    (0.008)
+#define CROSSFADE_TIME_CONSTANTS (4.0)    // per variation crossfade: see render_to()
 
-static double   gSmoothShape[MAX_ENGINE_NODES];
-static double   gSmoothCutoff[MAX_ENGINE_NODES];
-static double   gSmoothRes[MAX_ENGINE_NODES];
-static double   gSmoothGain[MAX_ENGINE_NODES];
-static double   gSmoothLevel[MAX_ENGINE_NODES][MAX_NODE_INPUTS];
+static double   gSmoothShape[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothCutoff[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothRes[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothGain[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothLevel[MAX_SLOTS][MAX_ENGINE_NODES][MAX_NODE_INPUTS];
+static double   gSmoothTime[MAX_SLOTS][MAX_ENGINE_NODES];
 
 // Where the per-sample smoothing pass leaves its results, for the voice passes to read. Not per
 // voice: a knob is in one place however many notes are sounding, and smoothing it inside the voice
 // loop would advance the filter once per voice — so a sweep would speed up as more keys went down.
-static double   gSmoothedShape[MAX_ENGINE_NODES];
-static double   gSmoothedCutoff[MAX_ENGINE_NODES];
-static double   gSmoothedRes[MAX_ENGINE_NODES];
-static double   gSmoothedGain[MAX_ENGINE_NODES];
-static double   gSmoothedLevel[MAX_ENGINE_NODES][MAX_NODE_INPUTS];
+static double   gSmoothedShape[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothedCutoff[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothedRes[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothedGain[MAX_SLOTS][MAX_ENGINE_NODES];
+static double   gSmoothedLevel[MAX_SLOTS][MAX_ENGINE_NODES][MAX_NODE_INPUTS];
+static double   gSmoothedTime[MAX_SLOTS][MAX_ENGINE_NODES];
 // Until a node has been seen once there is nothing to interpolate FROM, so the first sample snaps.
 // Also what stops a patch load sweeping every parameter up from whatever the last patch left.
-static bool     gSmoothPrimed[MAX_ENGINE_NODES];
+static bool     gSmoothPrimed[MAX_SLOTS][MAX_ENGINE_NODES];
 
-static double   gEnvProgress[MAX_VOICES][MAX_ENGINE_NODES];
-static double   gEnvStart[MAX_VOICES][MAX_ENGINE_NODES];
-static uint32_t gEnvStage[MAX_VOICES][MAX_ENGINE_NODES];
+static double   gEnvProgress[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static double   gEnvStart[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
+static uint32_t gEnvStage[MAX_SLOTS][MAX_VOICES][MAX_ENGINE_NODES];
 
 typedef enum {
     eEnvIdle = 0,
@@ -1377,59 +1617,60 @@ void sound_engine_set_sample_rate(double sampleRate) {
     }
 }
 
-static void reset_node_state(void) {
+static void reset_node_state(uint32_t slot) {
     uint32_t i = 0;
     uint32_t v = 0;
 
     for (v = 0; v < MAX_VOICES; v++) {
         for (i = 0; i < MAX_ENGINE_NODES; i++) {
-            gLfoLastPhase[v][i]  = 0.0;
-            gLfoTarget[v][i]     = 0.0;
-            gLfoHeld[v][i]       = 0.0;
-            gOscHistoryPos[v][i] = 0;
-            memset(gOscHistory[v][i], 0, sizeof(gOscHistory[v][i]));
+            gLfoLastPhase[slot][v][i]  = 0.0;
+            gLfoTarget[slot][v][i]     = 0.0;
+            gLfoHeld[slot][v][i]       = 0.0;
+            gOscHistoryPos[slot][v][i] = 0;
+            memset(gOscHistory[slot][v][i], 0, sizeof(gOscHistory[slot][v][i]));
 
             // Spread rather than zeroed, for the same reason the note-on path leaves them alone:
             // from the very first note the oscillators should be at unrelated points in their
             // cycles. The step is irrational-ish so no two land together — and the VOICE is folded
             // into it as well, so two voices playing the same note are not phase-locked copies of
             // each other. Held notes on the hardware do not cancel and reinforce like that.
-            gPhase[v][i]         = fmod(((double)i + ((double)v * 0.618034)) * 0.381966, 1.0);
-            gSuperPhase[v][i][0] = 0.0;
-            gSuperPhase[v][i][1] = 0.0;
-            gLadder[v][i][0]     = 0.0;
-            gLadder[v][i][1]     = 0.0;
-            gLadder[v][i][2]     = 0.0;
-            gLadder[v][i][3]     = 0.0;
-            gEnvLevel[v][i]      = 0.0;
-            gEnvProgress[v][i]   = 0.0;
-            gEnvStart[v][i]      = 0.0;
-            gEnvStage[v][i]      = eEnvIdle;
-            gCompEnv[v][i]       = 0.0;
-            gPulseCount[v][i]    = 0;
-            gPulsePrev[v][i]     = 0.0;
+            gPhase[slot][v][i]         = fmod(((double)i + ((double)v * 0.618034)) * 0.381966, 1.0);
+            gSuperPhase[slot][v][i][0] = 0.0;
+            gSuperPhase[slot][v][i][1] = 0.0;
+            gLadder[slot][v][i][0]     = 0.0;
+            gLadder[slot][v][i][1]     = 0.0;
+            gLadder[slot][v][i][2]     = 0.0;
+            gLadder[slot][v][i][3]     = 0.0;
+            gEnvLevel[slot][v][i]      = 0.0;
+            gEnvProgress[slot][v][i]   = 0.0;
+            gEnvStart[slot][v][i]      = 0.0;
+            gEnvStage[slot][v][i]      = eEnvIdle;
+            gCompEnv[slot][v][i]       = 0.0;
+            gPulseCount[slot][v][i]    = 0;
+            gPulsePrev[slot][v][i]     = 0.0;
         }
     }
 
     for (i = 0; i < MAX_ENGINE_NODES; i++) {
-        gSmoothPrimed[i]   = false;
-        gChorusWrite[i][0] = 0;
-        gChorusWrite[i][1] = 0;
-        gChorusLfo[i]      = 0.0;
-        memset(gChorusLine[i], 0, sizeof(gChorusLine[i]));
-    }
-
-    memset(gDelayLine, 0, sizeof(gDelayLine));
-    memset(gDelayWrite, 0, sizeof(gDelayWrite));
-    memset(gDelayDamp, 0, sizeof(gDelayDamp));
-    memset(gDelayHp, 0, sizeof(gDelayHp));
-    memset(gPreDelay, 0, sizeof(gPreDelay));
-    memset(gRvMem, 0, sizeof(gRvMem));
-    memset(gRvCur, 0, sizeof(gRvCur));
-    memset(gRvDamp, 0, sizeof(gRvDamp));
-    memset(gRvLow, 0, sizeof(gRvLow));
-    memset(gRvLoop, 0, sizeof(gRvLoop));
-    memset(gPreDelayPos, 0, sizeof(gPreDelayPos));
+        gSmoothPrimed[slot][i]   = false;
+        gChorusWrite[slot][i][0] = 0;
+        gChorusWrite[slot][i][1] = 0;
+        gChorusLfo[slot][i]      = 0.0;
+        memset(gChorusLine[slot][i], 0, sizeof(gChorusLine[slot][i]));
+    }
+
+    memset(gDelayLine[slot], 0, sizeof(gDelayLine[slot]));
+    memset(gDelayWrite[slot], 0, sizeof(gDelayWrite[slot]));
+    memset(gDelayAllpass[slot], 0, sizeof(gDelayAllpass[slot]));
+    memset(gDelayDamp[slot], 0, sizeof(gDelayDamp[slot]));
+    memset(gDelayHp[slot], 0, sizeof(gDelayHp[slot]));
+    memset(gPreDelay[slot], 0, sizeof(gPreDelay[slot]));
+    memset(gRvMem[slot], 0, sizeof(gRvMem[slot]));
+    memset(gRvCur[slot], 0, sizeof(gRvCur[slot]));
+    memset(gRvDamp[slot], 0, sizeof(gRvDamp[slot]));
+    memset(gRvLow[slot], 0, sizeof(gRvLow[slot]));
+    memset(gRvLoop[slot], 0, sizeof(gRvLoop[slot]));
+    memset(gPreDelayPos[slot], 0, sizeof(gPreDelayPos[slot]));
 }
 
 // The lowpass that turns OSC_OVERSAMPLE samples back into one. A windowed sinc: cut just under the
@@ -1493,8 +1734,19 @@ static void engine_prime(void) {
     // a previous run — is stale, and starting the read index behind the write index would have the
     // audio thread chewing through history instead of playing what is being pressed now.
     gNoteRead = atomic_load(&gNoteWrite);
-    reset_node_state();
-    reset_voices();
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        reset_node_state(slot);
+        reset_voices(slot);
+        gLanesBuilt[slot]     = false;   // the first update after a start resolves every lane
+        gSeenLane[slot]       = NO_LANE_SEEN;
+        gFadeFramesLeft[slot] = 0;
+        gVibratoPhase[slot]   = 0.0;
+
+        // The reverb's LFOs and input filters are only reset with its layout, which a restart with
+        // the same room would otherwise keep — and two takes of one patch would not match.
+        gRvLastType[slot]     = REVERB_TYPE_COUNT;
+    }
 }
 
 // For a plug-in host: prime the engine and mark it live, but leave the audio device alone. The
@@ -1502,27 +1754,26 @@ static void engine_prime(void) {
 void sound_engine_start_hosted(double sampleRate) {
     sound_engine_set_sample_rate(sampleRate);
     engine_prime();
+    sound_engine_timing_reset(0);
+    fx_pipeline_open();
     atomic_store(&gActive, true);
 }
 
 void sound_engine_stop_hosted(void) {
     atomic_store(&gActive, false);
+    fx_pipeline_close();
 }
 
 bool sound_engine_start(void) {
     if (atomic_load(&gActive) == true) {
         return true;
     }
-    build_decimator();
-    // Start from silence rather than inheriting whatever the last run left behind. That includes
-    // the note queue: anything posted while the engine was off — the Virtual Keyboard, or MIDI from
-    // a previous run — is stale, and starting the read index behind the write index would have the
-    // audio thread chewing through history instead of playing what is being pressed now.
-    gNoteRead = atomic_load(&gNoteWrite);
-    reset_node_state();
-    reset_voices();
+    engine_prime();
+    fx_pipeline_open();
+    sound_engine_timing_reset(0);
 
     if (audio_output_start() == false) {
+        fx_pipeline_close();
         return false;
     }
     atomic_store(&gActive, true);
@@ -1538,10 +1789,11 @@ void sound_engine_stop(void) {
     // that render should already be seeing an inactive engine.
     atomic_store(&gActive, false);
     audio_output_stop();
+    fx_pipeline_close();
 }
 
 const char * sound_engine_status_text(void) {
-    static char text[80];
+    static char text[160];
 
     if (atomic_load(&gActive) == false) {
         return "Off";
@@ -1572,14 +1824,25 @@ const char * sound_engine_status_text(void) {
         {
             return "That module is switched off";
         }
+        case eStatusSlotDisabled:
+        {
+            return "This slot is switched off in the performance";
+        }
         case eStatusPlaying:
         {
             // The voice figures are what say whether a chord is being cut short: sounding against
-            // allowed, the second being the patch's own Poly count.
-            snprintf(text, sizeof(text), "Playing %u module%s, %u/%u voices, load %u%%%s",
+            // allowed, the second being the patch's own Poly count. p99 is the load one buffer in a
+            // hundred goes over, where "load" is the peak since the last redraw; together they say
+            // whether a high figure is the usual or the exception.
+            tSoundEngineTiming timing = {0};
+
+            sound_engine_timing_stats(&timing);
+            snprintf(text, sizeof(text), "Playing %u module%s, %u/%u voices, load %u%%, p99 %u%%, %llu late%s",
                      (unsigned)gPlayingCount, (gPlayingCount == 1) ? "" : "s",
                      (unsigned)sound_engine_voices_sounding(), (unsigned)sound_engine_voice_count(),
                      (unsigned)sound_engine_load_percent(),
+                     (timing.periodUs > 0.0) ? (unsigned)((timing.p99Us / timing.periodUs) * 100.0) : 0U,
+                     (unsigned long long)timing.misses,
                      (midi_input_connected_count() > 0) ? " - MIDI in" : " - Virtual Keyboard");
             return text;
         }
@@ -1599,34 +1862,36 @@ const char * sound_engine_modulation_text(void) {
     char        vib[48] = {0};
     uint32_t    lfos    = 0;
     uint32_t    i       = 0;
+    // The UI thread's own copy, the same one sound_engine_debug_text() reads.
+    const tSoundEngineParams * params = playing_params(gSlot);
 
-    // gParams is the UI thread's own copy, the same one sound_engine_debug_text() reads.
-    for (i = 0; i < gParams.nodeCount; i++) {
-        if (gParams.node[i].kind == eNodeLfo) {
+    for (i = 0; i < params->nodeCount; i++) {
+        if (params->node[i].kind == eNodeLfo) {
             lfos++;
         }
     }
 
     {
         static const char * source[] = {"Off", "AfTouch", "Wheel"};
-        uint32_t            mod      = (gParams.vibratoSource < 3) ? gParams.vibratoSource : 0;
+        uint32_t            mod      = (params->vibratoSource < 3) ? params->vibratoSource : 0;
 
         snprintf(vib, sizeof(vib), "Vib %s %ucnt %.1fHz", source[mod],
-                 (unsigned)gParams.vibratoCents, gParams.vibratoHz);
+                 (unsigned)params->vibratoCents, params->vibratoHz);
     }
 
     snprintf(text, sizeof(text), "Aftertouch %u msg, morph %u%% peak %u%%, %s, %u LFO of %u nodes",
              (unsigned)midi_input_pressure_count(),
              (unsigned)((atomic_load(&gMorphMilli[MORPH_GROUP_AFTERTOUCH]) + 5) / 10),
              (unsigned)((atomic_load(&gMorphPeakMilli[MORPH_GROUP_AFTERTOUCH]) + 5) / 10),
-             vib, (unsigned)lfos, (unsigned)gParams.nodeCount);
+             vib, (unsigned)lfos, (unsigned)params->nodeCount);
     return text;
 }
 
 const char * sound_engine_debug_text(void) {
-    // Big enough for a full patch: a couple of dozen nodes at roughly 230 characters each. It was
-    // 1024, which silently cut the listing off after five nodes.
-    static char  text[8192];
+    // Big enough for a full patch: a couple of dozen nodes at roughly 230 characters each, and the
+    // profiler's table after them when it is on. It was 1024, which silently cut the listing off after
+    // five nodes.
+    static char  text[12288];
     size_t       used       = 0;
     uint32_t     i          = 0;
     // One entry per tNodeKind, in enum order. Kept in step with it — a short array here is read off
@@ -1635,17 +1900,18 @@ const char * sound_engine_debug_text(void) {
         "Osc",    "OscShp",   "Filter", "LevAmp", "LevMult", "Mix",   "Env",
         "Chorus", "Compress", "Delay",  "Reverb", "Lfo",     "Const", "FxIn","PassThru","Pulse", "Out"
     };
+    const tSoundEngineParams * params = playing_params(gSlot);
 
     used += (size_t)snprintf(text + used, sizeof(text) - used,
                              "active=%d status=%d nodes=%u tap=%d extraTaps=%u variation=%u peak=%.3f rawpeak=%.3f\n",
-                             (int)atomic_load(&gActive), (int)gStatus, (unsigned)gParams.nodeCount,
-                             (int)gParams.tap, (unsigned)gParams.extraTapCount,
+                             (int)atomic_load(&gActive), (int)gStatus, (unsigned)params->nodeCount,
+                             (int)params->tap, (unsigned)params->extraTapCount,
                              (unsigned)gPatchDescr[gSlot].activeVariation,
                              (double)atomic_exchange(&gPeakMilli, 0) / 1000.0,
                              (double)atomic_exchange(&gRawPeakMilli, 0) / 1000.0);
 
-    for (i = 0; (i < gParams.nodeCount) && (used < sizeof(text)); i++) {
-        const tEngineNode * n = &gParams.node[i];
+    for (i = 0; (i < params->nodeCount) && (used < sizeof(text)); i++) {
+        const tEngineNode * n = &params->node[i];
 
         used += (size_t)snprintf(text + used, sizeof(text) - used,
                                  "[%u] %-8s mod=%u n=%u in=%d/%d src=%u/%u active=%d "
@@ -1665,6 +1931,9 @@ const char * sound_engine_debug_text(void) {
                                  n->timeSeconds, n->amount, n->depth);
     }
 
+    if ((sound_engine_profiling() == true) && (used < sizeof(text))) {
+        snprintf(text + used, sizeof(text) - used, "%s", sound_engine_profile_text());
+    }
     return text;
 }
 
@@ -1681,23 +1950,23 @@ void sound_engine_note(int32_t note, bool on) {
 
 // ── VOICE ALLOCATION (audio thread) ─────────────────────────────────────────────────────────────
 
-static void reset_voices(void) {
+static void reset_voices(uint32_t slot) {
     uint32_t v = 0;
 
     for (v = 0; v < MAX_VOICES; v++) {
-        gVoice[v].note        = -1;
-        gVoice[v].gate        = false;
-        gVoice[v].sounding    = false;
-        gVoice[v].glidePitch  = -1.0;
-        gVoice[v].glideActive = false;
-        gVoice[v].envelope    = 0.0;
-        gVoice[v].age         = 0;
-        gVoice[v].quiet       = 0;
-        gVoice[v].released    = 0;
-        gVoice[v].fade        = 1.0;
-    }
-
-    gVoiceClock = 0;
+        gVoice[slot][v].note        = -1;
+        gVoice[slot][v].gate        = false;
+        gVoice[slot][v].sounding    = false;
+        gVoice[slot][v].glidePitch  = -1.0;
+        gVoice[slot][v].glideActive = false;
+        gVoice[slot][v].envelope    = 0.0;
+        gVoice[slot][v].age         = 0;
+        gVoice[slot][v].quiet       = 0;
+        gVoice[slot][v].released    = 0;
+        gVoice[slot][v].fade        = 1.0;
+    }
+
+    gVoiceClock[slot] = 0;
 }
 
 // How many voices this patch may use at once. Mono and Legato are one voice whatever the count says,
@@ -1720,9 +1989,11 @@ static uint32_t voice_count_for_patch(uint32_t slot) {
 // The voice already holding a note, or -1. Matched whether or not the key is still down: a repeated
 // note-on for something still releasing belongs on the voice that is releasing it, or the release
 // carries on underneath the new note as a duplicate.
-static int32_t voice_holding_note(int32_t note, uint32_t count) {
+static int32_t voice_holding_note(uint32_t slot, int32_t note, uint32_t count) {
+    const tVoice * voices = gVoice[slot];
+
     for (uint32_t v = 0; v < count; v++) {
-        if ((gVoice[v].note == note) && (gVoice[v].sounding || gVoice[v].gate)) {
+        if ((voices[v].note == note) && (voices[v].sounding || voices[v].gate)) {
             return (int32_t)v;
         }
     }
@@ -1734,19 +2005,20 @@ static int32_t voice_holding_note(int32_t note, uint32_t count) {
 // that is doing nothing, then the longest-released, then the oldest still held. Only the last of
 // those is a steal — cutting a note off — and it is what a polyphonic instrument does when it runs
 // out, so it is worth being sure the two cheaper cases are exhausted first.
-static uint32_t voice_to_allocate(uint32_t count) {
-    uint32_t best    = 0;
-    uint64_t bestAge = UINT64_MAX;
+static uint32_t voice_to_allocate(uint32_t slot, uint32_t count) {
+    const tVoice * voices  = gVoice[slot];
+    uint32_t       best    = 0;
+    uint64_t       bestAge = UINT64_MAX;
 
     for (uint32_t v = 0; v < count; v++) {
-        if ((gVoice[v].sounding == false) && (gVoice[v].gate == false)) {
+        if ((voices[v].sounding == false) && (voices[v].gate == false)) {
             return v;
         }
     }
 
     for (uint32_t v = 0; v < count; v++) {   // released but still ringing: the oldest of them
-        if ((gVoice[v].gate == false) && (gVoice[v].age < bestAge)) {
-            bestAge = gVoice[v].age;
+        if ((voices[v].gate == false) && (voices[v].age < bestAge)) {
+            bestAge = voices[v].age;
             best    = v;
         }
     }
@@ -1756,8 +2028,8 @@ static uint32_t voice_to_allocate(uint32_t count) {
     }
 
     for (uint32_t v = 0; v < count; v++) {   // everything is held: steal the oldest
-        if (gVoice[v].age < bestAge) {
-            bestAge = gVoice[v].age;
+        if (voices[v].age < bestAge) {
+            bestAge = voices[v].age;
             best    = v;
         }
     }
@@ -1765,9 +2037,10 @@ static uint32_t voice_to_allocate(uint32_t count) {
     return best;
 }
 
-static void voice_note_on(int32_t note) {
-    uint32_t count = atomic_load(&gEngineVoices);
-
+// `count` is the voice count from the slot's own snapshot. It used to be read from gEngineVoices,
+// which is one figure for the slot being edited — a performance can hold a Mono patch beside a Poly
+// one, and each has to allocate by its own.
+static void voice_note_on(uint32_t slot, int32_t note, uint32_t count) {
     // Bounded BEFORE it is used to pick a voice, not after. A published count is already clamped,
     // but a zero would send voice_to_allocate() round an empty loop and every note would land on
     // voice 0 — one note at a time, silently, with no obvious cause.
@@ -1776,9 +2049,9 @@ static void voice_note_on(int32_t note) {
     } else if (count > MAX_VOICES) {
         count = MAX_VOICES;
     }
-    int32_t  held  = voice_holding_note(note, count);
-    uint32_t v     = (held >= 0) ? (uint32_t)held : voice_to_allocate(count);
-    tVoice * voice = &gVoice[v];
+    int32_t  held  = voice_holding_note(slot, note, count);
+    uint32_t v     = (held >= 0) ? (uint32_t)held : voice_to_allocate(slot, count);
+    tVoice * voice = &gVoice[slot][v];
     // Auto glide only slides between overlapping notes, which is the point of it: a phrase played
     // legato slides, a detached note starts where it means to. Whether THIS VOICE'S gate is already
     // open is that test — and it is why the check has to happen before the gate is opened below.
@@ -1796,15 +2069,17 @@ static void voice_note_on(int32_t note) {
     voice->sounding    = true;
     voice->released    = 0;
     voice->fade        = 1.0;   // a stolen voice may have been fading; this note cancels that
-    voice->age         = ++gVoiceClock;
+    voice->age         = ++gVoiceClock[slot];
 }
 
 // A note-off names its note; -1 is all-notes-off. Only the gate closes — the voice keeps its note
 // and goes on sounding its release, at the pitch it was played at.
-static void voice_note_off(int32_t note) {
+static void voice_note_off(uint32_t slot, int32_t note) {
+    tVoice * voices = gVoice[slot];
+
     for (uint32_t v = 0; v < MAX_VOICES; v++) {
-        if ((note < 0) || (gVoice[v].note == note)) {
-            gVoice[v].gate = false;
+        if ((note < 0) || (voices[v].note == note)) {
+            voices[v].gate = false;
         }
     }
 }
@@ -1815,19 +2090,139 @@ uint32_t sound_engine_load_percent(void) {
     return atomic_exchange(&gLoadPercent, 0);
 }
 
+static uint32_t timing_bucket(uint64_t nanos) {
+    uint32_t top    = 0;
+    uint32_t bucket = 0;
+
+    if (nanos <= (1ULL << TIMING_MIN_SHIFT)) {
+        return 0;
+    }
+    nanos -= 1;                                       // so an exact edge lands in the bucket it closes
+    top    = 63U - (uint32_t)__builtin_clzll(nanos);  // the octave, and below it the quarter within it
+    bucket = ((top - TIMING_MIN_SHIFT) * TIMING_STEPS_PER_OCTAVE) + (uint32_t)((nanos >> (top - 2U)) & 3U) + 1U;
+    return (bucket < SOUND_ENGINE_TIMING_BUCKETS) ? bucket : (SOUND_ENGINE_TIMING_BUCKETS - 1U);
+}
+
+// The upper edge of a bucket, which is what timing_bucket() rounds up to.
+static double timing_bucket_upper_us(uint32_t bucket) {
+    if (bucket == 0) {
+        return (double)(1ULL << TIMING_MIN_SHIFT) / 1.0e3;
+    }
+    bucket -= 1;
+    return ((double)(1ULL << (TIMING_MIN_SHIFT + (bucket / TIMING_STEPS_PER_OCTAVE)))
+            * (1.0 + ((double)((bucket % TIMING_STEPS_PER_OCTAVE) + 1U) / (double)TIMING_STEPS_PER_OCTAVE))) / 1.0e3;
+}
+
+// Audio thread, once per callback of a started engine.
+static void timing_record(uint64_t nanos, uint64_t periodNanos, uint64_t finishedNanos) {
+    atomic_fetch_add_explicit(&gTimingBucket[timing_bucket(nanos)], 1, memory_order_relaxed);
+    atomic_store_explicit(&gTimingPeriodNanos, periodNanos, memory_order_relaxed);
+
+    if (nanos > atomic_load_explicit(&gTimingMaxNanos, memory_order_relaxed)) {
+        atomic_store_explicit(&gTimingMaxNanos, nanos, memory_order_relaxed);
+    }
+
+    if ((nanos * 100U) > (periodNanos * atomic_load_explicit(&gTimingMissPercent, memory_order_relaxed))) {
+        atomic_fetch_add_explicit(&gTimingMisses, 1, memory_order_relaxed);
+        atomic_store_explicit(&gTimingLastMiss, finishedNanos, memory_order_relaxed);
+    }
+}
+
+void sound_engine_timing_histogram(uint64_t counts[SOUND_ENGINE_TIMING_BUCKETS],
+                                   double upperUs[SOUND_ENGINE_TIMING_BUCKETS]) {
+    for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+        counts[b]  = atomic_load_explicit(&gTimingBucket[b], memory_order_relaxed);
+        upperUs[b] = timing_bucket_upper_us(b);
+    }
+}
+
+void sound_engine_timing_stats(tSoundEngineTiming * stats) {
+    static const double quantile[] = {0.50, 0.90, 0.99, 0.999};
+    double *            out[]      = {&stats->p50Us, &stats->p90Us, &stats->p99Us, &stats->p999Us};
+    uint64_t            counts[SOUND_ENGINE_TIMING_BUCKETS];
+    double              upperUs[SOUND_ENGINE_TIMING_BUCKETS];
+    uint64_t            total      = 0;
+
+    sound_engine_timing_histogram(counts, upperUs);
+
+    for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+        total += counts[b];
+    }
+    memset(stats, 0, sizeof(*stats));
+    stats->callbacks       = total;
+    stats->maxUs           = (double)atomic_load(&gTimingMaxNanos) / 1.0e3;
+    stats->periodUs        = (double)atomic_load(&gTimingPeriodNanos) / 1.0e3;
+    stats->missPercent     = atomic_load(&gTimingMissPercent);
+    stats->misses          = atomic_load(&gTimingMisses);
+    stats->lastMissSeconds = (double)atomic_load(&gTimingLastMiss) / 1.0e9;
+
+    for (uint32_t q = 0; (q < (sizeof(quantile) / sizeof(quantile[0]))) && (total > 0); q++) {
+        // The first bucket at which the running count reaches the quantile's rank.
+        uint64_t rank    = (uint64_t)ceil(quantile[q] * (double)total);
+        uint64_t running = 0;
+
+        for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+            running += counts[b];
+
+            if (running >= rank) {
+                // Never past the slowest callback actually seen: the bucket's edge can overshoot it.
+                *out[q] = fmin(upperUs[b], stats->maxUs);
+                break;
+            }
+        }
+    }
+}
+
+void sound_engine_timing_reset(uint32_t missPercent) {
+    for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+        atomic_store(&gTimingBucket[b], 0);
+    }
+    atomic_store(&gTimingMaxNanos, 0);
+    atomic_store(&gTimingMisses, 0);
+    atomic_store(&gTimingLastMiss, 0);
+
+    if ((missPercent >= 1) && (missPercent <= 1000)) {
+        atomic_store(&gTimingMissPercent, missPercent);
+    }
+}
+
 bool sound_engine_is_polyphonic(void) {
     return atomic_load(&gEngineVoices) > 1;
 }
 
+// Summed over every slot that is playing, so in a performance the status line's "3/12 voices" is
+// the whole instrument rather than whichever slot happens to be on screen. gParams is the UI side's
+// own copy of each snapshot, read in the lane being played, and an idle slot's carries a tap of -1.
 uint32_t sound_engine_voice_count(void) {
-    return atomic_load(&gEngineVoices);
+    uint32_t count = 0;
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        const tSoundEngineParams * params = playing_params(slot);
+
+        if (params->tap >= 0) {
+            count += params->voiceCount;
+        }
+    }
+
+    return (count > 0) ? count : atomic_load(&gEngineVoices);
 }
 
 // Read without a lock from whichever thread asks. It is a display figure that changes every time a
 // key moves, so a torn read is one frame of a number that is about to change anyway.
-uint32_t sound_engine_voices_sounding(void) {
-    uint32_t count  = 0;
-    uint32_t voices = atomic_load(&gEngineVoices);
+uint32_t sound_engine_slot_voices_sounding(uint32_t slot) {
+    const tSoundEngineParams * params = NULL;
+    uint32_t                   voices = 0;
+    uint32_t                   count  = 0;
+
+    if (slot >= MAX_SLOTS) {
+        return 0;
+    }
+    params = playing_params(slot);
+    voices = params->voiceCount;
+
+    if (params->tap < 0) {
+        return 0;
+    }
 
     // Only the voices this patch may use. Lowering a patch's voice count can leave a higher voice
     // flagged as sounding when it is no longer rendered or allocated; counting those would report
@@ -1837,7 +2232,7 @@ uint32_t sound_engine_voices_sounding(void) {
     }
 
     for (uint32_t v = 0; v < voices; v++) {
-        if (gVoice[v].sounding == true) {
+        if (gVoice[slot][v].sounding == true) {
             count++;
         }
     }
@@ -1845,12 +2240,37 @@ uint32_t sound_engine_voices_sounding(void) {
     return count;
 }
 
+uint32_t sound_engine_voices_sounding(void) {
+    uint32_t count = 0;
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        count += sound_engine_slot_voices_sounding(slot);
+    }
+
+    return count;
+}
+
+// Whether a note-on belongs to a slot. Patch mode publishes one slot that takes everything; a
+// performance can switch a slot's keyboard off, and with Keyboard Range on each slot only answers
+// between its own two keys — a split, or a layer where the ranges overlap.
+static bool slot_takes_note(const tSoundEngineParams * params, int32_t note) {
+    if ((params->tap < 0) || (params->keyboard == false)) {
+        return false;
+    }
+    return ((uint32_t)note >= params->keyLow) && ((uint32_t)note <= params->keyHigh);
+}
+
 // Audio thread. Applies the next queued event if there is one, returning false when the queue is
 // empty. Called per sample, so a note lands on the sample it arrived rather than at the next buffer
 // boundary.
-static bool take_next_note_event(void) {
+//
+// One queue feeds every slot: a note-on goes to each slot whose range covers it, and a note-off goes
+// to ALL of them. Routing the off by range as well would strand a note whenever the range, the
+// enabled slots or the performance itself changed while a key was down — the voice that took the
+// note-on would never hear its key come up.
+static bool take_next_note_event(const tSoundEngineParams * params) {
     uint32_t write = atomic_load(&gNoteWrite);
-    uint32_t slot  = 0;
+    uint32_t entry = 0;
 
     if (gNoteRead >= write) {
         return false;
@@ -1864,16 +2284,20 @@ static bool take_next_note_event(void) {
     if ((write - gNoteRead) > NOTE_QUEUE_SIZE) {
         gNoteRead = write - NOTE_QUEUE_SIZE;
     }
-    slot = gNoteRead % NOTE_QUEUE_SIZE;
+    entry = gNoteRead % NOTE_QUEUE_SIZE;
 
-    if (atomic_load(&gNoteQueue[slot].sequence) != (gNoteRead + 1)) {
+    if (atomic_load(&gNoteQueue[entry].sequence) != (gNoteRead + 1)) {
         return false;   // claimed but not yet written; it will be there next time round
     }
 
-    if ((gNoteQueue[slot].on == true) && (gNoteQueue[slot].note >= 0)) {
-        voice_note_on(gNoteQueue[slot].note);
-    } else {
-        voice_note_off(gNoteQueue[slot].note);
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if ((gNoteQueue[entry].on == true) && (gNoteQueue[entry].note >= 0)) {
+            if (slot_takes_note(&params[slot], gNoteQueue[entry].note) == true) {
+                voice_note_on(slot, gNoteQueue[entry].note, params[slot].voiceCount);
+            }
+        } else {
+            voice_note_off(slot, gNoteQueue[entry].note);
+        }
     }
     gNoteRead++;
     return true;
@@ -2261,7 +2685,7 @@ static tModule * module_feeding(tModule * sink, uint32_t connectorIndex, uint32_
 //
 // Returns NULL when nothing is feeding that bus, which is correct: an Fx-In listening to a bus
 // nobody sends to receives silence.
-static tModule * voice_area_output_for_fx(uint32_t slot, uint32_t wantedBus) {
+static tModule * voice_area_output_for_fx(uint32_t slot, uint32_t wantedBus, uint32_t variation) {
     uint32_t index = 0;
 
     for (index = 0; index < MAX_NUM_MODULES; index++) {
@@ -2270,7 +2694,6 @@ static tModule * voice_area_output_for_fx(uint32_t slot, uint32_t wantedBus) {
         if (module == NULL) {
             continue;
         }
-        uint32_t  variation   = gPatchDescr[slot].activeVariation;
         uint32_t  destination = module->param[variation][OUT_PARAM_DESTINATION].value;
 
         if (module->type == moduleType2toOut) {
@@ -2373,7 +2796,7 @@ static int32_t add_node(tSoundEngineParams * params, tModule * module, uint32_t
         // though — see voice_area_output_for_fx().
         if (kind == eNodeFxIn) {
             uint32_t  wantedBus = module->param[variation][FXIN_PARAM_SOURCE].value;
-            tModule * feeder    = voice_area_output_for_fx(module->key.slot, wantedBus);
+            tModule * feeder    = voice_area_output_for_fx(module->key.slot, wantedBus, variation);
 
             resolvedIn[0]     = (feeder != NULL) ? add_node(params, feeder, variation, depth + 1) : -1;
             resolvedSrcOut[0] = 0;
@@ -2841,13 +3264,13 @@ static uint64_t topology_signature(const tSoundEngineParams * params) {
 // Does this Out module actually reach the speakers, or is it internal routing? Getting this wrong is
 // audible in both directions: treat a send as an output and the FX area's input is heard raw
 // alongside the finished signal; ignore a real output and the patch is silent.
-static bool out_module_is_audible(tModule * module) {
+static bool out_module_is_audible(tModule * module, uint32_t variation) {
     uint32_t destination = 0;
 
     if (module == NULL) {
         return false;
     }
-    destination = module->param[gPatchDescr[module->key.slot].activeVariation][OUT_PARAM_DESTINATION].value;
+    destination = module->param[variation][OUT_PARAM_DESTINATION].value;
 
     if (module->type == moduleType4toOut) {
         return destination == 0;              // "Out"; "Fx" and "Bus" are internal
@@ -2855,21 +3278,21 @@ static bool out_module_is_audible(tModule * module) {
     return destination <= 1;                  // "Out 1/2" or "Out 3/4"
 }
 
-static tModule * find_output_module(void) {
+static tModule * find_output_module(uint32_t slot, uint32_t variation) {
     const uint32_t locations[] = {(uint32_t)locationFx, (uint32_t)locationVa};
     uint32_t       l           = 0;
     uint32_t       index       = 0;
 
     for (l = 0; l < 2; l++) {
         for (index = 0; index < MAX_NUM_MODULES; index++) {
-            tModule * module = get_module_slot(gSlot, locations[l], index);
+            tModule * module = get_module_slot(slot, locations[l], index);
 
             if ((module == NULL) || (module->type == 0)) {
                 continue;
             }
 
             if (  ((module->type == moduleType2toOut) || (module->type == moduleType4toOut))
-               && (out_module_is_audible(module) == true)) {
+               && (out_module_is_audible(module, variation) == true)) {
                 return module;
             }
         }
@@ -2909,42 +3332,72 @@ static void mark_post_mix_nodes(tSoundEngineParams * params) {
     }
 }
 
-void sound_engine_update_from_patch(void) {
-    tSoundEngineParams snapshot  = {0};
-    tModule *          tapModule = NULL;
-    uint32_t           variation = 0;
+// Which nodes feed a meter or an LED, and on which side of the mix — after mark_post_mix_nodes(),
+// which decides the side. Only the modules the engine models can show anything: a meter on a module
+// that is not in the graph has no signal behind it, and stays dark.
+static void mark_metered_nodes(uint32_t slot, tSoundEngineParams * params) {
+    params->meterCount[0] = 0;
+    params->meterCount[1] = 0;
 
-    if (atomic_load(&gActive) == false) {
-        return;
+    for (uint32_t n = 0; n < params->nodeCount; n++) {
+        tEngineNode * node   = &params->node[n];
+        tModule *     module = get_module_slot(slot, node->location, node->moduleIndex);
+        uint32_t      half   = (node->postMix == true) ? 1 : 0;
+
+        node->meter = volumeTypeNone;
+        node->led   = false;
+
+        if ((module == NULL) || (module->active == false) || (node->location > (uint32_t)locationVa)) {
+            continue;
+        }
+        node->meter = gModuleProperties[module->type].volumeType;
+        node->led   = module_led_count(module->type) > 0;
+
+        // The sequencers' "meter" is a step position, which nothing here models.
+        if (node->meter == volumeTypeSequencer) {
+            node->meter = volumeTypeNone;
+        }
+
+        if ((node->meter != volumeTypeNone) || (node->led == true)) {
+            params->meterNode[half][params->meterCount[half]++] = (uint8_t)n;
+        }
     }
-    snapshot.tap = -1;
+}
+
+// One slot's snapshot for one variation, built into `snapshot` (which arrives zeroed, tap -1). Returns
+// what the status line should say about it; sound_engine_update_from_patch() only reports the slot on
+// screen, and only the variation selected on it.
+static tSoundEngineStatus build_slot_params(uint32_t slot, uint32_t variation, tSoundEngineParams * snapshot,
+                                            uint32_t * playing) {
+    tSoundEngineStatus status    = eStatusOff;
+    tModule *          tapModule = NULL;
 
     // Glide and Bend come from the patch, not from any module in the chain — they sit on hidden
     // modules in the Morph location alongside the rest of the patch settings.
     {
-        tModule * glide = get_module_slot(gSlot, (uint32_t)locationMorph, patchModuleGlide);
-        tModule * bend  = get_module_slot(gSlot, (uint32_t)locationMorph, patchModuleBend);
+        tModule * glide = get_module_slot(slot, (uint32_t)locationMorph, patchModuleGlide);
+        tModule * bend  = get_module_slot(slot, (uint32_t)locationMorph, patchModuleBend);
 
         if (glide != NULL) {
             uint32_t mode = glide->param[0][GLIDE_TYPE].value;
 
-            snapshot.glideMode    = (mode <= (uint32_t)eGlideAuto) ? (tGlideMode)mode : eGlideOff;
-            snapshot.glideSeconds = glide_time_seconds(glide->param[0][GLIDE_SPEED].value);
+            snapshot->glideMode    = (mode <= (uint32_t)eGlideAuto) ? (tGlideMode)mode : eGlideOff;
+            snapshot->glideSeconds = glide_time_seconds(glide->param[0][GLIDE_SPEED].value);
         }
         {
-            tModule * vibrato = get_module_slot(gSlot, (uint32_t)locationMorph, patchModuleVibrato);
+            tModule * vibrato = get_module_slot(slot, (uint32_t)locationMorph, patchModuleVibrato);
 
             if (vibrato != NULL) {
                 // Depth is in cents as the dial reads it, and the rate dial spans 4 to 8 Hz.
-                snapshot.vibratoSource = vibrato->param[0][VIBRATO_MOD].value;
-                snapshot.vibratoCents  = (double)vibrato->param[0][VIBRATO_DEPTH].value;
-                snapshot.vibratoHz     = 4.0 + (((double)vibrato->param[0][VIBRATO_RATE].value / 127.0) * 4.0);
+                snapshot->vibratoSource = vibrato->param[0][VIBRATO_MOD].value;
+                snapshot->vibratoCents  = (double)vibrato->param[0][VIBRATO_DEPTH].value;
+                snapshot->vibratoHz     = 4.0 + (((double)vibrato->param[0][VIBRATO_RATE].value / 127.0) * 4.0);
             }
         }
 
         if ((bend != NULL) && (bend->param[0][BEND_ON_OFF].value != 0)) {
             // The dial reads one more than it stores, so 0 is a single semitone.
-            snapshot.bendSemitones = (double)bend->param[0][BEND_RANGE].value + 1.0;
+            snapshot->bendSemitones = (double)bend->param[0][BEND_RANGE].value + 1.0;
         }
     }
 
@@ -2956,27 +3409,25 @@ void sound_engine_update_from_patch(void) {
     // signal paths from one patch — the plug-in has no selection and always took the outputs — which
     // hid engine faults in whichever path was not being listened to.
     {
-        tapModule = find_output_module();
+        tapModule = find_output_module(slot, variation);
 
         if (tapModule == NULL) {
-            gStatus = eStatusNoOutput;
+            status = eStatusNoOutput;
         } else {
             tNodeKind kind = eNodeOsc;
 
-            variation = gPatchDescr[tapModule->key.slot].activeVariation;
-
             if (module_kind(tapModule, &kind) == false) {
-                gStatus = eStatusUnsupportedModule;
+                status = eStatusUnsupportedModule;
             } else {
-                snapshot.tap = add_node(&snapshot, tapModule, variation, 0);
+                snapshot->tap = add_node(snapshot, tapModule, variation, 0);
 
                 // Every other audible Out module, summed with the first.
-                if (snapshot.tap >= 0) {
+                if (snapshot->tap >= 0) {
                     for (uint32_t l = 0; l < 2; l++) {
                         uint32_t location = (l == 0) ? (uint32_t)locationFx : (uint32_t)locationVa;
 
                         for (uint32_t index = 0; index < MAX_NUM_MODULES; index++) {
-                            tModule * other = get_module_slot(gSlot, location, index);
+                            tModule * other = get_module_slot(slot, location, index);
 
                             if ((other == NULL) || (other == tapModule)) {
                                 continue;
@@ -2984,41 +3435,41 @@ void sound_engine_update_from_patch(void) {
 
                             if (  (  (other->type != moduleType2toOut)
                                   && (other->type != moduleType4toOut))
-                               || (out_module_is_audible(other) == false)) {
+                               || (out_module_is_audible(other, variation) == false)) {
                                 continue;
                             }
 
-                            if (snapshot.extraTapCount >= (MAX_ENGINE_TAPS - 1)) {
+                            if (snapshot->extraTapCount >= (MAX_ENGINE_TAPS - 1)) {
                                 break;
                             }
-                            int32_t   extra = add_node(&snapshot, other, variation, 0);
+                            int32_t   extra = add_node(snapshot, other, variation, 0);
 
                             if (extra >= 0) {
-                                snapshot.extraTap[snapshot.extraTapCount++] = extra;
+                                snapshot->extraTap[snapshot->extraTapCount++] = extra;
                             }
                         }
                     }
                 }
 
-                if (snapshot.tap < 0) {
+                if (snapshot->tap < 0) {
                     // The kind lookup above already succeeded, so this is the node budget or the
                     // recursion guard, not an unknown module — most likely a patch that feeds back
                     // into itself.
-                    gStatus = eStatusChainTooDeep;
-                } else if (chain_has_source(&snapshot) == false) {
-                    gStatus = eStatusNoSource;
-                } else if (chain_is_bypassed(&snapshot) == true) {
-                    gStatus = eStatusBypassed;
+                    status = eStatusChainTooDeep;
+                } else if (chain_has_source(snapshot) == false) {
+                    status = eStatusNoSource;
+                } else if (chain_is_bypassed(snapshot) == true) {
+                    status = eStatusBypassed;
                 } else {
-                    gStatus       = eStatusPlaying;
-                    gPlayingCount = snapshot.nodeCount;
+                    status   = eStatusPlaying;
+                    *playing = snapshot->nodeCount;
                 }
             }
         }
     }
 
-    if (gStatus != eStatusPlaying) {
-        snapshot.tap = -1;    // publish silence rather than a half-built chain
+    if (status != eStatusPlaying) {
+        snapshot->tap = -1;    // publish silence rather than a half-built chain
     }
     // Hand out the shared delay lines. Done here rather than in add_node() so the assignment is
     // stable for a given chain — the audio thread keys its buffers off it.
@@ -3027,53 +3478,319 @@ void sound_engine_update_from_patch(void) {
         uint32_t lines = 0;
         uint32_t verbs = 0;
 
-        for (i = 0; i < snapshot.nodeCount; i++) {
-            if (snapshot.node[i].kind == eNodeDelay) {
-                snapshot.node[i].line = lines++;
-            } else if (snapshot.node[i].kind == eNodeReverb) {
-                snapshot.node[i].line = verbs++;
+        for (i = 0; i < snapshot->nodeCount; i++) {
+            if (snapshot->node[i].kind == eNodeDelay) {
+                snapshot->node[i].line = lines++;
+            } else if (snapshot->node[i].kind == eNodeReverb) {
+                snapshot->node[i].line = verbs++;
             }
         }
     }
-    mark_post_mix_nodes(&snapshot);
-    snapshot.topology   = topology_signature(&snapshot);
-    snapshot.voiceCount = voice_count_for_patch((uint32_t)gSlot);
+    mark_post_mix_nodes(snapshot);
+    mark_metered_nodes(slot, snapshot);
+    snapshot->topology   = topology_signature(snapshot);
+    snapshot->voiceCount = voice_count_for_patch(slot);
 
-    // How many voices the audio thread may allocate. Published separately as well as in the snapshot
-    // because the note stack asks the same question from the MIDI thread, where reading the whole
-    // snapshot to answer it would be absurd.
-    atomic_store(&gEngineVoices, snapshot.voiceCount);
+    return status;
+}
 
-    // The snapshot above was built into a local, so only this section needs the writers' mutex.
-    pthread_mutex_lock(&gParamsWriteMutex);
-    atomic_fetch_add(&gParamsSeq, 1);    // now odd — a reader seeing this discards its copy
-    gParams             = snapshot;
-    atomic_fetch_add(&gParamsSeq, 1);    // even again, snapshot is whole
-    pthread_mutex_unlock(&gParamsWriteMutex);
+// What a slot contributes to a performance: its patch's own Volume dial, muted or not, and which keys
+// it answers. The Volume dial is read here and only here, and only in performance mode. Patch mode
+// has always played at the level the graph makes, and reading the dial there as well would move
+// every single-patch measurement taken so far; in a performance it is what balances one slot against
+// another, which is the job the instrument gives it.
+static void apply_perf_settings(uint32_t slot, uint32_t variation, bool performance, tSoundEngineParams * snapshot) {
+    snapshot->slotGain = 1.0;
+    snapshot->keyboard = true;
+    snapshot->keyLow   = 0;
+    snapshot->keyHigh  = 127;
+
+    if (performance == false) {
+        return;
+    }
+    {
+        tModule * volume = get_module_slot(slot, (uint32_t)locationMorph, patchModuleVolume);
+
+        // The "mute" parameter is the hardware's ACTIVE switch: 1 is sounding, 0 is muted. Every
+        // patch in PatchTestFiles stores 1 at its normal level.
+        if (volume != NULL) {
+            if (volume->param[variation][VOLUME_MUTE].value == 0) {
+                snapshot->slotGain = 0.0;
+            } else {
+                snapshot->slotGain = pow(10.0, patch_volume_db((double)volume->param[variation][VOLUME_LEVEL].value) / 20.0);
+            }
+        }
+    }
+    snapshot->keyboard = atomic_load(&gPerfSettings.slot[slot].keyboardEnabled) != 0;
+
+    if (atomic_load(&gPerfSettings.keyboardRange) != 0) {
+        snapshot->keyLow  = atomic_load(&gPerfSettings.slot[slot].rangeLower);
+        snapshot->keyHigh = atomic_load(&gPerfSettings.slot[slot].rangeUpper);
+    }
+}
+
+// One lane: the slot's snapshot for one variation, as sound_engine_update_from_patch() publishes it.
+static tSoundEngineStatus build_lane(uint32_t slot, uint32_t variation, bool build, bool performance,
+                                     tSoundEngineParams * snapshot, uint32_t * playing) {
+    tSoundEngineStatus status = eStatusOff;
+
+    // Zeroed with memset rather than = {0}: lanes are compared byte for byte below, padding included.
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->tap = -1;
+    *playing      = 0;
+
+    if (build == true) {
+        status = build_slot_params(slot, variation, snapshot, playing);
+        apply_perf_settings(slot, variation, performance, snapshot);
+        atomic_fetch_add_explicit(&gLaneBuilds, 1, memory_order_relaxed);
+    }
+
+    return status;
+}
+
+// Under gParamsWriteMutex.
+static void publish_lane(uint32_t slot, uint32_t lane, const tSoundEngineParams * snapshot) {
+    atomic_fetch_add(&gParamsSeq[slot][lane], 1);    // now odd — a reader seeing this discards its copy
+    gParams[slot][lane] = *snapshot;
+
+    if (atomic_load_explicit(&gSnapshotCheck, memory_order_relaxed) == true) {
+        gParamsCheck[slot][lane] = snapshot_checksum(&gParams[slot][lane]);
+    }
+    atomic_fetch_add(&gParamsSeq[slot][lane], 1);    // even again, snapshot is whole
+}
+
+// Whether a slot is built at all: in patch mode the slot on screen, in a performance each slot it has
+// switched on. A slot that is not built still publishes, with empty lanes.
+static bool slot_is_built(uint32_t slot, bool performance) {
+    return performance ? (atomic_load(&gGlobalSettings.slot[slot].enabled) != 0) : (slot == gSlot);
+}
+
+// Every slot is published on every call, idle ones included: an idle slot's snapshot is empty with a
+// tap of -1, which is what tells the audio thread to skip it. Patch mode builds the slot on screen
+// and nothing else, exactly as it did when the engine only knew about one slot. A performance builds
+// each slot it has switched on.
+//
+// THE SELECTED VARIATION IS BUILT EVERY TIME, and so is any lane sound_engine_lane_edited() named
+// since the last call. Nothing else is built unless it has to be. If the selected lane comes out
+// exactly as it was published, nothing in the patch has moved since the last call — this runs on
+// every redraw, and nearly every redraw is that — so every stale lane is brought up to date. If it
+// comes out different, something was edited, morphed or reloaded, and which of the other lanes that
+// moved cannot be told without building them: they are marked stale instead, so a knob being dragged
+// costs one lane per redraw rather than all nine, and the first redraw after the knob is let go pays
+// for the rest at once. That is what keeps a variation switch a single store: by the time a click on
+// a variation button can land, the lane it selects has nearly always been rebuilt already. A switch
+// that beats the idle call to it has sound_engine_select_variation() build the lane instead. With
+// nothing stale, the idle call walks the lanes round robin, one per call, for a write to a variation
+// that nobody reported.
+void sound_engine_update_from_patch(void) {
+    bool performance = atomic_load(&gGlobalSettings.perfMode) == 1;
+
+    if (atomic_load(&gActive) == false) {
+        return;
+    }
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        tSoundEngineParams snapshot = {0};
+        tSoundEngineStatus status   = eStatusOff;
+        uint32_t           playing  = 0;
+        uint32_t           active   = (gPatchDescr[slot].activeVariation < NUM_VARIATIONS)
+                                      ? gPatchDescr[slot].activeVariation : 0;
+        bool               build    = slot_is_built(slot, performance);
+        uint32_t           rebuild  = 0;
+
+        status = build_lane(slot, active, build, performance, &snapshot, &playing);
+
+        if (slot == gSlot) {
+            gStatus       = build ? status : eStatusSlotDisabled;
+            gPlayingCount = playing;
+
+            // How many voices the audio thread may allocate. Published separately as well as in the
+            // snapshot because the note stack asks the same question from the MIDI thread, where
+            // reading the whole snapshot to answer it would be absurd. The slot on screen is the one
+            // it asks about — see sound_engine_is_polyphonic().
+            atomic_store(&gEngineVoices, (snapshot.voiceCount > 0) ? snapshot.voiceCount : 1);
+        }
+
+        // Held across the other lanes' builds as well as the publishing: which lanes need building is
+        // decided by comparing with what is published, and another writer must not move it meanwhile.
+        pthread_mutex_lock(&gParamsWriteMutex);
+
+        // Taken before the lanes are built, so an edit landing during the build marks its lane again.
+        rebuild = atomic_exchange(&gLaneEdited[slot], 0) & ~(1U << active);
+
+        if (gLanesBuilt[slot] == false) {
+            publish_lane(slot, active, &snapshot);
+
+            for (uint32_t lane = 0; lane < NUM_VARIATIONS; lane++) {
+                if (lane != active) {
+                    (void)build_lane(slot, lane, build, performance, &snapshot, &playing);
+                    publish_lane(slot, lane, &snapshot);
+                }
+            }
+            gLaneStale[slot]  = 0;
+            gLanesBuilt[slot] = true;
+        } else {
+            bool moved = memcmp(&snapshot, &gParams[slot][active], sizeof(snapshot)) != 0;
+
+            if (moved == true) {
+                publish_lane(slot, active, &snapshot);
+                gLaneStale[slot] |= (1U << NUM_VARIATIONS) - 1U;
+            }
+            gLaneStale[slot] &= ~(1U << active);
+
+            if ((moved == false) && (rebuild == 0)) {
+                uint32_t lane = gLaneRefresh[slot];
+
+                if (gLaneStale[slot] != 0) {
+                    rebuild = gLaneStale[slot];
+                } else {
+                    gLaneRefresh[slot] = (lane + 1) % NUM_VARIATIONS;
+
+                    if (lane != active) {
+                        rebuild = 1U << lane;
+                    }
+                }
+            }
+
+            for (uint32_t lane = 0; lane < NUM_VARIATIONS; lane++) {
+                if ((rebuild & (1U << lane)) != 0) {
+                    (void)build_lane(slot, lane, build, performance, &snapshot, &playing);
+                    publish_lane(slot, lane, &snapshot);
+                    gLaneStale[slot] &= ~(1U << lane);
+                }
+            }
+        }
+        atomic_store_explicit(&gLaneSelect[slot], active, memory_order_release);
+        pthread_mutex_unlock(&gParamsWriteMutex);
+    }
+}
+
+void sound_engine_lane_edited(uint32_t slot, uint32_t variation) {
+    if ((slot < MAX_SLOTS) && (variation < NUM_VARIATIONS)) {
+        atomic_fetch_or(&gLaneEdited[slot], 1U << variation);
+    }
+}
+
+// Selecting a variation, as far as the audio thread is concerned: the lane was resolved when the slot
+// was built and kept current by every idle update since, so this is one store and takes no lock, safe
+// from any thread but the audio thread. The next sound_engine_update_from_patch() agrees with it,
+// finds the lane as it left it, and builds nothing new.
+//
+// A lane that is stale or was edited since — a switch made before the first redraw after an edit —
+// is built and published first, here, under the mutex, so the switch never lands on settings from
+// before the last edit; the store after it is what the audio thread sees. The lock-free check can
+// race an update that is just marking the lane stale, and then plays the lane from before that edit
+// until the caller's next update, which has activeVariation to go on and builds it.
+void sound_engine_select_variation(uint32_t slot, uint32_t variation) {
+    if ((slot < MAX_SLOTS) && (variation < NUM_VARIATIONS)) {
+        uint32_t bit = 1U << variation;
+
+        if (((atomic_load(&gLaneStale[slot]) | atomic_load(&gLaneEdited[slot])) & bit) == 0) {
+            atomic_store_explicit(&gLaneSelect[slot], variation, memory_order_release);
+            return;
+        }
+        pthread_mutex_lock(&gParamsWriteMutex);
+
+        if (gLanesBuilt[slot] == true) {
+            uint32_t edited = atomic_fetch_and(&gLaneEdited[slot], ~(1U << variation));
+
+            if (((gLaneStale[slot] | edited) & (1U << variation)) != 0) {
+                bool               performance = atomic_load(&gGlobalSettings.perfMode) == 1;
+                tSoundEngineParams snapshot    = {0};
+                uint32_t           playing     = 0;
+
+                (void)build_lane(slot, variation, slot_is_built(slot, performance), performance,
+                                 &snapshot, &playing);
+                publish_lane(slot, variation, &snapshot);
+                gLaneStale[slot] &= ~(1U << variation);
+            }
+        }
+        atomic_store_explicit(&gLaneSelect[slot], variation, memory_order_release);
+        pthread_mutex_unlock(&gParamsWriteMutex);
+    }
+}
+
+void sound_engine_set_variation_crossfade(double seconds) {
+    if (!(seconds > 0.0)) {
+        seconds = 0.0;
+    } else if (seconds > 10.0) {
+        seconds = 10.0;
+    }
+    atomic_store(&gCrossfadeMicros, (uint32_t)((seconds * 1.0e6) + 0.5));
+}
+
+uint64_t sound_engine_lane_builds(void) {
+    return atomic_load_explicit(&gLaneBuilds, memory_order_relaxed);
 }
 
 // Audio thread half of the seqlock. Returns the newest whole snapshot, or the last one it managed to
 // read cleanly if the UI thread happens to be publishing right now — one buffer of slightly stale
 // parameters is inaudible, and blocking here would not be.
-static tSoundEngineParams read_params(void) {
+//
+// The fence matters. The copy is plain loads, and plain loads may be satisfied after a later acquire
+// load — so without it, on a weakly ordered CPU (Apple silicon, any ARM), the second sequence read
+// could be done before the copy finished and bless a copy that overlapped a write. x86 happens not to
+// reorder loads with loads, which is why this never showed there.
+//
+// `lane` is the variation to read, which the caller takes from gLaneSelect once so it knows which one
+// it got. gLastGoodParams stays per slot: a lane that cannot be read keeps the slot playing what it was.
+static tSoundEngineParams read_params(uint32_t slot, uint32_t lane) {
     uint32_t attempt = 0;
+    bool     check   = atomic_load_explicit(&gSnapshotCheck, memory_order_relaxed);
 
     for (attempt = 0; attempt < PARAMS_READ_ATTEMPTS; attempt++) {
-        uint32_t           before = atomic_load(&gParamsSeq);
+        uint32_t           before = atomic_load(&gParamsSeq[slot][lane]);
+        uint64_t           sum    = 0;
         tSoundEngineParams copy;
 
         if ((before & 1u) != 0u) {
             continue;    // mid-write
         }
-        copy = gParams;
+        memcpy(&copy, &gParams[slot][lane], sizeof(copy));
+        sum = gParamsCheck[slot][lane];
+        atomic_thread_fence(memory_order_acquire);
 
-        if (atomic_load(&gParamsSeq) == before) {
-            gLastGoodParams = copy;
-            break;
+        if (atomic_load(&gParamsSeq[slot][lane]) == before) {
+            // The seqlock says whole. With the check on, make sure — the checksum can be 0 only for a
+            // slot never published while checking was on, so that one is taken on trust.
+            if ((check == true) && (sum != 0) && (snapshot_checksum(&copy) != sum)) {
+                atomic_fetch_add(&gTornSnapshots, 1);
+                continue;
+            }
+            gLastGoodParams[slot] = copy;
+            return gLastGoodParams[slot];
+        }
+    }
+    atomic_fetch_add_explicit(&gStaleSnapshots, 1, memory_order_relaxed);
+
+    return gLastGoodParams[slot];
+}
+
+void sound_engine_set_snapshot_check(bool on) {
+    uint32_t slot = 0;
+
+    // Under the writers' mutex, so no publish is halfway between storing a snapshot and its checksum
+    // when the switch flips. Old checksums are cleared: they describe snapshots from before.
+    pthread_mutex_lock(&gParamsWriteMutex);
+
+    for (slot = 0; slot < MAX_SLOTS; slot++) {
+        for (uint32_t lane = 0; lane < NUM_VARIATIONS; lane++) {
+            atomic_fetch_add(&gParamsSeq[slot][lane], 1);
+            gParamsCheck[slot][lane] = on ? snapshot_checksum(&gParams[slot][lane]) : 0;
+            atomic_fetch_add(&gParamsSeq[slot][lane], 1);
         }
     }
+    atomic_store(&gSnapshotCheck, on);
+    atomic_store(&gTornSnapshots, 0);
+    pthread_mutex_unlock(&gParamsWriteMutex);
+}
 
-    return gLastGoodParams;
+uint64_t sound_engine_torn_snapshots(void) {
+    return atomic_load(&gTornSnapshots);
+}
+
+uint64_t sound_engine_stale_snapshots(void) {
+    return atomic_load(&gStaleSnapshots);
 }
 
 // ---------------------------------------------------------------------------------------------
@@ -3223,39 +3940,42 @@ static double osc_shp_wave(uint32_t waveform, double phase, double dt, double sh
 
 // A delay line with feedback and a one-pole damping filter in the loop — the usual arrangement, and
 // what the LP knob on the module controls.
-static double delay_step(uint32_t line, double input, double timeSeconds, double feedback,
+//
+// The time is read FRACTIONALLY, through the allpass in delayRing.h, and arrives already smoothed
+// (gSmoothedTime). Truncated to whole samples and stepped at frame rate, a Time dial being turned
+// jumped the read point by hundreds of samples at each redraw, and every jump was a click; now it
+// glides, which is the tape-like pitch bend a real delay makes when its time is moved.
+static double delay_step(uint32_t slot, uint32_t line, double input, double timeSeconds, double feedback,
                          double damping, double hpCoeff, double mix) {
-    uint32_t samples = (uint32_t)(timeSeconds * gSampleRate);
-    uint32_t readPos = 0;
-    double   wet     = 0.0;
+    double samples = timeSeconds * gSampleRate;
+    double wet     = 0.0;
 
     if (line >= MAX_DELAY_LINES) {
         return input;
     }
 
-    if (samples < 1) {
-        samples = 1;
-    } else if (samples >= DELAY_LINE_SAMPLES) {
-        samples = DELAY_LINE_SAMPLES - 1;
+    if (samples < 1.0) {
+        samples = 1.0;
+    } else if (samples > (double)(DELAY_LINE_MASK - 1U)) {
+        samples = (double)(DELAY_LINE_MASK - 1U);
     }
-    readPos                             = (gDelayWrite[line] + DELAY_LINE_SAMPLES - samples) % DELAY_LINE_SAMPLES;
-    wet                                 = (double)gDelayLine[line][readPos];
+    wet = delay_ring_read_allpass(gDelayLine[slot][line], DELAY_LINE_MASK, gDelayWrite[slot][line], samples,
+                                  &gDelayAllpass[slot][line]);
 
     // Damping in the feedback path, so each repeat is duller than the last rather than the dry
     // signal being filtered once.
-    gDelayDamp[line]                   += (1.0 - damping) * (wet - gDelayDamp[line]);
-    double   fed     = gDelayDamp[line];
+    gDelayDamp[slot][line]                   += (1.0 - damping) * (wet - gDelayDamp[slot][line]);
+    double   fed     = gDelayDamp[slot][line];
 
     // Then the high-pass, also in the loop, so each repeat loses more low end than the last — the
     // counterpart to the LP above. Built as a one-pole lowpass subtracted from the signal, which is
     // the cheapest honest one-pole high-pass there is. A coefficient of zero is the dial at 0,
     // where the filter measures flat and is simply switched out.
     if (hpCoeff > 0.0) {
-        gDelayHp[line] += hpCoeff * (fed - gDelayHp[line]);
-        fed             = fed - gDelayHp[line];
+        gDelayHp[slot][line] += hpCoeff * (fed - gDelayHp[slot][line]);
+        fed             = fed - gDelayHp[slot][line];
     }
-    gDelayLine[line][gDelayWrite[line]] = (float)(input + (fed * feedback));
-    gDelayWrite[line]                   = (gDelayWrite[line] + 1) % DELAY_LINE_SAMPLES;
+    delay_ring_write(gDelayLine[slot][line], DELAY_LINE_MASK, &gDelayWrite[slot][line], input + (fed * feedback));
 
     // DRY/WET IS THE SAME NON-CROSSFADE THE REVERB USES, and this was a plain linear blend. The two
     // gains are independent, each a ramp cubed, and they overlap: dry holds full scale until the
@@ -3338,19 +4058,19 @@ static double delay_step(uint32_t line, double input, double timeSeconds, double
 //
 // TimeMod is NOT implemented: the module has a modulation input for its width and this ignores it,
 // which is honest rather than inventing a law for it. Nothing measured so far uses it.
-static double pulse_step(uint32_t voice, uint32_t node, double input, const tEngineNode * spec) {
-    double   prev    = gPulsePrev[voice][node];
+static double pulse_step(uint32_t slot, uint32_t voice, uint32_t node, double input, const tEngineNode * spec) {
+    double   prev    = gPulsePrev[slot][voice][node];
     double   width   = spec->pulseSeconds * gSampleRate;
     uint32_t samples = (width < 1.0) ? 1U : (uint32_t)width;
 
-    gPulsePrev[voice][node] = input;
+    gPulsePrev[slot][voice][node] = input;
 
     if ((prev <= PULSE_THRESHOLD) && (input > PULSE_THRESHOLD)) {
-        gPulseCount[voice][node] = samples;
+        gPulseCount[slot][voice][node] = samples;
     }
 
-    if (gPulseCount[voice][node] > 0) {
-        gPulseCount[voice][node]--;
+    if (gPulseCount[slot][voice][node] > 0) {
+        gPulseCount[slot][voice][node]--;
         return 1.0;
     }
     return 0.0;
@@ -3372,27 +4092,27 @@ static double chorus_triangle(double phase) {
 // ONE CHANNEL of the sweep, read at the LFO phase it is given. The two channels differ ONLY in that
 // phase, which is why this is one function called twice rather than two structures — measured, see
 // the antiphase note above chorus_step().
-static double chorus_tap(uint32_t node, uint32_t ch, double input, double phase, double amount) {
-    double   sweep   = 0.0;
-    uint32_t samples = 0;
-    uint32_t readPos = 0;
-    double   wet     = 0.0;
+static double chorus_tap(uint32_t slot, uint32_t node, uint32_t ch, double input, double phase, double amount) {
+    double sweep   = 0.0;
+    double samples = 0.0;
+    double wet     = 0.0;
 
     // The DEPTH is fixed; only the rate follows the dial. The shape is a TRIANGLE — measured, and
     // the difference between a chorus and a vibrato; see chorus_triangle().
-    sweep                                         = CHORUS_CENTRE_S + (CHORUS_SWEEP_S * chorus_triangle(phase));
-    samples                                       = (uint32_t)(sweep * gSampleRate);
+    //
+    // Read at the FRACTIONAL delay the sweep asks for, linearly — this is the moving read the linear
+    // path in delayRing.h exists for. It used to truncate to whole samples.
+    sweep   = CHORUS_CENTRE_S + (CHORUS_SWEEP_S * chorus_triangle(phase));
+    samples = sweep * gSampleRate;
 
-    if (samples < 1) {
-        samples = 1;
-    } else if (samples >= CHORUS_SAMPLES) {
-        samples = CHORUS_SAMPLES - 1;
+    if (samples < 1.0) {
+        samples = 1.0;
+    } else if (samples > (double)(CHORUS_MASK - 1U)) {
+        samples = (double)(CHORUS_MASK - 1U);
     }
-    readPos                                       = (gChorusWrite[node][ch] + CHORUS_SAMPLES - samples) % CHORUS_SAMPLES;
-    wet                                           = (double)gChorusLine[node][ch][readPos];
+    wet     = delay_ring_read_linear(gChorusLine[slot][node][ch], CHORUS_MASK, gChorusWrite[slot][node][ch], samples);
 
-    gChorusLine[node][ch][gChorusWrite[node][ch]] = (float)input;
-    gChorusWrite[node][ch]                        = (gChorusWrite[node][ch] + 1) % CHORUS_SAMPLES;
+    delay_ring_write(gChorusLine[slot][node][ch], CHORUS_MASK, &gChorusWrite[slot][node][ch], input);
 
     // A CONSTANT-POWER BLEND whose wet/dry ratio IS the dial, measured on the instrument.
     //
@@ -3423,9 +4143,9 @@ static double chorus_tap(uint32_t node, uint32_t ch, double input, double phase,
 // re-confirmed from the retained captures the same day — L/R phase at the AM fundamental of 180.0,
 // 179.9 and 180.1 degrees across three files, so antiphase and not the quarter cycle that was the
 // other candidate.
-static void chorus_step(uint32_t node, double input, double depth, double amount,
-                        double * outLeft, double * outRight) {
-    double phase = gChorusLfo[node];
+static void chorus_step(uint32_t slot, uint32_t node, double input, double depth, double amount,
+                        g2_sample_t * outLeft, g2_sample_t * outRight) {
+    double phase = gChorusLfo[slot][node];
 
     // DETUNE SETS THE RATE, NOT THE DEPTH — this had it the other way round, with the rate fixed at
     // 0.7 Hz and the sweep scaled by the dial.
@@ -3449,30 +4169,30 @@ static void chorus_step(uint32_t node, double input, double depth, double amount
     // values falls inside it.
     // BOTH TAPS READ THE PHASE BEFORE IT ADVANCES, so the two channels are sampled at the same
     // instant rather than one being a sample ahead of the other.
-    *outLeft          = chorus_tap(node, 0, input, phase, amount);
-    *outRight         = chorus_tap(node, 1, input, phase + 0.5, amount);
+    *outLeft          = chorus_tap(slot, node, 0, input, phase, amount);
+    *outRight         = chorus_tap(slot, node, 1, input, phase + 0.5, amount);
 
-    gChorusLfo[node] += (CHORUS_RATE_MAX_HZ * depth) / gSampleRate;
+    gChorusLfo[slot][node] += (CHORUS_RATE_MAX_HZ * depth) / gSampleRate;
 
-    if (gChorusLfo[node] >= 1.0) {
-        gChorusLfo[node] -= 1.0;
+    if (gChorusLfo[slot][node] >= 1.0) {
+        gChorusLfo[slot][node] -= 1.0;
     }
 }
 
 // Peak-following compressor. Above the threshold the excess is divided by the ratio; the follower
 // has separate attack and release so it grabs quickly and lets go slowly.
-static double compress_step(uint32_t voice, uint32_t node, double input, const tEngineNode * spec) {
+static double compress_step(uint32_t slot, uint32_t voice, uint32_t node, double input, const tEngineNode * spec) {
     double level = fabs(input);
     double gain  = 1.0;
 
-    if (level > gCompEnv[voice][node]) {
-        gCompEnv[voice][node] += spec->attackCoeff * (level - gCompEnv[voice][node]);
+    if (level > gCompEnv[slot][voice][node]) {
+        gCompEnv[slot][voice][node] += spec->attackCoeff * (level - gCompEnv[slot][voice][node]);
     } else {
-        gCompEnv[voice][node] += spec->releaseCoeff * (level - gCompEnv[voice][node]);
+        gCompEnv[slot][voice][node] += spec->releaseCoeff * (level - gCompEnv[slot][voice][node]);
     }
 
-    if ((gCompEnv[voice][node] > spec->threshold) && (spec->threshold > 0.0)) {
-        double over = gCompEnv[voice][node] / spec->threshold;
+    if ((gCompEnv[slot][voice][node] > spec->threshold) && (spec->threshold > 0.0)) {
+        double over = gCompEnv[slot][voice][node] / spec->threshold;
 
         gain = pow(over, (1.0 / spec->ratio) - 1.0);
     }
@@ -3485,12 +4205,13 @@ static double compress_step(uint32_t voice, uint32_t node, double input, const t
 // filter's coefficient, which inverted it — a knob labelled Brightness made the tail darker as it
 // opened, and the manual's advice that "the most natural range is between 25 and 50" (p.251) landed
 // on the dullest part of the travel instead of the liveliest.
-static void reverb_step(double input, double timeSeconds, double timeNorm, double brightness,
-                        double mix, uint32_t type, double * outLeft, double * outRight) {
+static void reverb_step(uint32_t slot, double input, double timeSeconds, double timeNorm, double brightness,
+                        double mix, uint32_t type, g2_sample_t * outLeft, g2_sample_t * outRight) {
     double   sum[REVERB_CHANNELS] = {0.0, 0.0};
     uint32_t ch                   = 0;
     uint32_t i                    = 0;
-    double   lfo[RV_LINES];
+    double   lfoCos[RV_LINES];
+    double   lfoSin[RV_LINES];
     // A one-pole lowpass inside each comb, so every pass round the loop loses more high end — which
     // is what makes a tail decay into a thump rather than ringing on with the same tone.
     //
@@ -3534,41 +4255,47 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
     // lower half damps the top with a one-pole, the upper half damps the bottom by the same law.
     // The centre is right; the ends need a Brightness sweep off the hardware before either
     // REVERB_DAMP_MAX or REVERB_BRIGHT_CURVE means anything.
-    double          tilt      = (brightness - 0.5) * 2.0;
-    double          dampLo    = (tilt < 0.0) ? (REVERB_DAMP_MAX * pow(-tilt, REVERB_BRIGHT_CURVE)) : 0.0;
-    double          dampHi    = (tilt > 0.0) ? (REVERB_DAMP_MAX * pow(tilt, REVERB_BRIGHT_CURVE)) : 0.0;
+    tRvCoeffs *     coeff     = &gRvCoeff[slot];
     double          scale     = kReverbTypeScale[(type < REVERB_TYPE_COUNT) ? type : 0];
 
-    // ONE TRIP ROUND THE LOOP, and the gain that costs. The sections either side of it are
-    // lossless, so this single number is the whole decay: 60 dB in the requested time, three
-    // decades over however many trips fit into it.
-    double          gRvGain[RV_LINES];
-    static uint32_t sLastType = REVERB_TYPE_COUNT;   // forces the reset below on the first call
+    if (brightness != coeff->brightness) {
+        double tilt = (brightness - 0.5) * 2.0;
 
+        coeff->dampLo     = (float)((tilt < 0.0) ? (REVERB_DAMP_MAX * pow(-tilt, REVERB_BRIGHT_CURVE)) : 0.0);
+        coeff->dampHi     = (float)((tilt > 0.0) ? (REVERB_DAMP_MAX * pow(tilt, REVERB_BRIGHT_CURVE)) : 0.0);
+        coeff->brightness = brightness;
+    }
 
     // Changing type resizes every delay line, so the positions into them are meaningless and the
     // contents are a room that no longer exists. Cleared rather than carried over — which is also
     // what the instrument does: "changing reverb type will force the Sound Engine to recalculate and
     // thus cause a brief moment of silence" (p.251).
-    if (type != sLastType) {
-        memset(gPreDelay, 0, sizeof(gPreDelay));
-        memset(gRvMem, 0, sizeof(gRvMem));
-        memset(gRvCur, 0, sizeof(gRvCur));
-        memset(gRvDamp, 0, sizeof(gRvDamp));
-        memset(gRvLow, 0, sizeof(gRvLow));
-        memset(gRvLfo, 0, sizeof(gRvLfo));
-        memset(gRevInLp, 0, sizeof(gRevInLp));
-        memset(gRevInLp2, 0, sizeof(gRevInLp2));
-        memset(gRevInLp3, 0, sizeof(gRevInLp3));
-        memset(gRevInLp4, 0, sizeof(gRevInLp4));
-        memset(gRvLoop, 0, sizeof(gRvLoop));
-        memset(gPreDelayPos, 0, sizeof(gPreDelayPos));
-        sLastType  = type;
+    //
+    // A NEW RATE IS A NEW LAYOUT TOO: every span is a length at 96 kHz converted by RV_RATE, so a
+    // restart at another device rate left the old room's lengths in place until the type moved.
+    if ((type != gRvLastType[slot]) || (gSampleRate != coeff->rate)) {
+        memset(gPreDelay[slot], 0, sizeof(gPreDelay[slot]));
+        memset(gRvMem[slot], 0, sizeof(gRvMem[slot]));
+        memset(gRvCur[slot], 0, sizeof(gRvCur[slot]));
+        memset(gRvDamp[slot], 0, sizeof(gRvDamp[slot]));
+        memset(gRvLow[slot], 0, sizeof(gRvLow[slot]));
+
+        for (i = 0; i < RV_LINES; i++) {
+            gRvLfoCos[slot][i] = 1.0;
+            gRvLfoSin[slot][i] = 0.0;
+        }
+        memset(gRevInLp[slot], 0, sizeof(gRevInLp[slot]));
+        memset(gRevInLp2[slot], 0, sizeof(gRevInLp2[slot]));
+        memset(gRevInLp3[slot], 0, sizeof(gRevInLp3[slot]));
+        memset(gRevInLp4[slot], 0, sizeof(gRevInLp4[slot]));
+        memset(gRvLoop[slot], 0, sizeof(gRvLoop[slot]));
+        memset(gPreDelayPos[slot], 0, sizeof(gPreDelayPos[slot]));
+        gRvLastType[slot] = type;
 
         // Lay the spans out end to end. Each one starts where the last finished, so a section
         // writing at its own base and reading at the next gets exactly its own length of delay and
         // no two sections can ever share a cell.
-        gRvAddr[0] = 16;
+        gRvAddr[slot][0] = 16;
 
         for (i = 0; i < eRvSpanCount; i++) {
             // THE PRE-DELAY IS MEASURED, NOT SCALED. Every other span is a length recovered from
@@ -3606,7 +4333,34 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
                   ? ((meas > lead) ? (meas - lead) : 2)
                   : (uint32_t)((double)kRvLen[i] * scale * RV_RATE);
 
-            gRvAddr[i + 1] = gRvAddr[i] + ((len < 2) ? 2 : len);
+            gRvAddr[slot][i + 1] = gRvAddr[slot][i] + ((len < 2) ? 2 : len);
+        }
+
+        // Everything below depends on the rate or the layout and on nothing else.
+        coeff->rate        = gSampleRate;
+        coeff->timeSeconds = -1.0;   // the gains depend on the line lengths just laid out
+        coeff->inA1        = exp(-2.0 * M_PI * REVERB_INPUT_LP_HZ / gSampleRate);
+        coeff->inA2        = exp(-2.0 * M_PI * REVERB_INPUT_LP2_HZ / gSampleRate);
+        coeff->inA4        = exp(-2.0 * M_PI * REVERB_INPUT_LP4_HZ / gSampleRate);
+
+        for (i = 0; i < RV_LINES; i++) {
+            coeff->lfoCos[i] = cos(2.0 * M_PI * kRvModHz[i] / gSampleRate);
+            coeff->lfoSin[i] = sin(2.0 * M_PI * kRvModHz[i] / gSampleRate);
+        }
+
+        // ALTERNATING SIGNS are applied where the taps are summed; these are only the places. The
+        // right channel reads the same fractions of the same lines a little earlier — see
+        // REVERB_SPREAD for why earlier and not later.
+        for (ch = 0; ch < REVERB_CHANNELS; ch++) {
+            uint32_t spread = (ch == 0) ? 0 : REVERB_SPREAD;
+
+            for (i = 0; i < RV_OUTTAPS; i++) {
+                uint32_t n   = kRvTapLine[i];
+                uint32_t len = gRvAddr[slot][n + 1] - gRvAddr[slot][n];
+                uint32_t off = (uint32_t)(kRvTapFrac[i] * (double)len);
+
+                coeff->tapAt[ch][i] = gRvAddr[slot][n] + ((off > spread) ? (off - spread) : 0u);
+            }
         }
     }
 
@@ -3622,15 +4376,24 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
     // different lengths, so their gains differ; the Householder mix is orthogonal and takes nothing
     // out, which is what lets a closed form like this set the decay exactly with no trim fitted to a
     // render.
-    for (i = 0; i < RV_LINES; i++) {
-        // THE LINE ALONE, not the allpass in front of it. An allpass passes a fraction of its input
-        // straight through -- that is what the -g feedforward term is -- so only some of the energy
-        // ever takes its delay, and charging the decay for the whole of it ran a Hall 30% fast.
-        double len = (double)(gRvAddr[kRvLineDl[i] + 1] - gRvAddr[kRvLineDl[i]]);
+    //
+    // ONE TRIP ROUND THE LOOP, and the gain that costs. The sections either side of it are lossless,
+    // so this single number per line is the whole decay. The Hadamard's 1/sqrt(8) is folded in here,
+    // since every pass multiplies by both.
+    if (timeSeconds != coeff->timeSeconds) {
+        for (i = 0; i < RV_LINES; i++) {
+            // THE LINE ALONE, not the allpass in front of it. An allpass passes a fraction of its
+            // input straight through -- that is what the -g feedforward term is -- so only some of
+            // the energy ever takes its delay, and charging the decay for the whole of it ran a Hall
+            // 30% fast.
+            double len = (double)(gRvAddr[slot][kRvLineDl[i] + 1] - gRvAddr[slot][kRvLineDl[i]]);
 
-        gRvGain[i] = (timeSeconds > 0.01)
-                     ? (pow(10.0, (-3.0 * len) / (gSampleRate * timeSeconds)) / RV_MOD_LOSS)
-                     : 0.0;
+            coeff->gain[i] = (float)((timeSeconds > 0.01)
+                                     ? ((pow(10.0, (-3.0 * len) / (gSampleRate * timeSeconds)) / RV_MOD_LOSS)
+                                        * RV_HADAMARD)
+                                     : 0.0);
+        }
+        coeff->timeSeconds = timeSeconds;
     }
 
     // ONE BANK PER CHANNEL. The two run the same structure and decorrelate through their tap
@@ -3639,16 +4402,19 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
     // behind, so the two never move their modes the same way at the same moment -- one more thing
     // keeping them uncorrelated, on top of the tap offset.
     for (i = 0; i < RV_LINES; i++) {
-        lfo[i]    = gRvLfo[i];
-        gRvLfo[i] = gRvLfo[i] + (kRvModHz[i] / gSampleRate);
+        double c    = gRvLfoCos[slot][i];
+        double s    = gRvLfoSin[slot][i];
+        double nc   = (c * coeff->lfoCos[i]) - (s * coeff->lfoSin[i]);
+        double ns   = (s * coeff->lfoCos[i]) + (c * coeff->lfoSin[i]);
+        double norm = 1.5 - (0.5 * ((nc * nc) + (ns * ns)));
 
-        if (gRvLfo[i] >= 1.0) {
-            gRvLfo[i] -= 1.0;
-        }
+        lfoCos[i]          = c;
+        lfoSin[i]          = s;
+        gRvLfoCos[slot][i] = nc * norm;
+        gRvLfoSin[slot][i] = ns * norm;
     }
 
     for (ch = 0; ch < REVERB_CHANNELS; ch++) {
-        uint32_t spread   = (ch == 0) ? 0 : REVERB_SPREAD;
         double   diffused = input;
 
         // THE PRE-DELAY IS A SPAN OF THE TANK'S OWN MEMORY, the first one, and it does not
@@ -3683,42 +4449,27 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
         {
             double   v      = diffused;
             uint32_t modMax = (uint32_t)(RV_MOD_DEPTH * RV_RATE);
-            double   phOff  = (ch == 0) ? 0.0 : 0.25;
             uint32_t i      = 0;
             double   tapSum = 0.0;
-            double   line[RV_LINES];
 
-#define RVR(a)       ((double)gRvMem[ch][(gRvCur[ch] + (a)) & (RV_MEM - 1)])
-#define RVW(a, x)    (gRvMem[ch][(gRvCur[ch] + (a)) & (RV_MEM - 1)] = (float)(x))
+#define RVR(a)       ((double)gRvMem[slot][ch][(gRvCur[slot][ch] + (a)) & (RV_MEM - 1)])
+#define RVW(a, x)    (gRvMem[slot][ch][(gRvCur[slot][ch] + (a)) & (RV_MEM - 1)] = (float)(x))
 
             // A plain line: hand `v` in, get it back L samples later.
 #define RVDLY(n)                         \
    do {                                  \
-       double d = RVR(gRvAddr[(n) + 1]); \
-       RVW(gRvAddr[n], v);               \
+       double d = RVR(gRvAddr[slot][(n) + 1]); \
+       RVW(gRvAddr[slot][n], v);               \
        v = d;                            \
    }                                     \
    while (0)
 
             // An allpass section, the form the recovered gains describe.
-            // A MODULATED LINE. The read position sweeps across the slack at the end of the span,
-            // interpolating between the two samples it falls between -- without that the delay would
-            // step a whole sample at a time and the steps would be heard as clicks.
-#define RVDLYM(n, off)                                            \
-   do {                                                           \
-       double   rd = (double)(gRvAddr[(n) + 1] - modMax) + (off); \
-       uint32_t ri = (uint32_t)rd;                                \
-       double   fr = rd - (double)ri;                             \
-       double   d  = (RVR(ri) * (1.0 - fr)) + (RVR(ri + 1) * fr); \
-       RVW(gRvAddr[n], v);                                        \
-       v = d;                                                     \
-   } while (0)
-
 #define RVAP(n, g)                       \
    do {                                  \
-       double d = RVR(gRvAddr[(n) + 1]); \
+       double d = RVR(gRvAddr[slot][(n) + 1]); \
        double w = v + ((g) * d);         \
-       RVW(gRvAddr[n], w);               \
+       RVW(gRvAddr[slot][n], w);               \
        v = d - ((g) * w);                \
    } while (0)
 
@@ -3737,18 +4488,31 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
             // Leaving it out is what made the tank sound metallic: dead flat to 16 kHz, 26 dB of
             // treble the instrument does not have.
             {
-                double a1 = exp(-2.0 * M_PI * REVERB_INPUT_LP_HZ / gSampleRate);
-                double a2 = exp(-2.0 * M_PI * REVERB_INPUT_LP2_HZ / gSampleRate);
+                double a1 = coeff->inA1;
+                double a2 = coeff->inA2;
 
-                gRevInLp[ch]  = ((1.0 - a1) * v) + (a1 * gRevInLp[ch]);
+                gRevInLp[slot][ch]  = ((1.0 - a1) * v) + (a1 * gRevInLp[slot][ch]);
                 double a3 = REVERB_INPUT_LP_TIME * timeNorm;
 
-                gRevInLp2[ch] = ((1.0 - a2) * gRevInLp[ch]) + (a2 * gRevInLp2[ch]);
-                double a4 = exp(-2.0 * M_PI * REVERB_INPUT_LP4_HZ / gSampleRate);
-
-                gRevInLp3[ch] = ((1.0 - a3) * gRevInLp2[ch]) + (a3 * gRevInLp3[ch]);
-                gRevInLp4[ch] = ((1.0 - a4) * gRevInLp3[ch]) + (a4 * gRevInLp4[ch]);
-                v             = gRevInLp4[ch];
+                gRevInLp2[slot][ch] = ((1.0 - a2) * gRevInLp[slot][ch]) + (a2 * gRevInLp2[slot][ch]);
+                double a4 = coeff->inA4;
+
+                gRevInLp3[slot][ch] = ((1.0 - a3) * gRevInLp2[slot][ch]) + (a3 * gRevInLp3[slot][ch]);
+                gRevInLp4[slot][ch] = ((1.0 - a4) * gRevInLp3[slot][ch]) + (a4 * gRevInLp4[slot][ch]);
+
+                // FLUSHED, because a one-pole with silence at its input never reaches zero. Each
+                // step multiplies by a pole above one half, and the smallest denormal times 0.74
+                // rounds back UP to the smallest denormal — so all four states sat there forever
+                // after the first note, and every multiply on them took the processor's slow path.
+                // That was half the reverb's cost on x86, in silence. Nothing below 1e-30 is audible
+                // by six hundred decibels.
+                if (fabs(gRevInLp4[slot][ch]) < RV_FLUSH) {
+                    gRevInLp[slot][ch]  = (fabs(gRevInLp[slot][ch]) < RV_FLUSH) ? 0.0 : gRevInLp[slot][ch];
+                    gRevInLp2[slot][ch] = (fabs(gRevInLp2[slot][ch]) < RV_FLUSH) ? 0.0 : gRevInLp2[slot][ch];
+                    gRevInLp3[slot][ch] = (fabs(gRevInLp3[slot][ch]) < RV_FLUSH) ? 0.0 : gRevInLp3[slot][ch];
+                    gRevInLp4[slot][ch] = 0.0;
+                }
+                v             = gRevInLp4[slot][ch];
             }
 
             // The input stage: pre-delay, then four short allpasses that smear the attack before
@@ -3761,51 +4525,86 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
 
             diffused = v;
 
-            // THE FOUR LINES. Each gets the input with its own sign and its own share of the
-            // previous sample's mix. Injecting in phase into every line drives the tank's common
+            // THE EIGHT LINES, all at once. Each gets the input with its own sign and its own share of
+            // the previous sample's mix. Injecting in phase into every line drives the tank's common
             // mode -- the one where all four hold the same thing -- and that mode has a period of
             // its own, so it beats. In phase it put a 12.2 dB lobe at 6.8 Hz into the tail.
-            for (i = 0; i < RV_LINES; i++) {
-                v              = ((i & 1) ? -diffused : diffused) + gRvLoop[ch][i];
+            {
+                static const tRvLanes kSign = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+                tRvLanes feed  = (kSign * (float)diffused) + gRvLoop[slot][ch];
+                tRvLanes sweep = {0};
+                tRvLanes frac  = {0};
+                tRvLanes near  = {0};
+                tRvLanes far   = {0};
+                tRvLanes line  = {0};
+                tRvLanes mixed = {0};
+                float    lo    = coeff->dampLo;
+                float    hi    = coeff->dampHi;
+
+                // A MODULATED READ PER LINE. The read position sweeps across the slack at the end of
+                // the span, interpolating between the two samples it falls between -- without that
+                // the delay would step a whole sample at a time and the steps would be heard as
+                // clicks. The right channel runs a quarter cycle behind: -sin where the left has cos.
+                for (i = 0; i < RV_LINES; i++) {
+                    double osc = (ch == 0) ? lfoCos[i] : -lfoSin[i];
+
+                    sweep[i] = (float)((0.5 - (0.5 * osc)) * (double)modMax);
+                }
+
+                // THE ONE PART THAT CANNOT BE A VECTOR: eight lines at eight unrelated addresses is
+                // a gather, and neither target has one worth using for eight. Every read happens
+                // before any write, which is safe because no line reads another's span -- the
+                // highest cell a line reads is the next span's write address, and the scalar
+                // version read that before the next line wrote it too.
+                for (i = 0; i < RV_LINES; i++) {
+                    uint32_t n     = kRvLineDl[i];
+                    uint32_t whole = (uint32_t)sweep[i];
+                    uint32_t at    = gRvAddr[slot][n + 1] - modMax + whole;
+
+                    frac[i] = sweep[i] - (float)whole;
+                    near[i] = (float)RVR(at);
+                    far[i]  = (float)RVR(at + 1u);
+                }
 
-                RVDLYM(kRvLineDl[i], (0.5 - (0.5 * cos(2.0 * M_PI * (lfo[i] + phOff)))) * (double)modMax);
+                for (i = 0; i < RV_LINES; i++) {
+                    RVW(gRvAddr[slot][kRvLineDl[i]], feed[i]);
+                }
 
                 // Brightness, one filter per line and inside the loop, so it accumulates with every
                 // pass rather than colouring the output once on the way out.
-                gRvDamp[ch][i] = ((1.0 - dampLo) * v) + (dampLo * gRvDamp[ch][i]);
-                gRvLow[ch][i]  = ((1.0 - RV_LOW_A) * gRvDamp[ch][i]) + (RV_LOW_A * gRvLow[ch][i]);
-                line[i]        = gRvDamp[ch][i] - (dampHi * gRvLow[ch][i]);
-            }
-
-            // THE MIXING MATRIX, a 4-point Hadamard as two butterfly stages. Orthogonal, so it moves
-            // energy between the lines without creating or destroying any -- which is what lets the
-            // decay below be a closed form rather than a figure trimmed against a render.
-            //
-            // EVERY LINE REACHES EVERY OTHER LINE ON EVERY PASS. That is what stops each one being a
-            // comb in its own right: an echo entering one line leaves spread across all four, is
-            // spread again a few milliseconds later, and the echo count squares instead of
-            // repeating. Without it, four parallel lines are just four combs.
-            {
-                double a0 = line[0] + line[4], a4 = line[0] - line[4];
-                double a1 = line[1] + line[5], a5 = line[1] - line[5];
-                double a2 = line[2] + line[6], a6 = line[2] - line[6];
-                double a3 = line[3] + line[7], a7 = line[3] - line[7];
-                double b0 = a0 + a2, b2 = a0 - a2;
-                double b1 = a1 + a3, b3 = a1 - a3;
-                double b4 = a4 + a6, b6 = a4 - a6;
-                double b5 = a5 + a7, b7 = a5 - a7;
+                line                  = near + (frac * (far - near));
+                gRvDamp[slot][ch]     = ((1.0f - lo) * line) + (lo * gRvDamp[slot][ch]);
+                gRvLow[slot][ch]      = ((float)(1.0 - RV_LOW_A) * gRvDamp[slot][ch])
+                                        + ((float)RV_LOW_A * gRvLow[slot][ch]);
+                line                  = gRvDamp[slot][ch] - (hi * gRvLow[slot][ch]);
+
+                // THE MIXING MATRIX, an 8-point Hadamard as a fast Walsh-Hadamard transform: three
+                // butterfly stages, pairs 4 apart, then 2, then 1, each a shuffle, a multiply by a
+                // sign pattern and an add across all eight lanes. Orthogonal, so it moves energy
+                // between the lines without creating or destroying any -- which is what lets the
+                // decay be a closed form rather than a figure trimmed against a render.
+                //
+                // EVERY LINE REACHES EVERY OTHER LINE ON EVERY PASS. That is what stops each one
+                // being a comb in its own right: an echo entering one line leaves spread across all
+                // eight, is spread again a few milliseconds later, and the echo count squares
+                // instead of repeating. Without it, parallel lines are just parallel combs.
+                {
+                    static const tRvLanes kStride4 = {1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f};
+                    static const tRvLanes kStride2 = {1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f};
+                    static const tRvLanes kStride1 = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f};
+
+                    mixed = RV_SHUFFLE(line, 0, 1, 2, 3, 0, 1, 2, 3)
+                            + (kStride4 * RV_SHUFFLE(line, 4, 5, 6, 7, 4, 5, 6, 7));
+                    mixed = RV_SHUFFLE(mixed, 0, 1, 0, 1, 4, 5, 4, 5)
+                            + (kStride2 * RV_SHUFFLE(mixed, 2, 3, 2, 3, 6, 7, 6, 7));
+                    mixed = RV_SHUFFLE(mixed, 0, 0, 2, 2, 4, 4, 6, 6)
+                            + (kStride1 * RV_SHUFFLE(mixed, 1, 1, 3, 3, 5, 5, 7, 7));
+                }
 
                 // PER-LINE DECAY GAIN, each line losing 60 dB in the requested time over ITS OWN
                 // length. One gain shared by all eight would decay the short lines faster than the
                 // long ones and leave the tail's colour drifting as it faded.
-                gRvLoop[ch][0] = (b0 + b1) * RV_HADAMARD * gRvGain[0];
-                gRvLoop[ch][1] = (b0 - b1) * RV_HADAMARD * gRvGain[1];
-                gRvLoop[ch][2] = (b2 + b3) * RV_HADAMARD * gRvGain[2];
-                gRvLoop[ch][3] = (b2 - b3) * RV_HADAMARD * gRvGain[3];
-                gRvLoop[ch][4] = (b4 + b5) * RV_HADAMARD * gRvGain[4];
-                gRvLoop[ch][5] = (b4 - b5) * RV_HADAMARD * gRvGain[5];
-                gRvLoop[ch][6] = (b6 + b7) * RV_HADAMARD * gRvGain[6];
-                gRvLoop[ch][7] = (b6 - b7) * RV_HADAMARD * gRvGain[7];
+                gRvLoop[slot][ch] = mixed * coeff->gain;
             }
 
             // THE OUTPUT TAPS read INSIDE the four lines, never at a section's own write address.
@@ -3815,22 +4614,17 @@ static void reverb_step(double input, double timeSeconds, double timeNorm, doubl
             // along a line is the circulating signal at that point of its trip, which is what a
             // reverb output is made of.
             //
-            // ALTERNATING SIGNS, and the right channel reads the same fractions of the same lines
-            // a little earlier -- see REVERB_SPREAD for why earlier and not later.
+            // ALTERNATING SIGNS, at the addresses laid out with the room (coeff->tapAt).
             for (i = 0; i < RV_OUTTAPS; i++) {
-                uint32_t n   = kRvTapLine[i];
-                uint32_t len = gRvAddr[n + 1] - gRvAddr[n];
-                uint32_t off = (uint32_t)(kRvTapFrac[i] * (double)len);
-                uint32_t at  = gRvAddr[n] + ((off > spread) ? (off - spread) : 0u);
+                double tap = RVR(coeff->tapAt[ch][i]);
 
-                tapSum += (i & 1) ? -RVR(at) : RVR(at);
+                tapSum += (i & 1) ? -tap : tap;
             }
 
             sum[ch]    = tapSum * RV_TAP_SCALE;
-            gRvCur[ch] = (gRvCur[ch] - 1u) & (RV_MEM - 1);
+            gRvCur[slot][ch] = (gRvCur[slot][ch] - 1u) & (RV_MEM - 1);
 
 #undef RVAP
-#undef RVDLYM
 #undef RVDLY
 #undef RVR
 #undef RVW
@@ -3928,31 +4722,32 @@ void sound_engine_render_reverb_ir(double deviceRate, uint32_t type, uint32_t ti
         type = 0;
     }
     gSampleRate = deviceRate * (double)ENGINE_OVERSAMPLE;
+    uint32_t slot = 0;    // an offline tool with no performance: slot 0's reverb is the scratch one
 
     // Cleared explicitly rather than relying on reverb_step()'s own type-change reset: a second render
     // at the SAME type in one process would otherwise start inside the first one's tail, and the
     // resulting lag set would be a mixture of two rooms — the identical trap the hardware captures hit
     // when settings were grouped by counting.
-    memset(gPreDelay, 0, sizeof(gPreDelay));
-    memset(gRvMem, 0, sizeof(gRvMem));
-    memset(gRvCur, 0, sizeof(gRvCur));
-    memset(gRvDamp, 0, sizeof(gRvDamp));
-    memset(gRvLow, 0, sizeof(gRvLow));
-    memset(gRvLoop, 0, sizeof(gRvLoop));
-    memset(gPreDelayPos, 0, sizeof(gPreDelayPos));
+    memset(gPreDelay[slot], 0, sizeof(gPreDelay[slot]));
+    memset(gRvMem[slot], 0, sizeof(gRvMem[slot]));
+    memset(gRvCur[slot], 0, sizeof(gRvCur[slot]));
+    memset(gRvDamp[slot], 0, sizeof(gRvDamp[slot]));
+    memset(gRvLow[slot], 0, sizeof(gRvLow[slot]));
+    memset(gRvLoop[slot], 0, sizeof(gRvLoop[slot]));
+    memset(gPreDelayPos[slot], 0, sizeof(gPreDelayPos[slot]));
 
     double timeSeconds = kReverbDecayBase[type] + (kReverbDecaySlope[type] * (double)timeValue);
     double timeNorm    = (double)timeValue / 127.0;
     double brightness  = (double)brightValue / 127.0;
 
     for (uint32_t i = 0; i < frames; i++) {
-        double in   = (i == 0) ? 1.0 : 0.0;
-        double wetL = 0.0;
-        double wetR = 0.0;
+        double      in   = (i == 0) ? 1.0 : 0.0;
+        g2_sample_t wetL = 0.0;
+        g2_sample_t wetR = 0.0;
 
         // mix at 1.0 is fully wet, matching DryWet 127 on the hardware — and with the dry/wet law
         // above that means the dry ramp is zero, so nothing of the click itself is in the output.
-        reverb_step(in, timeSeconds, timeNorm, brightness, 1.0, type, &wetL, &wetR);
+        reverb_step(slot, in, timeSeconds, timeNorm, brightness, 1.0, type, &wetL, &wetR);
 
         out[(i * 2) + 0] = (float)wetL;
         out[(i * 2) + 1] = (float)wetR;
@@ -4043,8 +4838,8 @@ static double ladder_filter(double * state, double input, double g, double k, ui
 
 // One ADSR step. Times are in seconds; each stage moves linearly towards its target, which is
 // plenty for shaping a note and keeps the stage logic obvious.
-static double envelope_step(uint32_t voice, uint32_t node, const tEngineNode * spec, bool gate) {
-    double level = gEnvLevel[voice][node];
+static double envelope_step(uint32_t slot, uint32_t voice, uint32_t node, const tEngineNode * spec, bool gate) {
+    double level = gEnvLevel[slot][voice][node];
     double step  = 0.0;
 
     if (gate == true) {
@@ -4053,54 +4848,54 @@ static double envelope_step(uint32_t voice, uint32_t node, const tEngineNode * s
         // FALLING, holding the filter part open, and the attack began late from wherever it landed.
         // Attacking from the current level is what an ADSR does — the level is deliberately not
         // zeroed, so a fast retrigger rises from where it was rather than clicking to nothing first.
-        if ((gEnvStage[voice][node] == eEnvIdle) || (gEnvStage[voice][node] == eEnvRelease)) {
-            gEnvStage[voice][node]    = eEnvAttack;
-            gEnvProgress[voice][node] = 0.0;
-            gEnvStart[voice][node]    = level;   // rise from wherever a fast retrigger caught it
+        if ((gEnvStage[slot][voice][node] == eEnvIdle) || (gEnvStage[slot][voice][node] == eEnvRelease)) {
+            gEnvStage[slot][voice][node]    = eEnvAttack;
+            gEnvProgress[slot][voice][node] = 0.0;
+            gEnvStart[slot][voice][node]    = level;   // rise from wherever a fast retrigger caught it
         }
-    } else if (gEnvStage[voice][node] != eEnvIdle) {
-        if (gEnvStage[voice][node] != eEnvRelease) {
-            gEnvProgress[voice][node] = 0.0;
-            gEnvStart[voice][node]    = level;   // fall from the level the key was let go at
+    } else if (gEnvStage[slot][voice][node] != eEnvIdle) {
+        if (gEnvStage[slot][voice][node] != eEnvRelease) {
+            gEnvProgress[slot][voice][node] = 0.0;
+            gEnvStart[slot][voice][node]    = level;   // fall from the level the key was let go at
         }
-        gEnvStage[voice][node] = eEnvRelease;
+        gEnvStage[slot][voice][node] = eEnvRelease;
     }
 
-    switch (gEnvStage[voice][node]) {
+    switch (gEnvStage[slot][voice][node]) {
         case eEnvAttack:
         {
             step                       = 1.0 / (spec->attack * gSampleRate);
-            gEnvProgress[voice][node] += step;
+            gEnvProgress[slot][voice][node] += step;
 
-            if (gEnvProgress[voice][node] >= 1.0) {
-                gEnvProgress[voice][node] = 0.0;
+            if (gEnvProgress[slot][voice][node] >= 1.0) {
+                gEnvProgress[slot][voice][node] = 0.0;
                 level                     = 1.0;
-                gEnvStage[voice][node]    = eEnvDecay;
+                gEnvStage[slot][voice][node]    = eEnvDecay;
             } else {
                 // From wherever the stage began, so a note struck during release still rises
                 // smoothly from the level it had rather than jumping.
-                level = gEnvStart[voice][node]
-                        + ((1.0 - gEnvStart[voice][node]) * env_attack_curve((uint32_t)spec->wave, gEnvProgress[voice][node]));
+                level = gEnvStart[slot][voice][node]
+                        + ((1.0 - gEnvStart[slot][voice][node]) * env_attack_curve((uint32_t)spec->wave, gEnvProgress[slot][voice][node]));
             }
             break;
         }
         case eEnvDecay:
         {
             step                       = 1.0 / (spec->decay * gSampleRate);
-            gEnvProgress[voice][node] += step;
+            gEnvProgress[slot][voice][node] += step;
 
-            if (gEnvProgress[voice][node] >= 1.0) {
-                gEnvProgress[voice][node] = 0.0;
+            if (gEnvProgress[slot][voice][node] >= 1.0) {
+                gEnvProgress[slot][voice][node] = 0.0;
                 level                     = spec->sustain;
-                gEnvStage[voice][node]    = eEnvSustain;
+                gEnvStage[slot][voice][node]    = eEnvSustain;
             } else {
                 level = spec->sustain
-                        + ((1.0 - spec->sustain) * env_fall_curve((uint32_t)spec->wave, gEnvProgress[voice][node]));
+                        + ((1.0 - spec->sustain) * env_fall_curve((uint32_t)spec->wave, gEnvProgress[slot][voice][node]));
             }
 
             if (level <= spec->sustain) {
                 level                  = spec->sustain;
-                gEnvStage[voice][node] = eEnvSustain;
+                gEnvStage[slot][voice][node] = eEnvSustain;
             }
             break;
         }
@@ -4112,19 +4907,19 @@ static double envelope_step(uint32_t voice, uint32_t node, const tEngineNode * s
         case eEnvRelease:
         {
             step                       = 1.0 / (spec->release * gSampleRate);
-            gEnvProgress[voice][node] += step;
+            gEnvProgress[slot][voice][node] += step;
 
-            if (gEnvProgress[voice][node] >= 1.0) {
-                gEnvProgress[voice][node] = 0.0;
+            if (gEnvProgress[slot][voice][node] >= 1.0) {
+                gEnvProgress[slot][voice][node] = 0.0;
                 level                     = 0.0;
-                gEnvStage[voice][node]    = eEnvIdle;
+                gEnvStage[slot][voice][node]    = eEnvIdle;
             } else {
-                level = gEnvStart[voice][node] * env_fall_curve((uint32_t)spec->wave, gEnvProgress[voice][node]);
+                level = gEnvStart[slot][voice][node] * env_fall_curve((uint32_t)spec->wave, gEnvProgress[slot][voice][node]);
             }
 
             if (level <= 0.0) {
                 level                  = 0.0;
-                gEnvStage[voice][node] = eEnvIdle;
+                gEnvStage[slot][voice][node] = eEnvIdle;
             }
             break;
         }
@@ -4134,12 +4929,12 @@ static double envelope_step(uint32_t voice, uint32_t node, const tEngineNode * s
             break;
         }
     }
-    gEnvLevel[voice][node] = level;
+    gEnvLevel[slot][voice][node] = level;
     return level;
 }
 
 // The signal arriving at one of a node's inputs: whichever output of whichever node feeds it.
-static double signal_in(const tEngineNode * spec, double value[][2], uint32_t input) {
+static g2_sample_t signal_in(const tEngineNode * spec, g2_sample_t value[][2], uint32_t input) {
     int32_t source = spec->in[input];
 
     if ((input >= spec->inCount) || (source < 0)) {
@@ -4149,8 +4944,8 @@ static double signal_in(const tEngineNode * spec, double value[][2], uint32_t in
 }
 
 // One sample of the raw waveform, at whatever rate the caller is stepping the phase.
-// `voice` IS NEEDED HERE, and its absence was a bug rather than an omission. gSuperPhase is
-// [MAX_VOICES][MAX_ENGINE_NODES][2]; the Super branch below indexed it as gSuperPhase[node][0], which
+// `voice` IS NEEDED HERE, and its absence was a bug rather than an omission. gSuperPhase[slot] is
+// [MAX_VOICES][MAX_ENGINE_NODES][2]; the Super branch below indexed it as gSuperPhase[slot][node][0], which
 // puts the NODE number in the VOICE position and 0/1 in the node position. The compiler had been saying
 // so all along — passing `double (*)[2]` where a `double *` is expected is what a two-deep index into a
 // three-deep array produces.
@@ -4160,7 +4955,7 @@ static double signal_in(const tEngineNode * spec, double value[][2], uint32_t in
 // different Super oscillators trod on each other's storage. A single voice with one Super oscillator
 // is unaffected — it read [node][0][0] and now reads [0][node][0], the same value in a different slot —
 // so what changes audibly is polyphonic Super and multi-Super patches, which is the point.
-static double osc_waveform(uint32_t voice, uint32_t node, const tEngineNode * spec, double phase, double dt, double shape) {
+static double osc_waveform(uint32_t slot, uint32_t voice, uint32_t node, const tEngineNode * spec, double phase, double dt, double shape) {
     // The shape oscillators have their own eight waveforms, and Shape morphs each of them rather
     // than acting as a pulse width, so they do not share the switch below.
     if (spec->kind == eNodeOscShp) {
@@ -4192,8 +4987,8 @@ static double osc_waveform(uint32_t voice, uint32_t node, const tEngineNode * sp
             double down = dt * 0.9941;    // about -10 cents
             double sum  = osc_saw(phase, dt);
 
-            sum += osc_saw(advance_phase(&gSuperPhase[voice][node][0], up), up);
-            sum += osc_saw(advance_phase(&gSuperPhase[voice][node][1], down), down);
+            sum += osc_saw(advance_phase(&gSuperPhase[slot][voice][node][0], up), up);
+            sum += osc_saw(advance_phase(&gSuperPhase[slot][voice][node][1], down), down);
             return sum / 3.0;
         }
         default:
@@ -4209,13 +5004,13 @@ static double osc_waveform(uint32_t voice, uint32_t node, const tEngineNode * sp
 // there — the filter, mixers and amplifiers below them are linear — so oversampling here alone
 // removes the aliasing without disturbing the delay, chorus and reverb, whose buffers are sized in
 // samples and would all have to be resized for a change of engine rate.
-static double oscillator_step(uint32_t voice, uint32_t node, const tEngineNode * spec, double voicePitch,
+static double oscillator_step(uint32_t slot, uint32_t voice, uint32_t node, const tEngineNode * spec, double voicePitch,
                               double pitchDirect, double pitchVar, double shape) {
-    double   pitch     = spec->basePitch;
-    double   frequency = 0.0;
-    double   dt        = 0.0;
-    double   sum       = 0.0;
-    uint32_t step      = 0;
+    double      pitch     = spec->basePitch;
+    double      frequency = 0.0;
+    double      dt        = 0.0;
+    g2_sample_t sum       = 0.0;
+    uint32_t    step      = 0;
     uint32_t tap       = 0;
 
     // Kbt on transposes the played note by the oscillator's offset from unity; Kbt off leaves the
@@ -4245,10 +5040,10 @@ static double oscillator_step(uint32_t voice, uint32_t node, const tEngineNode *
     dt        = frequency / (gSampleRate * (double)OSC_OVERSAMPLE);
 
     for (step = 0; step < OSC_OVERSAMPLE; step++) {
-        double phase = advance_phase(&gPhase[voice][node], dt);
+        double phase = advance_phase(&gPhase[slot][voice][node], dt);
 
-        gOscHistory[voice][node][gOscHistoryPos[voice][node]] = (float)osc_waveform(voice, node, spec, phase, dt, shape);
-        gOscHistoryPos[voice][node]                           = (gOscHistoryPos[voice][node] + 1) % OSC_DECIMATE_TAPS;
+        gOscHistory[slot][voice][node][gOscHistoryPos[slot][voice][node]] = (float)osc_waveform(slot, voice, node, spec, phase, dt, shape);
+        gOscHistoryPos[slot][voice][node]                           = (gOscHistoryPos[slot][voice][node] + 1) % OSC_DECIMATE_TAPS;
     }
 
     // One output for every OSC_OVERSAMPLE inputs, so the filter only has to be evaluated at the
@@ -4259,11 +5054,11 @@ static double oscillator_step(uint32_t voice, uint32_t node, const tEngineNode *
     // Walking the read position and wrapping with a comparison is the identical sequence of taps in
     // the identical order — bit-for-bit the same output — for a fraction of the cost.
     {
-        const float * history = gOscHistory[voice][node];
-        uint32_t      oldest  = gOscHistoryPos[voice][node];
+        const float * history = gOscHistory[slot][voice][node];
+        uint32_t      oldest  = gOscHistoryPos[slot][voice][node];
 
         for (tap = 0; tap < OSC_DECIMATE_TAPS; tap++) {
-            sum += (double)history[oldest] * gOscDecimate[OSC_DECIMATE_TAPS - 1 - tap];
+            sum += (g2_sample_t)history[oldest] * gOscDecimate[OSC_DECIMATE_TAPS - 1 - tap];
             oldest++;
 
             if (oldest >= OSC_DECIMATE_TAPS) {
@@ -4282,8 +5077,8 @@ static double oscillator_step(uint32_t voice, uint32_t node, const tEngineNode *
 //
 // Not band-limited, and deliberately so: an LFO runs at control rate on the hardware, well below
 // anything that could alias into the audio band.
-static double lfo_step(uint32_t voice, uint32_t node, const tEngineNode * spec) {
-    double phase = advance_phase(&gPhase[voice][node], spec->rateHz / gSampleRate);
+static double lfo_step(uint32_t slot, uint32_t voice, uint32_t node, const tEngineNode * spec) {
+    double phase = advance_phase(&gPhase[slot][voice][node], spec->rateHz / gSampleRate);
     double wave  = 0.0;
 
     if (spec->active == false) {
@@ -4354,14 +5149,14 @@ static double lfo_step(uint32_t voice, uint32_t node, const tEngineNode * spec)
             case 4:
             case 5:
             {
-                if (phase < gLfoLastPhase[voice][node]) {
-                    gLfoTarget[voice][node] = ((double)rand() / (double)RAND_MAX * 2.0) - 1.0;
+                if (phase < gLfoLastPhase[slot][voice][node]) {
+                    gLfoTarget[slot][voice][node] = ((double)rand() / (double)RAND_MAX * 2.0) - 1.0;
                 }
-                wave = (spec->wave == 4) ? gLfoTarget[voice][node]
-                       : (gLfoHeld[voice][node] + ((gLfoTarget[voice][node] - gLfoHeld[voice][node]) * phase));
+                wave = (spec->wave == 4) ? gLfoTarget[slot][voice][node]
+                       : (gLfoHeld[slot][voice][node] + ((gLfoTarget[slot][voice][node] - gLfoHeld[slot][voice][node]) * phase));
 
-                if (phase < gLfoLastPhase[voice][node]) {
-                    gLfoHeld[voice][node] = gLfoTarget[voice][node];
+                if (phase < gLfoLastPhase[slot][voice][node]) {
+                    gLfoHeld[slot][voice][node] = gLfoTarget[slot][voice][node];
                 }
                 break;
             }
@@ -4372,7 +5167,7 @@ static double lfo_step(uint32_t voice, uint32_t node, const tEngineNode * spec)
             }
         }
     }
-    gLfoLastPhase[voice][node] = phase;
+    gLfoLastPhase[slot][voice][node] = phase;
 
     {
         double unipolar = (wave + 1.0) * 0.5;
@@ -4425,7 +5220,7 @@ static double lfo_step(uint32_t voice, uint32_t node, const tEngineNode * spec)
 #define FLT_CONTROL_MIN    (0.0)
 #define FLT_CONTROL_MAX    (127.0)
 
-static double filter_step(uint32_t voice, uint32_t node, const tEngineNode * spec, double input, double mod, double voicePitch,
+static double filter_step(uint32_t slot, uint32_t voice, uint32_t node, const tEngineNode * spec, double input, double mod, double voicePitch,
                           double cutoffParam, double resonance) {
     double control = cutoffParam;
     double cutoff  = 0.0;
@@ -4525,7 +5320,7 @@ static double filter_step(uint32_t voice, uint32_t node, const tEngineNode * spe
     // oscillation, is a property of the rate rather than of the filter.
 #define LADDER_K_MAX    (4.3)
 
-    return ladder_filter(gLadder[voice][node], input, g, LADDER_K_MAX * resonance, 1 + spec->extraPoles);
+    return ladder_filter(gLadder[slot][voice][node], input, g, LADDER_K_MAX * resonance, 1 + spec->extraPoles);
 }
 
 // One node's output for one voice, written into value[n]. Extracted so the Voice Area pass and the
@@ -4533,11 +5328,12 @@ static double filter_step(uint32_t voice, uint32_t node, const tEngineNode * spe
 // nodes they visit and in the voice index they carry.
 //
 // `voice` selects the per-voice state; FX Area nodes are evaluated once with voice 0, which is also
-// the only voice the shared delay/chorus/reverb buffers ever see.
-static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * paramsIn,
-                      double value[][2], double voicePitch) {
+// the only voice the shared delay/chorus/reverb buffers ever see. `gate` is that voice's key, passed
+// in rather than read from gVoice so the FX Area can run on the pipeline thread — see FX PIPELINE.
+static void eval_node(uint32_t slot, uint32_t voice, uint32_t n, const tSoundEngineParams * paramsIn,
+                      g2_sample_t value[][2], double voicePitch, bool gate) {
     const tEngineNode * spec = &paramsIn->node[n];
-    double              a    = signal_in(spec, value, 0);
+    g2_sample_t         a    = signal_in(spec, value, 0);
 
     value[n][0] = 0.0;
     value[n][1] = 0.0;
@@ -4545,7 +5341,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
     switch (spec->kind) {
         case eNodeLfo:
         {
-            value[n][0] = lfo_step(voice, n, spec);
+            value[n][0] = lfo_step(slot, voice, n, spec);
             value[n][1] = value[n][0];
             break;
         }
@@ -4555,20 +5351,20 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
             // Connector 0 is the direct Pitch input, connector 1 the knob-attenuated
             // PitchVar — see oscillator_step().
             value[n][0] = (spec->active == true)
-                              ? oscillator_step(voice, n, spec, voicePitch, a, signal_in(spec, value, 1),
-                                                gSmoothedShape[n])
+                              ? oscillator_step(slot, voice, n, spec, voicePitch, a, signal_in(spec, value, 1),
+                                                gSmoothedShape[slot][n])
                               : 0.0;
             break;
         }
         case eNodeFilter:
         {
-            value[n][0] = filter_step(voice, n, spec, a, signal_in(spec, value, 1), voicePitch,
-                                      gSmoothedCutoff[n], gSmoothedRes[n]);
+            value[n][0] = filter_step(slot, voice, n, spec, a, signal_in(spec, value, 1), voicePitch,
+                                      gSmoothedCutoff[slot][n], gSmoothedRes[slot][n]);
             break;
         }
         case eNodeEnv:
         {
-            double env = envelope_step(voice, n, spec, gVoice[voice].gate);
+            double env = envelope_step(slot, voice, n, spec, gate);
 
             // Output 0 is the envelope itself, for patching at a modulation input. Output 1
             // is whatever audio is patched into the module, shaped by that envelope — the
@@ -4579,7 +5375,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
         }
         case eNodeLevAmp:
         {
-            value[n][0] = a * gSmoothedGain[n];
+            value[n][0] = a * gSmoothedGain[slot][n];
             break;
         }
         case eNodeLevMult:
@@ -4589,7 +5385,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
         }
         case eNodePulse:
         {
-            value[n][0] = pulse_step(voice, n, a, spec);
+            value[n][0] = pulse_step(slot, voice, n, a, spec);
             break;
         }
         case eNodeMix:
@@ -4613,7 +5409,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
             for (c = 0; c < spec->inCount; c++) {
                 uint32_t channel = stereoPairs ? (c / 2) : c;
 
-                value[n][0] += signal_in(spec, value, c) * legScale * gSmoothedLevel[n][channel];
+                value[n][0] += signal_in(spec, value, c) * legScale * gSmoothedLevel[slot][n][channel];
             }
 
             break;
@@ -4621,7 +5417,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
         case eNodeChorus:
         {
             if (spec->active == true) {
-                chorus_step(n, a, spec->depth, spec->amount, &value[n][0], &value[n][1]);
+                chorus_step(slot, n, a, spec->depth, spec->amount, &value[n][0], &value[n][1]);
             } else {
                 value[n][0] = a;
                 value[n][1] = a;
@@ -4630,14 +5426,14 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
         }
         case eNodeCompress:
         {
-            value[n][0] = (spec->active == true) ? compress_step(voice, n, a, spec) : a;
+            value[n][0] = (spec->active == true) ? compress_step(slot, voice, n, a, spec) : a;
             value[n][1] = value[n][0];
             break;
         }
         case eNodeDelay:
         {
             value[n][0] = (spec->active == true)
-                              ? delay_step(spec->line, a, spec->timeSeconds, spec->depth,
+                              ? delay_step(slot, spec->line, a, gSmoothedTime[slot][n], spec->depth,
                                            spec->damping, spec->hpCoeff, spec->amount) : a;
             value[n][1] = value[n][0];
             break;
@@ -4648,7 +5444,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
             double in = (a + signal_in(spec, value, 1)) * 0.5;
 
             if ((spec->active == true) && (spec->line == 0)) {
-                reverb_step(in, spec->timeSeconds, spec->timeNorm, spec->brightness,
+                reverb_step(slot, in, spec->timeSeconds, spec->timeNorm, spec->brightness,
                             spec->amount, spec->reverbType, &value[n][0], &value[n][1]);
             } else {
                 value[n][0] = in;
@@ -4664,7 +5460,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
         }
         case eNodeFxIn:
         {
-            value[n][0] = (spec->active == true) ? (a * gSmoothedGain[n]) : 0.0;
+            value[n][0] = (spec->active == true) ? (a * gSmoothedGain[slot][n]) : 0.0;
             value[n][1] = value[n][0];
             break;
         }
@@ -4702,8 +5498,8 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
                 if (haveRight == false) {
                     right = left;
                 }
-                value[n][0] = left * gSmoothedGain[n];
-                value[n][1] = right * gSmoothedGain[n];
+                value[n][0] = left * gSmoothedGain[slot][n];
+                value[n][1] = right * gSmoothedGain[slot][n];
             }
             break;
         }
@@ -4748,7 +5544,7 @@ static void eval_node(uint32_t voice, uint32_t n, const tSoundEngineParams * par
 // silent right channel, so anything that is not an Out module has its leg 0 mirrored, which is
 // exactly what the mono path did before stereo. An envelope used as an amp is the standing
 // exception: its SHAPED AUDIO is in leg 1 and is mono, so both channels take that.
-static void tap_pair(const tSoundEngineParams * paramsIn, int32_t node, double value[][2], double out[2]) {
+static void tap_pair(const tSoundEngineParams * paramsIn, int32_t node, g2_sample_t value[][2], g2_sample_t out[2]) {
     switch (paramsIn->node[node].kind) {
         case eNodeEnv:
         {
@@ -4778,13 +5574,13 @@ static void tap_pair(const tSoundEngineParams * paramsIn, int32_t node, double v
 // Asking the envelopes rather than watching the output level is deliberate: an envelope says when it
 // has finished, where a level has to be watched for long enough to be sure it is not just passing
 // through zero.
-static bool voice_is_finished(const tSoundEngineParams * paramsIn, uint32_t v, bool chainHasEnvelope) {
-    if (gVoice[v].gate == true) {
+static bool voice_is_finished(uint32_t slot, const tSoundEngineParams * paramsIn, uint32_t v, bool chainHasEnvelope) {
+    if (gVoice[slot][v].gate == true) {
         return false;
     }
 
     if (chainHasEnvelope == false) {
-        return gVoice[v].envelope <= 0.0;
+        return gVoice[slot][v].envelope <= 0.0;
     }
 
     for (uint32_t n = 0; n < paramsIn->nodeCount; n++) {
@@ -4794,7 +5590,7 @@ static bool voice_is_finished(const tSoundEngineParams * paramsIn, uint32_t v, b
             continue;
         }
 
-        if ((gEnvStage[v][n] != (uint32_t)eEnvIdle) || (fabs(gEnvLevel[v][n]) > 1.0e-5)) {
+        if ((gEnvStage[slot][v][n] != (uint32_t)eEnvIdle) || (fabs(gEnvLevel[slot][v][n]) > 1.0e-5)) {
             return false;
         }
     }
@@ -4802,401 +5598,1706 @@ static bool voice_is_finished(const tSoundEngineParams * paramsIn, uint32_t v, b
     return true;
 }
 
-void sound_engine_render(float * out, uint32_t frameCount, uint32_t channelCount) {
-    tSoundEngineParams params;
-    uint32_t           frame            = 0;
-    bool               chainHasEnvelope = false;
-    uint32_t           n                = 0;
+// One sample of parameter smoothing for the nodes on one side of the mix. Split by side because
+// the two sides can run on different threads (see FX PIPELINE), and each node's smoothing state
+// must only ever be touched by the thread that evaluates that node. Nothing on one side reads the
+// other's smoothed values, so doing the FX Area's after the voices changes no result.
+static void smooth_nodes(uint32_t slot, const tSoundEngineParams * params, double smoothCoeff, bool postMix) {
+    for (uint32_t n = 0; n < params->nodeCount; n++) {
+        const tEngineNode * spec   = &params->node[n];
+        bool                primed = gSmoothPrimed[slot][n];
 
-    struct timespec    started          = {0};
+        if (spec->postMix != postMix) {
+            continue;
+        }
 
-    (void)clock_gettime(CLOCK_MONOTONIC, &started);
+        gSmoothedShape[slot][n]  = smooth_to(&gSmoothShape[slot][n], spec->shape, smoothCoeff, primed);
+        // Smoothed in DIAL units, not hertz. Smoothing a logarithmic control linearly in
+        // frequency makes a knob move slowly at the bottom of its travel and leap at the
+        // top; smoothing the dial value sweeps evenly in pitch, which is what the dial
+        // means and what turning it sounds like.
+        gSmoothedCutoff[slot][n] = smooth_to(&gSmoothCutoff[slot][n], spec->cutoffParam, smoothCoeff, primed);
+        gSmoothedRes[slot][n]    = smooth_to(&gSmoothRes[slot][n], spec->resonance, smoothCoeff, primed);
+        gSmoothedGain[slot][n]   = smooth_to(&gSmoothGain[slot][n], spec->gain, smoothCoeff, primed);
 
-    if ((out == NULL) || (channelCount == 0)) {
-        return;
-    }
-    memset(out, 0, (size_t)frameCount * channelCount * sizeof(float));
+        // A delay's time: see delay_step() for why this one is not left stepped.
+        gSmoothedTime[slot][n]   = smooth_to(&gSmoothTime[slot][n], spec->timeSeconds, smoothCoeff, primed);
 
-    if (atomic_load(&gActive) == false) {
-        return;
+        for (uint32_t c = 0; c < MAX_NODE_INPUTS; c++) {
+            gSmoothedLevel[slot][n][c] = smooth_to(&gSmoothLevel[slot][n][c], spec->level[c], smoothCoeff, primed);
+        }
+
+        gSmoothPrimed[slot][n]   = true;
+    }
+}
+
+// ── PROFILER ────────────────────────────────────────────────────────────────────────────────────
+//
+// Where the time goes, node by node. gLoadPercent says HOW MUCH of the callback a patch uses; this
+// says WHICH MODULE is using it, which is the question anyone trying to make a patch cheaper actually
+// has. Off unless asked for — sound_engine_set_profiling(), or SNDPROF ON through the backdoor — and
+// when off, each evaluation site costs one test of a pointer that is NULL for the whole callback,
+// which the branch predictor gets right every time.
+//
+// Counted in the CPU's own cycle counter rather than clock_gettime(), which costs more than the
+// smaller nodes do and would swamp what it measured. The counter's rate is not known up front, so it
+// is calibrated against the monotonic clock over the whole profiling window when the table is read.
+// Reading the counter twice is not free either — some tens of cycles — so the smallest nodes read
+// high; the ranking is what to trust, not the last nanosecond.
+//
+// Two sets of accumulators, one per half of the graph, because with the FX pipeline on the two halves
+// run on different threads: gProfVoice belongs to the audio thread and gProfFx to whichever thread runs
+// the FX Area. Each is plain memory written only by its owner and moved into the shared atomic totals
+// once per callback or per pipeline block, never per sample.
+typedef struct {
+    uint64_t ticks;
+    uint64_t evals;       // one per node per voice per engine sample: a "voice-sample"
+} tProfileNode;
+
+static _Atomic bool     gProfileOn                                      = false;
+static tProfileNode     gProfVoice[MAX_SLOTS][MAX_ENGINE_NODES];
+static tProfileNode     gProfFx[MAX_SLOTS][MAX_ENGINE_NODES];
+static _Atomic uint64_t gProfTicks[MAX_SLOTS][MAX_ENGINE_NODES];
+static _Atomic uint64_t gProfEvals[MAX_SLOTS][MAX_ENGINE_NODES];
+static _Atomic uint64_t gProfCallbackNanos                              = 0;
+static _Atomic uint64_t gProfCallbackFrames                             = 0;
+static _Atomic uint32_t gProfCallbacks                                  = 0;
+static uint64_t         gProfStartTicks                                 = 0;   // UI thread: the calibration window
+static uint64_t         gProfStartNanos                                 = 0;
+
+static inline uint64_t profile_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks = 0;
+
+    __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (ticks));
+    return ticks;
+#else
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+#endif
+}
+
+static uint64_t profile_nanos(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+// Moves one half's counts into the shared totals and clears them. Called by the half's own thread.
+static void profile_publish(tProfileNode half[MAX_SLOTS][MAX_ENGINE_NODES]) {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        for (uint32_t n = 0; n < MAX_ENGINE_NODES; n++) {
+            if (half[slot][n].evals == 0) {
+                continue;
+            }
+            atomic_fetch_add_explicit(&gProfTicks[slot][n], half[slot][n].ticks, memory_order_relaxed);
+            atomic_fetch_add_explicit(&gProfEvals[slot][n], half[slot][n].evals, memory_order_relaxed);
+            half[slot][n].ticks = 0;
+            half[slot][n].evals = 0;
+        }
+    }
+}
+
+static void profile_reset(void) {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        for (uint32_t n = 0; n < MAX_ENGINE_NODES; n++) {
+            atomic_store(&gProfTicks[slot][n], 0);
+            atomic_store(&gProfEvals[slot][n], 0);
+        }
+    }
+    atomic_store(&gProfCallbackNanos, 0);
+    atomic_store(&gProfCallbackFrames, 0);
+    atomic_store(&gProfCallbacks, 0);
+    gProfStartTicks = profile_ticks();
+    gProfStartNanos = profile_nanos();
+}
+
+void sound_engine_set_profiling(bool on) {
+    if (on == true) {
+        profile_reset();
+    }
+    atomic_store(&gProfileOn, on);
+}
+
+bool sound_engine_profiling(void) {
+    return atomic_load(&gProfileOn);
+}
+
+// One node, timed. Inline so that the untimed path is the plain call and nothing else.
+static inline void eval_node_profiled(uint32_t slot, uint32_t v, uint32_t n, const tSoundEngineParams * params,
+                                      g2_sample_t value[][2], double voicePitch, bool gate, tProfileNode * profile) {
+    uint64_t begin = profile_ticks();
+
+    eval_node(slot, v, n, params, value, voicePitch, gate);
+    profile[n].ticks += profile_ticks() - begin;
+    profile[n].evals++;
+}
+
+typedef struct {
+    uint32_t node;
+    uint64_t ticks;
+    uint64_t evals;
+} tProfileRow;
+
+static int profile_row_compare(const void * a, const void * b) {
+    uint64_t x = ((const tProfileRow *)a)->ticks;
+    uint64_t y = ((const tProfileRow *)b)->ticks;
+
+    return (x < y) - (x > y);    // most expensive first
+}
+
+// The table, for the slot on screen, since profiling was switched on or the table was last read —
+// reading it starts a new window. UI thread only: it reads the UI's copy of the snapshot and the
+// module names out of the patch database.
+const char * sound_engine_profile_text(void) {
+    static char  text[4096];
+    // In tNodeKind order, as in sound_engine_debug_text().
+    const char * kindName[] = {
+        "Osc",    "OscShp",   "Filter", "LevAmp", "LevMult", "Mix",   "Env",
+        "Chorus", "Compress", "Delay",  "Reverb", "Lfo",     "Const", "FxIn","PassThru","Pulse", "Out"
+    };
+    const uint32_t kindCount                       = (uint32_t)(sizeof(kindName) / sizeof(kindName[0]));
+    tProfileRow    row[MAX_ENGINE_NODES];
+    uint64_t       kindTicks[sizeof(kindName) / sizeof(kindName[0])] = {0};
+    uint64_t       kindEvals[sizeof(kindName) / sizeof(kindName[0])] = {0};
+    const tSoundEngineParams * params              = playing_params(gSlot);
+    uint64_t       ticksNow                        = profile_ticks();
+    uint64_t       nanosNow                        = profile_nanos();
+    double         nsPerTick                       = 0.0;
+    double         callbackNs                      = (double)atomic_exchange(&gProfCallbackNanos, 0);
+    uint64_t       frames                          = atomic_exchange(&gProfCallbackFrames, 0);
+    uint32_t       callbacks                       = atomic_exchange(&gProfCallbacks, 0);
+    uint32_t       rows                            = 0;
+    size_t         used                            = 0;
+
+    if (atomic_load(&gProfileOn) == false) {
+        snprintf(text, sizeof(text), "profiling off (SNDPROF ON, or sound_engine_set_profiling)\n");
+        return text;
+    }
+
+    if (ticksNow > gProfStartTicks) {
+        nsPerTick = (double)(nanosNow - gProfStartNanos) / (double)(ticksNow - gProfStartTicks);
+    }
+    gProfStartTicks = ticksNow;
+    gProfStartNanos = nanosNow;
+
+    for (uint32_t n = 0; n < MAX_ENGINE_NODES; n++) {
+        uint64_t ticks = atomic_exchange(&gProfTicks[gSlot][n], 0);
+        uint64_t evals = atomic_exchange(&gProfEvals[gSlot][n], 0);
+
+        if ((n < params->nodeCount) && (evals > 0)) {
+            row[rows++] = (tProfileRow){n, ticks, evals};
+
+            if (params->node[n].kind < kindCount) {
+                kindTicks[params->node[n].kind] += ticks;
+                kindEvals[params->node[n].kind] += evals;
+            }
+        }
+    }
+    qsort(row, rows, sizeof(row[0]), profile_row_compare);
+
+    used += (size_t)snprintf(text + used, sizeof(text) - used,
+                             "profile: %u callbacks, %.2f ms spent on %.1f ms of audio (%.2f%%)%s\n"
+                             "%-16s %-8s %8s %14s %12s\n",
+                             (unsigned)callbacks, callbackNs / 1e6,
+                             (gDeviceRate > 0.0) ? (((double)frames / gDeviceRate) * 1e3) : 0.0,
+                             ((frames > 0) && (gDeviceRate > 0.0)) ? ((callbackNs / 1e9) / ((double)frames / gDeviceRate) * 100.0) : 0.0,
+                             (sound_engine_latency_frames() > 0) ? ", FX Area on the pipeline thread" : "",
+                             "module", "kind", "% cb", "ns/voice-smp", "evals");
+
+    for (uint32_t r = 0; (r < rows) && (used < sizeof(text)); r++) {
+        const tEngineNode * node   = &params->node[row[r].node];
+        tModule *           module = get_module_slot(gSlot, node->location, node->moduleIndex);
+        double              ns     = (double)row[r].ticks * nsPerTick;
+
+        used += (size_t)snprintf(text + used, sizeof(text) - used, "%-16.16s %-8s %7.2f%% %14.1f %12llu\n",
+                                 ((module != NULL) && (module->name[0] != '\0')) ? module->name : "?",
+                                 (node->kind < kindCount) ? kindName[node->kind] : "?",
+                                 (callbackNs > 0.0) ? ((ns / callbackNs) * 100.0) : 0.0,
+                                 ns / (double)row[r].evals, (unsigned long long)row[r].evals);
+    }
+
+    if (used < sizeof(text)) {
+        used += (size_t)snprintf(text + used, sizeof(text) - used, "by kind:\n");
+    }
+
+    for (uint32_t k = 0; (k < kindCount) && (used < sizeof(text)); k++) {
+        double ns = (double)kindTicks[k] * nsPerTick;
+
+        if (kindEvals[k] == 0) {
+            continue;
+        }
+        used += (size_t)snprintf(text + used, sizeof(text) - used, "%-16s %-8s %7.2f%% %14.1f %12llu\n",
+                                 "", kindName[k], (callbackNs > 0.0) ? ((ns / callbackNs) * 100.0) : 0.0,
+                                 ns / (double)kindEvals[k], (unsigned long long)kindEvals[k]);
+    }
+    return text;
+}
+
+// ── METERS ──────────────────────────────────────────────────────────────────────────────────────
+//
+// The LEDs and volume meters on the modules, when there is no G2 to report them. Online they come
+// from the device — parse_volume_indicator() and parse_led_data() in usbComms.c — and offline they
+// used to be dead, though every signal behind them is computed right here.
+//
+// Per sample, the only work is a running max-abs of each metered node's output: a few compares for
+// the handful of nodes that have a meter or an LED at all, listed in the snapshot so nothing else is
+// even looked at. About 30 times a second the peaks are turned into what the device would have sent
+// — the same 0..12 level codes with the clip bit, the same 2-bit LED values — and published, one
+// atomic word per module, keyed by slot, area and module index as the database is. The UI thread
+// copies them into the module structures the USB parsers fill (sound_engine_apply_meters()), so the
+// renderer draws them exactly as it draws the device's.
+//
+// Two accumulators, as the profiler has, for the same reason: with the FX pipeline on, the Voice
+// Area's nodes are seen by the audio thread and everything after the mix by the FX thread. Each
+// publishes its own half, and each published word carries the time it was written, so a module that
+// has left the graph goes dark on its own instead of being cleared by a thread that no longer owns it.
+//
+// An LED is lit while its node has any signal to speak of. That is right for the ones most patches
+// have — an envelope's gate, a Pulse's output, a send that is passing something — and an
+// approximation for the rest.
+#define METER_HZ               (30.0)
+#define METER_STALE_MS         (250U)     // older than this, a published word is dark
+#define METER_DB_PER_STEP      (3.0)      // twelve steps: 0 at -36 dB, 12 at full scale
+#define METER_CLIP_BIT         (0x40U)    // as render_volume_meter() reads it
+#define METER_LED_THRESHOLD    (0.01)     // -40 dB
+
+typedef struct {
+    float    peak[MAX_SLOTS][MAX_ENGINE_NODES][2];
+    uint32_t frames;
+} tMeterHalf;
+
+static tMeterHalf       gMeterVoice;
+static tMeterHalf       gMeterFx;
+// Bits 0..31 the four meter bytes, 32..47 eight 2-bit LED values, 48..63 the publish time in ms.
+static _Atomic uint64_t gMeterOut[MAX_SLOTS][locationVa + 1][MAX_NUM_MODULES];
+
+static uint32_t meter_now_ms(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000ULL) + ((uint64_t)now.tv_nsec / 1000000ULL));
+}
+
+// The per-sample half. `half` is 0 before the mix and 1 after it; value[] is whatever that half's
+// nodes hold at this sample.
+static inline void meter_accumulate(uint32_t slot, const tSoundEngineParams * params, uint32_t half,
+                                    g2_sample_t value[][2]) {
+    float(*peak)[2] = (half == 0) ? gMeterVoice.peak[slot] : gMeterFx.peak[slot];
+
+    for (uint32_t m = 0; m < params->meterCount[half]; m++) {
+        uint32_t n     = params->meterNode[half][m];
+        float    left  = fabsf((float)value[n][0]);
+        float    right = fabsf((float)value[n][1]);
+
+        peak[n][0] = (left > peak[n][0]) ? left : peak[n][0];
+        peak[n][1] = (right > peak[n][1]) ? right : peak[n][1];
+    }
+}
+
+// A peak as the device's level-bar code. The level falls by one step per publish rather than
+// dropping straight to the new peak, which is how the hardware's meters read — a bar that empties
+// between two 30 Hz frames flickers.
+static uint32_t meter_level_code(float peak, uint32_t previous) {
+    uint32_t level = 0;
+    uint32_t held  = previous & 0x0fU;
+
+    if (peak > 0.0f) {
+        double steps = ceil((20.0 * log10((double)peak) / METER_DB_PER_STEP) + 12.0);
+
+        level = (steps <= 0.0) ? 0U : ((steps >= 12.0) ? 12U : (uint32_t)steps);
+    }
+
+    if ((held > 0) && (level < (held - 1))) {
+        level = held - 1;
+    }
+    return level | ((peak >= 1.0f) ? METER_CLIP_BIT : 0U);
+}
+
+// The compressor's meter is gain reduction, drawn as a bar of LEDs, one bit each.
+static uint32_t meter_compress_code(uint32_t slot, uint32_t n, const tEngineNode * node) {
+    static const double step[] = {1.0, 2.0, 3.0, 4.5, 6.0, 9.0, 12.0, 18.0};
+    double              env    = gCompEnv[slot][0][n];
+    double              gr     = 0.0;
+    uint32_t            code   = 0;
+
+    if ((node->threshold > 0.0) && (env > node->threshold) && (node->ratio > 0.0)) {
+        gr = 20.0 * log10(env / node->threshold) * (1.0 - (1.0 / node->ratio));
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)(sizeof(step) / sizeof(step[0])); i++) {
+        if (gr >= step[i]) {
+            code |= 1U << i;
+        }
+    }
+    return code;
+}
+
+// The decimated half: once per block, on the thread that ran it, and only every 1/METER_HZ seconds
+// does it do anything.
+static void meter_publish(tMeterHalf * meters, uint32_t half, const tSoundEngineParams params[MAX_SLOTS],
+                          const bool live[MAX_SLOTS], uint32_t frames) {
+    uint64_t stamp = 0;
+
+    meters->frames += frames;
+
+    if ((gDeviceRate <= 0.0) || ((double)meters->frames < (gDeviceRate / METER_HZ))) {
+        return;
+    }
+    meters->frames = 0;
+    stamp          = (uint64_t)(meter_now_ms() & 0xffffU) << 48;
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if (live[slot] == false) {
+            continue;
+        }
+
+        for (uint32_t m = 0; m < params[slot].meterCount[half]; m++) {
+            uint32_t            n    = params[slot].meterNode[half][m];
+            const tEngineNode * node = &params[slot].node[n];
+
+            if (node->moduleIndex >= MAX_NUM_MODULES) {
+                continue;
+            }
+            float *             peak     = meters->peak[slot][n];
+            _Atomic uint64_t *  out      = &gMeterOut[slot][node->location][node->moduleIndex];
+            uint64_t            previous = atomic_load_explicit(out, memory_order_relaxed);
+            uint64_t            word     = 0;
+            float               both     = (peak[0] > peak[1]) ? peak[0] : peak[1];
+
+            switch (node->meter) {
+                case volumeTypeMono:
+                {
+                    word = meter_level_code(both, (uint32_t)previous);
+                    break;
+                }
+                case volumeTypeStereo:
+                case volumeTypeQuad:    // the engine carries one pair; the second stays dark
+                {
+                    word = meter_level_code(peak[0], (uint32_t)previous)
+                           | ((uint64_t)meter_level_code(peak[1], (uint32_t)(previous >> 8)) << 8);
+                    break;
+                }
+                case volumeTypeCompress:
+                {
+                    word = meter_compress_code(slot, n, node);
+                    break;
+                }
+                default:
+                {
+                    break;
+                }
+            }
+
+            if ((node->led == true) && (both > METER_LED_THRESHOLD)) {
+                word |= 1ULL << 32;    // green, as render_led_common() reads bit 0
+            }
+            atomic_store_explicit(out, word | stamp, memory_order_relaxed);
+            peak[0] = 0.0f;
+            peak[1] = 0.0f;
+        }
+    }
+}
+
+bool sound_engine_apply_meters(uint32_t slot) {
+    bool     active  = sound_engine_active();
+    uint32_t now     = meter_now_ms();
+    bool     changed = false;
+
+    if (slot >= MAX_SLOTS) {
+        return false;
+    }
+
+    for (uint32_t location = 0; location <= (uint32_t)locationVa; location++) {
+        for (uint32_t index = 0; index < MAX_NUM_MODULES; index++) {
+            tModule * module = get_module((tModuleKey){slot, location, index});
+            uint64_t  word   = atomic_load_explicit(&gMeterOut[slot][location][index], memory_order_relaxed);
+
+            if (module == NULL) {
+                continue;
+            }
+
+            if ((active == false) || (((now - (uint32_t)(word >> 48)) & 0xffffU) > METER_STALE_MS)) {
+                word = 0;
+            }
+
+            for (uint32_t i = 0; i < 4; i++) {
+                uint32_t value = (uint32_t)(word >> (i * 8)) & 0xffU;
+
+                changed                 |= (module->volume.value[i] != value);
+                module->volume.value[i]  = value;
+            }
+
+            if (module_led_count(module->type) > 0) {
+                uint32_t value = (uint32_t)(word >> 32) & 0x3U;
+
+                changed |= (atomic_load(&module->led.value[0]) != value);
+                atomic_store(&module->led.value[0], value);
+            }
+        }
+    }
+    return changed;
+}
+
+// ── ANALYSIS TAP ────────────────────────────────────────────────────────────────────────────────
+//
+// A copy of what the engine is playing, or of one module's output, for a scope or a spectrum to
+// read — see analysis.h for the consumer side. One ring, one writer, one reader: the writer is
+// whichever thread runs the output stage (the audio thread, or the FX pipeline's thread when that is
+// on), it never waits, and a reader that falls a whole ring behind loses the oldest frames rather
+// than holding anything up.
+//
+// The source is chosen by the UI and resolved to a node once per callback, on the audio thread, so
+// the render itself tests one index per sample. A module's output is taken as its sum over the
+// voices, as the meters take it, and averaged down from the engine rate to the device rate. With the
+// pipeline on, a tapped Voice Area module is added to what crosses to the FX thread, so it is seen
+// there like any other.
+//
+// Off, it costs that one test per slot per sample and nothing else.
+#define ANALYSIS_RING_FRAMES    (1U << 17)    // about 2.7 s at 48 kHz; a power of two
+#define ANALYSIS_GUARD_FRAMES   (64U)         // kept clear of the writer by a reader that has fallen behind
+
+typedef struct {
+    uint32_t kind;                 // tAnalysisTap
+    int32_t  node[MAX_SLOTS];      // the tapped node in each slot, -1 for none
+} tAnalysisRun;
+
+static _Atomic uint64_t gAnalysisSelect = 0;    // kind | slot << 8 | location << 16 | index << 24
+static float            gAnalysisRing[ANALYSIS_RING_FRAMES][2];
+static _Atomic uint64_t gAnalysisWrite  = 0;
+// Owned by the thread running the output stage.
+static tAnalysisRun     gAnalysisRun    = {0};
+static g2_sample_t      gAnalysisSum[2] = {0.0, 0.0};
+
+void sound_engine_set_analysis_tap(tAnalysisTap tap, uint32_t slot, uint32_t location, uint32_t moduleIndex) {
+    atomic_store(&gAnalysisSelect, (uint64_t)tap | ((uint64_t)(slot & 0xffU) << 8)
+                 | ((uint64_t)(location & 0xffU) << 16) | ((uint64_t)moduleIndex << 24));
+}
+
+// Audio thread, once per callback: the selection as this callback's snapshots see it.
+static void analysis_resolve(const tSoundEngineParams params[MAX_SLOTS], const bool live[MAX_SLOTS], tAnalysisRun * run) {
+    uint64_t select   = atomic_load_explicit(&gAnalysisSelect, memory_order_relaxed);
+    uint32_t slot     = (uint32_t)(select >> 8) & 0xffU;
+    uint32_t location = (uint32_t)(select >> 16) & 0xffU;
+    uint32_t index    = (uint32_t)(select >> 24);
+
+    run->kind = (uint32_t)(select & 0xffU);
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        run->node[s] = -1;
+    }
+
+    if ((run->kind != eAnalysisTapModule) || (slot >= MAX_SLOTS) || (live[slot] == false)) {
+        return;
+    }
+
+    for (uint32_t n = 0; n < params[slot].nodeCount; n++) {
+        if ((params[slot].node[n].location == location) && (params[slot].node[n].moduleIndex == index)) {
+            run->node[slot] = (int32_t)n;
+            return;
+        }
+    }
+}
+
+// Per engine sample, from render_slot_fx().
+static inline void analysis_accumulate(uint32_t slot, g2_sample_t value[][2]) {
+    int32_t n = gAnalysisRun.node[slot];
+
+    if (n >= 0) {
+        gAnalysisSum[0] += value[n][0];
+        gAnalysisSum[1] += value[n][1];
+    }
+}
+
+// Per device frame, after the output stage.
+static inline void analysis_push(const g2_sample_t outSample[4]) {
+    uint64_t write = 0;
+    float *  frame = NULL;
+
+    if (gAnalysisRun.kind == eAnalysisTapOff) {
+        return;
+    }
+    write = atomic_load_explicit(&gAnalysisWrite, memory_order_relaxed);
+    frame = gAnalysisRing[write & (ANALYSIS_RING_FRAMES - 1)];
+
+    if (gAnalysisRun.kind == eAnalysisTapOutput) {
+        frame[0] = (float)outSample[0];
+        frame[1] = (float)outSample[1];
+    } else {
+        frame[0]        = (float)(gAnalysisSum[0] / (double)ENGINE_OVERSAMPLE);
+        frame[1]        = (float)(gAnalysisSum[1] / (double)ENGINE_OVERSAMPLE);
+        gAnalysisSum[0] = 0.0;
+        gAnalysisSum[1] = 0.0;
+    }
+    atomic_store_explicit(&gAnalysisWrite, write + 1, memory_order_release);
+}
+
+uint64_t sound_engine_analysis_position(void) {
+    return atomic_load_explicit(&gAnalysisWrite, memory_order_acquire);
+}
+
+double sound_engine_analysis_rate(void) {
+    return gDeviceRate;
+}
+
+uint32_t sound_engine_analysis_read(uint64_t * cursor, float * frames, uint32_t maxFrames) {
+    uint64_t write  = atomic_load_explicit(&gAnalysisWrite, memory_order_acquire);
+    uint64_t oldest = (write > (ANALYSIS_RING_FRAMES - ANALYSIS_GUARD_FRAMES))
+                      ? (write - (ANALYSIS_RING_FRAMES - ANALYSIS_GUARD_FRAMES)) : 0;
+    uint32_t count  = 0;
+
+    if (*cursor < oldest) {
+        *cursor = oldest;    // lapped: what was there has been overwritten
+    }
+
+    if (*cursor > write) {
+        *cursor = write;     // a cursor from before a restart of the count
+    }
+    count = ((write - *cursor) < maxFrames) ? (uint32_t)(write - *cursor) : maxFrames;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const float * frame = gAnalysisRing[(*cursor + i) & (ANALYSIS_RING_FRAMES - 1)];
+
+        frames[(i * 2) + 0] = frame[0];
+        frames[(i * 2) + 1] = frame[1];
+    }
+
+    // The writer may have come round onto the start of the copy while it was being made. If so the
+    // copy is not trusted at all: the cursor moves past the damage and the caller reads again.
+    atomic_thread_fence(memory_order_acquire);
+    write  = atomic_load_explicit(&gAnalysisWrite, memory_order_relaxed);
+    oldest = (write > (ANALYSIS_RING_FRAMES - ANALYSIS_GUARD_FRAMES))
+             ? (write - (ANALYSIS_RING_FRAMES - ANALYSIS_GUARD_FRAMES)) : 0;
+
+    if (*cursor < oldest) {
+        *cursor = oldest;
+        return 0;
+    }
+    *cursor += count;
+
+    return count;
+}
+
+// ONE SLOT, ONE OVERSAMPLED SAMPLE, VOICE AREA HALF: vibrato, smoothing and every sounding voice,
+// leaving the SUM of the voices in voiceSum for render_slot_fx(). The voices are all the audio
+// thread ever renders when the FX pipeline is on; with it off the two halves run back to back.
+static void render_slot_voices(uint32_t slot, const tSoundEngineParams * params, bool chainHasEnvelope,
+                               double envelopeStep, double smoothCoeff, g2_sample_t voiceSum[][2],
+                               tProfileNode * profile) {
+    g2_sample_t value[MAX_ENGINE_NODES][2];
+    uint32_t n = 0;
+
+    // The patch's own Vibrato, which is nothing to do with the cabling: it lives on a hidden
+    // module beside Glide and Bend, and is how a patch gets aftertouch vibrato without an LFO
+    // anywhere in it. The chosen controller sets the depth, so at rest there is none.
+    //
+    // ONE PHASE FOR THE WHOLE PATCH, not one per voice: it is a property of the patch rather
+    // than of a note, so a chord's notes wobble together instead of drifting apart.
+    double vibrato      = 0.0;
+
+    if (params->vibratoSource != eVibratoOff) {
+        uint32_t group = (params->vibratoSource == eVibratoWheel)
+                     ? MORPH_GROUP_WHEEL : MORPH_GROUP_AFTERTOUCH;
+        double   depth = (double)atomic_load(&gMorphMilli[group]) / 1000.0;
+
+        gVibratoPhase[slot] += params->vibratoHz / gSampleRate;
+
+        if (gVibratoPhase[slot] >= 1.0) {
+            gVibratoPhase[slot] -= 1.0;
+        }
+        vibrato        = (sin(gVibratoPhase[slot] * 2.0 * M_PI) * depth * params->vibratoCents) / 100.0;
+    }
+    double bend         = ((double)atomic_load(&gBendMilli) / 1000.0) * params->bendSemitones;
+    // Depends on the patch and the rate, not on the voice, so it is worked out once here
+    // rather than once per voice — an exp() per voice per sample is not free at eight of them.
+    double glideCoeff   = (params->glideSeconds > 0.0)
+                          ? (1.0 - exp(-4.6 / (params->glideSeconds * gSampleRate))) : 1.0;
+
+    // PARAMETER SMOOTHING IS PER SAMPLE, NOT PER VOICE. It tracks where a knob is, which is
+    // one thing however many notes are sounding — and running it inside the voice loop would
+    // advance it once per voice, so a knob would sweep faster the more keys were held.
+    smooth_nodes(slot, params, smoothCoeff, false);
+
+    memset(voiceSum, 0, sizeof(g2_sample_t) * 2 * MAX_ENGINE_NODES);
+
+    // ── VOICE AREA: the whole area, once per sounding voice ──────────────────────────
+    //
+    // Each voice is a complete instance of the Voice Area with its own oscillator phases,
+    // filter state and envelopes, exactly as the hardware instantiates it. The FX Area is
+    // NOT in here: it is one shared instance fed by the sum of the voices, which is what
+    // lets a chord share one reverb instead of running 8 of them.
+    for (uint32_t v = 0; v < params->voiceCount; v++) {
+        tVoice * voice      = &gVoice[slot][v];
+
+        if (voice->sounding == false) {
+            continue;               // costs nothing when it is not playing
+        }
+
+        // Portamento. The sounding pitch chases the played note; how fast, and whether at
+        // all, comes from the patch's Glide setting. Exponential rather than linear — it is
+        // what a glide sounds like, and the coefficient is set so the remaining distance is
+        // down to a percent by the time the dial says.
+        if (voice->note >= 0) {
+            bool sliding = (params->glideMode == eGlideNormal)
+                           || ((params->glideMode == eGlideAuto) && (voice->glideActive == true));
+
+            if ((sliding == true) && (params->glideSeconds > 0.0)) {
+                voice->glidePitch += glideCoeff * ((double)voice->note - voice->glidePitch);
+            } else {
+                voice->glidePitch = (double)voice->note;
+            }
+        }
+        double   voicePitch = voice->glidePitch + bend + vibrato;
+
+        // The anti-click ramp, per voice. Only used when the patch has no EnvADSR to shape
+        // the note itself — with one, this would just double up on it.
+        double   rampTarget = (voice->gate == true) ? 1.0 : 0.0;
+
+        if (voice->envelope < rampTarget) {
+            voice->envelope += envelopeStep;
+
+            if (voice->envelope > rampTarget) {
+                voice->envelope = rampTarget;
+            }
+        } else if (voice->envelope > rampTarget) {
+            voice->envelope -= envelopeStep;
+
+            if (voice->envelope < rampTarget) {
+                voice->envelope = rampTarget;
+            }
+        }
+        voice->released = (voice->gate == true) ? 0 : (voice->released + 1);
+
+        // Past the limit, wind the voice down rather than cutting it. voice->fade reaching
+        // zero is what retires it below.
+        if (  (voice->gate == false)
+           && (voice->released > (uint32_t)(VOICE_MAX_TAIL_SECONDS * gSampleRate))) {
+            voice->fade -= 1.0 / (VOICE_FADE_SECONDS * gSampleRate);
+
+            if (voice->fade < 0.0) {
+                voice->fade = 0.0;
+            }
+        }
+        double level   = ((chainHasEnvelope == true) ? 1.0 : voice->envelope) * voice->fade;
+
+        for (n = 0; n < params->nodeCount; n++) {
+            if (params->node[n].postMix == true) {
+                continue;
+            }
+            if (profile == NULL) {
+                eval_node(slot, v, n, params, value, voicePitch, voice->gate);
+            } else {
+                eval_node_profiled(slot, v, n, params, value, voicePitch, voice->gate, profile);
+            }
+        }
+
+        // The voices SUM, which is what playing more than one note at once means. Only the
+        // per-voice nodes are summed here — everything inside the voice was read from
+        // value[] during its own pass, before the next voice overwrites it.
+        double leaving = 0.0;
+
+        for (n = 0; n < params->nodeCount; n++) {
+            if (params->node[n].postMix == true) {
+                continue;
+            }
+            voiceSum[n][0] += value[n][0] * level;
+            voiceSum[n][1] += value[n][1] * level;
+
+            // What this voice is putting out, measured at its Out modules — the point where
+            // it leaves the voice for the mix or for the FX Area.
+            if (params->node[n].kind == eNodeOut) {
+                double magnitude = fabs(value[n][0] * level);
+
+                if (magnitude > leaving) {
+                    leaving = magnitude;
+                }
+            }
+        }
+
+        voice->quiet = (leaving < VOICE_SILENCE) ? (voice->quiet + 1) : 0;
+
+        // RETIRED ONLY WHEN IT HAS GONE QUIET AS WELL as finishing its envelope. The
+        // envelope alone is not enough: a patch whose EnvADSR modulates the filter rather
+        // than acting as the amp goes on sounding after that envelope is idle, and dropping
+        // it from the render at that moment cuts it off mid-note with a click. A patch that
+        // genuinely drones simply never frees the voice, so new notes take the others and
+        // eventually steal — which is what the instrument does with a droning patch too.
+        if (  (  (voice_is_finished(slot, params, v, chainHasEnvelope) == true)
+              && (voice->quiet > (uint32_t)(VOICE_SILENCE_SECONDS * gSampleRate)))
+           || (voice->fade <= 0.0)) {
+            voice->sounding = false;
+            voice->quiet    = 0;
+            voice->released = 0;
+            voice->fade     = 1.0;
+        }
+    }
+
+    meter_accumulate(slot, params, 0, voiceSum);
+}
+
+// ONE SLOT, ONE OVERSAMPLED SAMPLE, FX AREA HALF: everything after the mix, once however many voices
+// are sounding, with the slot's Out modules added into `sample` at the slot's level. `gate` is voice
+// 0's key, which is what an envelope after the mix is triggered by.
+static void render_slot_fx(uint32_t slot, const tSoundEngineParams * params, double smoothCoeff,
+                           g2_sample_t voiceSum[][2], bool gate, g2_sample_t sample[2][2], tProfileNode * profile) {
+    g2_sample_t value[MAX_ENGINE_NODES][2];
+    uint32_t n = 0;
+
+    smooth_nodes(slot, params, smoothCoeff, true);
+
+    // What everything after the mix sees of the voices is their SUM.
+    for (n = 0; n < params->nodeCount; n++) {
+        if (params->node[n].postMix == false) {
+            value[n][0] = voiceSum[n][0];
+            value[n][1] = voiceSum[n][1];
+        }
+    }
+
+    // ── AFTER THE MIX: one shared instance, whatever the polyphony ───────────────────────
+    //
+    // The FX Area, plus any delay, chorus or reverb sitting in the Voice Area and anything
+    // downstream of one — see mark_post_mix_nodes(). Runs even with every voice silent, so a
+    // reverb tail or a delay repeat carries on after the last note is released rather than
+    // being cut off with it.
+    for (n = 0; n < params->nodeCount; n++) {
+        if (params->node[n].postMix == false) {
+            continue;
+        }
+        if (profile == NULL) {
+            eval_node(slot, 0, n, params, value, 0.0, gate);
+        } else {
+            eval_node_profiled(slot, 0, n, params, value, 0.0, gate, profile);
+        }
+    }
+    meter_accumulate(slot, params, 1, value);
+    analysis_accumulate(slot, value);
+
+    if (params->tap >= 0) {
+        // Tapping a module means listening to its main output; for an envelope used as an amp
+        // that is its shaped audio rather than the envelope signal. See tap_pair().
+        {
+            g2_sample_t first[2] = {0.0, 0.0};
+            uint32_t d        = params->node[params->tap].outDest & 1U;
+
+            tap_pair(params, params->tap, value, first);
+            sample[d][0] += first[0] * params->slotGain;
+            sample[d][1] += first[1] * params->slotGain;
+        }
+
+        // The patch's other Out modules, summed rather than mixed at some fraction: that is
+        // what the hardware's sockets do when two areas both drive them. Summed per channel
+        // AND PER PAIR, so a patch whose Out modules feed different physical pairs — which
+        // is what every measurement patch does — keeps them apart instead of folding them
+        // into one stereo image.
+        for (uint32_t t = 0; t < params->extraTapCount; t++) {
+            g2_sample_t extra[2] = {0.0, 0.0};
+            uint32_t d        = params->node[params->extraTap[t]].outDest & 1U;
+
+            tap_pair(params, params->extraTap[t], value, extra);
+            sample[d][0] += extra[0] * params->slotGain;
+            sample[d][1] += extra[1] * params->slotGain;
+        }
+    }
+}
+
+// The instrument's output stage, one oversampled sample of it: the meters, the gain and the knee
+// on the sum of every slot, fed into the decimator's history. Runs on whichever thread runs the FX
+// Area — the audio thread normally, the pipeline thread when that is on — and only ever that one.
+static void output_stage_sample(g2_sample_t sample[2][2]) {
+    // THE METERS READ THE LOUDER CHANNEL. A per-channel peak would need a per-channel meter
+    // to show it, and what these drive is one number.
+    {
+        uint32_t rawMilli = (uint32_t)(fmax(fmax(fabs(sample[0][0]), fabs(sample[0][1])),
+                                            fmax(fabs(sample[1][0]), fabs(sample[1][1]))) * 1000.0);
+
+        if (rawMilli > atomic_load(&gRawPeakMilli)) {
+            atomic_store(&gRawPeakMilli, rawMilli);
+        }
+    }
+
+    // The gain, the knee and the clamp are all PER CHANNEL. The knee especially: shaping the
+    // two channels together off a common peak would make one duck when the other got loud,
+    // which is a stereo image moving under a limiter rather than an output stage.
+    for (uint32_t q = 0; q < 4; q++) {
+        g2_sample_t * sp = &sample[q >> 1][q & 1];
+
+        *sp                           *= VOICE_GAIN;
+        // The anti-click ramp is applied PER VOICE as each voice's output leaves the Voice Area
+        // (see the voice loop), not here. Applying it to the mixed output would fade the whole
+        // instrument — including the FX tail — every time any one note was released.
+        // The user's own attenuation, ahead of the knee.
+        *sp                           *= (double)atomic_load(&gOutputGainMilli) / 1000.0;
+
+        // Soft knee rather than a hard edge. Below the knee nothing is touched at all, so ordinary
+        // playing is untouched; above it the curve bends over instead of shearing the tops off, which
+        // is both kinder to listen to and closer to what an overloaded analogue output does. The hard
+        // clamp afterwards is only a guard against a bug producing something enormous.
+        if (*sp > OUTPUT_KNEE) {
+            *sp = OUTPUT_KNEE + ((1.0 - OUTPUT_KNEE) * tanh((*sp - OUTPUT_KNEE) / (1.0 - OUTPUT_KNEE)));
+        } else if (*sp < -OUTPUT_KNEE) {
+            *sp = -OUTPUT_KNEE - ((1.0 - OUTPUT_KNEE) * tanh((-*sp - OUTPUT_KNEE) / (1.0 - OUTPUT_KNEE)));
+        }
+
+        if (*sp > 1.0) {
+            *sp = 1.0;
+        } else if (*sp < -1.0) {
+            *sp = -1.0;
+        }
+        // Every internal sample goes through the decimator; only the last of each group produces
+        // an output. Feeding all of them is the point — dropping the others without filtering is
+        // exactly what would fold the high end back down.
+        gOutHistory[q][gOutHistoryPos] = *sp;
+    }
+
+    // ONE position for both lines: they are written in lockstep, so one cursor serves.
+    gOutHistoryPos = (gOutHistoryPos + 1) % OUT_DECIMATE_TAPS;
+}
+
+// The decimator's output for the frame just completed, all four channels, and the output meter
+// with it. Same thread rule as output_stage_sample().
+static void output_stage_frame(g2_sample_t outSample[4]) {
+    uint32_t tap    = 0;
+    double   milli  = 0.0;
+    // Walked rather than recomputed, as in the oscillator decimator above and for the same
+    // reason — the same taps in the same order, without a division per tap. All four
+    // channels share the walk and the coefficient lookup; only the history line differs.
+    uint32_t oldest = gOutHistoryPos;
+
+    for (tap = 0; tap < OUT_DECIMATE_TAPS; tap++) {
+        g2_sample_t coeff = gOutDecimate[OUT_DECIMATE_TAPS - 1 - tap];
+
+        outSample[0] += gOutHistory[0][oldest] * coeff;
+        outSample[1] += gOutHistory[1][oldest] * coeff;
+        outSample[2] += gOutHistory[2][oldest] * coeff;
+        outSample[3] += gOutHistory[3][oldest] * coeff;
+        oldest++;
+
+        if (oldest >= OUT_DECIMATE_TAPS) {
+            oldest = 0;
+        }
+    }
+
+    milli = fmax(fmax(fabs(outSample[0]), fabs(outSample[1])),
+                 fmax(fabs(outSample[2]), fabs(outSample[3]))) * 1000.0;
+
+    if ((uint32_t)milli > atomic_load(&gPeakMilli)) {
+        atomic_store(&gPeakMilli, (uint32_t)milli);
+    }
+}
+
+// One frame of the caller's buffer, from the four output channels.
+//
+// FOUR CHANNELS IF THE CALLER ASKED FOR THEM, otherwise the two pairs are SUMMED.
+//
+// The summing is what keeps the application unchanged: its device is stereo, every Out
+// module used to be added together whatever pair it fed, and a patch sending anything to
+// Out 3/4 would fall silent if this suddenly routed by destination. A caller that wants
+// them apart — the measurement harness, which needs the rig's dry reference on one pair
+// and its processed signal on the other — asks for four and gets them.
+//
+// Choosing WHICH pair a stereo device should monitor, rather than always summing, wants
+// a menu item; see the todo. Summing is the answer that changes nothing until then.
+//
+// THE TARGET IS EITHER LAYOUT. A device callback hands over one interleaved buffer; a plug-in host
+// hands over one buffer per channel, and rendering interleaved for it meant a scratch block and a
+// second pass to pull the channels apart. A planar target takes each frame straight to the host's
+// buffers. The rule for which channel gets what is the same either way, and a NULL channel — an aux
+// bus the host has switched off — is skipped rather than written.
+typedef struct {
+    float *         interleaved;    // channelCount floats per frame, or NULL for planar
+    float * const * planar;         // channelCount buffers, one per channel
+    uint32_t        channelCount;
+} tOutputTarget;
+
+static void write_output_frame(const tOutputTarget * target, uint32_t frame, const g2_sample_t outSample[4]) {
+    const uint32_t channelCount = target->channelCount;
+
+    for (uint32_t channel = 0; channel < channelCount; channel++) {
+        g2_sample_t v = (channelCount >= 4)
+                        ? outSample[channel & 3U]
+                        : (outSample[channel & 1U] + outSample[2U + (channel & 1U)]);
+
+        if (target->interleaved != NULL) {
+            target->interleaved[(frame * channelCount) + channel] = (float)v;
+        } else if (target->planar[channel] != NULL) {
+            target->planar[channel][frame] = (float)v;
+        }
+    }
+}
+
+static void clear_output(const tOutputTarget * target, uint32_t frameCount) {
+    if (target->interleaved != NULL) {
+        memset(target->interleaved, 0, (size_t)frameCount * target->channelCount * sizeof(float));
+        return;
+    }
+
+    for (uint32_t channel = 0; channel < target->channelCount; channel++) {
+        if (target->planar[channel] != NULL) {
+            memset(target->planar[channel], 0, (size_t)frameCount * sizeof(float));
+        }
+    }
+}
+
+// ── FX PIPELINE ─────────────────────────────────────────────────────────────────────────────────
+//
+// OPTIONAL AND OFF BY DEFAULT, because it is a trade rather than a free win: the FX Area of every slot
+// moves to a thread of its own and runs behind the voices. The audio callback renders this block's
+// voices, hands their mix over, and plays FX output the other thread finished while the callback was
+// waiting for its turn. A reverb-heavy patch spends much of its time after the mix — a reverb and two
+// delays are a fixed serial cost whatever the polyphony — and this lets that cost overlap the voices
+// on a second core instead of following them on the first.
+//
+// THE PRICE IS EXACTLY gFxLatency FRAMES, fixed when the pipeline is switched on and reported through
+// sound_engine_latency_frames() so a host can compensate. It is a frame count rather than "one block"
+// because hosts do not promise equal blocks: finished output sits in a FIFO primed with that much
+// silence, so a short block followed by a long one still plays every sample exactly gFxLatency frames
+// after its voices were rendered. The caller passes its largest block, which is the least that lets
+// the previous block's FX finish while the current block's voices render.
+//
+// WHAT CROSSES is only what the FX Area reads of the voices: per oversampled sample, the voice-side
+// nodes that feed a post-mix node or are tapped as an Out, plus voice 0's key for an envelope after
+// the mix. Two or three values for an ordinary patch, not the node array. Everything else belongs to
+// exactly one side while the pipeline runs — the delay lines, reverb, post-mix smoothing and the
+// output stage to the pipeline thread, the voices and their smoothing to the audio thread — which is
+// what smooth_nodes() being split by side and eval_node() taking `gate` are for.
+//
+// A TOPOLOGY CHANGE is the one moment both sides want the same state, since reset_node_state() clears
+// all of it. The callback waits for the pipeline to empty first; that is at most one block's FX time,
+// on an edit that is wiping the delay lines anyway.
+//
+// FALLING BEHIND IS AN UNDERRUN, counted rather than hidden. A block that cannot be handed over in time
+// is played as silence, and output that has not arrived by the deadline is silence too — with those
+// frames discarded when they do arrive, so the delay stays what the host was told.
+//
+// THE WAIT IS SHORT. The audio thread spins on the other one at most FX_PIPE_WAIT_SHARE of a period,
+// and no more than FX_PIPE_WAIT_MAX_NS, summed over every wait in the callback — not the whole
+// period, which left nothing for the rest of the callback and made the next one late as well. The
+// FX Area cannot be run on the audio thread in the meantime, since its state is the pipeline thread's
+// while that thread is up, so past the bound the answer is silence, and gFxWaitsCut counts it.
+#define FX_PIPE_BLOCKS          (8)          // in flight between the threads; a power of two
+#define FX_PIPE_CHUNK_FRAMES    (256)        // the most frames one block carries
+#define FX_PIPE_MIX_VALUES      (16384)      // per block; a big patch gets shorter blocks, not a bigger ring
+#define FX_PIPE_OUT_FRAMES      (16384)      // finished output; a power of two, well past latency + blocks
+#define FX_PIPE_MAX_LATENCY     (4096)
+#define FX_PIPE_WAKE_NS         (1000000)    // the longest the pipeline thread sleeps with nothing to do
+#define FX_PIPE_WAIT_SHARE      (8)          // the audio thread waits at most 1/8 of a period in all...
+#define FX_PIPE_WAIT_MAX_NS     (250000)     // ...and never more than this, however long the period
+
+// The audio thread's waits on the pipeline thread in one callback, and how long they may take between
+// them. The clock starts at the first wait, not at the callback, so time spent rendering voices is
+// not taken out of it.
+typedef struct {
+    uint64_t           limitNs;
+    struct timespec    until;
+    bool               started;
+    bool               over;
+} tFxWait;
+
+typedef struct {
+    uint32_t           frames;
+    uint32_t           silence;                              // dropped frames, played as silence first
+    bool               profile;                              // the profiler was on when it was rendered
+    tAnalysisRun       analysis;                             // the analysis tap, as the audio thread resolved it
+    double             smoothCoeff[MAX_SLOTS];               // each slot's parameter smoothing, crossfade and all
+    bool               live[MAX_SLOTS];
+    uint32_t           crossingCount[MAX_SLOTS];
+    uint8_t            crossing[MAX_SLOTS][MAX_ENGINE_NODES];
+    tSoundEngineParams params[MAX_SLOTS];                    // the snapshot the voices were rendered with
+    g2_sample_t        mix[FX_PIPE_MIX_VALUES];
+} tFxBlock;
+
+// Set only while the engine is stopped — see sound_engine_set_fx_pipeline().
+static bool             gFxEnabled  = false;
+static uint32_t         gFxLatency  = 0;
+static bool             gFxThreadUp = false;    // false with the pipeline on: it runs on the audio thread
+static pthread_t        gFxThread;
+static _Atomic bool     gFxRun      = false;
+static pthread_mutex_t  gFxWakeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   gFxWake      = PTHREAD_COND_INITIALIZER;
+
+// Single producer, single consumer, both ways. Blocks: the audio thread writes gFxHead and the
+// pipeline thread gFxTail. Output: the pipeline thread writes gFxOutWrite and the audio thread
+// gFxOutRead. Each index only ever grows; the masks do the wrapping.
+static tFxBlock         gFxBlock[FX_PIPE_BLOCKS];
+static _Atomic uint32_t gFxHead     = 0;
+static _Atomic uint32_t gFxTail     = 0;
+static g2_sample_t      gFxOut[FX_PIPE_OUT_FRAMES][4];
+static _Atomic uint32_t gFxOutWrite = 0;
+static _Atomic uint32_t gFxOutRead  = 0;
+
+// Audio thread only: frames dropped and not yet handed over as silence, and frames played as
+// silence whose real output is still to come and must be thrown away.
+static uint32_t         gFxDropped  = 0;
+static uint32_t         gFxOwed     = 0;
+static _Atomic uint32_t gFxUnderruns = 0;
+static _Atomic uint32_t gFxWaitsCut  = 0;
+
+// True once this callback has waited as long as it may. The first call starts the clock; the first
+// that finds it run out counts the callback in gFxWaitsCut, once however many waits follow.
+static bool fx_wait_over(tFxWait * wait) {
+    struct timespec now = {0};
+
+    if (wait->over == true) {
+        return true;
     }
-    params = read_params();
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
 
-    if (params.topology != gSeenTopology) {
-        // WORTH LOGGING, because reset_node_state() below empties every delay line and reverb buffer
-        // in the engine. A topology change that is real — a module added, a cable moved — has to do
-        // that. One that is NOT real takes the delay repeats and the reverb tail with it, and what
-        // is heard is the effect stopping dead and then filling up again from nothing.
-        //
-        // So if a delay or reverb is ever reported cutting out at random, this line is the first
-        // thing to look for: if it fires when nothing about the patch changed, the signature is
-        // unstable and the wipe is the symptom rather than the cause. Debug builds only.
-        //
-        // Not the explanation for every such report: 45 s of idle playing, 120 parameter edits and
-        // repeated select/deselect cycles all produced ZERO changes here, so whatever else may cut a
-        // delay short, it is not this under those conditions.
-        LOG_DEBUG("TOPOLOGY CHANGE %llu -> %llu, nodes %u, tap %d — delay and reverb buffers cleared\n",
-                  (unsigned long long)gSeenTopology, (unsigned long long)params.topology,
-                  (unsigned)params.nodeCount, params.tap);
-        gSeenTopology = params.topology;
-        reset_node_state();
-    }
-    // Oscillator phases are deliberately NOT reset when a note starts. They free-run, as the G2's do
-    // unless something is patched to their Sync input, and that matters more than it sounds: several
-    // oscillators detuned by a few cents are what makes a patch thick, and starting them all at
-    // phase zero has them summing as one voice for the seconds a 7 cent difference takes to drift
-    // apart. Note events themselves are taken inside the sample loop below.
-
-    if (params.tap < 0) {
-        return;
+    if (wait->started == false) {
+        uint64_t nanos = (uint64_t)now.tv_nsec + wait->limitNs;
+
+        wait->until.tv_sec  = now.tv_sec + (time_t)(nanos / 1000000000ULL);
+        wait->until.tv_nsec = (long)(nanos % 1000000000ULL);
+        wait->started       = true;
+        return false;
     }
 
-    // A snapshot that has never been published carries a voice count of zero, and zero voices render
-    // silence — which would look exactly like the engine being broken. One voice is the safe reading
-    // of "not told yet", and it is what the engine did before it could count.
-    if (params.voiceCount < 1) {
-        params.voiceCount = 1;
-    } else if (params.voiceCount > MAX_VOICES) {
-        params.voiceCount = MAX_VOICES;
+    if ((now.tv_sec > wait->until.tv_sec)
+        || ((now.tv_sec == wait->until.tv_sec) && (now.tv_nsec >= wait->until.tv_nsec))) {
+        wait->over = true;
+        atomic_fetch_add(&gFxWaitsCut, 1);
     }
 
-    // A PER-VOICE EnvADSR is the note's shape; the fixed ramp is only there to stop a click when
-    // there is none to do that job. Per-voice only, and it has to be: an envelope after the mix
-    // shapes the effect rather than the note, and counting it here would leave every voice unramped
-    // AND have voice_is_finished() retire voices the moment a key came up.
-    for (n = 0; n < params.nodeCount; n++) {
-        if ((params.node[n].kind == eNodeEnv) && (params.node[n].postMix == false)) {
-            chainHasEnvelope = true;
-            break;
+    return wait->over;
+}
+
+// The voice-side nodes the FX Area of one slot reads: every input of a post-mix node that comes from
+// the voice side, the tapped Out modules that sit there, and the analysis tap's module if it is one
+// of them. Nothing else of value[] is looked at after the mix, so nothing else has to cross.
+static uint32_t fx_crossing_nodes(const tSoundEngineParams * params, int32_t analysisNode,
+                                  uint8_t crossing[MAX_ENGINE_NODES]) {
+    bool     wanted[MAX_ENGINE_NODES] = {false};
+    uint32_t count                    = 0;
+
+    for (uint32_t n = 0; n < params->nodeCount; n++) {
+        if (params->node[n].postMix == false) {
+            continue;
+        }
+
+        for (uint32_t c = 0; c < params->node[n].inCount; c++) {
+            int32_t source = params->node[n].in[c];
+
+            if ((source >= 0) && (params->node[source].postMix == false)) {
+                wanted[source] = true;
+            }
         }
     }
 
-    for (frame = 0; frame < frameCount; frame++) {
-        uint32_t sub = 0;
+    if ((params->tap >= 0) && (params->node[params->tap].postMix == false)) {
+        wanted[params->tap] = true;
+    }
 
-        // ENGINE_OVERSAMPLE passes of the whole graph per output sample. Note events are consumed
-        // inside, so they land on the finer grid too rather than being quantised to the output rate.
-        for (sub = 0; sub < ENGINE_OVERSAMPLE; sub++) {
-            double value[MAX_ENGINE_NODES][2];
-            double voiceSum[MAX_ENGINE_NODES][2];
+    for (uint32_t t = 0; t < params->extraTapCount; t++) {
+        if (params->node[params->extraTap[t]].postMix == false) {
+            wanted[params->extraTap[t]] = true;
+        }
+    }
 
-            // One event per sample. A chord's worth of note-ons arriving together therefore lands over
-            // consecutive samples rather than all but the last being thrown away, and every note takes
-            // effect where it actually arrived instead of at the next buffer boundary.
-            (void)take_next_note_event();
+    if ((analysisNode >= 0) && (params->node[analysisNode].postMix == false)) {
+        wanted[analysisNode] = true;    // the analysis tap — see ANALYSIS TAP
+    }
 
-            // The patch's own Vibrato, which is nothing to do with the cabling: it lives on a hidden
-            // module beside Glide and Bend, and is how a patch gets aftertouch vibrato without an LFO
-            // anywhere in it. The chosen controller sets the depth, so at rest there is none.
-            //
-            // ONE PHASE FOR THE WHOLE PATCH, not one per voice: it is a property of the patch rather
-            // than of a note, so a chord's notes wobble together instead of drifting apart.
-            double vibrato      = 0.0;
+    for (uint32_t n = 0; n < params->nodeCount; n++) {
+        if (wanted[n] == true) {
+            crossing[count++] = (uint8_t)n;
+        }
+    }
+
+    return count;
+}
+
+// One frame of finished output into the FIFO. The FIFO cannot really fill — it holds four times the
+// most the pipeline can be ahead by — but a host that stops calling process() mid-stream leaves this
+// thread nothing to do but wait, and it must still hear a stop.
+static void fx_emit_frame(const g2_sample_t outSample[4]) {
+    uint32_t write = atomic_load_explicit(&gFxOutWrite, memory_order_relaxed);
+
+    while ((write - atomic_load_explicit(&gFxOutRead, memory_order_acquire)) >= FX_PIPE_OUT_FRAMES) {
+        struct timespec pause = {0, 100000};
+
+        if ((gFxThreadUp == false) || (atomic_load(&gFxRun) == false)) {
+            return;
+        }
+        (void)nanosleep(&pause, NULL);
+    }
+    memcpy(gFxOut[write & (FX_PIPE_OUT_FRAMES - 1)], outSample, sizeof(gFxOut[0]));
+    atomic_store_explicit(&gFxOutWrite, write + 1, memory_order_release);
+}
+
+// The FX Area and the output stage for one block, on whichever thread owns them.
+static void fx_run_block(const tFxBlock * block) {
+    g2_sample_t voiceSum[MAX_SLOTS][MAX_ENGINE_NODES][2];
+    uint32_t    pos = 0;
 
-            if (params.vibratoSource != eVibratoOff) {
-                uint32_t group = (params.vibratoSource == eVibratoWheel)
-                             ? MORPH_GROUP_WHEEL : MORPH_GROUP_AFTERTOUCH;
-                double   depth = (double)atomic_load(&gMorphMilli[group]) / 1000.0;
+    for (uint32_t i = 0; i < block->silence; i++) {
+        g2_sample_t silence[4] = {0.0, 0.0, 0.0, 0.0};
 
-                gVibratoPhase += params.vibratoHz / gSampleRate;
+        fx_emit_frame(silence);
+    }
+    memset(voiceSum, 0, sizeof(voiceSum));
+    gAnalysisRun = block->analysis;
+
+    for (uint32_t frame = 0; frame < block->frames; frame++) {
+        g2_sample_t outSample[4] = {0.0, 0.0, 0.0, 0.0};
 
-                if (gVibratoPhase >= 1.0) {
-                    gVibratoPhase -= 1.0;
+        for (uint32_t sub = 0; sub < ENGINE_OVERSAMPLE; sub++) {
+            g2_sample_t sample[2][2] = {{0.0, 0.0}, {0.0, 0.0}};
+
+            for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+                if (block->live[slot] == false) {
+                    continue;
                 }
-                vibrato        = (sin(gVibratoPhase * 2.0 * M_PI) * depth * params.vibratoCents) / 100.0;
-            }
-            double bend         = ((double)atomic_load(&gBendMilli) / 1000.0) * params.bendSemitones;
-            double sample[2][2] = {{0.0, 0.0}, {0.0, 0.0}};   // [output pair][channel]
-            double envelopeStep = 1.0 / (ENVELOPE_SECONDS * gSampleRate);
-            double smoothCoeff  = 1.0 - exp(-1.0 / (PARAM_SMOOTH_SECONDS * gSampleRate));
-            // Depends on the patch and the rate, not on the voice, so it is worked out once here
-            // rather than once per voice — an exp() per voice per sample is not free at eight of them.
-            double glideCoeff   = (params.glideSeconds > 0.0)
-                                  ? (1.0 - exp(-4.6 / (params.glideSeconds * gSampleRate))) : 1.0;
-
-            // PARAMETER SMOOTHING IS PER SAMPLE, NOT PER VOICE. It tracks where a knob is, which is
-            // one thing however many notes are sounding — and running it inside the voice loop would
-            // advance it once per voice, so a knob would sweep faster the more keys were held.
-            for (n = 0; n < params.nodeCount; n++) {
-                const tEngineNode * spec   = &params.node[n];
-                bool                primed = gSmoothPrimed[n];
-
-                gSmoothedShape[n]  = smooth_to(&gSmoothShape[n], spec->shape, smoothCoeff, primed);
-                // Smoothed in DIAL units, not hertz. Smoothing a logarithmic control linearly in
-                // frequency makes a knob move slowly at the bottom of its travel and leap at the
-                // top; smoothing the dial value sweeps evenly in pitch, which is what the dial
-                // means and what turning it sounds like.
-                gSmoothedCutoff[n] = smooth_to(&gSmoothCutoff[n], spec->cutoffParam, smoothCoeff, primed);
-                gSmoothedRes[n]    = smooth_to(&gSmoothRes[n], spec->resonance, smoothCoeff, primed);
-                gSmoothedGain[n]   = smooth_to(&gSmoothGain[n], spec->gain, smoothCoeff, primed);
-
-                for (uint32_t c = 0; c < MAX_NODE_INPUTS; c++) {
-                    gSmoothedLevel[n][c] = smooth_to(&gSmoothLevel[n][c], spec->level[c], smoothCoeff, primed);
+
+                for (uint32_t k = 0; k < block->crossingCount[slot]; k++) {
+                    voiceSum[slot][block->crossing[slot][k]][0] = block->mix[pos++];
+                    voiceSum[slot][block->crossing[slot][k]][1] = block->mix[pos++];
                 }
+                bool gate = (block->mix[pos++] != 0.0);
 
-                gSmoothPrimed[n]   = true;
+                render_slot_fx(slot, &block->params[slot], block->smoothCoeff[slot], voiceSum[slot], gate, sample,
+                               (block->profile == true) ? gProfFx[slot] : NULL);
             }
+            output_stage_sample(sample);
+        }
+        output_stage_frame(outSample);
+        analysis_push(outSample);
+        fx_emit_frame(outSample);
+    }
 
-            memset(voiceSum, 0, sizeof(voiceSum));
+    if (block->profile == true) {
+        profile_publish(gProfFx);
+    }
+    meter_publish(&gMeterFx, 1, block->params, block->live, block->frames);
+}
 
-            // ── VOICE AREA: the whole area, once per sounding voice ──────────────────────────
-            //
-            // Each voice is a complete instance of the Voice Area with its own oscillator phases,
-            // filter state and envelopes, exactly as the hardware instantiates it. The FX Area is
-            // NOT in here: it is one shared instance fed by the sum of the voices, which is what
-            // lets a chord share one reverb instead of running 8 of them.
-            for (uint32_t v = 0; v < params.voiceCount; v++) {
-                tVoice * voice      = &gVoice[v];
-
-                if (voice->sounding == false) {
-                    continue;               // costs nothing when it is not playing
-                }
+// Everything handed over and not yet run. True if there was anything.
+static bool fx_run_pending(void) {
+    uint32_t tail = atomic_load_explicit(&gFxTail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&gFxHead, memory_order_acquire);
 
-                // Portamento. The sounding pitch chases the played note; how fast, and whether at
-                // all, comes from the patch's Glide setting. Exponential rather than linear — it is
-                // what a glide sounds like, and the coefficient is set so the remaining distance is
-                // down to a percent by the time the dial says.
-                if (voice->note >= 0) {
-                    bool sliding = (params.glideMode == eGlideNormal)
-                                   || ((params.glideMode == eGlideAuto) && (voice->glideActive == true));
-
-                    if ((sliding == true) && (params.glideSeconds > 0.0)) {
-                        voice->glidePitch += glideCoeff * ((double)voice->note - voice->glidePitch);
-                    } else {
-                        voice->glidePitch = (double)voice->note;
-                    }
-                }
-                double   voicePitch = voice->glidePitch + bend + vibrato;
+    if (tail == head) {
+        return false;
+    }
 
-                // The anti-click ramp, per voice. Only used when the patch has no EnvADSR to shape
-                // the note itself — with one, this would just double up on it.
-                double   rampTarget = (voice->gate == true) ? 1.0 : 0.0;
+    while (tail != head) {
+        fx_run_block(&gFxBlock[tail & (FX_PIPE_BLOCKS - 1)]);
+        tail++;
+        atomic_store_explicit(&gFxTail, tail, memory_order_release);
+    }
 
-                if (voice->envelope < rampTarget) {
-                    voice->envelope += envelopeStep;
+    return true;
+}
 
-                    if (voice->envelope > rampTarget) {
-                        voice->envelope = rampTarget;
-                    }
-                } else if (voice->envelope > rampTarget) {
-                    voice->envelope -= envelopeStep;
+// The pipeline thread as a real-time thread, with a deadline of one latency period — on macOS the
+// same time-constraint class CoreAudio gives its own IO thread, elsewhere SCHED_FIFO where the
+// process is allowed it. Either failing leaves an ordinary thread, which still works, with less
+// margin.
+static void fx_make_realtime(void) {
+    double periodNs = ((double)gFxLatency / ((gDeviceRate > 0.0) ? gDeviceRate : 48000.0)) * 1.0e9;
 
-                    if (voice->envelope < rampTarget) {
-                        voice->envelope = rampTarget;
-                    }
-                }
-                voice->released = (voice->gate == true) ? 0 : (voice->released + 1);
+#if defined(__APPLE__)
+    mach_timebase_info_data_t            timebase = {0};
 
-                // Past the limit, wind the voice down rather than cutting it. voice->fade reaching
-                // zero is what retires it below.
-                if (  (voice->gate == false)
-                   && (voice->released > (uint32_t)(VOICE_MAX_TAIL_SECONDS * gSampleRate))) {
-                    voice->fade -= 1.0 / (VOICE_FADE_SECONDS * gSampleRate);
+    (void)mach_timebase_info(&timebase);
 
-                    if (voice->fade < 0.0) {
-                        voice->fade = 0.0;
-                    }
-                }
-                double level   = ((chainHasEnvelope == true) ? 1.0 : voice->envelope) * voice->fade;
+    double                               ticks    = periodNs * (double)timebase.denom / (double)timebase.numer;
+    thread_time_constraint_policy_data_t policy   = {
+        .period      = (uint32_t)ticks,
+        .computation = (uint32_t)(ticks * 0.5),
+        .constraint  = (uint32_t)ticks,
+        .preemptible = 1,
+    };
 
-                for (n = 0; n < params.nodeCount; n++) {
-                    if (params.node[n].postMix == true) {
-                        continue;
-                    }
-                    eval_node(v, n, &params, value, voicePitch);
-                }
+    (void)thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                            (thread_policy_t)&policy, THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+#else
+    struct sched_param param = {0};
 
-                // The voices SUM, which is what playing more than one note at once means. Only the
-                // per-voice nodes are summed here — everything inside the voice was read from
-                // value[] during its own pass, before the next voice overwrites it.
-                double leaving = 0.0;
+    (void)periodNs;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    (void)pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
 
-                for (n = 0; n < params.nodeCount; n++) {
-                    if (params.node[n].postMix == true) {
-                        continue;
-                    }
-                    voiceSum[n][0] += value[n][0] * level;
-                    voiceSum[n][1] += value[n][1] * level;
+// Sleeps on a condition variable the audio thread signals WITHOUT taking the mutex — a real-time
+// thread must not queue on a lock — so a wakeup can slip between the check and the wait. The timeout
+// is what bounds that: a missed signal costs at most FX_PIPE_WAKE_NS, well inside a block.
+static void * fx_pipeline_thread(void * unused) {
+    (void)unused;
+    fx_make_realtime();
 
-                    // What this voice is putting out, measured at its Out modules — the point where
-                    // it leaves the voice for the mix or for the FX Area.
-                    if (params.node[n].kind == eNodeOut) {
-                        double magnitude = fabs(value[n][0] * level);
+    while (atomic_load(&gFxRun) == true) {
+        if (fx_run_pending() == true) {
+            continue;
+        }
+        struct timespec until = {0};
 
-                        if (magnitude > leaving) {
-                            leaving = magnitude;
-                        }
-                    }
-                }
+        (void)clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += FX_PIPE_WAKE_NS;
 
-                voice->quiet = (leaving < VOICE_SILENCE) ? (voice->quiet + 1) : 0;
-
-                // RETIRED ONLY WHEN IT HAS GONE QUIET AS WELL as finishing its envelope. The
-                // envelope alone is not enough: a patch whose EnvADSR modulates the filter rather
-                // than acting as the amp goes on sounding after that envelope is idle, and dropping
-                // it from the render at that moment cuts it off mid-note with a click. A patch that
-                // genuinely drones simply never frees the voice, so new notes take the others and
-                // eventually steal — which is what the instrument does with a droning patch too.
-                if (  (  (voice_is_finished(&params, v, chainHasEnvelope) == true)
-                      && (voice->quiet > (uint32_t)(VOICE_SILENCE_SECONDS * gSampleRate)))
-                   || (voice->fade <= 0.0)) {
-                    voice->sounding = false;
-                    voice->quiet    = 0;
-                    voice->released = 0;
-                    voice->fade     = 1.0;
-                }
-            }
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&gFxWakeMutex);
 
-            // What everything after the mix sees of the voices is their SUM.
-            for (n = 0; n < params.nodeCount; n++) {
-                if (params.node[n].postMix == false) {
-                    value[n][0] = voiceSum[n][0];
-                    value[n][1] = voiceSum[n][1];
-                }
+        if (atomic_load(&gFxHead) == atomic_load(&gFxTail)) {
+            (void)pthread_cond_timedwait(&gFxWake, &gFxWakeMutex, &until);
+        }
+        pthread_mutex_unlock(&gFxWakeMutex);
+    }
+
+    return NULL;
+}
+
+// Starting and stopping happen with the engine inactive, so nothing renders while the rings are reset.
+static void fx_pipeline_open(void) {
+    if ((gFxEnabled == false) || (gFxThreadUp == true)) {
+        return;
+    }
+    atomic_store(&gFxHead, 0);
+    atomic_store(&gFxTail, 0);
+    memset(gFxOut, 0, sizeof(gFxOut));
+    atomic_store(&gFxOutRead, 0);
+    atomic_store(&gFxOutWrite, gFxLatency);     // the latency IS this much silence, queued up front
+    atomic_store(&gFxUnderruns, 0);
+    atomic_store(&gFxWaitsCut, 0);
+    gFxDropped = 0;
+    gFxOwed    = 0;
+    atomic_store(&gFxRun, true);
+
+    // No thread is not no pipeline: the blocks are then run on the audio thread as they are handed
+    // over, which gives no overlap but keeps the delay the host was told about.
+    gFxThreadUp = (pthread_create(&gFxThread, NULL, fx_pipeline_thread, NULL) == 0);
+
+    if (gFxThreadUp == false) {
+        LOG_ERROR("Sound engine: no FX pipeline thread, running the FX Area inline\n");
+    }
+}
+
+static void fx_pipeline_close(void) {
+    if (gFxThreadUp == false) {
+        return;
+    }
+    atomic_store(&gFxRun, false);
+    pthread_cond_signal(&gFxWake);
+    (void)pthread_join(gFxThread, NULL);
+    gFxThreadUp = false;
+}
+
+// Waits for the pipeline thread to have run everything handed to it. False once the wait is over.
+static bool fx_pipeline_drain(tFxWait * wait) {
+    while (atomic_load_explicit(&gFxTail, memory_order_acquire) != atomic_load(&gFxHead)) {
+        if ((gFxThreadUp == false) && (fx_run_pending() == true)) {
+            continue;
+        }
+
+        if (fx_wait_over(wait) == true) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The audio thread's half: renders this buffer's voices and hands the FX Area what it reads of them,
+// a block at a time. A block that finds the ring still full when the wait is over is not rendered at all — its
+// frames are passed on as silence — because a voice rendered with nowhere to put it is work wasted
+// on a thread that has already run out of time.
+static void fx_pipeline_submit(uint32_t frameCount, const bool live[MAX_SLOTS], const bool chainHasEnvelope[MAX_SLOTS],
+                               double envelopeStep, const double smoothCoeff[MAX_SLOTS], bool profile,
+                               const tAnalysisRun * analysis, tFxWait * wait) {
+    uint8_t  crossing[MAX_SLOTS][MAX_ENGINE_NODES];
+    uint32_t crossingCount[MAX_SLOTS] = {0};
+    uint32_t perSub                   = 0;
+    uint32_t chunkFrames              = 0;
+    uint32_t done                     = 0;
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if (live[slot] == true) {
+            crossingCount[slot] = fx_crossing_nodes(&gRenderParams[slot], analysis->node[slot], crossing[slot]);
+            perSub             += (crossingCount[slot] * 2) + 1;     // + 1: voice 0's key
+        }
+    }
+
+    if (perSub == 0) {
+        gFxDropped += frameCount;      // nothing sounding: the FX tails have already been cut
+        done        = frameCount;
+    } else {
+        chunkFrames = FX_PIPE_MIX_VALUES / (perSub * ENGINE_OVERSAMPLE);
+
+        if (chunkFrames > FX_PIPE_CHUNK_FRAMES) {
+            chunkFrames = FX_PIPE_CHUNK_FRAMES;
+        }
+    }
+
+    while (done < frameCount) {
+        uint32_t   frames = ((frameCount - done) < chunkFrames) ? (frameCount - done) : chunkFrames;
+        uint32_t   head   = atomic_load_explicit(&gFxHead, memory_order_relaxed);
+        tFxBlock * block  = &gFxBlock[head & (FX_PIPE_BLOCKS - 1)];
+        uint32_t   pos    = 0;
+        bool       room   = true;
+
+        while ((head - atomic_load_explicit(&gFxTail, memory_order_acquire)) >= FX_PIPE_BLOCKS) {
+            if ((gFxThreadUp == false) && (fx_run_pending() == true)) {
+                continue;
             }
 
-            // ── AFTER THE MIX: one shared instance, whatever the polyphony ───────────────────────
-            //
-            // The FX Area, plus any delay, chorus or reverb sitting in the Voice Area and anything
-            // downstream of one — see mark_post_mix_nodes(). Runs even with every voice silent, so a
-            // reverb tail or a delay repeat carries on after the last note is released rather than
-            // being cut off with it.
-            for (n = 0; n < params.nodeCount; n++) {
-                if (params.node[n].postMix == false) {
-                    continue;
-                }
-                eval_node(0, n, &params, value, 0.0);
+            if (fx_wait_over(wait) == true) {
+                room = false;
+                break;
             }
+        }
 
-            if (params.tap >= 0) {
-                // Tapping a module means listening to its main output; for an envelope used as an amp
-                // that is its shaped audio rather than the envelope signal. See tap_pair().
-                {
-                    double   first[2] = {0.0, 0.0};
-                    uint32_t d        = params.node[params.tap].outDest & 1U;
+        if (room == false) {
+            gFxDropped += frames;
+            done       += frames;
+            continue;
+        }
+        block->frames  = frames;
+        block->silence = gFxDropped;
+        block->profile  = profile;
+        block->analysis = *analysis;
+        gFxDropped      = 0;
 
-                    tap_pair(&params, params.tap, value, first);
-                    sample[d][0] += first[0];
-                    sample[d][1] += first[1];
-                }
+        for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+            block->live[slot]          = live[slot];
+            block->crossingCount[slot] = crossingCount[slot];
+            block->smoothCoeff[slot]   = smoothCoeff[slot];
 
-                // The patch's other Out modules, summed rather than mixed at some fraction: that is
-                // what the hardware's sockets do when two areas both drive them. Summed per channel
-                // AND PER PAIR, so a patch whose Out modules feed different physical pairs — which
-                // is what every measurement patch does — keeps them apart instead of folding them
-                // into one stereo image.
-                for (uint32_t t = 0; t < params.extraTapCount; t++) {
-                    double   extra[2] = {0.0, 0.0};
-                    uint32_t d        = params.node[params.extraTap[t]].outDest & 1U;
-
-                    tap_pair(&params, params.extraTap[t], value, extra);
-                    sample[d][0] += extra[0];
-                    sample[d][1] += extra[1];
-                }
+            if (live[slot] == true) {
+                memcpy(block->crossing[slot], crossing[slot], crossingCount[slot]);
+                block->params[slot] = gRenderParams[slot];
             }
-            // With an envelope module shaping the note, the fixed ramp would only double up on it; it is
-            // still applied when the chain has none.
-            // THE METERS READ THE LOUDER CHANNEL. A per-channel peak would need a per-channel meter
-            // to show it, and what these drive is one number.
-            {
-                uint32_t rawMilli = (uint32_t)(fmax(fmax(fabs(sample[0][0]), fabs(sample[0][1])),
-                                                    fmax(fabs(sample[1][0]), fabs(sample[1][1]))) * 1000.0);
+        }
+
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            for (uint32_t sub = 0; sub < ENGINE_OVERSAMPLE; sub++) {
+                (void)take_next_note_event(gRenderParams);
+
+                for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+                    g2_sample_t voiceSum[MAX_ENGINE_NODES][2];
+
+                    if (live[slot] == false) {
+                        continue;
+                    }
+                    render_slot_voices(slot, &gRenderParams[slot], chainHasEnvelope[slot], envelopeStep,
+                                       smoothCoeff[slot], voiceSum, (profile == true) ? gProfVoice[slot] : NULL);
 
-                if (rawMilli > atomic_load(&gRawPeakMilli)) {
-                    atomic_store(&gRawPeakMilli, rawMilli);
+                    for (uint32_t k = 0; k < crossingCount[slot]; k++) {
+                        block->mix[pos++] = voiceSum[crossing[slot][k]][0];
+                        block->mix[pos++] = voiceSum[crossing[slot][k]][1];
+                    }
+                    block->mix[pos++] = (gVoice[slot][0].gate == true) ? 1.0 : 0.0;
                 }
             }
+        }
+        atomic_store_explicit(&gFxHead, head + 1, memory_order_release);
+        pthread_cond_signal(&gFxWake);
+        done += frames;
+    }
 
-            // The gain, the knee and the clamp are all PER CHANNEL. The knee especially: shaping the
-            // two channels together off a common peak would make one duck when the other got loud,
-            // which is a stereo image moving under a limiter rather than an output stage.
-            for (uint32_t q = 0; q < 4; q++) {
-                double * sp = &sample[q >> 1][q & 1];
-
-                *sp                           *= VOICE_GAIN;
-                // The anti-click ramp is applied PER VOICE as each voice's output leaves the Voice Area
-                // (see the voice loop), not here. Applying it to the mixed output would fade the whole
-                // instrument — including the FX tail — every time any one note was released.
-                // The user's own attenuation, ahead of the knee.
-                *sp                           *= (double)atomic_load(&gOutputGainMilli) / 1000.0;
-
-                // Soft knee rather than a hard edge. Below the knee nothing is touched at all, so ordinary
-                // playing is untouched; above it the curve bends over instead of shearing the tops off, which
-                // is both kinder to listen to and closer to what an overloaded analogue output does. The hard
-                // clamp afterwards is only a guard against a bug producing something enormous.
-                if (*sp > OUTPUT_KNEE) {
-                    *sp = OUTPUT_KNEE + ((1.0 - OUTPUT_KNEE) * tanh((*sp - OUTPUT_KNEE) / (1.0 - OUTPUT_KNEE)));
-                } else if (*sp < -OUTPUT_KNEE) {
-                    *sp = -OUTPUT_KNEE - ((1.0 - OUTPUT_KNEE) * tanh((-*sp - OUTPUT_KNEE) / (1.0 - OUTPUT_KNEE)));
-                }
+    // Silence still owed with no block to carry it — nothing is sounding, or the ring was full — goes
+    // over on its own if there is room, so the FX output does not stall waiting for the next note.
+    if (gFxDropped > 0) {
+        uint32_t head = atomic_load_explicit(&gFxHead, memory_order_relaxed);
 
-                if (*sp > 1.0) {
-                    *sp = 1.0;
-                } else if (*sp < -1.0) {
-                    *sp = -1.0;
-                }
-                // Every internal sample goes through the decimator; only the last of each group produces
-                // an output. Feeding all of them is the point — dropping the others without filtering is
-                // exactly what would fold the high end back down.
-                gOutHistory[q][gOutHistoryPos] = *sp;
+        if ((head - atomic_load_explicit(&gFxTail, memory_order_acquire)) < FX_PIPE_BLOCKS) {
+            tFxBlock * block = &gFxBlock[head & (FX_PIPE_BLOCKS - 1)];
+
+            block->frames  = 0;
+            block->silence = gFxDropped;
+            block->profile = false;
+            gFxDropped     = 0;
+            atomic_store_explicit(&gFxHead, head + 1, memory_order_release);
+            pthread_cond_signal(&gFxWake);
+        }
+    }
+}
+
+// The audio thread's other half: this buffer's worth of finished output, gFxLatency frames behind.
+// Normally already there — it was the previous buffer's FX — so this copies rather than waits.
+static void fx_pipeline_collect(const tOutputTarget * out, uint32_t frameCount, tFxWait * wait) {
+    uint32_t read  = atomic_load_explicit(&gFxOutRead, memory_order_relaxed);
+    uint32_t frame = 0;
+
+    if (gFxThreadUp == false) {
+        (void)fx_run_pending();
+    }
+
+    while (frame < frameCount) {
+        uint32_t ready = atomic_load_explicit(&gFxOutWrite, memory_order_acquire) - read;
+
+        if ((gFxOwed > 0) && (ready > 0)) {
+            uint32_t skip = (ready < gFxOwed) ? ready : gFxOwed;
+
+            read    += skip;
+            gFxOwed -= skip;
+            continue;
+        }
+
+        if (ready == 0) {
+            if ((gFxThreadUp == false) || (fx_wait_over(wait) == true)) {
+                break;
             }
+            continue;
+        }
 
-            // ONE position for both lines: they are written in lockstep, so one cursor serves.
-            gOutHistoryPos = (gOutHistoryPos + 1) % OUT_DECIMATE_TAPS;
+        for (; (ready > 0) && (frame < frameCount); ready--, frame++, read++) {
+            write_output_frame(out, frame, gFxOut[read & (FX_PIPE_OUT_FRAMES - 1)]);
         }
+    }
+    atomic_store_explicit(&gFxOutRead, read, memory_order_release);
 
-        {
-            uint32_t channel      = 0;
-            uint32_t tap          = 0;
-            double   milli        = 0.0;
-            double   outSample[4] = {0.0, 0.0, 0.0, 0.0};
-
-            // Walked rather than recomputed, as in the oscillator decimator above and for the same
-            // reason — the same taps in the same order, without a division per tap. All four
-            // channels share the walk and the coefficient lookup; only the history line differs.
-            {
-                uint32_t oldest = gOutHistoryPos;
+    // The buffer was cleared on entry, so what is missing is already silence.
+    if (frame < frameCount) {
+        gFxOwed += frameCount - frame;
+        atomic_fetch_add(&gFxUnderruns, 1);
+    }
+}
+
+bool sound_engine_set_fx_pipeline(bool on, uint32_t latencyFrames) {
+    if (atomic_load(&gActive) == true) {
+        return false;
+    }
+
+    if (latencyFrames < 1) {
+        latencyFrames = 1;
+    } else if (latencyFrames > FX_PIPE_MAX_LATENCY) {
+        latencyFrames = FX_PIPE_MAX_LATENCY;
+    }
+    gFxEnabled = on;
+    gFxLatency = latencyFrames;
+    return true;
+}
+
+uint32_t sound_engine_latency_frames(void) {
+    return (gFxEnabled == true) ? gFxLatency : 0;
+}
 
-                for (tap = 0; tap < OUT_DECIMATE_TAPS; tap++) {
-                    double coeff = gOutDecimate[OUT_DECIMATE_TAPS - 1 - tap];
+uint32_t sound_engine_fx_underruns(void) {
+    return atomic_load(&gFxUnderruns);
+}
 
-                    outSample[0] += gOutHistory[0][oldest] * coeff;
-                    outSample[1] += gOutHistory[1][oldest] * coeff;
-                    outSample[2] += gOutHistory[2][oldest] * coeff;
-                    outSample[3] += gOutHistory[3][oldest] * coeff;
-                    oldest++;
+uint32_t sound_engine_fx_waits_cut(void) {
+    return atomic_load(&gFxWaitsCut);
+}
 
-                    if (oldest >= OUT_DECIMATE_TAPS) {
-                        oldest = 0;
-                    }
+// The whole graph on the audio thread, voices then FX then the output stage, one oversampled sample
+// at a time. What sound_engine_render() does unless the FX pipeline is on.
+static void render_inline(const tOutputTarget * out, uint32_t frameCount, const bool live[MAX_SLOTS],
+                          const bool chainHasEnvelope[MAX_SLOTS], double envelopeStep,
+                          const double smoothCoeff[MAX_SLOTS], bool profile, const tAnalysisRun * analysis) {
+    uint32_t frame = 0;
+    uint32_t slot  = 0;
+
+    gAnalysisRun = *analysis;
+
+    for (frame = 0; frame < frameCount; frame++) {
+        uint32_t sub = 0;
+
+        // ENGINE_OVERSAMPLE passes of the whole graph per output sample. Note events are consumed
+        // inside, so they land on the finer grid too rather than being quantised to the output rate.
+        for (sub = 0; sub < ENGINE_OVERSAMPLE; sub++) {
+            g2_sample_t sample[2][2] = {{0.0, 0.0}, {0.0, 0.0}};   // [output pair][channel]
+
+            // One event per sample. A chord's worth of note-ons arriving together therefore lands over
+            // consecutive samples rather than all but the last being thrown away, and every note takes
+            // effect where it actually arrived instead of at the next buffer boundary.
+            (void)take_next_note_event(gRenderParams);
+
+            // THE SLOTS SUM INTO ONE BUS, as the four slots of a G2 performance share its outputs. Each
+            // is rendered whole before the next, so nothing of one slot's state is touched while
+            // another's is running.
+            for (slot = 0; slot < MAX_SLOTS; slot++) {
+                if (live[slot] == false) {
+                    continue;
                 }
+                g2_sample_t voiceSum[MAX_ENGINE_NODES][2];
+
+                render_slot_voices(slot, &gRenderParams[slot], chainHasEnvelope[slot], envelopeStep, smoothCoeff[slot],
+                                   voiceSum, (profile == true) ? gProfVoice[slot] : NULL);
+                render_slot_fx(slot, &gRenderParams[slot], smoothCoeff[slot], voiceSum, gVoice[slot][0].gate, sample,
+                               (profile == true) ? gProfFx[slot] : NULL);
             }
+            output_stage_sample(sample);
+        }
 
-            milli = fmax(fmax(fabs(outSample[0]), fabs(outSample[1])),
-                         fmax(fabs(outSample[2]), fabs(outSample[3]))) * 1000.0;
+        {
+            g2_sample_t outSample[4] = {0.0, 0.0, 0.0, 0.0};
+
+            output_stage_frame(outSample);
+            analysis_push(outSample);
+            write_output_frame(out, frame, outSample);
+        }
+    }
+}
+
+// Both entry points below, once the caller's buffers are described.
+static void render_to(const tOutputTarget * out, uint32_t frameCount) {
+    bool               chainHasEnvelope[MAX_SLOTS] = {false};
+    bool               live[MAX_SLOTS]             = {false};
+    bool               anyLive                     = false;
+    uint32_t           slot                        = 0;
+    uint32_t           n                           = 0;
+    double             envelopeStep                = 0.0;
+    double             smoothCoeff[MAX_SLOTS]      = {0.0};
+    tAnalysisRun       analysis                    = {0};
+    // Read once: the profiler's switch holds still for the whole callback, so every evaluation site in
+    // it takes the same side of its branch.
+    bool               profile                     = atomic_load_explicit(&gProfileOn, memory_order_relaxed);
+
+    struct timespec    started                     = {0};
+    tFxWait            fxWait                      = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &started);
+
+    // The most the FX pipeline may wait for anything, all waits together: a small share of the time
+    // this buffer takes to play — see FX PIPELINE.
+    {
+        double seconds = (gDeviceRate > 0.0) ? ((double)frameCount / gDeviceRate) : 0.0;
+
+        fxWait.limitNs = (uint64_t)(seconds * 1.0e9) / FX_PIPE_WAIT_SHARE;
+
+        if (fxWait.limitNs > FX_PIPE_WAIT_MAX_NS) {
+            fxWait.limitNs = FX_PIPE_WAIT_MAX_NS;
+        }
+    }
+
+    clear_output(out, frameCount);
+
+    if (atomic_load(&gActive) == false) {
+        return;
+    }
+
+    for (slot = 0; slot < MAX_SLOTS; slot++) {
+        tSoundEngineParams * params = &gRenderParams[slot];
+        uint32_t             lane   = atomic_load_explicit(&gLaneSelect[slot], memory_order_acquire);
 
-            if ((uint32_t)milli > atomic_load(&gPeakMilli)) {
-                atomic_store(&gPeakMilli, (uint32_t)milli);
+        *params = read_params(slot, lane);
+
+        // A variation switch. With a crossfade set, the slot's smoothing slows down for its length —
+        // see below.
+        if (lane != gSeenLane[slot]) {
+            if (gSeenLane[slot] != NO_LANE_SEEN) {
+                gFadeFramesLeft[slot] = (uint64_t)((double)atomic_load(&gCrossfadeMicros) * 1.0e-6 * gDeviceRate);
             }
+            gSeenLane[slot] = lane;
+        }
+
+        // A slot with nothing to play — switched off in the performance, or not the focused one in
+        // patch mode — is skipped outright rather than run silent. Forgetting its topology means it
+        // starts from clean state when it comes back, the same as a patch that has just loaded.
+        if (params->nodeCount == 0) {
+            gSeenTopology[slot] = 0;
+            continue;
+        }
 
-            // FOUR CHANNELS IF THE CALLER ASKED FOR THEM, otherwise the two pairs are SUMMED.
+        if (params->topology != gSeenTopology[slot]) {
+            // WORTH LOGGING, because reset_node_state() below empties every delay line and reverb buffer
+            // in the slot. A topology change that is real — a module added, a cable moved — has to do
+            // that. One that is NOT real takes the delay repeats and the reverb tail with it, and what
+            // is heard is the effect stopping dead and then filling up again from nothing.
+            //
+            // So if a delay or reverb is ever reported cutting out at random, this line is the first
+            // thing to look for: if it fires when nothing about the patch changed, the signature is
+            // unstable and the wipe is the symptom rather than the cause. Debug builds only.
             //
-            // The summing is what keeps the application unchanged: its device is stereo, every Out
-            // module used to be added together whatever pair it fed, and a patch sending anything to
-            // Out 3/4 would fall silent if this suddenly routed by destination. A caller that wants
-            // them apart — the measurement harness, which needs the rig's dry reference on one pair
-            // and its processed signal on the other — asks for four and gets them.
+            // Not the explanation for every such report: 45 s of idle playing, 120 parameter edits and
+            // repeated select/deselect cycles all produced ZERO changes here, so whatever else may cut a
+            // delay short, it is not this under those conditions.
+            RT_LOG_DEBUG("TOPOLOGY CHANGE %llu -> %llu, nodes %u, tap %d — delay and reverb buffers cleared\n",
+                         (unsigned long long)gSeenTopology[slot], (unsigned long long)params->topology,
+                         (unsigned)params->nodeCount, params->tap);
             //
-            // Choosing WHICH pair a stereo device should monitor, rather than always summing, wants
-            // a menu item; see the todo. Summing is the answer that changes nothing until then.
-            for (channel = 0; channel < channelCount; channel++) {
-                double v = (channelCount >= 4)
-                           ? outSample[channel & 3U]
-                           : (outSample[channel & 1U] + outSample[2U + (channel & 1U)]);
-
-                out[(frame * channelCount) + channel] = (float)v;
+            // With the FX pipeline on, the other thread may still be running this slot's FX Area from
+            // an earlier block, so it has to finish first. If it cannot in the time the callback may wait,
+            // the slot sits this buffer out and the change is picked up next time.
+            if ((gFxEnabled == true) && (fx_pipeline_drain(&fxWait) == false)) {
+                continue;
+            }
+            gSeenTopology[slot] = params->topology;
+            reset_node_state(slot);
+        }
+        // Oscillator phases are deliberately NOT reset when a note starts. They free-run, as the G2's do
+        // unless something is patched to their Sync input, and that matters more than it sounds: several
+        // oscillators detuned by a few cents are what makes a patch thick, and starting them all at
+        // phase zero has them summing as one voice for the seconds a 7 cent difference takes to drift
+        // apart. Note events themselves are taken inside the sample loop below.
+
+        if (params->tap < 0) {
+            continue;
+        }
+
+        // A snapshot that has never been published carries a voice count of zero, and zero voices render
+        // silence — which would look exactly like the engine being broken. One voice is the safe reading
+        // of "not told yet", and it is what the engine did before it could count.
+        if (params->voiceCount < 1) {
+            params->voiceCount = 1;
+        } else if (params->voiceCount > MAX_VOICES) {
+            params->voiceCount = MAX_VOICES;
+        }
+
+        // A PER-VOICE EnvADSR is the note's shape; the fixed ramp is only there to stop a click when
+        // there is none to do that job. Per-voice only, and it has to be: an envelope after the mix
+        // shapes the effect rather than the note, and counting it here would leave every voice unramped
+        // AND have voice_is_finished() retire voices the moment a key came up.
+        for (n = 0; n < params->nodeCount; n++) {
+            if ((params->node[n].kind == eNodeEnv) && (params->node[n].postMix == false)) {
+                chainHasEnvelope[slot] = true;
+                break;
             }
         }
+        live[slot] = true;
+        anyLive    = true;
+    }
+
+    // Both depend on the rate alone, so they are worked out once per buffer rather than once per
+    // slot per sample.
+    envelopeStep = 1.0 / (ENVELOPE_SECONDS * gSampleRate);
+
+    // THE VARIATION CROSSFADE IS THE PARAMETER SMOOTHING, SLOWED DOWN. Every continuous control the
+    // engine smooths — levels, cutoffs, resonance, gains, shapes, delay times — glides from the old
+    // lane's value to the new one's, with a time constant a quarter of the crossfade's length so the
+    // glide is all but complete when the crossfade ends and the usual smoothing takes back over.
+    // Stepped settings (a waveform, a routing) change at once, as they do when the dial is turned;
+    // and a switch between variations with different graphs is a topology change, which no fade
+    // spans.
+    for (slot = 0; slot < MAX_SLOTS; slot++) {
+        double crossfade = (double)atomic_load(&gCrossfadeMicros) * 1.0e-6;
+
+        smoothCoeff[slot] = 1.0 - exp(-1.0 / (PARAM_SMOOTH_SECONDS * gSampleRate));
+
+        if ((gFadeFramesLeft[slot] > 0) && (crossfade > 0.0)) {
+            smoothCoeff[slot]     = 1.0 - exp(-1.0 / ((crossfade / CROSSFADE_TIME_CONSTANTS) * gSampleRate));
+            gFadeFramesLeft[slot] = (gFadeFramesLeft[slot] > frameCount) ? (gFadeFramesLeft[slot] - frameCount) : 0;
+        }
+    }
+
+    analysis_resolve(gRenderParams, live, &analysis);
+
+    if (gFxEnabled == true) {
+        fx_pipeline_submit(frameCount, live, chainHasEnvelope, envelopeStep, smoothCoeff, profile, &analysis, &fxWait);
+        fx_pipeline_collect(out, frameCount, &fxWait);
+    } else if (anyLive == true) {
+        render_inline(out, frameCount, live, chainHasEnvelope, envelopeStep, smoothCoeff, profile, &analysis);
+
+        if (profile == true) {
+            profile_publish(gProfFx);
+        }
+        meter_publish(&gMeterFx, 1, gRenderParams, live, frameCount);
+    }
+
+    // A callback with nothing live rendered nothing and has no meters to publish, but it still had a
+    // deadline, so it is timed below with the rest. The profiler is about the work, and skips it.
+    bool rendered = (gFxEnabled == true) || (anyLive == true);
+
+    if (rendered == true) {
+        meter_publish(&gMeterVoice, 0, gRenderParams, live, frameCount);
     }
 
     // What that cost, against what it bought. frameCount / gDeviceRate is the time the buffer will
@@ -5217,10 +7318,37 @@ void sound_engine_render(float * out, uint32_t frameCount, uint32_t channelCount
             if (percent > atomic_load(&gLoadPercent)) {
                 atomic_store(&gLoadPercent, percent);
             }
+            timing_record((uint64_t)(spent * 1.0e9), (uint64_t)(available * 1.0e9),
+                          ((uint64_t)finished.tv_sec * 1000000000ULL) + (uint64_t)finished.tv_nsec);
+        }
+
+        if ((profile == true) && (rendered == true)) {
+            profile_publish(gProfVoice);
+            atomic_fetch_add_explicit(&gProfCallbackNanos, (uint64_t)(spent * 1.0e9), memory_order_relaxed);
+            atomic_fetch_add_explicit(&gProfCallbackFrames, frameCount, memory_order_relaxed);
+            atomic_fetch_add_explicit(&gProfCallbacks, 1, memory_order_relaxed);
         }
     }
 }
 
+void sound_engine_render(float * out, uint32_t frameCount, uint32_t channelCount) {
+    const tOutputTarget target = {out, NULL, channelCount};
+
+    if ((out == NULL) || (channelCount == 0)) {
+        return;
+    }
+    render_to(&target, frameCount);
+}
+
+void sound_engine_render_planar(float * const * outs, uint32_t outCount, uint32_t frameCount) {
+    const tOutputTarget target = {NULL, outs, outCount};
+
+    if ((outs == NULL) || (outCount == 0)) {
+        return;
+    }
+    render_to(&target, frameCount);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,32 +130,182 @@ void sound_engine_note(int32_t note, bool on);
 // still held, and in Poly it must not, because that note already has a voice of its own sounding it.
 bool sound_engine_is_polyphonic(void);
 
-// How many voices the current patch may sound at once, and how many are audible right now. For the
-// status line — the second figure is what tells you whether a chord is being cut short.
+// How many voices the engine may sound at once, and how many are audible right now. For the status
+// line — the second figure is what tells you whether a chord is being cut short. In a performance
+// both count across every slot that is playing, not just the one on screen.
 uint32_t sound_engine_voice_count(void);
 uint32_t sound_engine_voices_sounding(void);
 
+// The same, for one slot: which slots a note reached. For a test of a performance's keyboard split,
+// tools/perfsplit.c. Any thread, and as loosely as the figure above.
+uint32_t sound_engine_slot_voices_sounding(uint32_t slot);
+
 // Worst render load since this was last called, as a percentage of real time — reading it clears the
 // peak. Approaching 100 % means the engine is running out of its deadline, which is what crackling
 // is; well below it means a crackle is something else.
 uint32_t sound_engine_load_percent(void);
 
+// CALLBACK TIMING, as a distribution rather than a peak. Every callback of a started engine is timed
+// into a log-bucketed histogram, a quarter-octave per bucket, from which the percentiles below are
+// read; each is the upper edge of its bucket, so within 19 % above the true figure, never below. One
+// with no slot live counts too: it rendered nothing, but it still had a deadline. Only a callback
+// before sound_engine_start() or after sound_engine_stop() is left out.
+// A callback counts as a MISS when it takes longer than missPercent of its own buffer's playing time
+// — 100 by default, i.e. the buffer was late. Counts run from engine start or the last reset.
+typedef struct {
+    uint64_t callbacks;
+    double   p50Us;
+    double   p90Us;
+    double   p99Us;
+    double   p999Us;
+    double   maxUs;
+    double   periodUs;           // the most recent buffer's playing time: the deadline the above are against
+    uint32_t missPercent;
+    uint64_t misses;
+    double   lastMissSeconds;    // CLOCK_MONOTONIC, as clock_gettime() gives it; 0 if there has been none
+} tSoundEngineTiming;
+
+#define SOUND_ENGINE_TIMING_BUCKETS    (96U)
+
+// Any thread. Lock-free against the audio thread: a callback landing mid-read can leave the figures a
+// callback apart from each other, which at these counts is nothing.
+void sound_engine_timing_stats(tSoundEngineTiming * stats);
+
+// Clears the histogram and the miss count, and sets the threshold for a miss (1..1000 %; anything
+// else keeps the current one). Any thread.
+void sound_engine_timing_reset(uint32_t missPercent);
+
+// The raw histogram, for a CSV or a plot: counts[b] callbacks took at most upperUs[b], and more than
+// upperUs[b - 1]. Bucket 0 holds everything up to its edge, the last everything beyond. Any thread.
+void sound_engine_timing_histogram(uint64_t counts[SOUND_ENGINE_TIMING_BUCKETS],
+                                   double upperUs[SOUND_ENGINE_TIMING_BUCKETS]);
+
+// THE SNAPSHOT CHECK: proof, for a soak test, that the seqlock between the parameter writers and the
+// audio thread never lets a half-written snapshot through. While on, every publish stores a checksum of
+// the snapshot alongside it and every read the seqlock accepts is checked against it; a mismatch is a
+// torn snapshot, counted and otherwise handled like a failed read. It costs a pass over the snapshot
+// on both sides, so it is off by default and meant for tools/soak.c. Any thread.
+void sound_engine_set_snapshot_check(bool on);
+
+// Reads the check caught since it was switched on. Anything above zero is a bug.
+uint64_t sound_engine_torn_snapshots(void);
+
+// Buffers that fell back to the last good snapshot because every read attempt overlapped a write.
+// Expected now and then under heavy editing, and harmless; counted whether or not the check is on.
+uint64_t sound_engine_stale_snapshots(void);
+
 // UI thread. Reads the current selection and publishes a parameter snapshot for the audio thread.
 // Cheap enough to call on every redraw, which is what graphics.c does — every parameter change
-// forces one, so nothing else needs to poll.
+// forces one, so nothing else needs to poll. In patch mode only the slot on screen is built; in
+// performance mode every enabled slot is, with its patch volume and keyboard range, and all of
+// them sound together.
 void sound_engine_update_from_patch(void);
 
+// VARIATIONS ARE PRE-RESOLVED: every variation of a built slot has its own snapshot, kept current by
+// sound_engine_update_from_patch(), so switching between them is a single store here, without a lock
+// — nothing is rebuilt and the next buffer plays the new one. The exception is a switch made before
+// the first update after an edit has caught its lane up, which builds the lane here first. Call it
+// alongside setting activeVariation, from any thread but the audio thread. A variation out of range
+// is ignored.
+void sound_engine_select_variation(uint32_t slot, uint32_t variation);
+
+// One variation's parameters were written — a value or a morph range — from any thread. The next
+// sound_engine_update_from_patch() rebuilds that lane along with the selected one, and a switch to it
+// before then rebuilds it first. Edits to the selected variation need not call it, but may.
+void sound_engine_lane_edited(uint32_t slot, uint32_t variation);
+
+// How long a variation switch takes to glide from the old settings to the new, in seconds, up to 10.
+// 0, the default, switches as fast as any edit does, through the ordinary parameter smoothing. Any
+// thread; takes effect from the next switch. The application's setting is in audioOutput.h.
+void sound_engine_set_variation_crossfade(double seconds);
+
+// How many variation snapshots the engine has resolved since it was loaded. Only for a test to show
+// that switching variations resolves none. Any thread.
+uint64_t sound_engine_lane_builds(void);
+
+// THE OFFLINE METERS: with no G2 connected, the engine stands in for it and drives the modules' LEDs
+// and volume meters from its own signals, about 30 times a second. This copies the latest into the
+// slot's modules — module->volume.value and module->led.value, the fields parse_volume_indicator() and
+// parse_led_data() fill online — and returns whether anything changed, i.e. whether to redraw. With
+// the engine stopped everything reads dark. Only modules the engine models light up. UI thread, and
+// only while offline: online the device's own readings are the ones to show.
+bool sound_engine_apply_meters(uint32_t slot);
+
+// THE ANALYSIS TAP: a copy of the engine's output, or of one module's, for a scope or a spectrum —
+// analysis.h does the FFT. The audio side writes into a ring and never waits for the reader; a
+// reader that falls more than a couple of seconds behind is moved on past what it missed.
+typedef enum {
+    eAnalysisTapOff = 0,
+    eAnalysisTapOutput,    // the stereo output, after the output stage
+    eAnalysisTapModule     // one module's Out (its first two outputs), summed over the voices
+} tAnalysisTap;
+
+// Chooses the source. slot, location (locationVa or locationFx) and moduleIndex are only read for
+// eAnalysisTapModule; a module the engine does not model leaves the tap silent. Any thread.
+void sound_engine_set_analysis_tap(tAnalysisTap tap, uint32_t slot, uint32_t location, uint32_t moduleIndex);
+
+// The tap's write position in frames since start, e.g. to start a cursor at "now". Any thread.
+uint64_t sound_engine_analysis_position(void);
+
+// The rate the tap's frames are at: the device's, as the engine was last started at. Any thread.
+double sound_engine_analysis_rate(void);
+
+// Copies up to maxFrames stereo frames, interleaved, from *cursor on, and advances it. Returns the
+// number copied, which is 0 both when nothing is new and when the writer overran the copy — in that
+// case the cursor has moved past the damage and the next call reads good frames. Frames are at the
+// device rate. One reader only.
+uint32_t sound_engine_analysis_read(uint64_t * cursor, float * frames, uint32_t maxFrames);
+
 // The resolved chain as the engine currently sees it — one line per node with the parameters it
 // actually read. For diagnosing "it looks right on screen but makes no sound": the usual causes are
 // a parameter read from the wrong variation, or a chain that resolved differently than it looks.
 // UI thread only.
 const char * sound_engine_debug_text(void);
 
+// THE PROFILER: cycle counts per engine node, accumulated inside the render loop, for finding which
+// module in a patch the load is going to. Off by default; while off it costs one predictable branch
+// per node evaluation. Switching it on starts a fresh count. Any thread.
+void sound_engine_set_profiling(bool on);
+bool sound_engine_profiling(void);
+
+// The count so far for the slot on screen, as a table sorted by cost: module, node kind, share of the
+// callback's time and nanoseconds per voice-sample, then the same summed by kind. Reading it starts a
+// new count. Also appended to sound_engine_debug_text() while profiling is on. UI thread only.
+const char * sound_engine_profile_text(void);
+
+// THE FX PIPELINE: runs every slot's FX Area — reverb, delays, chorus, compressor and whatever sits
+// after them — on a real-time thread of its own, overlapping the next block's voices instead of
+// following them. It costs exactly latencyFrames of delay, which should be the caller's largest
+// block; a plug-in reports it to the host as sound_engine_latency_frames(). See FX PIPELINE in
+// soundEngine.c.
+//
+// Only while the engine is stopped — false, and nothing changed, if it is running. It takes effect at
+// the next sound_engine_start() or sound_engine_start_hosted().
+bool sound_engine_set_fx_pipeline(bool on, uint32_t latencyFrames);
+
+// The delay the engine adds, in frames at the device rate. 0 unless the FX pipeline is on.
+uint32_t sound_engine_latency_frames(void);
+
+// Buffers since the engine started in which the FX pipeline's output arrived late and silence was
+// played instead. Anything above zero means the FX Area needs more time than the latency gives it.
+uint32_t sound_engine_fx_underruns(void);
+
+// Buffers in which the audio thread gave up waiting on the FX pipeline — a full ring, a late block or
+// a topology change it could not drain — and played silence rather than spin past its share of the
+// period. Each of these is usually an underrun as well; it says the wait is why.
+uint32_t sound_engine_fx_waits_cut(void);
+
 // Audio thread, real-time context: no locks, no allocation, no logging below this line.
 // Fills frameCount frames of interleaved float, channelCount channels wide.
 void sound_engine_set_sample_rate(double sampleRate);
 void sound_engine_render(float * out, uint32_t frameCount, uint32_t channelCount);
 
+// The same, into one buffer per channel — what a plug-in host hands over — so nothing is rendered
+// into a scratch block and copied apart afterwards. Two channels get the G2's Out 1/2 and 3/4 summed,
+// as a stereo device does; four or more get the four outputs each on their own. A NULL entry is a
+// channel nobody is listening to and is skipped.
+void sound_engine_render_planar(float * const * outs, uint32_t outCount, uint32_t frameCount);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,7 @@ extern "C" {
 #include "synthlibDefs.h"
 #include "synthlibGlobals.h"
 #include "globalVars.h"
+#include "protocol.h"
 #include "graphics.h"
 #include "utilsGraphics.h"
 #include "dataBase.h"
@@ -372,7 +373,7 @@ void split_view_flush_position(void) {
     gSplitView.dirty = false;
     msg.cmd          = eMsgCmdWritePatchDescr;
     msg.slot         = gSlot;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 bool handle_split_bar_mouse(tCoord coord, tMouseButton mouseButton) {
@@ -593,7 +593,7 @@ static void recreate_module(uint32_t slot, uint32_t location, tClipboardModule *
     }
 
     COPY_STRING(msg.moduleData.name, cm->name);
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     write_module(key, &module);
 
@@ -631,7 +631,7 @@ static void recreate_module(uint32_t slot, uint32_t location, tClipboardModule *
                 nmsg.paramLabelData.moduleKey  = key;
                 nmsg.paramLabelData.paramIndex = pi;
                 COPY_STRING(nmsg.paramLabelData.name, cm->paramName[pi][l]);
-                msg_send(&gToUsbThread, &nmsg);
+                send_usb_command(&nmsg);
             }
         }
     }
@@ -672,7 +672,7 @@ static void apply_delete_undo(tUndoDeletePayload * p) {
         msg.cableData.linkType             = ce->linkType;
         msg.cableData.moduleToIndex        = ce->toIndex;
         msg.cableData.connectorToIoIndex   = ce->toIoCount;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     // Knob, global knob and MIDI CC assignments, put back on the modules that now exist again. AFTER
@@ -692,7 +692,7 @@ static void apply_delete_undo(tUndoDeletePayload * p) {
         };
         msg.knobAssignData.paramIndex       = knob.paramIndex;
         msg.knobAssignData.knobIndex        = knobIndex;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     for (uint32_t i = 0; i < p->globalKnobCount; i++) {
@@ -708,7 +708,7 @@ static void apply_delete_undo(tUndoDeletePayload * p) {
         msg.globalKnobAssignData.moduleIndex = knob.moduleIndex;
         msg.globalKnobAssignData.paramIndex  = knob.paramIndex;
         msg.globalKnobAssignData.knobIndex   = knobIndex;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     for (uint32_t i = 0; i < p->controllerCount; i++) {
@@ -733,7 +733,7 @@ static void apply_delete_undo(tUndoDeletePayload * p) {
         msg.midiCCAssignData.moduleKey                                    = key;
         msg.midiCCAssignData.paramIndex                                   = controller.paramIndex;
         msg.midiCCAssignData.midiCC                                       = controller.midiCC;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     update_module_up_rates();
@@ -756,6 +756,9 @@ static void apply_delete_redo(tUndoDeletePayload * p) {
 }
 
 static void apply_paste_undo(tUndoPastePayload * p) {
+    // As many commands as the paste was, so one window for them as well. See paste_snapshot().
+    send_batch_begin();
+
     for (uint32_t i = 0; i < p->pastedCount; i++) {
         tModule * mod = get_module(p->pastedKeys[i]);
 
@@ -779,6 +782,7 @@ static void apply_paste_undo(tUndoPastePayload * p) {
 
     selection_clear();
     update_module_up_rates();
+    send_batch_end();
     synthlib_request_redraw();
 }
 
@@ -881,7 +885,7 @@ static void apply_module_colour(tUndoModuleColourPayload * p, bool isUndo) {
     msg.slot                       = p->key.slot;
     msg.moduleColourData.moduleKey = p->key;
     msg.moduleColourData.colour    = module->colour;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -973,7 +977,7 @@ static void apply_midi_cc(tUndoMidiCcPayload * p, bool isUndo) {
 
     msg.cmd                   = eMsgCmdWritePatch;
     msg.slot                  = p->slot;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 
     synthlib_request_redraw();
 }
@@ -1039,7 +1043,7 @@ static void apply_global_knob(tUndoGlobalKnobPayload * p, bool isUndo) {
             msg.cmd                              = eMsgCmdDeassignGlobalKnob;
             msg.globalKnobDeassignData.knobIndex = i;
         }
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 
     synthlib_request_redraw();
@@ -1318,12 +1322,12 @@ static void apply_knob_entry(uint32_t slot, uint32_t idx, const tKnob * k) {
         };
         msg.knobAssignData.paramIndex = k->paramIndex;
         msg.knobAssignData.knobIndex  = idx;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     } else {
         msg.cmd                        = eMsgCmdDeassignKnob;
         msg.slot                       = slot;
         msg.knobDeassignData.knobIndex = idx;
-        msg_send(&gToUsbThread, &msg);
+        send_usb_command(&msg);
     }
 }
 
@@ -1372,7 +1376,7 @@ static void apply_module_name(tUndoModuleNamePayload * p, bool isUndo) {
     msg.slot                      = p->key.slot;
     msg.moduleLabelData.moduleKey = p->key;
     COPY_STRING(msg.moduleLabelData.name, name);
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -1422,7 +1426,7 @@ static void apply_param_name(tUndoParamNamePayload * p, bool isUndo) {
     msg.paramLabelData.moduleKey  = p->key;
     msg.paramLabelData.paramIndex = pi;
     COPY_STRING(msg.paramLabelData.name, set ? name : "");
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -1461,7 +1465,7 @@ static void apply_patch_descr(tUndoPatchDescrPayload * p, bool isUndo) {
     tMessageContent msg   = {0};
     msg.cmd  = eMsgCmdWritePatchDescr;
     msg.slot = p->slot;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -1515,7 +1519,7 @@ static void apply_patch_name(tUndoPatchNamePayload * p, bool isUndo) {
     msg.cmd  = eMsgCmdSetPatchName;
     msg.slot = p->slot;
     COPY_STRING(msg.patchName.name, name);
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -1540,7 +1544,7 @@ static void apply_perf_name(tUndoPerfNamePayload * p, bool isUndo) {
 
     COPY_STRING(gGlobalSettings.perfName, name);
     msg.cmd = eMsgCmdWritePerfName;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
     synthlib_request_redraw();
 }
 
@@ -0,0 +1,321 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "usbCoalesce.h"
+
+// See usbCoalesce.h for the rules.
+
+void usb_coalesce_init(tUsbCoalescer * stage) {
+    memset(stage, 0, sizeof(*stage));
+}
+
+bool usb_coalesce_mergeable(uint32_t cmd) {
+    switch (cmd) {
+        case eMsgCmdSetValue:
+        case eMsgCmdSetParamMorph:
+        case eMsgCmdSetCustomData:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+tUsbLane usb_coalesce_lane(uint32_t cmd) {
+    switch (cmd) {
+        case eMsgCmdSetValue:
+        case eMsgCmdSetParamMorph:
+        case eMsgCmdPlayNote:
+        case eMsgCmdSelectVariation:
+            return eUsbLaneRealtime;
+
+        case eMsgCmdBackupBank:
+        case eMsgCmdBackupSynthSettings:
+        case eMsgCmdBackupEverything:
+        case eMsgCmdRestoreBank:
+        case eMsgCmdRestoreEverything:
+            return eUsbLaneBulk;
+
+        default:
+            return eUsbLaneEdit;
+    }
+}
+
+static bool same_module(const tModuleKey * a, const tModuleKey * b) {
+    return (a->location == b->location) && (a->index == b->index);
+}
+
+// Whether b may replace a. Both are of a kind that merges.
+static bool same_target(const tMessageContent * a, const tMessageContent * b) {
+    if ((a->cmd != b->cmd) || (a->slot != b->slot)) {
+        return false;
+    }
+
+    switch (a->cmd) {
+        case eMsgCmdSetValue:
+        {
+            return same_module(&a->paramData.moduleKey, &b->paramData.moduleKey)
+                   && (a->paramData.param == b->paramData.param)
+                   && (a->paramData.variation == b->paramData.variation);
+        }
+        case eMsgCmdSetParamMorph:
+        {
+            return same_module(&a->paramMorphData.moduleKey, &b->paramMorphData.moduleKey)
+                   && (a->paramMorphData.param == b->paramMorphData.param)
+                   && (a->paramMorphData.paramMorph == b->paramMorphData.paramMorph)
+                   && (a->paramMorphData.variation == b->paramMorphData.variation);
+        }
+        case eMsgCmdSetCustomData:
+        {
+            return same_module(&a->customDataMsg.moduleKey, &b->customDataMsg.moduleKey);
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+bool usb_coalesce_push(tUsbCoalescer * stage, const tMessageContent * command) {
+    // Newest first, back to the first barrier: anything older than that is on the far side of it.
+    if (usb_coalesce_mergeable(command->cmd) == true) {
+        for (uint32_t back = 0; back < stage->count; back++) {
+            uint32_t          at     = (stage->head + stage->count - 1 - back) % USB_COALESCE_DEPTH;
+            tMessageContent * staged = &stage->command[at];
+
+            if (usb_coalesce_mergeable(staged->cmd) == false) {
+                break;
+            }
+
+            if (same_target(staged, command) == true) {
+                *staged = *command;
+                stage->merged++;
+                return true;
+            }
+        }
+    }
+
+    if (stage->count >= USB_COALESCE_DEPTH) {
+        return false;
+    }
+    stage->command[(stage->head + stage->count) % USB_COALESCE_DEPTH] = *command;
+    stage->count++;
+    return true;
+}
+
+bool usb_coalesce_pop(tUsbCoalescer * stage, tMessageContent * command) {
+    if (stage->count == 0) {
+        return false;
+    }
+    *command    = stage->command[stage->head];
+    stage->head = (stage->head + 1) % USB_COALESCE_DEPTH;
+    stage->count--;
+    return true;
+}
+
+// Moves commands from the queue onto the stage until the queue is empty or the stage is full.
+static void top_up(tUsbCoalescer * stage, tMessageQueue * queue) {
+    tMessageContent incoming = {0};
+
+    while (stage->count < USB_COALESCE_DEPTH) {
+        if (msg_receive(queue, eRcvPoll, &incoming) != EXIT_SUCCESS) {
+            break;
+        }
+        (void)usb_coalesce_push(stage, &incoming);    // cannot fail: there was room
+    }
+}
+
+bool usb_coalesce_receive(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command) {
+    top_up(stage, queue);
+    return usb_coalesce_pop(stage, command);
+}
+
+bool usb_coalesce_peek(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command) {
+    top_up(stage, queue);
+
+    if (stage->count == 0) {
+        return false;
+    }
+    *command = stage->command[stage->head];
+    return true;
+}
+
+// The module an edit is addressed to, or NULL if it is not addressed to one module.
+static const tModuleKey * edit_module(const tMessageContent * edit) {
+    switch (edit->cmd) {
+        case eMsgCmdSetMode:
+            return &edit->modeData.moduleKey;
+
+        case eMsgCmdWriteModule:
+        case eMsgCmdDeleteModule:
+        case eMsgCmdMoveModule:
+        case eMsgCmdSetModuleUpRate:
+            return &edit->moduleData.moduleKey;
+
+        case eMsgCmdSetModuleLabel:
+            return &edit->moduleLabelData.moduleKey;
+
+        case eMsgCmdSetModuleColour:
+            return &edit->moduleColourData.moduleKey;
+
+        case eMsgCmdSetMutationLock:
+            return &edit->moduleMutationLockData.moduleKey;
+
+        case eMsgCmdSetParamLabel:
+            return &edit->paramLabelData.moduleKey;
+
+        case eMsgCmdAssignKnob:
+            return &edit->knobAssignData.moduleKey;
+
+        case eMsgCmdAssignMidiCC:
+            return &edit->midiCCAssignData.moduleKey;
+
+        case eMsgCmdSetCustomData:
+            return &edit->customDataMsg.moduleKey;
+
+        default:
+            return NULL;
+    }
+}
+
+static bool is_cable_edit(uint32_t cmd) {
+    return (cmd == eMsgCmdWriteCable) || (cmd == eMsgCmdSetCableColour) || (cmd == eMsgCmdDeleteCable);
+}
+
+// Edits to one slot's patch as a whole rather than to a module in it.
+static bool is_slot_edit(uint32_t cmd) {
+    switch (cmd) {
+        case eMsgCmdWritePatch:
+        case eMsgCmdWritePatchDescr:
+        case eMsgCmdSetPatchName:
+        case eMsgCmdCopyVariation:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// The module a realtime command is addressed to, or NULL for a note or a variation select.
+static const tModuleKey * realtime_module(const tMessageContent * command) {
+    switch (command->cmd) {
+        case eMsgCmdSetValue:
+            return &command->paramData.moduleKey;
+
+        case eMsgCmdSetParamMorph:
+            return &command->paramMorphData.moduleKey;
+
+        default:
+            return NULL;
+    }
+}
+
+// Whether a realtime command must wait for an edit queued ahead of it. Anything not known to be
+// confined to one module, its cables or its slot's patch — a slot or mode switch, a file, a bank
+// job, the synth's settings — holds every realtime command behind it, as the one FIFO did. The rest
+// hold only what they could change the meaning of:
+//
+//   - a note, nothing: it carries no slot, and the G2 plays it on whatever is there;
+//   - a variation select, an edit to its slot's patch as a whole (a variation copied into it, say);
+//   - a value or a morph range, that and any edit to its module or to a cable at either end of one.
+static bool waits_for(const tMessageContent * edit, const tMessageContent * command) {
+    const tModuleKey * module = edit_module(edit);
+    const tModuleKey * target = realtime_module(command);
+
+    if ((module == NULL) && (is_cable_edit(edit->cmd) == false) && (is_slot_edit(edit->cmd) == false)) {
+        return true;
+    }
+
+    if ((command->cmd == eMsgCmdPlayNote) || (edit->slot != command->slot)) {
+        return false;
+    }
+
+    if (is_slot_edit(edit->cmd) == true) {
+        return true;
+    }
+
+    if (target == NULL) {
+        return false;
+    }
+
+    if (module != NULL) {
+        return same_module(module, target);
+    }
+    return (edit->cableData.location == target->location)
+           && ((edit->cableData.moduleFromIndex == target->index) || (edit->cableData.moduleToIndex == target->index));
+}
+
+// Takes the staged command `back` places behind the oldest out of the stage, closing the gap.
+static void take_at(tUsbCoalescer * stage, uint32_t back, tMessageContent * command) {
+    *command = stage->command[(stage->head + back) % USB_COALESCE_DEPTH];
+
+    for (uint32_t i = back; (i + 1) < stage->count; i++) {
+        stage->command[(stage->head + i) % USB_COALESCE_DEPTH] = stage->command[(stage->head + i + 1) % USB_COALESCE_DEPTH];
+    }
+    stage->count--;
+}
+
+bool usb_coalesce_receive_realtime(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command) {
+    bool inBatch = false;
+
+    top_up(stage, queue);
+
+    // The oldest realtime command that waits for nothing ahead of it. One inside a marked batch stays
+    // with the batch: its commands go out together or not at all.
+    for (uint32_t back = 0; back < stage->count; back++) {
+        const tMessageContent * staged = &stage->command[(stage->head + back) % USB_COALESCE_DEPTH];
+        bool                    free   = true;
+
+        if (staged->cmd == eMsgCmdBeginBatch) {
+            inBatch = true;
+        } else if (staged->cmd == eMsgCmdEndBatch) {
+            inBatch = false;
+        }
+
+        if ((inBatch == true) || (usb_coalesce_lane(staged->cmd) != eUsbLaneRealtime)) {
+            continue;
+        }
+
+        for (uint32_t ahead = 0; (ahead < back) && (free == true); ahead++) {
+            const tMessageContent * edit = &stage->command[(stage->head + ahead) % USB_COALESCE_DEPTH];
+
+            if ((usb_coalesce_lane(edit->cmd) != eUsbLaneRealtime) && (edit->cmd != eMsgCmdBeginBatch)
+                && (edit->cmd != eMsgCmdEndBatch)) {
+                free = (waits_for(edit, staged) == false);
+            }
+        }
+
+        if (free == true) {
+            take_at(stage, back, command);
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef __cplusplus
+}
+#endif
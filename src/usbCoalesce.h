@@ -0,0 +1,127 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __USB_COALESCE_H__
+#define __USB_COALESCE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+
+// THE USB THREAD'S COMMAND STAGE: where queued UI commands wait between gToUsbThread and the device,
+// and where a dial drag stops costing one USB round trip per mouse move.
+//
+// Dragging a dial posts an eMsgCmdSetValue for every move, and each one goes out as its own synchronous
+// transfer. Over a slow link the queue grows faster than it drains, and the G2 ends up hundreds of
+// milliseconds behind the cursor, playing back every intermediate value it was sent. Only the last of
+// them matters. So commands are read off the queue into this stage, and a value arriving for a
+// parameter that already has one waiting REPLACES it, in place, rather than queueing behind it.
+//
+// THE ORDERING RULES, which tools/coalesce.c checks:
+//
+//   - Only eMsgCmdSetValue, eMsgCmdSetParamMorph and eMsgCmdSetCustomData merge, and only with a
+//     waiting command of the same kind for the same target: slot, location, module, parameter and
+//     variation for a value; the same and the morph group for a morph range; slot, location and
+//     module for custom data.
+//   - Every other command is a barrier. Nothing merges across one, so whatever was sent before a
+//     structural change — a cable, a module, a variation select — still goes before it, and
+//     whatever after, after. The same parameter either side of a barrier is sent twice.
+//   - Commands that do not merge leave in the order they arrived. One that merges takes the place of
+//     the one it replaces: it may overtake values for OTHER parameters queued since, which is
+//     harmless, and never a barrier. The one exception is a bulk job's yield, below.
+//
+// Nothing is lost that would have been observable: the G2 ends up holding exactly what it would have
+// had the commands been sent one by one.
+//
+// One thread only — the USB thread in the application. The stage is bounded; a full one stops
+// taking from the queue, which then holds the rest as it always did.
+//
+// THE LANES. Every command belongs to one of three, by what waiting costs the person at the G2:
+//
+//   REALTIME   a value, a morph range, a note, a variation select — what a hand is doing right now,
+//              where a delay is heard.
+//   EDIT       everything else that changes the patch or the device: modules, cables, names, modes.
+//   BULK       a job of many round trips — backing up or restoring a bank, or everything — which
+//              would hold the queue for seconds or minutes.
+//
+// Normally the lanes change nothing: commands leave in the order they arrived. A bulk job, though,
+// runs on the USB thread with the queue behind it, and so yields between bank locations, taking what
+// it can from the REALTIME lane through usb_coalesce_receive_realtime() and sending it. A realtime
+// command may pass an edit queued before it only if it cannot depend on it: a value passes an edit to
+// another module or another slot, but not one to its own module, a cable to it, or its slot's patch as
+// a whole — a value for a module still being added waits for the module. An edit that is not confined
+// to one slot's patch, a bulk job, or an open batch holds everything behind it until the job is done,
+// exactly as the one FIFO did. The edits themselves wait for the job, in order.
+
+#define USB_COALESCE_DEPTH    (64U)
+
+typedef enum {
+    eUsbLaneRealtime = 0,
+    eUsbLaneEdit,
+    eUsbLaneBulk
+} tUsbLane;
+
+typedef struct {
+    tMessageContent command[USB_COALESCE_DEPTH];
+    uint32_t        head;      // next to leave
+    uint32_t        count;
+    uint64_t        merged;    // commands replaced by a later one for the same target, ever
+} tUsbCoalescer;
+
+void usb_coalesce_init(tUsbCoalescer * stage);
+
+// Whether cmd is one of the kinds that merge.
+bool usb_coalesce_mergeable(uint32_t cmd);
+
+// The lane cmd travels in.
+tUsbLane usb_coalesce_lane(uint32_t cmd);
+
+// Stages a command, merging it if the rules allow. Returns false, staging nothing, only if it does not
+// merge and the stage is full.
+bool usb_coalesce_push(tUsbCoalescer * stage, const tMessageContent * command);
+
+// The oldest staged command. Returns false if there is none.
+bool usb_coalesce_pop(tUsbCoalescer * stage, tMessageContent * command);
+
+// Moves commands from the queue onto the stage until the queue is empty or the stage is full, then
+// takes the oldest off it. Returns false if there was nothing at all.
+bool usb_coalesce_receive(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command);
+
+// As usb_coalesce_receive(), but leaves the oldest where it is: the next receive returns the same
+// command, or a later value that has since merged into it.
+bool usb_coalesce_peek(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command);
+
+// As usb_coalesce_receive(), but takes only the oldest REALTIME command that depends on no edit still
+// staged ahead of it, as above; returns false if there is none. What a bulk job calls between its
+// round trips.
+bool usb_coalesce_receive_realtime(tUsbCoalescer * stage, tMessageQueue * queue, tMessageContent * command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __USB_COALESCE_H__
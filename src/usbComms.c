@@ -37,6 +37,7 @@ extern "C" {
 #include "defs.h"
 #include "synthlibDefs.h"
 #include "usbLog.h"
+#include "rtLog.h"
 #include "types.h"
 #include <libusb.h>
 #include "utils.h"
@@ -44,12 +45,16 @@ extern "C" {
 #include "protocol.h"
 #include "deviceSync.h"
 #include "usbComms.h"
+#include "usbCoalesce.h"
+#include "usbTransport.h"
+#include "indicatorPlan.h"
 #include "dataBase.h"
 #include "moduleResourcesAccess.h"
 #include "globalVars.h"
 #include "paramPages.h"
 #include "graphics.h"      // set_patch_name_from_filename / write_database_to_file (extern "C")
 #include "mouseHandle.h"   // init_patch (extern "C")
+#include "soundEngine.h"   // sound_engine_lane_edited()
 #include <stdatomic.h>
 #include <pthread.h>
 
@@ -59,10 +64,21 @@ extern "C" {
 // USB transfer timeouts (milliseconds)
 #define USB_SEND_TIMEOUT_MS         (50)
 #define USB_RECV_POLL_MS            (50)   // ePollYes idle poll — timeout is expected and normal
+#define USB_IDLE_WAIT_MS            (1000) // idle sleep; inbound data or a queued command ends it sooner
 #define USB_RECV_ACK_MS             (500)  // simple command acknowledgment (SUB_RESPONSE_OK)
 #define USB_RECV_DATA_MS            (3000) // data response — may be large or slow to prepare
 #define USB_KEEPALIVE_INTERVAL_S    (2)    // macOS suspends USB after ~3s idle; keep well inside that
 
+// How long one stop/start window may stay open (see send_batch_window()). An unmarked burst gets the
+// short one; a batch the UI marked as one edit, the long one.
+#define USB_BATCH_WINDOW_MS         (250)
+#define USB_BATCH_MARKED_MS         (2000)
+
+// How long after losing the G2 a reconnect may still trust what was pulled before (see
+// warm_snapshot_take()). Long enough for a glitch, a hub reset or the Mac's USB suspend; short enough
+// that someone who unplugged to play the synth on its own and tweaked it gets a full pull.
+#define USB_WARM_RECONNECT_MS       (30000)
+
 // Atomic flags for cross-thread signalling
 static _Atomic bool gotBadConnectionIndication            = false;
 static _Atomic bool gotPatchChangeIndication[MAX_SLOTS]   = {0};
@@ -95,7 +111,7 @@ static uint8_t * ensure_bank_scratch_buffer(uint8_t ** buffer) {
         *buffer = (uint8_t *)malloc(PATCH_FILE_SIZE);
 
         if (*buffer == NULL) {
-            LOG_ERROR("Failed to allocate %d-byte bank scratch buffer\n", PATCH_FILE_SIZE);
+            RT_LOG_ERROR("Failed to allocate %d-byte bank scratch buffer\n", PATCH_FILE_SIZE);
         }
     }
     return *buffer;
@@ -129,6 +145,11 @@ static pthread_t              usbThread                   = NULL;
 static libusb_context *       libUsbCtx                   = NULL;
 static libusb_device_handle * devHandle                   = NULL;
 
+// The device in place of libusb, if any — see usbComms.h. Set before the thread starts; whether it is
+// open is protected by usbStaticMutex, as devHandle is.
+static const tUsbStandIn *    gStandIn                    = NULL;
+static bool                   gStandInOpen                = false;
+
 // Callback pointers protected by callbackMutex
 static void                   (*wake_glfw_func_ptr)(void) = NULL;
 static void                   (*full_patch_change_notify_func_ptr)(void) = NULL;
@@ -140,6 +161,63 @@ static pthread_mutex_t        callbackMutex               = PTHREAD_MUTEX_INITIA
 // Keepalive: timestamp of the last successful inbound or outbound USB transfer
 static time_t                 gLastActivityTime           = 0;
 
+// UI commands on their way to the device, with a drag's superseded values merged away — see
+// usbCoalesce.h. USB thread only; the count is published for anyone who asks.
+static tUsbCoalescer          gCommandStage               = {0};
+static _Atomic uint64_t       gCoalescedCommands          = 0;
+
+// Stop/start windows opened, and the device commands sent inside them — see send_batch_window(). The
+// difference is how many pauses of the G2 batching saved.
+static _Atomic uint64_t       gBatchWindows               = 0;
+static _Atomic uint64_t       gBatchedCommands            = 0;
+
+// Realtime commands sent from inside a bulk job rather than after it — see serve_realtime_lane().
+static _Atomic uint64_t       gRealtimeInBulk             = 0;
+
+// Every transfer to and from the device — see usbTransport.h. Started per connection.
+static tUsbTransport          gTransport;
+
+// WARM RECONNECT. What a reconnect needs to know to skip pulling a slot again: the patch version the
+// G2 reported for it and a CRC of the slot as the editor held it when the link went, with its name.
+// The slot itself stays in the module database — a disconnect clears nothing. This is a snapshot held
+// in memory, not a cache on disk: it is taken when the link goes and used up by the next connect, and
+// a restart of the editor always pulls cold. A cache on disk would save a restart nothing, as the
+// patch dump it would stand in for is read again anyway, to check the values (see warm_slots()). See
+// warm_snapshot_take() and send_init_sequence_pull().
+// USB thread only, apart from the two published results.
+typedef struct {
+    bool     valid;
+    uint8_t  version;
+    uint16_t crc;
+    char     name[CLAVIA_NAME_SIZE + 1];
+} tWarmSlot;
+
+// What parse_performance_settings() wrote, kept so a warm reconnect can put it back without asking.
+typedef struct {
+    bool    valid;
+    uint8_t version;
+    char    perfName[CLAVIA_NAME_SIZE + 1];
+    uint8_t selectedSlot;
+    uint8_t masterClock;
+    uint8_t masterClockRunning;
+    struct {
+        char    patchName[CLAVIA_NAME_SIZE + 1];
+        uint8_t enabled;
+        uint8_t keyboardEnabled;
+        uint8_t holdEnabled;
+        uint8_t rangeLower;
+        uint8_t rangeUpper;
+    } slot[MAX_SLOTS];
+} tWarmPerf;
+
+static bool                   gSlotInStep[MAX_SLOTS]      = {0};   // pulled whole, and only edited in step since
+static tWarmSlot              gWarmSlot[MAX_SLOTS]        = {0};
+static tWarmPerf              gWarmPerf                   = {0};
+static uint64_t               gWarmTakenMs                = 0;
+static uint64_t               gOpenedMs                   = 0;
+static _Atomic uint32_t       gLastConnectMs              = 0;
+static _Atomic uint32_t       gLastWarmSlots              = 0;
+
 // ---------------------------------------------------------------------------
 // Callback registration
 // ---------------------------------------------------------------------------
@@ -164,7 +242,7 @@ static void call_wake_glfw(void) {
     pthread_mutex_unlock(&callbackMutex);
 
     if (func_ptr == NULL) {
-        LOG_ERROR("Wake GLFW callback not registered\n");
+        RT_LOG_ERROR("Wake GLFW callback not registered\n");
         exit(1);
     }
     func_ptr();
@@ -178,7 +256,7 @@ static void call_full_patch_change_notify(void) {
     pthread_mutex_unlock(&callbackMutex);
 
     if (func_ptr == NULL) {
-        LOG_ERROR("Full patch change callback not registered\n");
+        RT_LOG_ERROR("Full patch change callback not registered\n");
         exit(1);
     }
     func_ptr();
@@ -189,6 +267,126 @@ static void call_full_patch_change_notify(void) {
 static void post_alert_response(const char * title, const char * message);
 static void post_response(uint32_t responseType); // bare signal (payload-less); peek data stays in globals
 
+// Bank backup and restore yield to the realtime lane between locations — see serve_realtime_lane(),
+// defined with the command dispatch it uses.
+static void serve_realtime_lane(void);
+
+// ---------------------------------------------------------------------------
+// Transfers — the libusb backend for usbTransport.c
+// ---------------------------------------------------------------------------
+
+// The transport keeps USB_TRANSPORT_IN_DEPTH reads submitted on both IN endpoints and a few
+// preallocated transfers for sending, and runs libusb's event loop on a thread of its own; see
+// usbTransport.h. It is started when the device is opened and stopped before it is closed. This is
+// the glue: libusb transfers for its slots, and libusb's results mapped the way the callers below
+// have always checked them.
+
+static int libusb_transfer_result(enum libusb_transfer_status status) {
+    switch (status) {
+        case LIBUSB_TRANSFER_COMPLETED: return LIBUSB_SUCCESS;
+
+        case LIBUSB_TRANSFER_CANCELLED: return LIBUSB_ERROR_TIMEOUT;
+
+        case LIBUSB_TRANSFER_TIMED_OUT: return LIBUSB_ERROR_TIMEOUT;
+
+        case LIBUSB_TRANSFER_STALL:     return LIBUSB_ERROR_PIPE;
+
+        case LIBUSB_TRANSFER_NO_DEVICE: return LIBUSB_ERROR_NO_DEVICE;
+
+        case LIBUSB_TRANSFER_OVERFLOW:  return LIBUSB_ERROR_OVERFLOW;
+
+        default:                         return LIBUSB_ERROR_IO;
+    }
+}
+
+static void LIBUSB_CALL usb_transfer_cb(struct libusb_transfer * xfer) {
+    usb_transport_completed((tUsbTransfer *)xfer->user_data, libusb_transfer_result(xfer->status), xfer->actual_length);
+}
+
+static bool libusb_backend_alloc(void * ctx, tUsbTransfer * transfer) {
+    struct libusb_transfer * xfer = libusb_alloc_transfer(0);
+
+    if (xfer == NULL) {
+        return false;
+    }
+    // No per-transfer timeout: a read waits for as long as the device has nothing to say, and a send
+    // is timed, and cancelled, by the transport.
+    libusb_fill_bulk_transfer(xfer, (libusb_device_handle *)ctx, transfer->endpoint, transfer->buffer,
+                              transfer->size, usb_transfer_cb, transfer, 0);
+    transfer->handle = xfer;
+    return true;
+}
+
+static void libusb_backend_release(void * ctx, tUsbTransfer * transfer) {
+    libusb_free_transfer((struct libusb_transfer *)transfer->handle);
+    transfer->handle = NULL;
+}
+
+static int libusb_backend_submit(void * ctx, tUsbTransfer * transfer) {
+    struct libusb_transfer * xfer = (struct libusb_transfer *)transfer->handle;
+
+    xfer->endpoint = transfer->endpoint;
+    xfer->length   = transfer->length;
+    return libusb_submit_transfer(xfer);
+}
+
+static void libusb_backend_cancel(void * ctx, tUsbTransfer * transfer) {
+    (void)libusb_cancel_transfer((struct libusb_transfer *)transfer->handle);
+}
+
+static void libusb_backend_handle_events(void * ctx, uint32_t timeoutMs) {
+    struct timeval tv = {0, (int)(timeoutMs * 1000U)};
+
+    (void)libusb_handle_events_timeout_completed(libUsbCtx, &tv, NULL);
+}
+
+static void libusb_backend_interrupt(void * ctx) {
+    libusb_interrupt_event_handler(libUsbCtx);
+}
+
+static const tUsbBackend gLibusbBackend = {
+    libusb_backend_alloc,
+    libusb_backend_release,
+    libusb_backend_submit,
+    libusb_backend_cancel,
+    libusb_backend_handle_events,
+    libusb_backend_interrupt,
+};
+
+// Starts the transport on a freshly opened device — a libusb handle, or a stand-in's ctx: the interrupt
+// endpoint's 16-byte messages and the bulk endpoint's extended ones, and sends on endpoint 3.
+static bool start_transport(const tUsbBackend * backend, void * ctx) {
+    static const uint8_t inEndpoints[] = {0x81, 0x82};
+    static const int     inSizes[]     = {INTERRUPT_MESSAGE_SIZE, EXTENDED_MESSAGE_SIZE};
+
+    return usb_transport_start(&gTransport, backend, ctx, inEndpoints, inSizes, 2, SEND_MESSAGE_SIZE);
+}
+
+// One send or one read, through the transport, with libusb's result codes. A read takes the oldest
+// message already up from the device, or waits up to timeout_ms for one.
+static int usb_transfer_sync(uint8_t endpoint, uint8_t * buffer, int length, int * actual_length,
+                             unsigned int timeout_ms) {
+    int result = USB_TRANSPORT_OK;
+
+    if ((endpoint & 0x80) != 0) {
+        result = usb_transport_receive(&gTransport, endpoint, buffer, length, actual_length, timeout_ms);
+    } else {
+        result = usb_transport_send(&gTransport, endpoint, buffer, length, actual_length, timeout_ms);
+    }
+
+    switch (result) {
+        case USB_TRANSPORT_OK:      return LIBUSB_SUCCESS;
+
+        case USB_TRANSPORT_TIMEOUT: return LIBUSB_ERROR_TIMEOUT;
+
+        case USB_TRANSPORT_CLOSED:  return LIBUSB_ERROR_NO_DEVICE;
+
+        case USB_TRANSPORT_BUSY:    return LIBUSB_ERROR_OTHER;
+
+        default:                    return result;    // libusb's own
+    }
+}
+
 // ---------------------------------------------------------------------------
 // libusb helpers
 // ---------------------------------------------------------------------------
@@ -201,15 +399,46 @@ static bool is_disconnect_error(int err) {
            || err == LIBUSB_ERROR_PIPE;
 }
 
+// Whether there is a device to talk to. With usbStaticMutex held.
+static bool device_is_open(void) {
+    return (devHandle != NULL) || gStandInOpen;
+}
+
 // Must be called with usbStaticMutex held, or from a context where devHandle
 // is not yet shared (e.g. open_and_claim_device on failure path).
 static void close_device(void) {
-    if (devHandle != NULL) {
-        libusb_release_interface(devHandle, 0);
-        libusb_close(devHandle);
-        devHandle = NULL;
-        LOG_DEBUG("Device closed\n");
+    if (device_is_open()) {
+        // Every transfer is on this handle, so they all go first.
+        if (usb_transport_stop(&gTransport) == false) {
+            RT_LOG_ERROR("Transfers still in flight at close — leaking them\n");
+        }
+
+        if (gStandIn != NULL) {
+            gStandIn->close(gStandIn->ctx);
+            gStandInOpen = false;
+        } else {
+            libusb_release_interface(devHandle, 0);
+            libusb_close(devHandle);
+            devHandle = NULL;
+        }
+        RT_LOG_DEBUG("Device closed\n");
+    }
+}
+
+// A stand-in has no interface to claim or reset: open it and start the transport on it.
+static bool open_stand_in(void) {
+    if (gStandIn->open(gStandIn->ctx) == false) {
+        return false;  // Nothing to open — normal while searching
     }
+    gStandInOpen = true;
+
+    if (start_transport(gStandIn->backend, gStandIn->ctx) == false) {
+        RT_LOG_ERROR("Failed to start the USB transport\n");
+        close_device();
+        return false;
+    }
+    RT_LOG_DEBUG("Stand-in device opened\n");
+    return true;
 }
 
 // Opens the G2 and claims interface 0. Returns true on success.
@@ -218,6 +447,9 @@ static void close_device(void) {
 // the bulk endpoint DATA0/DATA1 toggle bits — without it the host and device
 // can be out of phase after a reconnect, causing all transfers to time out.
 static bool open_and_claim_device(void) {
+    if (gStandIn != NULL) {
+        return open_stand_in();
+    }
     devHandle = libusb_open_device_with_vid_pid(libUsbCtx, VENDOR_ID, PRODUCT_ID);
 
     if (devHandle == NULL) {
@@ -226,119 +458,25 @@ static bool open_and_claim_device(void) {
     int result = libusb_claim_interface(devHandle, 0);
 
     if (result != LIBUSB_SUCCESS) {
-        LOG_ERROR("Failed to claim interface: %s\n", libusb_error_name(result));
+        RT_LOG_ERROR("Failed to claim interface: %s\n", libusb_error_name(result));
         close_device();
         return false;
     }
     result    = libusb_reset_device(devHandle);
 
     if (result != LIBUSB_SUCCESS) {
-        LOG_ERROR("Failed to reset device: %s\n", libusb_error_name(result));
+        RT_LOG_ERROR("Failed to reset device: %s\n", libusb_error_name(result));
         close_device();
         return false;
     }
-    LOG_DEBUG("Device opened and interface claimed\n");
-    return true;
-}
-
-// ---------------------------------------------------------------------------
-// Async-backed synchronous transfer — replaces libusb_bulk_transfer.
-// Drives the libusb event loop in 50ms slices so the wall-clock timeout is
-// reliable even when the macOS IOKit backend ignores per-transfer timeouts.
-// ---------------------------------------------------------------------------
-
-static void LIBUSB_CALL usb_transfer_cb(struct libusb_transfer * xfer) {
-    int * completed = (int *)xfer->user_data;
-
-    *completed = 1;
-}
-
-static int usb_bulk_transfer_sync(libusb_device_handle * handle, uint8_t endpoint,
-                                  uint8_t * buffer, int length, int * actual_length,
-                                  unsigned int timeout_ms) {
-    struct libusb_transfer * xfer      = NULL;
-    int                      completed = 0;
-    int                      r         = LIBUSB_SUCCESS;
-    struct timeval           tv        = {0, 50 * 1000};
-    struct timespec          start     = {0};
-    struct timespec          now       = {0};
-    int                      status    = LIBUSB_TRANSFER_ERROR;
-
-    *actual_length = 0;
-
-    xfer           = libusb_alloc_transfer(0);
-
-    if (xfer == NULL) {
-        return LIBUSB_ERROR_NO_MEM;
-    }
-    libusb_fill_bulk_transfer(xfer, handle, endpoint, buffer, length,
-                              usb_transfer_cb, &completed, 0);
-
-    r              = libusb_submit_transfer(xfer);
-
-    if (r != LIBUSB_SUCCESS) {
-        libusb_free_transfer(xfer);
-        return r;
-    }
-    clock_gettime(CLOCK_MONOTONIC, &start);
-
-    while (!completed) {
-        clock_gettime(CLOCK_MONOTONIC, &now);
-        long elapsed_ms = (now.tv_sec - start.tv_sec) * 1000L
-                          + (now.tv_nsec - start.tv_nsec) / 1000000L;
-
-        if ((unsigned int)elapsed_ms >= timeout_ms) {
-            break;
-        }
-        r = libusb_handle_events_timeout_completed(libUsbCtx, &tv, &completed);
-
-        if (r != LIBUSB_SUCCESS) {
-            break;
-        }
-    }
-
-    if (!completed) {
-        libusb_cancel_transfer(xfer);
-        clock_gettime(CLOCK_MONOTONIC, &start);
-
-        while (!completed) {
-            clock_gettime(CLOCK_MONOTONIC, &now);
-            long drain_ms = (now.tv_sec - start.tv_sec) * 1000L
-                            + (now.tv_nsec - start.tv_nsec) / 1000000L;
-
-            if (drain_ms >= 500L) {
-                LOG_ERROR("Cancel drain timed out — leaking transfer\n");
-                *actual_length = 0;
-                return LIBUSB_ERROR_IO;
-            }
-            r = libusb_handle_events_timeout_completed(libUsbCtx, &tv, &completed);
-
-            if (r != LIBUSB_SUCCESS) {
-                LOG_ERROR("Event loop error during cancel drain: %s\n", libusb_error_name(r));
-                *actual_length = 0;
-                return LIBUSB_ERROR_IO;
-            }
-        }
-    }
-    *actual_length = xfer->actual_length;
-    status         = xfer->status;
-    libusb_free_transfer(xfer);
-
-    switch (status) {
-        case LIBUSB_TRANSFER_COMPLETED: return LIBUSB_SUCCESS;
-
-        case LIBUSB_TRANSFER_CANCELLED: return LIBUSB_ERROR_TIMEOUT;
-
-        case LIBUSB_TRANSFER_TIMED_OUT: return LIBUSB_ERROR_TIMEOUT;
-
-        case LIBUSB_TRANSFER_STALL:     return LIBUSB_ERROR_PIPE;
 
-        case LIBUSB_TRANSFER_NO_DEVICE: return LIBUSB_ERROR_NO_DEVICE;
-
-        case LIBUSB_TRANSFER_OVERFLOW:  return LIBUSB_ERROR_OVERFLOW;
-
-        default:                         return LIBUSB_ERROR_IO;
+    if (start_transport(&gLibusbBackend, devHandle) == false) {
+        RT_LOG_ERROR("Failed to start the USB transport\n");
+        close_device();
+        return false;
     }
+    RT_LOG_DEBUG("Device opened and interface claimed\n");
+    return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -364,12 +502,13 @@ static void parse_param_change(uint32_t slot, uint8_t * buff, int length) {
     if (module != NULL) {
         if (variation < NUM_VARIATIONS_USB && param < MAX_NUM_PARAMETERS) {
             module->param[variation][param].value = value;
+            sound_engine_lane_edited(slot, variation);
         } else {
-            LOG_ERROR("parse_param_change: out-of-range variation=%u param=%u from G2\n", variation, param);
+            RT_LOG_ERROR("parse_param_change: out-of-range variation=%u param=%u from G2\n", variation, param);
         }
     }
-    LOG_DEBUG("Param change - module %u:%u param=%u value=%u\n",
-              key.location, key.index, param, value);
+    RT_LOG_DEBUG("Param change - module %u:%u param=%u value=%u\n",
+                 key.location, key.index, param, value);
 
     // The Parameter Pages panel is a live readout of whichever params its page's knobs are
     // assigned to, and turning one of those knobs on the G2 itself arrives here - so it needs a
@@ -381,61 +520,31 @@ static void parse_param_change(uint32_t slot, uint8_t * buff, int length) {
     }
 }
 
-static void parse_volume_indicator(uint32_t slot, uint8_t * buff, uint32_t * bitPos) {
-    int volumesToRead = 0;
+// Volume (meter) data, sub-command 0x3a: after a start index, one 16-bit entry per meter, low byte
+// first, for every module that has meters, in the order indicatorPlan.h describes — and one more per
+// multi-bit LED group. A MULTI-BIT LED GROUP TAKES ONE ENTRY OUT OF THIS STREAM, not one 2-bit value
+// per LED out of the 0x39 one. 8Counter, BinCounter, ADConv, the three Mux modules and FlipFlop are
+// all of this shape: several LEDs driven by a single value whose BITS are the LEDs. Consuming them
+// from the other stream cost the modules after them eight slots each, which is why LEDs looked right
+// until a patch contained one.
+//
+// Which entry is whose is the slot's decode plan, built when its modules last changed; this only runs
+// it. A message shorter than the plan leaves the meters past its end as they were, where walking the
+// modules used to read on past it into whatever the buffer held.
+static void parse_volume_indicator(uint32_t slot, uint8_t * buff, uint32_t * bitPos, int length) {
+    const tIndicatorPlan * plan      = indicator_plan_for_slot(slot);
+    uint32_t               dataStart = 0;
+    uint32_t               dataBytes = 0;
 
     read_bit_stream(buff, bitPos, 8);  // start_idx (always 0 in practice)
+    dataStart = BIT_TO_BYTE(*bitPos);
 
-    for (int32_t location = 1; location >= 0; location--) {
-        for (int k = 0; k < MAX_NUM_MODULES; k++) {
-            tModuleKey key    = {slot, (uint32_t)location, (uint32_t)k};
-            tModule *  module = get_module(key);
-
-            if (module != NULL) {
-                switch (gModuleProperties[module->type].volumeType) {
-                    case volumeTypeMono:
-                    case volumeTypeCompress:
-                    case volumeTypeSequencer:
-                        volumesToRead = 1;
-                        break;
-                    case volumeTypeStereo:
-                        volumesToRead = 2;
-                        break;
-                    case volumeTypeQuad:
-                        volumesToRead = 4;
-                        break;
-                    case volumeTypeNone:
-                        volumesToRead = 0;
-                        break;
-                }
-
-                for (int i = 0; i < volumesToRead; i++) {
-                    module->volume.value[i] = read_bit_stream(buff, bitPos, 8);
-                    read_bit_stream(buff, bitPos, 8);  // hi byte: unused
-                }
+    if (length > (int)(dataStart + CRC_BYTES)) {
+        dataBytes = (uint32_t)length - dataStart - CRC_BYTES;
+    }
 
-                // A MULTI-BIT LED GROUP TAKES ONE ENTRY OUT OF THIS STREAM, not one 2-bit value per
-                // LED out of the 0x39 one. 8Counter, BinCounter, ADConv, the three Mux modules and
-                // FlipFlop are all of this shape: several LEDs driven by a single value whose BITS
-                // are the LEDs. Consuming them from the other stream cost the modules after them
-                // eight slots each, which is why LEDs looked right until a patch contained one.
-                uint32_t multiBitLeds = module_multibit_led_count(module->type);
-
-                if (multiBitLeds > 0) {
-                    uint32_t value = read_bit_stream(buff, bitPos, 8);
-
-                    value |= read_bit_stream(buff, bitPos, 8) << 8;
-
-                    // The two top flag bits say the value IS a bit set; the reference only spreads it
-                    // a bit at a time when both are present (and only for groups under twelve LEDs,
-                    // which all of these are). Anything else is some other encoding we have not had
-                    // to decode, so show nothing rather than show nonsense.
-                    for (uint32_t l = 0; (l < multiBitLeds) && (l < MAX_LEDS_PER_MODULE); l++) {
-                        module->led.value[l] = ((value & 0x3000) == 0x3000) ? ((value >> l) & 1) : 0;
-                    }
-                }
-            }
-        }
+    if (plan != NULL) {
+        indicator_plan_decode_meters(plan, &buff[dataStart], dataBytes);
     }
 }
 
@@ -463,50 +572,21 @@ static void parse_volume_indicator(uint32_t slot, uint8_t * buff, uint32_t * bit
 // 40 is the whole index space for both areas together and a patch with more LEDs than that has the
 // surplus unreported by the instrument. A message therefore covers startIndex..LED_STREAM_SIZE-1 —
 // it is NOT startIndex + 40.
+//
+// Which index is whose LED is the slot's decode plan — see indicatorPlan.h — built when its modules
+// last changed rather than found by walking them for every message.
 static void parse_led_data(uint32_t slot, uint8_t * buff, uint32_t * bitPos, int length) {
-    uint32_t startIndex         = read_bit_stream(buff, bitPos, 8);
-    uint32_t ledCount           = 0;
-    uint32_t ledCountFromModule = 0;
-    uint32_t dataStart          = BIT_TO_BYTE(*bitPos);
-    uint32_t dataBytes          = 0;
+    const tIndicatorPlan * plan       = indicator_plan_for_slot(slot);
+    uint32_t               startIndex = read_bit_stream(buff, bitPos, 8);
+    uint32_t               dataStart  = BIT_TO_BYTE(*bitPos);
+    uint32_t               dataBytes  = 0;
 
     if (length > (int)(dataStart + CRC_BYTES)) {
         dataBytes = (uint32_t)length - dataStart - CRC_BYTES;
     }
 
-    for (int32_t location = 1; location >= 0; location--) {
-        for (int k = 0; k < MAX_NUM_MODULES; k++) {
-            tModuleKey key    = {slot, (uint32_t)location, (uint32_t)k};
-            tModule *  module = get_module(key);
-
-            if (module != NULL) {
-                ledCountFromModule = module_led_count(module->type);
-
-                if (ledCountFromModule > MAX_LEDS_PER_MODULE) {
-                    // The module still consumes all of its indices, so the ones after it stay in
-                    // step; only the surplus is dropped. Not exit(1): that took the editor down in
-                    // Release too, and said nothing on the way out (LOG_DEBUG is compiled out there).
-                    LOG_ERROR("Module type %u has %u LEDs, MAX_LEDS_PER_MODULE is %u — storing the first %u\n",
-                              module->type, ledCountFromModule, MAX_LEDS_PER_MODULE, MAX_LEDS_PER_MODULE);
-                    EXIT_IN_DEBUG();
-                }
-
-                for (uint32_t l = 0; l < ledCountFromModule; l++) {
-                    if ((ledCount >= startIndex) && (ledCount < LED_STREAM_SIZE)) {
-                        uint32_t offset = ledCount - startIndex;
-
-                        if ((offset / 4) < dataBytes) {
-                            uint32_t ledValue = (buff[dataStart + (offset / 4)] >> ((offset % 4) * 2)) & 0x3;
-
-                            if (l < MAX_LEDS_PER_MODULE) {
-                                module->led.value[l] = ledValue;
-                            }
-                        }
-                    }
-                    ledCount++;
-                }
-            }
-        }
+    if (plan != NULL) {
+        indicator_plan_decode_leds(plan, startIndex, &buff[dataStart], dataBytes);
     }
 }
 
@@ -529,10 +609,10 @@ static int parse_resources_used(uint32_t slot, uint8_t * buff, uint32_t * bitPos
     float    cyclesLoad = 0.0f;
     float    memLoad    = 0.0f;
 
-    LOG_DEBUG("Got resources in use slot %u\n", slot);
+    RT_LOG_DEBUG("Got resources in use slot %u\n", slot);
 
     if (*bitPos < 8) {
-        LOG_ERROR("Resources used: bitPos underflow (%u)\n", *bitPos);
+        RT_LOG_ERROR("Resources used: bitPos underflow (%u)\n", *bitPos);
         return EXIT_FAILURE;
     }
     *bitPos -= 8; // Multiple messages in here, so need to move back a byte to process each sub response
@@ -590,14 +670,14 @@ static void parse_global_page(uint8_t * buff, uint32_t * bitPos) {
 
     globalPage  = read_bit_stream(buff, bitPos, 8);
     gGlobalPage = globalPage;
-    LOG_DEBUG("%u Got global page Page=%u Pos=%u\n", count++, globalPage / 3, globalPage % 3);
+    RT_LOG_DEBUG("%u Got global page Page=%u Pos=%u\n", count++, globalPage / 3, globalPage % 3);
 }
 
 static void parse_patch_version_change(uint8_t * buff, uint32_t * bitPos) {
     uint8_t changedSlot = read_bit_stream(buff, bitPos, 8);
     uint8_t newVersion  = read_bit_stream(buff, bitPos, 8);
 
-    LOG_DEBUG("Patch version change: slot %u new version 0x%02x\n", changedSlot, newVersion);
+    RT_LOG_DEBUG("Patch version change: slot %u new version 0x%02x\n", changedSlot, newVersion);
 
     if (changedSlot < MAX_SLOTS) {
         if (newVersion != gGlobalSettings.slot[changedSlot].patchVersion) {
@@ -608,18 +688,18 @@ static void parse_patch_version_change(uint8_t * buff, uint32_t * bitPos) {
 }
 
 static void parse_slot_selection(uint8_t * buff, uint32_t * bitPos) {
-    LOG_DEBUG("Got slot selection dump\n");
+    RT_LOG_DEBUG("Got slot selection dump\n");
     read_bit_stream(buff, bitPos, 4);  // 4 padding bits (always 0)
 
     for (uint32_t i = 0; i < MAX_SLOTS; i++) {
         uint8_t status = (uint8_t)read_bit_stream(buff, bitPos, 1);
         gGlobalSettings.slot[i].enabled = status;
-        LOG_DEBUG("  Slot %u enabled: %u\n", i, status != 0 ? 1 : 0);
+        RT_LOG_DEBUG("  Slot %u enabled: %u\n", i, status != 0 ? 1 : 0);
     }
 }
 
 static void parse_assigned_voices(uint8_t * buff, uint32_t * bitPos) {
-    LOG_DEBUG("Got assigned voices response\n");
+    RT_LOG_DEBUG("Got assigned voices response\n");
 
     for (int i = 0; i < MAX_SLOTS; i++) {
         gAssignedVoices[i] = read_bit_stream(buff, bitPos, 8);  // TODO - might have to set target assigned voices to lower number, before attempting increase?
@@ -631,25 +711,25 @@ static void parse_master_clock(uint8_t * buff, uint32_t * bitPos) {
     uint8_t running = 0;
     uint8_t type    = 0;
 
-    LOG_DEBUG("Got master clock\n");
+    RT_LOG_DEBUG("Got master clock\n");
     read_bit_stream(buff, bitPos, 8);  // 0xff - not sure what this is, or if it ever changes
     type = read_bit_stream(buff, bitPos, 8);
 
     if (type == 1) {
         clock                       = read_bit_stream(buff, bitPos, 8);
         gGlobalSettings.masterClock = clock;
-        LOG_DEBUG_DIRECT("Master clock = %u\n", clock);
+        RT_LOG_DEBUG_DIRECT("Master clock = %u\n", clock);
     } else if (type == 0) {
         running                            = read_bit_stream(buff, bitPos, 8);
         gGlobalSettings.masterClockRunning = running;
-        LOG_DEBUG_DIRECT("Clock running = %u\n", running);
+        RT_LOG_DEBUG_DIRECT("Clock running = %u\n", running);
     }
 }
 
 static void parse_select_slot(uint8_t * buff, uint32_t * bitPos) {
     uint32_t newSlot = read_bit_stream(buff, bitPos, 8);
 
-    LOG_DEBUG("Got slot select %u\n", newSlot);
+    RT_LOG_DEBUG("Got slot select %u\n", newSlot);
 
     gSlot                 = newSlot;
     gPatchParamsEdit.slot = newSlot;
@@ -662,14 +742,14 @@ static void parse_select_slot(uint8_t * buff, uint32_t * bitPos) {
 static int parse_get_patch_name(uint32_t slot, uint8_t * buff, uint32_t * bitPos, int length) {
     int nameBytes = length - 6;
 
-    LOG_DEBUG("Got patch name (length %d)\n", length);
+    RT_LOG_DEBUG("Got patch name (length %d)\n", length);
 
     if ((nameBytes < 0) || (nameBytes > CLAVIA_NAME_SIZE)) {
-        LOG_ERROR("Patch name length out of range: %d\n", nameBytes);
+        RT_LOG_ERROR("Patch name length out of range: %d\n", nameBytes);
         return EXIT_FAILURE;
     }
     read_clavia_string(buff, bitPos, gGlobalSettings.slot[slot].patchName, sizeof(gGlobalSettings.slot[slot].patchName));
-    LOG_DEBUG("Patch name: %s\n", gGlobalSettings.slot[slot].patchName);
+    RT_LOG_DEBUG("Patch name: %s\n", gGlobalSettings.slot[slot].patchName);
     return EXIT_SUCCESS;
 }
 
@@ -686,14 +766,14 @@ static void parse_select_param(uint32_t slot, uint8_t * buff, uint32_t * bitPos)
         gSelectedParam[slot].moduleIndex = moduleIndex;
         gSelectedParam[slot].paramIndex  = paramIndex;
     }
-    LOG_DEBUG("Got select param: slot=%u location=%u module=%u param=%u\n",
-              slot, location, moduleIndex, paramIndex);
+    RT_LOG_DEBUG("Got select param: slot=%u location=%u module=%u param=%u\n",
+                 slot, location, moduleIndex, paramIndex);
 }
 
 static void parse_select_variation(uint32_t slot, uint8_t * buff, uint32_t * bitPos) {
     uint8_t variation = read_bit_stream(buff, bitPos, 8);
 
-    LOG_DEBUG("Got variation select\n");
+    RT_LOG_DEBUG("Got variation select\n");
     gPatchDescr[slot].activeVariation = variation;
     set_exclusive_button_highlight(topbarVariation1Id, topbarVariationInitId,
                                    (tTopbarControlId)(topbarVariation1Id + variation));
@@ -702,7 +782,7 @@ static void parse_select_variation(uint32_t slot, uint8_t * buff, uint32_t * bit
 static void parse_sel_param_page(uint8_t * buff, uint32_t * bitPos) {
     uint8_t paramPage = read_bit_stream(buff, bitPos, 8);
 
-    LOG_DEBUG("Got param page Page=%u Pos=%u\n", paramPage / 3, paramPage % 3);
+    RT_LOG_DEBUG("Got param page Page=%u Pos=%u\n", paramPage / 3, paramPage % 3);
 }
 
 // Reads a SUB_COMMAND_LIST_NAMES (0x14) response — reverse-engineered from a real startup capture
@@ -812,10 +892,10 @@ static void parse_perf_patch_versions(uint8_t * buff, uint32_t * bitPos) {
     uint8_t readSlot    = 0;
     uint8_t subResponse = 0;
 
-    LOG_DEBUG("\nGot performance patch versions\n\n");
+    RT_LOG_DEBUG("\nGot performance patch versions\n\n");
 
     newVersion = read_bit_stream(buff, bitPos, 8);
-    LOG_DEBUG("Old perf = %u new = %u\n", gGlobalSettings.perfVersion, newVersion);
+    RT_LOG_DEBUG("Old perf = %u new = %u\n", gGlobalSettings.perfVersion, newVersion);
 
     if (newVersion != gGlobalSettings.perfVersion) {
         gGlobalSettings.perfVersion     = newVersion;
@@ -829,7 +909,7 @@ static void parse_perf_patch_versions(uint8_t * buff, uint32_t * bitPos) {
         newVersion  = read_bit_stream(buff, bitPos, 8);
 
         if (subResponse == SUB_RESPONSE_PATCH_VERSION) {
-            LOG_DEBUG("Store old patch %u ver = %u new = %u\n", readSlot, gGlobalSettings.slot[readSlot].patchVersion, newVersion);
+            RT_LOG_DEBUG("Store old patch %u ver = %u new = %u\n", readSlot, gGlobalSettings.slot[readSlot].patchVersion, newVersion);
 
             if (newVersion != gGlobalSettings.slot[readSlot].patchVersion) {
                 gGlobalSettings.slot[readSlot].patchVersion = newVersion;
@@ -864,7 +944,7 @@ static void parse_bank_upload_data(uint8_t * buff, uint32_t * bitPos) {
     contentStart          = BIT_TO_BYTE(*bitPos);
 
     if (contentLength > PATCH_FILE_SIZE) {
-        LOG_ERROR("Bank upload content length %u exceeds buffer %d, truncating\n", contentLength, PATCH_FILE_SIZE);
+        RT_LOG_ERROR("Bank upload content length %u exceeds buffer %d, truncating\n", contentLength, PATCH_FILE_SIZE);
         contentLength = PATCH_FILE_SIZE;
     }
 
@@ -874,12 +954,12 @@ static void parse_bank_upload_data(uint8_t * buff, uint32_t * bitPos) {
     memcpy(sBankUploadContent, &buff[contentStart], contentLength);
     sBankUploadContentLen = contentLength;
     sBankUploadGotData    = true;
-    LOG_DEBUG("Bank upload: got '%s' (%u bytes)\n", sBankUploadName, contentLength);
+    RT_LOG_DEBUG("Bank upload: got '%s' (%u bytes)\n", sBankUploadName, contentLength);
 }
 
 static void parse_bank_upload_empty(void) {
     sBankUploadGotData = false;
-    LOG_DEBUG("Bank upload: location empty\n");
+    RT_LOG_DEBUG("Bank upload: location empty\n");
 }
 
 // The device's own SUB_RESPONSE_PARAM_LIST (0x4d), arriving as a message rather than as a section of
@@ -933,11 +1013,11 @@ static void report_param_list_framing(tParamListFraming framing, uint32_t slot)
 
     switch (framing) {
         case paramListFramingNoLength:
-            LOG_INFO("Got param list slot %u — NO section length in front. First one this run.\n", slot);
+            RT_LOG_INFO("Got param list slot %u — NO section length in front. First one this run.\n", slot);
             break;
 
         case paramListFramingWithLength:
-            LOG_INFO("Got param list slot %u — 16-BIT SECTION LENGTH in front, as in a patch dump. First one this run.\n", slot);
+            RT_LOG_INFO("Got param list slot %u — 16-BIT SECTION LENGTH in front, as in a patch dump. First one this run.\n", slot);
             break;
 
         default:
@@ -968,8 +1048,8 @@ static void parse_param_list_message(uint32_t slot, uint8_t * buff, uint32_t * b
 
     // LOG_ERROR, and every time rather than once: this is the case where a real message is being
     // DROPPED, so the patch on screen can go stale against the instrument. It should be loud.
-    LOG_ERROR("param list slot %u: header implausible at either offset, NOT PARSED — params may now be stale\n", slot);
-    LOG_ERROR("  bytes from byte %u: %s\n", dumpStart, dump);
+    RT_LOG_ERROR("param list slot %u: header implausible at either offset, NOT PARSED — params may now be stale\n", slot);
+    RT_LOG_ERROR("  bytes from byte %u: %s\n", dumpStart, dump);
 }
 
 static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
@@ -979,7 +1059,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
 
     switch (subCommand) {
         case SUB_RESPONSE_VOLUME_INDICATOR:
-            parse_volume_indicator(slot, buff, bitPos);
+            parse_volume_indicator(slot, buff, bitPos, length);
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_LED_DATA:
@@ -987,14 +1067,14 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_ERROR:
-            LOG_DEBUG("Got Error!!!\n");
+            RT_LOG_DEBUG("Got Error!!!\n");
             return EXIT_FAILURE;
 
         case SUB_RESPONSE_RESOURCES_USED:
             return parse_resources_used(slot, buff, bitPos, length);
 
         case SUB_RESPONSE_KNOBS:
-            LOG_DEBUG("Got knob snapshot slot %u\n", slot);
+            RT_LOG_DEBUG("Got knob snapshot slot %u\n", slot);
             parse_knobs(slot, buff, bitPos);
             return EXIT_SUCCESS;
 
@@ -1004,17 +1084,17 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_PATCH_VERSION:
-            LOG_DEBUG("Got patch version\n");
+            RT_LOG_DEBUG("Got patch version\n");
             return parse_patch_version(&buff[BIT_TO_BYTE(*bitPos)],
                                        length - BIT_TO_BYTE(*bitPos) - CRC_BYTES);
 
         case SUB_RESPONSE_SYNTH_SETTINGS:
-            LOG_DEBUG("Got synth settings\n");
+            RT_LOG_DEBUG("Got synth settings\n");
             return parse_synth_settings(&buff[BIT_TO_BYTE(*bitPos)],
                                         length - BIT_TO_BYTE(*bitPos) - CRC_BYTES);
 
         case SUB_RESPONSE_MIDI_CC:
-            LOG_DEBUG("Got MIDI CC response slot %u\n", slot);
+            RT_LOG_DEBUG("Got MIDI CC response slot %u\n", slot);
             parse_midi_cc(&buff[BIT_TO_BYTE(*bitPos)],
                           length - BIT_TO_BYTE(*bitPos) - CRC_BYTES, slot);
             return EXIT_SUCCESS;
@@ -1036,7 +1116,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_SET_ASSIGNED_VOICES:
-            LOG_DEBUG("Got assigned voices command — unexpected\n");
+            RT_LOG_DEBUG("Got assigned voices command — unexpected\n");
             return EXIT_SUCCESS;
 
         // SUB_COMMAND_SET_PARAM_MODE (0x3e, incoming) and SUB_RESPONSE_PERF_HEADER (0x11) parsers were
@@ -1046,7 +1126,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
         // did send one it now falls through to the default unhandled-message log below.
 
         case SUB_RESPONSE_PERFORMANCE_SETTINGS:
-            LOG_DEBUG("Got performance settings\n");
+            RT_LOG_DEBUG("Got performance settings\n");
             parse_performance_settings(&buff[BIT_TO_BYTE(*bitPos)],
                                        length - BIT_TO_BYTE(*bitPos) - CRC_BYTES);
             return EXIT_SUCCESS;
@@ -1060,7 +1140,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_PATCH_DESCRIPTION:
-            LOG_DEBUG("Got patch description\n");
+            RT_LOG_DEBUG("Got patch description\n");
             parse_patch(slot, &buff[BIT_TO_BYTE(*bitPos) - 1],
                         (length - BIT_TO_BYTE(*bitPos) - CRC_BYTES) + 1);
             return EXIT_SUCCESS;
@@ -1097,7 +1177,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         case SUB_RESPONSE_GLOBAL_KNOBS:
-            LOG_DEBUG("Got global knobs\n");
+            RT_LOG_DEBUG("Got global knobs\n");
             read_bit_stream(buff, bitPos, 16);  // section byte count — consumed, not used
             parse_global_knobs(buff, bitPos);
             return EXIT_SUCCESS;
@@ -1106,7 +1186,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
         {
             uint32_t count = read_bit_stream(buff, bitPos, 16);
 
-            LOG_DEBUG("Got current note slot %u count %u\n", slot, count);
+            RT_LOG_DEBUG("Got current note slot %u count %u\n", slot, count);
             store_note2(slot, buff, bitPos, count);
             return EXIT_SUCCESS;
         }
@@ -1115,7 +1195,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
         {
             uint32_t count = read_bit_stream(buff, bitPos, 16);
 
-            LOG_DEBUG("Got patch notes slot %u count %u\n", slot, count);
+            RT_LOG_DEBUG("Got patch notes slot %u count %u\n", slot, count);
             store_patch_notes(slot, buff, bitPos, count);
             return EXIT_SUCCESS;
         }
@@ -1139,7 +1219,7 @@ static int parse_command_response(uint8_t * buff, uint32_t * bitPos,
             return EXIT_SUCCESS;
 
         default:
-            LOG_DEBUG("Got unknown sub-command 0x%02x - must implement!!!\n", subCommand);
+            RT_LOG_DEBUG("Got unknown sub-command 0x%02x - must implement!!!\n", subCommand);
             exit(1);
     }
 }
@@ -1158,7 +1238,7 @@ static int parse_incoming(uint8_t * buff, int length, int * response) {
 
     switch (responseType) {
         case RESPONSE_TYPE_INIT:
-            LOG_DEBUG("Got response init\n");
+            RT_LOG_DEBUG("Got response init\n");
 
             if (response != NULL) {
                 *response = SUB_RESPONSE_OK;
@@ -1182,7 +1262,7 @@ static int parse_incoming(uint8_t * buff, int length, int * response) {
         }
 
         default:
-            LOG_DEBUG("Got unknown response type 0x%02x\n", responseType);
+            RT_LOG_DEBUG("Got unknown response type 0x%02x\n", responseType);
             ret = EXIT_FAILURE;
             break;
     }
@@ -1190,6 +1270,67 @@ static int parse_incoming(uint8_t * buff, int length, int * response) {
     return ret;
 }
 
+// ---------------------------------------------------------------------------
+// Inbound framing — what arrived on each IN endpoint, checked and handed to the parsers. The receive
+// functions below call these with what they read; tools/usbreplay.c calls them with a capture.
+// ---------------------------------------------------------------------------
+
+bool usb_comms_parse_interrupt(uint8_t * buff, int length, int * result, int * response, int * extendedLength) {
+    uint32_t bitPos     = 0;
+    int      dataLength = 0;
+    int      type       = 0;
+
+    *extendedLength = 0;
+
+    if ((buff == NULL) || (length <= 0)) {
+        return false;
+    }
+    dataLength = read_bit_stream(buff, &bitPos, 4);
+    type       = read_bit_stream(buff, &bitPos, 4);
+
+    if (type == RESPONSE_TYPE_EXTENDED) {
+        // Only a header if everything after the length is zero; anything else is not one we know.
+        for (int i = 3; i < length; i++) {
+            if (buff[i] != 0) {
+                return false;
+            }
+        }
+        *extendedLength = read_bit_stream(buff, &bitPos, 16);
+        return true;
+    }
+
+    if (type == RESPONSE_TYPE_EMBEDDED) {
+        uint32_t crcBitPos = SIGNED_BYTE_TO_BIT(dataLength - 1);
+
+        if ((dataLength < CRC_BYTES) || ((dataLength + 1) > length)) {
+            RT_LOG_DEBUG("Embedded length %d does not fit a %d-byte message\n", dataLength, length);
+            *result = EXIT_FAILURE;
+        } else if (calc_crc16(&buff[1], dataLength - 2) != (uint16_t)read_bit_stream(buff, &crcBitPos, 16)) {
+            RT_LOG_DEBUG("Bad embedded CRC\n");
+            *result = EXIT_FAILURE;
+        } else {
+            *result = parse_incoming(buff + 1, dataLength, response);
+        }
+        return true;
+    }
+    return false;
+}
+
+int usb_comms_parse_extended(uint8_t * buff, int length, int * response) {
+    uint32_t bitPos = 0;
+
+    if ((buff == NULL) || (length < CRC_BYTES)) {
+        return EXIT_FAILURE;
+    }
+    bitPos = SIGNED_BYTE_TO_BIT(length - 2);
+
+    if (calc_crc16(buff, length - 2) != read_bit_stream(buff, &bitPos, 16)) {
+        RT_LOG_DEBUG("Bad CRC\n");
+        return EXIT_FAILURE;
+    }
+    return parse_incoming(buff, length, response);
+}
+
 // ---------------------------------------------------------------------------
 // USB receive functions
 // ---------------------------------------------------------------------------
@@ -1199,20 +1340,20 @@ static int rcv_extended(int dataLength, int * response, unsigned int timeout_ms)
     int                    readLength                  = 0;
     int                    retVal                      = EXIT_FAILURE;
     int                    try                         = 1;
-    libusb_device_handle * devHandle_local             = NULL;
+    bool                   deviceOpen                  = false;
     double                 timeDelta                   = 0.0f;
     static double          largestDelta                = 0.0f;
 
     if (dataLength > EXTENDED_MESSAGE_SIZE) {
-        LOG_ERROR("Expected message too large (%u > %u)\n", dataLength, EXTENDED_MESSAGE_SIZE);
+        RT_LOG_ERROR("Expected message too large (%u > %u)\n", dataLength, EXTENDED_MESSAGE_SIZE);
         return EXIT_FAILURE;
     }
     pthread_mutex_lock(&usbStaticMutex);
-    devHandle_local = devHandle;
+    deviceOpen = device_is_open();
     pthread_mutex_unlock(&usbStaticMutex);
 
-    if (devHandle_local == NULL) {
-        LOG_ERROR("Device handle is NULL\n");
+    if (deviceOpen == false) {
+        RT_LOG_ERROR("Device handle is NULL\n");
         return EXIT_FAILURE;
     }
 
@@ -1222,9 +1363,7 @@ static int rcv_extended(int dataLength, int * response, unsigned int timeout_ms)
         memset(buff, 0, sizeof(buff));
         readLength = 0;
         get_time_delta();
-        retVal     = usb_bulk_transfer_sync(devHandle_local, 0x82, buff,
-                                            sizeof(buff), &readLength,
-                                            timeout_ms);
+        retVal     = usb_transfer_sync(0x82, buff, sizeof(buff), &readLength, timeout_ms);
         timeDelta  = get_time_delta();
 
         if (timeDelta > largestDelta) {
@@ -1239,47 +1378,41 @@ static int rcv_extended(int dataLength, int * response, unsigned int timeout_ms)
                 if (  (responseType == RESPONSE_TYPE_INIT)
                    || (responseType == RESPONSE_TYPE_COMMAND)) {
                     gUsbRxTime = (uint64_t)get_time_ms();
-                    usb_log_message("EX", buff, (size_t)readLength);
+                    usb_log_message(eUsbLogExtended, 0x82, buff, (size_t)readLength);
                     break;
                 } else {
-                    LOG_DEBUG("Unexpected extended responseType 0x%02x — discarding\n", responseType);
+                    RT_LOG_DEBUG("Unexpected extended responseType 0x%02x — discarding\n", responseType);
                     break;
                 }
             }
             // readLength == 0: ZLP — device not ready yet, retry
         } else if (is_disconnect_error(retVal)) {
-            LOG_DEBUG("Disconnect error %s\n", libusb_error_name(retVal));
+            RT_LOG_DEBUG("Disconnect error %s\n", libusb_error_name(retVal));
             gotBadConnectionIndication = true;
             return EXIT_FAILURE;
         } else {
-            LOG_DEBUG("Transfer error %s\n", libusb_error_name(retVal));
+            RT_LOG_DEBUG("Transfer error %s\n", libusb_error_name(retVal));
             break;
         }
     }
 
     if (readLength != dataLength) {
-        LOG_DEBUG("Length mismatch read=%d expected=%d\n", readLength, dataLength);
+        RT_LOG_DEBUG("Length mismatch read=%d expected=%d\n", readLength, dataLength);
 
         if (readLength == 0) {
-            LOG_DEBUG("Extended receive got no data — triggering reconnect\n");
+            RT_LOG_DEBUG("Extended receive got no data — triggering reconnect\n");
             gotBadConnectionIndication = true;
         }
         return EXIT_FAILURE;
     }
-    uint32_t bitPos = SIGNED_BYTE_TO_BIT(dataLength - 2);
-
-    if (calc_crc16(buff, dataLength - 2) != read_bit_stream(buff, &bitPos, 16)) {
-        LOG_DEBUG("Bad CRC\n");
-        return EXIT_FAILURE;
-    }
-    return parse_incoming(buff, dataLength, response);
+    return usb_comms_parse_extended(buff, dataLength, response);
 }
 
 static int int_rec(tPoll poll, int expectedResponse, unsigned int timeout_ms) {
     uint8_t                buff[INTERRUPT_MESSAGE_SIZE] = {0};
     int                    readLength                   = 0;
     int                    retVal                       = EXIT_FAILURE;
-    libusb_device_handle * devHandle_local              = NULL;
+    bool                   deviceOpen                   = false;
     bool                   doLoop                       = true;
     int                    response                     = SUB_RESPONSE_ERROR;
     double                 timeDelta                    = 0.0f;
@@ -1288,19 +1421,17 @@ static int int_rec(tPoll poll, int expectedResponse, unsigned int timeout_ms) {
 
     for (try = 1; try <= 5 && doLoop == true; try++) {
         pthread_mutex_lock(&usbStaticMutex);
-        devHandle_local = devHandle;
+        deviceOpen = device_is_open();
         pthread_mutex_unlock(&usbStaticMutex);
 
-        if (devHandle_local == NULL) {
-            LOG_ERROR("int_rec: device handle is NULL\n");
+        if (deviceOpen == false) {
+            RT_LOG_ERROR("int_rec: device handle is NULL\n");
             return EXIT_FAILURE;
         }
         memset(buff, 0, sizeof(buff));
         readLength      = 0;
         get_time_delta();
-        retVal          = usb_bulk_transfer_sync(devHandle_local, 0x81, buff,
-                                                 sizeof(buff), &readLength,
-                                                 timeout_ms);
+        retVal          = usb_transfer_sync(0x81, buff, sizeof(buff), &readLength, timeout_ms);
         timeDelta       = get_time_delta();
 
         if (timeDelta > largestDelta) {
@@ -1311,7 +1442,7 @@ static int int_rec(tPoll poll, int expectedResponse, unsigned int timeout_ms) {
         if (retVal == LIBUSB_SUCCESS) {
             if (readLength > 0) {
                 gUsbRxTime = (uint64_t)get_time_ms();
-                usb_log_message("RX", buff, (size_t)readLength);
+                usb_log_message(eUsbLogRx, 0x81, buff, (size_t)readLength);
             }
         } else if (retVal == LIBUSB_ERROR_TIMEOUT) {
             if (poll == ePollYes) {
@@ -1320,49 +1451,30 @@ static int int_rec(tPoll poll, int expectedResponse, unsigned int timeout_ms) {
                 return EXIT_FAILURE;
             }
         } else if (is_disconnect_error(retVal)) {
-            LOG_DEBUG("int_rec: disconnect error %s\n", libusb_error_name(retVal));
+            RT_LOG_DEBUG("int_rec: disconnect error %s\n", libusb_error_name(retVal));
             gotBadConnectionIndication = true;
             return EXIT_FAILURE;
         } else {
-            LOG_DEBUG("int_rec: transfer error %s\n", libusb_error_name(retVal));
+            RT_LOG_DEBUG("int_rec: transfer error %s\n", libusb_error_name(retVal));
         }
 
         if (readLength <= 0) {
             return EXIT_FAILURE;
         }
-        uint32_t bitPos     = 0;
-        int      dataLength = read_bit_stream(buff, &bitPos, 4);
-        int      type       = read_bit_stream(buff, &bitPos, 4);
-
-        if (type == RESPONSE_TYPE_EXTENDED) {
-            bool foundNoneZero = false;
-
-            for (int i = 3; i < readLength; i++) {
-                if (buff[i] != 0) {
-                    foundNoneZero = true;
-                    break;
-                }
-            }
-
-            if (!foundNoneZero) {
-                dataLength = read_bit_stream(buff, &bitPos, 16);
-                retVal     = rcv_extended(dataLength, &response, timeout_ms);
-            }
-        } else if (type == RESPONSE_TYPE_EMBEDDED) {
-            uint32_t crcBitPos = SIGNED_BYTE_TO_BIT(dataLength - 1);
+        int extendedLength = 0;
 
-            if (calc_crc16(&buff[1], dataLength - 2) != (uint16_t)read_bit_stream(buff, &crcBitPos, 16)) {
-                LOG_DEBUG("Bad embedded CRC\n");
-                retVal = EXIT_FAILURE;
-            } else {
-                retVal = parse_incoming(buff + 1, dataLength, &response);
+        // An embedded reply is parsed here and now; an extended header means the reply itself follows
+        // on 0x82. Anything else leaves retVal as the read left it.
+        if (usb_comms_parse_interrupt(buff, readLength, &retVal, &response, &extendedLength) == true) {
+            if (extendedLength > 0) {
+                retVal = rcv_extended(extendedLength, &response, timeout_ms);
             }
         }
 
         if (poll == ePollYes) {
             doLoop = false;                        // Idle poll — always exit after one
         } else {
-            LOG_DEBUG("response = 0x%02x expected = 0x%02x\n", response, expectedResponse);
+            RT_LOG_DEBUG("response = 0x%02x expected = 0x%02x\n", response, expectedResponse);
 
             // A Bank Upload request can legitimately come back either with patch data or
             // with an "empty location" response — both are valid terminal outcomes.
@@ -1402,17 +1514,16 @@ static int send_message(uint8_t * buff, int pos) {
     write_uint16(&buff[0], msgLength);
 
     pthread_mutex_lock(&usbStaticMutex);
-    libusb_device_handle * handle       = devHandle;
+    bool                   deviceOpen   = device_is_open();
     pthread_mutex_unlock(&usbStaticMutex);
 
-    if (handle == NULL) {
+    if (deviceOpen == false) {
         gotBadConnectionIndication = true;
         return EXIT_FAILURE;
     }
     actualLength = 0;
     get_time_delta();
-    result       = usb_bulk_transfer_sync(handle, 3, buff, msgLength,
-                                          &actualLength, USB_SEND_TIMEOUT_MS);
+    result       = usb_transfer_sync(3, buff, msgLength, &actualLength, USB_SEND_TIMEOUT_MS);
     timeDelta    = get_time_delta();
 
     if (timeDelta > largestDelta) {
@@ -1423,20 +1534,20 @@ static int send_message(uint8_t * buff, int pos) {
     if ((result == 0) && (actualLength == msgLength)) {
         gLastActivityTime = time(NULL);
         gUsbTxTime        = (uint64_t)get_time_ms();
-        usb_log_message("TX", buff, (size_t)msgLength);
+        usb_log_message(eUsbLogTx, 3, buff, (size_t)msgLength);
         return EXIT_SUCCESS;
     }
 
     if (actualLength != msgLength) {
-        LOG_ERROR("Mismatch: actual length %d, msg length %d\n", actualLength, msgLength);
+        RT_LOG_ERROR("Mismatch: actual length %d, msg length %d\n", actualLength, msgLength);
     }
 
     if (is_disconnect_error(result)) {
-        LOG_DEBUG("disconnect error %s\n", libusb_error_name(result));
+        RT_LOG_DEBUG("disconnect error %s\n", libusb_error_name(result));
         gotBadConnectionIndication = true;
         return EXIT_FAILURE;
     } else {
-        LOG_ERROR("transfer error %s, Time taken %f with timeout of %u\n", libusb_error_name(result), timeDelta, USB_SEND_TIMEOUT_MS);
+        RT_LOG_ERROR("transfer error %s, Time taken %f with timeout of %u\n", libusb_error_name(result), timeDelta, USB_SEND_TIMEOUT_MS);
     }
     return EXIT_FAILURE;
 }
@@ -1454,7 +1565,7 @@ static int send_and_receive_once(uint8_t * buff, int pos, int expectedResponse,
             retVal = int_rec(ePollNo, expectedResponse, timeout_ms);
             break;
         }
-        LOG_ERROR("send failed, attempt %d\n", attempt);
+        RT_LOG_ERROR("send failed, attempt %d\n", attempt);
     }
 
     return retVal;
@@ -1473,9 +1584,9 @@ static int send_and_receive(uint8_t * buff, int pos, int expectedResponse, unsig
             if (retVal == EXIT_SUCCESS) {
                 break;
             }
-            LOG_ERROR("receive failed, attempt %d\n", attempt);
+            RT_LOG_ERROR("receive failed, attempt %d\n", attempt);
         } else {
-            LOG_ERROR("send failed, attempt %d\n", attempt);
+            RT_LOG_ERROR("send failed, attempt %d\n", attempt);
         }
     }
 
@@ -1517,7 +1628,7 @@ static int send_stop(void) {
     stopCount++;
 
     if (stopCount > 10) {
-        LOG_ERROR("Stop message count went greater than 10\n");
+        RT_LOG_ERROR("Stop message count went greater than 10\n");
         exit(1);
     }
     return retVal;
@@ -1531,7 +1642,7 @@ static int send_start(void) {
     stopCount--;
 
     if (stopCount < 0) {
-        LOG_ERROR("Stop message count went negative\n");
+        RT_LOG_ERROR("Stop message count went negative\n");
         exit(1);
     }
 
@@ -1612,7 +1723,7 @@ static int send_get_performance_settings(void) {
     uint8_t  buff[SEND_MESSAGE_SIZE] = {0};
     uint32_t bitPos                  = BYTE_TO_BIT(COMMAND_OFFSET);
 
-    LOG_DEBUG("Send get performance settings\n");
+    RT_LOG_DEBUG("Send get performance settings\n");
     usb_cmd_sys(buff, &bitPos, (uint8_t)gGlobalSettings.perfVersion, SUB_COMMAND_PERFORMANCE_SETTINGS);
     return send_and_receive(buff, BIT_TO_BYTE(bitPos), SUB_RESPONSE_PERFORMANCE_SETTINGS, USB_RECV_DATA_MS);
 }
@@ -1621,7 +1732,7 @@ static int send_get_patch_version(uint32_t slot) {
     uint8_t  buff[SEND_MESSAGE_SIZE] = {0};
     uint32_t bitPos                  = BYTE_TO_BIT(COMMAND_OFFSET);
 
-    LOG_DEBUG("Send get patch version\n");
+    RT_LOG_DEBUG("Send get patch version\n");
     usb_cmd_sys(buff, &bitPos, 0x41, SUB_COMMAND_GET_PATCH_VERSION);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)slot);
     return send_and_receive(buff, BIT_TO_BYTE(bitPos), SUB_RESPONSE_PATCH_VERSION, USB_RECV_DATA_MS);
@@ -1687,7 +1798,7 @@ static int send_bank_download_push(uint8_t domain, uint32_t bank, uint32_t locat
     uint32_t byteStart               = 0;
 
     if (contentLen == 0 || BIT_TO_BYTE(bitPos) + CLAVIA_NAME_SIZE + 32 + contentLen > SEND_MESSAGE_SIZE) {
-        LOG_ERROR("send_bank_download_push: content length %u out of range\n", contentLen);
+        RT_LOG_ERROR("send_bank_download_push: content length %u out of range\n", contentLen);
         return EXIT_FAILURE;
     }
     usb_cmd_sys(buff, &bitPos, 0x41, SUB_COMMAND_PATCH_BANK_DATA);
@@ -1767,8 +1878,8 @@ static int send_retrieve_patch(uint8_t domain, uint32_t bank, uint32_t location)
                                        ? SUB_RESPONSE_PATCH_VERSION_CHANGE
                                        : SUB_RESPONSE_PERF_PATCH_VERSIONS;
 
-    LOG_DEBUG("Retrieve: domain %u -> first byte %u (bank %u location %u), expecting 0x%02x\n",
-              domain, slotOrPerf, bank, location, expected);
+    RT_LOG_DEBUG("Retrieve: domain %u -> first byte %u (bank %u location %u), expecting 0x%02x\n",
+                 domain, slotOrPerf, bank, location, expected);
     usb_cmd_sys(buff, &bitPos, 0x41, SUB_COMMAND_RETRIEVE);
     write_bit_stream(buff, &bitPos, 8, slotOrPerf);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)bank);
@@ -1846,7 +1957,7 @@ static int backup_bank(uint32_t bank, const char * destFolder, bool isPerf, bool
     if (gCommsState != eCommsOnLine) {
         // Fail fast rather than looping NUM_LOCATIONS_PER_BANK times at USB_RECV_DATA_MS each
         // (over 6 minutes) waiting for a device that isn't there.
-        LOG_ERROR("backup_bank: G2 is not connected\n");
+        RT_LOG_ERROR("backup_bank: G2 is not connected\n");
 
         if (!silent) {
             snprintf(msg, sizeof(msg), "Backup of %s Bank %u failed: the G2 is not connected", typeLabel, bank + 1);
@@ -1867,21 +1978,22 @@ static int backup_bank(uint32_t bank, const char * destFolder, bool isPerf, bool
     if (manifest != NULL) {
         fprintf(manifest, "Version=Nord Modular G2 Bank Dump\r\n");
     } else {
-        LOG_ERROR("backup_bank: could not create manifest %s\n", manifestPath);
+        RT_LOG_ERROR("backup_bank: could not create manifest %s\n", manifestPath);
     }
 
     for (uint32_t location = 0; location < NUM_LOCATIONS_PER_BANK; location++) {
         if (gotBadConnectionIndication) {
-            LOG_ERROR("backup_bank: aborting early — lost connection to device\n");
+            RT_LOG_ERROR("backup_bank: aborting early — lost connection to device\n");
             break;
         }
+        serve_realtime_lane();
         gBankBackupLocation = location;
         call_wake_glfw();
 
         sBankUploadGotData  = false;
 
         if (send_bank_upload_request(domain, bank, location) != EXIT_SUCCESS) {
-            LOG_ERROR("Bank upload request failed for bank %u location %u\n", bank, location);
+            RT_LOG_ERROR("Bank upload request failed for bank %u location %u\n", bank, location);
             continue;
         }
 
@@ -1941,7 +2053,7 @@ static bool parse_bank_manifest(const char * manifestPath, uint32_t sourceBank1I
     char   line[1280] = {0};
 
     if (manifest == NULL) {
-        LOG_ERROR("parse_bank_manifest: could not open %s\n", manifestPath);
+        RT_LOG_ERROR("parse_bank_manifest: could not open %s\n", manifestPath);
         return false;
     }
 
@@ -1995,7 +2107,7 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
     memset(fileNames, 0, sizeof(fileNames));
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("restore_bank: G2 is not connected\n");
+        RT_LOG_ERROR("restore_bank: G2 is not connected\n");
 
         if (!silent) {
             snprintf(msg, sizeof(msg), "Restore of %s Bank %u failed: the G2 is not connected", typeLabel, destBank + 1);
@@ -2006,7 +2118,7 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
     snprintf(manifestPath, sizeof(manifestPath), "%s/%s%u.pchList", srcFolder, manifestPrefix, sourceBank + 1);
 
     if (!parse_bank_manifest(manifestPath, sourceBank + 1, fileNames)) {
-        LOG_ERROR("restore_bank: no manifest at %s — refusing to touch destination bank %u\n", manifestPath, destBank + 1);
+        RT_LOG_ERROR("restore_bank: no manifest at %s — refusing to touch destination bank %u\n", manifestPath, destBank + 1);
 
         if (!silent) {
             snprintf(msg, sizeof(msg),
@@ -2025,10 +2137,11 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
 
     for (uint32_t location = 0; location < NUM_LOCATIONS_PER_BANK; location++) {
         if (gotBadConnectionIndication) {
-            LOG_ERROR("restore_bank: aborting — lost connection to device\n");
+            RT_LOG_ERROR("restore_bank: aborting — lost connection to device\n");
             aborted = true;
             break;
         }
+        serve_realtime_lane();
         gBankRestoreLocation = location;
         call_wake_glfw();
 
@@ -2046,7 +2159,7 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
             }
 
             if (!read_bank_upload_file(filePath, sBankRestoreContent, PATCH_FILE_SIZE, &sBankRestoreContentLen)) {
-                LOG_ERROR("restore_bank: could not read %s\n", filePath);
+                RT_LOG_ERROR("restore_bank: could not read %s\n", filePath);
                 aborted = true;
                 break;
             }
@@ -2066,7 +2179,7 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
             }
 
             if (send_bank_download_push(domain, destBank, location, pushName, sBankRestoreContent, sBankRestoreContentLen) != EXIT_SUCCESS) {
-                LOG_ERROR("restore_bank: push failed for bank %u location %u\n", destBank, location);
+                RT_LOG_ERROR("restore_bank: push failed for bank %u location %u\n", destBank, location);
                 aborted = true;
                 break;
             }
@@ -2090,7 +2203,7 @@ static int restore_bank(uint32_t sourceBank, uint32_t destBank, const char * src
             }
         } else {
             if (send_bank_clear(domain, destBank, location) != EXIT_SUCCESS) {
-                LOG_ERROR("restore_bank: clear failed for bank %u location %u\n", destBank, location);
+                RT_LOG_ERROR("restore_bank: clear failed for bank %u location %u\n", destBank, location);
                 aborted = true;
                 break;
             }
@@ -2143,7 +2256,7 @@ static int peek_store_target(uint32_t bank, uint32_t location, bool isPerf) {
     gStorePeekIsPerf    = isPerf;
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("peek_store_target: G2 is not connected\n");
+        RT_LOG_ERROR("peek_store_target: G2 is not connected\n");
         gStorePeekFailed = true;
         post_response(eRspStorePeek);
         return EXIT_FAILURE;
@@ -2169,7 +2282,7 @@ static int store_patch_to_bank(uint32_t bank, uint32_t location, bool isPerf) {
     char         msg[256]  = {0};
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("store_patch_to_bank: G2 is not connected\n");
+        RT_LOG_ERROR("store_patch_to_bank: G2 is not connected\n");
         post_alert_response("Store to Bank", "Store failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -2217,7 +2330,7 @@ static int peek_delete_target(uint32_t bank, uint32_t location, bool isPerf) {
     gDeletePeekIsPerf    = isPerf;
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("peek_delete_target: G2 is not connected\n");
+        RT_LOG_ERROR("peek_delete_target: G2 is not connected\n");
         gDeletePeekFailed = true;
         post_response(eRspDeletePeek);
         return EXIT_FAILURE;
@@ -2245,7 +2358,7 @@ static int delete_bank_location(uint32_t bank, uint32_t location, bool isPerf) {
     char         msg[256]  = {0};
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("delete_bank_location: G2 is not connected\n");
+        RT_LOG_ERROR("delete_bank_location: G2 is not connected\n");
         post_alert_response("Delete", "Delete failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -2290,7 +2403,7 @@ static int peek_load_target(uint32_t bank, uint32_t location, bool isPerf) {
     gLoadPeekIsPerf    = isPerf;
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("peek_load_target: G2 is not connected\n");
+        RT_LOG_ERROR("peek_load_target: G2 is not connected\n");
         gLoadPeekFailed = true;
         post_response(eRspLoadPeek);
         return EXIT_FAILURE;
@@ -2315,7 +2428,7 @@ static int load_patch_from_bank(uint32_t bank, uint32_t location, bool isPerf) {
     int          result    = EXIT_FAILURE;
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("load_patch_from_bank: G2 is not connected\n");
+        RT_LOG_ERROR("load_patch_from_bank: G2 is not connected\n");
         post_alert_response("Load", "Load failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -2392,7 +2505,7 @@ static int backup_synth_settings(const char * destFolder, bool silent) {
     FILE * file             = NULL;
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("backup_synth_settings: G2 is not connected\n");
+        RT_LOG_ERROR("backup_synth_settings: G2 is not connected\n");
 
         if (!silent) {
             post_alert_response("Synth Settings Backup", "Synth Settings Backup failed: the G2 is not connected");
@@ -2412,7 +2525,7 @@ static int backup_synth_settings(const char * destFolder, bool silent) {
     file = fopen(filePath, "wb");
 
     if (file == NULL) {
-        LOG_ERROR("backup_synth_settings: could not create %s\n", filePath);
+        RT_LOG_ERROR("backup_synth_settings: could not create %s\n", filePath);
 
         if (!silent) {
             snprintf(msg, sizeof(msg), "Synth Settings Backup failed: could not write to %s", destFolder);
@@ -2510,7 +2623,7 @@ static bool find_latest_synth_settings_backup(const char * folder, char * outFil
     struct stat     st;
 
     if (dir == NULL) {
-        LOG_ERROR("find_latest_synth_settings_backup: could not open folder %s\n", folder);
+        RT_LOG_ERROR("find_latest_synth_settings_backup: could not open folder %s\n", folder);
         return false;
     }
 
@@ -2547,14 +2660,14 @@ static bool parse_synth_settings_backup_file(const char * filePath, tSynthSettin
     char * value     = NULL;
 
     if (file == NULL) {
-        LOG_ERROR("parse_synth_settings_backup_file: could not open %s\n", filePath);
+        RT_LOG_ERROR("parse_synth_settings_backup_file: could not open %s\n", filePath);
         return false;
     }
     memset(outSettings, 0, sizeof(*outSettings));
 
     if (  (fgets(line, sizeof(line), file) == NULL)
        || (strncmp(line, "Version=G2-Edit Synth Settings Backup", strlen("Version=G2-Edit Synth Settings Backup")) != 0)) {
-        LOG_ERROR("parse_synth_settings_backup_file: %s is not a recognized Synth Settings Backup\n", filePath);
+        RT_LOG_ERROR("parse_synth_settings_backup_file: %s is not a recognized Synth Settings Backup\n", filePath);
         fclose(file);
         return false;
     }
@@ -2680,7 +2793,7 @@ static int backup_everything(const char * destFolder) {
     char     msg[256]     = {0};
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("backup_everything: G2 is not connected\n");
+        RT_LOG_ERROR("backup_everything: G2 is not connected\n");
         post_alert_response("Backup Everything", "Backup Everything failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -2690,7 +2803,7 @@ static int backup_everything(const char * destFolder) {
 
     for (uint32_t bank = 0; bank < NUM_PATCH_BANKS; bank++) {
         if (gotBadConnectionIndication) {
-            LOG_ERROR("backup_everything: aborting early — lost connection to device\n");
+            RT_LOG_ERROR("backup_everything: aborting early — lost connection to device\n");
             aborted = true;
             break;
         }
@@ -2705,7 +2818,7 @@ static int backup_everything(const char * destFolder) {
     if (!aborted) {
         for (uint32_t bank = 0; bank < NUM_PERF_BANKS; bank++) {
             if (gotBadConnectionIndication) {
-                LOG_ERROR("backup_everything: aborting early — lost connection to device\n");
+                RT_LOG_ERROR("backup_everything: aborting early — lost connection to device\n");
                 aborted = true;
                 break;
             }
@@ -2786,13 +2899,13 @@ static int send_set_param_label(uint32_t slot, tModuleKey moduleKey, uint32_t pa
     uint32_t  labelCount                       = 0;
     uint32_t  labelIndices[MAX_NUM_PARAMETERS] = {0};
 
-    LOG_DEBUG("SET PARAM LABEL slot=%u location=%u index=%u param=%u name='%s'\n",
-              slot, moduleKey.location, moduleKey.index, paramIndex, name);
+    RT_LOG_DEBUG("SET PARAM LABEL slot=%u location=%u index=%u param=%u name='%s'\n",
+                 slot, moduleKey.location, moduleKey.index, paramIndex, name);
 
     tModule * module                           = get_module(moduleKey);
 
     if (module == NULL) {
-        LOG_DEBUG("SET PARAM LABEL get_module FAILED\n");
+        RT_LOG_DEBUG("SET PARAM LABEL get_module FAILED\n");
         return EXIT_FAILURE;
     }
     // A PARAMETER MAY CARRY MORE THAN ONE NAME. It always could — the wire format is a COUNT of
@@ -2887,7 +3000,7 @@ static int send_set_mode(uint32_t slot, tModeData * modeData) {
     write_bit_stream(buff, &bitPos, 8, (uint8_t)modeData->moduleKey.index);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)modeData->mode);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)modeData->value);
-    LOG_DEBUG("SET MODE %u %u\n", modeData->mode, modeData->value);
+    RT_LOG_DEBUG("SET MODE %u %u\n", modeData->mode, modeData->value);
     return send_and_receive(buff, BIT_TO_BYTE(bitPos), SUB_RESPONSE_OK, USB_RECV_ACK_MS);
 }
 
@@ -2946,7 +3059,7 @@ static int send_add_module(uint32_t slot, tModuleData * moduleData) {
     int      written                 = 0;
     int      i                       = 0;
 
-    LOG_DEBUG("Writing module\n");
+    RT_LOG_DEBUG("Writing module\n");
     usb_cmd_slot(buff, &bitPos, slot, COMMAND_REQ, SUB_COMMAND_ADD_MODULE);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)moduleData->type);
     write_bit_stream(buff, &bitPos, 8, (uint8_t)moduleData->moduleKey.location);
@@ -3033,8 +3146,11 @@ static int send_select_variation(uint32_t slot, uint32_t variation) {
 // and it does not clear gNote2/gPatchNotes at all. Which is right is an open question — until it is
 // answered, neither path's behaviour is changed by merging them. They were previously both called
 // clear_slot_data(), the static one here quietly shadowing the other.
-static void clear_slot_data_usb(uint32_t slot) {
+// What a patch dump refills: everything but the patch notes and the current note, which are asked for
+// on their own. warm_slots() re-reads a kept slot's dump into this.
+static void clear_slot_body_usb(uint32_t slot) {
     gPatchGeneration[slot]++;   // everything keyed to this slot's modules is now stale
+    gSlotInStep[slot] = false;
     database_delete_modules_by_slot(slot);
     database_delete_cables_by_slot(slot);
 
@@ -3043,8 +3159,12 @@ static void clear_slot_data_usb(uint32_t slot) {
     memset(&gControllerArray[slot], 0, sizeof(tControllerArray));
     gControllerCount[slot] = 0;
     gMorphCount[slot]      = 8;
-    gPatchNotesSize[slot]  = 0;
-    gNote2Size[slot]       = 0;
+}
+
+static void clear_slot_data_usb(uint32_t slot) {
+    clear_slot_body_usb(slot);
+    gPatchNotesSize[slot] = 0;
+    gNote2Size[slot]      = 0;
 }
 
 static int send_get_global_knobs(void) {
@@ -3119,10 +3239,11 @@ static int send_get_patch_data(uint32_t slot) {
     retVal |= send_get_resources_used(slot, locationFx);
 
     if (send_get_knob_snapshot(slot) != EXIT_SUCCESS) {
-        LOG_DEBUG("send_get_knob_snapshot slot %u failed — skipping\n", slot);
+        RT_LOG_DEBUG("send_get_knob_snapshot slot %u failed — skipping\n", slot);
     }
     retVal |= send_get_selected_param(slot);
 
+    gSlotInStep[slot] = (retVal == EXIT_SUCCESS);
     return retVal;
 }
 
@@ -3136,7 +3257,10 @@ static int push_slot_to_device(uint32_t slot) {
     uint8_t  buff[SEND_MESSAGE_SIZE] = {0};
     uint32_t bitPos                  = BYTE_TO_BIT(COMMAND_OFFSET);
 
-    LOG_DEBUG("Pushing slot %u to device\n", slot);
+    RT_LOG_DEBUG("Pushing slot %u to device\n", slot);
+
+    // Whatever the G2 ends up holding, it is not known to be this until it is pulled back.
+    gSlotInStep[slot] = false;
 
     usb_cmd_slot(buff, &bitPos, slot, COMMAND_REQ, SUB_COMMAND_SET_PATCH);
     write_bit_stream(buff, &bitPos, 8, 0x00);
@@ -3402,7 +3526,7 @@ static int apply_synth_settings_restore(void) {
     char msg[256] = {0};
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("apply_synth_settings_restore: G2 is not connected\n");
+        RT_LOG_ERROR("apply_synth_settings_restore: G2 is not connected\n");
         post_alert_response("Restore Synth Settings", "Restore failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -3439,7 +3563,7 @@ static int restore_everything(const char * srcFolder) {
     char         msg[256]           = {0};
 
     if (gCommsState != eCommsOnLine) {
-        LOG_ERROR("restore_everything: G2 is not connected\n");
+        RT_LOG_ERROR("restore_everything: G2 is not connected\n");
         post_alert_response("Restore Everything", "Restore Everything failed: the G2 is not connected");
         return EXIT_FAILURE;
     }
@@ -3449,7 +3573,7 @@ static int restore_everything(const char * srcFolder) {
 
     for (uint32_t bank = 0; (bank < NUM_PATCH_BANKS) && !aborted; bank++) {
         if (gotBadConnectionIndication) {
-            LOG_ERROR("restore_everything: aborting early — lost connection to device\n");
+            RT_LOG_ERROR("restore_everything: aborting early — lost connection to device\n");
             aborted = true;
             break;
         }
@@ -3471,7 +3595,7 @@ static int restore_everything(const char * srcFolder) {
     if (!aborted) {
         for (uint32_t bank = 0; bank < NUM_PERF_BANKS; bank++) {
             if (gotBadConnectionIndication) {
-                LOG_ERROR("restore_everything: aborting early — lost connection to device\n");
+                RT_LOG_ERROR("restore_everything: aborting early — lost connection to device\n");
                 aborted = true;
                 break;
             }
@@ -3631,7 +3755,7 @@ static int send_list_names_sweep(void) {
             write_bit_stream(buff, &bitPos, 8, location);
 
             if (send_and_receive(buff, BIT_TO_BYTE(bitPos), SUB_RESPONSE_LIST_NAMES, USB_RECV_DATA_MS) != EXIT_SUCCESS) {
-                LOG_ERROR("send_list_names_sweep: request failed for mode=%u bank=%u location=%u\n", mode, bank, location);
+                RT_LOG_ERROR("send_list_names_sweep: request failed for mode=%u bank=%u location=%u\n", mode, bank, location);
                 return EXIT_FAILURE;
             }
 
@@ -3642,7 +3766,7 @@ static int send_list_names_sweep(void) {
             location = sListNamesNextLoc;
 
             if (++guard > 2000) {
-                LOG_ERROR("send_list_names_sweep: guard tripped for mode=%u, aborting to avoid an infinite loop\n", mode);
+                RT_LOG_ERROR("send_list_names_sweep: guard tripped for mode=%u, aborting to avoid an infinite loop\n", mode);
                 break;
             }
         }
@@ -3658,31 +3782,172 @@ static void debug_dump_name_tables(void) {
     uint32_t patchCount = 0;
     uint32_t perfCount  = 0;
 
-    LOG_DEBUG("List Names: Patch table:\n");
+    RT_LOG_DEBUG("List Names: Patch table:\n");
 
     for (uint32_t bank = 0; bank < NUM_PATCH_BANKS; bank++) {
         for (uint32_t location = 0; location < NUM_LOCATIONS_PER_BANK; location++) {
             if (gPatchNameTable[bank][location].populated) {
-                LOG_DEBUG_DIRECT("  Bank %2u Loc %3u: \"%s\" (cat %u)\n", bank + 1, location + 1,
-                                 gPatchNameTable[bank][location].name, gPatchNameTable[bank][location].category);
+                RT_LOG_DEBUG_DIRECT("  Bank %2u Loc %3u: \"%s\" (cat %u)\n", bank + 1, location + 1,
+                                    gPatchNameTable[bank][location].name, gPatchNameTable[bank][location].category);
                 patchCount++;
             }
         }
     }
 
-    LOG_DEBUG("List Names: Performance table:\n");
+    RT_LOG_DEBUG("List Names: Performance table:\n");
 
     for (uint32_t bank = 0; bank < NUM_PERF_BANKS; bank++) {
         for (uint32_t location = 0; location < NUM_LOCATIONS_PER_BANK; location++) {
             if (gPerfNameTable[bank][location].populated) {
-                LOG_DEBUG_DIRECT("  Bank %2u Loc %3u: \"%s\" (cat %u)\n", bank + 1, location + 1,
-                                 gPerfNameTable[bank][location].name, gPerfNameTable[bank][location].category);
+                RT_LOG_DEBUG_DIRECT("  Bank %2u Loc %3u: \"%s\" (cat %u)\n", bank + 1, location + 1,
+                                    gPerfNameTable[bank][location].name, gPerfNameTable[bank][location].category);
                 perfCount++;
             }
         }
     }
 
-    LOG_DEBUG("List Names: %u patches, %u performances total\n", patchCount, perfCount);
+    RT_LOG_DEBUG("List Names: %u patches, %u performances total\n", patchCount, perfCount);
+}
+
+// ---------------------------------------------------------------------------
+// Warm reconnect — what was pulled, and whether it still holds
+// ---------------------------------------------------------------------------
+
+// A CRC of the slot as the database holds it, over the same sections push_slot_to_device() sends.
+// It changes with any edit made while the G2 was away — a file opened, a module moved — which is all
+// it is for: it is never compared with anything the G2 computed.
+static uint16_t slot_image_crc(uint32_t slot) {
+    static uint8_t buff[SEND_MESSAGE_SIZE];
+    uint32_t       bitPos = 0;
+
+    memset(buff, 0, sizeof(buff));
+    write_patch_descr(slot, buff, &bitPos);
+    write_module_list(slot, locationVa, buff, &bitPos);
+    write_module_list(slot, locationFx, buff, &bitPos);
+    write_current_note_2(slot, buff, &bitPos);
+    write_cable_list(slot, locationVa, buff, &bitPos);
+    write_cable_list(slot, locationFx, buff, &bitPos);
+    write_param_list(slot, locationMorph, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationVa, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationFx, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_morph_params(slot, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_knobs(slot, buff, &bitPos);
+    write_controllers(slot, buff, &bitPos);
+    write_param_names(slot, locationVa, buff, &bitPos);
+    write_param_names(slot, locationFx, buff, &bitPos);
+    write_module_names(slot, locationVa, buff, &bitPos);
+    write_module_names(slot, locationFx, buff, &bitPos);
+    write_patch_notes(slot, buff, &bitPos);
+    return (uint16_t)calc_crc16(buff, BIT_TO_BYTE_ROUND_UP(bitPos));
+}
+
+// The link has just gone, from on line. Records, for each slot that was pulled whole and has only been
+// edited in step with the G2 since, with no patch change waiting to be pulled, the version the G2 last
+// gave it and what the editor holds. The performance settings too, unless the G2 said they had
+// changed. A slot half way through a pull or a push is left out. Edits still queued when the link went
+// are in the snapshot but never reached the G2; the offline-edit decision forgets those slots.
+//
+// THE VERSION IS THE G2'S OWN COUNT, and it moves when a slot's patch is replaced — a panel load, a
+// retrieve, a whole patch sent — not when a knob on the panel is turned. So the snapshot is only
+// trusted for USB_WARM_RECONNECT_MS, the name is checked too, and the values are read again before a
+// slot is kept (see warm_slots()).
+static void warm_snapshot_take(void) {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        tWarmSlot * warm = &gWarmSlot[slot];
+
+        warm->valid   = gSlotInStep[slot] && (gotPatchChangeIndication[slot] == false);
+        warm->version = gGlobalSettings.slot[slot].patchVersion;
+        warm->crc     = warm->valid ? slot_image_crc(slot) : 0;
+        COPY_STRING(warm->name, gGlobalSettings.slot[slot].patchName);
+    }
+    gWarmPerf.valid              = (gotPerfSettingsChangeIndication == false);
+    gWarmPerf.version            = gGlobalSettings.perfVersion;
+    gWarmPerf.selectedSlot       = gGlobalSettings.selectedSlot;
+    gWarmPerf.masterClock        = gGlobalSettings.masterClock;
+    gWarmPerf.masterClockRunning = gGlobalSettings.masterClockRunning;
+    COPY_STRING(gWarmPerf.perfName, gGlobalSettings.perfName);
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        COPY_STRING(gWarmPerf.slot[slot].patchName, gGlobalSettings.slot[slot].patchName);
+        gWarmPerf.slot[slot].enabled         = gGlobalSettings.slot[slot].enabled;
+        gWarmPerf.slot[slot].keyboardEnabled = gPerfSettings.slot[slot].keyboardEnabled;
+        gWarmPerf.slot[slot].holdEnabled     = gPerfSettings.slot[slot].holdEnabled;
+        gWarmPerf.slot[slot].rangeLower      = gPerfSettings.slot[slot].rangeLower;
+        gWarmPerf.slot[slot].rangeUpper      = gPerfSettings.slot[slot].rangeUpper;
+    }
+    gWarmTakenMs = (uint64_t)get_time_ms();
+}
+
+static void warm_snapshot_forget(uint32_t slotMask) {
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if ((slotMask & (1u << slot)) != 0) {
+            gWarmSlot[slot].valid = false;
+            gWarmPerf.valid       = false;
+        }
+    }
+}
+
+// The performance settings as they were recorded, in place of asking for them again.
+static void warm_perf_restore(void) {
+    gGlobalSettings.selectedSlot       = gWarmPerf.selectedSlot;
+    gGlobalSettings.masterClock        = gWarmPerf.masterClock;
+    gGlobalSettings.masterClockRunning = gWarmPerf.masterClockRunning;
+    COPY_STRING(gGlobalSettings.perfName, gWarmPerf.perfName);
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        COPY_STRING(gGlobalSettings.slot[slot].patchName, gWarmPerf.slot[slot].patchName);
+        gGlobalSettings.slot[slot].enabled       = gWarmPerf.slot[slot].enabled;
+        gPerfSettings.slot[slot].keyboardEnabled = gWarmPerf.slot[slot].keyboardEnabled;
+        gPerfSettings.slot[slot].holdEnabled     = gWarmPerf.slot[slot].holdEnabled;
+        gPerfSettings.slot[slot].rangeLower      = gWarmPerf.slot[slot].rangeLower;
+        gPerfSettings.slot[slot].rangeUpper      = gWarmPerf.slot[slot].rangeUpper;
+    }
+}
+
+// Which slots need not be pulled again, as a mask: recorded, recorded recently, the version the G2
+// has just reported the same, the editor's copy unchanged — and the name the G2 gives the slot now
+// the one it had, which costs a round trip but catches a G2 restarted in the meantime, whose count
+// may have come back round to the same number. *perfWarm says the same of the performance settings,
+// which are only trusted if every slot is. Call with the versions freshly read. The snapshot is used
+// up: whatever happens next, a later reconnect takes a new one or pulls everything.
+//
+// THE VALUES ARE READ AGAIN. A parameter turned on the G2's own panel while the link was down moves
+// neither the version nor the name, so each slot that passes the rest has its patch dump pulled over
+// the editor's copy, and is kept only if the result is the slot as recorded, CRC for CRC. One that
+// differs is pulled whole by the caller, like any other; the dump just read is not wasted on it, only
+// the few requests around it — notes, resources, knobs, the selected parameter — are what a kept slot
+// saves. Reading the values alone would be cheaper, and SUB_COMMAND_QUERY_PARAMS looks to be that
+// request, but no capture shows its reply, so it is not sent on a guess.
+static uint32_t warm_slots(bool * perfWarm) {
+    uint32_t warm  = 0;
+    bool     fresh = (gWarmTakenMs != 0) && (((uint64_t)get_time_ms() - gWarmTakenMs) <= USB_WARM_RECONNECT_MS);
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        tWarmSlot * cached = &gWarmSlot[slot];
+
+        if ((fresh == false) || (cached->valid == false)
+            || (cached->version != gGlobalSettings.slot[slot].patchVersion)
+            || (cached->crc != slot_image_crc(slot))) {
+            continue;
+        }
+
+        if ((send_get_patch_name(slot) != EXIT_SUCCESS)
+            || (strncmp(cached->name, gGlobalSettings.slot[slot].patchName, CLAVIA_NAME_SIZE) != 0)) {
+            continue;
+        }
+        clear_slot_body_usb(slot);
+
+        if ((send_get_patch(slot) == EXIT_SUCCESS) && (cached->crc == slot_image_crc(slot))) {
+            gSlotInStep[slot]  = true;
+            warm              |= 1u << slot;
+        } else {
+            RT_LOG_INFO("Slot %u changed on the G2's panel while the link was down: pulling it again\n", slot);
+        }
+    }
+    *perfWarm = fresh && gWarmPerf.valid && (gWarmPerf.version == gGlobalSettings.perfVersion)
+                && (warm == ((1u << MAX_SLOTS) - 1));
+    warm_snapshot_forget((1u << MAX_SLOTS) - 1);
+    return warm;
 }
 
 // ---------------------------------------------------------------------------
@@ -3690,13 +3955,18 @@ static void debug_dump_name_tables(void) {
 // ---------------------------------------------------------------------------
 
 // First connection: G2 is authoritative — pull all patch data from hardware.
+//
+// A RECONNECT MAY BE WARM. The versions come first; a slot the G2 still has at the version it had when
+// the link went, and the editor still holds as it was then, is not pulled again beyond its patch dump,
+// which is read to check the values — see warm_slots(). Nor are the performance settings, if nothing
+// else was. The rest — synth settings, MIDI CC, knobs, the name sweep — is small, or may have changed
+// without a version to say so, and is pulled every time.
 static int send_init_sequence_pull(void) {
-    LOG_DEBUG("Init sequence: pulling from G2\n");
-    gCommsState = eCommsInitialising;
+    uint32_t warm     = 0;
+    bool     perfWarm = false;
 
-    // Clear any stale data before pulling fresh state
-    database_clear_cables();
-    database_clear_modules();
+    RT_LOG_DEBUG("Init sequence: pulling from G2\n");
+    gCommsState = eCommsInitialising;
 
     send_init();
     send_stop();
@@ -3706,15 +3976,33 @@ static int send_init_sequence_pull(void) {
     }
 
     send_get_patch_version(4); // Performance slot
+    warm = warm_slots(&perfWarm);
+
+    // Clear any stale data before pulling fresh state. Slot by slot if some are being kept: each one
+    // pulled is cleared on its way in (send_get_patch_data()).
+    if (warm == 0) {
+        database_clear_cables();
+        database_clear_modules();
+    }
     send_get_synth_settings();
     send_get_midi_cc();
     send_select_slot(0);
     send_get_global_page();
-    send_get_performance_settings();
+
+    if (perfWarm) {
+        warm_perf_restore();
+    } else {
+        send_get_performance_settings();
+    }
 
     for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if ((warm & (1u << slot)) != 0) {
+            RT_LOG_DEBUG("Slot %u kept from before the reconnect\n", slot);
+            continue;
+        }
+
         if (send_get_patch_data(slot) != EXIT_SUCCESS) {
-            LOG_DEBUG("Setting to eCommsReconnecting state, due to send_get_patch_data(slot) failing\n");
+            RT_LOG_DEBUG("Setting to eCommsReconnecting state, due to send_get_patch_data(slot) failing\n");
             gCommsState = eCommsReconnecting;
             return EXIT_FAILURE;
         }
@@ -3735,7 +4023,15 @@ static int send_init_sequence_pull(void) {
 
     send_start();
 
-    LOG_DEBUG("Pull init sequence complete\n");
+    RT_LOG_DEBUG("Pull init sequence complete\n");
+    gLastConnectMs = (uint32_t)((uint64_t)get_time_ms() - gOpenedMs);
+    gLastWarmSlots = 0;
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        gLastWarmSlots += ((warm & (1u << slot)) != 0) ? 1u : 0u;
+    }
+    RT_LOG_INFO("On line %u ms after opening the G2, %s: %u of %u slots kept from before the reconnect\n",
+                (unsigned)gLastConnectMs, (warm != 0) ? "warm" : "cold", (unsigned)gLastWarmSlots, MAX_SLOTS);
 
     for (int i = 0; i < MAX_SLOTS; i++) {
         gotPatchChangeIndication[i] = false;
@@ -3756,7 +4052,7 @@ static int send_init_sequence_pull(void) {
 __attribute__((unused))
 
 static int send_init_sequence_push(void) {
-    LOG_DEBUG("Init sequence: pushing editor data to G2\n");
+    RT_LOG_DEBUG("Init sequence: pushing editor data to G2\n");
     gCommsState = eCommsInitialising;
 
     send_init();
@@ -3765,7 +4061,7 @@ static int send_init_sequence_push(void) {
 
     for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
         if (push_slot_to_device(slot) != EXIT_SUCCESS) {
-            LOG_DEBUG("Setting to eCommsReconnecting state, due to push_slot_to_device(slot) failing\n");
+            RT_LOG_DEBUG("Setting to eCommsReconnecting state, due to push_slot_to_device(slot) failing\n");
             gCommsState = eCommsReconnecting;
             return EXIT_FAILURE;
         }
@@ -3780,7 +4076,7 @@ static int send_init_sequence_push(void) {
 
     send_start();
 
-    LOG_DEBUG("Push init sequence complete\n");
+    RT_LOG_DEBUG("Push init sequence complete\n");
 
     for (int i = 0; i < MAX_SLOTS; i++) {
         gotPatchChangeIndication[i] = false;
@@ -3847,7 +4143,7 @@ static int read_g2_file_payload(const char * filePath, uint8_t ** outBuf, int64_
     FILE *    file       = fopen(filePath, "rb");
 
     if (file == NULL) {
-        LOG_ERROR("read_g2_file_payload: cannot open %s\n", filePath);
+        RT_LOG_ERROR("read_g2_file_payload: cannot open %s\n", filePath);
         return EXIT_FAILURE;
     }
     fseek(file, 0, SEEK_END);
@@ -3855,14 +4151,14 @@ static int read_g2_file_payload(const char * filePath, uint8_t ** outBuf, int64_
     fseek(file, 0, SEEK_SET);
 
     if ((fileSize <= 4) || (fileSize > PERF_FILE_SIZE)) {
-        LOG_ERROR("read_g2_file_payload: bad file size %ld\n", fileSize);
+        RT_LOG_ERROR("read_g2_file_payload: bad file size %ld\n", fileSize);
         fclose(file);
         return EXIT_FAILURE;
     }
     uint8_t * buff       = (uint8_t *)malloc((size_t)fileSize);
 
     if (buff == NULL) {
-        LOG_ERROR("read_g2_file_payload: alloc failed\n");
+        RT_LOG_ERROR("read_g2_file_payload: alloc failed\n");
         fclose(file);
         return EXIT_FAILURE;
     }
@@ -3870,7 +4166,7 @@ static int read_g2_file_payload(const char * filePath, uint8_t ** outBuf, int64_
     fclose(file);
 
     if (readSize != (size_t)fileSize) {
-        LOG_ERROR("read_g2_file_payload: short read\n");
+        RT_LOG_ERROR("read_g2_file_payload: short read\n");
         free(buff);
         return EXIT_FAILURE;
     }
@@ -3887,7 +4183,7 @@ static int read_g2_file_payload(const char * filePath, uint8_t ** outBuf, int64_
     uint16_t  calcCrc    = calc_crc16(buff + byteOffset, (int)((fileSize - byteOffset) - 2));
 
     if (readCrc != calcCrc) {
-        LOG_WARNING("read_g2_file_payload: CRC check failed for %s\n", filePath);
+        RT_LOG_WARNING("read_g2_file_payload: CRC check failed for %s\n", filePath);
         free(buff);
         return EXIT_FAILURE;
     }
@@ -4043,7 +4339,8 @@ static void post_alert_response(const char * title, const char * message) {
 // send_start()) around its own device writes. True for every command except: eMsgCmdSetValue/
 // eMsgCmdSetParamMorph (real-time param/morph tweaks, left unpaused so they stay responsive
 // while dragging) and eMsgCmdSetCustomData/eMsgCmdPeekSynthSettingsRestore (no device write at
-// all). An unrecognised cmd value falls through to send_write_data()'s own default: case (a
+// all), and the eMsgCmdBeginBatch/eMsgCmdEndBatch markers (nothing to send; see
+// send_batch_window()). An unrecognised cmd value falls through to send_write_data()'s own default: case (a
 // no-op log), which harmlessly gets a pointless stop/start bracket rather than none — that
 // combination should never actually happen.
 static bool command_needs_stop_start(uint32_t cmd) {
@@ -4052,6 +4349,8 @@ static bool command_needs_stop_start(uint32_t cmd) {
         case eMsgCmdSetParamMorph:
         case eMsgCmdSetCustomData:
         case eMsgCmdPeekSynthSettingsRestore:
+        case eMsgCmdBeginBatch:
+        case eMsgCmdEndBatch:
             return false;
 
         default:
@@ -4421,8 +4720,15 @@ static int send_write_data(tMessageContent * messageContent) {
             retVal = restore_everything(messageContent->synthSettingsRestoreData.srcFolder);
             break;
 
+        case eMsgCmdBeginBatch:
+        case eMsgCmdEndBatch:
+            // Only reaches here when no window is open for it: an end after its window ran out of
+            // time, or a begin with nothing behind it yet. Nothing to do either way.
+            retVal = EXIT_SUCCESS;
+            break;
+
         default:
-            LOG_DEBUG("Unknown command %d\n", messageContent->cmd);
+            RT_LOG_DEBUG("Unknown command %d\n", messageContent->cmd);
             break;
     }
 
@@ -4432,6 +4738,106 @@ static int send_write_data(tMessageContent * messageContent) {
     return retVal;
 }
 
+// Structural edits that may share a stop/start window with the ones either side of them. Each is a
+// small write to the edit buffer and nothing else: none switches slot or mode, reads the device back,
+// touches a file or waits on the user, and none of the G2's unsolicited messages is wanted between
+// two of them. Parameter writes need no window of their own, but travel inside one when they are part
+// of a marked batch — a paste sends each new module's values between its module and its cables.
+static bool command_joins_window(uint32_t cmd, bool inBatch) {
+    switch (cmd) {
+        case eMsgCmdBeginBatch:
+        case eMsgCmdEndBatch:
+        case eMsgCmdSetMode:
+        case eMsgCmdWriteModule:
+        case eMsgCmdDeleteModule:
+        case eMsgCmdMoveModule:
+        case eMsgCmdSetModuleUpRate:
+        case eMsgCmdWriteCable:
+        case eMsgCmdSetCableColour:
+        case eMsgCmdDeleteCable:
+        case eMsgCmdSetModuleLabel:
+        case eMsgCmdSetModuleColour:
+        case eMsgCmdSetParamLabel:
+        case eMsgCmdSetMutationLock:
+            return true;
+
+        case eMsgCmdSetValue:
+        case eMsgCmdSetParamMorph:
+        case eMsgCmdSetCustomData:
+            return inBatch;
+
+        default:
+            return false;
+    }
+}
+
+// Sends `first`, and whatever follows it that may share the window, inside ONE send_stop()/
+// send_start() pair.
+//
+// Every structural command pauses the G2's unsolicited stream around itself, and each pause is a
+// round trip and an audible gap. A paste of forty modules and sixty cables was a hundred of them in a
+// row. Here the window is opened once and every queued command behind the first that
+// command_joins_window() accepts goes out inside it; send_write_data()'s own stop/start pair nests
+// inside ours and costs nothing on the wire. The window closes at the first command that cannot
+// join, when the queue runs dry, or when its time is up — it must not starve the G2's LED and meter
+// traffic, or the patch-change indications state_handler() services between commands.
+//
+// A batch the UI marked with send_batch_begin()/send_batch_end() also takes the parameter writes in
+// it, waits briefly for the rest of it should the queue catch up with the UI, and is given longer:
+// the whole point is that it reaches the device as one edit. Anything left when a window closes is
+// sent by later passes exactly as before.
+static void send_batch_window(const tMessageContent * first) {
+    tMessageContent command  = *first;
+    bool            inBatch  = false;
+    uint64_t        sent     = 0;
+    uint64_t        deadline = (uint64_t)get_time_ms() + USB_BATCH_WINDOW_MS;
+
+    send_stop();
+
+    while (true) {
+        if (command.cmd == eMsgCmdBeginBatch) {
+            inBatch  = true;
+            deadline = (uint64_t)get_time_ms() + USB_BATCH_MARKED_MS;
+        } else if (command.cmd == eMsgCmdEndBatch) {
+            if (inBatch) {
+                break;    // the marked edit is all out; leave what follows to its own window
+            }
+        } else {
+            int result = send_write_data(&command);
+
+            sent++;
+
+            if ((result != EXIT_SUCCESS) || gotBadConnectionIndication) {
+                break;    // no sense stacking more on a link that is failing
+            }
+        }
+
+        if ((uint64_t)get_time_ms() >= deadline) {
+            break;
+        }
+
+        // The next command, if it may join. Inside a marked batch an empty queue usually means the UI
+        // is still posting the rest of it, so wait for that; otherwise the burst is over.
+        tMessageContent next  = {0};
+        bool            found = usb_coalesce_peek(&gCommandStage, &gToUsbThread, &next);
+
+        while ((found == false) && inBatch && ((uint64_t)get_time_ms() < deadline)) {
+            usleep(1000);
+            found = usb_coalesce_peek(&gCommandStage, &gToUsbThread, &next);
+        }
+
+        if ((found == false) || (command_joins_window(next.cmd, inBatch) == false)) {
+            break;
+        }
+        (void)usb_comms_next_command(&command);
+    }
+
+    send_start();
+
+    atomic_fetch_add_explicit(&gBatchWindows, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&gBatchedCommands, sent, memory_order_relaxed);
+}
+
 // ---------------------------------------------------------------------------
 // Main state handler — called in a tight loop from usb_thread_loop
 // ---------------------------------------------------------------------------
@@ -4443,8 +4849,14 @@ static void state_handler(void) {
     //TODO - Don't like early returns. Use retVal
 
     if (gotBadConnectionIndication) {
-        LOG_DEBUG("Bad connection — closing device\n");
+        RT_LOG_DEBUG("Bad connection — closing device\n");
         gotBadConnectionIndication = false;
+
+        // Only a connection that was fully up leaves anything a reconnect can keep. One lost half way
+        // through its init pull has a snapshot it already used up, or none.
+        if (gCommsState == eCommsOnLine) {
+            warm_snapshot_take();
+        }
         gCommsState                = eCommsReconnecting;
 
         pthread_mutex_lock(&usbStaticMutex);
@@ -4467,6 +4879,7 @@ static void state_handler(void) {
         pthread_mutex_unlock(&usbStaticMutex);
 
         if (opened) {
+            gOpenedMs   = (uint64_t)get_time_ms();
             gCommsState = eCommsWaitingReady;
         } else {
             usleep(500000);  // 500ms between open attempts — don't hammer the bus
@@ -4479,7 +4892,7 @@ static void state_handler(void) {
     if (gCommsState == eCommsAwaitingSyncDecision) {
         tMessageContent decision = {0};
 
-        if (msg_receive(&gToUsbThread, eRcvPoll, &decision) != EXIT_SUCCESS) {
+        if (usb_comms_next_command(&decision) == false) {
             usleep(50000);  // 50ms — waiting on a human, so nothing here needs to be tight
             return;
         }
@@ -4490,11 +4903,14 @@ static void state_handler(void) {
 
         // Push BEFORE the pull, then pull as usual: the device ends up holding the editor's
         // patches and the editor re-reads them, so both sides finish provably identical and the
-        // normal init sequence still runs exactly once.
+        // normal init sequence still runs exactly once. Either way the slots in question are pulled
+        // whole: the snapshot taken when the link went may hold edits the G2 never received.
+        warm_snapshot_forget(decision.offlineEditData.slotMask);
+
         if (decision.offlineEditData.pushToDevice) {
             for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
                 if ((decision.offlineEditData.slotMask & (1u << slot)) != 0) {
-                    LOG_DEBUG("Pushing editor's slot %u to the G2 after offline edits\n", slot);
+                    RT_LOG_DEBUG("Pushing editor's slot %u to the G2 after offline edits\n", slot);
                     push_slot_to_device(slot);
                 }
             }
@@ -4521,20 +4937,20 @@ static void state_handler(void) {
                 gCommsState                       = eCommsAwaitingSyncDecision;
                 return;
             }
-            LOG_DEBUG("G2 ready — starting init sequence\n");
+            RT_LOG_DEBUG("G2 ready — starting init sequence\n");
             int      result     = send_init_sequence_pull();
 
             if (result == EXIT_SUCCESS) {
                 gCommsState = eCommsOnLine;
             } else {
-                LOG_DEBUG("Init sequence failed — will retry\n");
+                RT_LOG_DEBUG("Init sequence failed — will retry\n");
                 pthread_mutex_lock(&usbStaticMutex);
                 close_device();
                 pthread_mutex_unlock(&usbStaticMutex);
                 gCommsState = eCommsReconnecting;
             }
         } else if (!gotBadConnectionIndication) {
-            LOG_DEBUG("G2 not ready yet — polling\n");
+            RT_LOG_DEBUG("G2 not ready yet — polling\n");
             usleep(500000);  // 500ms between readiness polls
         }
         return;
@@ -4545,7 +4961,7 @@ static void state_handler(void) {
     if (gotPerfSettingsChangeIndication) {
         gotPerfSettingsChangeIndication = false;
 
-        LOG_DEBUG("\nPerf settings change — reloading all slots via reload_all_patch_date()\n\n");
+        RT_LOG_DEBUG("\nPerf settings change — reloading all slots via reload_all_patch_date()\n\n");
 
         //if (reload_all_patch_data() != EXIT_SUCCESS) {
         //    LOG_ERROR("reload_all_patch_data failed\n");
@@ -4570,7 +4986,7 @@ static void state_handler(void) {
     for (int i = 0; i < MAX_SLOTS; i++) {
         if (gotPatchChangeIndication[i] == true) {
             gotPatchChangeIndication[i] = false;
-            LOG_DEBUG("Patch change on slot %u — reloading\n", i);
+            RT_LOG_DEBUG("Patch change on slot %u — reloading\n", i);
             send_stop();
             send_get_patch_data(i);
             send_start();
@@ -4585,27 +5001,86 @@ static void state_handler(void) {
     }
 
     // Command from UI thread
-    if (msg_receive(&gToUsbThread, eRcvPoll, &messageContent) == EXIT_SUCCESS) {
-        send_write_data(&messageContent);
-
+    if (usb_comms_next_command(&messageContent) == true) {
+        if (command_needs_stop_start(messageContent.cmd) || (messageContent.cmd == eMsgCmdBeginBatch)) {
+            send_batch_window(&messageContent);
+        } else {
+            send_write_data(&messageContent);
+        }
         return;
     }
 #if 0
     // Keepalive: if no outbound traffic for a while, send a lightweight request.
     // If the G2 doesn't respond, treat it as a bad connection and force a reconnect.
     if (time(NULL) - gLastActivityTime >= USB_KEEPALIVE_INTERVAL_S) {
-        LOG_DEBUG("USB keepalive\n");
+        RT_LOG_DEBUG("USB keepalive\n");
 
         if (send_get_patch_version(0) != EXIT_SUCCESS) {
-            LOG_DEBUG("Keepalive failed — forcing reconnect\n");
+            RT_LOG_DEBUG("Keepalive failed — forcing reconnect\n");
             gotBadConnectionIndication = true;
         }
         return;
     }
 #endif
 
-    // Nothing to do — poll for unsolicited messages (LED, volume, param change)
-    int_rec(ePollYes, SUB_RESPONSE_NULL, USB_RECV_POLL_MS);
+    // Nothing to do. Sleep until the G2 sends something (LED, volume, param change) or the UI queues
+    // a command — send_usb_command() rings usb_comms_wake() — rather than polling every 50ms: a queued
+    // edit went out up to 50ms late, and an idle editor woke 20 times a second to find nothing. The
+    // sleep itself only looks; int_rec() reads what woke it, through the same paths as ever, as it
+    // does when the transport is down and it is int_rec() that has to say so.
+    int waited = usb_transport_wait(&gTransport, 0x81, USB_IDLE_WAIT_MS);
+
+    if ((waited != USB_TRANSPORT_WOKEN) && (waited != USB_TRANSPORT_TIMEOUT)) {
+        int_rec(ePollYes, SUB_RESPONSE_NULL, USB_RECV_POLL_MS);
+    }
+}
+
+// The next UI command for the device, through the stage. Every reader of gToUsbThread on this thread
+// goes through here, so nothing can be taken from the queue out of turn with what the stage holds.
+bool usb_comms_next_command(tMessageContent * command) {
+    bool found = usb_coalesce_receive(&gCommandStage, &gToUsbThread, command);
+
+    atomic_store_explicit(&gCoalescedCommands, gCommandStage.merged, memory_order_relaxed);
+    return found;
+}
+
+// A bulk job's yield: sends whatever the realtime lane has staged — values, morph ranges, notes,
+// variation selects the user made while the job ran — then returns to the job. Called between bank
+// locations, so a dial or a key waits for at most one location's round trip rather than for the whole
+// bank. A realtime command queued behind an edit goes too, unless it may depend on that edit — a
+// value for the module the edit adds, say. Edits are not sent here: they wait for the job, in order,
+// as before, and so does anything that depends on one. See usbCoalesce.h.
+static void serve_realtime_lane(void) {
+    tMessageContent command = {0};
+
+    while ((gotBadConnectionIndication == false)
+           && usb_coalesce_receive_realtime(&gCommandStage, &gToUsbThread, &command)) {
+        send_write_data(&command);
+        atomic_fetch_add_explicit(&gRealtimeInBulk, 1, memory_order_relaxed);
+    }
+    atomic_store_explicit(&gCoalescedCommands, gCommandStage.merged, memory_order_relaxed);
+}
+
+uint64_t usb_comms_coalesced_commands(void) {
+    return atomic_load_explicit(&gCoalescedCommands, memory_order_relaxed);
+}
+
+uint64_t usb_comms_realtime_in_bulk(void) {
+    return atomic_load_explicit(&gRealtimeInBulk, memory_order_relaxed);
+}
+
+uint32_t usb_comms_last_connect(uint32_t * warmSlots) {
+    if (warmSlots != NULL) {
+        *warmSlots = gLastWarmSlots;
+    }
+    return gLastConnectMs;
+}
+
+uint64_t usb_comms_stop_windows(uint64_t * commands) {
+    if (commands != NULL) {
+        *commands = atomic_load_explicit(&gBatchedCommands, memory_order_relaxed);
+    }
+    return atomic_load_explicit(&gBatchWindows, memory_order_relaxed);
 }
 
 // ---------------------------------------------------------------------------
@@ -4613,7 +5088,7 @@ static void state_handler(void) {
 // ---------------------------------------------------------------------------
 
 static void usb_comms_signal_handler(int sigraised) {
-    LOG_DEBUG("USBComms signal %d\n", sigraised);
+    RT_LOG_DEBUG("USBComms signal %d\n", sigraised);
     _exit(0);
 }
 
@@ -4628,12 +5103,17 @@ static int usb_comms_init_signals(void) {
 
 static void * usb_thread_loop(void * arg) {
     usb_comms_init_signals();
+    // Everything this thread logs goes through its ring, so a slow write to the log never holds up a
+    // reply the G2 is waiting for. See rtLog.h.
+    rt_log_register_thread("usb");
     msg_init(&gToUsbThread, "toUsbThread", sizeof(tMessageContent));
+    usb_coalesce_init(&gCommandStage);
     msg_init(&gToGuiThread, "toGuiThread", sizeof(tMessageContent)); // reverse: USB thread -> UI thread (drained in the render loop)
     usb_log_open();
 
-    if (libusb_init(&libUsbCtx) != LIBUSB_SUCCESS) {
-        LOG_ERROR("libusb_init failed\n");
+    if ((gStandIn == NULL) && (libusb_init(&libUsbCtx) != LIBUSB_SUCCESS)) {
+        RT_LOG_ERROR("libusb_init failed\n");
+        rt_log_unregister_thread();
         return NULL;
     }
     // Only if needed: libusb_set_option(libUsbCtx, LIBUSB_OPTION_LOG_LEVEL, LIBUSB_LOG_LEVEL_WARNING);
@@ -4645,19 +5125,36 @@ static void * usb_thread_loop(void * arg) {
     close_device();
     pthread_mutex_unlock(&usbStaticMutex);
 
-    libusb_exit(libUsbCtx);
+    if (gStandIn == NULL) {
+        libusb_exit(libUsbCtx);
+    }
     usb_log_close();
+    rt_log_unregister_thread();
     return NULL;
 }
 
 void usb_signal_reconnect(void) {
-    LOG_DEBUG("System wake detected — forcing USB reconnect\n");
+    RT_LOG_DEBUG("System wake detected — forcing USB reconnect\n");
     gotBadConnectionIndication = true;
+    usb_comms_wake();
+}
+
+void usb_comms_wake(void) {
+    usb_transport_wake(&gTransport);
+}
+
+void usb_comms_use_stand_in(const tUsbStandIn * standIn) {
+    gStandIn = standIn;
 }
 
 void start_usb_thread(void) {
+    // Before the thread, and before anything can ring it: the UI may queue a command the moment this
+    // returns.
+    usb_transport_init(&gTransport);
+    register_usb_command_wake_cb(usb_comms_wake);
+
     if (pthread_create(&usbThread, NULL, usb_thread_loop, NULL) != EXIT_SUCCESS) {
-        LOG_ERROR("Failed to create USB thread\n");
+        RT_LOG_ERROR("Failed to create USB thread\n");
         exit(EXIT_FAILURE);
     }
 }
@@ -21,6 +21,11 @@
 #define __USB_COMMS_H__
 
 #include "sysIncludes.h"
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "usbTransport.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,6 +36,69 @@ void register_glfw_wake_cb(void ( *func_ptr )(void));
 void register_full_patch_change_notify_cb(void ( *func_ptr )(void));
 void usb_signal_reconnect(void);                             // Call on system wake to force USB re-init
 
+// Wakes the USB thread if it is idle, so a command just queued for it goes now. Any thread.
+// send_usb_command() (protocol.h) calls it; nothing else needs to.
+void usb_comms_wake(void);
+
+// USB thread. The next command the UI has queued for the device, with superseded parameter values
+// already merged away (see usbCoalesce.h). Returns false if there is none. Take commands only through
+// this: the queue and the stage in front of it are one FIFO.
+bool usb_comms_next_command(tMessageContent * command);
+
+// How many queued parameter writes were dropped because a later one for the same parameter replaced
+// them before they were sent. Any thread.
+uint64_t usb_comms_coalesced_commands(void);
+
+// How many stop/start windows have been opened around structural edits, and (in *commands, if not
+// NULL) how many device commands went out inside them. Without batching the two would be equal. Any
+// thread.
+uint64_t usb_comms_stop_windows(uint64_t * commands);
+
+// How many realtime commands — values, morph ranges, notes, variation selects — went out in the middle
+// of a bank backup or restore rather than waiting for it to finish. Any thread.
+uint64_t usb_comms_realtime_in_bulk(void);
+
+// How long the last connection took to come on line, in ms from the G2 being opened, and (in
+// *warmSlots, if not NULL) how many slots it kept from before a reconnect rather than pulling them
+// again — 0 for a cold start. A kept slot has had its patch dump read again and found unchanged, values
+// and all; what it skipped is the rest of a pull. Any thread.
+uint32_t usb_comms_last_connect(uint32_t * warmSlots);
+
+// A STAND-IN FOR THE G2: something other than libusb behind the transport — tools/g2Emulator.c, which
+// answers the protocol as a G2 would. The USB thread runs unchanged on top of it: the same state
+// machine, the same reconnect, the same parsers; only where the transfers go differs. Results from the
+// backend are libusb's codes, as the libusb backend's are.
+//
+// open() is the USB thread's attempt to open the device: false while there is none to open, as when a
+// G2 is unplugged, and it is tried again on the usual reconnect poll. close() follows every successful
+// open(), after the transport has stopped. ctx is passed to both and to the backend.
+typedef struct {
+    const tUsbBackend * backend;
+    void *              ctx;
+    bool                (*open)(void * ctx);
+    void                (*close)(void * ctx);
+} tUsbStandIn;
+
+// Before start_usb_thread(), and once: the USB thread then never touches libusb. The stand-in must
+// outlive the thread.
+void usb_comms_use_stand_in(const tUsbStandIn * standIn);
+
+// INBOUND FRAMING. What the receive path does with a message once it has read one, split out so that a
+// recorded message can be put through exactly the same code (tools/usbreplay.c). Either runs the
+// parsers, which write the module database and the globals as a live message would. USB thread only —
+// or any single thread, with the USB thread not running.
+//
+// A message from the interrupt endpoint (0x81). Returns false if it is neither an embedded reply nor an
+// extended header, and has done nothing. An embedded reply is checked and parsed: *result is
+// EXIT_SUCCESS or EXIT_FAILURE and *response the sub-command it answered. An extended header sets
+// *extendedLength to the length of the message that follows on 0x82, which the caller reads and
+// passes to usb_comms_parse_extended(); *extendedLength is 0 otherwise.
+bool usb_comms_parse_interrupt(uint8_t * buff, int length, int * result, int * response, int * extendedLength);
+
+// A message from the extended endpoint (0x82), length bytes of it including the CRC. Checked and
+// parsed; *response as above.
+int usb_comms_parse_extended(uint8_t * buff, int length, int * response);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include <time.h>
 #include <errno.h>
 #include <string.h>
@@ -28,93 +31,250 @@
 
 #ifdef ENABLE_USB_LOG
 
-static FILE * logFile = NULL;
+// See usbLog.h for what this is for and for the file format.
+
+#define USB_LOG_RING_BYTES    (1U << 20)     // a power of two; sixteen of the largest extended messages
+#define USB_LOG_TEXT_BYTES    (512U)
+#define USB_LOG_DRAIN_NS      (20000000L)    // how often the writer looks at the ring
+
+// ONE WRITER AT A TIME, ONE READER. head and tail count bytes ever written and ever taken, and are
+// masked into the ring only to address it, so head - tail is always what is waiting. head is advanced
+// only by whichever thread holds producing, after its whole record is in; tail only by the writer
+// thread, after the bytes behind it are on their way to the file. Each reads the other's with acquire.
+//
+// A record in the ring is laid out exactly as it is in the file, so the writer copies spans of the
+// ring to it without looking at what they hold.
+static uint8_t          gRing[USB_LOG_RING_BYTES];
+static _Atomic uint64_t gHead      = 0;
+static _Atomic uint64_t gTail      = 0;
+static atomic_flag      gProducing = ATOMIC_FLAG_INIT;
+static _Atomic uint64_t gDropped   = 0;
+static _Atomic bool     gOpen      = false;
+static _Atomic bool     gWriterRun = false;
+static pthread_t        gWriter;
+static FILE *           logFile    = NULL;
+static uint64_t         gReported  = 0;     // writer only: the dropped count last put in the file
+
+static uint64_t now_nanos(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_REALTIME, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+// The header in file order. Native byte order is the file's: every machine the editor builds for is
+// little-endian, and the decoder reads it as such whatever it runs on.
+static void fill_header(uint8_t * header, tUsbLogRecord type, uint8_t direction, uint8_t endpoint,
+                        uint32_t length, uint64_t nanos) {
+    header[0] = (uint8_t)type;
+    header[1] = direction;
+    header[2] = endpoint;
+    header[3] = 0;
+    memcpy(&header[4], &length, sizeof(length));
+    memcpy(&header[8], &nanos, sizeof(nanos));
+}
+
+static void ring_copy_in(uint64_t at, const void * data, uint32_t bytes) {
+    uint32_t offset = (uint32_t)(at & (USB_LOG_RING_BYTES - 1U));
+    uint32_t first  = ((USB_LOG_RING_BYTES - offset) < bytes) ? (USB_LOG_RING_BYTES - offset) : bytes;
+
+    memcpy(&gRing[offset], data, first);
+    memcpy(&gRing[0], (const uint8_t *)data + first, bytes - first);
+}
+
+// The only thing a logging thread does: one record into the ring, or a count if it cannot have one.
+static void post(tUsbLogRecord type, uint8_t direction, uint8_t endpoint, const void * data, size_t length) {
+    uint8_t  header[USB_LOG_HEADER_BYTES];
+    uint64_t head  = 0;
+    uint64_t bytes = USB_LOG_HEADER_BYTES + (uint64_t)length;
+
+    if (atomic_load_explicit(&gOpen, memory_order_acquire) == false) {
+        return;
+    }
+
+    // Another thread mid-record: drop this one rather than wait for it. (Or usb_log_close() has the
+    // ring, in which case there is nothing to count it against.)
+    if (atomic_flag_test_and_set_explicit(&gProducing, memory_order_acquire) == true) {
+        if (atomic_load_explicit(&gOpen, memory_order_acquire) == true) {
+            atomic_fetch_add_explicit(&gDropped, 1, memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (atomic_load_explicit(&gOpen, memory_order_acquire) == false) {
+        atomic_flag_clear_explicit(&gProducing, memory_order_release);
+        return;
+    }
+    head = atomic_load_explicit(&gHead, memory_order_relaxed);
+
+    if ((bytes > (USB_LOG_RING_BYTES - (head - atomic_load_explicit(&gTail, memory_order_acquire))))
+        || (length > UINT32_MAX)) {
+        atomic_fetch_add_explicit(&gDropped, 1, memory_order_relaxed);
+    } else {
+        fill_header(header, type, direction, endpoint, (uint32_t)length, now_nanos());
+        ring_copy_in(head, header, USB_LOG_HEADER_BYTES);
+        ring_copy_in(head + USB_LOG_HEADER_BYTES, data, (uint32_t)length);
+        atomic_store_explicit(&gHead, head + bytes, memory_order_release);
+    }
+    atomic_flag_clear_explicit(&gProducing, memory_order_release);
+}
+
+// Writer thread only, and usb_log_open()/usb_log_close() while it is not running.
+static void write_record(tUsbLogRecord type, const void * data, uint32_t length) {
+    uint8_t header[USB_LOG_HEADER_BYTES];
+
+    fill_header(header, type, 0, 0, length, now_nanos());
+    fwrite(header, 1, sizeof(header), logFile);
+
+    if (length > 0) {
+        fwrite(data, 1, length, logFile);
+    }
+}
+
+// Everything in the ring to the file, then a dropped record if the count has moved. A drop has no
+// place in the ring — a full ring is usually why it happened — so the marker goes where the writer
+// noticed it: after the records that were waiting, within one drain period of the gap. Good enough to
+// tell the reader not to trust the sequence there, which is all it is for.
+static void drain(void) {
+    uint64_t dropped = atomic_load_explicit(&gDropped, memory_order_relaxed);
+    uint64_t head    = atomic_load_explicit(&gHead, memory_order_acquire);
+    uint64_t tail    = atomic_load_explicit(&gTail, memory_order_relaxed);
+
+    while (tail != head) {
+        uint32_t offset = (uint32_t)(tail & (USB_LOG_RING_BYTES - 1U));
+        uint64_t span   = head - tail;
+
+        if (span > (USB_LOG_RING_BYTES - offset)) {
+            span = USB_LOG_RING_BYTES - offset;
+        }
+        fwrite(&gRing[offset], 1, (size_t)span, logFile);
+        tail += span;
+    }
+    atomic_store_explicit(&gTail, tail, memory_order_release);
+
+    if (dropped != gReported) {
+        uint64_t missing = dropped - gReported;
+
+        write_record(eUsbLogRecordDropped, &missing, sizeof(missing));
+        gReported = dropped;
+    }
+    fflush(logFile);
+}
+
+static void * writer_thread(void * arg) {
+    const struct timespec period = {0, USB_LOG_DRAIN_NS};
+
+    (void)arg;
+
+    while (atomic_load(&gWriterRun) == true) {
+        nanosleep(&period, NULL);
+        drain();
+    }
+    return NULL;
+}
 
 void usb_log_open(void) {
     char         path[1024] = {0};
     const char * home       = getenv("HOME");
+    uint8_t      session[USB_LOG_MAGIC_BYTES + sizeof(uint32_t)];
+    uint32_t     version    = USB_LOG_VERSION;
+
+    if (atomic_load(&gOpen) == true) {
+        return;
+    }
 
     if (home != NULL) {
-        snprintf(path, sizeof(path), "%s/G2_usb.log", home);
+        snprintf(path, sizeof(path), "%s/G2_usb.bin", home);
     } else {
-        snprintf(path, sizeof(path), "/tmp/G2_usb.log");
+        snprintf(path, sizeof(path), "/tmp/G2_usb.bin");
     }
     // APPEND, not truncate. This used to open "w", so relaunching the app destroyed the previous
     // session's capture — which is precisely the wrong behaviour when the thing being captured is a
     // fault that only shows on a particular device state and may not survive being reproduced twice.
-    // Each session is separated by the marker below. Grows without bound; this is a temporary
+    // Each session starts with its own session record. Grows without bound; this is a temporary
     // diagnostic (see ENABLE_USB_LOG in defs.h) and the file is meant to be deleted afterwards.
-    logFile = fopen(path, "a");
+    logFile = fopen(path, "ab");
 
     if (logFile == NULL) {
         fprintf(stderr, "usb_log_open: failed to open %s (errno=%d %s)\n", path, errno, strerror(errno));
         return;
     }
-    {
-        time_t    now      = time(NULL);
-        struct tm tmInfo;
-        char      when[64] = {0};
-
-        localtime_r(&now, &tmInfo);
-        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tmInfo);
-        fprintf(logFile, "\n--- session start %s ---\n", when);
-    }
+    memcpy(session, USB_LOG_MAGIC, USB_LOG_MAGIC_BYTES);
+    memcpy(&session[USB_LOG_MAGIC_BYTES], &version, sizeof(version));
+    write_record(eUsbLogRecordSession, session, sizeof(session));
     fflush(logFile);
-}
 
-void usb_log_close(void) {
-    if (logFile != NULL) {
-        fprintf(logFile, "--- session end ---\n");
-        fflush(logFile);
+    atomic_store(&gHead, 0);
+    atomic_store(&gTail, 0);
+    atomic_store(&gDropped, 0);
+    gReported = 0;
+    atomic_store(&gWriterRun, true);
+
+    if (pthread_create(&gWriter, NULL, writer_thread, NULL) != 0) {
+        fprintf(stderr, "usb_log_open: failed to start the writer thread\n");
+        atomic_store(&gWriterRun, false);
         fclose(logFile);
         logFile = NULL;
+        return;
     }
+    atomic_store_explicit(&gOpen, true, memory_order_release);
 }
 
-void usb_log_text(const char * fmt, ...) {
-    struct timespec ts;
-    struct tm       tmInfo;
-    va_list         args;
+void usb_log_close(void) {
+    uint64_t dropped = 0;
 
-    if (logFile == NULL) {
+    if (atomic_load(&gOpen) == false) {
         return;
     }
-    clock_gettime(CLOCK_REALTIME, &ts);
-    localtime_r(&ts.tv_sec, &tmInfo);
+    atomic_store_explicit(&gOpen, false, memory_order_release);
 
-    fprintf(logFile, "[%02d:%02d:%02d.%03d] ",
-            tmInfo.tm_hour, tmInfo.tm_min, tmInfo.tm_sec,
-            (int)(ts.tv_nsec / 1000000));
+    // A thread that was already inside post() finishes its record before this can have the ring, and
+    // the ring stays held until the file is closed, so nothing lands in it after the last drain.
+    while (atomic_flag_test_and_set_explicit(&gProducing, memory_order_acquire) == true) {
+        // a producer holds it for one record's copy
+    }
+    atomic_store(&gWriterRun, false);
+    pthread_join(gWriter, NULL);
+    drain();
+    write_record(eUsbLogRecordEnd, NULL, 0);
+    fflush(logFile);
+    fclose(logFile);
+    logFile = NULL;
+    atomic_flag_clear_explicit(&gProducing, memory_order_release);
 
-    va_start(args, fmt);
-    vfprintf(logFile, fmt, args);
-    va_end(args);
+    dropped = atomic_load(&gDropped);
 
-    fflush(logFile);
+    if (dropped > 0) {
+        fprintf(stderr, "usb_log_close: %llu records dropped this session — the ring was full or contended\n",
+                (unsigned long long)dropped);
+    }
 }
 
-void usb_log_message(const char * direction, const uint8_t * data, size_t length) {
-    struct timespec ts;
-    struct tm       tmInfo;
-    size_t          i;
+// Formatted on the calling thread, which is a cost the caller chose; the write is still the writer's.
+void usb_log_text(const char * fmt, ...) {
+    char    text[USB_LOG_TEXT_BYTES];
+    int     length = 0;
+    va_list args;
 
-    if (logFile == NULL) {
+    if (atomic_load_explicit(&gOpen, memory_order_acquire) == false) {
         return;
     }
-    clock_gettime(CLOCK_REALTIME, &ts);
-    localtime_r(&ts.tv_sec, &tmInfo);
+    va_start(args, fmt);
+    length = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
 
-    fprintf(logFile, "[%02d:%02d:%02d.%03d] %s %zu bytes:",
-            tmInfo.tm_hour, tmInfo.tm_min, tmInfo.tm_sec,
-            (int)(ts.tv_nsec / 1000000),
-            direction, length);
+    if (length < 0) {
+        return;
+    }
 
-    for (i = 0; i < length; i++) {
-        fprintf(logFile, " %02x", data[i]);
+    if ((size_t)length >= sizeof(text)) {
+        length = (int)sizeof(text) - 1;
     }
+    post(eUsbLogRecordText, 0, 0, text, (size_t)length);
+}
 
-    fprintf(logFile, "\n");
-    fflush(logFile);
+void usb_log_message(tUsbLogDirection direction, uint8_t endpoint, const uint8_t * data, size_t length) {
+    post(eUsbLogRecordMessage, (uint8_t)direction, endpoint, data, length);
 }
 
 #endif // ENABLE_USB_LOG
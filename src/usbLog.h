@@ -24,16 +24,68 @@
 #include <stddef.h>
 #include "defs.h"
 
+// THE USB TRAFFIC LOG (ENABLE_USB_LOG in defs.h): every message to and from the G2, raw, with the time
+// it moved.
+//
+// It used to print each message as hex, a byte at a time through fprintf, and fflush it, on the USB
+// thread, between one transfer and the next — enough added latency that turning the log on could hide
+// the timing fault it was turned on to catch. Now the USB thread only copies the bytes into a ring,
+// and a writer thread of the log's own moves the ring to the file in large writes. Logging a message
+// costs a copy and a few atomic operations; it never waits for the disk or for a lock.
+//
+// A full ring, or a second thread logging at the same moment as the first, DROPS the record and
+// counts it. The writer puts the count into the file where the records went missing, and
+// usb_log_close() says the session's total on stderr — a gap is reported, never silently closed up,
+// and never traded for a stall.
+//
+// The file is ~/G2_usb.bin (or /tmp/G2_usb.bin), appended to, one session after another. It is binary:
+// tools/usblogdecode.c turns it back into the text the log used to write directly. The format, all
+// little-endian, is a run of records, each a 16-byte header and then length bytes of payload:
+//
+//   offset 0    uint8   type         a tUsbLogRecord
+//          1    uint8   direction    a tUsbLogDirection, for eUsbLogRecordMessage
+//          2    uint8   endpoint     for eUsbLogRecordMessage
+//          3    uint8   reserved     0
+//          4    uint32  length       payload bytes that follow
+//          8    uint64  nanos        CLOCK_REALTIME, in ns since the epoch
+//
+// and what each payload holds:
+//
+//   eUsbLogRecordSession    USB_LOG_MAGIC, then the uint32 USB_LOG_VERSION; starts every session
+//   eUsbLogRecordMessage    the message's bytes, exactly as they went over the bus
+//   eUsbLogRecordText       a usb_log_text() line, not terminated
+//   eUsbLogRecordDropped    a uint64: records dropped since the previous eUsbLogRecordDropped
+//   eUsbLogRecordEnd        nothing; the session closed cleanly
+
+#define USB_LOG_MAGIC            "G2USBLOG"    // 8 bytes, no terminator in the file
+#define USB_LOG_MAGIC_BYTES      (8U)
+#define USB_LOG_VERSION          (1U)
+#define USB_LOG_HEADER_BYTES     (16U)
+
+typedef enum {
+    eUsbLogRecordSession = 0,
+    eUsbLogRecordMessage,
+    eUsbLogRecordText,
+    eUsbLogRecordDropped,
+    eUsbLogRecordEnd,
+} tUsbLogRecord;
+
+typedef enum {
+    eUsbLogRx = 0,       // the interrupt endpoint
+    eUsbLogTx,
+    eUsbLogExtended,     // the bulk IN endpoint's extended messages
+} tUsbLogDirection;
+
 #ifdef ENABLE_USB_LOG
 void usb_log_open(void);
 void usb_log_close(void);
-void usb_log_message(const char * direction, const uint8_t * data, size_t length);
-void usb_log_text(const char * fmt, ...);
+void usb_log_message(tUsbLogDirection direction, uint8_t endpoint, const uint8_t * data, size_t length);
+void usb_log_text(const char * fmt, ...) __attribute__((format(printf, 1, 2)));
 #else
 #define usb_log_open()
 #define usb_log_close()
-#define usb_log_message(direction, data, length)    ((void)0)
-#define usb_log_text(fmt, ...)                      ((void)0)
+#define usb_log_message(direction, endpoint, data, length)    ((void)0)
+#define usb_log_text(fmt, ...)                                ((void)0)
 #endif
 
 #endif // __USB_LOG_H__
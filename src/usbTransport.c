@@ -0,0 +1,502 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "usbTransport.h"
+
+// See usbTransport.h for what this is and why.
+//
+// Locking: transport->lock guards every transfer's busy/result/actual, the rings and the counters.
+// The backend is never called with it held — a backend is entitled to take locks of its own in
+// submit() that its event loop holds while calling usb_transport_completed(), and libusb does.
+
+#define USB_TRANSPORT_ALIGN(n)    (((n) + 15U) & ~(size_t)15U)
+
+// A deadline ms from now, in the clock pthread_cond_timedwait() measures by default. macOS has no
+// pthread_condattr_setclock(), so it is CLOCK_REALTIME on every platform.
+static void deadline_after(struct timespec * deadline, uint32_t ms) {
+    (void)clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec  += (time_t)(ms / 1000U);
+    deadline->tv_nsec += (long)(ms % 1000U) * 1000000L;
+
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// Waits for a change until deadline, with the lock held. False once the deadline has passed.
+static bool wait_for_change(tUsbTransport * transport, const struct timespec * deadline) {
+    return pthread_cond_timedwait(&transport->changed, &transport->lock, deadline) != ETIMEDOUT;
+}
+
+static tUsbInLane * find_lane(tUsbTransport * transport, uint8_t endpoint) {
+    for (uint32_t l = 0; l < transport->inCount; l++) {
+        if (transport->in[l].endpoint == endpoint) {
+            return &transport->in[l];
+        }
+    }
+    return NULL;
+}
+
+static bool lane_has_flight(const tUsbInLane * lane) {
+    for (uint32_t i = 0; i < USB_TRANSPORT_IN_DEPTH; i++) {
+        if (lane->transfer[i].busy) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Submits a transfer already marked busy, undoing that if the backend refuses it. Lock NOT held.
+static int submit(tUsbTransport * transport, tUsbTransfer * transfer) {
+    int result = transport->backend->submit(transport->ctx, transfer);
+
+    if (result != USB_TRANSPORT_OK) {
+        pthread_mutex_lock(&transport->lock);
+        transfer->busy = false;
+        transport->inFlight--;
+
+        if (transfer->lane < transport->inCount) {
+            transport->in[transfer->lane].submitError = result;
+        }
+        pthread_cond_broadcast(&transport->changed);
+        pthread_mutex_unlock(&transport->lock);
+    }
+    return result;
+}
+
+static void * event_thread(void * arg) {
+    tUsbTransport * transport = (tUsbTransport *)arg;
+
+    while (atomic_load_explicit(&transport->running, memory_order_acquire)) {
+        transport->backend->handle_events(transport->ctx, USB_TRANSPORT_EVENT_MS);
+    }
+    return NULL;
+}
+
+void usb_transport_init(tUsbTransport * transport) {
+    memset(transport, 0, sizeof(*transport));
+    pthread_mutex_init(&transport->lock, NULL);
+    pthread_cond_init(&transport->changed, NULL);
+}
+
+// Releases every transfer the backend allocated, and the memory. Nothing may be in flight.
+static void release_all(tUsbTransport * transport) {
+    for (uint32_t l = 0; l < transport->inCount; l++) {
+        for (uint32_t i = 0; i < USB_TRANSPORT_IN_DEPTH; i++) {
+            if (transport->in[l].transfer[i].handle != NULL) {
+                transport->backend->release(transport->ctx, &transport->in[l].transfer[i]);
+            }
+        }
+    }
+
+    for (uint32_t s = 0; s < USB_TRANSPORT_OUT_SLOTS; s++) {
+        if (transport->out[s].handle != NULL) {
+            transport->backend->release(transport->ctx, &transport->out[s]);
+        }
+    }
+    free(transport->memory);
+    transport->memory  = NULL;
+    transport->in      = NULL;
+    transport->out     = NULL;
+    transport->inCount = 0;
+}
+
+bool usb_transport_start(tUsbTransport * transport, const tUsbBackend * backend, void * ctx,
+                         const uint8_t * inEndpoints, const int * inSizes, uint32_t inCount, int outSize) {
+    size_t bytes = 0;
+
+    if (transport->started || (inCount > USB_TRANSPORT_MAX_IN)) {
+        return false;
+    }
+
+    // One block: the lanes, the OUT slots, then every buffer.
+    bytes += USB_TRANSPORT_ALIGN(sizeof(tUsbInLane) * inCount);
+    bytes += USB_TRANSPORT_ALIGN(sizeof(tUsbTransfer) * USB_TRANSPORT_OUT_SLOTS);
+
+    for (uint32_t l = 0; l < inCount; l++) {
+        bytes += USB_TRANSPORT_ALIGN((size_t)inSizes[l]) * USB_TRANSPORT_IN_DEPTH;
+    }
+    bytes                += USB_TRANSPORT_ALIGN((size_t)outSize) * USB_TRANSPORT_OUT_SLOTS;
+
+    transport->memory     = (uint8_t *)calloc(1, bytes);
+
+    if (transport->memory == NULL) {
+        return false;
+    }
+    uint8_t * next        = transport->memory;
+
+    transport->backend    = backend;
+    transport->ctx        = ctx;
+    transport->generation++;
+    transport->stopping   = false;
+    transport->inFlight   = 0;
+    transport->in         = (tUsbInLane *)next;
+    next                 += USB_TRANSPORT_ALIGN(sizeof(tUsbInLane) * inCount);
+    transport->out        = (tUsbTransfer *)next;
+    next                 += USB_TRANSPORT_ALIGN(sizeof(tUsbTransfer) * USB_TRANSPORT_OUT_SLOTS);
+    transport->inCount    = inCount;
+
+    for (uint32_t l = 0; l < inCount; l++) {
+        tUsbInLane * lane = &transport->in[l];
+
+        lane->endpoint = inEndpoints[l];
+
+        for (uint32_t i = 0; i < USB_TRANSPORT_IN_DEPTH; i++) {
+            tUsbTransfer * transfer = &lane->transfer[i];
+
+            transfer->owner       = transport;
+            transfer->endpoint    = inEndpoints[l];
+            transfer->buffer      = next;
+            transfer->size        = inSizes[l];
+            transfer->length      = inSizes[l];
+            transfer->lane        = l;
+            transfer->index       = i;
+            transfer->generation  = transport->generation;
+            next                 += USB_TRANSPORT_ALIGN((size_t)inSizes[l]);
+        }
+    }
+
+    for (uint32_t s = 0; s < USB_TRANSPORT_OUT_SLOTS; s++) {
+        tUsbTransfer * transfer = &transport->out[s];
+
+        transfer->owner       = transport;
+        transfer->buffer      = next;
+        transfer->size        = outSize;
+        transfer->lane        = USB_TRANSPORT_MAX_IN;
+        transfer->index       = s;
+        transfer->generation  = transport->generation;
+        next                 += USB_TRANSPORT_ALIGN((size_t)outSize);
+    }
+
+    // Allocate everything before submitting anything, so a failure part way has nothing to cancel.
+    bool allocated = true;
+
+    for (uint32_t l = 0; (l < inCount) && allocated; l++) {
+        for (uint32_t i = 0; (i < USB_TRANSPORT_IN_DEPTH) && allocated; i++) {
+            allocated = backend->alloc(ctx, &transport->in[l].transfer[i]);
+        }
+    }
+
+    for (uint32_t s = 0; (s < USB_TRANSPORT_OUT_SLOTS) && allocated; s++) {
+        allocated = backend->alloc(ctx, &transport->out[s]);
+    }
+
+    if (allocated == false) {
+        release_all(transport);
+        return false;
+    }
+    atomic_store_explicit(&transport->running, true, memory_order_release);
+
+    if (pthread_create(&transport->events, NULL, event_thread, transport) != 0) {
+        atomic_store_explicit(&transport->running, false, memory_order_release);
+        release_all(transport);
+        return false;
+    }
+    transport->started = true;
+
+    for (uint32_t l = 0; l < inCount; l++) {
+        for (uint32_t i = 0; i < USB_TRANSPORT_IN_DEPTH; i++) {
+            pthread_mutex_lock(&transport->lock);
+            transport->in[l].transfer[i].busy = true;
+            transport->inFlight++;
+            pthread_mutex_unlock(&transport->lock);
+
+            (void)submit(transport, &transport->in[l].transfer[i]);    // a failure shows at the first receive
+        }
+    }
+    transport->sent       = 0;
+    transport->received   = 0;
+    return true;
+}
+
+bool usb_transport_stop(tUsbTransport * transport) {
+    tUsbTransfer *  flying[(USB_TRANSPORT_MAX_IN * USB_TRANSPORT_IN_DEPTH) + USB_TRANSPORT_OUT_SLOTS];
+    uint32_t        count   = 0;
+    struct timespec deadline;
+    bool            drained = true;
+
+    if (transport->started == false) {
+        return true;
+    }
+    pthread_mutex_lock(&transport->lock);
+    transport->stopping = true;
+
+    for (uint32_t l = 0; l < transport->inCount; l++) {
+        for (uint32_t i = 0; i < USB_TRANSPORT_IN_DEPTH; i++) {
+            if (transport->in[l].transfer[i].busy) {
+                flying[count++] = &transport->in[l].transfer[i];
+            }
+        }
+    }
+
+    for (uint32_t s = 0; s < USB_TRANSPORT_OUT_SLOTS; s++) {
+        if (transport->out[s].busy) {
+            flying[count++] = &transport->out[s];
+        }
+    }
+    pthread_cond_broadcast(&transport->changed);    // wake any waiter: it will find stopping
+    pthread_mutex_unlock(&transport->lock);
+
+    for (uint32_t f = 0; f < count; f++) {
+        transport->backend->cancel(transport->ctx, flying[f]);
+    }
+
+    // The event thread is still running, and delivers the cancellations.
+    deadline_after(&deadline, USB_TRANSPORT_CANCEL_MS);
+    pthread_mutex_lock(&transport->lock);
+
+    while (transport->inFlight > 0) {
+        if (wait_for_change(transport, &deadline) == false) {
+            break;
+        }
+    }
+    drained = (transport->inFlight == 0);
+    pthread_mutex_unlock(&transport->lock);
+
+    atomic_store_explicit(&transport->running, false, memory_order_release);
+    transport->backend->interrupt(transport->ctx);
+    pthread_join(transport->events, NULL);
+    transport->started = false;
+
+    if (drained) {
+        release_all(transport);
+    } else {
+        // Still owned by the backend. Abandon the block rather than free it under a transfer that may
+        // yet complete into it; usb_transport_completed() ignores it by its generation when it does.
+        transport->memory  = NULL;
+        transport->in      = NULL;
+        transport->out     = NULL;
+        transport->inCount = 0;
+    }
+    return drained;
+}
+
+void usb_transport_completed(tUsbTransfer * transfer, int result, int actual) {
+    tUsbTransport * transport = transfer->owner;
+
+    pthread_mutex_lock(&transport->lock);
+
+    if (transfer->generation != transport->generation) {
+        pthread_mutex_unlock(&transport->lock);
+        return;    // from a connection whose stop gave up on it
+    }
+    transfer->result = result;
+    transfer->actual = actual;
+    transfer->busy   = false;
+    transport->inFlight--;
+
+    if ((transfer->lane < transport->inCount) && (transport->stopping == false)) {
+        tUsbInLane * lane = &transport->in[transfer->lane];
+
+        lane->done[(lane->doneHead + lane->doneCount) % USB_TRANSPORT_IN_DEPTH] = transfer->index;
+        lane->doneCount++;
+    }
+    pthread_cond_broadcast(&transport->changed);
+    pthread_mutex_unlock(&transport->lock);
+}
+
+int usb_transport_send(tUsbTransport * transport, uint8_t endpoint, const uint8_t * data, int length,
+                       int * actual, uint32_t timeoutMs) {
+    tUsbTransfer *  slot   = NULL;
+    struct timespec deadline;
+    int             result = USB_TRANSPORT_OK;
+
+    *actual = 0;
+    pthread_mutex_lock(&transport->lock);
+
+    if ((transport->started == false) || transport->stopping) {
+        pthread_mutex_unlock(&transport->lock);
+        return USB_TRANSPORT_CLOSED;
+    }
+
+    for (uint32_t s = 0; s < USB_TRANSPORT_OUT_SLOTS; s++) {
+        if (transport->out[s].busy == false) {
+            slot = &transport->out[s];
+            break;
+        }
+    }
+
+    if ((slot == NULL) || (length > slot->size)) {
+        pthread_mutex_unlock(&transport->lock);
+        return USB_TRANSPORT_BUSY;    // every slot is a send still being cancelled, or it does not fit
+    }
+    memcpy(slot->buffer, data, (size_t)length);
+    slot->endpoint = endpoint;
+    slot->length   = length;
+    slot->actual   = 0;
+    slot->busy     = true;
+    transport->inFlight++;
+    pthread_mutex_unlock(&transport->lock);
+
+    result         = submit(transport, slot);
+
+    if (result != USB_TRANSPORT_OK) {
+        return result;
+    }
+    deadline_after(&deadline, timeoutMs);
+    pthread_mutex_lock(&transport->lock);
+
+    while (slot->busy && (transport->stopping == false)) {
+        if (wait_for_change(transport, &deadline) == false) {
+            break;
+        }
+    }
+
+    if (slot->busy) {
+        // Timed out, or stopping. Cancel it and wait for the cancellation, so the slot is free for the
+        // next send — or, if even that does not come, leave it busy and the pool one smaller until stop.
+        pthread_mutex_unlock(&transport->lock);
+        transport->backend->cancel(transport->ctx, slot);
+        deadline_after(&deadline, USB_TRANSPORT_CANCEL_MS);
+        pthread_mutex_lock(&transport->lock);
+
+        while (slot->busy) {
+            if (wait_for_change(transport, &deadline) == false) {
+                break;
+            }
+        }
+        *actual = slot->busy ? 0 : slot->actual;
+        result  = USB_TRANSPORT_TIMEOUT;
+    } else {
+        *actual = slot->actual;
+        result  = slot->result;
+        transport->sent++;
+    }
+    pthread_mutex_unlock(&transport->lock);
+    return result;
+}
+
+int usb_transport_wait(tUsbTransport * transport, uint8_t endpoint, uint32_t timeoutMs) {
+    tUsbInLane *    lane   = NULL;
+    struct timespec deadline;
+    int             result = USB_TRANSPORT_OK;
+
+    deadline_after(&deadline, timeoutMs);
+    pthread_mutex_lock(&transport->lock);
+
+    while (true) {
+        if (transport->woken) {
+            transport->woken = false;
+            result           = USB_TRANSPORT_WOKEN;
+            break;
+        }
+
+        if ((transport->started == false) || transport->stopping) {
+            result = USB_TRANSPORT_CLOSED;
+            break;
+        }
+
+        if ((lane = find_lane(transport, endpoint)) == NULL) {
+            result = USB_TRANSPORT_BUSY;
+            break;
+        }
+
+        if (lane->doneCount > 0) {
+            result = USB_TRANSPORT_OK;
+            break;
+        }
+
+        if (lane_has_flight(lane) == false) {
+            result = lane->submitError;
+            break;
+        }
+
+        if (wait_for_change(transport, &deadline) == false) {
+            result = USB_TRANSPORT_TIMEOUT;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&transport->lock);
+    return result;
+}
+
+void usb_transport_wake(tUsbTransport * transport) {
+    pthread_mutex_lock(&transport->lock);
+    transport->woken = true;
+    pthread_cond_broadcast(&transport->changed);
+    pthread_mutex_unlock(&transport->lock);
+}
+
+int usb_transport_receive(tUsbTransport * transport, uint8_t endpoint, uint8_t * data, int size,
+                          int * actual, uint32_t timeoutMs) {
+    tUsbInLane *    lane     = NULL;
+    tUsbTransfer *  transfer = NULL;
+    struct timespec deadline;
+    int             result   = USB_TRANSPORT_OK;
+
+    *actual = 0;
+    deadline_after(&deadline, timeoutMs);
+    pthread_mutex_lock(&transport->lock);
+
+    if ((transport->started == false) || ((lane = find_lane(transport, endpoint)) == NULL)) {
+        pthread_mutex_unlock(&transport->lock);
+        return (transport->started == false) ? USB_TRANSPORT_CLOSED : USB_TRANSPORT_BUSY;
+    }
+
+    while (lane->doneCount == 0) {
+        if (transport->stopping) {
+            pthread_mutex_unlock(&transport->lock);
+            return USB_TRANSPORT_CLOSED;
+        }
+
+        if (lane_has_flight(lane) == false) {
+            // Every transfer on it failed to resubmit, so nothing can arrive. Say why.
+            result = lane->submitError;
+            pthread_mutex_unlock(&transport->lock);
+            return result;
+        }
+
+        if (wait_for_change(transport, &deadline) == false) {
+            pthread_mutex_unlock(&transport->lock);
+            return USB_TRANSPORT_TIMEOUT;
+        }
+    }
+    transfer        = &lane->transfer[lane->done[lane->doneHead]];
+    lane->doneHead  = (lane->doneHead + 1) % USB_TRANSPORT_IN_DEPTH;
+    lane->doneCount--;
+
+    *actual         = (transfer->actual < size) ? transfer->actual : size;
+    memcpy(data, transfer->buffer, (size_t)*actual);
+    result          = transfer->result;
+
+    // Straight back on the endpoint, behind the others.
+    transfer->length = transfer->size;
+    transfer->actual = 0;
+    transfer->busy   = true;
+    transport->inFlight++;
+    transport->received++;
+    pthread_mutex_unlock(&transport->lock);
+
+    (void)submit(transport, transfer);
+    return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __USB_TRANSPORT_H__
+#define __USB_TRANSPORT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// THE USB TRANSPORT: a fixed set of transfers allocated once per connection, and a thread of its own
+// that services them, so that moving a message costs neither an allocation nor a caller spinning on
+// the event loop.
+//
+// What it replaced allocated a transfer for every message, submitted it, spun the event loop on the
+// calling thread until that one transfer finished, and freed it. Nothing was ever waiting on the IN
+// endpoints between reads, so a reply that came back quickly still waited for the next read to be
+// submitted, and nothing overlapped sending with receiving.
+//
+// Here, per connection:
+//
+//   - Every IN endpoint named at start has USB_TRANSPORT_IN_DEPTH transfers submitted at all times.
+//     A completed one is queued, in completion order, on its endpoint's ring; usb_transport_receive()
+//     takes the oldest, copies it out and resubmits it. A reader that falls behind therefore stops
+//     the endpoint once all of its transfers are queued, and the device holds the rest — exactly the
+//     back-pressure a read that was never submitted used to give.
+//   - USB_TRANSPORT_OUT_SLOTS transfers are kept for sending. usb_transport_send() copies into a free
+//     one, submits it and waits for it, so the caller's buffer is its own again when it returns.
+//   - One thread runs the backend's event loop and nothing else. It sleeps in the backend until
+//     something completes — libusb polls its own descriptors there — and is interrupted to stop.
+//     Completions reach the waiting caller through the rings and one condition variable, which
+//     usb_transport_wake() also signals: an idle caller sleeps in usb_transport_wait() until the
+//     device sends something or it has something to send, and for nothing else.
+//
+// The protocol on top is still one request and its reply at a time; that is the G2's, not this
+// file's. What changes is what each one costs, and that a reply is already on its way up while the
+// caller is still returning from the send.
+//
+// Nothing here knows about libusb. The backend — libusb in usbComms.c, a simulated device in
+// tools/usbbench.c — allocates, submits and cancels its own transfers and calls
+// usb_transport_completed() from inside its handle_events(). Results are the backend's own codes,
+// passed through untouched, with USB_TRANSPORT_OK for success and the positive codes below for what
+// the transport itself decides.
+
+#define USB_TRANSPORT_IN_DEPTH       (3U)     // transfers kept submitted on each IN endpoint
+#define USB_TRANSPORT_OUT_SLOTS      (4U)
+#define USB_TRANSPORT_MAX_IN         (2U)     // IN endpoints per transport
+#define USB_TRANSPORT_EVENT_MS       (1000U)  // longest the event thread waits in the backend at once
+#define USB_TRANSPORT_CANCEL_MS      (500U)   // longest a cancelled transfer is waited for
+
+#define USB_TRANSPORT_OK             (0)
+#define USB_TRANSPORT_TIMEOUT        (1)      // nothing completed in time; a send is cancelled first
+#define USB_TRANSPORT_CLOSED         (2)      // not started, or stopping
+#define USB_TRANSPORT_BUSY           (3)      // no OUT slot free, the message too big, or no such endpoint
+#define USB_TRANSPORT_WOKEN          (4)      // usb_transport_wake() ended a usb_transport_wait()
+
+typedef struct tUsbTransport tUsbTransport;
+
+typedef struct {
+    tUsbTransport * owner;
+    void *          handle;        // the backend's own transfer
+    uint8_t         endpoint;
+    uint8_t *       buffer;
+    int             size;          // what buffer holds
+    int             length;        // what this submission moves
+    int             actual;        // what it did move, once complete
+    int             result;        // USB_TRANSPORT_OK or the backend's code, once complete
+    bool            busy;          // submitted and not yet complete
+    uint32_t        lane;          // which in[], or USB_TRANSPORT_MAX_IN for an OUT slot
+    uint32_t        index;         // within it
+    uint32_t        generation;    // the connection it belongs to
+} tUsbTransfer;
+
+typedef struct {
+    bool (*alloc)(void * ctx, tUsbTransfer * transfer);         // once per transfer, at start
+    void (*release)(void * ctx, tUsbTransfer * transfer);       // once per transfer, at stop
+    int  (*submit)(void * ctx, tUsbTransfer * transfer);        // endpoint/buffer/length are set
+    void (*cancel)(void * ctx, tUsbTransfer * transfer);        // it still completes, later
+    void (*handle_events)(void * ctx, uint32_t timeoutMs);      // event thread only
+    void (*interrupt)(void * ctx);                              // makes handle_events() return now
+} tUsbBackend;
+
+typedef struct {
+    uint8_t      endpoint;
+    tUsbTransfer transfer[USB_TRANSPORT_IN_DEPTH];
+    uint32_t     done[USB_TRANSPORT_IN_DEPTH];    // completed transfers, oldest at doneHead
+    uint32_t     doneHead;
+    uint32_t     doneCount;
+    int          submitError;                     // why the last resubmission failed, if one did
+} tUsbInLane;
+
+struct tUsbTransport {
+    const tUsbBackend * backend;
+    void *              ctx;
+    tUsbInLane *        in;          // inCount of them, in memory
+    uint32_t            inCount;
+    tUsbTransfer *      out;         // USB_TRANSPORT_OUT_SLOTS of them, in memory
+    uint8_t *           memory;      // lanes, slots and every buffer; one allocation per connection
+    pthread_mutex_t     lock;
+    pthread_cond_t      changed;     // a transfer completed, a wake, or the transport is stopping
+    pthread_t           events;
+    _Atomic bool        running;     // the event thread's
+    bool                started;
+    bool                stopping;
+    bool                woken;       // usb_transport_wake() since the last usb_transport_wait()
+    uint32_t            inFlight;
+    uint32_t            generation;
+    uint64_t            sent;
+    uint64_t            received;
+};
+
+// Once, before anything else. A transport is started and stopped once per connection.
+void usb_transport_init(tUsbTransport * transport);
+
+// Allocates every transfer, submits the IN ones and starts the event thread. inEndpoints[] and
+// inSizes[] give each IN endpoint and the most one transfer on it can carry; outSize the most one
+// send can. Returns false, leaving nothing running, if any of it failed.
+bool usb_transport_start(tUsbTransport * transport, const tUsbBackend * backend, void * ctx,
+                         const uint8_t * inEndpoints, const int * inSizes, uint32_t inCount, int outSize);
+
+// Cancels everything in flight, waits for it, stops the event thread and frees what start allocated.
+// Returns false if some transfer never completed: its memory is then kept rather than freed under
+// it, and a late completion is ignored. Call before the device handle is closed.
+bool usb_transport_stop(tUsbTransport * transport);
+
+// Sends length bytes on endpoint and waits for them to go. *actual is what went.
+int usb_transport_send(tUsbTransport * transport, uint8_t endpoint, const uint8_t * data, int length,
+                       int * actual, uint32_t timeoutMs);
+
+// The oldest completed transfer on endpoint, copied into data — at most size bytes of it. Waits up to
+// timeoutMs for one. *actual is how many bytes it held.
+int usb_transport_receive(tUsbTransport * transport, uint8_t endpoint, uint8_t * data, int size,
+                          int * actual, uint32_t timeoutMs);
+
+// Waits up to timeoutMs for a completed transfer on endpoint, without taking it, and returns
+// USB_TRANSPORT_OK once there is one. Returns USB_TRANSPORT_WOKEN instead if usb_transport_wake() was
+// called, now or since the last wait — so a wake that lands while the caller is busy elsewhere is not
+// lost. This is an idle thread's sleep: it ends for inbound data or for the wake, whichever is first.
+int usb_transport_wait(tUsbTransport * transport, uint8_t endpoint, uint32_t timeoutMs);
+
+// Ends a usb_transport_wait(), or the next one. Any thread; the transport need not be started, only
+// initialised.
+void usb_transport_wake(tUsbTransport * transport);
+
+// Backend only, from inside handle_events(): transfer has finished, with the backend's result.
+void usb_transport_completed(tUsbTransfer * transfer, int result, int actual);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __USB_TRANSPORT_H__
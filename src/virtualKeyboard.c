@@ -43,6 +43,7 @@ extern "C" {
 #include "globalVars.h"
 #include "graphics.h"
 #include "msgQueue.h"
+#include "protocol.h"
 #include "soundEngine.h"
 #include "utilsGraphics.h"
 
@@ -107,7 +108,7 @@ static void send_note(uint32_t note, bool on) {
     msg.playNoteData.note     = note;
     msg.playNoteData.velocity = gVirtualKeyboard.velocity;
     msg.playNoteData.on       = on;
-    msg_send(&gToUsbThread, &msg);
+    send_usb_command(&msg);
 }
 
 // The single point at which the sounding note changes. Every path goes through here — closing the
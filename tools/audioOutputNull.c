@@ -0,0 +1,292 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <sched.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "audioOutput.h"
+#include "audioOutputNull.h"
+#include "soundEngine.h"
+#include "rtLog.h"
+
+// See audioOutputNull.h. Plain POSIX throughout: this is the backend for the machines CoreAudio is not
+// on.
+
+#define NULL_CHANNELS          (2U)
+#define NULL_DEFAULT_FRAMES    (256U)
+#define NULL_MAX_FRAMES        (8192U)
+#define NULL_LATE_FRACTION     (0.25)      // of a period, past the deadline, to count as a late wake
+
+static pthread_t        gThread;
+static bool             gRunning         = false;
+static _Atomic bool     gRun             = false;
+static double           gConfiguredRate  = 48000.0;
+static bool             gWantRealtime    = false;
+static double           gSampleRate      = 0.0;
+static uint32_t         gBufferFrames    = 0;
+static uint32_t         gLeftChannel     = 0;
+static uint32_t         gRightChannel    = 1;
+static int32_t          gLevelDb         = 0;
+static uint32_t         gCrossfadeMs     = 0;
+
+static _Atomic uint64_t gCallbacks       = 0;
+static _Atomic uint64_t gLateWakes       = 0;
+static _Atomic uint64_t gOverrunWakes    = 0;
+static _Atomic uint64_t gSkippedPeriods  = 0;
+static _Atomic uint64_t gWorstWakeNanos  = 0;
+static _Atomic bool     gRealtimeGranted = false;
+
+static float            gScratch[NULL_MAX_FRAMES * NULL_CHANNELS];
+
+static uint64_t timespec_nanos(const struct timespec * ts) {
+    return ((uint64_t)ts->tv_sec * 1000000000ULL) + (uint64_t)ts->tv_nsec;
+}
+
+static struct timespec nanos_timespec(uint64_t nanos) {
+    struct timespec ts = {0};
+
+    ts.tv_sec  = (time_t)(nanos / 1000000000ULL);
+    ts.tv_nsec = (long)(nanos % 1000000000ULL);
+    return ts;
+}
+
+// Asks for SCHED_FIFO a little below the top, where an audio server would put its own threads. Refused
+// without the privilege, which is the usual case for a test run; the thread then keeps its default
+// policy and the stats say it did.
+static void make_realtime(void) {
+    struct sched_param param  = {0};
+    int                policy = SCHED_FIFO;
+
+    param.sched_priority = sched_get_priority_max(policy) - 10;
+
+    if (param.sched_priority < sched_get_priority_min(policy)) {
+        param.sched_priority = sched_get_priority_min(policy);
+    }
+    atomic_store(&gRealtimeGranted, pthread_setschedparam(pthread_self(), policy, &param) == 0);
+}
+
+// The device. Each deadline is the last one plus a period, on the absolute monotonic clock, so a late
+// wake does not push every later one back with it — the cadence stays the device's, as a sound card's
+// would, and a callback that overruns eats into the next period rather than moving it.
+static void * null_device_thread(void * unused) {
+    uint32_t        frames      = (gBufferFrames > 0) ? gBufferFrames : NULL_DEFAULT_FRAMES;
+    uint64_t        periodNanos = (uint64_t)(((double)frames / gSampleRate) * 1.0e9);
+    uint64_t        deadline    = 0;
+    struct timespec now         = {0};
+
+    (void)unused;
+
+    if (gWantRealtime == true) {
+        make_realtime();
+    }
+    (void)rt_log_register_thread("audio");
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    deadline = timespec_nanos(&now) + periodNanos;
+
+    while (atomic_load(&gRun) == true) {
+        struct timespec until = nanos_timespec(deadline);
+        uint64_t        woke  = 0;
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR) {
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+        woke = timespec_nanos(&now);
+
+        if (woke > deadline) {
+            uint64_t late = woke - deadline;
+
+            if (late > atomic_load(&gWorstWakeNanos)) {
+                atomic_store(&gWorstWakeNanos, late);
+            }
+
+            if ((double)late > ((double)periodNanos * NULL_LATE_FRACTION)) {
+                atomic_fetch_add(&gLateWakes, 1);
+            }
+
+            // So late that whole periods have gone: a real device would have played silence for them.
+            // Jump the schedule rather than firing a burst of callbacks to catch up.
+            if (late >= periodNanos) {
+                atomic_fetch_add(&gOverrunWakes, 1);
+                atomic_fetch_add(&gSkippedPeriods, late / periodNanos);
+                deadline += (late / periodNanos) * periodNanos;
+            }
+        }
+        sound_engine_render(gScratch, frames, NULL_CHANNELS);
+        atomic_fetch_add(&gCallbacks, 1);
+        deadline += periodNanos;
+    }
+
+    rt_log_unregister_thread();
+    return NULL;
+}
+
+void audio_output_null_configure(double sampleRate, bool realtime) {
+    gConfiguredRate = (sampleRate > 0.0) ? sampleRate : 48000.0;
+    gWantRealtime   = realtime;
+}
+
+void audio_output_null_stats(tAudioNullStats * stats) {
+    stats->callbacks      = atomic_load(&gCallbacks);
+    stats->lateWakes      = atomic_load(&gLateWakes);
+    stats->overrunWakes   = atomic_load(&gOverrunWakes);
+    stats->skippedPeriods = atomic_load(&gSkippedPeriods);
+    stats->worstWakeUs    = (double)atomic_load(&gWorstWakeNanos) / 1.0e3;
+    stats->realtime       = atomic_load(&gRealtimeGranted);
+}
+
+bool audio_output_start(void) {
+    if (gRunning == true) {
+        return true;
+    }
+
+    if (gBufferFrames > NULL_MAX_FRAMES) {
+        LOG_ERROR("Sound engine: the null device takes at most %u frames, not %u\n", NULL_MAX_FRAMES, (unsigned)gBufferFrames);
+        return false;
+    }
+    gSampleRate = gConfiguredRate;
+    sound_engine_set_sample_rate(gSampleRate);
+
+    atomic_store(&gCallbacks, 0);
+    atomic_store(&gLateWakes, 0);
+    atomic_store(&gOverrunWakes, 0);
+    atomic_store(&gSkippedPeriods, 0);
+    atomic_store(&gWorstWakeNanos, 0);
+    atomic_store(&gRealtimeGranted, false);
+    atomic_store(&gRun, true);
+
+    if (pthread_create(&gThread, NULL, null_device_thread, NULL) != 0) {
+        LOG_ERROR("Sound engine: could not start the null device thread\n");
+        atomic_store(&gRun, false);
+        gSampleRate = 0.0;
+        return false;
+    }
+    gRunning = true;
+    LOG_DEBUG("Sound engine: null device started at %.0f Hz\n", gSampleRate);
+    return true;
+}
+
+// Joins the thread, so as with CoreAudio's stop, no render is in flight once this returns.
+void audio_output_stop(void) {
+    if (gRunning == false) {
+        return;
+    }
+    atomic_store(&gRun, false);
+    pthread_join(gThread, NULL);
+    gRunning    = false;
+    gSampleRate = 0.0;
+}
+
+double audio_output_sample_rate(void) {
+    return gRunning ? gSampleRate : 0.0;
+}
+
+static void reopen_if_running(void) {
+    if (gRunning == true) {
+        audio_output_stop();
+        (void)audio_output_start();
+    }
+}
+
+uint32_t audio_output_device_count(void) {
+    return 1;
+}
+
+const char * audio_output_device_name(uint32_t index) {
+    return (index == 0) ? "Null" : "";
+}
+
+uint32_t audio_output_device_channels(uint32_t index) {
+    return (index == 0) ? NULL_CHANNELS : 0;
+}
+
+bool audio_output_device_is_selected(uint32_t index) {
+    return index == 0;
+}
+
+const char * audio_output_device_uid(uint32_t index) {
+    return (index == 0) ? "null" : "";
+}
+
+bool audio_output_select_device_by_uid(const char * uid) {
+    return (uid != NULL) && (strcmp(uid, "null") == 0);
+}
+
+// The channels are remembered and otherwise ignored: there is nothing to map them onto.
+void audio_output_select_left_channel(uint32_t channel) {
+    gLeftChannel = channel;
+}
+
+void audio_output_select_right_channel(uint32_t channel) {
+    gRightChannel = channel;
+}
+
+uint32_t audio_output_left_channel(void) {
+    return gLeftChannel;
+}
+
+uint32_t audio_output_right_channel(void) {
+    return gRightChannel;
+}
+
+uint32_t audio_output_selected_device_channels(void) {
+    return NULL_CHANNELS;
+}
+
+int32_t audio_output_level_db(void) {
+    return gLevelDb;
+}
+
+void audio_output_select_level_db(int32_t db) {
+    gLevelDb = (db > 0) ? 0 : db;
+    sound_engine_set_output_level_db((double)gLevelDb);
+}
+
+uint32_t audio_output_variation_crossfade_ms(void) {
+    return gCrossfadeMs;
+}
+
+void audio_output_select_variation_crossfade_ms(uint32_t ms) {
+    gCrossfadeMs = (ms > 10000) ? 10000 : ms;
+    sound_engine_set_variation_crossfade((double)gCrossfadeMs * 1.0e-3);
+}
+
+uint32_t audio_output_buffer_frames(void) {
+    return gBufferFrames;
+}
+
+void audio_output_select_buffer_frames(uint32_t frames) {
+    gBufferFrames = frames;
+    reopen_if_running();
+}
+
+// No preferences to read: every setting starts at its default each run.
+void audio_output_load_settings(void) {
+    sound_engine_set_output_level_db((double)gLevelDb);
+    sound_engine_set_variation_crossfade((double)gCrossfadeMs * 1.0e-3);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,64 @@
+/*
+ * The G2 Editor application.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __AUDIO_OUTPUT_NULL_H__
+#define __AUDIO_OUTPUT_NULL_H__
+
+#include "sysIncludes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// THE NULL DEVICE: audioOutput.h with no hardware behind it. A thread of its own wakes on an absolute
+// clock_nanosleep() schedule, one buffer period apart, calls sound_engine_render() into a scratch
+// buffer and throws the result away — the cadence of a real device, with nothing to play it on.
+//
+// Backends are chosen at link time, as the plug-in already does with vst3/g2HostIo.c: link
+// audioOutput.c for CoreAudio, or audioOutputNull.c for this, never both. It exists so the engine's
+// real-time behaviour — a callback arriving every period whatever else is happening — can be run on a
+// machine with no sound card, Linux CI included. tools/soak.c is what drives it.
+//
+// IT LIVES IN tools/, NOT src/, because the Xcode project compiles everything under src/ into the
+// application, and there it would collide with audioOutput.c.
+//
+// Everything in audioOutput.h is implemented: one device, "Null", two channels, so a menu built over
+// it has something to show. The buffer size is audio_output_select_buffer_frames()'s, 256 if that is 0.
+
+// Before audio_output_start() (sound_engine_start()). sampleRate is the device rate the engine is told;
+// realtime asks for SCHED_FIFO, which needs the privilege for it — without, the thread runs at normal
+// priority and audio_output_null_stats() says so.
+void audio_output_null_configure(double sampleRate, bool realtime);
+
+typedef struct {
+    uint64_t callbacks;
+    uint64_t lateWakes;        // woke more than a quarter of a period after its deadline
+    uint64_t overrunWakes;     // woke a whole period or more after its deadline: that buffer was late
+    uint64_t skippedPeriods;   // woke so late whole periods had passed; the schedule jumped them
+    double   worstWakeUs;      // latest wake after a deadline
+    bool     realtime;         // SCHED_FIFO was granted
+} tAudioNullStats;
+
+void audio_output_null_stats(tAudioNullStats * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __AUDIO_OUTPUT_NULL_H__
@@ -0,0 +1,651 @@
+/*
+ * bench — reproducible CPU measurements of the sound engine, per kernel and per patch.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// The engine's cost has been recorded by reading the editor's status line — "1.8% → 3.4% on a
+// 12-module patch" — which nobody can repeat and which moves with whatever else the machine is doing.
+// This measures the same things the same way every time, and writes them down so that a change can be
+// judged against the run before it:
+//
+//     ./do-bench --json before.json                      kernels, then every patch at every size
+//     ./do-bench --json after.json
+//     ./bench --compare before.json after.json           what got slower, beyond the noise
+//
+// TWO KINDS OF RUN.
+//
+//   KERNELS. Each per-sample step function on its own, in ns per ENGINE sample (96 kHz for a 48 kHz
+//   device): oscillator_step, filter_step, envelope_step, reverb_step, chorus_step, delay_step and
+//   compress_step. This file includes soundEngine.c itself, so these are the engine's own static
+//   functions, inlined exactly as the engine inlines them, not copies that could drift.
+//
+//   PATCHES. Every PatchTestFiles/*.pch2 that loads, forced to Poly at 1, 8, 16 and 32 voices with
+//   that many notes held, at 44.1, 48 and 96 kHz. Reported in ns per output frame and as a percentage
+//   of real time. Read together, the voice counts are the scaling curve: a straight line is the
+//   Voice Area's cost per voice, and where it meets zero is the FX Area's fixed cost.
+//
+//   OUTPUTS, only when asked for with --outputs. One patch (SimpleLead, or --patch) at 8 voices and
+//   48 kHz, in blocks of 32, 128 and 512 frames, delivered three ways: interleaved and then copied
+//   apart into two channel buffers, which is what the VST3 plug-in used to do; straight into two
+//   channel buffers with sound_engine_render_planar(); and into four, the plug-in with its aux bus on.
+//   In ns per block. The first two differ by the copy and nothing else.
+//
+// NOISE. Each measurement is taken --repeats times. The figure is the FASTEST, which is the one least
+// disturbed by the rest of the machine; the spread is how far the median sits above it. --compare
+// flags a result as slower only if it moved by more than --threshold percent AND by more than three
+// times the larger of the two spreads, so a noisy measurement has to move further to count.
+// The exit status is 1 if anything regressed, so the comparison can gate a commit.
+//
+// Build: see tools/do-bench.
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// The engine itself, so its static kernels are callable here. do-bench leaves soundEngine.c out of the
+// link for this reason.
+#include "../src/soundEngine.c"
+
+#include "msgQueue.h"
+#include "undo.h"
+#include "../vst3/g2Patch.h"
+
+#define BENCH_KERNEL_RATE     (48000.0)   // device rate for the kernels; they run at twice this
+#define BENCH_INPUT_LENGTH    (4096U)
+#define BENCH_BLOCK           (256U)
+#define BENCH_WARMUP          (0.25)      // seconds rendered and thrown away before a patch is timed
+#define BENCH_MAX_RESULTS     (1024U)
+#define BENCH_MAX_REPEATS     (64U)
+#define BENCH_NAME            (160U)
+#define BENCH_PATCH_DIR       "PatchTestFiles"
+#define BENCH_MAX_PATCHES     (256U)
+
+#define BENCH_OUTPUT_PATCH    "SimpleLead.pch2"
+#define BENCH_OUTPUT_VOICES   (8U)
+#define BENCH_OUTPUT_RATE     (48000.0)
+#define BENCH_OUTPUT_MAX      (512U)
+
+static const uint32_t kVoiceCounts[]  = {1, 8, 16, 32};
+static const double   kRates[]        = {44100.0, 48000.0, 96000.0};
+static const uint32_t kOutputBlocks[] = {32, 128, 512};
+
+// Loading a patch goes through protocol.c, which reports a linked-variation edit to the undo stack and
+// may post to the GUI. There is neither here; these are the two references the link needs, as in
+// fxbench.c.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+typedef enum {
+    eKernelOscillator = 0,
+    eKernelFilter,
+    eKernelEnvelope,
+    eKernelReverb,
+    eKernelChorus,
+    eKernelDelay,
+    eKernelCompress,
+    eKernelCount,
+} tKernel;
+
+static const char * const kKernelName[eKernelCount] = {
+    "oscillator_step",
+    "filter_step",
+    "envelope_step",
+    "reverb_step",
+    "chorus_step",
+    "delay_step",
+    "compress_step",
+};
+
+typedef struct {
+    char     name[BENCH_NAME];
+    char     unit[16];
+    double   value;      // the fastest repeat
+    double   spread;     // (median - fastest) / fastest
+    double   load;       // patches: percent of real time; kernels: 0
+} tBenchResult;
+
+static tBenchResult gResults[BENCH_MAX_RESULTS];
+static uint32_t     gResultCount = 0;
+static double       gInput[BENCH_INPUT_LENGTH];
+static float        gBuffer[BENCH_BLOCK * 2];
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static int compare_double(const void * a, const void * b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static int compare_names(const void * a, const void * b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+// Fastest and spread of a set of repeats, into the next result.
+static tBenchResult * add_result(const char * name, const char * unit, double * times, uint32_t repeats) {
+    tBenchResult * result = NULL;
+
+    if (gResultCount >= BENCH_MAX_RESULTS) {
+        return NULL;
+    }
+    result = &gResults[gResultCount++];
+    qsort(times, repeats, sizeof(times[0]), compare_double);
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    snprintf(result->unit, sizeof(result->unit), "%s", unit);
+    result->value  = times[0];
+    result->spread = (times[0] > 0.0) ? ((times[repeats / 2] - times[0]) / times[0]) : 0.0;
+    result->load   = 0.0;
+    return result;
+}
+
+// One kernel, `samples` times, against a looping input. What it returns is summed into a volatile so
+// none of it can be optimised away.
+static double run_kernel(tKernel kernel, uint32_t samples) {
+    tEngineNode spec  = {0};
+    double      sink  = 0.0;
+    g2_sample_t left  = 0.0;
+    g2_sample_t right = 0.0;
+
+    spec.active       = true;
+    spec.kind         = eNodeOsc;
+    spec.wave         = eOscWaveSaw;
+    spec.oscKbt       = true;
+    spec.basePitch    = OSCB_TUNE_UNITY;
+    spec.cutoffParam  = 64.0;
+    spec.resonance    = 0.5;
+    spec.extraPoles   = 3;          // 24 dB, the slope most patches use
+    spec.attack       = 0.005;
+    spec.decay        = 0.1;
+    spec.sustain      = 0.5;
+    spec.release      = 0.1;
+    spec.threshold    = 0.25;
+    spec.ratio        = 4.0;
+    spec.attackCoeff  = 0.01;
+    spec.releaseCoeff = 0.0005;
+
+    for (uint32_t i = 0; i < samples; i++) {
+        double input = gInput[i & (BENCH_INPUT_LENGTH - 1)];
+
+        switch (kernel) {
+            case eKernelOscillator:
+            {
+                sink += oscillator_step(0, 0, 0, &spec, 60.0, 0.0, 0.0, 0.5);
+                break;
+            }
+            case eKernelFilter:
+            {
+                sink += filter_step(0, 0, 1, &spec, input, 0.0, 60.0, spec.cutoffParam, spec.resonance);
+                break;
+            }
+            case eKernelEnvelope:
+            {
+                // The gate changes every 50 ms so every stage is visited, not just the sustain.
+                sink += envelope_step(0, 0, 2, &spec, ((i / 4800U) & 1U) == 0);
+                break;
+            }
+            case eKernelReverb:
+            {
+                reverb_step(0, input, 2.0, 0.7, 0.5, 0.5, 2, &left, &right);
+                sink += left + right;
+                break;
+            }
+            case eKernelChorus:
+            {
+                chorus_step(0, 3, input, 0.5, 0.5, &left, &right);
+                sink += left + right;
+                break;
+            }
+            case eKernelDelay:
+            {
+                sink += delay_step(0, 0, input, 0.3, 0.5, 0.5, 0.0, 0.5);
+                break;
+            }
+            default:
+            {
+                sink += compress_step(0, 0, 4, input, &spec);
+                break;
+            }
+        }
+    }
+    return sink;
+}
+
+static void bench_kernels(double seconds, uint32_t repeats) {
+    double   times[BENCH_MAX_REPEATS];
+    uint32_t samples = 0;
+
+    sound_engine_start_hosted(BENCH_KERNEL_RATE);
+    samples = (uint32_t)((seconds * gSampleRate) / (double)repeats);
+
+    // A sawtooth at a few hundred hertz with a little noise on it: broadband enough that no filter
+    // sits in a trivial state, and the same every run.
+    for (uint32_t i = 0; i < BENCH_INPUT_LENGTH; i++) {
+        gInput[i] = (0.5 * ((double)((i * 7U) % 256U) / 128.0 - 1.0)) + (0.01 * (double)((i * 2654435761U) >> 24) / 256.0);
+    }
+    printf("kernels, ns per engine sample at %.0f Hz\n", gSampleRate);
+
+    for (uint32_t k = 0; k < eKernelCount; k++) {
+        tBenchResult * result = NULL;
+        char           name[BENCH_NAME];
+
+        for (uint32_t r = 0; r < repeats; r++) {
+            double          started = now_seconds();
+            volatile double sink    = run_kernel((tKernel)k, samples);
+
+            (void)sink;
+            times[r] = ((now_seconds() - started) * 1e9) / (double)samples;
+        }
+        snprintf(name, sizeof(name), "kernel %s", kKernelName[k]);
+        result = add_result(name, "ns/sample", times, repeats);
+
+        if (result != NULL) {
+            printf("  %-18s %8.1f ns   spread %4.1f%%\n", kKernelName[k], result->value, result->spread * 100.0);
+        }
+    }
+    sound_engine_stop_hosted();
+}
+
+// One patch at one size: load it, force the voice count, hold as many notes, and time the callbacks.
+static bool bench_patch(const char * path, const char * patch, uint32_t voices, double rate, double seconds,
+                        uint32_t repeats) {
+    double         times[BENCH_MAX_REPEATS];
+    uint32_t       frames  = (uint32_t)((seconds * rate) / (double)repeats);
+    uint32_t       warmup  = (uint32_t)(BENCH_WARMUP * rate);
+    tBenchResult * result  = NULL;
+    char           name[BENCH_NAME];
+
+    if (g2_plugin_load_patch(path, 0) == false) {
+        return false;
+    }
+    gPatchDescr[0].monoPoly   = monoPolyPoly;
+    gPatchDescr[0].voiceCount = voices - 1;   // the descriptor holds the count minus one
+
+    sound_engine_start_hosted(rate);
+    sound_engine_update_from_patch();
+
+    // Whole tones up from C2, so even 32 notes stay inside the keyboard and no two share a voice.
+    for (uint32_t v = 0; v < voices; v++) {
+        sound_engine_note((int32_t)(36U + (v * 2U)), true);
+    }
+
+    for (uint32_t done = 0; done < warmup; done += BENCH_BLOCK) {
+        sound_engine_render(gBuffer, BENCH_BLOCK, 2);
+    }
+
+    for (uint32_t r = 0; r < repeats; r++) {
+        double   started = now_seconds();
+        uint32_t done    = 0;
+
+        for (done = 0; done < frames; done += BENCH_BLOCK) {
+            sound_engine_render(gBuffer, BENCH_BLOCK, 2);
+        }
+        times[r] = ((now_seconds() - started) * 1e9) / (double)done;
+    }
+    sound_engine_note(-1, false);
+    sound_engine_stop_hosted();
+
+    snprintf(name, sizeof(name), "patch %s voices %u rate %.0f", patch, voices, rate);
+    result = add_result(name, "ns/frame", times, repeats);
+
+    if (result != NULL) {
+        result->load = (result->value * rate) / 1e7;   // ns per frame x frames per second, as % of 1e9
+        printf("  %-24s %2u voices %6.0f Hz %9.1f ns/frame %6.2f%%   spread %4.1f%%\n",
+               patch, voices, rate, result->value, result->load, result->spread * 100.0);
+    }
+    return true;
+}
+
+static void bench_patches(const char * only, double seconds, uint32_t repeats) {
+    DIR *           handle = opendir(BENCH_PATCH_DIR);
+    struct dirent * entry  = NULL;
+    char *          names[BENCH_MAX_PATCHES];
+    char            path[BENCH_NAME * 2];
+    uint32_t        count  = 0;
+
+    if (handle == NULL) {
+        fprintf(stderr, "bench: no %s (run from the repository root)\n", BENCH_PATCH_DIR);
+        return;
+    }
+
+    while (((entry = readdir(handle)) != NULL) && (count < BENCH_MAX_PATCHES)) {
+        size_t length = strlen(entry->d_name);
+
+        if ((length > 5) && (strcmp(entry->d_name + length - 5, ".pch2") == 0)
+            && ((only == NULL) || (strcmp(entry->d_name, only) == 0))) {
+            names[count++] = strdup(entry->d_name);
+        }
+    }
+    closedir(handle);
+    qsort(names, count, sizeof(names[0]), compare_names);
+    printf("patches, ns per output frame and %% of real time\n");
+
+    for (uint32_t p = 0; p < count; p++) {
+        snprintf(path, sizeof(path), "%s/%s", BENCH_PATCH_DIR, names[p]);
+
+        for (uint32_t r = 0; r < (sizeof(kRates) / sizeof(kRates[0])); r++) {
+            for (uint32_t v = 0; v < (sizeof(kVoiceCounts) / sizeof(kVoiceCounts[0])); v++) {
+                if (bench_patch(path, names[p], kVoiceCounts[v], kRates[r], seconds, repeats) == false) {
+                    printf("  %-24s did not load, skipped\n", names[p]);
+                    r = (uint32_t)(sizeof(kRates) / sizeof(kRates[0]));
+                    break;
+                }
+            }
+        }
+        free(names[p]);
+    }
+}
+
+typedef enum {
+    eOutputCopied = 0,
+    eOutputPlanar2,
+    eOutputPlanar4,
+    eOutputCount,
+} tOutputPath;
+
+static const char * const kOutputName[eOutputCount] = {
+    "interleaved+copy",
+    "planar 2ch",
+    "planar 4ch",
+};
+
+// One block delivered one way.
+static void render_output(tOutputPath path, uint32_t block) {
+    static float interleaved[BENCH_OUTPUT_MAX * 2];
+    static float planar[4][BENCH_OUTPUT_MAX];
+    float *      outs[4] = {planar[0], planar[1], planar[2], planar[3]};
+
+    switch (path) {
+        case eOutputCopied:
+        {
+            sound_engine_render(interleaved, block, 2);
+
+            for (uint32_t i = 0; i < block; i++) {
+                planar[0][i] = interleaved[i * 2];
+                planar[1][i] = interleaved[(i * 2) + 1];
+            }
+            break;
+        }
+        case eOutputPlanar2:
+        {
+            sound_engine_render_planar(outs, 2, block);
+            break;
+        }
+        default:
+        {
+            sound_engine_render_planar(outs, 4, block);
+            break;
+        }
+    }
+}
+
+static void bench_outputs(const char * only, double seconds, uint32_t repeats) {
+    double   times[BENCH_MAX_REPEATS];
+    char     path[BENCH_NAME * 2];
+    char     name[BENCH_NAME];
+    uint32_t frames = (uint32_t)((seconds * BENCH_OUTPUT_RATE) / (double)repeats);
+    uint32_t warmup = (uint32_t)(BENCH_WARMUP * BENCH_OUTPUT_RATE);
+
+    snprintf(path, sizeof(path), "%s/%s", BENCH_PATCH_DIR, (only != NULL) ? only : BENCH_OUTPUT_PATCH);
+
+    if (g2_plugin_load_patch(path, 0) == false) {
+        fprintf(stderr, "bench: %s did not load\n", path);
+        return;
+    }
+    gPatchDescr[0].monoPoly   = monoPolyPoly;
+    gPatchDescr[0].voiceCount = BENCH_OUTPUT_VOICES - 1;
+
+    sound_engine_start_hosted(BENCH_OUTPUT_RATE);
+    sound_engine_update_from_patch();
+
+    for (uint32_t v = 0; v < BENCH_OUTPUT_VOICES; v++) {
+        sound_engine_note((int32_t)(36U + (v * 2U)), true);
+    }
+
+    for (uint32_t done = 0; done < warmup; done += BENCH_BLOCK) {
+        sound_engine_render(gBuffer, BENCH_BLOCK, 2);
+    }
+    printf("outputs, %s at %u voices and %.0f Hz, ns per block\n",
+           (only != NULL) ? only : BENCH_OUTPUT_PATCH, BENCH_OUTPUT_VOICES, BENCH_OUTPUT_RATE);
+
+    // The three ways take turns within each repeat rather than running one after another, so a patch
+    // whose cost drifts as its notes develop weighs on all of them alike.
+    for (uint32_t b = 0; b < (sizeof(kOutputBlocks) / sizeof(kOutputBlocks[0])); b++) {
+        uint32_t block = kOutputBlocks[b];
+        double   pathTimes[eOutputCount][BENCH_MAX_REPEATS];
+
+        for (uint32_t r = 0; r < repeats; r++) {
+            for (uint32_t o = 0; o < eOutputCount; o++) {
+                double   started = now_seconds();
+                uint32_t blocks  = 0;
+
+                for (uint32_t done = 0; done < (frames / eOutputCount); done += block) {
+                    render_output((tOutputPath)o, block);
+                    blocks++;
+                }
+                pathTimes[o][r] = ((now_seconds() - started) * 1e9) / (double)blocks;
+            }
+        }
+
+        for (uint32_t o = 0; o < eOutputCount; o++) {
+            tBenchResult * result = NULL;
+
+            memcpy(times, pathTimes[o], sizeof(double) * repeats);
+            snprintf(name, sizeof(name), "outputs %s block %u", kOutputName[o], block);
+            result = add_result(name, "ns/block", times, repeats);
+
+            if (result != NULL) {
+                printf("  %4u frames  %-18s %10.1f ns/block %7.1f ns/frame   spread %4.1f%%\n",
+                       block, kOutputName[o], result->value, result->value / (double)block, result->spread * 100.0);
+            }
+        }
+    }
+    sound_engine_note(-1, false);
+    sound_engine_stop_hosted();
+}
+
+// One result per line, so that --compare can read it back without a JSON parser and a diff of two
+// files lines up.
+static bool write_json(const char * path, double seconds, uint32_t repeats) {
+    FILE * file = fopen(path, "w");
+
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "{\n  \"tool\": \"g2-bench\",\n  \"format\": 1,\n");
+    fprintf(file, "  \"engineOversample\": %u,\n  \"singlePrecision\": %s,\n",
+            (unsigned)ENGINE_OVERSAMPLE, G2_ENGINE_SINGLE_PRECISION ? "true" : "false");
+    fprintf(file, "  \"seconds\": %.3f,\n  \"repeats\": %u,\n  \"results\": [\n", seconds, repeats);
+
+    for (uint32_t i = 0; i < gResultCount; i++) {
+        fprintf(file, "    {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.3f, \"spread\": %.4f, \"load\": %.4f}%s\n",
+                gResults[i].name, gResults[i].unit, gResults[i].value, gResults[i].spread, gResults[i].load,
+                ((i + 1) < gResultCount) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+// Reads back what write_json() wrote. Not a JSON parser and does not pretend to be one: it knows the
+// one line shape above and skips everything else.
+static uint32_t read_json(const char * path, tBenchResult * results, uint32_t capacity) {
+    FILE *   file  = fopen(path, "r");
+    char     line[512];
+    uint32_t count = 0;
+
+    if (file == NULL) {
+        return 0;
+    }
+
+    while ((fgets(line, sizeof(line), file) != NULL) && (count < capacity)) {
+        tBenchResult * result = &results[count];
+        const char *   name   = strstr(line, "{\"name\": \"");
+        const char *   end    = NULL;
+        const char *   value  = strstr(line, "\"value\": ");
+        const char *   spread = strstr(line, "\"spread\": ");
+
+        if ((name == NULL) || (value == NULL) || (spread == NULL)) {
+            continue;
+        }
+        name += strlen("{\"name\": \"");
+        end   = strchr(name, '"');
+
+        if ((end == NULL) || ((size_t)(end - name) >= sizeof(result->name))) {
+            continue;
+        }
+        memset(result, 0, sizeof(*result));
+        memcpy(result->name, name, (size_t)(end - name));
+        result->value  = atof(value + strlen("\"value\": "));
+        result->spread = atof(spread + strlen("\"spread\": "));
+        count++;
+    }
+    fclose(file);
+    return count;
+}
+
+static int compare_runs(const char * beforePath, const char * afterPath, double threshold) {
+    static tBenchResult before[BENCH_MAX_RESULTS];
+    static tBenchResult after[BENCH_MAX_RESULTS];
+    uint32_t            beforeCount = read_json(beforePath, before, BENCH_MAX_RESULTS);
+    uint32_t            afterCount  = read_json(afterPath, after, BENCH_MAX_RESULTS);
+    uint32_t            slower      = 0;
+    uint32_t            faster      = 0;
+
+    if ((beforeCount == 0) || (afterCount == 0)) {
+        fprintf(stderr, "bench: nothing to compare in %s\n", (beforeCount == 0) ? beforePath : afterPath);
+        return 2;
+    }
+    printf("%-48s %10s %10s %8s %8s\n", "", "before", "after", "change", "noise");
+
+    for (uint32_t a = 0; a < afterCount; a++) {
+        for (uint32_t b = 0; b < beforeCount; b++) {
+            double       change = 0.0;
+            double       noise  = 0.0;
+            const char * verdict = "";
+
+            if (strcmp(after[a].name, before[b].name) != 0) {
+                continue;
+            }
+            change = (before[b].value > 0.0) ? (((after[a].value - before[b].value) / before[b].value) * 100.0) : 0.0;
+            noise  = 300.0 * fmax(before[b].spread, after[a].spread);
+
+            if ((change > threshold) && (change > noise)) {
+                verdict = "  SLOWER";
+                slower++;
+            } else if ((-change > threshold) && (-change > noise)) {
+                verdict = "  faster";
+                faster++;
+            }
+            printf("%-48s %10.1f %10.1f %+7.1f%% %7.1f%%%s\n",
+                   after[a].name, before[b].value, after[a].value, change, noise, verdict);
+            break;
+        }
+    }
+    printf("%u slower, %u faster, threshold %.1f%%\n", slower, faster, threshold);
+    return (slower > 0) ? 1 : 0;
+}
+
+int main(int argc, char ** argv) {
+    const char * jsonPath  = NULL;
+    const char * only      = NULL;
+    double       seconds   = 1.0;
+    double       threshold = 5.0;
+    uint32_t     repeats   = 5;
+    bool         kernels   = true;
+    bool         patches   = true;
+    bool         outputs   = false;
+    int          i         = 0;
+
+    if ((argc >= 4) && (strcmp(argv[1], "--compare") == 0)) {
+        if ((argc == 6) && (strcmp(argv[4], "--threshold") == 0)) {
+            threshold = atof(argv[5]);
+        } else if (argc != 4) {
+            fprintf(stderr, "usage: %s --compare before.json after.json [--threshold percent]\n", argv[0]);
+            return 2;
+        }
+        return compare_runs(argv[2], argv[3], threshold);
+    }
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--json") == 0) && ((i + 1) < argc)) {
+            jsonPath = argv[++i];
+        } else if ((strcmp(argv[i], "--patch") == 0) && ((i + 1) < argc)) {
+            only = argv[++i];
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--repeats") == 0) && ((i + 1) < argc)) {
+            repeats = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--kernels") == 0) {
+            patches = false;
+        } else if (strcmp(argv[i], "--patches") == 0) {
+            kernels = false;
+        } else if (strcmp(argv[i], "--outputs") == 0) {
+            outputs = true;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--json out.json] [--kernels | --patches | --outputs] [--patch name.pch2] [--seconds n] [--repeats n]\n"
+                    "       %s --compare before.json after.json [--threshold percent]\n"
+                    "  Times the engine's kernels and whole patches, or compares two runs.\n",
+                    argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if ((seconds <= 0.0) || (seconds > 600.0) || (repeats < 1) || (repeats > BENCH_MAX_REPEATS)) {
+        fprintf(stderr, "bench: --seconds must be in (0, 600] and --repeats in 1..%u\n", BENCH_MAX_REPEATS);
+        return 2;
+    }
+
+    if (outputs) {
+        bench_outputs(only, seconds, repeats);
+    } else {
+        if (kernels) {
+            bench_kernels(seconds, repeats);
+        }
+
+        if (patches) {
+            bench_patches(only, seconds, repeats);
+        }
+    }
+
+    if ((jsonPath != NULL) && (write_json(jsonPath, seconds, repeats) == false)) {
+        fprintf(stderr, "bench: cannot write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,453 @@
+/*
+ * coalesce — the USB command stage's ordering rules, checked.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// src/usbCoalesce.c sits between the UI's command queue and the device and merges a dial drag's
+// superseded values away. Getting its rules wrong does not crash anything: it sends a value after the
+// cable it was meant to precede, or drops a morph range because a value for the same knob came along.
+// Each case below feeds the stage a sequence of commands and checks exactly what comes out, in what
+// order, and how many were counted as merged:
+//
+//     ./do-coalesce
+//
+// It also checks the lanes (see usbCoalesce.h): what a bulk job may take from the stage between bank
+// locations, and which queued edits a realtime command may pass on its way there. How long a dial
+// waits while a real bank backup runs is emubench's to measure: it drives backup_bank() itself,
+// against the software G2.
+//
+// Prints one line per case and exits non-zero if any failed. Links src/usbCoalesce.c and nothing else
+// of the application's; the queue it reads from is a plain array here.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "usbCoalesce.h"
+
+#define COALESCE_MAX_COMMANDS    (256U)
+
+// The queue. usb_coalesce_receive() only ever polls it.
+static tMessageContent gQueue[COALESCE_MAX_COMMANDS];
+static uint32_t        gQueueHead  = 0;
+static uint32_t        gQueueCount = 0;
+
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+
+    if (gQueueCount < COALESCE_MAX_COMMANDS) {
+        memcpy(&gQueue[(gQueueHead + gQueueCount) % COALESCE_MAX_COMMANDS], content, sizeof(tMessageContent));
+        gQueueCount++;
+    }
+}
+
+int msg_receive(tMessageQueue * msgQueue, eRcv mode, void * content) {
+    (void)msgQueue;
+    (void)mode;
+
+    if (gQueueCount == 0) {
+        return EXIT_FAILURE;
+    }
+    memcpy(content, &gQueue[gQueueHead], sizeof(tMessageContent));
+    gQueueHead = (gQueueHead + 1) % COALESCE_MAX_COMMANDS;
+    gQueueCount--;
+    return EXIT_SUCCESS;
+}
+
+static tMessageContent set_value(uint32_t module, uint32_t param, uint32_t variation, uint32_t value) {
+    tMessageContent command = {0};
+
+    command.cmd                          = eMsgCmdSetValue;
+    command.slot                         = 0;
+    command.paramData.moduleKey.location = 1;
+    command.paramData.moduleKey.index    = module;
+    command.paramData.param              = param;
+    command.paramData.variation          = variation;
+    command.paramData.value              = value;
+    return command;
+}
+
+static tMessageContent set_morph(uint32_t module, uint32_t param, uint32_t morph, uint32_t value) {
+    tMessageContent command = {0};
+
+    command.cmd                               = eMsgCmdSetParamMorph;
+    command.paramMorphData.moduleKey.location = 1;
+    command.paramMorphData.moduleKey.index    = module;
+    command.paramMorphData.param              = param;
+    command.paramMorphData.paramMorph         = morph;
+    command.paramMorphData.value              = value;
+    return command;
+}
+
+static tMessageContent set_custom(uint32_t module, uint32_t value) {
+    tMessageContent command = {0};
+
+    command.cmd                              = eMsgCmdSetCustomData;
+    command.customDataMsg.moduleKey.location = 1;
+    command.customDataMsg.moduleKey.index    = module;
+    command.customDataMsg.customData[0]      = value;
+    return command;
+}
+
+static tMessageContent play_note(uint32_t note) {
+    tMessageContent command = {0};
+
+    command.cmd                   = eMsgCmdPlayNote;
+    command.playNoteData.note     = note;
+    command.playNoteData.velocity = 100;
+    command.playNoteData.on       = true;
+    return command;
+}
+
+static tMessageContent barrier(uint32_t cmd) {
+    tMessageContent command = {0};
+
+    command.cmd = cmd;
+    return command;
+}
+
+static tMessageContent in_slot(uint32_t slot, tMessageContent command) {
+    command.slot = slot;
+    return command;
+}
+
+static tMessageContent cable(uint32_t from, uint32_t to) {
+    tMessageContent command = {0};
+
+    command.cmd                       = eMsgCmdWriteCable;
+    command.cableData.location        = 1;
+    command.cableData.moduleFromIndex = from;
+    command.cableData.moduleToIndex   = to;
+    return command;
+}
+
+static tMessageContent module_colour(uint32_t module) {
+    tMessageContent command = {0};
+
+    command.cmd                                 = eMsgCmdSetModuleColour;
+    command.moduleColourData.moduleKey.location = 1;
+    command.moduleColourData.moduleKey.index    = module;
+    return command;
+}
+
+// One command as the checks spell it: V<module>.<param>=<value>, M<module>.<param>=<value>,
+// C<module>=<value>, N<note>, or #<cmd> for anything else; s<slot>/ first for any slot but the first.
+static void describe(const tMessageContent * command, char * text, size_t size) {
+    if (command->slot != 0) {
+        int used = snprintf(text, size, "s%u/", (unsigned)command->slot);
+
+        text += used;
+        size -= (size_t)used;
+    }
+
+    switch (command->cmd) {
+        case eMsgCmdSetValue:
+        {
+            snprintf(text, size, "V%u.%u=%u", (unsigned)command->paramData.moduleKey.index,
+                     (unsigned)command->paramData.param, (unsigned)command->paramData.value);
+            break;
+        }
+        case eMsgCmdSetParamMorph:
+        {
+            snprintf(text, size, "M%u.%u=%u", (unsigned)command->paramMorphData.moduleKey.index,
+                     (unsigned)command->paramMorphData.param, (unsigned)command->paramMorphData.value);
+            break;
+        }
+        case eMsgCmdSetCustomData:
+        {
+            snprintf(text, size, "C%u=%u", (unsigned)command->customDataMsg.moduleKey.index,
+                     (unsigned)command->customDataMsg.customData[0]);
+            break;
+        }
+        case eMsgCmdPlayNote:
+        {
+            snprintf(text, size, "N%u", (unsigned)command->playNoteData.note);
+            break;
+        }
+        default:
+        {
+            snprintf(text, size, "#%u", (unsigned)command->cmd);
+            break;
+        }
+    }
+}
+
+// Sends `count` commands through the queue and the stage, drains the stage, and compares what came
+// out with `expected` — the commands described as above, space separated.
+static bool check(const char * name, const tMessageContent * commands, uint32_t count, const char * expected,
+                  uint64_t expectedMerged) {
+    static tUsbCoalescer stage;
+    tMessageContent      out       = {0};
+    char                 got[2048] = {0};
+    size_t               used      = 0;
+    bool                 ok        = true;
+
+    usb_coalesce_init(&stage);
+
+    for (uint32_t i = 0; i < count; i++) {
+        msg_send(NULL, &commands[i]);
+    }
+
+    while (usb_coalesce_receive(&stage, NULL, &out) == true) {
+        char one[64];
+
+        describe(&out, one, sizeof(one));
+        used += (size_t)snprintf(got + used, sizeof(got) - used, "%s%s", (used > 0) ? " " : "", one);
+    }
+    ok = (strcmp(got, expected) == 0) && (stage.merged == expectedMerged) && (gQueueCount == 0);
+
+    printf("%-44s %s\n", name, ok ? "ok" : "FAILED");
+
+    if (ok == false) {
+        printf("    expected %s (%llu merged)\n    got      %s (%llu merged)\n", expected,
+               (unsigned long long)expectedMerged, got, (unsigned long long)stage.merged);
+    }
+    return ok;
+}
+
+// Sends `count` commands through the queue, takes what a bulk job's yield would, then drains the rest,
+// and compares both with `expected`: the yield's commands, " |", then the rest, described as above.
+static bool check_realtime(const char * name, const tMessageContent * commands, uint32_t count, const char * expected) {
+    static tUsbCoalescer stage;
+    tMessageContent      command   = {0};
+    char                 got[2048] = {0};
+    size_t               used      = 0;
+    bool                 ok        = true;
+
+    usb_coalesce_init(&stage);
+
+    for (uint32_t i = 0; i < count; i++) {
+        msg_send(NULL, &commands[i]);
+    }
+
+    while (usb_coalesce_receive_realtime(&stage, NULL, &command) == true) {
+        char one[64];
+
+        describe(&command, one, sizeof(one));
+        used += (size_t)snprintf(got + used, sizeof(got) - used, "%s%s", (used > 0) ? " " : "", one);
+    }
+    used += (size_t)snprintf(got + used, sizeof(got) - used, "%s|", (used > 0) ? " " : "");
+
+    while (usb_coalesce_receive(&stage, NULL, &command) == true) {
+        char one[64];
+
+        describe(&command, one, sizeof(one));
+        used += (size_t)snprintf(got + used, sizeof(got) - used, " %s", one);
+    }
+    ok = (strcmp(got, expected) == 0) && (gQueueCount == 0);
+
+    printf("%-44s %s\n", name, ok ? "ok" : "FAILED");
+
+    if (ok == false) {
+        printf("    expected %s\n    got      %s\n", expected, got);
+    }
+    return ok;
+}
+
+int main(void) {
+    uint32_t        failures = 0;
+    tMessageContent c[COALESCE_MAX_COMMANDS];
+    uint32_t        n        = 0;
+
+    // A drag: a hundred values for one knob leave as one, the last.
+    for (n = 0; n < 100; n++) {
+        c[n] = set_value(3, 0, 0, n);
+    }
+    failures += check("a drag collapses to its last value", c, n, "V3.0=99", 99) ? 0 : 1;
+
+    // Two knobs dragged together keep their own last values, in the order each started.
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = set_value(4, 0, 0, 1);
+    c[n++] = set_value(3, 0, 0, 2);
+    c[n++] = set_value(4, 0, 0, 2);
+    c[n++] = set_value(3, 0, 0, 3);
+    failures += check("interleaved knobs merge separately", c, n, "V3.0=3 V4.0=2", 3) ? 0 : 1;
+
+    // The same knob in two variations is two targets.
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = set_value(3, 0, 1, 2);
+    c[n++] = set_value(3, 0, 0, 3);
+    failures += check("variations are separate targets", c, n, "V3.0=3 V3.0=2", 1) ? 0 : 1;
+
+    // Nothing merges across a structural command, either way.
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = set_value(3, 0, 0, 2);
+    c[n++] = barrier(eMsgCmdWriteCable);
+    c[n++] = set_value(3, 0, 0, 3);
+    c[n++] = set_value(3, 0, 0, 4);
+    failures += check("a cable is a barrier", c, n, "V3.0=2 #7 V3.0=4", 2) ? 0 : 1;
+
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = barrier(eMsgCmdSelectVariation);
+    c[n++] = set_value(3, 0, 0, 2);
+    c[n++] = barrier(eMsgCmdSetMode);
+    c[n++] = set_value(3, 0, 0, 3);
+    failures += check("a mode or a variation select is a barrier", c, n, "V3.0=1 #10 V3.0=2 #1 V3.0=3", 0) ? 0 : 1;
+
+    // A value and a morph range on the same knob are different things, as are two morph groups.
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = set_morph(3, 0, 0, 10);
+    c[n++] = set_value(3, 0, 0, 2);
+    c[n++] = set_morph(3, 0, 0, 20);
+    c[n++] = set_morph(3, 0, 1, 30);
+    failures += check("values and morph ranges stay apart", c, n, "V3.0=2 M3.0=20 M3.0=30", 2) ? 0 : 1;
+
+    // Custom data merges per module.
+    n      = 0;
+    c[n++] = set_custom(5, 1);
+    c[n++] = set_custom(6, 1);
+    c[n++] = set_custom(5, 2);
+    failures += check("custom data merges per module", c, n, "C5=2 C6=1", 1) ? 0 : 1;
+
+    // A barrier far back does not stop a merge with something newer than it.
+    n      = 0;
+    c[n++] = barrier(eMsgCmdWriteModule);
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = set_value(4, 0, 0, 1);
+    c[n++] = set_value(3, 0, 0, 2);
+    failures += check("merging looks back only to the last barrier", c, n, "#3 V3.0=2 V4.0=1", 1) ? 0 : 1;
+
+    // A batch's markers keep its commands apart from whatever was queued either side of it.
+    n      = 0;
+    c[n++] = set_value(3, 0, 0, 1);
+    c[n++] = barrier(eMsgCmdBeginBatch);
+    c[n++] = set_value(3, 0, 0, 2);
+    c[n++] = barrier(eMsgCmdEndBatch);
+    c[n++] = set_value(3, 0, 0, 3);
+    {
+        char expected[64];
+
+        snprintf(expected, sizeof(expected), "V3.0=1 #%u V3.0=2 #%u V3.0=3",
+                 (unsigned)eMsgCmdBeginBatch, (unsigned)eMsgCmdEndBatch);
+        failures += check("batch markers are barriers", c, n, expected, 0) ? 0 : 1;
+    }
+
+    // A peek leaves the command where it is, and a value arriving after it still merges into it.
+    {
+        static tUsbCoalescer stage;
+        tMessageContent      seen  = {0};
+        tMessageContent      taken = {0};
+        tMessageContent      value = set_value(3, 0, 0, 1);
+        bool                 ok    = false;
+
+        usb_coalesce_init(&stage);
+        msg_send(NULL, &value);
+        ok    = usb_coalesce_peek(&stage, NULL, &seen) && (seen.paramData.value == 1);
+        value = set_value(3, 0, 0, 2);
+        msg_send(NULL, &value);
+        ok    = ok && usb_coalesce_receive(&stage, NULL, &taken) && (taken.paramData.value == 2);
+        ok    = ok && (usb_coalesce_peek(&stage, NULL, &seen) == false) && (gQueueCount == 0);
+
+        printf("%-44s %s\n", "a peek takes nothing", ok ? "ok" : "FAILED");
+        failures += ok ? 0 : 1;
+    }
+
+    // More distinct commands than the stage holds: the rest wait in the queue, and nothing is lost or
+    // reordered on the way through.
+    {
+        char   expected[2048] = {0};
+        size_t used           = 0;
+
+        n = 0;
+
+        for (uint32_t i = 0; i < (USB_COALESCE_DEPTH + 20); i++) {
+            c[n++]  = set_value(i, 0, 0, i);
+            used   += (size_t)snprintf(expected + used, sizeof(expected) - used, "%sV%u.0=%u",
+                                       (i > 0) ? " " : "", (unsigned)i, (unsigned)i);
+        }
+        failures += check("a full stage leaves the rest queued", c, n, expected, 0) ? 0 : 1;
+    }
+
+    // The realtime lane. A bulk job's yield takes every realtime command that cannot depend on an edit
+    // queued ahead of it, and leaves the edits, and whatever does depend on them, for after the job.
+    {
+        char            expected[256];
+        tMessageContent queued[] = {
+            set_value(3, 0, 0, 1), play_note(60), cable(5, 6), set_value(3, 0, 0, 2), set_value(4, 0, 0, 1),
+            module_colour(7), set_value(7, 0, 0, 1), set_morph(3, 0, 0, 5),
+        };
+
+        snprintf(expected, sizeof(expected), "V3.0=1 N60 V3.0=2 V4.0=1 M3.0=5 | #7 #%u V7.0=1",
+                 (unsigned)eMsgCmdSetModuleColour);
+        failures += check_realtime("the yield passes other modules' edits", queued,
+                                   sizeof(queued) / sizeof(queued[0]), expected) ? 0 : 1;
+    }
+    {
+        tMessageContent queued[] = {
+            cable(3, 4), set_value(3, 0, 0, 1), set_value(4, 0, 0, 1), set_value(5, 0, 0, 1),
+            in_slot(1, set_value(3, 0, 0, 2)),
+        };
+
+        failures += check_realtime("a value waits for a cable to its module", queued,
+                                   sizeof(queued) / sizeof(queued[0]), "V5.0=1 s1/V3.0=2 | #7 V3.0=1 V4.0=1") ? 0 : 1;
+    }
+    {
+        char            expected[256];
+        tMessageContent queued[] = {
+            barrier(eMsgCmdCopyVariation), barrier(eMsgCmdSelectVariation), set_value(3, 0, 0, 1), play_note(60),
+            in_slot(1, barrier(eMsgCmdSelectVariation)),
+        };
+
+        snprintf(expected, sizeof(expected), "N60 s1/#%u | #%u #%u V3.0=1", (unsigned)eMsgCmdSelectVariation,
+                 (unsigned)eMsgCmdCopyVariation, (unsigned)eMsgCmdSelectVariation);
+        failures += check_realtime("an edit to a slot's patch holds that slot", queued,
+                                   sizeof(queued) / sizeof(queued[0]), expected) ? 0 : 1;
+    }
+    {
+        char            expected[256];
+        tMessageContent queued[] = {
+            barrier(eMsgCmdSelectSlot), set_value(3, 0, 0, 1), play_note(60), in_slot(1, set_value(3, 0, 0, 1)),
+        };
+
+        snprintf(expected, sizeof(expected), "| #%u V3.0=1 N60 s1/V3.0=1", (unsigned)eMsgCmdSelectSlot);
+        failures += check_realtime("a slot switch holds everything", queued,
+                                   sizeof(queued) / sizeof(queued[0]), expected) ? 0 : 1;
+    }
+    {
+        char            expected[256];
+        tMessageContent queued[] = {
+            barrier(eMsgCmdBeginBatch), set_value(3, 0, 0, 1), barrier(eMsgCmdEndBatch), set_value(4, 0, 0, 1),
+            barrier(eMsgCmdBackupBank), set_value(5, 0, 0, 1),
+        };
+
+        snprintf(expected, sizeof(expected), "V4.0=1 | #%u V3.0=1 #%u #%u V5.0=1", (unsigned)eMsgCmdBeginBatch,
+                 (unsigned)eMsgCmdEndBatch, (unsigned)eMsgCmdBackupBank);
+        failures += check_realtime("a batch keeps its values; a bulk job holds", queued,
+                                   sizeof(queued) / sizeof(queued[0]), expected) ? 0 : 1;
+    }
+    {
+        bool ok = (usb_coalesce_lane(eMsgCmdBackupBank) == eUsbLaneBulk)
+                  && (usb_coalesce_lane(eMsgCmdSelectVariation) == eUsbLaneRealtime)
+                  && (usb_coalesce_lane(eMsgCmdPlayNote) == eUsbLaneRealtime)
+                  && (usb_coalesce_lane(eMsgCmdWriteCable) == eUsbLaneEdit);
+
+        printf("%-44s %s\n", "the lanes", ok ? "ok" : "FAILED");
+        failures += ok ? 0 : 1;
+    }
+
+    printf("\n%u failures\n", (unsigned)failures);
+    return (failures > 0) ? 1 : 0;
+}
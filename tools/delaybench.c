@@ -0,0 +1,270 @@
+/*
+ * delaybench — time and check the sound engine's delay-line reads.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// src/delayRing.h is the arithmetic every delay line in the engine runs per sample. This includes it
+// directly — the same inline functions, not a copy — and does two things with them:
+//
+//   1. THROUGHPUT. One read and one write per sample through a 2.7 s line, for the `%`-wrapped
+//      whole-sample read the engine used to do, the masked whole-sample read, and the two fractional
+//      reads. The first two are the mask's saving on its own; the last two are what fractional
+//      delay costs on top of it.
+//
+//   2. THE SUB-SAMPLE RESPONSE. An impulse through each read at delays of 10 + 0, 0.25, 0.5, 0.75
+//      samples. The linear read must put exactly (1 - f) and f on the two neighbouring samples. The
+//      allpass must be flat in magnitude everywhere and have a phase delay of 10 + f at low
+//      frequency — flat is the whole reason it is used inside the Delay's feedback loop.
+//
+// Exits non-zero if a response check fails, so it can sit in a script:
+//
+//     ./do-delaybench && ./delaybench
+//     ./delaybench --seconds 30          a longer timing run
+//
+// Build: see tools/do-delaybench. No engine sources are linked; the header is the whole subject.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/delayRing.h"
+
+#define BENCH_RATE          (96000.0)        // the engine's internal rate for a 48 kHz device
+#define BENCH_RING          (1U << 18)       // as DELAY_LINE_SAMPLES in soundEngine.c
+#define BENCH_MASK          (BENCH_RING - 1U)
+#define BENCH_OLD_LENGTH    (134400U * 2U)   // the line's old length, wrapped with %
+
+#define RESPONSE_RING       (1U << 12)
+#define RESPONSE_LENGTH     (2048U)
+#define RESPONSE_WHOLE      (10.0)
+#define RESPONSE_TOLERANCE  (1e-6)
+#define PHASE_TOLERANCE     (0.01)           // samples
+
+typedef enum {
+    eReadModulo = 0,
+    eReadMasked,
+    eReadLinear,
+    eReadAllpass,
+    eReadCount,
+} tReadKind;
+
+static const char * const kReadName[eReadCount] = {
+    "modulo (old)",
+    "masked",
+    "masked + linear",
+    "masked + allpass",
+};
+
+// Sized for the longer of the two layouts; the masked reads use the first BENCH_RING of it.
+static float gRing[BENCH_OLD_LENGTH];
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+// One delay-with-feedback loop, the shape of delay_step() without its filters, so the timing is the
+// ring and nothing else. The delay drifts slowly so the fractional reads see a moving fraction, as a
+// Time dial being turned would give them; the whole-sample reads truncate it, as the engine used to.
+static double run_kernel(tReadKind kind, uint32_t samples) {
+    uint32_t write   = 0;
+    double   state   = 0.0;
+    double   sink    = 0.0;
+    double   input   = 1.0;
+    double   delay   = 0.5 * BENCH_RATE;
+    double   drift   = 1.0 / BENCH_RATE;
+    uint32_t i       = 0;
+
+    memset(gRing, 0, sizeof(gRing));
+
+    for (i = 0; i < samples; i++) {
+        double wet = 0.0;
+
+        switch (kind) {
+            case eReadModulo:
+            {
+                uint32_t whole = (uint32_t)delay;
+
+                wet            = (double)gRing[(write + BENCH_OLD_LENGTH - whole) % BENCH_OLD_LENGTH];
+                gRing[write]   = (float)(input + (wet * 0.5));
+                write          = (write + 1) % BENCH_OLD_LENGTH;
+                break;
+            }
+            case eReadMasked:
+            {
+                wet = delay_ring_tap(gRing, BENCH_MASK, write, (uint32_t)delay);
+                delay_ring_write(gRing, BENCH_MASK, &write, input + (wet * 0.5));
+                break;
+            }
+            case eReadLinear:
+            {
+                wet = delay_ring_read_linear(gRing, BENCH_MASK, write, delay);
+                delay_ring_write(gRing, BENCH_MASK, &write, input + (wet * 0.5));
+                break;
+            }
+            default:
+            {
+                wet = delay_ring_read_allpass(gRing, BENCH_MASK, write, delay, &state);
+                delay_ring_write(gRing, BENCH_MASK, &write, input + (wet * 0.5));
+                break;
+            }
+        }
+        sink  += wet;
+        input  = -input;
+        delay += drift;
+    }
+    return sink;
+}
+
+static void report_throughput(double seconds) {
+    uint32_t samples = (uint32_t)(seconds * BENCH_RATE);
+    double   base    = 0.0;
+    int      kind    = 0;
+
+    printf("throughput, %u samples (%.1f s at %.0f Hz), one read and one write each\n",
+           samples, seconds, BENCH_RATE);
+
+    for (kind = 0; kind < eReadCount; kind++) {
+        double          started = now_seconds();
+        volatile double sink    = run_kernel((tReadKind)kind, samples);
+        double          elapsed = now_seconds() - started;
+        double          ns      = (elapsed * 1e9) / (double)samples;
+
+        (void)sink;
+
+        if (kind == eReadModulo) {
+            base = ns;
+        }
+        printf("  %-18s %7.2f ns/sample  %8.1f Msample/s  %5.2fx\n",
+               kReadName[kind], ns, (double)samples / (elapsed * 1e6), base / ns);
+    }
+}
+
+// The impulse response of one fractional read at a fixed delay.
+static void impulse_response(bool allpass, double delay, double * response) {
+    static float ring[RESPONSE_RING];
+    uint32_t     write = 0;
+    double       state = 0.0;
+    uint32_t     i     = 0;
+
+    memset(ring, 0, sizeof(ring));
+
+    for (i = 0; i < RESPONSE_LENGTH; i++) {
+        response[i] = allpass
+                      ? delay_ring_read_allpass(ring, RESPONSE_RING - 1U, write, delay, &state)
+                      : delay_ring_read_linear(ring, RESPONSE_RING - 1U, write, delay);
+        delay_ring_write(ring, RESPONSE_RING - 1U, &write, (i == 0) ? 1.0 : 0.0);
+    }
+}
+
+// Magnitude and phase delay of a response at normalised angular frequency w.
+static void response_at(const double * response, double w, double * magnitude, double * phaseDelay) {
+    double re = 0.0;
+    double im = 0.0;
+
+    for (uint32_t i = 0; i < RESPONSE_LENGTH; i++) {
+        re += response[i] * cos(w * (double)i);
+        im -= response[i] * sin(w * (double)i);
+    }
+    *magnitude  = sqrt((re * re) + (im * im));
+    *phaseDelay = -atan2(im, re) / w;
+}
+
+static bool check_response(void) {
+    static const double fractions[] = {0.0, 0.25, 0.5, 0.75};
+    static double       response[RESPONSE_LENGTH];
+    bool                ok          = true;
+
+    printf("sub-sample response, delay %.0f + f samples\n", RESPONSE_WHOLE);
+
+    for (uint32_t k = 0; k < (sizeof(fractions) / sizeof(fractions[0])); k++) {
+        double f         = fractions[k];
+        double delay     = RESPONSE_WHOLE + f;
+        double worstGain = 0.0;
+        double magnitude = 0.0;
+        double lowDelay  = 0.0;
+        bool   linearOk  = false;
+        bool   allpassOk = false;
+        int    bin       = 0;
+
+        // Linear: exactly two taps, (1 - f) then f, and nothing anywhere else.
+        impulse_response(false, delay, response);
+        linearOk = (fabs(response[(uint32_t)RESPONSE_WHOLE] - (1.0 - f)) < RESPONSE_TOLERANCE)
+                   && (fabs(response[(uint32_t)RESPONSE_WHOLE + 1U] - f) < RESPONSE_TOLERANCE);
+
+        for (uint32_t i = 0; i < RESPONSE_LENGTH; i++) {
+            if ((i != (uint32_t)RESPONSE_WHOLE) && (i != ((uint32_t)RESPONSE_WHOLE + 1U))
+                && (response[i] != 0.0)) {
+                linearOk = false;
+            }
+        }
+
+        // Allpass: flat magnitude from near DC to near Nyquist, and the asked-for delay low down.
+        impulse_response(true, delay, response);
+
+        for (bin = 1; bin < 64; bin++) {
+            double w     = (M_PI * (double)bin) / 64.0;
+            double phase = 0.0;
+
+            response_at(response, w, &magnitude, &phase);
+            worstGain = fmax(worstGain, fabs(magnitude - 1.0));
+        }
+        response_at(response, 0.001, &magnitude, &lowDelay);
+        allpassOk = (worstGain < 1e-3) && (fabs(lowDelay - delay) < PHASE_TOLERANCE);
+
+        printf("  f = %.2f  linear taps %s   allpass |H| within %.1e of 1, delay %.4f  %s\n",
+               f, linearOk ? "ok" : "WRONG", worstGain, lowDelay, allpassOk ? "ok" : "WRONG");
+        ok = ok && linearOk && allpassOk;
+    }
+    return ok;
+}
+
+int main(int argc, char ** argv) {
+    double seconds = 10.0;
+    bool   ok      = false;
+    int    i       = 0;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--seconds n]\n"
+                    "  Times the engine's delay-line reads and checks their sub-sample response.\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if ((seconds <= 0.0) || (seconds > 3600.0)) {
+        fprintf(stderr, "delaybench: --seconds must be positive and at most an hour\n");
+        return 2;
+    }
+
+    ok = check_response();
+    report_throughput(seconds);
+    printf("%s\n", ok ? "response: pass" : "response: FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,970 @@
+/*
+ * emubench — the editor's whole USB thread against a software G2: connect, edit, reconnect, banks.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// state_handler() in usbComms.c — the readiness poll, the init pull, the edit path, the bank jobs,
+// losing the G2 and finding it again — only ever ran with a G2 on the other end of the cable. This
+// starts the real USB thread, unchanged, with tools/g2Emulator.c standing in for libusb
+// (usb_comms_use_stand_in(), usbComms.h), and times what a user waits for:
+//
+//   CONNECT      start_usb_thread() to eCommsOnLine: the readiness poll and the whole init pull,
+//                every slot's patch, the settings, and the name sweep over every bank. Then every
+//                slot must hold as many modules as its patch file loads, and the patch name table
+//                must list exactly what the emulator's banks hold.
+//
+//   EDITS        --edits parameter changes (300 by default) queued with send_usb_command() at random
+//                gaps of up to 10ms, as a dial drag queues them, each timed from being queued to the
+//                emulator taking its SET_PARAM off the wire: p50, p99 and worst. Changes the command
+//                stage merged into a later one (src/usbCoalesce.c) never reach the wire; they are
+//                counted, not timed.
+//
+//   RECONNECT    --reconnects times (3 by default): the cable pulled, the editor seeing it, the cable
+//                back in, and the time from that to eCommsOnLine again. The open poll is 500ms, so
+//                expect up to that on top of the init pull; the editor's own figure, from opening the
+//                G2 to on line, leaves it out and is printed beside the cold connect's. Nothing changed
+//                on the G2, so each should be warm: every slot kept, its patch dump read again to check
+//                the values but nothing else pulled. Then once more with slots A and D swapped on the
+//                G2 while the cable is out, which must pull those two, and once with a value of slot
+//                B's turned on the G2's panel — no new version, no new name — which must pull slot B,
+//                after which the editor must hold the new value. The slots are checked after each.
+//
+//   BANKS        A backup of patch bank 1 (eMsgCmdBackupBank) into a scratch folder, timed to its
+//                completion alert, in locations and bytes a second. Then a restore of that folder into
+//                bank 2 (eMsgCmdRestoreBank), after which bank 2 must hold bank 1's bodies byte for
+//                byte, and every other location of it must be empty.
+//
+//   A DIAL DURING A BACKUP   Bank 1 backed up again while a dial is turned, one value every
+//                --backup-gap-us at most (250 by default), each timed from being queued to the
+//                emulator taking it, or a later value the command stage merged it into, off the wire:
+//                either way that is when the G2 heard the dial get there. backup_bank() yields to the realtime lane before each
+//                location's request (serve_realtime_lane(), usbComms.c), so a value must go out before
+//                the second location request after it was queued — the one after the yield it may just
+//                have missed. One that waits longer has waited for the job. Printed beside the longest
+//                location round trip, which is what it should wait at most, and the whole backup, which
+//                is what it waited behind one FIFO. On the default link a location takes a few
+//                microseconds; --latency-us makes the numbers look like a real G2's. Then again with an
+//                edit to another module, its colour, queued between the backup and the dial: the dial
+//                must not wait for it, and the edit itself must wait for the job, reaching the G2 only
+//                after the last location.
+//
+// THE EMULATED G2. Its four slots hold the first four PatchTestFiles patches that load (Corrupt.pch2
+// is skipped); bank 1 holds every one of them, every fourth location, and bank 3 a few more, so the
+// name sweep crosses both gaps and banks. --latency-us, --jitter-us and --loss make the link slower,
+// less even and lossy (thousandths of the messages to the host, dropped whole); --stream-ms sets how
+// often it sends LED and meter messages while started; --seed fixes the jitter and the losses. With
+// --loss the editor's retries are what is being measured, and a stage may fail as it would on a bad
+// cable: that is a result, not a bug in the bench.
+//
+//     ./do-emubench
+//     ./emubench --latency-us 1000 --jitter-us 500 --reconnects 5
+//     ./emubench --loss 5 --seed 7
+//
+// Exits non-zero if the editor did not come on line, a slot or the name table came back wrong, a
+// reconnect on a lossless link pulled a slot nothing had changed, or kept one that had, the editor
+// missed a value turned on the panel, a backup or restore failed, bank 2 did not end up a copy of
+// bank 1, a dial value waited out more than one yield of a backup, or the edit queued ahead of the dial
+// went out before the backup was done, or not at all.
+//
+// Build: see tools/do-emubench. libusb and the GLFW headers are needed to compile usbComms.c; neither
+// is called.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "utils.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "protocol.h"
+#include "graphics.h"
+#include "deviceSync.h"
+#include "paramPages.h"
+#include "usbComms.h"
+#include "../vst3/g2Patch.h"
+#include "g2Emulator.h"
+
+#define BENCH_MAX_PATCHES        (32U)
+#define BENCH_QUEUE_DEPTH        (4096U)
+#define BENCH_EDIT_GAP_US        (10000U)      // edits queued up to this far apart
+#define BENCH_ONLINE_MS          (60000U)      // longest a connect may take before it is a failure
+#define BENCH_OFFLINE_MS         (5000U)       // longest the editor may take to notice the cable pulled
+#define BENCH_JOB_MS             (300000U)     // longest a bank backup or restore may take
+#define BENCH_SOURCE_BANK        (0U)
+#define BENCH_DEST_BANK          (1U)
+#define BENCH_EXTRA_BANK         (2U)
+#define BENCH_BANK_STRIDE        (4U)
+#define BENCH_BACKUP_EDITS       (8192U)       // most dial values queued during the backup with a dial
+
+// ── STUBS ──────────────────────────────────────────────────────────────────────────────────────────
+
+// The two queues the USB thread uses, for real this time: commands go to it and alerts come back.
+// SynthLib's queues are not linked, and tMessageQueue is SynthLib's to lay out, so each queue here is
+// kept aside and found by the address of the one it stands for.
+typedef struct {
+    const tMessageQueue * owner;
+    tMessageContent       message[BENCH_QUEUE_DEPTH];
+    uint32_t              head;
+    uint32_t              count;
+} tBenchQueue;
+
+static pthread_mutex_t gQueueLock  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  gQueueReady = PTHREAD_COND_INITIALIZER;
+static tBenchQueue     gQueues[2];
+static volatile bool   gQuit;
+
+static tBenchQueue * queue_for(const tMessageQueue * msgQueue) {
+    return &gQueues[(msgQueue == &gToGuiThread) ? 1 : 0];
+}
+
+void msg_init(tMessageQueue * msgQueue, const char * name, size_t size) {
+    (void)name;
+    (void)size;
+    pthread_mutex_lock(&gQueueLock);
+    queue_for(msgQueue)->owner = msgQueue;
+    pthread_mutex_unlock(&gQueueLock);
+}
+
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    tBenchQueue * queue = NULL;
+
+    pthread_mutex_lock(&gQueueLock);
+    queue = queue_for(msgQueue);
+
+    if (queue->count < BENCH_QUEUE_DEPTH) {
+        memcpy(&queue->message[(queue->head + queue->count) % BENCH_QUEUE_DEPTH], content, sizeof(tMessageContent));
+        queue->count++;
+    }
+    pthread_cond_broadcast(&gQueueReady);
+    pthread_mutex_unlock(&gQueueLock);
+}
+
+// Pops the oldest message, waiting up to timeoutMs for one. False if there was none.
+static bool queue_take(tBenchQueue * queue, void * content, uint32_t timeoutMs) {
+    struct timespec until;
+    bool            found = false;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec  += (time_t)(timeoutMs / 1000U);
+    until.tv_nsec += (long)(timeoutMs % 1000U) * 1000000L;
+
+    if (until.tv_nsec >= 1000000000L) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&gQueueLock);
+
+    while ((queue->count == 0) && (timeoutMs > 0)) {
+        if (pthread_cond_timedwait(&gQueueReady, &gQueueLock, &until) != 0) {
+            break;
+        }
+    }
+
+    if (queue->count > 0) {
+        memcpy(content, &queue->message[queue->head], sizeof(tMessageContent));
+        queue->head = (queue->head + 1) % BENCH_QUEUE_DEPTH;
+        queue->count--;
+        found       = true;
+    }
+    pthread_mutex_unlock(&gQueueLock);
+    return found;
+}
+
+int msg_receive(tMessageQueue * msgQueue, eRcv mode, void * content) {
+    return queue_take(queue_for(msgQueue), content, (mode == eRcvPoll) ? 0 : UINT32_MAX / 2) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint32_t msg_count(tMessageQueue * msgQueue) {
+    uint32_t count = 0;
+
+    pthread_mutex_lock(&gQueueLock);
+    count = queue_for(msgQueue)->count;
+    pthread_mutex_unlock(&gQueueLock);
+    return count;
+}
+
+bool synthlib_quit_requested(void) {
+    return gQuit;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// What usbComms.c reaches of the UI. Patch and performance files are only written by the save
+// commands, which the bench never sends; a bank backup writes its own.
+tParamPagesEdit gParamPages = {0};
+
+int write_database_to_file(const char * filepath, uint32_t slot) {
+    (void)filepath;
+    (void)slot;
+    return EXIT_FAILURE;
+}
+
+int write_perf_to_file(const char * filepath) {
+    (void)filepath;
+    return EXIT_FAILURE;
+}
+
+uint32_t device_sync_drain_offline_edits(void) {
+    return 0;
+}
+
+static void no_ui(void) {
+}
+
+// ── TIMING ─────────────────────────────────────────────────────────────────────────────────────────
+
+static uint64_t now_nanos(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int compare_u64(const void * a, const void * b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Waits for gCommsState to be (or, with !equal, to stop being) state. Returns the nanoseconds it took,
+// or 0 on a timeout.
+static uint64_t wait_for_state(tCommsState state, bool equal, uint32_t timeoutMs) {
+    uint64_t start = now_nanos();
+
+    while ((gCommsState == state) != equal) {
+        if ((now_nanos() - start) > ((uint64_t)timeoutMs * 1000000ULL)) {
+            return 0;
+        }
+        usleep(200);
+    }
+    return now_nanos() - start;
+}
+
+// The next alert the USB thread posts, up to timeoutMs from now. False if none came.
+static bool wait_for_alert(tMessageContent * alert, uint32_t timeoutMs) {
+    uint64_t giveUp = now_nanos() + ((uint64_t)timeoutMs * 1000000ULL);
+
+    while (now_nanos() < giveUp) {
+        if (queue_take(&gQueues[1], alert, 100) && (alert->cmd == eRspAlert)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ── THE SLOTS AND THE NAME TABLE ───────────────────────────────────────────────────────────────────
+
+static uint32_t gWantModules[MAX_SLOTS];
+
+static bool check_slots(const char * when, bool show) {
+    bool ok = true;
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        uint32_t modules = (uint32_t)count_active_modules(s);
+
+        if (modules != gWantModules[s]) {
+            printf("    %s: slot %c holds %u modules, its patch %u  FAIL\n", when, 'A' + s, (unsigned)modules,
+                   (unsigned)gWantModules[s]);
+            ok = false;
+        }
+    }
+
+    if (show) {
+        printf("    slots: %u, %u, %u and %u modules%s\n", (unsigned)gWantModules[0], (unsigned)gWantModules[1],
+               (unsigned)gWantModules[2], (unsigned)gWantModules[3], ok ? ", as their patches load" : "");
+    }
+    return ok;
+}
+
+static bool check_name_table(void) {
+    static uint8_t content[PATCH_FILE_SIZE];
+    uint32_t       listed = 0;
+    bool           ok     = true;
+
+    for (uint32_t b = 0; b < NUM_PATCH_BANKS; b++) {
+        for (uint32_t l = 0; l < NUM_LOCATIONS_PER_BANK; l++) {
+            bool held = g2_emulator_bank_content(BANK_UPLOAD_DOMAIN_PATCH, b, l, content, sizeof(content)) > 0;
+
+            if (held != gPatchNameTable[b][l].populated) {
+                printf("    name table: bank %u location %u %s  FAIL\n", (unsigned)b + 1, (unsigned)l + 1,
+                       held ? "missing" : "listed, but the G2 holds nothing there");
+                ok = false;
+            }
+            listed += held ? 1U : 0U;
+        }
+    }
+    printf("    name table: %u patch locations listed%s\n", (unsigned)listed, ok ? "" : "  FAIL");
+    return ok;
+}
+
+// ── EDITS ──────────────────────────────────────────────────────────────────────────────────────────
+
+// Every edit sets the same parameter, each to the next value along, so the value on the wire says
+// which edit it was. 128 values; at 5ms an edit, a value comes round again every 640ms, far longer
+// than any edit takes to arrive.
+#define BENCH_EDIT_LOCATION      (locationVa)
+#define BENCH_EDIT_MODULE        (1U)
+#define BENCH_EDIT_PARAM         (0U)
+#define BENCH_EDIT_VALUES        (128U)
+
+static pthread_mutex_t gEditLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t        gEditOfValue[BENCH_EDIT_VALUES];
+static uint64_t *      gEditQueued;
+static uint64_t *      gEditArrived;
+
+static void observe_edit(uint32_t slot, uint8_t subCommand, const uint8_t * payload, uint32_t length) {
+    uint64_t now = now_nanos();
+
+    if ((subCommand != SUB_COMMAND_SET_PARAM) || (length < 5) || (slot != 0)
+        || (payload[0] != BENCH_EDIT_LOCATION) || (payload[1] != BENCH_EDIT_MODULE) || (payload[2] != BENCH_EDIT_PARAM)) {
+        return;
+    }
+    pthread_mutex_lock(&gEditLock);
+
+    if (gEditArrived != NULL) {
+        uint32_t edit = gEditOfValue[payload[3] % BENCH_EDIT_VALUES];
+
+        if (gEditArrived[edit] == 0) {
+            gEditArrived[edit] = now;
+        }
+    }
+    pthread_mutex_unlock(&gEditLock);
+}
+
+static bool run_edits(uint32_t count) {
+    uint64_t * latency = malloc(sizeof(uint64_t) * count);
+    uint32_t   arrived = 0;
+
+    gEditQueued  = calloc(count, sizeof(uint64_t));
+    gEditArrived = calloc(count, sizeof(uint64_t));
+
+    if ((latency == NULL) || (gEditQueued == NULL) || (gEditArrived == NULL)) {
+        return false;
+    }
+    g2_emulator_observe(observe_edit);
+
+    for (uint32_t e = 0; e < count; e++) {
+        tMessageContent edit = {0};
+
+        edit.cmd                           = eMsgCmdSetValue;
+        edit.slot                          = 0;
+        edit.paramData.moduleKey.slot      = 0;
+        edit.paramData.moduleKey.location  = BENCH_EDIT_LOCATION;
+        edit.paramData.moduleKey.index     = BENCH_EDIT_MODULE;
+        edit.paramData.param               = BENCH_EDIT_PARAM;
+        edit.paramData.value               = e % BENCH_EDIT_VALUES;
+        edit.paramData.variation           = 0;
+
+        pthread_mutex_lock(&gEditLock);
+        gEditOfValue[e % BENCH_EDIT_VALUES] = e;
+        gEditQueued[e]                     = now_nanos();
+        pthread_mutex_unlock(&gEditLock);
+        send_usb_command(&edit);
+        usleep((useconds_t)(rand() % BENCH_EDIT_GAP_US));
+    }
+    usleep(200000);    // the last few, and anything held back behind a merge
+    g2_emulator_observe(NULL);
+
+    pthread_mutex_lock(&gEditLock);
+
+    for (uint32_t e = 0; e < count; e++) {
+        if (gEditArrived[e] != 0) {
+            latency[arrived++] = gEditArrived[e] - gEditQueued[e];
+        }
+    }
+    free(gEditQueued);
+    free(gEditArrived);
+    gEditQueued  = NULL;
+    gEditArrived = NULL;
+    pthread_mutex_unlock(&gEditLock);
+
+    if (arrived == 0) {
+        printf("edits      none of %u reached the G2  FAIL\n", (unsigned)count);
+        free(latency);
+        return false;
+    }
+    qsort(latency, arrived, sizeof(latency[0]), compare_u64);
+    printf("edits      queued to on the wire: p50 %8.1f us   p99 %8.1f us   worst %8.1f us   %u sent, %u merged\n",
+           (double)latency[arrived / 2] / 1e3, (double)latency[(arrived * 99) / 100] / 1e3,
+           (double)latency[arrived - 1] / 1e3, (unsigned)arrived, (unsigned)(count - arrived));
+    free(latency);
+    return true;
+}
+
+// ── RECONNECTS ─────────────────────────────────────────────────────────────────────────────────────
+
+// What changes on the G2 while the cable is out.
+typedef enum {
+    changeNothing,
+    changeSwap,     // slots A and D swapped, as if each were loaded with the other's patch
+    changeTurn      // one of slot B's values turned on the panel: no new version, no new name
+} tBenchChange;
+
+// The value changeTurn turns: slot B's first parameter of its first VA module that has any, in
+// variation 0. gTurnModule is that module's index, or MAX_NUM_MODULES if slot B has none.
+#define BENCH_TURN_SLOT          (1U)
+
+static uint32_t gTurnModule = MAX_NUM_MODULES;
+static uint32_t gTurnValue  = 0;
+
+static bool turn_on_panel(void) {
+    for (uint32_t i = 0; i < MAX_NUM_MODULES; i++) {
+        tModule * module = get_module_slot(BENCH_TURN_SLOT, locationVa, i);
+
+        if (module->active && (module->actualParamCount > 0)) {
+            gTurnModule = i;
+            gTurnValue  = module->param[0][0].value ^ 1U;
+            return g2_emulator_turn_param(BENCH_TURN_SLOT, locationVa, i, 0, 0, gTurnValue);
+        }
+    }
+    gTurnModule = MAX_NUM_MODULES;
+    return false;
+}
+
+// Pulls the cable and puts it back, with the G2 changed in between as change says. Returns the time
+// from the cable going back in to on line, 0 on a failure; *opened and *kept are what the editor
+// measured of its own connect (usb_comms_last_connect()).
+static uint64_t reconnect_once(uint32_t r, tBenchChange change, uint32_t * opened, uint32_t * kept) {
+    uint64_t online = 0;
+
+    g2_emulator_plug(false);
+
+    if (wait_for_state(eCommsOnLine, false, BENCH_OFFLINE_MS) == 0) {
+        printf("reconnect  %u: the editor did not notice the cable pulled  FAIL\n", (unsigned)r + 1);
+        g2_emulator_plug(true);
+        return 0;
+    }
+
+    if (change == changeSwap) {
+        uint32_t modules = gWantModules[0];
+
+        g2_emulator_swap_slots(0, MAX_SLOTS - 1);
+        gWantModules[0]             = gWantModules[MAX_SLOTS - 1];
+        gWantModules[MAX_SLOTS - 1] = modules;
+    } else if ((change == changeTurn) && (turn_on_panel() == false)) {
+        printf("reconnect  %u: slot B has no value to turn  FAIL\n", (unsigned)r + 1);
+        g2_emulator_plug(true);
+        return 0;
+    }
+    usleep(100000);    // long enough for the editor to try, and fail, to open it again
+    g2_emulator_plug(true);
+    online = wait_for_state(eCommsOnLine, true, BENCH_ONLINE_MS);
+
+    if (online == 0) {
+        printf("reconnect  %u: not on line again after %u ms  FAIL\n", (unsigned)r + 1, BENCH_ONLINE_MS);
+        return 0;
+    }
+    *opened = usb_comms_last_connect(kept);
+
+    if ((change == changeTurn)
+        && (get_module_slot(BENCH_TURN_SLOT, locationVa, gTurnModule)->param[0][0].value != gTurnValue)) {
+        printf("reconnect  %u: slot B's value turned on the panel is not the editor's  FAIL\n", (unsigned)r + 1);
+        return 0;
+    }
+    return check_slots((change == changeSwap) ? "after slots A and D changed" : "after a reconnect", false) ? online : 0;
+}
+
+// count reconnects with nothing changed on the G2, which should keep every slot (on a lossless link —
+// a lost reply to the name check costs a slot its place, as it should), then one with two slots
+// changed, which must pull those two again and may keep the others, then one with a value turned on
+// the panel, which must pull that slot again and leave the editor holding the new value.
+static bool run_reconnects(uint32_t count, bool lossless) {
+    uint64_t * online   = malloc(sizeof(uint64_t) * ((count > 0) ? count : 1));
+    uint64_t   total    = 0;
+    uint64_t   openedMs = 0;
+    uint32_t   opened   = 0;
+    uint32_t   kept     = 0;
+    uint32_t   keptAll  = 0;
+    uint64_t   changed  = 0;
+
+    if (online == NULL) {
+        return false;
+    }
+
+    for (uint32_t r = 0; r < count; r++) {
+        online[r] = reconnect_once(r, changeNothing, &opened, &kept);
+
+        if (online[r] == 0) {
+            free(online);
+            return false;
+        }
+        total    += online[r];
+        openedMs += opened;
+        keptAll  += kept;
+    }
+
+    if (count > 0) {
+        qsort(online, count, sizeof(online[0]), compare_u64);
+        printf("reconnect  cable back in to on line: mean %8.1f ms   best %8.1f ms   worst %8.1f ms   (%u)\n",
+               (double)total / (double)count / 1e6, (double)online[0] / 1e6, (double)online[count - 1] / 1e6,
+               (unsigned)count);
+        printf("           opened to on line, warm: mean %8.1f ms, %.1f of %u slots kept%s\n",
+               (double)openedMs / (double)count, (double)keptAll / (double)count, MAX_SLOTS,
+               (lossless && (keptAll != (count * MAX_SLOTS))) ? "  FAIL" : "");
+    }
+    free(online);
+
+    if (lossless && (keptAll != (count * MAX_SLOTS))) {
+        return false;
+    }
+    changed = reconnect_once(count, changeSwap, &opened, &kept);
+
+    if (changed == 0) {
+        return false;
+    }
+    printf("           slots A and D changed on the G2: opened to on line %8.1f ms, %u of %u slots kept%s\n",
+           (double)opened, (unsigned)kept, MAX_SLOTS, (kept > (MAX_SLOTS - 2)) ? "  FAIL" : "");
+
+    if (kept > (MAX_SLOTS - 2)) {
+        return false;
+    }
+    changed = reconnect_once(count + 1, changeTurn, &opened, &kept);
+
+    if (changed == 0) {
+        return false;
+    }
+    printf("           a value on slot B turned on the panel: opened to on line %8.1f ms, %u of %u slots kept%s\n",
+           (double)opened, (unsigned)kept, MAX_SLOTS, (kept > (MAX_SLOTS - 1)) ? "  FAIL" : "");
+    return kept <= (MAX_SLOTS - 1);
+}
+
+// ── BANKS ──────────────────────────────────────────────────────────────────────────────────────────
+
+static bool run_banks(const char * dir) {
+    static uint8_t  source[PATCH_FILE_SIZE];
+    static uint8_t  dest[PATCH_FILE_SIZE];
+    tMessageContent command   = {0};
+    tMessageContent alert     = {0};
+    uint64_t        start     = 0;
+    uint64_t        took      = 0;
+    uint64_t        bytes     = 0;
+    uint32_t        locations = 0;
+    uint32_t        wrong     = 0;
+
+    for (uint32_t l = 0; l < NUM_LOCATIONS_PER_BANK; l++) {
+        uint32_t length = g2_emulator_bank_content(BANK_UPLOAD_DOMAIN_PATCH, BENCH_SOURCE_BANK, l, source, sizeof(source));
+
+        bytes     += length;
+        locations += (length > 0) ? 1U : 0U;
+    }
+    command.cmd                   = eMsgCmdBackupBank;
+    command.bankBackupData.bank   = BENCH_SOURCE_BANK;
+    command.bankBackupData.isPerf = false;
+    snprintf(command.bankBackupData.destFolder, sizeof(command.bankBackupData.destFolder), "%s", dir);
+    start                         = now_nanos();
+    send_usb_command(&command);
+
+    if ((wait_for_alert(&alert, BENCH_JOB_MS) == false) || (strstr(alert.alertData.message, "complete") == NULL)) {
+        printf("backup     %s  FAIL\n", (alert.cmd == eRspAlert) ? alert.alertData.message : "no completion alert");
+        return false;
+    }
+    took = now_nanos() - start;
+    printf("backup     bank %u, %u patches: %8.1f ms   %7.1f locations/s   %7.1f kB/s\n", BENCH_SOURCE_BANK + 1,
+           (unsigned)locations, (double)took / 1e6, (double)NUM_LOCATIONS_PER_BANK / ((double)took / 1e9),
+           ((double)bytes / 1024.0) / ((double)took / 1e9));
+
+    memset(&command, 0, sizeof(command));
+    command.cmd                        = eMsgCmdRestoreBank;
+    command.bankRestoreData.sourceBank = BENCH_SOURCE_BANK;
+    command.bankRestoreData.destBank   = BENCH_DEST_BANK;
+    command.bankRestoreData.isPerf     = false;
+    snprintf(command.bankRestoreData.srcFolder, sizeof(command.bankRestoreData.srcFolder), "%s", dir);
+    start                              = now_nanos();
+    send_usb_command(&command);
+
+    if ((wait_for_alert(&alert, BENCH_JOB_MS) == false) || (strstr(alert.alertData.message, "complete") == NULL)) {
+        printf("restore    %s  FAIL\n", (alert.cmd == eRspAlert) ? alert.alertData.message : "no completion alert");
+        return false;
+    }
+    took = now_nanos() - start;
+
+    for (uint32_t l = 0; l < NUM_LOCATIONS_PER_BANK; l++) {
+        uint32_t want = g2_emulator_bank_content(BANK_UPLOAD_DOMAIN_PATCH, BENCH_SOURCE_BANK, l, source, sizeof(source));
+        uint32_t got  = g2_emulator_bank_content(BANK_UPLOAD_DOMAIN_PATCH, BENCH_DEST_BANK, l, dest, sizeof(dest));
+
+        if ((want != got) || (memcmp(source, dest, (want < sizeof(source)) ? want : sizeof(source)) != 0)) {
+            wrong++;
+        }
+    }
+    printf("restore    into bank %u: %8.1f ms   %7.1f locations/s   %s\n", BENCH_DEST_BANK + 1, (double)took / 1e6,
+           (double)NUM_LOCATIONS_PER_BANK / ((double)took / 1e9), (wrong == 0) ? "ok" : "");
+
+    if (wrong > 0) {
+        printf("           %u locations of bank %u differ from bank %u  FAIL\n", (unsigned)wrong, BENCH_DEST_BANK + 1,
+               BENCH_SOURCE_BANK + 1);
+    }
+    return wrong == 0;
+}
+
+// ── A DIAL DURING A BACKUP ─────────────────────────────────────────────────────────────────────────
+
+#define BENCH_AHEAD_MODULE       (BENCH_EDIT_MODULE + 1U)   // the module the edit ahead of the dial recolours
+
+static uint64_t gLocationAsked[NUM_LOCATIONS_PER_BANK];
+static uint32_t gLocationsAsked;
+static uint64_t gAheadArrived;
+
+// The edits' observer, plus the time each location's request arrived.
+static void observe_backup(uint32_t slot, uint8_t subCommand, const uint8_t * payload, uint32_t length) {
+    if (subCommand == SUB_COMMAND_PATCH_BANK_UPLOAD) {
+        pthread_mutex_lock(&gEditLock);
+
+        if (gLocationsAsked < NUM_LOCATIONS_PER_BANK) {
+            gLocationAsked[gLocationsAsked++] = now_nanos();
+        }
+        pthread_mutex_unlock(&gEditLock);
+        return;
+    }
+
+    if ((subCommand == SUB_COMMAND_SET_MODULE_COLOUR) && (slot == 0) && (length >= 2)
+        && (payload[0] == BENCH_EDIT_LOCATION) && (payload[1] == BENCH_AHEAD_MODULE)) {
+        pthread_mutex_lock(&gEditLock);
+        gAheadArrived = (gAheadArrived == 0) ? now_nanos() : gAheadArrived;
+        pthread_mutex_unlock(&gEditLock);
+        return;
+    }
+    observe_edit(slot, subCommand, payload, length);
+}
+
+// With editAhead, an edit to another module is queued between the backup and the first dial value.
+static bool run_backup_with_dial(const char * dir, uint32_t gapUs, bool editAhead) {
+    const char *    label   = editAhead ? "behind an edit" : "during a backup";
+    uint64_t *      latency = malloc(sizeof(uint64_t) * BENCH_BACKUP_EDITS);
+    tMessageContent command = {0};
+    tMessageContent alert   = {0};
+    bool            done    = false;
+    uint32_t        queued  = 0;
+    uint32_t        sent    = 0;
+    uint32_t        timed   = 0;
+    uint32_t        missed  = 0;
+    uint64_t        out     = 0;
+    uint64_t        start   = 0;
+    uint64_t        took    = 0;
+    uint64_t        longest = 0;
+
+    gEditQueued     = calloc(BENCH_BACKUP_EDITS, sizeof(uint64_t));
+    gEditArrived    = calloc(BENCH_BACKUP_EDITS, sizeof(uint64_t));
+    gLocationsAsked = 0;
+    gAheadArrived   = 0;
+
+    if ((latency == NULL) || (gEditQueued == NULL) || (gEditArrived == NULL)) {
+        return false;
+    }
+    g2_emulator_observe(observe_backup);
+
+    command.cmd                   = eMsgCmdBackupBank;
+    command.bankBackupData.bank   = BENCH_SOURCE_BANK;
+    command.bankBackupData.isPerf = false;
+    snprintf(command.bankBackupData.destFolder, sizeof(command.bankBackupData.destFolder), "%s", dir);
+    start                         = now_nanos();
+    send_usb_command(&command);
+
+    if (editAhead == true) {
+        tMessageContent edit = {0};
+
+        edit.cmd                                 = eMsgCmdSetModuleColour;
+        edit.slot                                = 0;
+        edit.moduleColourData.moduleKey.slot     = 0;
+        edit.moduleColourData.moduleKey.location = BENCH_EDIT_LOCATION;
+        edit.moduleColourData.moduleKey.index    = BENCH_AHEAD_MODULE;
+        edit.moduleColourData.colour             = 1;
+        send_usb_command(&edit);
+    }
+
+    // The dial turns until the job says it is done.
+    while ((done == false) && ((now_nanos() - start) < ((uint64_t)BENCH_JOB_MS * 1000000ULL))) {
+        if (queued < BENCH_BACKUP_EDITS) {
+            tMessageContent edit = {0};
+
+            edit.cmd                          = eMsgCmdSetValue;
+            edit.slot                         = 0;
+            edit.paramData.moduleKey.slot     = 0;
+            edit.paramData.moduleKey.location = BENCH_EDIT_LOCATION;
+            edit.paramData.moduleKey.index    = BENCH_EDIT_MODULE;
+            edit.paramData.param              = BENCH_EDIT_PARAM;
+            edit.paramData.value              = queued % BENCH_EDIT_VALUES;
+            edit.paramData.variation          = 0;
+
+            pthread_mutex_lock(&gEditLock);
+            gEditOfValue[queued % BENCH_EDIT_VALUES] = queued;
+            gEditQueued[queued]                      = now_nanos();
+            pthread_mutex_unlock(&gEditLock);
+            send_usb_command(&edit);
+            queued++;
+        }
+        usleep((useconds_t)(rand() % (gapUs + 1)));
+        done = queue_take(&gQueues[1], &alert, 0) && (alert.cmd == eRspAlert);
+    }
+    took = now_nanos() - start;
+    usleep(200000);    // whatever the last location left queued goes once the job is done
+    g2_emulator_observe(NULL);
+
+    pthread_mutex_lock(&gEditLock);
+
+    for (uint32_t l = 1; l < gLocationsAsked; l++) {
+        longest = ((gLocationAsked[l] - gLocationAsked[l - 1]) > longest) ? (gLocationAsked[l] - gLocationAsked[l - 1]) : longest;
+    }
+
+    // Backwards, so `out` is when this value or a later one that replaced it went out.
+    for (uint32_t e = queued; e-- > 0;) {
+        uint32_t next = 0;
+
+        if (gEditArrived[e] != 0) {
+            out = ((out == 0) || (gEditArrived[e] < out)) ? gEditArrived[e] : out;
+            sent++;
+        }
+
+        if (out == 0) {
+            continue;
+        }
+        latency[timed++] = out - gEditQueued[e];
+
+        // The first request after it was queued, and the one after that: it must be out by then.
+        while ((next < gLocationsAsked) && (gLocationAsked[next] <= gEditQueued[e])) {
+            next++;
+        }
+
+        if (((next + 1) < gLocationsAsked) && (out > gLocationAsked[next + 1])) {
+            missed++;
+        }
+    }
+    free(gEditQueued);
+    free(gEditArrived);
+    gEditQueued  = NULL;
+    gEditArrived = NULL;
+    pthread_mutex_unlock(&gEditLock);
+
+    if ((done == false) || (strstr(alert.alertData.message, "complete") == NULL)) {
+        printf("dial       %s: %s  FAIL\n", label, done ? alert.alertData.message : "no completion alert");
+        free(latency);
+        return false;
+    }
+
+    if (timed == 0) {
+        printf("dial       %s: none of %u values reached the G2  FAIL\n", label, (unsigned)queued);
+        free(latency);
+        return false;
+    }
+    qsort(latency, timed, sizeof(latency[0]), compare_u64);
+    printf("dial       %s, queued to on the wire: p50 %8.1f us   p99 %8.1f us   worst %8.1f us   %u sent, %u merged\n",
+           label, (double)latency[timed / 2] / 1e3, (double)latency[(timed * 99) / 100] / 1e3,
+           (double)latency[timed - 1] / 1e3, (unsigned)sent, (unsigned)(queued - sent));
+    printf("           longest location round trip %8.1f us, the whole backup %8.1f ms; %u waited out a yield%s\n",
+           (double)longest / 1e3, (double)took / 1e6, (unsigned)missed, (missed > 0) ? "  FAIL" : "");
+    free(latency);
+
+    if (editAhead == true) {
+        bool after = (gAheadArrived != 0) && (gLocationsAsked > 0) && (gAheadArrived > gLocationAsked[gLocationsAsked - 1]);
+
+        printf("           the edit ahead of it %s%s\n",
+               (gAheadArrived == 0) ? "never reached the G2" : (after ? "went out after the backup" : "went out during the backup"),
+               after ? "" : "  FAIL");
+        return (missed == 0) && after;
+    }
+    return missed == 0;
+}
+
+static void remove_dir(const char * dir) {
+    DIR *           handle = opendir(dir);
+    struct dirent * entry  = NULL;
+    char            path[1400];
+
+    while ((handle != NULL) && ((entry = readdir(handle)) != NULL)) {
+        if (entry->d_name[0] != '.') {
+            snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+            remove(path);
+        }
+    }
+
+    if (handle != NULL) {
+        closedir(handle);
+    }
+    rmdir(dir);
+}
+
+// ── SEEDING ────────────────────────────────────────────────────────────────────────────────────────
+
+static uint32_t default_patches(char names[][1024], uint32_t max) {
+    DIR *           dir   = opendir("PatchTestFiles");
+    struct dirent * entry = NULL;
+    uint32_t        count = 0;
+
+    if (dir == NULL) {
+        return 0;
+    }
+
+    while (((entry = readdir(dir)) != NULL) && (count < max)) {
+        size_t length = strlen(entry->d_name);
+
+        if ((length > 5) && (strcmp(&entry->d_name[length - 5], ".pch2") == 0) && (strcmp(entry->d_name, "Corrupt.pch2") != 0)) {
+            snprintf(names[count++], 1024, "PatchTestFiles/%s", entry->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, count, 1024, (int (*)(const void *, const void *))strcmp);
+    return count;
+}
+
+// The slots, with the module count each must come back with — taken from the file the same way the
+// emulator takes its image — then the banks.
+static bool seed(char patches[][1024], uint32_t count) {
+    uint32_t slots  = 0;
+    uint32_t banked = 0;
+
+    for (uint32_t p = 0; (p < count) && (slots < MAX_SLOTS); p++) {
+        if (g2_plugin_load_patch(patches[p], slots) == false) {
+            continue;
+        }
+        gWantModules[slots] = (uint32_t)count_active_modules(slots);
+        clear_slot_data(slots);
+
+        if (g2_emulator_load_slot(slots, patches[p])) {
+            slots++;
+        }
+    }
+
+    for (uint32_t p = 0; p < count; p++) {
+        uint32_t location = p * BENCH_BANK_STRIDE;
+
+        if (location < NUM_LOCATIONS_PER_BANK) {
+            banked += g2_emulator_load_bank(BANK_UPLOAD_DOMAIN_PATCH, BENCH_SOURCE_BANK, location, patches[p]) ? 1U : 0U;
+        }
+
+        if (p < 3) {
+            banked += g2_emulator_load_bank(BANK_UPLOAD_DOMAIN_PATCH, BENCH_EXTRA_BANK, 100 + p, patches[p]) ? 1U : 0U;
+        }
+    }
+    printf("the G2: %u slots and %u bank locations seeded from %u patches\n", (unsigned)slots, (unsigned)banked,
+           (unsigned)count);
+    return (slots == MAX_SLOTS) && (banked > 0);
+}
+
+int main(int argc, char ** argv) {
+    static char       patches[BENCH_MAX_PATCHES][1024];
+    tG2EmulatorConfig config     = {0, 0, 0, 20, 1};
+    tG2EmulatorStats  stats      = {0};
+    uint32_t          edits      = 300;
+    uint32_t          reconnects = 3;
+    uint32_t          backupGap  = 250;
+    uint32_t          patchCount = 0;
+    uint64_t          online     = 0;
+    char              dir[]      = "/tmp/emubench.XXXXXX";
+    char              dialDir[]  = "/tmp/emubench-dial.XXXXXX";
+    bool              ok         = true;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--latency-us") == 0) && ((i + 1) < argc)) {
+            config.latencyUs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--jitter-us") == 0) && ((i + 1) < argc)) {
+            config.jitterUs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--loss") == 0) && ((i + 1) < argc)) {
+            config.lossPerMille = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--stream-ms") == 0) && ((i + 1) < argc)) {
+            config.streamMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--seed") == 0) && ((i + 1) < argc)) {
+            config.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--edits") == 0) && ((i + 1) < argc)) {
+            edits = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--reconnects") == 0) && ((i + 1) < argc)) {
+            reconnects = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--backup-gap-us") == 0) && ((i + 1) < argc)) {
+            backupGap = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--latency-us N] [--jitter-us N] [--loss PER_MILLE] [--stream-ms N] [--seed N]\n"
+                            "          [--edits N] [--reconnects N] [--backup-gap-us N]\n"
+                            "  Runs the editor's USB thread against a software G2 and times connecting,\n"
+                            "  edits, reconnecting, a bank backup and restore, and a dial during a backup.\n", argv[0]);
+            return 126;
+        }
+    }
+
+    if (edits == 0) {
+        edits = 1;
+    }
+    srand(config.seed);
+    init_database();
+    register_glfw_wake_cb(no_ui);
+    register_full_patch_change_notify_cb(no_ui);
+
+    patchCount = default_patches(patches, BENCH_MAX_PATCHES);
+    g2_emulator_init(&config);
+
+    if (seed(patches, patchCount) == false) {
+        fprintf(stderr, "%s: need at least %u patches in PatchTestFiles that load — run from the repository root\n",
+                argv[0], MAX_SLOTS);
+        return 1;
+    }
+
+    if ((mkdtemp(dir) == NULL) || (mkdtemp(dialDir) == NULL)) {
+        fprintf(stderr, "%s: no scratch directory\n", argv[0]);
+        return 1;
+    }
+    printf("the link: replies %u us after the request, up to %u us more, %u/1000 lost; LEDs and meters every %u ms\n\n",
+           (unsigned)config.latencyUs, (unsigned)config.jitterUs, (unsigned)config.lossPerMille, (unsigned)config.streamMs);
+
+    usb_comms_use_stand_in(g2_emulator_stand_in());
+    start_usb_thread();
+    online = wait_for_state(eCommsOnLine, true, BENCH_ONLINE_MS);
+
+    if (online == 0) {
+        printf("connect    not on line after %u ms  FAIL\n", BENCH_ONLINE_MS);
+        ok = false;
+    } else {
+        printf("connect    start to on line: %8.1f ms   opened to on line, cold: %8.1f ms\n", (double)online / 1e6,
+               (double)usb_comms_last_connect(NULL));
+        ok = check_slots("after connecting", true) && ok;
+        ok = check_name_table() && ok;
+        ok = run_edits(edits) && ok;
+        ok = run_reconnects(reconnects, config.lossPerMille == 0) && ok;
+        ok = run_banks(dir) && ok;
+        ok = run_backup_with_dial(dialDir, backupGap, false) && ok;
+        ok = run_backup_with_dial(dialDir, backupGap, true) && ok;
+    }
+    g2_emulator_stats(&stats);
+    printf("\nthe G2: %llu opens, %llu requests (%llu bad, %llu refused), %llu messages sent (%llu LED and meter),"
+           " %llu lost\n", (unsigned long long)stats.opens, (unsigned long long)stats.requests,
+           (unsigned long long)stats.badRequests, (unsigned long long)stats.refused, (unsigned long long)stats.replies,
+           (unsigned long long)stats.streamed, (unsigned long long)stats.lost);
+
+    ok = (stats.badRequests == 0) && ok;
+    remove_dir(dir);
+    remove_dir(dialDir);
+
+    // The USB thread is left where it is: it holds nothing the process needs to give back.
+    gQuit = true;
+    return ok ? 0 : 1;
+}
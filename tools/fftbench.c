@@ -0,0 +1,364 @@
+/*
+ * fftbench — check and time the analysis FFT.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// src/analysis.c is what turns the engine's analysis tap into a spectrum. A wrong FFT draws a
+// plausible-looking picture, so this checks it against answers known in advance before timing it:
+//
+//   1. THE TRANSFORM. Random input at every size from 16 to 4096, against a DFT worked out directly in
+//      double. Odd and even powers of two both, since they take different paths through the last stage.
+//
+//   2. KNOWN SINES. A sine of known frequency and level, off the bin grid, through a Hann window and
+//      the peak finder, at 2k, 8k and 32k: the frequency to a tenth of a bin and the level to 0.2 dB.
+//      A sine exactly on a bin with no window: its level to 0.01 dB and every other bin empty. Two
+//      sines at once: both found, the louder first. DC and Nyquist at their own levels.
+//
+//   3. LEAKAGE. An off-bin sine through Blackman-Harris, which must leave nothing above -90 dB more
+//      than five bins from it — the floor the window is chosen for.
+//
+//   4. THE PEAK HOLD: holds, then falls at its rate, then meets the live level.
+//
+// Then it times the transform and the full spectrum (window, transform, levels) at 2k, 8k and 32k.
+// Exits non-zero if a check fails:
+//
+//     ./do-fftbench && ./fftbench
+//     ./fftbench --seconds 5          a longer timing run per size
+//
+// Build: see tools/do-fftbench. It links src/analysis.c and nothing else of the application's.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/analysis.h"
+
+#define BENCH_RATE           (48000.0)
+#define TRANSFORM_TOLERANCE  (2e-6)     // of the largest bin, in float
+#define HZ_TOLERANCE_BINS    (0.1)
+#define LEVEL_TOLERANCE_DB   (0.2)
+#define LEAKAGE_DB           (-90.0)
+
+static const uint32_t kBenchSizes[] = {2048U, 8192U, 32768U};
+
+#define BENCH_SIZE_COUNT     (sizeof(kBenchSizes) / sizeof(kBenchSizes[0]))
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void fill_sine(float * out, uint32_t count, double hz, double amplitude, double phase) {
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] += (float)(amplitude * sin(phase + ((2.0 * M_PI * hz * (double)i) / BENCH_RATE)));
+    }
+}
+
+static bool check_transform(void) {
+    bool ok = true;
+
+    printf("transform against a direct DFT\n");
+
+    for (uint32_t size = ANALYSIS_FFT_MIN; size <= 4096U; size *= 2U) {
+        tAnalysisFft fft     = {0};
+        float *      in      = calloc(size, sizeof(float));
+        float *      re      = calloc((size / 2) + 1, sizeof(float));
+        float *      im      = calloc((size / 2) + 1, sizeof(float));
+        double       worst   = 0.0;
+        double       largest = 0.0;
+        bool         pass    = false;
+
+        if ((in == NULL) || (re == NULL) || (im == NULL) || !analysis_fft_init(&fft, size, eAnalysisWindowRect)) {
+            fprintf(stderr, "fftbench: out of memory\n");
+            exit(2);
+        }
+        srand(size);
+
+        for (uint32_t i = 0; i < size; i++) {
+            in[i] = (float)(((double)rand() / (double)RAND_MAX) - 0.5);
+        }
+        analysis_fft_real(&fft, in, 1, re, im);
+
+        for (uint32_t k = 0; k <= (size / 2); k++) {
+            double refRe = 0.0;
+            double refIm = 0.0;
+
+            for (uint32_t i = 0; i < size; i++) {
+                double angle = (-2.0 * M_PI * (double)k * (double)i) / (double)size;
+
+                refRe += (double)in[i] * cos(angle);
+                refIm += (double)in[i] * sin(angle);
+            }
+            largest = fmax(largest, hypot(refRe, refIm));
+            worst   = fmax(worst, hypot((double)re[k] - refRe, (double)im[k] - refIm));
+        }
+        pass = (worst / largest) < TRANSFORM_TOLERANCE;
+        printf("  %5u  worst error %.1e of the largest bin  %s\n", size, worst / largest, pass ? "ok" : "WRONG");
+        ok = ok && pass;
+
+        analysis_fft_free(&fft);
+        free(in);
+        free(re);
+        free(im);
+    }
+    return ok;
+}
+
+// One spectrum of in[], at the given size and window, into a fresh db[].
+static float * spectrum_of(const float * in, uint32_t size, tAnalysisWindow window) {
+    tAnalysisFft fft = {0};
+    float *      db  = calloc((size / 2) + 1, sizeof(float));
+
+    if ((db == NULL) || !analysis_fft_init(&fft, size, window)) {
+        fprintf(stderr, "fftbench: out of memory\n");
+        exit(2);
+    }
+    analysis_spectrum_db(&fft, in, 1, db);
+    analysis_fft_free(&fft);
+    return db;
+}
+
+static bool check_sines(void) {
+    bool ok = true;
+
+    printf("known sines, %.0f Hz\n", BENCH_RATE);
+
+    for (uint32_t s = 0; s < BENCH_SIZE_COUNT; s++) {
+        uint32_t      size  = kBenchSizes[s];
+        double        binHz = BENCH_RATE / (double)size;
+        float *       in    = calloc(size, sizeof(float));
+        float *       db    = NULL;
+        tAnalysisPeak peaks[4];
+        uint32_t      found = 0;
+        bool          pass  = false;
+
+        if (in == NULL) {
+            fprintf(stderr, "fftbench: out of memory\n");
+            exit(2);
+        }
+
+        // Off the bin grid, and not by a round fraction of a bin either.
+        fill_sine(in, size, 1000.37, 0.5, 0.3);
+        db    = spectrum_of(in, size, eAnalysisWindowHann);
+        found = analysis_find_peaks(db, (size / 2) + 1, (float)binHz, -60.0f, peaks, 4);
+        pass  = (found >= 1) && (fabs(peaks[0].hz - 1000.37) < (HZ_TOLERANCE_BINS * binHz))
+                && (fabs(peaks[0].db - (20.0 * log10(0.5))) < LEVEL_TOLERANCE_DB);
+        printf("  %5u  hann     1000.37 Hz -6.02 dB  read %8.2f Hz %6.2f dB  %s\n",
+               size, (found >= 1) ? peaks[0].hz : 0.0, (found >= 1) ? peaks[0].db : 0.0, pass ? "ok" : "WRONG");
+        ok = ok && pass;
+        free(db);
+
+        // Two at once, the quieter one higher up.
+        fill_sine(in, size, 7123.9, 0.1, 1.1);
+        db    = spectrum_of(in, size, eAnalysisWindowHann);
+        found = analysis_find_peaks(db, (size / 2) + 1, (float)binHz, -60.0f, peaks, 4);
+        pass  = (found >= 2) && (fabs(peaks[0].hz - 1000.37) < (HZ_TOLERANCE_BINS * binHz))
+                && (fabs(peaks[1].hz - 7123.9) < (HZ_TOLERANCE_BINS * binHz))
+                && (fabs(peaks[1].db - (20.0 * log10(0.1))) < LEVEL_TOLERANCE_DB);
+        printf("  %5u  hann     + 7123.90 Hz -20.00 dB  read %8.2f Hz %6.2f dB  %s\n",
+               size, (found >= 2) ? peaks[1].hz : 0.0, (found >= 2) ? peaks[1].db : 0.0, pass ? "ok" : "WRONG");
+        ok = ok && pass;
+        free(db);
+
+        // On a bin, no window: all of it in that bin and none anywhere else.
+        {
+            uint32_t bin   = size / 16;
+            float    other = ANALYSIS_FLOOR_DB;
+
+            memset(in, 0, size * sizeof(float));
+            fill_sine(in, size, (double)bin * binHz, 1.0, 0.0);
+            db = spectrum_of(in, size, eAnalysisWindowRect);
+
+            for (uint32_t k = 0; k <= (size / 2); k++) {
+                if (k != bin) {
+                    other = fmaxf(other, db[k]);
+                }
+            }
+            pass = (fabs(db[bin]) < 0.01) && (other < -100.0f);
+            printf("  %5u  rect     on bin %u, 0 dB  read %6.3f dB, elsewhere at most %7.1f dB  %s\n",
+                   size, bin, db[bin], other, pass ? "ok" : "WRONG");
+            ok = ok && pass;
+            free(db);
+        }
+
+        // Leakage through Blackman-Harris.
+        {
+            uint32_t centre = (uint32_t)lrint(3210.77 / binHz);
+            float    worst  = ANALYSIS_FLOOR_DB;
+
+            memset(in, 0, size * sizeof(float));
+            fill_sine(in, size, 3210.77, 1.0, 0.0);
+            db = spectrum_of(in, size, eAnalysisWindowBlackmanHarris);
+
+            for (uint32_t k = 0; k <= (size / 2); k++) {
+                if ((k + 5 < centre) || (k > centre + 5)) {
+                    worst = fmaxf(worst, db[k]);
+                }
+            }
+            pass = (worst < LEAKAGE_DB) && (fabs(db[centre]) < 1.0);
+            printf("  %5u  b-harris leakage beyond 5 bins %7.1f dB  %s\n", size, worst, pass ? "ok" : "WRONG");
+            ok = ok && pass;
+            free(db);
+        }
+        free(in);
+    }
+
+    // DC and Nyquist have no mirror image; a level there must still read as its amplitude.
+    {
+        uint32_t size = 1024;
+        float *  in   = calloc(size, sizeof(float));
+        float *  db   = NULL;
+        bool     pass = false;
+
+        if (in == NULL) {
+            fprintf(stderr, "fftbench: out of memory\n");
+            exit(2);
+        }
+
+        for (uint32_t i = 0; i < size; i++) {
+            in[i] = 0.25f + (((i & 1U) != 0) ? -0.125f : 0.125f);
+        }
+        db   = spectrum_of(in, size, eAnalysisWindowRect);
+        pass = (fabs(db[0] - (20.0 * log10(0.25))) < 0.01) && (fabs(db[size / 2] - (20.0 * log10(0.125))) < 0.01);
+        printf("  %5u  rect     DC -12.04 dB, Nyquist -18.06 dB  read %.2f, %.2f  %s\n",
+               size, db[0], db[size / 2], pass ? "ok" : "WRONG");
+        ok = ok && pass;
+        free(db);
+        free(in);
+    }
+    return ok;
+}
+
+static bool check_peak_hold(void) {
+    tAnalysisPeakHold hold   = {0};
+    float             loud[] = {-10.0f};
+    float             quiet[] = {-80.0f};
+    bool              pass   = true;
+
+    printf("peak hold, 0.5 s then 20 dB/s\n");
+
+    if (!analysis_peak_hold_init(&hold, 1, 0.5f, 20.0f)) {
+        fprintf(stderr, "fftbench: out of memory\n");
+        exit(2);
+    }
+    analysis_peak_hold_update(&hold, loud, 0.1f);
+
+    for (uint32_t step = 0; step < 5; step++) {
+        analysis_peak_hold_update(&hold, quiet, 0.1f);
+    }
+    pass = pass && (hold.level[0] == -10.0f);      // still held after 0.5 s
+
+    for (uint32_t step = 0; step < 10; step++) {
+        analysis_peak_hold_update(&hold, quiet, 0.1f);
+    }
+    pass = pass && (fabsf(hold.level[0] - -28.0f) < 0.01f);    // one step to use the hold up, nine falling
+
+    for (uint32_t step = 0; step < 100; step++) {
+        analysis_peak_hold_update(&hold, quiet, 0.1f);
+    }
+    pass = pass && (hold.level[0] == -80.0f);      // and stopped at the live level
+    printf("  %s\n", pass ? "ok" : "WRONG");
+    analysis_peak_hold_free(&hold);
+    return pass;
+}
+
+static void report_timing(double seconds) {
+    printf("timing, %.1f s per size\n", seconds);
+
+    for (uint32_t s = 0; s < BENCH_SIZE_COUNT; s++) {
+        uint32_t     size  = kBenchSizes[s];
+        tAnalysisFft fft   = {0};
+        float *      in    = calloc(size, sizeof(float));
+        float *      re    = calloc((size / 2) + 1, sizeof(float));
+        float *      im    = calloc((size / 2) + 1, sizeof(float));
+        double       us[2] = {0.0, 0.0};
+
+        if ((in == NULL) || (re == NULL) || (im == NULL) || !analysis_fft_init(&fft, size, eAnalysisWindowHann)) {
+            fprintf(stderr, "fftbench: out of memory\n");
+            exit(2);
+        }
+        fill_sine(in, size, 440.0, 0.5, 0.0);
+
+        // The plain transform, then the whole spectrum as a display would ask for it.
+        for (uint32_t pass = 0; pass < 2; pass++) {
+            double   started = now_seconds();
+            double   elapsed = 0.0;
+            uint64_t runs    = 0;
+
+            do {
+                for (uint32_t r = 0; r < 16; r++) {
+                    if (pass == 0) {
+                        analysis_fft_real(&fft, in, 1, re, im);
+                    } else {
+                        analysis_spectrum_db(&fft, in, 1, re);
+                    }
+                }
+                runs   += 16;
+                elapsed = now_seconds() - started;
+            } while (elapsed < (seconds * 0.5));
+
+            us[pass] = (elapsed * 1e6) / (double)runs;
+        }
+
+        // What a display refreshing 30 times a second spends on it, as a share of one core.
+        printf("  %5u  transform %8.2f us  %5.2f ns/sample   spectrum %8.2f us   at 30/s %5.3f %% of a core\n",
+               size, us[0], (us[0] * 1e3) / (double)size, us[1], us[1] * 30.0 * 1e-4);
+
+        analysis_fft_free(&fft);
+        free(in);
+        free(re);
+        free(im);
+    }
+}
+
+int main(int argc, char ** argv) {
+    double seconds = 1.0;
+    bool   ok      = true;
+    int    i       = 0;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--seconds n]\n"
+                    "  Checks the analysis FFT against known answers and times it at 2k, 8k and 32k.\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if ((seconds <= 0.0) || (seconds > 3600.0)) {
+        fprintf(stderr, "fftbench: --seconds must be positive and at most an hour\n");
+        return 2;
+    }
+
+    ok = check_transform() && ok;
+    ok = check_sines() && ok;
+    ok = check_peak_hold() && ok;
+    report_timing(seconds);
+    printf("%s\n", ok ? "checks: pass" : "checks: FAIL");
+    return ok ? 0 : 1;
+}
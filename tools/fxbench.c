@@ -0,0 +1,315 @@
+/*
+ * fxbench — time the engine's audio callback with and without the FX pipeline.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// The FX pipeline (soundEngine.c, "FX PIPELINE") moves the FX area — the delays and the reverb — onto
+// a thread of its own, one block behind the voices. Whether that is worth its latency is a question
+// about ONE number: how long the host's callback takes, because that is what runs out of budget and
+// clicks. Total CPU does not answer it; the pipeline spends slightly MORE of that, not less.
+//
+// So this plays the same chord through the same patch twice, pipeline off and then on, and times every
+// sound_engine_render() call exactly as a host would see it:
+//
+//     ./fxbench                                     PatchTestFiles/SimpleLead.pch2, 256-frame blocks
+//     ./fxbench --patch f.pch2 --block 128 --poly 8 --seconds 10
+//
+// SimpleLead is the default because its FX area is the expensive case — two delays into the reverb —
+// while its voice chain is modest, which is the patch shape the pipeline is for.
+//
+// PACED BY DEFAULT. Each callback starts on its own deadline, as a device would start it, so the FX
+// thread has the gap between callbacks to do its work in. Unpaced (--unpaced) the next callback starts
+// the instant the last one returns and the FX thread is left competing for the same core — a useful
+// worst case, but not what a host does.
+//
+// Read the result on a machine with more than one core. On one, the two threads take turns and the
+// callback time with the pipeline on can only get worse; the underrun count says whether the FX thread
+// kept up at all.
+//
+// --csv f.csv also writes the engine's own callback-time histogram for each run (sound_engine_timing_
+// histogram()), one row per bucket, for plotting the whole distribution rather than three points of it.
+// The engine's percentiles are printed beside this tool's as a check on them: they are bucket edges,
+// so they read up to a quarter-octave high but never low.
+//
+// Build: see tools/do-fxbench.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+
+#define BENCH_RATE         (48000.0)
+#define BENCH_MAX_BLOCK    (4096U)
+#define BENCH_MAX_CALLS    (1U << 20)
+
+// Loading a patch goes through protocol.c, which reports a linked-variation edit to the undo stack and
+// may post to the GUI. There is neither here, and nothing this tool does edits a parameter; these are
+// the two references the link needs, the same two the plug-in answers in g2AppStubs.c.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+typedef struct {
+    double             mean;
+    double             p50;
+    double             p99;
+    double             worst;
+    uint32_t           overBudget;
+    uint32_t           underruns;
+    uint32_t           waitsCut;
+    tSoundEngineTiming engine;
+    uint64_t           counts[SOUND_ENGINE_TIMING_BUCKETS];
+    double             upperUs[SOUND_ENGINE_TIMING_BUCKETS];
+} tBenchResult;
+
+static double now_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e6) + ((double)ts.tv_nsec / 1e3);
+}
+
+static void sleep_until_us(double when) {
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(when / 1e6);
+    ts.tv_nsec = (long)((when - ((double)ts.tv_sec * 1e6)) * 1e3);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+static int compare_double(const void * a, const void * b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+// One run: start the engine, strike a chord, hold it for the whole run so the reverb never empties,
+// and time every callback. The first second is discarded — it holds the note-on transients and the
+// first touch of every buffer, neither of which is the steady state being compared.
+static bool bench_run(bool pipeline, uint32_t block, uint32_t calls, bool paced, double * times, tBenchResult * result) {
+    static float  buffer[BENCH_MAX_BLOCK * 2];
+    static const uint32_t chord[] = {48, 55, 60, 64, 67, 71};
+    uint32_t      warmup          = (uint32_t)(BENCH_RATE / block);
+    double        period          = ((double)block / BENCH_RATE) * 1e6;
+    double        next            = 0.0;
+    double        sum             = 0.0;
+    uint32_t      counted         = 0;
+    uint32_t      call            = 0;
+    uint32_t      i               = 0;
+
+    if (sound_engine_set_fx_pipeline(pipeline, block) == false) {
+        fprintf(stderr, "fxbench: could not set the FX pipeline\n");
+        return false;
+    }
+
+    sound_engine_start_hosted(BENCH_RATE);
+    sound_engine_update_from_patch();
+
+    for (i = 0; i < (sizeof(chord) / sizeof(chord[0])); i++) {
+        sound_engine_note(chord[i], true);
+    }
+
+    memset(result, 0, sizeof(*result));
+    next = now_us();
+
+    for (call = 0; call < (warmup + calls); call++) {
+        double started = 0.0;
+        double elapsed = 0.0;
+
+        if (paced) {
+            sleep_until_us(next);
+            next += period;
+        }
+        started = now_us();
+        sound_engine_render(buffer, block, 2);
+        elapsed = now_us() - started;
+
+        if (call < warmup) {
+            // The engine's histogram starts where this tool's timings do.
+            if (call == (warmup - 1)) {
+                sound_engine_timing_reset(0);
+            }
+            continue;
+        }
+        times[counted++] = elapsed;
+        sum             += elapsed;
+
+        if (elapsed > period) {
+            result->overBudget++;
+        }
+    }
+
+    for (i = 0; i < (sizeof(chord) / sizeof(chord[0])); i++) {
+        sound_engine_note(chord[i], false);
+    }
+    result->underruns = sound_engine_fx_underruns();
+    result->waitsCut  = sound_engine_fx_waits_cut();
+    sound_engine_timing_stats(&result->engine);
+    sound_engine_timing_histogram(result->counts, result->upperUs);
+    sound_engine_stop_hosted();
+
+    qsort(times, counted, sizeof(times[0]), compare_double);
+    result->mean  = sum / (double)counted;
+    result->p50   = times[counted / 2];
+    result->p99   = times[(uint32_t)((double)(counted - 1) * 0.99)];
+    result->worst = times[counted - 1];
+    return true;
+}
+
+static void print_result(const char * label, const tBenchResult * result) {
+    printf("%-10s %9.1f %9.1f %9.1f %9.1f %8u %9u %9u\n", label, result->mean, result->p50, result->p99,
+           result->worst, result->overBudget, result->underruns, result->waitsCut);
+}
+
+static void print_engine_result(const char * label, const tBenchResult * result) {
+    printf("%-10s %9s %9.1f %9.1f %9.1f %8llu   p90 %.1f, p99.9 %.1f\n",
+           label, "", result->engine.p50Us, result->engine.p99Us, result->engine.maxUs,
+           (unsigned long long)result->engine.misses, result->engine.p90Us, result->engine.p999Us);
+}
+
+// One row per histogram bucket per run. Empty buckets are kept, so every run has the same rows.
+static bool write_csv(const char * path, const tBenchResult * off, const tBenchResult * on) {
+    const tBenchResult * runs[]  = {off, on};
+    const char *         names[] = {"off", "on"};
+    FILE *               file    = fopen(path, "w");
+
+    if (file == NULL) {
+        fprintf(stderr, "fxbench: could not write %s\n", path);
+        return false;
+    }
+    fprintf(file, "pipeline,bucket,upper_us,callbacks\n");
+
+    for (uint32_t r = 0; r < 2; r++) {
+        for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+            fprintf(file, "%s,%u,%.3f,%llu\n", names[r], b, runs[r]->upperUs[b], (unsigned long long)runs[r]->counts[b]);
+        }
+    }
+    return fclose(file) == 0;
+}
+
+int main(int argc, char ** argv) {
+    const char * patchPath = "PatchTestFiles/SimpleLead.pch2";
+    const char * csvPath   = NULL;
+    uint32_t     block     = 256;
+    uint32_t     voices    = 0;
+    double       seconds   = 5.0;
+    bool         paced     = true;
+    uint32_t     calls     = 0;
+    double *     times     = NULL;
+    tBenchResult off       = {0};
+    tBenchResult on        = {0};
+    int          i         = 0;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--patch") == 0) && ((i + 1) < argc)) {
+            patchPath = argv[++i];
+        } else if ((strcmp(argv[i], "--block") == 0) && ((i + 1) < argc)) {
+            block = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--poly") == 0) && ((i + 1) < argc)) {
+            voices = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--csv") == 0) && ((i + 1) < argc)) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--unpaced") == 0) {
+            paced = false;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--patch f.pch2] [--block frames] [--poly voices] [--seconds n] [--unpaced] [--csv f.csv]\n"
+                    "  Times each audio callback with the FX pipeline off, then on.\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if ((block == 0) || (block > BENCH_MAX_BLOCK) || (seconds <= 0.0)) {
+        fprintf(stderr, "fxbench: --block must be 1..%u and --seconds positive\n", BENCH_MAX_BLOCK);
+        return 2;
+    }
+    calls = (uint32_t)((seconds * BENCH_RATE) / block);
+
+    if ((calls == 0) || (calls > BENCH_MAX_CALLS)) {
+        fprintf(stderr, "fxbench: %.1f s of %u-frame blocks is out of range\n", seconds, block);
+        return 2;
+    }
+
+    if (g2_plugin_load_patch(patchPath, 0) == false) {
+        fprintf(stderr, "fxbench: could not load %s\n", patchPath);
+        return 1;
+    }
+
+    // A patch saved mono plays one note of the chord. Forcing poly is what makes the voice half of the
+    // callback heavy enough for the comparison to mean anything.
+    if (voices > 0) {
+        gPatchDescr[0].monoPoly   = monoPolyPoly;
+        gPatchDescr[0].voiceCount = voices - 1;   // the descriptor holds the count minus one
+    }
+
+    times = calloc(calls, sizeof(times[0]));
+
+    if (times == NULL) {
+        fprintf(stderr, "fxbench: out of memory\n");
+        return 1;
+    }
+
+    if ((bench_run(false, block, calls, paced, times, &off) == false) ||
+        (bench_run(true, block, calls, paced, times, &on) == false)) {
+        free(times);
+        return 1;
+    }
+    free(times);
+
+    printf("%s, %u-frame blocks (budget %.1f us), %u callbacks%s\n",
+           patchPath, block, ((double)block / BENCH_RATE) * 1e6, calls, paced ? "" : ", unpaced");
+    printf("%-10s %9s %9s %9s %9s %8s %9s %9s\n", "pipeline", "mean us", "p50 us", "p99 us", "max us", "> budget",
+           "underruns", "waits cut");
+    print_result("off", &off);
+    print_result("on", &on);
+    printf("as the engine's own histogram counts them (p50, p99, max, misses):\n");
+    print_engine_result("off", &off);
+    print_engine_result("on", &on);
+
+    if ((csvPath != NULL) && (write_csv(csvPath, &off, &on) == false)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,1292 @@
+/*
+ * g2Emulator — a G2 in software, behind the editor's USB transport.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// See g2Emulator.h for what it models and what it does not. The shape is tools/usbbench.c's simulated
+// device — pending transfers under one lock, completed in handle_events() with the lock dropped — with
+// a G2's protocol where that one echoed. Every reply this file builds is in the layout the parser that
+// reads it (usbComms.c, protocol.c) expects; where a field means nothing to the editor it is zero.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <libusb.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "utils.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "protocol.h"
+#include "../vst3/g2Patch.h"
+#include "g2Emulator.h"
+
+#define EMU_MAX_PENDING         (32U)        // transfers submitted at once; the transport keeps 10
+#define EMU_MAX_QUEUED          (256U)       // messages waiting on one IN endpoint
+#define EMU_STREAM_BACKLOG      (4U)         // a stream tick is skipped while this many interrupt messages wait
+#define EMU_EMBEDDED_MAX        (13U)        // content bytes an interrupt message can carry, less the CRC
+#define EMU_LIST_NAMES_BYTES    (512U)       // entries per list-names reply; the editor asks again for the rest
+#define EMU_METERS              (32U)
+#define EMU_KNOBS               (120U)       // what the G2 always reports, assigned or not
+#define EMU_SYNTH_NAME          "G2 Emulator"
+#define EMU_PERF_NAME           "Emulated"
+#define EMU_DOMAINS             (2U)         // BANK_UPLOAD_DOMAIN_PATCH and _PERFORMANCE
+
+// ── STATE ──────────────────────────────────────────────────────────────────────────────────────────
+
+typedef struct {
+    uint64_t  ready;
+    uint32_t  length;
+    uint8_t * data;
+} tEmuMessage;
+
+typedef struct {
+    tEmuMessage message[EMU_MAX_QUEUED];
+    uint32_t    head;
+    uint32_t    count;
+    uint64_t    lastReady;
+} tEmuQueue;
+
+typedef struct {
+    tUsbTransfer * transfer;
+    bool           cancelled;
+} tEmuPending;
+
+typedef struct {
+    tUsbTransfer * transfer;
+    int            result;
+    int            actual;
+} tEmuCompletion;
+
+typedef struct {
+    char      name[CLAVIA_NAME_SIZE + 1];
+    uint8_t   version;
+    uint8_t * image;          // sections, [type][length16][payload] each, as a patch dump carries them
+    uint32_t  imageLength;
+} tEmuSlot;
+
+typedef struct {
+    bool      populated;
+    char      name[CLAVIA_NAME_SIZE + 1];
+    uint8_t   category;
+    uint8_t * content;        // the .pch2/.prf2 body
+    uint32_t  contentLength;
+    uint8_t * image;          // what a retrieve loads; NULL if the location was only ever pushed
+    uint32_t  imageLength;
+} tEmuEntry;
+
+static pthread_mutex_t     gLock                                                    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t      gWork                                                    = PTHREAD_COND_INITIALIZER;
+static tG2EmulatorConfig   gConfig;
+static tG2EmulatorStats    gStats;
+static tG2EmulatorObserver gObserver;
+static tEmuSlot            gSlots[MAX_SLOTS];
+static tEmuEntry           gBanks[EMU_DOMAINS][NUM_PATCH_BANKS][NUM_LOCATIONS_PER_BANK];
+static uint8_t             gPerfVersion;
+static tEmuPending         gPending[EMU_MAX_PENDING];
+static uint32_t            gPendingCount;
+static tEmuQueue           gInterruptQueue;       // 0x81
+static tEmuQueue           gExtendedQueue;        // 0x82
+static bool                gPlugged;
+static bool                gOpen;
+static bool                gStopped;
+static bool                gInterrupted;          // emu_interrupt() since handle_events last looked
+static uint64_t            gNextStream;
+static uint32_t            gStreamSlot;
+static uint32_t            gStreamTick;
+static uint32_t            gRandom;
+
+// The reply being built. Event thread only.
+static uint8_t             gReply[EXTENDED_MESSAGE_SIZE];
+
+static uint64_t now_nanos(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+// xorshift32: the same run for the same seed, which a timing comparison wants.
+static uint32_t next_random(void) {
+    gRandom ^= gRandom << 13;
+    gRandom ^= gRandom >> 17;
+    gRandom ^= gRandom << 5;
+    return gRandom;
+}
+
+static uint8_t * copy_bytes(const uint8_t * data, uint32_t length) {
+    uint8_t * copy = malloc((length > 0) ? length : 1);
+
+    if (copy != NULL) {
+        memcpy(copy, data, length);
+    }
+    return copy;
+}
+
+static void name_from_path(const char * path, char * name) {
+    const char * base   = strrchr(path, '/');
+    const char * dot    = NULL;
+    size_t       length = 0;
+
+    base   = (base != NULL) ? base + 1 : path;
+    dot    = strrchr(base, '.');
+    length = (dot != NULL) ? (size_t)(dot - base) : strlen(base);
+    length = (length > CLAVIA_NAME_SIZE) ? CLAVIA_NAME_SIZE : length;
+    memset(name, 0, CLAVIA_NAME_SIZE + 1);
+    memcpy(name, base, length);
+}
+
+// ── MESSAGES TO THE HOST ───────────────────────────────────────────────────────────────────────────
+
+static void queue_clear(tEmuQueue * queue) {
+    for (uint32_t m = 0; m < queue->count; m++) {
+        free(queue->message[(queue->head + m) % EMU_MAX_QUEUED].data);
+    }
+    queue->head      = 0;
+    queue->count     = 0;
+    queue->lastReady = 0;
+}
+
+static void queue_push(tEmuQueue * queue, uint8_t * data, uint32_t length, uint64_t ready) {
+    tEmuMessage * message = &queue->message[(queue->head + queue->count) % EMU_MAX_QUEUED];
+
+    message->data    = data;
+    message->length  = length;
+    message->ready   = ready;
+    queue->lastReady = ready;
+    queue->count++;
+}
+
+// content is a whole reply less its CRC — [type][command][version][sub-command] onwards — framed as
+// the G2 frames it and queued, ready at `ready` or after whatever is queued ahead of it, whichever is
+// later. Or dropped, lossPerMille of the time.
+static void send_to_host(const uint8_t * content, uint32_t length, uint64_t ready, bool stream) {
+    uint32_t bitPos = 0;
+
+    if ((gConfig.lossPerMille > 0) && ((next_random() % 1000U) < gConfig.lossPerMille)) {
+        gStats.lost++;
+        return;
+    }
+
+    if ((length + CRC_BYTES) > EXTENDED_MESSAGE_SIZE) {
+        return;
+    }
+    ready = (ready > gInterruptQueue.lastReady) ? ready : gInterruptQueue.lastReady;
+
+    if (length <= EMU_EMBEDDED_MAX) {
+        uint8_t interrupt[INTERRUPT_MESSAGE_SIZE] = {0};
+
+        if (gInterruptQueue.count >= EMU_MAX_QUEUED) {
+            gStats.lost++;
+            return;
+        }
+        write_bit_stream(interrupt, &bitPos, 4, length + CRC_BYTES);
+        write_bit_stream(interrupt, &bitPos, 4, RESPONSE_TYPE_EMBEDDED);
+        memcpy(&interrupt[1], content, length);
+        bitPos = BYTE_TO_BIT(1 + length);
+        write_bit_stream(interrupt, &bitPos, 16, calc_crc16(content, length));
+        queue_push(&gInterruptQueue, copy_bytes(interrupt, sizeof(interrupt)), sizeof(interrupt), ready);
+    } else {
+        uint8_t   header[INTERRUPT_MESSAGE_SIZE] = {0};
+        uint8_t * message                        = malloc(length + CRC_BYTES);
+
+        if ((message == NULL) || (gInterruptQueue.count >= EMU_MAX_QUEUED) || (gExtendedQueue.count >= EMU_MAX_QUEUED)) {
+            free(message);
+            gStats.lost++;
+            return;
+        }
+        // The header and its message go up together: the editor reads one and then the other.
+        ready = (ready > gExtendedQueue.lastReady) ? ready : gExtendedQueue.lastReady;
+        write_bit_stream(header, &bitPos, 4, 0);
+        write_bit_stream(header, &bitPos, 4, RESPONSE_TYPE_EXTENDED);
+        write_bit_stream(header, &bitPos, 16, length + CRC_BYTES);
+        memcpy(message, content, length);
+        bitPos = BYTE_TO_BIT(length);
+        write_bit_stream(message, &bitPos, 16, calc_crc16(content, length));
+        queue_push(&gInterruptQueue, copy_bytes(header, sizeof(header)), sizeof(header), ready);
+        queue_push(&gExtendedQueue, message, length + CRC_BYTES, ready);
+    }
+    gStats.replies++;
+    gStats.streamed += stream ? 1U : 0U;
+}
+
+static void reply_begin(uint32_t * bitPos, bool isSlot, uint32_t slot, uint8_t subCommand) {
+    *bitPos = 0;
+    write_bit_stream(gReply, bitPos, 8, RESPONSE_TYPE_COMMAND);
+    write_bit_stream(gReply, bitPos, 8, isSlot ? (COMMAND_SLOT | slot) : COMMAND_SYS);
+    write_bit_stream(gReply, bitPos, 8, isSlot ? gSlots[slot].version : gPerfVersion);
+    write_bit_stream(gReply, bitPos, 8, subCommand);
+}
+
+static void reply_bytes(uint32_t * bitPos, const uint8_t * data, uint32_t length) {
+    memcpy(&gReply[BIT_TO_BYTE(*bitPos)], data, length);
+    *bitPos += BYTE_TO_BIT(length);
+}
+
+static void reply_zeros(uint32_t * bitPos, uint32_t length) {
+    memset(&gReply[BIT_TO_BYTE(*bitPos)], 0, length);
+    *bitPos += BYTE_TO_BIT(length);
+}
+
+static void reply_send(uint32_t bitPos, uint64_t ready) {
+    send_to_host(gReply, BIT_TO_BYTE_ROUND_UP(bitPos), ready, false);
+}
+
+static void reply_simple(bool isSlot, uint32_t slot, uint8_t subCommand, uint64_t ready) {
+    uint32_t bitPos = 0;
+
+    reply_begin(&bitPos, isSlot, slot, subCommand);
+    reply_send(bitPos, ready);
+}
+
+// One section of a slot image, whole — [type][length16][payload] — or NULL if it has none.
+static const uint8_t * find_section(const tEmuSlot * slot, uint8_t type, uint32_t * length) {
+    uint32_t pos = 0;
+
+    while ((slot->image != NULL) && ((pos + 3) <= slot->imageLength)) {
+        uint32_t sectionLength = ((uint32_t)slot->image[pos + 1] << 8) | slot->image[pos + 2];
+
+        if ((pos + 3 + sectionLength) > slot->imageLength) {
+            break;
+        }
+
+        if (slot->image[pos] == type) {
+            *length = 3 + sectionLength;
+            return &slot->image[pos];
+        }
+        pos += 3 + sectionLength;
+    }
+    *length = 0;
+    return NULL;
+}
+
+// A slot's LED and meter messages, as the G2 streams them. The values only have to move: where each
+// lands is tools/ledbench.c's business.
+static void stream_slot(uint32_t slot, uint64_t now) {
+    uint32_t bitPos = 0;
+
+    reply_begin(&bitPos, true, slot, SUB_RESPONSE_LED_DATA);
+    write_bit_stream(gReply, &bitPos, 8, 0);
+
+    for (uint32_t b = 0; b < (LED_STREAM_SIZE / 4); b++) {
+        write_bit_stream(gReply, &bitPos, 8, ((b + gStreamTick) * 0x5bU) & 0xff);
+    }
+    send_to_host(gReply, BIT_TO_BYTE(bitPos), now, true);
+
+    reply_begin(&bitPos, true, slot, SUB_RESPONSE_VOLUME_INDICATOR);
+    write_bit_stream(gReply, &bitPos, 8, 0);
+
+    for (uint32_t m = 0; m < EMU_METERS; m++) {
+        write_bit_stream(gReply, &bitPos, 16, ((m + gStreamTick) * 29U) & 0x7f);
+    }
+    send_to_host(gReply, BIT_TO_BYTE(bitPos), now, true);
+    gStreamTick++;
+}
+
+// ── ANSWERING ──────────────────────────────────────────────────────────────────────────────────────
+
+static bool bank_in_range(uint8_t domain, uint32_t bank, uint32_t location) {
+    uint32_t banks = (domain == BANK_UPLOAD_DOMAIN_PATCH) ? NUM_PATCH_BANKS : NUM_PERF_BANKS;
+
+    return (domain < EMU_DOMAINS) && (bank < banks) && (location < NUM_LOCATIONS_PER_BANK);
+}
+
+static void entry_clear(tEmuEntry * entry) {
+    free(entry->content);
+    free(entry->image);
+    memset(entry, 0, sizeof(*entry));
+}
+
+// SUB_RESPONSE_LIST_NAMES from (bank, location) on: the populated locations in order, each a name and
+// a category, with a 0x03 [bank][location] marker wherever the next one is not the one after the last.
+// Up to EMU_LIST_NAMES_BYTES of them; the editor resumes where the reply ended. Past the last, the
+// short "domain exhausted" form. See parse_list_names_response().
+static void answer_list_names(uint8_t domain, uint32_t bank, uint32_t location, uint64_t ready) {
+    uint32_t banks  = (domain == BANK_UPLOAD_DOMAIN_PATCH) ? NUM_PATCH_BANKS : NUM_PERF_BANKS;
+    uint32_t bitPos = 0;
+    uint32_t start  = 0;
+    uint32_t nextB  = 0;
+    uint32_t nextL  = 0;
+    bool     first  = true;
+
+    reply_begin(&bitPos, false, 0, SUB_RESPONSE_LIST_NAMES);
+    reply_zeros(&bitPos, 4);
+    write_bit_stream(gReply, &bitPos, 8, domain);
+    start = BIT_TO_BYTE(bitPos);
+
+    for (uint32_t b = bank + (location / NUM_LOCATIONS_PER_BANK), l = location % NUM_LOCATIONS_PER_BANK;
+         (domain < EMU_DOMAINS) && (b < banks) && ((BIT_TO_BYTE(bitPos) - start) < EMU_LIST_NAMES_BYTES); ) {
+        const tEmuEntry * entry = &gBanks[domain][b][l];
+
+        if (entry->populated) {
+            if (first || (b != nextB) || (l != nextL)) {
+                write_bit_stream(gReply, &bitPos, 8, 0x03);
+                write_bit_stream(gReply, &bitPos, 8, b);
+                write_bit_stream(gReply, &bitPos, 8, l);
+            }
+            write_clavia_string(gReply, &bitPos, entry->name);
+            write_bit_stream(gReply, &bitPos, 8, entry->category);
+            first = false;
+            nextB = b;
+            nextL = l + 1;
+        }
+
+        if (++l >= NUM_LOCATIONS_PER_BANK) {
+            l = 0;
+            b++;
+        }
+    }
+
+    if (first) {
+        write_bit_stream(gReply, &bitPos, 8, 0x04);
+    }
+    reply_send(bitPos, ready);
+}
+
+// SUB_COMMAND_PATCH_BANK_DATA with the location's body, or SUB_RESPONSE_PATCH_BANK_UPLOAD if it is
+// empty. See parse_bank_upload_data().
+static void answer_bank_upload(uint8_t domain, uint32_t bank, uint32_t location, uint64_t ready) {
+    const tEmuEntry * entry  = bank_in_range(domain, bank, location) ? &gBanks[domain][bank][location] : NULL;
+    uint32_t          bitPos = 0;
+
+    if ((entry == NULL) || (entry->populated == false) || (entry->contentLength < 2)
+        || ((entry->contentLength + 64) > EXTENDED_MESSAGE_SIZE)) {
+        reply_simple(false, 0, SUB_RESPONSE_PATCH_BANK_UPLOAD, ready);
+        return;
+    }
+    reply_begin(&bitPos, false, 0, SUB_COMMAND_PATCH_BANK_DATA);
+    write_bit_stream(gReply, &bitPos, 8, domain);
+    write_bit_stream(gReply, &bitPos, 8, 0);
+    write_bit_stream(gReply, &bitPos, 8, location);
+    write_clavia_string(gReply, &bitPos, entry->name);
+    write_bit_stream(gReply, &bitPos, 16, entry->contentLength + 1);
+    write_bit_stream(gReply, &bitPos, 8, entry->content[0]);
+    write_bit_stream(gReply, &bitPos, 8, entry->content[1]);
+    reply_bytes(&bitPos, entry->content, entry->contentLength);
+    reply_send(bitPos, ready);
+}
+
+// A restore's push: [domain][bank][location][name][length16][2 marker bytes][body]. Stored; acked
+// with SUB_RESPONSE_PATCH_BANK_UPLOAD.
+static bool take_bank_push(const uint8_t * payload, uint32_t length) {
+    uint32_t    bitPos                        = 0;
+    char        name[CLAVIA_NAME_SIZE + 1]    = {0};
+    uint8_t     domain                        = 0;
+    uint8_t     bank                          = 0;
+    uint8_t     location                      = 0;
+    uint32_t    contentLength                 = 0;
+    tEmuEntry * entry                         = NULL;
+
+    if (length < 8) {
+        return false;
+    }
+    domain        = (uint8_t)read_bit_stream((uint8_t *)payload, &bitPos, 8);
+    bank          = (uint8_t)read_bit_stream((uint8_t *)payload, &bitPos, 8);
+    location      = (uint8_t)read_bit_stream((uint8_t *)payload, &bitPos, 8);
+    read_clavia_string((uint8_t *)payload, &bitPos, name, sizeof(name));
+    contentLength = read_bit_stream((uint8_t *)payload, &bitPos, 16);
+    bitPos       += 16;    // the [version][type] marker, repeated at the start of the body
+
+    if ((contentLength < 1) || (bank_in_range(domain, bank, location) == false)
+        || ((BIT_TO_BYTE(bitPos) + contentLength - 1) > length)) {
+        return false;
+    }
+    contentLength--;
+    entry                = &gBanks[domain][bank][location];
+    entry_clear(entry);
+    entry->populated     = true;
+    entry->content       = copy_bytes(&payload[BIT_TO_BYTE(bitPos)], contentLength);
+    entry->contentLength = contentLength;
+    entry->category      = peek_patch_category(entry->content, contentLength);
+    memcpy(entry->name, name, sizeof(entry->name));
+    return entry->content != NULL;
+}
+
+// SUB_COMMAND_SET_PATCH: [3 zero bytes][name][the image]. The slot's image is replaced and its version
+// moves on; the editor is told the new one.
+static bool take_slot_push(uint32_t slot, const uint8_t * payload, uint32_t length, uint64_t ready) {
+    uint32_t   bitPos = BYTE_TO_BIT(3);
+    uint32_t   start  = 0;
+    tEmuSlot * target = &gSlots[slot];
+
+    if (length < 4) {
+        return false;
+    }
+    read_clavia_string((uint8_t *)payload, &bitPos, target->name, sizeof(target->name));
+    start               = BIT_TO_BYTE(bitPos);
+    free(target->image);
+    target->image       = copy_bytes(&payload[start], (length > start) ? length - start : 0);
+    target->imageLength = (length > start) ? length - start : 0;
+    target->version++;
+
+    reply_begin(&bitPos, false, 0, SUB_RESPONSE_PATCH_VERSION);
+    write_bit_stream(gReply, &bitPos, 8, slot);
+    write_bit_stream(gReply, &bitPos, 8, target->version);
+    reply_send(bitPos, ready);
+    return true;
+}
+
+// A retrieve into a slot: the location's image, if it has one, and the slot's version moves on —
+// SUB_RESPONSE_PATCH_VERSION_CHANGE, which sends the editor to pull the slot again. Into the
+// performance (slot MAX_SLOTS): every version moves on, SUB_RESPONSE_PERF_PATCH_VERSIONS.
+static void answer_perf_versions(uint64_t ready) {
+    uint32_t bitPos = 0;
+
+    reply_begin(&bitPos, false, 0, SUB_RESPONSE_PERF_PATCH_VERSIONS);
+    write_bit_stream(gReply, &bitPos, 8, gPerfVersion);
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        write_bit_stream(gReply, &bitPos, 8, SUB_RESPONSE_PATCH_VERSION);
+        write_bit_stream(gReply, &bitPos, 8, s);
+        write_bit_stream(gReply, &bitPos, 8, gSlots[s].version);
+    }
+    reply_send(bitPos, ready);
+}
+
+static bool answer_retrieve(uint8_t target, uint8_t bank, uint8_t location, uint64_t ready) {
+    uint8_t           domain = (target == MAX_SLOTS) ? BANK_UPLOAD_DOMAIN_PERFORMANCE : BANK_UPLOAD_DOMAIN_PATCH;
+    const tEmuEntry * entry  = NULL;
+    uint32_t          bitPos = 0;
+
+    if ((target > MAX_SLOTS) || (bank_in_range(domain, bank, location) == false)) {
+        return false;
+    }
+    entry = &gBanks[domain][bank][location];
+
+    if (entry->populated == false) {
+        return false;
+    }
+
+    if (target == MAX_SLOTS) {
+        gPerfVersion++;
+
+        for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+            gSlots[s].version++;
+        }
+        answer_perf_versions(ready);
+        return true;
+    }
+    tEmuSlot * slot = &gSlots[target];
+
+    if (entry->image != NULL) {
+        free(slot->image);
+        slot->image       = copy_bytes(entry->image, entry->imageLength);
+        slot->imageLength = entry->imageLength;
+        memcpy(slot->name, entry->name, sizeof(slot->name));
+    }
+    slot->version++;
+
+    reply_begin(&bitPos, false, 0, SUB_RESPONSE_PATCH_VERSION_CHANGE);
+    write_bit_stream(gReply, &bitPos, 8, target);
+    write_bit_stream(gReply, &bitPos, 8, slot->version);
+    reply_send(bitPos, ready);
+    return true;
+}
+
+static void answer_performance_settings(uint64_t ready) {
+    uint32_t bitPos = 0;
+
+    reply_begin(&bitPos, false, 0, SUB_RESPONSE_PERFORMANCE_SETTINGS);
+    write_clavia_string(gReply, &bitPos, EMU_PERF_NAME);
+    reply_zeros(&bitPos, 6);
+    write_bit_stream(gReply, &bitPos, 8, 120);    // master clock
+    reply_zeros(&bitPos, 4);
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        write_clavia_string(gReply, &bitPos, gSlots[s].name);
+        write_bit_stream(gReply, &bitPos, 8, 1);      // enabled
+        write_bit_stream(gReply, &bitPos, 8, 1);      // keyboard
+        write_bit_stream(gReply, &bitPos, 8, 0);      // hold
+        reply_zeros(&bitPos, 2);                      // bank, patch
+        write_bit_stream(gReply, &bitPos, 8, 0);      // range
+        write_bit_stream(gReply, &bitPos, 8, 127);
+        reply_zeros(&bitPos, 3);
+    }
+    reply_send(bitPos, ready);
+}
+
+// A section of the slot's image as its own reply — the sub-command is the section's type, so the
+// section goes in whole, in place of it. An image without one answers with an empty section.
+static void answer_section(uint32_t slot, uint8_t type, bool withLength, uint64_t ready) {
+    const uint8_t * section = NULL;
+    uint32_t        length  = 0;
+    uint32_t        bitPos  = 0;
+
+    reply_begin(&bitPos, true, slot, type);
+    section = find_section(&gSlots[slot], type, &length);
+
+    if (section == NULL) {
+        reply_zeros(&bitPos, 2);
+    } else if (withLength) {
+        reply_bytes(&bitPos, &section[1], length - 1);
+    } else {
+        reply_bytes(&bitPos, &section[3], length - 3);
+    }
+    reply_send(bitPos, ready);
+}
+
+// One request on endpoint 3, its framing already checked: content is [0x01][command][version][sub]
+// and the payload, or the lone init byte. Answers it, or does not, as the G2 would.
+static void answer(const uint8_t * content, uint32_t length, uint64_t ready) {
+    uint8_t         command = 0;
+    uint8_t         sub     = 0;
+    uint32_t        slot    = 0;
+    bool            isSlot  = false;
+    const uint8_t * payload = NULL;
+    uint32_t        count   = 0;
+    uint32_t        bitPos  = 0;
+
+    if ((length == 1) && (content[0] == RESPONSE_TYPE_INIT)) {
+        gReply[0] = RESPONSE_TYPE_INIT;
+        send_to_host(gReply, 1, ready, false);
+        return;
+    }
+    command = content[1];
+    sub     = content[3];
+    slot    = command & 0x03;
+    isSlot  = (command & 0x0f) != COMMAND_SYS;
+    payload = &content[4];
+    count   = length - 4;
+
+    // Writes without a reply asked for — parameter values, morph ranges — and the keyboard.
+    if (((command & 0xf0) == COMMAND_WRITE_NO_RESP) || (sub == SUB_COMMAND_PLAY_NOTE)) {
+        return;
+    }
+
+#define EMU_PAYLOAD(n)    (((n) < count) ? payload[(n)] : 0U)
+
+    switch (sub) {
+        case SUB_COMMAND_START_STOP:
+        {
+            gStopped = (EMU_PAYLOAD(0) == 1);
+            reply_simple(isSlot, slot, SUB_RESPONSE_OK, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_SYNTH_SETTINGS:
+        {
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_SYNTH_SETTINGS);
+            write_clavia_string(gReply, &bitPos, EMU_SYNTH_NAME);
+            reply_zeros(&bitPos, 24);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_MIDI_CC:
+        {
+            // One record per slot, [first][controller], 0xff for none, separated by the sub-command.
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_MIDI_CC);
+
+            for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+                if (s > 0) {
+                    write_bit_stream(gReply, &bitPos, 8, SUB_RESPONSE_MIDI_CC);
+                }
+                write_bit_stream(gReply, &bitPos, 8, 0);
+                write_bit_stream(gReply, &bitPos, 8, 0xff);
+            }
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_SLOT_SELECTION:
+        {
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_SLOT_SELECTION);
+            write_bit_stream(gReply, &bitPos, 4, 0);
+            write_bit_stream(gReply, &bitPos, 4, 0x0f);    // all four enabled
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_ASSIGNED_VOICES:
+        {
+            if (count > 0) {
+                reply_simple(isSlot, slot, SUB_RESPONSE_OK, ready);    // the set, which shares its code
+                break;
+            }
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_ASSIGNED_VOICES);
+
+            for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+                write_bit_stream(gReply, &bitPos, 8, 1);
+            }
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_QUERY_MASTER_CLOCK:
+        {
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_EXT_MASTER_CLOCK);
+            write_bit_stream(gReply, &bitPos, 8, 0xff);
+            write_bit_stream(gReply, &bitPos, 8, 1);
+            write_bit_stream(gReply, &bitPos, 8, 120);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_GLOBAL_PAGE:
+        {
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_GLOBAL_PAGE);
+            write_bit_stream(gReply, &bitPos, 8, 0);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_PERFORMANCE_SETTINGS:
+        {
+            if (isSlot == false) {
+                answer_performance_settings(ready);
+            } else {
+                reply_simple(isSlot, slot, SUB_RESPONSE_OK, ready);
+            }
+            break;
+        }
+        case SUB_COMMAND_GET_PATCH_VERSION:
+        {
+            uint32_t which = EMU_PAYLOAD(0);
+
+            if (which > MAX_SLOTS) {
+                gStats.refused++;
+                reply_simple(false, 0, SUB_RESPONSE_ERROR, ready);
+                break;
+            }
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_PATCH_VERSION);
+            write_bit_stream(gReply, &bitPos, 8, which);
+            write_bit_stream(gReply, &bitPos, 8, (which == MAX_SLOTS) ? gPerfVersion : gSlots[which].version);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_PATCH_SLOT:
+        {
+            // The dump: the image follows the header, its first section's type standing in for the
+            // sub-command. An empty slot is one empty patch description.
+            reply_begin(&bitPos, true, slot, 0);
+            bitPos -= 8;
+
+            if (gSlots[slot].image != NULL) {
+                reply_bytes(&bitPos, gSlots[slot].image, gSlots[slot].imageLength);
+            } else {
+                write_bit_stream(gReply, &bitPos, 8, SUB_RESPONSE_PATCH_DESCRIPTION);
+                write_bit_stream(gReply, &bitPos, 16, 0);
+            }
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_PATCH_NAME:
+        {
+            reply_begin(&bitPos, true, slot, SUB_RESPONSE_GET_PATCH_NAME);
+            write_clavia_string(gReply, &bitPos, gSlots[slot].name);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_CURRENT_NOTE:
+        {
+            answer_section(slot, SUB_RESPONSE_CURRENT_NOTE_2, true, ready);
+            break;
+        }
+        case SUB_COMMAND_QUERY_PATCH_TEXT:
+        {
+            answer_section(slot, SUB_RESPONSE_PATCH_NOTES, true, ready);
+            break;
+        }
+        case SUB_COMMAND_KNOB_SNAPSHOT:
+        {
+            // The knobs go first, unasked for as far as the editor's reader is concerned, then the OK
+            // it waits on. parse_knobs() wants the count straight after the sub-command: the section
+            // less its length.
+            answer_section(slot, SUB_RESPONSE_KNOBS, false, ready);
+            reply_simple(isSlot, slot, SUB_RESPONSE_OK, ready);
+            break;
+        }
+        case SUB_COMMAND_QUERY_RESOURCES:
+        {
+            reply_begin(&bitPos, true, slot, SUB_RESPONSE_RESOURCES_USED);
+            write_bit_stream(gReply, &bitPos, 8, EMU_PAYLOAD(0));
+            reply_zeros(&bitPos, 27);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_GET_SELECTED_PARAM:
+        {
+            reply_begin(&bitPos, true, slot, SUB_RESPONSE_SELECT_PARAM);
+            write_bit_stream(gReply, &bitPos, 8, 0);
+            write_bit_stream(gReply, &bitPos, 8, locationVa);
+            write_bit_stream(gReply, &bitPos, 8, 0);
+            write_bit_stream(gReply, &bitPos, 8, 0);
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_QUERY_GLOBAL_KNOBS:
+        {
+            reply_begin(&bitPos, false, 0, SUB_RESPONSE_GLOBAL_KNOBS);
+            write_bit_stream(gReply, &bitPos, 16, 2 + (EMU_KNOBS / 8));
+            write_bit_stream(gReply, &bitPos, 16, EMU_KNOBS);
+            reply_zeros(&bitPos, EMU_KNOBS / 8);    // one "not assigned" bit each
+            reply_send(bitPos, ready);
+            break;
+        }
+        case SUB_COMMAND_SET_PARAM_MODE:
+        {
+            answer_perf_versions(ready);
+            break;
+        }
+        case SUB_COMMAND_SET_PATCH:
+        {
+            if ((isSlot == false) || (take_slot_push(slot, payload, count, ready) == false)) {
+                gStats.refused++;
+                reply_simple(false, 0, SUB_RESPONSE_ERROR, ready);
+            }
+            break;
+        }
+        case SUB_COMMAND_LIST_NAMES:
+        {
+            answer_list_names(EMU_PAYLOAD(0), EMU_PAYLOAD(1), EMU_PAYLOAD(2), ready);
+            break;
+        }
+        case SUB_COMMAND_PATCH_BANK_UPLOAD:
+        {
+            answer_bank_upload(EMU_PAYLOAD(0), EMU_PAYLOAD(1), EMU_PAYLOAD(2), ready);
+            break;
+        }
+        case SUB_COMMAND_PATCH_BANK_DATA:
+        {
+            if (take_bank_push(payload, count) == false) {
+                gStats.refused++;
+                reply_simple(false, 0, SUB_RESPONSE_ERROR, ready);
+                break;
+            }
+            reply_simple(false, 0, SUB_RESPONSE_PATCH_BANK_UPLOAD, ready);
+            break;
+        }
+        case SUB_COMMAND_CLEAR:
+        {
+            if (bank_in_range(EMU_PAYLOAD(0), EMU_PAYLOAD(1), EMU_PAYLOAD(2))) {
+                entry_clear(&gBanks[EMU_PAYLOAD(0)][EMU_PAYLOAD(1)][EMU_PAYLOAD(2)]);
+            }
+            reply_simple(false, 0, SUB_RESPONSE_CLEAR, ready);
+            break;
+        }
+        case SUB_COMMAND_RETRIEVE:
+        {
+            if ((isSlot == true) || (answer_retrieve(EMU_PAYLOAD(0), EMU_PAYLOAD(1), EMU_PAYLOAD(2), ready) == false)) {
+                gStats.refused++;
+                reply_simple(false, 0, SUB_RESPONSE_ERROR, ready);
+            }
+            break;
+        }
+        case SUB_COMMAND_STORE:
+        {
+            gStats.refused++;
+            reply_simple(false, 0, SUB_RESPONSE_ERROR, ready);
+            break;
+        }
+        default:
+        {
+            // Every other request is an edit the G2 acknowledges: modules, cables, names, knobs,
+            // variations, settings.
+            reply_simple(isSlot, slot, SUB_RESPONSE_OK, ready);
+            break;
+        }
+    }
+#undef EMU_PAYLOAD
+}
+
+// A send on endpoint 3: [length16][content][crc16]. True if it was a command, for the observer.
+static bool take_request(const tUsbTransfer * transfer, uint64_t now) {
+    const uint8_t * content = &transfer->buffer[COMMAND_OFFSET];
+    uint32_t        length  = 0;
+    uint64_t        ready   = now + ((uint64_t)gConfig.latencyUs * 1000ULL);
+
+    if (transfer->length < (COMMAND_OFFSET + 1 + CRC_BYTES)) {
+        gStats.badRequests++;
+        return false;
+    }
+    length = (uint32_t)transfer->length - COMMAND_OFFSET - CRC_BYTES;
+
+    if (calc_crc16(content, length) != (((uint32_t)content[length] << 8) | content[length + 1])) {
+        gStats.badRequests++;
+        return false;
+    }
+
+    if ((length != 1) && ((length < 4) || (content[0] != RESPONSE_TYPE_COMMAND))) {
+        gStats.badRequests++;
+        return false;
+    }
+
+    if (gConfig.jitterUs > 0) {
+        ready += (uint64_t)(next_random() % (gConfig.jitterUs + 1U)) * 1000ULL;
+    }
+    gStats.requests++;
+    answer(content, length, ready);
+    return length >= 4;
+}
+
+// ── THE BACKEND ────────────────────────────────────────────────────────────────────────────────────
+
+static bool emu_alloc(void * ctx, tUsbTransfer * transfer) {
+    transfer->handle = transfer;    // nothing of its own to hold, but the transport checks it is set
+    return true;
+}
+
+static void emu_release(void * ctx, tUsbTransfer * transfer) {
+    transfer->handle = NULL;
+}
+
+static int emu_submit(void * ctx, tUsbTransfer * transfer) {
+    int result = LIBUSB_SUCCESS;
+
+    pthread_mutex_lock(&gLock);
+
+    if (gPlugged == false) {
+        result = LIBUSB_ERROR_NO_DEVICE;
+    } else if (gPendingCount >= EMU_MAX_PENDING) {
+        result = LIBUSB_ERROR_BUSY;
+    } else {
+        gPending[gPendingCount].transfer  = transfer;
+        gPending[gPendingCount].cancelled = false;
+        gPendingCount++;
+        pthread_cond_signal(&gWork);
+    }
+    pthread_mutex_unlock(&gLock);
+    return result;
+}
+
+static void emu_cancel(void * ctx, tUsbTransfer * transfer) {
+    pthread_mutex_lock(&gLock);
+
+    for (uint32_t p = 0; p < gPendingCount; p++) {
+        if (gPending[p].transfer == transfer) {
+            gPending[p].cancelled = true;
+        }
+    }
+    pthread_cond_signal(&gWork);
+    pthread_mutex_unlock(&gLock);
+}
+
+static void remove_pending(uint32_t p) {
+    memmove(&gPending[p], &gPending[p + 1], sizeof(gPending[0]) * (gPendingCount - p - 1));
+    gPendingCount--;
+}
+
+// The oldest message on the queue into a read, if it is due.
+static bool deliver(tEmuQueue * queue, tUsbTransfer * transfer, uint64_t now, tEmuCompletion * done, uint64_t * next) {
+    tEmuMessage * message = &queue->message[queue->head];
+    int           actual  = 0;
+
+    if (queue->count == 0) {
+        return false;
+    }
+
+    if (message->ready > now) {
+        *next = (message->ready < *next) ? message->ready : *next;
+        return false;
+    }
+    actual      = ((int)message->length < transfer->length) ? (int)message->length : transfer->length;
+    memcpy(transfer->buffer, message->data, (size_t)actual);
+    free(message->data);
+    queue->head = (queue->head + 1) % EMU_MAX_QUEUED;
+    queue->count--;
+    *done       = (tEmuCompletion){transfer, LIBUSB_SUCCESS, actual};
+    return true;
+}
+
+// Everything that can complete now, then the observer and the callbacks with the lock dropped — as
+// libusb does. Otherwise waits for a submission, the next due message or stream tick, or the timeout.
+static void emu_handle_events(void * ctx, uint32_t timeoutMs) {
+    static uint8_t   observed[EMU_MAX_PENDING][EXTENDED_MESSAGE_SIZE / EMU_MAX_PENDING];
+    tEmuCompletion   done[EMU_MAX_PENDING];
+    uint32_t         observedLength[EMU_MAX_PENDING];
+    uint32_t         doneCount     = 0;
+    uint32_t         observedCount = 0;
+    uint64_t         giveUp        = now_nanos() + ((uint64_t)timeoutMs * 1000000ULL);
+
+    pthread_mutex_lock(&gLock);
+
+    while (true) {
+        uint64_t now  = now_nanos();
+        uint64_t next = giveUp;
+
+        if ((gPlugged == false) || (gOpen == false)) {
+            // Pulled out, or not opened: nothing goes anywhere.
+            for (uint32_t p = 0; p < gPendingCount; p++) {
+                done[doneCount++] = (tEmuCompletion){gPending[p].transfer, LIBUSB_ERROR_NO_DEVICE, 0};
+            }
+            gPendingCount = 0;
+        }
+
+        if ((gConfig.streamMs > 0) && (gStopped == false) && gPlugged && gOpen) {
+            if (now >= gNextStream) {
+                if (gInterruptQueue.count < EMU_STREAM_BACKLOG) {
+                    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+                        uint32_t slot = (gStreamSlot + s) % MAX_SLOTS;
+
+                        if (gSlots[slot].image != NULL) {
+                            stream_slot(slot, now);
+                            gStreamSlot = (slot + 1) % MAX_SLOTS;
+                            break;
+                        }
+                    }
+                }
+                gNextStream = now + ((uint64_t)gConfig.streamMs * 1000000ULL);
+            }
+            next = (gNextStream < next) ? gNextStream : next;
+        }
+
+        for (uint32_t p = 0; p < gPendingCount;) {
+            tEmuPending *  pending  = &gPending[p];
+            tUsbTransfer * transfer = pending->transfer;
+
+            if (pending->cancelled) {
+                done[doneCount++] = (tEmuCompletion){transfer, LIBUSB_ERROR_TIMEOUT, 0};
+                remove_pending(p);
+                continue;
+            }
+
+            if ((transfer->endpoint & 0x80) == 0) {
+                // A request lands as it is sent; its reply is queued to be ready after the latency.
+                if (take_request(transfer, now) && (observedCount < EMU_MAX_PENDING)) {
+                    uint32_t length = (uint32_t)transfer->length - COMMAND_OFFSET - CRC_BYTES;
+
+                    length                          = (length < sizeof(observed[0])) ? length : sizeof(observed[0]);
+                    memcpy(observed[observedCount], &transfer->buffer[COMMAND_OFFSET], length);
+                    observedLength[observedCount++] = length;
+                }
+                done[doneCount++] = (tEmuCompletion){transfer, LIBUSB_SUCCESS, transfer->length};
+                remove_pending(p);
+                continue;
+            }
+            tEmuQueue * queue = (transfer->endpoint == 0x81) ? &gInterruptQueue : &gExtendedQueue;
+
+            if (deliver(queue, transfer, now, &done[doneCount], &next)) {
+                doneCount++;
+                remove_pending(p);
+                continue;
+            }
+            p++;
+        }
+
+        if ((doneCount > 0) || (now >= giveUp) || gInterrupted) {
+            gInterrupted = false;
+            break;
+        }
+        struct timespec until;
+
+        // pthread_cond_timedwait() measures CLOCK_REALTIME; convert the monotonic deadline to it.
+        clock_gettime(CLOCK_REALTIME, &until);
+        uint64_t        wait  = next - now;
+
+        until.tv_sec  += (time_t)(wait / 1000000000ULL);
+        until.tv_nsec += (long)(wait % 1000000000ULL);
+
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        (void)pthread_cond_timedwait(&gWork, &gLock, &until);
+    }
+    tG2EmulatorObserver observer = gObserver;
+
+    pthread_mutex_unlock(&gLock);
+
+    // Before the completions: a send's buffer is the transport's again once it has completed.
+    for (uint32_t o = 0; (observer != NULL) && (o < observedCount); o++) {
+        observer(observed[o][1] & 0x03, observed[o][3], &observed[o][4], observedLength[o] - 4);
+    }
+
+    for (uint32_t d = 0; d < doneCount; d++) {
+        usb_transport_completed(done[d].transfer, done[d].result, done[d].actual);
+    }
+}
+
+static void emu_interrupt(void * ctx) {
+    pthread_mutex_lock(&gLock);
+    gInterrupted = true;
+    pthread_cond_signal(&gWork);
+    pthread_mutex_unlock(&gLock);
+}
+
+static const tUsbBackend kEmulatorBackend = {
+    emu_alloc,
+    emu_release,
+    emu_submit,
+    emu_cancel,
+    emu_handle_events,
+    emu_interrupt,
+};
+
+// Opening finds a G2 with nothing on its way up — whatever was queued for the last connection went
+// with it — in the state it was left in.
+static bool emu_open(void * ctx) {
+    bool opened = false;
+
+    pthread_mutex_lock(&gLock);
+
+    if (gPlugged) {
+        queue_clear(&gInterruptQueue);
+        queue_clear(&gExtendedQueue);
+        gOpen       = true;
+        gNextStream = now_nanos();
+        gStats.opens++;
+        opened      = true;
+    }
+    pthread_mutex_unlock(&gLock);
+    return opened;
+}
+
+static void emu_close(void * ctx) {
+    pthread_mutex_lock(&gLock);
+    gOpen = false;
+    queue_clear(&gInterruptQueue);
+    queue_clear(&gExtendedQueue);
+    pthread_mutex_unlock(&gLock);
+}
+
+static const tUsbStandIn kStandIn = {
+    &kEmulatorBackend,
+    NULL,
+    emu_open,
+    emu_close,
+};
+
+// ── SEEDING ────────────────────────────────────────────────────────────────────────────────────────
+
+// The patch in the editor's database slot, as a dump carries it: the sections push_slot_to_device()
+// sends, in its order.
+static uint8_t * image_of(uint32_t slot, uint32_t * length) {
+    static uint8_t buff[EXTENDED_MESSAGE_SIZE];
+    uint32_t       bitPos = 0;
+
+    memset(buff, 0, sizeof(buff));
+    write_patch_descr(slot, buff, &bitPos);
+    write_module_list(slot, locationVa, buff, &bitPos);
+    write_module_list(slot, locationFx, buff, &bitPos);
+    write_current_note_2(slot, buff, &bitPos);
+    write_cable_list(slot, locationVa, buff, &bitPos);
+    write_cable_list(slot, locationFx, buff, &bitPos);
+    write_param_list(slot, locationMorph, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationVa, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationFx, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_morph_params(slot, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_knobs(slot, buff, &bitPos);
+    write_controllers(slot, buff, &bitPos);
+    write_param_names(slot, locationVa, buff, &bitPos);
+    write_param_names(slot, locationFx, buff, &bitPos);
+    write_module_names(slot, locationVa, buff, &bitPos);
+    write_module_names(slot, locationFx, buff, &bitPos);
+    write_patch_notes(slot, buff, &bitPos);
+    *length = BIT_TO_BYTE_ROUND_UP(bitPos);
+    return copy_bytes(buff, *length);
+}
+
+static uint8_t * load_image(const char * path, uint32_t slot, uint32_t * length) {
+    uint8_t * image = NULL;
+
+    if (g2_plugin_load_patch(path, slot) == false) {
+        return NULL;
+    }
+    image = image_of(slot, length);
+    clear_slot_data(slot);
+    return image;
+}
+
+void g2_emulator_init(const tG2EmulatorConfig * config) {
+    pthread_mutex_lock(&gLock);
+    gConfig      = *config;
+    gRandom      = (config->seed != 0) ? config->seed : 0x2d2d2d2dU;
+    gPlugged     = true;
+    gPerfVersion = 1;
+    memset(&gStats, 0, sizeof(gStats));
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        free(gSlots[s].image);
+        memset(&gSlots[s], 0, sizeof(gSlots[s]));
+        snprintf(gSlots[s].name, sizeof(gSlots[s].name), "Init %c", 'A' + s);
+        gSlots[s].version = 1;
+    }
+
+    for (uint32_t d = 0; d < EMU_DOMAINS; d++) {
+        for (uint32_t b = 0; b < NUM_PATCH_BANKS; b++) {
+            for (uint32_t l = 0; l < NUM_LOCATIONS_PER_BANK; l++) {
+                entry_clear(&gBanks[d][b][l]);
+            }
+        }
+    }
+    pthread_mutex_unlock(&gLock);
+}
+
+bool g2_emulator_load_slot(uint32_t slot, const char * path) {
+    uint32_t  length = 0;
+    uint8_t * image  = NULL;
+
+    if (slot >= MAX_SLOTS) {
+        return false;
+    }
+    image = load_image(path, slot, &length);
+
+    if (image == NULL) {
+        return false;
+    }
+    pthread_mutex_lock(&gLock);
+    free(gSlots[slot].image);
+    gSlots[slot].image       = image;
+    gSlots[slot].imageLength = length;
+    name_from_path(path, gSlots[slot].name);
+    pthread_mutex_unlock(&gLock);
+    return true;
+}
+
+bool g2_emulator_load_bank(uint8_t domain, uint32_t bank, uint32_t location, const char * path) {
+    tEmuEntry   loaded  = {0};
+    uint8_t *   content = NULL;
+    uint32_t    length  = 0;
+
+    if (bank_in_range(domain, bank, location) == false) {
+        return false;
+    }
+    content = malloc(PATCH_FILE_SIZE);
+
+    if ((content == NULL) || (read_bank_upload_file(path, content, PATCH_FILE_SIZE, &length) == false) || (length < 2)) {
+        free(content);
+        return false;
+    }
+    loaded.populated     = true;
+    loaded.content       = copy_bytes(content, length);
+    loaded.contentLength = length;
+    loaded.category      = peek_patch_category(content, length);
+    free(content);
+    name_from_path(path, loaded.name);
+
+    if (domain == BANK_UPLOAD_DOMAIN_PATCH) {
+        loaded.image = load_image(path, 0, &loaded.imageLength);
+
+        if (loaded.image == NULL) {
+            entry_clear(&loaded);
+            return false;
+        }
+    }
+    pthread_mutex_lock(&gLock);
+    entry_clear(&gBanks[domain][bank][location]);
+    gBanks[domain][bank][location] = loaded;
+    pthread_mutex_unlock(&gLock);
+    return true;
+}
+
+uint32_t g2_emulator_bank_content(uint8_t domain, uint32_t bank, uint32_t location, uint8_t * content, uint32_t size) {
+    uint32_t length = 0;
+
+    pthread_mutex_lock(&gLock);
+
+    if (bank_in_range(domain, bank, location) && gBanks[domain][bank][location].populated) {
+        const tEmuEntry * entry = &gBanks[domain][bank][location];
+
+        length = entry->contentLength;
+        memcpy(content, entry->content, (length < size) ? length : size);
+    }
+    pthread_mutex_unlock(&gLock);
+    return length;
+}
+
+void g2_emulator_plug(bool plugged) {
+    pthread_mutex_lock(&gLock);
+    gPlugged = plugged;
+    pthread_cond_signal(&gWork);
+    pthread_mutex_unlock(&gLock);
+}
+
+void g2_emulator_swap_slots(uint32_t a, uint32_t b) {
+    tEmuSlot swapped;
+
+    if ((a >= MAX_SLOTS) || (b >= MAX_SLOTS) || (a == b)) {
+        return;
+    }
+    pthread_mutex_lock(&gLock);
+    swapped               = gSlots[a];
+    gSlots[a].image       = gSlots[b].image;
+    gSlots[a].imageLength = gSlots[b].imageLength;
+    memcpy(gSlots[a].name, gSlots[b].name, sizeof(gSlots[a].name));
+    gSlots[b].image       = swapped.image;
+    gSlots[b].imageLength = swapped.imageLength;
+    memcpy(gSlots[b].name, swapped.name, sizeof(gSlots[b].name));
+    gSlots[a].version++;
+    gSlots[b].version++;
+    pthread_mutex_unlock(&gLock);
+}
+
+// The image's param list for the location, walked as parse_param_list() reads it, until the value.
+bool g2_emulator_turn_param(uint32_t slot, uint32_t location, uint32_t module, uint32_t param, uint32_t variation,
+                            uint32_t value) {
+    bool     turned = false;
+    uint32_t at     = 0;
+
+    if (slot >= MAX_SLOTS) {
+        return false;
+    }
+    pthread_mutex_lock(&gLock);
+
+    while ((turned == false) && (gSlots[slot].image != NULL) && ((at + 3) <= gSlots[slot].imageLength)) {
+        uint8_t * image   = gSlots[slot].image;
+        uint32_t  length  = ((uint32_t)image[at + 1] << 8) | image[at + 2];
+        uint32_t  bitPos  = BYTE_TO_BIT(at + 3);
+        uint32_t  modules = 0;
+        uint32_t  counts  = 0;
+
+        if ((image[at] == SUB_RESPONSE_PARAM_LIST) && (read_bit_stream(image, &bitPos, 2) == location)) {
+            modules = read_bit_stream(image, &bitPos, 8);
+            counts  = read_bit_stream(image, &bitPos, 8);
+
+            for (uint32_t m = 0; (m < modules) && (turned == false); m++) {
+                uint32_t index  = read_bit_stream(image, &bitPos, 8);
+                uint32_t params = read_bit_stream(image, &bitPos, 7);
+
+                for (uint32_t v = 0; (v < counts) && (turned == false); v++) {
+                    uint32_t thisVariation = read_bit_stream(image, &bitPos, 8);
+
+                    for (uint32_t p = 0; (p < params) && (turned == false); p++) {
+                        if ((index == module) && (thisVariation == variation) && (p == param)) {
+                            // Bit by bit: the value is overwritten in place, whatever was there.
+                            for (uint32_t b = 0; b < 7; b++) {
+                                uint32_t bit = bitPos + b;
+                                uint8_t  set = (uint8_t)(0x80U >> (bit & 7U));
+
+                                image[bit >> 3] = ((value >> (6U - b)) & 1U) ? (uint8_t)(image[bit >> 3] | set)
+                                                                              : (uint8_t)(image[bit >> 3] & ~set);
+                            }
+                            turned = true;
+                        }
+                        bitPos += 7;
+                    }
+                }
+            }
+        }
+        at += 3 + length;
+    }
+    pthread_mutex_unlock(&gLock);
+    return turned;
+}
+
+void g2_emulator_observe(tG2EmulatorObserver observer) {
+    pthread_mutex_lock(&gLock);
+    gObserver = observer;
+    pthread_mutex_unlock(&gLock);
+}
+
+void g2_emulator_stats(tG2EmulatorStats * stats) {
+    pthread_mutex_lock(&gLock);
+    *stats = gStats;
+    pthread_mutex_unlock(&gLock);
+}
+
+const tUsbStandIn * g2_emulator_stand_in(void) {
+    return &kStandIn;
+}
@@ -0,0 +1,116 @@
+/*
+ * g2Emulator — a G2 in software, behind the editor's USB transport.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __G2_EMULATOR_H__
+#define __G2_EMULATOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "usbComms.h"
+
+// A SOFTWARE G2. A backend for src/usbTransport.h that answers the editor's requests as a G2 would,
+// handed to the USB thread with usb_comms_use_stand_in() (usbComms.h): the thread runs exactly as it
+// does against the hardware — open, the readiness poll, the init pull, edits, bank jobs, reconnects
+// — and none of it knows the difference. tools/emubench.c times it; anything else that wants the
+// editor's whole USB path without a G2 can link it the same way.
+//
+// What it holds: four slot images — the patch as a patch dump carries it, section after section —
+// with a name and a version each, a performance version, and the patch and performance banks, each
+// location a name, a category, the .pch2/.prf2 body a bank upload carries and, if it was seeded from
+// a file, the slot image a retrieve puts into the edit buffer.
+//
+// What it answers: every request the editor's connect, reconnect, edit and bank paths send, framed as
+// the G2 frames it — up to 13 bytes embedded in one interrupt message, more as an extended header on
+// 0x81 and the message on 0x82, each with its CRC. Stop and start are honoured: while stopped it sends
+// nothing unsolicited. Started, it sends each slot's LED and meter messages in turn, one slot every
+// streamMs, as the G2's own streams interleave with replies. A parameter write, or anything else sent
+// without a reply asked for, is taken and not answered.
+//
+// What it does not model: the patch itself. Edits are acknowledged, not applied — the slot image is
+// what was loaded or last sent whole (SUB_COMMAND_SET_PATCH), or turned on the emulated panel
+// (g2_emulator_turn_param()), so a reconnect pulls that back, not the edits since. A bank location pushed by a restore has no slot image, and retrieves as whatever the
+// slot already held, with its version bumped as the G2 would. A Store is answered with an error: the
+// bank body it would write is the G2's own serialisation, which nothing here has.
+//
+// The link is made worse on request: every reply is ready latencyUs after the request lands, plus up
+// to jitterUs more, never ahead of the reply before it; lossPerMille of the messages it sends are
+// dropped whole, as a reply that never came. Unplugging fails everything in flight with
+// LIBUSB_ERROR_NO_DEVICE and keeps open() failing until it is plugged back in — the slots, banks and
+// versions survive, as the G2's do.
+//
+// Results are libusb's codes, as usbComms.c expects of any backend. One emulator per process.
+
+typedef struct {
+    uint32_t latencyUs;       // a request landing to its reply being ready
+    uint32_t jitterUs;        // plus up to this much, uniformly
+    uint32_t lossPerMille;    // messages to the host dropped, in thousandths
+    uint32_t streamMs;        // one slot's LED and meter messages this often, while started; 0 for none
+    uint32_t seed;            // for the jitter and the losses
+} tG2EmulatorConfig;
+
+typedef struct {
+    uint64_t opens;
+    uint64_t requests;        // on endpoint 3, framing and CRC good
+    uint64_t badRequests;     // framing or CRC bad; not answered
+    uint64_t replies;         // messages queued to the host, streams included
+    uint64_t streamed;        // of which LED and meter messages
+    uint64_t lost;            // dropped by lossPerMille
+    uint64_t refused;         // requests answered with SUB_RESPONSE_ERROR
+} tG2EmulatorStats;
+
+// Called on the transport's event thread for every request that arrives, before its send completes.
+// payload is what follows the sub-command, length bytes of it; it is not the observer's to keep.
+typedef void (*tG2EmulatorObserver)(uint32_t slot, uint8_t subCommand, const uint8_t * payload, uint32_t length);
+
+// Once, first. Empty slots, empty banks, plugged in.
+void g2_emulator_init(const tG2EmulatorConfig * config);
+
+// Seeding: the patch at path becomes slot's, or the bank location's. These load the file through the
+// editor's own database (g2_plugin_load_patch(), into slot — or slot 0 for a bank location — which
+// they leave cleared), so call them before start_usb_thread(). A performance location takes the
+// file's body only — a performance's four patches are not modelled. Each returns false if the file
+// did not load.
+bool g2_emulator_load_slot(uint32_t slot, const char * path);
+bool g2_emulator_load_bank(uint8_t domain, uint32_t bank, uint32_t location, const char * path);
+
+// A bank location's body, copied into content, at most size bytes of it. Returns its length, 0 if the
+// location is empty. Any thread.
+uint32_t g2_emulator_bank_content(uint8_t domain, uint32_t bank, uint32_t location, uint8_t * content, uint32_t size);
+
+// The cable, from any thread. Unplugged, everything in flight fails and nothing opens.
+void g2_emulator_plug(bool plugged);
+
+// As if each of the two slots had been loaded with the other's patch from the panel: they change
+// places, names and all, and both versions move on. Any thread.
+void g2_emulator_swap_slots(uint32_t a, uint32_t b);
+
+// As if a parameter had been turned on the panel with the cable out: one value in the slot's image
+// changes, and nothing else — not the version, not the name. False if the image holds no such value.
+// Any thread.
+bool g2_emulator_turn_param(uint32_t slot, uint32_t location, uint32_t module, uint32_t param, uint32_t variation,
+                            uint32_t value);
+
+void g2_emulator_observe(tG2EmulatorObserver observer);
+void g2_emulator_stats(tG2EmulatorStats * stats);
+
+// What to hand to usb_comms_use_stand_in().
+const tUsbStandIn * g2_emulator_stand_in(void);
+
+#endif // __G2_EMULATOR_H__
@@ -0,0 +1,749 @@
+/*
+ * golden — render the test patches and check them against references kept in the tree.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// An optimisation of the engine makes a promise: the sound did not change. This checks that promise
+// without anyone listening. It plays every PatchTestFiles/*.pch2 through the engine with one fixed
+// performance at 48 kHz and compares each render with a reference in tools/golden-refs/:
+//
+//     ./do-golden                          build, then check every patch within tolerance
+//     ./do-golden --exact                  ...and require every render to be bit-identical
+//     ./do-golden --update                 rewrite the references, after a change MEANT to alter the sound
+//
+// TWO WAYS TO PASS, because there are two kinds of change:
+//
+//   EXACT. The render's 64-bit hash must match the reference's. This is the claim to make for a change
+//   that should not move a single bit — a mask for a modulo, a hoisted constant, a walked index. It
+//   holds on the machine and compiler the references were made with; another libm's sin() may differ
+//   in the last place, and then only tolerance mode means anything.
+//
+//   TOLERANCE (the default). The loudness envelope, in 20 ms steps, must stay within 1 dB wherever
+//   either render is above -80 dBFS, and the long-term spectrum, in third-octave bands, within 1.5 dB
+//   wherever either is above -100 dB. That is the claim for a change that rounds differently — a float
+//   build, a vectorised kernel, a different but equivalent filter form — and it is loose enough to
+//   survive another platform's libm while still catching a filter in the wrong place, a lost voice or
+//   a delay of the wrong length.
+//
+// Every patch is played twice: as saved, and forced to four-voice Poly, so a mono patch still
+// exercises the voice allocator and the voice sum. A patch that fails to load is recorded as such, so
+// a parser change that suddenly accepts PatchTestFiles/Corrupt.pch2 is a failure too.
+//
+// A SILENT TAKE IS A FAILURE, in both modes and in --update, which will not write one. A reference of
+// silence matches any engine that has stopped making sound, so it checks nothing; eleven of the
+// thirteen test patches were exactly that before anyone noticed.
+//
+// SO A PATCH THAT DOES NOT PLAY AS SAVED IS RIGGED. Most of PatchTestFiles is module catalogues —
+// every delay, every filter, every envelope, side by side with no cables and no Out — and a few are
+// patched round modules the engine does not model. Those are taken apart: each Voice Area module the
+// engine builds a chain through is kept, everything else is removed, and the rig adds what the patch
+// lacks — an OscB at its defaults cabled into every input that is not a logic one, and a 2-Out per
+// module under test, from its first output (and second, for the stereo ones). A module the engine
+// will not take as a source on its own — an LFO, a Constant — modulates instead: into the pitch of an
+// OscB of its own, which plays into the Out. Up to four modules go into one take, one per Out the
+// engine will sum, and the takes are named rig1, rig2, ..., each played forced to Poly. Which modules
+// a rig holds is written into its reference, so a module that stops building is caught as a change
+// of plan rather than as a take that went missing, and a reference left over from a take no longer
+// played is a failure too (--update removes it). The rigging itself is tools/patchRig.c, which
+// precision.c plays the same takes through.
+//
+// A patch that not one module of can be rigged — GateLedBug and SwTest, which hold only modules the
+// engine does not model — is recorded as "unmodelled", the same way an unloadable one is, and fails
+// as soon as the engine learns to play something in it.
+//
+// A FAILURE WRITES A REPORT to golden-report/<patch>.<take>.txt: both hashes and peaks, then every
+// envelope step and band that was out of tolerance with the two levels side by side. Run from the
+// repository root; the exit status is the number of failing takes, capped at 125.
+//
+// Build: see tools/do-golden. Only libc and libm.
+
+#include <dirent.h>
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+#include "patchRig.h"
+
+#define GOLDEN_RATE             (48000.0)
+#define GOLDEN_BLOCK            (256U)
+#define GOLDEN_STAGGER          (2400U)          // 50 ms between the chord's notes
+#define GOLDEN_BEND_START       (36000U)         // 0.75 s: the wheel starts up...
+#define GOLDEN_BEND_END         (48000U)         // ...reaches half travel at 1 s and snaps back
+#define GOLDEN_HOLD             (72000U)         // 1.5 s: every key released
+#define GOLDEN_FRAMES           (GOLDEN_HOLD + 72000U)
+#define GOLDEN_CHANNELS         (2U)
+
+#define GOLDEN_ENV_STEP         (960U)           // 20 ms
+#define GOLDEN_ENV_COUNT        (GOLDEN_FRAMES / GOLDEN_ENV_STEP)
+#define GOLDEN_ENV_FLOOR_DB     (-80.0)
+#define GOLDEN_ENV_TOLERANCE    (1.0)
+
+#define GOLDEN_FFT_SIZE         (4096U)
+#define GOLDEN_BAND_COUNT       (30U)            // third octaves from 25 Hz
+#define GOLDEN_BAND_FLOOR_DB    (-100.0)
+#define GOLDEN_BAND_TOLERANCE   (1.5)
+#define GOLDEN_SILENT_DB        (-200.0)         // how an empty step or band is written
+#define GOLDEN_SILENT_PEAK      (1.0e-6)         // -120 dBFS: at or below this a take plays nothing
+
+#define GOLDEN_PATCH_DIR        "PatchTestFiles"
+#define GOLDEN_REF_DIR          "tools/golden-refs"
+#define GOLDEN_REPORT_DIR       "golden-report"
+#define GOLDEN_MAX_PATCHES      (256U)
+#define GOLDEN_PATH             (2048U)
+
+// Loading a patch goes through protocol.c, which reports a linked-variation edit to the undo stack and
+// may post to the GUI. There is neither here; these are the two references the link needs, as in
+// fxbench.c.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// What is kept of a render: enough to say whether it is the same, and if not, where it differs.
+// `unmodelled` is a patch with nothing the engine can play, and a rig's modules are written out so a
+// change in them is a failure of its own.
+typedef struct {
+    bool     loaded;
+    bool     unmodelled;
+    uint32_t rigCount;
+    uint32_t rig[RIG_MODULES];
+    bool     modulates[RIG_MODULES];
+    char     rigName[RIG_MODULES][CLAVIA_NAME_SIZE + 1];
+    uint64_t hash;
+    double   peak;
+    double   envelope[GOLDEN_ENV_COUNT];
+    double   band[GOLDEN_BAND_COUNT];
+} tGolden;
+
+static float  gRender[GOLDEN_FRAMES * GOLDEN_CHANNELS];
+static double gFftRe[GOLDEN_FFT_SIZE];
+static double gFftIm[GOLDEN_FFT_SIZE];
+static double gPower[(GOLDEN_FFT_SIZE / 2) + 1];
+
+static bool has_suffix(const char * name, const char * suffix) {
+    size_t nameLength   = strlen(name);
+    size_t suffixLength = strlen(suffix);
+
+    return (nameLength > suffixLength) && (strcmp(name + nameLength - suffixLength, suffix) == 0);
+}
+
+static int compare_names(const void * a, const void * b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+static double to_db(double power) {
+    return (power > 0.0) ? fmax(10.0 * log10(power), GOLDEN_SILENT_DB) : GOLDEN_SILENT_DB;
+}
+
+// FNV-1a over the float BITS, not their values: bit-exact means bit-exact, and -0.0 against 0.0 or a
+// change in the last place is exactly what this mode exists to notice.
+static uint64_t hash_render(const float * samples, size_t count) {
+    uint64_t hash = 1469598103934665603ULL;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bits = 0;
+
+        memcpy(&bits, &samples[i], sizeof(bits));
+
+        for (uint32_t byte = 0; byte < 4; byte++) {
+            hash = (hash ^ ((bits >> (byte * 8)) & 0xFFU)) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+// In-place radix-2 FFT. A tool's worth: correct and short, not fast.
+static void fft(double * re, double * im, uint32_t size) {
+    uint32_t j = 0;
+
+    for (uint32_t i = 1; i < size; i++) {
+        uint32_t bit = size >> 1;
+
+        for (; (j & bit) != 0; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+
+        if (i < j) {
+            double t = re[i];
+
+            re[i] = re[j];
+            re[j] = t;
+            t     = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    for (uint32_t length = 2; length <= size; length <<= 1) {
+        double angle = (-2.0 * M_PI) / (double)length;
+
+        for (uint32_t start = 0; start < size; start += length) {
+            for (uint32_t k = 0; k < (length / 2); k++) {
+                double   wr = cos(angle * (double)k);
+                double   wi = sin(angle * (double)k);
+                uint32_t a  = start + k;
+                uint32_t b  = a + (length / 2);
+                double   xr = (re[b] * wr) - (im[b] * wi);
+                double   xi = (re[b] * wi) + (im[b] * wr);
+
+                re[b]  = re[a] - xr;
+                im[b]  = im[a] - xi;
+                re[a] += xr;
+                im[a] += xi;
+            }
+        }
+    }
+}
+
+// Envelope and spectrum of gRender. The two channels are taken together: a change that moves sound
+// from one side to the other is rare, and the hash catches it in exact mode.
+static void analyse_render(tGolden * golden) {
+    uint32_t frames = 0;
+
+    golden->hash = hash_render(gRender, GOLDEN_FRAMES * GOLDEN_CHANNELS);
+    golden->peak = 0.0;
+
+    for (uint32_t step = 0; step < GOLDEN_ENV_COUNT; step++) {
+        double energy = 0.0;
+
+        for (uint32_t i = 0; i < (GOLDEN_ENV_STEP * GOLDEN_CHANNELS); i++) {
+            double v = (double)gRender[(step * GOLDEN_ENV_STEP * GOLDEN_CHANNELS) + i];
+
+            energy       += v * v;
+            golden->peak  = fmax(golden->peak, fabs(v));
+        }
+        golden->envelope[step] = to_db(energy / (double)(GOLDEN_ENV_STEP * GOLDEN_CHANNELS));
+    }
+
+    // Long-term spectrum: Hann-windowed blocks without overlap, power averaged, then summed into
+    // third-octave bands so that a tolerance in dB means the same thing at every frequency.
+    memset(gPower, 0, sizeof(gPower));
+
+    for (frames = 0; (frames + GOLDEN_FFT_SIZE) <= GOLDEN_FRAMES; frames += GOLDEN_FFT_SIZE) {
+        for (uint32_t i = 0; i < GOLDEN_FFT_SIZE; i++) {
+            double window = 0.5 - (0.5 * cos((2.0 * M_PI * (double)i) / (double)GOLDEN_FFT_SIZE));
+            uint32_t at   = (frames + i) * GOLDEN_CHANNELS;
+
+            gFftRe[i] = 0.5 * ((double)gRender[at] + (double)gRender[at + 1]) * window;
+            gFftIm[i] = 0.0;
+        }
+        fft(gFftRe, gFftIm, GOLDEN_FFT_SIZE);
+
+        for (uint32_t bin = 0; bin <= (GOLDEN_FFT_SIZE / 2); bin++) {
+            gPower[bin] += (gFftRe[bin] * gFftRe[bin]) + (gFftIm[bin] * gFftIm[bin]);
+        }
+    }
+
+    for (uint32_t band = 0; band < GOLDEN_BAND_COUNT; band++) {
+        double centre = 25.0 * pow(2.0, (double)band / 3.0);
+        double lower  = centre / pow(2.0, 1.0 / 6.0);
+        double upper  = centre * pow(2.0, 1.0 / 6.0);
+        double power  = 0.0;
+
+        for (uint32_t bin = 1; bin <= (GOLDEN_FFT_SIZE / 2); bin++) {
+            double hz = ((double)bin * GOLDEN_RATE) / (double)GOLDEN_FFT_SIZE;
+
+            if ((hz >= lower) && (hz < upper)) {
+                power += gPower[bin];
+            }
+        }
+        golden->band[band] = to_db(power / (double)(GOLDEN_FFT_SIZE * GOLDEN_FFT_SIZE));
+    }
+}
+
+// The performance: a four-note chord struck 50 ms apart, the bend wheel pushed halfway up and let go,
+// every key released at 1.5 s and the tail left to ring for as long again. Events land on block
+// boundaries, which is what a host gives the plug-in too.
+static bool render_take(const char * path, const tRigTake * take, tGolden * golden) {
+    static const int32_t chord[] = {48, 55, 60, 64};
+    const uint32_t       notes   = sizeof(chord) / sizeof(chord[0]);
+    uint32_t             frame   = 0;
+
+    memset(golden, 0, sizeof(*golden));
+
+    if (rig_load_take(path, take) == false) {
+        return false;
+    }
+    golden->loaded = true;
+
+    if (take->rigged == true) {
+        if (take->rigCount == 0) {
+            golden->unmodelled = true;
+            return true;
+        }
+        golden->rigCount = take->rigCount;
+
+        // The rig keeps each module it plays where it was, name and all.
+        for (uint32_t i = 0; i < take->rigCount; i++) {
+            golden->rig[i]       = take->rig[i];
+            golden->modulates[i] = take->modulates[i];
+            snprintf(golden->rigName[i], sizeof(golden->rigName[i]), "%s",
+                     get_module_slot(0, (uint32_t)locationVa, take->rig[i])->name);
+        }
+    }
+    sound_engine_start_hosted(GOLDEN_RATE);
+    sound_engine_pitch_bend(0.0);
+    sound_engine_update_from_patch();
+
+    while (frame < GOLDEN_FRAMES) {
+        uint32_t count = GOLDEN_BLOCK;
+
+        if ((frame + count) > GOLDEN_FRAMES) {
+            count = GOLDEN_FRAMES - frame;
+        }
+
+        for (uint32_t k = 0; k < notes; k++) {
+            uint32_t on = k * GOLDEN_STAGGER;
+
+            if ((frame <= on) && (on < (frame + count))) {
+                sound_engine_note(chord[k], true);
+            }
+        }
+
+        if ((frame >= GOLDEN_BEND_START) && (frame < GOLDEN_BEND_END)) {
+            sound_engine_pitch_bend(0.5 * (double)(frame - GOLDEN_BEND_START) / (double)(GOLDEN_BEND_END - GOLDEN_BEND_START));
+        } else if ((frame <= GOLDEN_BEND_END) && (GOLDEN_BEND_END < (frame + count))) {
+            sound_engine_pitch_bend(0.0);
+        }
+
+        if ((frame <= GOLDEN_HOLD) && (GOLDEN_HOLD < (frame + count))) {
+            sound_engine_note(-1, false);
+        }
+        sound_engine_render(&gRender[frame * GOLDEN_CHANNELS], count, GOLDEN_CHANNELS);
+        frame += count;
+    }
+    sound_engine_stop_hosted();
+    sound_engine_pitch_bend(0.0);
+    analyse_render(golden);
+    return true;
+}
+
+static bool write_reference(const char * path, const char * patch, const tRigTake * take, const tGolden * golden) {
+    FILE * file = fopen(path, "w");
+
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "# golden reference: %s, %s, %u frames at %.0f Hz", patch, take->name, GOLDEN_FRAMES, GOLDEN_RATE);
+
+    for (uint32_t i = 0; i < golden->rigCount; i++) {
+        fprintf(file, "%s %s (%u%s)", (i == 0) ? ", rig of" : ",", golden->rigName[i], golden->rig[i],
+                golden->modulates[i] ? ", modulating" : "");
+    }
+    fprintf(file, ". Written by golden --update.\n");
+
+    if (golden->loaded == false) {
+        fprintf(file, "unloadable\n");
+        return fclose(file) == 0;
+    }
+
+    if (golden->unmodelled == true) {
+        fprintf(file, "unmodelled\n");
+        return fclose(file) == 0;
+    }
+
+    if (golden->rigCount > 0) {
+        fprintf(file, "rig %u", golden->rigCount);
+
+        for (uint32_t i = 0; i < golden->rigCount; i++) {
+            fprintf(file, " %u%s", golden->rig[i], golden->modulates[i] ? ":mod" : "");
+        }
+        fprintf(file, "\n");
+    }
+    fprintf(file, "hash %016llx\n", (unsigned long long)golden->hash);
+    fprintf(file, "peak %.9g\n", golden->peak);
+    fprintf(file, "envelope %u\n", GOLDEN_ENV_COUNT);
+
+    for (uint32_t i = 0; i < GOLDEN_ENV_COUNT; i++) {
+        fprintf(file, "%.3f%s", golden->envelope[i], ((i % 10) == 9) ? "\n" : " ");
+    }
+    fprintf(file, "bands %u\n", GOLDEN_BAND_COUNT);
+
+    for (uint32_t i = 0; i < GOLDEN_BAND_COUNT; i++) {
+        fprintf(file, "%.3f%s", golden->band[i], ((i % 10) == 9) ? "\n" : " ");
+    }
+    return fclose(file) == 0;
+}
+
+static bool read_values(FILE * file, const char * label, double * values, uint32_t count) {
+    char     word[32];
+    uint32_t stated = 0;
+
+    if ((fscanf(file, "%31s %u", word, &stated) != 2) || (strcmp(word, label) != 0) || (stated != count)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (fscanf(file, "%lf", &values[i]) != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool read_reference(const char * path, tGolden * golden) {
+    FILE *             file = fopen(path, "r");
+    char               line[512];
+    unsigned long long hash = 0;
+    bool               ok   = false;
+
+    memset(golden, 0, sizeof(*golden));
+
+    if (file == NULL) {
+        return false;
+    }
+
+    if ((fgets(line, sizeof(line), file) == NULL) || (line[0] != '#') || (fgets(line, sizeof(line), file) == NULL)) {
+        fclose(file);
+        return false;
+    }
+
+    if (strncmp(line, "unloadable", 10) == 0) {
+        fclose(file);
+        return true;
+    }
+    golden->loaded = true;
+
+    if (strncmp(line, "unmodelled", 10) == 0) {
+        golden->unmodelled = true;
+        fclose(file);
+        return true;
+    }
+
+    if (strncmp(line, "rig ", 4) == 0) {
+        char * at  = line + 4;
+        char * end = NULL;
+
+        golden->rigCount = (uint32_t)strtoul(at, &end, 10);
+
+        if ((end == at) || (golden->rigCount > RIG_MODULES)) {
+            fclose(file);
+            return false;
+        }
+
+        for (uint32_t i = 0; i < golden->rigCount; i++) {
+            at             = end;
+            golden->rig[i] = (uint32_t)strtoul(at, &end, 10);
+
+            if (end == at) {
+                fclose(file);
+                return false;
+            }
+
+            if (strncmp(end, ":mod", 4) == 0) {
+                golden->modulates[i] = true;
+                end                 += 4;
+            }
+        }
+
+        if (fgets(line, sizeof(line), file) == NULL) {
+            fclose(file);
+            return false;
+        }
+    }
+    ok             = (sscanf(line, "hash %llx", &hash) == 1)
+                     && (fscanf(file, " peak %lf", &golden->peak) == 1)
+                     && read_values(file, "envelope", golden->envelope, GOLDEN_ENV_COUNT)
+                     && read_values(file, "bands", golden->band, GOLDEN_BAND_COUNT);
+    golden->hash = (uint64_t)hash;
+    fclose(file);
+    return ok;
+}
+
+// Whether `test` is within tolerance of `ref`, writing every step and band that is not to `report`
+// when there is one.
+static bool within_tolerance(const tGolden * ref, const tGolden * test, FILE * report) {
+    bool ok = true;
+
+    for (uint32_t i = 0; i < GOLDEN_ENV_COUNT; i++) {
+        double delta = test->envelope[i] - ref->envelope[i];
+
+        if ((fmax(ref->envelope[i], test->envelope[i]) > GOLDEN_ENV_FLOOR_DB) && (fabs(delta) > GOLDEN_ENV_TOLERANCE)) {
+            if (report != NULL) {
+                fprintf(report, "envelope %6.2f s   ref %8.2f dB   now %8.2f dB   %+7.2f dB\n",
+                        ((double)(i * GOLDEN_ENV_STEP)) / GOLDEN_RATE, ref->envelope[i], test->envelope[i], delta);
+            }
+            ok = false;
+        }
+    }
+
+    for (uint32_t i = 0; i < GOLDEN_BAND_COUNT; i++) {
+        double delta = test->band[i] - ref->band[i];
+
+        if ((fmax(ref->band[i], test->band[i]) > GOLDEN_BAND_FLOOR_DB) && (fabs(delta) > GOLDEN_BAND_TOLERANCE)) {
+            if (report != NULL) {
+                fprintf(report, "band %8.1f Hz   ref %8.2f dB   now %8.2f dB   %+7.2f dB\n",
+                        25.0 * pow(2.0, (double)i / 3.0), ref->band[i], test->band[i], delta);
+            }
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void write_report(const char * reportDir, const char * patch, const tRigTake * take, const char * why,
+                         const tGolden * ref, const tGolden * test) {
+    char   path[GOLDEN_PATH];
+    FILE * report = NULL;
+
+    if ((mkdir(reportDir, 0755) != 0) && (errno != EEXIST)) {
+        fprintf(stderr, "golden: cannot create %s\n", reportDir);
+        return;
+    }
+    snprintf(path, sizeof(path), "%s/%s.%s.txt", reportDir, patch, take->name);
+    report = fopen(path, "w");
+
+    if (report == NULL) {
+        fprintf(stderr, "golden: cannot write %s\n", path);
+        return;
+    }
+    fprintf(report, "%s, %s: %s\n", patch, take->name, why);
+    fprintf(report, "loaded   ref %s   now %s\n", ref->loaded ? "yes" : "no", test->loaded ? "yes" : "no");
+
+    if (ref->loaded && test->loaded && (ref->unmodelled == false) && (test->unmodelled == false)) {
+        fprintf(report, "hash     ref %016llx   now %016llx\n", (unsigned long long)ref->hash, (unsigned long long)test->hash);
+        fprintf(report, "peak     ref %.6f   now %.6f\n", ref->peak, test->peak);
+        fprintf(report, "out of tolerance (envelope %.1f dB above %.0f dBFS, bands %.1f dB above %.0f dB):\n",
+                GOLDEN_ENV_TOLERANCE, GOLDEN_ENV_FLOOR_DB, GOLDEN_BAND_TOLERANCE, GOLDEN_BAND_FLOOR_DB);
+
+        if (within_tolerance(ref, test, report)) {
+            fprintf(report, "(nothing: the render differs only below the tolerance)\n");
+        }
+    }
+    fclose(report);
+    printf("    report: %s\n", path);
+}
+
+static uint32_t list_patches(char ** names) {
+    DIR *           handle = opendir(GOLDEN_PATCH_DIR);
+    struct dirent * entry  = NULL;
+    uint32_t        count  = 0;
+
+    if (handle == NULL) {
+        return 0;
+    }
+
+    while (((entry = readdir(handle)) != NULL) && (count < GOLDEN_MAX_PATCHES)) {
+        if (has_suffix(entry->d_name, ".pch2")) {
+            names[count++] = strdup(entry->d_name);
+        }
+    }
+    closedir(handle);
+    qsort(names, count, sizeof(names[0]), compare_names);
+    return count;
+}
+
+// References for takes the patch is no longer played in — a patch that now plays as saved and was
+// rigged before, or a rig that has lost a take. A failure each, or with --update, removed.
+static uint32_t stale_references(const char * refDir, const char * patch, const tRigTake * takes, uint32_t count,
+                                 bool update) {
+    DIR *           handle = opendir(refDir);
+    struct dirent * entry  = NULL;
+    size_t          length = strlen(patch);
+    uint32_t        stale  = 0;
+
+    if (handle == NULL) {
+        return 0;
+    }
+
+    while ((entry = readdir(handle)) != NULL) {
+        char path[GOLDEN_PATH];
+        bool played = false;
+
+        if (  (strncmp(entry->d_name, patch, length) != 0) || (entry->d_name[length] != '.')
+           || (has_suffix(entry->d_name, ".ref") == false)) {
+            continue;
+        }
+
+        for (uint32_t take = 0; take < count; take++) {
+            char name[GOLDEN_PATH];
+
+            snprintf(name, sizeof(name), "%s.%s.ref", patch, takes[take].name);
+            played = played || (strcmp(entry->d_name, name) == 0);
+        }
+
+        if (played) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", refDir, entry->d_name);
+
+        if (update) {
+            (void)remove(path);
+            printf("  %-24s removed %s, a take no longer played\n", patch, entry->d_name);
+        } else {
+            printf("  %-24s %s is for a take no longer played\n", patch, entry->d_name);
+            stale++;
+        }
+    }
+    closedir(handle);
+    return stale;
+}
+
+int main(int argc, char ** argv) {
+    const char * refDir    = GOLDEN_REF_DIR;
+    const char * reportDir = GOLDEN_REPORT_DIR;
+    char *       names[GOLDEN_MAX_PATCHES];
+    char         path[GOLDEN_PATH];
+    char         refPath[GOLDEN_PATH];
+    static tRigTake plan[RIG_MAX_TAKES];
+    bool         exact     = false;
+    bool         update    = false;
+    uint32_t     count     = 0;
+    uint32_t     failed    = 0;
+    uint32_t     checked   = 0;
+    int          i         = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--exact") == 0) {
+            exact = true;
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if ((strcmp(argv[i], "--refs") == 0) && ((i + 1) < argc)) {
+            refDir = argv[++i];
+        } else if ((strcmp(argv[i], "--report") == 0) && ((i + 1) < argc)) {
+            reportDir = argv[++i];
+        } else if ((argv[i][0] != '-') && (count < GOLDEN_MAX_PATCHES)) {
+            names[count++] = strdup(argv[i]);
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--exact] [--update] [--refs dir] [--report dir] [patch.pch2 ...]\n"
+                    "  Renders the test patches and checks them against the references in %s.\n",
+                    argv[0], GOLDEN_REF_DIR);
+            return 126;
+        }
+    }
+
+    // Patches named on the command line are paths; the default set is every file in PatchTestFiles.
+    if (count == 0) {
+        count = list_patches(names);
+
+        for (uint32_t p = 0; p < count; p++) {
+            char * full = malloc(strlen(GOLDEN_PATCH_DIR) + strlen(names[p]) + 2);
+
+            sprintf(full, "%s/%s", GOLDEN_PATCH_DIR, names[p]);
+            free(names[p]);
+            names[p] = full;
+        }
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "golden: no patches (run from the repository root, or name them)\n");
+        return 126;
+    }
+
+    for (uint32_t p = 0; p < count; p++) {
+        const char * slash = strrchr(names[p], '/');
+        const char * patch = (slash != NULL) ? (slash + 1) : names[p];
+        uint32_t     takes = 0;
+
+        snprintf(path, sizeof(path), "%s", names[p]);
+        takes = rig_plan_takes(path, plan);
+
+        for (uint32_t take = 0; take < takes; take++) {
+            tGolden      test   = {0};
+            tGolden      ref    = {0};
+            const char * result = "ok";
+            bool         silent = false;
+
+            render_take(path, &plan[take], &test);
+            silent = test.loaded && (test.unmodelled == false) && (test.peak <= GOLDEN_SILENT_PEAK);
+            snprintf(refPath, sizeof(refPath), "%s/%s.%s.ref", refDir, patch, plan[take].name);
+
+            if (update) {
+                if (silent) {
+                    printf("  %-24s %-6s SILENT, not written\n", patch, plan[take].name);
+                    failed++;
+                    continue;
+                }
+
+                if (write_reference(refPath, patch, &plan[take], &test) == false) {
+                    fprintf(stderr, "golden: cannot write %s\n", refPath);
+                    return 126;
+                }
+                printf("  %-24s %-6s written\n", patch, plan[take].name);
+                continue;
+            }
+            checked++;
+
+            if (read_reference(refPath, &ref) == false) {
+                result = "no reference (run with --update to make one)";
+            } else if (ref.loaded != test.loaded) {
+                result = test.loaded ? "loads, but the reference says it should not" : "did not load";
+            } else if (test.loaded == false) {
+                result = "ok (does not load, as expected)";
+            } else if (ref.unmodelled != test.unmodelled) {
+                result = test.unmodelled ? "plays nothing, but the reference has it playing"
+                                         : "plays, but the reference says nothing in it is modelled";
+            } else if (test.unmodelled == true) {
+                result = "ok (nothing in it is modelled, as expected)";
+            } else if (  (ref.rigCount != test.rigCount)
+                      || (memcmp(ref.rig, test.rig, sizeof(ref.rig[0]) * test.rigCount) != 0)
+                      || (memcmp(ref.modulates, test.modulates, sizeof(ref.modulates[0]) * test.rigCount) != 0)) {
+                result = "the rig holds different modules from the reference's";
+            } else if (silent) {
+                result = "silent";
+            } else if (ref.hash == test.hash) {
+                result = "ok (bit-exact)";
+            } else if (exact) {
+                result = "hash differs";
+            } else if (within_tolerance(&ref, &test, NULL) == false) {
+                result = "out of tolerance";
+            } else {
+                result = "ok (within tolerance)";
+            }
+            printf("  %-24s %-6s %s\n", patch, plan[take].name, result);
+
+            if (strncmp(result, "ok", 2) != 0) {
+                write_report(reportDir, patch, &plan[take], result, &ref, &test);
+                failed++;
+            }
+        }
+        failed += stale_references(refDir, patch, plan, takes, update);
+        free(names[p]);
+    }
+
+    if (update == false) {
+        printf("%u of %u takes passed%s\n", (checked > failed) ? (checked - failed) : 0, checked,
+               exact ? ", bit-exact required" : "");
+    }
+    return (failed > 125) ? 125 : (int)failed;
+}
@@ -0,0 +1,417 @@
+/*
+ * ledbench — decode LED and meter messages by walking the modules and by the slot's plan, and time both.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// The G2 sends a volume (meter) message and an LED message for each slot many times a second, and
+// usbComms.c places their values through the slot's decode plan (src/indicatorPlan.h). Before the
+// plan, each message walked all 128 module indices of both areas and looked up every module's type to
+// find out whose value was whose. This loads each patch into slot 0 and, for its layout:
+//
+//   THE SAME VALUES. Decodes a few hundred messages both ways — the walk, copied here as it was, and
+//   the plan — and checks every meter and LED of every module ends up identical. Any difference is a
+//   failure.
+//
+//   THE TIME. Decodes each kind of message many times both ways and prints nanoseconds per message,
+//   and what building the plan costs, which happens once per change to the slot's modules.
+//
+// The messages are made up, shaped by the layout: a start index, one 16-bit entry per meter and per
+// multi-bit LED group, or four LEDs to a byte, then the two CRC bytes. There are no captures in the
+// tree to replay, and the decoders only care how long a message is and where its values sit — which
+// the layout alone decides. The values are random, with the group flag bits set on half of them.
+//
+// By default it runs PatchTestFiles/LedsTest.pch2 and PatchTestFiles/LedGroups.pch2, the two patches
+// made to exercise LEDs; name others to run those instead. Run from the repository root:
+//
+//     ./do-ledbench
+//     ./ledbench --messages 500000 PatchTestFiles/ExpAudio.pch2
+//
+// Exits non-zero if a patch failed to load or the two decoders disagreed.
+//
+// Build: see tools/do-ledbench. Only libc and libm.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "utils.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "moduleResourcesAccess.h"
+#include "../src/indicatorPlan.h"
+#include "../vst3/g2Patch.h"
+
+#define LEDBENCH_MESSAGES      (200000U)
+#define LEDBENCH_CHECKS        (300U)
+#define LEDBENCH_BUFFER        (4096U)
+
+// As golden.c: loading a patch may report to the undo stack and post to the GUI, and there is neither.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// ── THE WALK IT REPLACED ─────────────────────────────────────────────────────
+
+// parse_volume_indicator() as it was.
+static void walk_meters(uint32_t slot, uint8_t * buff, uint32_t * bitPos) {
+    int volumesToRead = 0;
+
+    read_bit_stream(buff, bitPos, 8);
+
+    for (int32_t location = 1; location >= 0; location--) {
+        for (int k = 0; k < MAX_NUM_MODULES; k++) {
+            tModuleKey key    = {slot, (uint32_t)location, (uint32_t)k};
+            tModule *  module = get_module(key);
+
+            if (module != NULL) {
+                switch (gModuleProperties[module->type].volumeType) {
+                    case volumeTypeMono:
+                    case volumeTypeCompress:
+                    case volumeTypeSequencer:
+                        volumesToRead = 1;
+                        break;
+                    case volumeTypeStereo:
+                        volumesToRead = 2;
+                        break;
+                    case volumeTypeQuad:
+                        volumesToRead = 4;
+                        break;
+                    case volumeTypeNone:
+                        volumesToRead = 0;
+                        break;
+                }
+
+                for (int i = 0; i < volumesToRead; i++) {
+                    module->volume.value[i] = read_bit_stream(buff, bitPos, 8);
+                    read_bit_stream(buff, bitPos, 8);
+                }
+                uint32_t multiBitLeds = module_multibit_led_count(module->type);
+
+                if (multiBitLeds > 0) {
+                    uint32_t value = read_bit_stream(buff, bitPos, 8);
+
+                    value |= read_bit_stream(buff, bitPos, 8) << 8;
+
+                    for (uint32_t l = 0; (l < multiBitLeds) && (l < MAX_LEDS_PER_MODULE); l++) {
+                        module->led.value[l] = ((value & 0x3000) == 0x3000) ? ((value >> l) & 1) : 0;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// parse_led_data() as it was.
+static void walk_leds(uint32_t slot, uint8_t * buff, uint32_t * bitPos, int length) {
+    uint32_t startIndex = read_bit_stream(buff, bitPos, 8);
+    uint32_t ledCount   = 0;
+    uint32_t dataStart  = BIT_TO_BYTE(*bitPos);
+    uint32_t dataBytes  = 0;
+
+    if (length > (int)(dataStart + CRC_BYTES)) {
+        dataBytes = (uint32_t)length - dataStart - CRC_BYTES;
+    }
+
+    for (int32_t location = 1; location >= 0; location--) {
+        for (int k = 0; k < MAX_NUM_MODULES; k++) {
+            tModuleKey key    = {slot, (uint32_t)location, (uint32_t)k};
+            tModule *  module = get_module(key);
+
+            if (module != NULL) {
+                uint32_t ledCountFromModule = module_led_count(module->type);
+
+                for (uint32_t l = 0; l < ledCountFromModule; l++) {
+                    if ((ledCount >= startIndex) && (ledCount < LED_STREAM_SIZE)) {
+                        uint32_t offset = ledCount - startIndex;
+
+                        if (((offset / 4) < dataBytes) && (l < MAX_LEDS_PER_MODULE)) {
+                            module->led.value[l] = (buff[dataStart + (offset / 4)] >> ((offset % 4) * 2)) & 0x3;
+                        }
+                    }
+                    ledCount++;
+                }
+            }
+        }
+    }
+}
+
+// ── THE PLAN ─────────────────────────────────────────────────────────────────
+
+// What parse_volume_indicator() and parse_led_data() do now, less the plan lookup.
+static void plan_meters(const tIndicatorPlan * plan, uint8_t * buff, int length) {
+    indicator_plan_decode_meters(plan, &buff[1], (uint32_t)length - 1 - CRC_BYTES);
+}
+
+static void plan_leds(const tIndicatorPlan * plan, uint8_t * buff, int length) {
+    indicator_plan_decode_leds(plan, buff[0], &buff[1], (uint32_t)length - 1 - CRC_BYTES);
+}
+
+// ── CHECKING AND TIMING ──────────────────────────────────────────────────────
+
+typedef struct {
+    uint32_t volume[2][MAX_NUM_MODULES][4];
+    uint32_t led[2][MAX_NUM_MODULES][MAX_LEDS_PER_MODULE];
+} tIndicators;
+
+static uint32_t gSeed = 1;
+
+static uint8_t random_byte(void) {
+    gSeed = (gSeed * 1103515245U) + 12345U;
+    return (uint8_t)(gSeed >> 16);
+}
+
+static uint64_t now_nanos(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static void read_indicators(uint32_t slot, tIndicators * out) {
+    for (uint32_t location = 0; location < 2; location++) {
+        for (uint32_t k = 0; k < MAX_NUM_MODULES; k++) {
+            tModule * module = get_module((tModuleKey){slot, location, k});
+
+            for (uint32_t i = 0; i < 4; i++) {
+                out->volume[location][k][i] = (module != NULL) ? module->volume.value[i] : 0;
+            }
+
+            for (uint32_t l = 0; l < MAX_LEDS_PER_MODULE; l++) {
+                out->led[location][k][l] = (module != NULL) ? module->led.value[l] : 0;
+            }
+        }
+    }
+}
+
+static void clear_indicators(uint32_t slot) {
+    for (uint32_t location = 0; location < 2; location++) {
+        for (uint32_t k = 0; k < MAX_NUM_MODULES; k++) {
+            tModule * module = get_module((tModuleKey){slot, location, k});
+
+            if (module != NULL) {
+                memset(module->volume.value, 0, sizeof(module->volume.value));
+
+                for (uint32_t l = 0; l < MAX_LEDS_PER_MODULE; l++) {
+                    module->led.value[l] = 0;
+                }
+            }
+        }
+    }
+}
+
+// A volume message for the plan's layout: start index 0, every entry, the CRC.
+static int make_meter_message(const tIndicatorPlan * plan, uint8_t * buff) {
+    int length = 1 + (int)(plan->meterBits / 8) + CRC_BYTES;
+
+    buff[0] = 0;
+
+    for (int i = 1; i < length; i++) {
+        buff[i] = random_byte();
+    }
+
+    // Half the groups carry the flag bits that say their value is a bit set.
+    for (uint32_t s = 0; s < plan->meterCount; s++) {
+        if ((plan->meter[s].width == 16) && ((random_byte() & 1) != 0)) {
+            buff[1 + (plan->meter[s].bitOffset / 8) + 1] |= 0x30;
+        }
+    }
+    return length;
+}
+
+// An LED message: from startIndex to the end of the stream, four to a byte, then the CRC.
+static int make_led_message(uint32_t startIndex, uint8_t * buff) {
+    int length = 1 + (int)((LED_STREAM_SIZE - startIndex + 3) / 4) + CRC_BYTES;
+
+    buff[0] = (uint8_t)startIndex;
+
+    for (int i = 1; i < length; i++) {
+        buff[i] = random_byte();
+    }
+    return length;
+}
+
+// Decodes `LEDBENCH_CHECKS` messages of each kind both ways and compares every indicator of the slot.
+static bool same_values(const tIndicatorPlan * plan) {
+    static uint8_t     buff[LEDBENCH_BUFFER];
+    static tIndicators walked;
+    static tIndicators planned;
+
+    for (uint32_t m = 0; m < LEDBENCH_CHECKS; m++) {
+        uint32_t startIndex = (m % 3 == 2) ? (m % 9) : 0;    // mostly whole streams, sometimes a tail
+        int      length     = 0;
+        uint32_t bitPos     = 0;
+
+        length = (m % 2 == 0) ? make_meter_message(plan, buff) : make_led_message(startIndex, buff);
+
+        clear_indicators(0);
+
+        if (m % 2 == 0) {
+            walk_meters(0, buff, &bitPos);
+        } else {
+            walk_leds(0, buff, &bitPos, length);
+        }
+        read_indicators(0, &walked);
+
+        clear_indicators(0);
+
+        if (m % 2 == 0) {
+            plan_meters(plan, buff, length);
+        } else {
+            plan_leds(plan, buff, length);
+        }
+        read_indicators(0, &planned);
+
+        if (memcmp(&walked, &planned, sizeof(walked)) != 0) {
+            printf("    message %u (%s) decoded differently\n", (unsigned)m, (m % 2 == 0) ? "meters" : "LEDs");
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nanoseconds per message for one decoder over the same message, `count` times.
+static double time_decoder(int which, const tIndicatorPlan * plan, uint8_t * buff, int length, uint32_t count) {
+    uint64_t began = now_nanos();
+
+    for (uint32_t m = 0; m < count; m++) {
+        uint32_t bitPos = 0;
+
+        switch (which) {
+            case 0:
+            {
+                walk_meters(0, buff, &bitPos);
+                break;
+            }
+            case 1:
+            {
+                plan_meters(plan, buff, length);
+                break;
+            }
+            case 2:
+            {
+                walk_leds(0, buff, &bitPos, length);
+                break;
+            }
+            default:
+            {
+                plan_leds(plan, buff, length);
+                break;
+            }
+        }
+    }
+    return (double)(now_nanos() - began) / (double)count;
+}
+
+static bool run(const char * path, uint32_t messages) {
+    static uint8_t         meters[LEDBENCH_BUFFER];
+    static uint8_t         leds[LEDBENCH_BUFFER];
+    static tIndicatorPlan  scratch;
+    const tIndicatorPlan * plan        = NULL;
+    int                    meterLength = 0;
+    int                    ledLength   = 0;
+    uint64_t               began       = 0;
+    double                 buildNs     = 0.0;
+    bool                   same        = false;
+    const char *           name        = strrchr(path, '/');
+
+    name = (name != NULL) ? name + 1 : path;
+
+    if (g2_plugin_load_patch(path, 0) == false) {
+        printf("%-20s did not load\n", name);
+        return false;
+    }
+    plan  = indicator_plan_for_slot(0);
+    same  = same_values(plan);
+
+    began = now_nanos();
+
+    for (uint32_t b = 0; b < 1000; b++) {
+        indicator_plan_build(&scratch, 0);
+    }
+    buildNs     = (double)(now_nanos() - began) / 1000.0;
+
+    meterLength = make_meter_message(plan, meters);
+    ledLength   = make_led_message(0, leds);
+
+    double walkMeters = time_decoder(0, plan, meters, meterLength, messages);
+    double planMeters = time_decoder(1, plan, meters, meterLength, messages);
+    double walkLeds   = time_decoder(2, plan, leds, ledLength, messages);
+    double planLeds   = time_decoder(3, plan, leds, ledLength, messages);
+
+    printf("%-20s %3u meter steps %2u LEDs   meters %7.1f -> %6.1f ns   LEDs %7.1f -> %6.1f ns   build %7.1f ns   %s\n",
+           name, (unsigned)plan->meterCount, (unsigned)plan->ledCount, walkMeters, planMeters, walkLeds, planLeds,
+           buildNs, same ? "ok" : "DIFFERENT");
+    return same;
+}
+
+int main(int argc, char ** argv) {
+    static const char * kDefault[] = {"PatchTestFiles/LedsTest.pch2", "PatchTestFiles/LedGroups.pch2"};
+    const char *        patches[64];
+    uint32_t            patchCount = 0;
+    uint32_t            messages   = LEDBENCH_MESSAGES;
+    bool                ok         = true;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--messages") == 0) && ((i + 1) < argc)) {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((argv[i][0] != '-') && (patchCount < (sizeof(patches) / sizeof(patches[0])))) {
+            patches[patchCount++] = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [--messages N] [patch.pch2 ...]\n"
+                            "  Decodes LED and meter messages for each patch's layout by walking the\n"
+                            "  modules and by the slot's decode plan, checks they agree, and times both.\n", argv[0]);
+            return 126;
+        }
+    }
+
+    if (patchCount == 0) {
+        for (uint32_t p = 0; p < (sizeof(kDefault) / sizeof(kDefault[0])); p++) {
+            patches[patchCount++] = kDefault[p];
+        }
+    }
+
+    if (messages == 0) {
+        messages = 1;
+    }
+    init_database();
+
+    printf("%u messages of each kind per patch, walked -> planned, per message\n\n", (unsigned)messages);
+
+    for (uint32_t p = 0; p < patchCount; p++) {
+        ok = run(patches[p], messages) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+/*
+ * patchRig — take a test patch apart into takes the engine can play, for the tools that render them.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// See patchRig.h. Moved out of golden.c so that precision.c plays the same takes.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "moduleResourcesAccess.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+#include "patchRig.h"
+
+#define RIG_PLAN_RATE    (48000.0)      // a chain is built or not whatever the rate; this is the tools' own
+
+// A fresh module of `type` at `index` in the Voice Area, every parameter and mode at its default — what
+// the editor's Add Module gives, less the trip to the synth.
+static tModule * rig_add_module(tModuleType type, uint32_t index) {
+    static tModule module;
+    tModuleKey     key = {0, (uint32_t)locationVa, index};
+
+    memset(&module, 0, sizeof(module));
+    module.type             = type;
+    module.actualParamCount = module_param_count(type);
+    module.modeCount        = module_mode_count(type);
+
+    for (uint32_t i = 0, seen = 0; (i < array_size_mode_location_list()) && (seen < MAX_NUM_MODES); i++) {
+        if (modeLocationList[i].moduleType == type) {
+            module.mode[seen++].value = modeLocationList[i].defaultValue;
+        }
+    }
+
+    for (uint32_t i = 0, seen = 0; (i < array_size_param_location_list()) && (seen < module.actualParamCount); i++) {
+        if (paramLocationList[i].moduleType == type) {
+            for (uint32_t variation = 0; variation < NUM_VARIATIONS_USB; variation++) {
+                module.param[variation][seen].value = paramLocationList[i].defaultValue;
+            }
+            seen++;
+        }
+    }
+    write_module(key, &module);
+    return get_module(key);
+}
+
+// The lowest Voice Area index with nothing in it. 0 is never used, as in the editor.
+static uint32_t rig_free_index(void) {
+    for (uint32_t index = 1; index < MAX_NUM_MODULES; index++) {
+        if (get_module(((tModuleKey){0, (uint32_t)locationVa, index})) == NULL) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+// The io count — the connector's number among the module's inputs, or among its outputs — that a
+// cable key wants, for the `nth` connector of that direction that is not a logic one. -1 if there is
+// none.
+static int32_t rig_connector(tModule * module, tConnectorDir dir, uint32_t nth) {
+    uint32_t count = module_connector_count(module->type);
+    int32_t  io    = -1;
+
+    for (uint32_t c = 0; c < count; c++) {
+        if (module->connector[c].dir != dir) {
+            continue;
+        }
+        io++;
+
+        if (  (module->connector[c].type != connectorTypeLogic)
+           && (module->connector[c].type != connectorTypeTurboLogic)) {
+            if (nth == 0) {
+                return io;
+            }
+            nth--;
+        }
+    }
+    return -1;
+}
+
+static void rig_cable(uint32_t fromIndex, uint32_t fromIo, uint32_t toIndex, uint32_t toIo) {
+    tCable    cable = {0};
+    tCableKey key   = {0, (uint32_t)locationVa, fromIndex, fromIo, 1, toIndex, toIo};
+
+    write_cable(key, &cable);
+}
+
+static bool is_out_module(tModuleType type) {
+    return (type == moduleType2toOut) || (type == moduleType4toOut);
+}
+
+// Takes the patch in slot 0 apart down to the Voice Area modules listed, and wires them as described
+// in patchRig.h: the rig's OscB into every input that is not logic, each module's outputs into an Out of
+// its own. A module that `modulates` gets an OscB of its own instead, and plays through it.
+static void rig_patch(const uint32_t * rig, const bool * modulates, uint32_t rigCount) {
+    static tModule kept[RIG_MODULES];
+    uint32_t       source = 0;
+
+    for (uint32_t i = 0; i < rigCount; i++) {
+        kept[i] = *get_module_slot(0, (uint32_t)locationVa, rig[i]);
+    }
+
+    for (uint32_t index = 0; index < MAX_NUM_MODULES; index++) {
+        delete_module(((tModuleKey){0, (uint32_t)locationVa, index}));
+        delete_module(((tModuleKey){0, (uint32_t)locationFx, index}));
+    }
+    database_delete_cables_by_slot(0);
+
+    for (uint32_t i = 0; i < rigCount; i++) {
+        write_module(kept[i].key, &kept[i]);
+    }
+    source = rig_free_index();
+    (void)rig_add_module(moduleTypeOscB, source);
+
+    for (uint32_t i = 0; i < rigCount; i++) {
+        tModule * module = get_module(((tModuleKey){0, (uint32_t)locationVa, rig[i]}));
+        int32_t   first  = rig_connector(module, connectorDirOut, 0);
+        int32_t   second = rig_connector(module, connectorDirOut, 1);
+        uint32_t  out    = 0;
+        int32_t   io     = 0;
+
+        if (modulates[i] == true) {
+            uint32_t  osc       = rig_free_index();
+            tModule * modulated = rig_add_module(moduleTypeOscB, osc);
+
+            out = rig_free_index();
+            (void)rig_add_module(moduleType2toOut, out);
+            rig_cable(rig[i], (uint32_t)first, osc, (uint32_t)rig_connector(modulated, connectorDirIn, 0));
+            rig_cable(osc, 0, out, 0);
+            rig_cable(osc, 0, out, 1);
+            continue;
+        }
+        out = rig_free_index();
+        (void)rig_add_module(moduleType2toOut, out);
+
+        for (uint32_t nth = 0; (io = rig_connector(module, connectorDirIn, nth)) >= 0; nth++) {
+            rig_cable(source, 0, rig[i], (uint32_t)io);
+        }
+        rig_cable(rig[i], (uint32_t)first, out, 0);
+        rig_cable(rig[i], (uint32_t)((second >= 0) ? second : first), out, 1);
+    }
+}
+
+// How many modules the engine plays in slot 0 as it now stands: 0 if it builds no chain at all.
+// Structure only — whether the chain then makes a sound is for the take to show.
+static uint32_t slot_playing(void) {
+    uint32_t modules = 0;
+
+    sound_engine_start_hosted(RIG_PLAN_RATE);
+    sound_engine_update_from_patch();
+
+    if (sscanf(sound_engine_status_text(), "Playing %u", &modules) != 1) {
+        modules = 0;
+    }
+    sound_engine_stop_hosted();
+    return modules;
+}
+
+// How a patch is played: as saved and forced to Poly if it plays as saved, in rigs if it does not, and
+// not at all if nothing in it can be rigged — one "saved" take then stands for the patch, to say so.
+uint32_t rig_plan_takes(const char * path, tRigTake * takes) {
+    uint32_t candidate[MAX_NUM_MODULES];
+    uint32_t candidates = 0;
+    uint32_t count      = 0;
+
+    memset(takes, 0, sizeof(tRigTake) * RIG_MAX_TAKES);
+
+    if ((g2_plugin_load_patch(path, 0) == false) || (slot_playing() > 0)) {
+        snprintf(takes[0].name, sizeof(takes[0].name), "saved");
+        snprintf(takes[1].name, sizeof(takes[1].name), "poly");
+        takes[1].poly = true;
+        return 2;
+    }
+
+    for (uint32_t index = 0; index < MAX_NUM_MODULES; index++) {
+        tModule * module = get_module(((tModuleKey){0, (uint32_t)locationVa, index}));
+
+        if (  (module != NULL) && (is_out_module(module->type) == false)
+           && (rig_connector(module, connectorDirOut, 0) >= 0)) {
+            candidate[candidates++] = index;
+        }
+    }
+
+    // Each module is tried in a rig of its own first, so that one the engine cannot build a chain
+    // through is left out rather than taking three others down with it. One that builds no chain into
+    // an Out — an LFO or a Constant, which the engine does not count as a source — is tried again as
+    // a modulator, and kept if the engine takes it into the chain: three modules playing rather than
+    // the rig's own two.
+    for (uint32_t c = 0; c < candidates; c++) {
+        tRigTake * take      = NULL;
+        bool    modulates = false;
+
+        (void)g2_plugin_load_patch(path, 0);
+        rig_patch(&candidate[c], &modulates, 1);
+
+        if (slot_playing() == 0) {
+            modulates = true;
+            (void)g2_plugin_load_patch(path, 0);
+            rig_patch(&candidate[c], &modulates, 1);
+
+            if (slot_playing() < 3) {
+                continue;
+            }
+        }
+
+        if ((count > 0) && (takes[count - 1].rigCount < RIG_MODULES)) {
+            take = &takes[count - 1];
+        } else if (count < RIG_MAX_TAKES) {
+            take = &takes[count++];
+            snprintf(take->name, sizeof(take->name), "rig%u", count);
+            take->poly   = true;
+            take->rigged = true;
+        } else {
+            break;
+        }
+        take->modulates[take->rigCount] = modulates;
+        take->rig[take->rigCount++]     = candidate[c];
+    }
+
+    if (count == 0) {
+        snprintf(takes[0].name, sizeof(takes[0].name), "saved");
+        takes[0].rigged = true;               // rigged, with nothing to rig
+        return 1;
+    }
+    return count;
+}
+
+bool rig_load_take(const char * path, const tRigTake * take) {
+    if (g2_plugin_load_patch(path, 0) == false) {
+        return false;
+    }
+
+    if ((take->rigged == true) && (take->rigCount > 0)) {
+        rig_patch(take->rig, take->modulates, take->rigCount);
+    }
+
+    if (take->poly == true) {
+        gPatchDescr[0].monoPoly   = monoPolyPoly;
+        gPatchDescr[0].voiceCount = RIG_POLY_VOICES - 1;   // the descriptor holds the count minus one
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/*
+ * patchRig — take a test patch apart into takes the engine can play, for the tools that render them.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PATCH_RIG_H__
+#define __PATCH_RIG_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// TAKES. Most of PatchTestFiles is module catalogues with no cables and no Out, and plays nothing as
+// saved. A tool that renders the test patches plays each one in takes instead: a patch that plays as
+// saved is one take as saved and one forced to four-voice Poly; one that does not is RIGGED — each
+// Voice Area module the engine builds a chain through kept, everything else removed, an OscB at its
+// defaults cabled into every input that is not a logic one, and a 2-Out per module from its first
+// output (and second, for the stereo ones). A module the engine will not take as a source on its own
+// — an LFO, a Constant — modulates an OscB of its own instead, which plays into the Out. Up to
+// RIG_MODULES modules go into one take, named rig1, rig2, ..., each forced to Poly. A patch with
+// nothing that can be rigged is one "saved" take, rigged with no modules: unmodelled. golden.c says
+// why it is done this way.
+//
+// Everything here works in slot 0 of the editor's database, and leaves it holding the take.
+
+#define RIG_MODULES        (4U)             // per take: one per Out the engine sums
+#define RIG_MAX_TAKES      (32U)
+#define RIG_TAKE_NAME      (16U)
+#define RIG_POLY_VOICES    (4U)
+
+// One way of playing a patch. A rig take names the Voice Area modules it keeps; the others play the
+// patch as it is, as saved or forced to Poly.
+typedef struct {
+    char     name[RIG_TAKE_NAME];
+    bool     poly;
+    bool     rigged;
+    uint32_t rigCount;
+    uint32_t rig[RIG_MODULES];
+    bool     modulates[RIG_MODULES];
+} tRigTake;
+
+// The takes the patch at path is played in, into takes, which holds RIG_MAX_TAKES. Returns how many.
+// A patch that does not load is planned as saved and Poly, for the caller to find it does not load.
+uint32_t rig_plan_takes(const char * path, tRigTake * takes);
+
+// Loads the patch at path into slot 0 as take plays it. False if it did not load. An unmodelled take
+// is left as loaded: there is nothing in it to rig.
+bool rig_load_take(const char * path, const tRigTake * take);
+
+#endif // __PATCH_RIG_H__
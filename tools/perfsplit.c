@@ -0,0 +1,402 @@
+/*
+ * perfsplit — a four-slot performance in the engine: which slot each key reaches, and what four slots cost.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// In performance mode the engine builds every enabled slot and routes each note-on to the slots whose
+// keyboard is on and whose key range holds it (slot_takes_note() in soundEngine.c). Every other tool
+// here loads one patch into slot A and never sets perfMode, keyboardRange or keyboardEnabled, so none
+// of that had been run. This loads four patches into the four slots and checks it, then times it:
+//
+//   ROUTING. For each arrangement below, every key from 0 to 127 is played on its own into a freshly
+//   started engine, one block is rendered, and sound_engine_slot_voices_sounding() must be 1 for each
+//   slot that should have taken the key and 0 for every other. What "should" is, is worked out here
+//   from the same settings, not read back from the engine.
+//
+//     split      Keyboard Range on; A 0-47, B 48-59, C 60-71, D 72-127.
+//     layer      Keyboard Range on; A 0-64, B 60-127, C 60-64, D 0-127 with its keyboard off.
+//     no range   Keyboard Range off, so the ranges are ignored; C switched off in the performance.
+//
+//   COST. The split, with --notes keys held in each slot's range (4 by default) at 48 kHz, in ns per
+//   output frame and % of real time; then the same with no slot on, and each slot alone, the same
+//   split with the other three switched off. A performance should cost what no slots cost plus each
+//   slot's share above that, and a figure well above it is work the slots are doing twice.
+//
+// The patches are the first four PatchTestFiles/*.pch2 that load and play a note, or up to four named
+// on the command line; with fewer than four, they fill the slots again in turn. Each is forced to Poly
+// with enough voices for the chord.
+//
+//     ./do-perfsplit
+//     ./perfsplit --notes 8 --seconds 5 PatchTestFiles/SimpleLead.pch2 ... (four of them)
+//
+// Exits non-zero if no patch plays or any key reached the wrong slots.
+//
+// Build: see tools/do-perfsplit. Only libc and libm.
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+
+#define PERFSPLIT_RATE          (48000.0)
+#define PERFSPLIT_BLOCK         (64U)
+#define PERFSPLIT_CHANNELS      (2U)
+#define PERFSPLIT_KEYS          (128U)
+#define PERFSPLIT_MAX_NOTES     (12U)
+#define PERFSPLIT_REPEATS       (5U)
+#define PERFSPLIT_WARMUP        (0.25)      // seconds rendered and thrown away before a run is timed
+#define PERFSPLIT_PATCH_DIR     "PatchTestFiles"
+#define PERFSPLIT_MAX_PATCHES   (256U)
+
+// As golden.c: loading a patch may report to the undo stack and post to the GUI, and there is neither.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// One arrangement of the performance: what the G2's Performance Settings would hold.
+typedef struct {
+    const char * name;
+    bool         keyboardRange;
+    bool         enabled[MAX_SLOTS];
+    bool         keyboard[MAX_SLOTS];
+    uint8_t      lower[MAX_SLOTS];
+    uint8_t      upper[MAX_SLOTS];
+} tArrangement;
+
+static const tArrangement kArrangements[] = {
+    {"split",    true,  {true, true, true,  true},  {true, true, true, true},  {0, 48, 60, 72},  {47, 59, 71, 127}},
+    {"layer",    true,  {true, true, true,  true},  {true, true, true, false}, {0, 60, 60, 0},   {64, 127, 64, 127}},
+    {"no range", false, {true, true, false, true},  {true, true, true, true},  {0, 48, 60, 72},  {47, 59, 71, 127}},
+};
+
+static float gBlock[PERFSPLIT_BLOCK * PERFSPLIT_CHANNELS];
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static bool has_suffix(const char * name, const char * suffix) {
+    size_t n = strlen(name);
+    size_t s = strlen(suffix);
+
+    return (n >= s) && (strcmp(name + n - s, suffix) == 0);
+}
+
+static int compare_names(const void * a, const void * b) {
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+static void set_poly(uint32_t slot, uint32_t voices) {
+    gPatchDescr[slot].monoPoly   = monoPolyPoly;
+    gPatchDescr[slot].voiceCount = (uint8_t)(voices - 1);   // the descriptor holds the count minus one
+}
+
+static void set_patch_mode(uint32_t slot) {
+    atomic_store(&gGlobalSettings.perfMode, 0);
+    atomic_store(&gSlot, slot);
+}
+
+static void set_arrangement(const tArrangement * arrangement) {
+    atomic_store(&gGlobalSettings.perfMode, 1);
+    atomic_store(&gSlot, 0);
+    atomic_store(&gPerfSettings.keyboardRange, arrangement->keyboardRange ? 1 : 0);
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        atomic_store(&gGlobalSettings.slot[slot].enabled, arrangement->enabled[slot] ? 1 : 0);
+        atomic_store(&gPerfSettings.slot[slot].keyboardEnabled, arrangement->keyboard[slot] ? 1 : 0);
+        atomic_store(&gPerfSettings.slot[slot].rangeLower, arrangement->lower[slot]);
+        atomic_store(&gPerfSettings.slot[slot].rangeUpper, arrangement->upper[slot]);
+    }
+}
+
+// The rule, as the instrument has it: a slot the performance has on, with its keyboard on, takes a key
+// inside its range, or any key while Keyboard Range is off.
+static bool expected(const tArrangement * arrangement, uint32_t slot, uint32_t key) {
+    if ((arrangement->enabled[slot] == false) || (arrangement->keyboard[slot] == false)) {
+        return false;
+    }
+    return (arrangement->keyboardRange == false)
+           || ((key >= arrangement->lower[slot]) && (key <= arrangement->upper[slot]));
+}
+
+// A fresh engine, one key down and one block rendered: how many voices each slot is sounding.
+static void play_key(uint32_t key, uint32_t sounding[MAX_SLOTS]) {
+    sound_engine_start_hosted(PERFSPLIT_RATE);
+    sound_engine_pitch_bend(0.0);
+    sound_engine_update_from_patch();
+    sound_engine_note((int32_t)key, true);
+    sound_engine_render(gBlock, PERFSPLIT_BLOCK, PERFSPLIT_CHANNELS);
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        sounding[slot] = sound_engine_slot_voices_sounding(slot);
+    }
+    sound_engine_note(-1, false);
+    sound_engine_stop_hosted();
+}
+
+static uint32_t check_arrangement(const tArrangement * arrangement) {
+    uint32_t failures = 0;
+
+    set_arrangement(arrangement);
+
+    for (uint32_t key = 0; key < PERFSPLIT_KEYS; key++) {
+        uint32_t sounding[MAX_SLOTS];
+
+        play_key(key, sounding);
+
+        for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+            uint32_t want = expected(arrangement, slot, key) ? 1 : 0;
+
+            if (sounding[slot] != want) {
+                if (failures < 8) {
+                    printf("  %s: key %u sounds %u voices in slot %c, expected %u\n", arrangement->name,
+                           (unsigned)key, (unsigned)sounding[slot], 'A' + (int)slot, (unsigned)want);
+                }
+                failures++;
+            }
+        }
+    }
+    printf("%-10s %s\n", arrangement->name, (failures == 0) ? "ok" : "FAILED");
+    return failures;
+}
+
+// The chord a slot holds in the split: notes keys a whole tone apart from the bottom of its range.
+static void split_chord(uint32_t slot, uint32_t notes, int32_t * chord) {
+    for (uint32_t n = 0; n < notes; n++) {
+        uint32_t key = (uint32_t)kArrangements[0].lower[slot] + (n * 2U);
+
+        chord[n] = (int32_t)((key > kArrangements[0].upper[slot]) ? kArrangements[0].upper[slot] : key);
+    }
+}
+
+// Fastest of the repeats, in ns per output frame, with whatever set_*() last chose and chord[slot]
+// held in every slot that takes it.
+static double time_render(uint32_t notes, double seconds) {
+    const uint32_t frames  = (uint32_t)((seconds * PERFSPLIT_RATE) / (double)PERFSPLIT_REPEATS);
+    const uint32_t warmup  = (uint32_t)(PERFSPLIT_WARMUP * PERFSPLIT_RATE);
+    double         fastest = 0.0;
+
+    sound_engine_start_hosted(PERFSPLIT_RATE);
+    sound_engine_pitch_bend(0.0);
+    sound_engine_update_from_patch();
+
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        int32_t chord[PERFSPLIT_MAX_NOTES];
+
+        split_chord(slot, notes, chord);
+
+        for (uint32_t n = 0; n < notes; n++) {
+            sound_engine_note(chord[n], true);
+        }
+    }
+
+    for (uint32_t done = 0; done < warmup; done += PERFSPLIT_BLOCK) {
+        sound_engine_render(gBlock, PERFSPLIT_BLOCK, PERFSPLIT_CHANNELS);
+    }
+
+    for (uint32_t r = 0; r < PERFSPLIT_REPEATS; r++) {
+        double   started = now_seconds();
+        uint32_t done    = 0;
+        double   ns      = 0.0;
+
+        for (done = 0; done < frames; done += PERFSPLIT_BLOCK) {
+            sound_engine_render(gBlock, PERFSPLIT_BLOCK, PERFSPLIT_CHANNELS);
+        }
+        ns      = ((now_seconds() - started) * 1e9) / (double)done;
+        fastest = ((r == 0) || (ns < fastest)) ? ns : fastest;
+    }
+    sound_engine_note(-1, false);
+    sound_engine_stop_hosted();
+
+    return fastest;
+}
+
+static void print_cost(const char * label, const char * name, double ns) {
+    printf("  %-14s %-30s %9.1f ns/frame %6.2f%%\n", label, name, ns, (ns * PERFSPLIT_RATE) / 1e7);
+}
+
+static void bench(char * const * names, uint32_t notes, double seconds) {
+    tArrangement none  = kArrangements[0];
+    double       empty = 0.0;
+    double       slots = 0.0;
+    double       both  = 0.0;
+
+    printf("\ncost, %u keys held per slot at %.0f Hz: ns per output frame and %% of real time\n",
+           (unsigned)notes, PERFSPLIT_RATE);
+
+    // What a buffer costs with nothing playing: the output stage, the decimator and the rest that is
+    // paid once however many slots sound. Each slot alone pays it too, so it is taken off before the
+    // slots are summed.
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        none.enabled[slot] = false;
+    }
+    set_arrangement(&none);
+    empty = time_render(notes, seconds);
+    print_cost("no slots", "", empty);
+
+    // Alone means the same split with the other three switched off in the performance, rather than
+    // patch mode: patch mode would give the slot every key, all four chords, and no patch volume.
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        tArrangement only = kArrangements[0];
+        char         label[16];
+        double       ns   = 0.0;
+
+        for (uint32_t other = 0; other < MAX_SLOTS; other++) {
+            only.enabled[other] = (other == slot);
+        }
+        set_arrangement(&only);
+        ns     = time_render(notes, seconds);
+        slots += ns - empty;
+        snprintf(label, sizeof(label), "slot %c alone", 'A' + (int)slot);
+        print_cost(label, names[slot], ns);
+    }
+    set_arrangement(&kArrangements[0]);
+    both = time_render(notes, seconds);
+    print_cost("expected", "no slots + each slot's share", empty + slots);
+    print_cost("performance", "", both);
+    printf("  %.2fx what was expected\n", both / (empty + slots));
+}
+
+// Loads a patch into a slot and checks, in patch mode, that a key sounds a voice in it. A patch the
+// engine cannot build — nothing it models reaches an Out — would sit in the performance taking no
+// keys, and the routing check would blame the router.
+static bool load_playable(const char * path, uint32_t slot, uint32_t notes) {
+    uint32_t sounding[MAX_SLOTS];
+
+    if (g2_plugin_load_patch(path, slot) == false) {
+        return false;
+    }
+    set_poly(slot, notes);
+    set_patch_mode(slot);
+    play_key(60, sounding);
+
+    return sounding[slot] == 1;
+}
+
+int main(int argc, char ** argv) {
+    char *   names[PERFSPLIT_MAX_PATCHES];
+    char *   chosen[MAX_SLOTS];
+    uint32_t count    = 0;
+    uint32_t playable = 0;
+    uint32_t failures = 0;
+    uint32_t notes    = 4;
+    double   seconds  = 2.0;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--notes") == 0) && ((i + 1) < argc)) {
+            notes = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = strtod(argv[++i], NULL);
+        } else if ((argv[i][0] == '-') || (count >= PERFSPLIT_MAX_PATCHES)) {
+            fprintf(stderr, "usage: %s [--notes N] [--seconds S] [a.pch2 b.pch2 c.pch2 d.pch2]\n"
+                            "  Checks a four-slot performance's key routing and times it.\n", argv[0]);
+            return 126;
+        } else {
+            names[count++] = strdup(argv[i]);
+        }
+    }
+
+    if ((notes < 1) || (notes > PERFSPLIT_MAX_NOTES) || !(seconds > 0.0)) {
+        fprintf(stderr, "perfsplit: --notes is 1..%u and --seconds above 0\n", (unsigned)PERFSPLIT_MAX_NOTES);
+        return 126;
+    }
+
+    if (count == 0) {
+        DIR *           handle = opendir(PERFSPLIT_PATCH_DIR);
+        struct dirent * entry  = NULL;
+
+        if (handle != NULL) {
+            while (((entry = readdir(handle)) != NULL) && (count < PERFSPLIT_MAX_PATCHES)) {
+                if (has_suffix(entry->d_name, ".pch2")) {
+                    char * full = malloc(strlen(PERFSPLIT_PATCH_DIR) + strlen(entry->d_name) + 2);
+
+                    sprintf(full, "%s/%s", PERFSPLIT_PATCH_DIR, entry->d_name);
+                    names[count++] = full;
+                }
+            }
+            closedir(handle);
+        }
+        qsort(names, count, sizeof(names[0]), compare_names);
+    }
+
+    for (uint32_t p = 0; (p < count) && (playable < MAX_SLOTS); p++) {
+        if (load_playable(names[p], playable, notes) == true) {
+            chosen[playable++] = names[p];
+        } else {
+            printf("        %s does not load or play, skipped\n", names[p]);
+        }
+    }
+
+    if (playable == 0) {
+        fprintf(stderr, "perfsplit: no playable patches (run from the repository root, or name them)\n");
+        return 126;
+    }
+
+    // Fewer than four play — PatchTestFiles has two — so the rest of the slots take them again, in
+    // turn. Routing is decided per slot, not per patch, so a patch in two slots tests as much.
+    for (uint32_t slot = 0; slot < MAX_SLOTS; slot++) {
+        if (slot >= playable) {
+            chosen[slot] = chosen[slot % playable];
+
+            if (load_playable(chosen[slot], slot, notes) == false) {
+                fprintf(stderr, "perfsplit: %s played in slot %c but not in slot %c\n", chosen[slot],
+                        'A' + (int)(slot % playable), 'A' + (int)slot);
+                return 126;
+            }
+        }
+        printf("slot %c  %s\n", 'A' + (int)slot, chosen[slot]);
+    }
+    printf("\n");
+
+    for (uint32_t a = 0; a < (sizeof(kArrangements) / sizeof(kArrangements[0])); a++) {
+        failures += check_arrangement(&kArrangements[a]);
+    }
+    bench(chosen, notes, seconds);
+    printf("\n%u routing failures\n", (unsigned)failures);
+
+    for (uint32_t p = 0; p < count; p++) {
+        free(names[p]);
+    }
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,349 @@
+/*
+ * precision — render the test patches through the engine and compare a float build with a double one.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// soundEngine.c carries audio between its nodes in g2_sample_t, which G2_ENGINE_SINGLE_PRECISION makes
+// float or double at build time. The question a float build raises is how far its output lands from
+// the double one, and the only honest answer is to play the same notes through the same patches in
+// both and look. tools/do-precision builds this file twice, once per setting, and runs:
+//
+//     ./precision-double --render dirA             every PatchTestFiles/*.pch2, one .f32 file per take
+//     ./precision-single --render dirB
+//     ./precision-double --compare dirA dirB       worst deviation per take, and over all of them
+//
+// --render also takes patch paths after the directory, to render just those.
+//
+// THE TAKES are golden.c's (tools/patchRig.h): a patch that plays as saved is rendered as saved and
+// forced to Poly, and one that does not — most of PatchTestFiles, module catalogues with no Out — is
+// rigged, its modules given a source and an Out, a few to a take. So every module the engine builds
+// is heard in one build against the other, not just the two patches that happen to be wired up.
+//
+// THE PERFORMANCE. Four notes struck 50 ms apart, held, then released together and left to ring out,
+// so each take goes through its attack, its sustain and the tail of whatever FX it has.
+//
+// The deviation is quoted as an absolute peak, in dB relative to the reference render's own peak, and
+// as an error energy relative to the reference's energy. A patch that fails to load is listed and
+// skipped (PatchTestFiles holds a deliberately corrupt one), and so is one with nothing in it the
+// engine models. A take silent in both builds is listed, and fails the comparison: a rig exists so
+// that none is.
+//
+// Build: see tools/do-precision.
+
+#include <dirent.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+#include "patchRig.h"
+
+#ifndef G2_ENGINE_SINGLE_PRECISION
+#define G2_ENGINE_SINGLE_PRECISION    (0)
+#endif
+
+#define PREC_RATE           (48000.0)
+#define PREC_BLOCK          (256U)
+#define PREC_STAGGER        (2400U)          // 50 ms between notes
+#define PREC_HOLD           (72000U)         // 1.5 s from the first note to the release
+#define PREC_TAIL           (72000U)         // 1.5 s after it
+#define PREC_FRAMES         (PREC_HOLD + PREC_TAIL)
+#define PREC_CHANNELS       (2U)
+#define PREC_PATCH_DIR      "PatchTestFiles"
+#define PREC_MAX_PATCHES    (256U)
+#define PREC_PATH           (1024U)
+
+// Loading a patch goes through protocol.c, which reports a linked-variation edit to the undo stack and
+// may post to the GUI. There is neither here; these are the two references the link needs, as in
+// fxbench.c.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+static float gRender[PREC_FRAMES * PREC_CHANNELS];
+static float gOther[PREC_FRAMES * PREC_CHANNELS];
+
+static const char * base_name(const char * path) {
+    const char * slash = strrchr(path, '/');
+
+    return (slash != NULL) ? (slash + 1) : path;
+}
+
+static bool has_suffix(const char * name, const char * suffix) {
+    size_t nameLength   = strlen(name);
+    size_t suffixLength = strlen(suffix);
+
+    return (nameLength > suffixLength) && (strcmp(name + nameLength - suffixLength, suffix) == 0);
+}
+
+static int compare_names(const void * a, const void * b) {
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+// Every file in `dir` ending in `suffix`, sorted so two runs list them in the same order.
+static uint32_t list_files(const char * dir, const char * suffix, char ** names) {
+    DIR *           handle = opendir(dir);
+    struct dirent * entry  = NULL;
+    uint32_t        count  = 0;
+
+    if (handle == NULL) {
+        return 0;
+    }
+
+    while (((entry = readdir(handle)) != NULL) && (count < PREC_MAX_PATCHES)) {
+        if (has_suffix(entry->d_name, suffix)) {
+            names[count++] = strdup(entry->d_name);
+        }
+    }
+    closedir(handle);
+    qsort(names, count, sizeof(names[0]), compare_names);
+    return count;
+}
+
+// One take, one performance, into gRender. The engine is started fresh for each so that no take
+// inherits another's delay lines or reverb tail.
+static bool render_take(const char * path, const tRigTake * take) {
+    static const int32_t chord[] = {48, 55, 60, 64};
+    const uint32_t       notes   = sizeof(chord) / sizeof(chord[0]);
+    uint32_t             frame   = 0;
+
+    if (rig_load_take(path, take) == false) {
+        return false;
+    }
+    sound_engine_start_hosted(PREC_RATE);
+    sound_engine_update_from_patch();
+
+    while (frame < PREC_FRAMES) {
+        uint32_t count = PREC_BLOCK;
+
+        // Events land on block boundaries; the stagger and the hold are both whole blocks near enough,
+        // and it is the same in both builds, which is all that matters here.
+        for (uint32_t k = 0; k < notes; k++) {
+            uint32_t on = k * PREC_STAGGER;
+
+            if ((frame <= on) && (on < (frame + count))) {
+                sound_engine_note(chord[k], true);
+            }
+        }
+
+        if ((frame <= PREC_HOLD) && (PREC_HOLD < (frame + count))) {
+            for (uint32_t k = 0; k < notes; k++) {
+                sound_engine_note(chord[k], false);
+            }
+        }
+
+        if ((frame + count) > PREC_FRAMES) {
+            count = PREC_FRAMES - frame;
+        }
+        sound_engine_render(&gRender[frame * PREC_CHANNELS], count, PREC_CHANNELS);
+        frame += count;
+    }
+    sound_engine_stop_hosted();
+    return true;
+}
+
+static bool write_floats(const char * path, const float * data, size_t count) {
+    FILE * file = fopen(path, "wb");
+    bool   ok   = false;
+
+    if (file == NULL) {
+        return false;
+    }
+    ok = (fwrite(data, sizeof(data[0]), count, file) == count);
+    return (fclose(file) == 0) && ok;
+}
+
+static bool read_floats(const char * path, float * data, size_t count) {
+    FILE * file = fopen(path, "rb");
+    bool   ok   = false;
+
+    if (file == NULL) {
+        return false;
+    }
+    ok = (fread(data, sizeof(data[0]), count, file) == count);
+    fclose(file);
+    return ok;
+}
+
+static int render_all(const char * outDir, int patchCount, char ** patchPaths) {
+    static tRigTake plan[RIG_MAX_TAKES];
+    char *          names[PREC_MAX_PATCHES];
+    char            path[PREC_PATH];
+    char            out[PREC_PATH * 4];
+    char            label[PREC_PATH * 2];
+    uint32_t        count    = 0;
+    uint32_t        rendered = 0;
+
+    if (patchCount > 0) {
+        count = ((uint32_t)patchCount < PREC_MAX_PATCHES) ? (uint32_t)patchCount : PREC_MAX_PATCHES;
+
+        for (uint32_t i = 0; i < count; i++) {
+            names[i] = strdup(patchPaths[i]);
+        }
+    } else {
+        count = list_files(PREC_PATCH_DIR, ".pch2", names);
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "precision: no patches (run from the repository root, or name them)\n");
+        return 1;
+    }
+    printf("%s build, %u frames at %.0f Hz per take\n",
+           G2_ENGINE_SINGLE_PRECISION ? "single-precision" : "double-precision", PREC_FRAMES, PREC_RATE);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (patchCount > 0) {
+            snprintf(path, sizeof(path), "%s", names[i]);
+        } else {
+            snprintf(path, sizeof(path), "%s/%s", PREC_PATCH_DIR, names[i]);
+        }
+        uint32_t takes = rig_plan_takes(path, plan);
+
+        for (uint32_t t = 0; t < takes; t++) {
+            snprintf(label, sizeof(label), "%s.%.*s", base_name(path), (int)sizeof(plan[t].name), plan[t].name);
+            snprintf(out, sizeof(out), "%s/%s.f32", outDir, label);
+
+            if ((plan[t].rigged == true) && (plan[t].rigCount == 0)) {
+                printf("  %-32s nothing the engine models, skipped\n", label);
+            } else if (render_take(path, &plan[t]) == false) {
+                printf("  %-32s did not load, skipped\n", label);
+                break;
+            } else if (write_floats(out, gRender, PREC_FRAMES * PREC_CHANNELS) == false) {
+                fprintf(stderr, "precision: could not write %s\n", out);
+                return 1;
+            } else {
+                printf("  %-32s %s\n", label, out);
+                rendered++;
+            }
+        }
+        free(names[i]);
+    }
+    return (rendered > 0) ? 0 : 1;
+}
+
+static double to_db(double ratio) {
+    return (ratio > 0.0) ? (20.0 * log10(ratio)) : -INFINITY;
+}
+
+static int compare_all(const char * refDir, const char * testDir) {
+    char *   names[PREC_MAX_PATCHES];
+    char     refPath[PREC_PATH * 2];
+    char     testPath[PREC_PATH * 2];
+    char     worst[PREC_PATH] = "";
+    uint32_t count            = list_files(refDir, ".f32", names);
+    double   worstDb          = -INFINITY;
+    uint32_t compared         = 0;
+    uint32_t silent           = 0;
+
+    if (count == 0) {
+        fprintf(stderr, "precision: no renders in %s\n", refDir);
+        return 1;
+    }
+    printf("%-36s %10s %12s %10s %10s\n", "take", "ref peak", "max |diff|", "dB re pk", "err dB");
+
+    for (uint32_t i = 0; i < count; i++) {
+        double peak      = 0.0;
+        double maxDiff   = 0.0;
+        double energy    = 0.0;
+        double errEnergy = 0.0;
+        double peakDb    = 0.0;
+
+        snprintf(refPath, sizeof(refPath), "%s/%s", refDir, names[i]);
+        snprintf(testPath, sizeof(testPath), "%s/%s", testDir, names[i]);
+
+        if ((read_floats(refPath, gRender, PREC_FRAMES * PREC_CHANNELS) == false) ||
+            (read_floats(testPath, gOther, PREC_FRAMES * PREC_CHANNELS) == false)) {
+            printf("%-36s missing or short in one of the two, skipped\n", names[i]);
+            free(names[i]);
+            continue;
+        }
+
+        for (uint32_t s = 0; s < (PREC_FRAMES * PREC_CHANNELS); s++) {
+            double ref  = (double)gRender[s];
+            double diff = (double)gOther[s] - ref;
+
+            peak       = fmax(peak, fabs(ref));
+            maxDiff    = fmax(maxDiff, fabs(diff));
+            energy    += ref * ref;
+            errEnergy += diff * diff;
+        }
+        // Says nothing about precision, and should not happen: a take that plays nothing as saved is
+        // rigged until it does.
+        if ((peak == 0.0) && (maxDiff == 0.0)) {
+            printf("%-36s silent in both  FAIL\n", names[i]);
+            silent++;
+            free(names[i]);
+            continue;
+        }
+        peakDb = (peak > 0.0) ? to_db(maxDiff / peak) : to_db(maxDiff);
+
+        printf("%-36s %10.6f %12.3e %10.1f %10.1f\n", names[i], peak, maxDiff, peakDb,
+               (energy > 0.0) ? (10.0 * log10(fmax(errEnergy, 1e-300) / energy)) : 0.0);
+
+        if (peakDb > worstDb) {
+            worstDb = peakDb;
+            snprintf(worst, sizeof(worst), "%s", names[i]);
+        }
+        compared++;
+        free(names[i]);
+    }
+
+    if (compared == 0) {
+        fprintf(stderr, "precision: nothing to compare between %s and %s\n", refDir, testDir);
+        return 1;
+    }
+    printf("worst: %s at %.1f dB re its peak, over %u takes\n", worst, worstDb, compared);
+    return (silent > 0) ? 1 : 0;
+}
+
+int main(int argc, char ** argv) {
+    if ((argc >= 3) && (strcmp(argv[1], "--render") == 0)) {
+        return render_all(argv[2], argc - 3, argv + 3);
+    }
+
+    if ((argc == 4) && (strcmp(argv[1], "--compare") == 0)) {
+        return compare_all(argv[2], argv[3]);
+    }
+    fprintf(stderr,
+            "usage: %s --render dir [patch.pch2 ...]\n"
+            "       %s --compare refDir testDir\n"
+            "  Renders the test patches through this build of the engine, or compares two sets of renders.\n",
+            argv[0], argv[0]);
+    return 2;
+}
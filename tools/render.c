@@ -40,6 +40,16 @@
 // Rendered at the ENGINE's own rate (96 kHz for a 48 kHz device), so a lag is the same integer as in
 // the hardware tables and no rescaling stands between the two sets of numbers.
 //
+// --csv f.csv RENDERS THE WHOLE ENGINE INSTEAD, to dump its callback-time histogram (sound_engine_
+// timing_histogram()) one row per bucket, for plotting the distribution rather than reading three
+// points off it. It loads a patch, holds a chord, and calls sound_engine_render() back to back for
+// --seconds of --block frames, the first second discarded as fxbench does; the engine's percentiles
+// and miss count are printed beside it. Unpaced, so it is the engine's cost and nothing else — whether
+// a device keeps up with it is soak's question.
+//
+//     ./render --csv times.csv                          SimpleLead, 256-frame blocks, 5 s
+//     ./render --csv times.csv --patch f.pch2 --block 64 --seconds 20
+//
 // Build: see tools/do-render, which links the engine's headless dependency set.
 
 #include <stdbool.h>
@@ -47,11 +57,35 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
 #include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
 
 #define RENDER_DEVICE_RATE    (48000.0)   // engine runs at twice this; see sound_engine_render_reverb_ir
 #define RENDER_CHANNELS       (4)
+#define RENDER_MAX_BLOCK      (4096U)
+
+// Loading a patch for --csv goes through protocol.c, which reports a linked-variation edit to the undo
+// stack and may post to the GUI. There is neither here; these are the two references the link needs,
+// the same two fxbench answers.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
 
 static void put32(FILE * f, uint32_t v) {
     fputc((int)(v & 0xFF), f);
@@ -139,6 +173,74 @@ static bool write_sidecar(const char * wavPath, const char * sweep, const int *
     return true;
 }
 
+// --csv: the engine's callbacks, timed by the engine itself, written as its histogram.
+static int render_timing_csv(const char * csvPath, const char * patchPath, uint32_t block, double seconds) {
+    static float          buffer[RENDER_MAX_BLOCK * 2];
+    static const uint32_t chord[]  = {48, 55, 60, 64, 67, 71};
+    uint32_t              warmup   = (uint32_t)(RENDER_DEVICE_RATE / block);
+    uint32_t              calls    = (uint32_t)((seconds * RENDER_DEVICE_RATE) / block);
+    tSoundEngineTiming    timing   = {0};
+    uint64_t              counts[SOUND_ENGINE_TIMING_BUCKETS];
+    double                upperUs[SOUND_ENGINE_TIMING_BUCKETS];
+    FILE *                file     = NULL;
+
+    if ((block == 0) || (block > RENDER_MAX_BLOCK) || (calls == 0)) {
+        fprintf(stderr, "error: --block must be 1..%u and --seconds positive\n", RENDER_MAX_BLOCK);
+        return 2;
+    }
+
+    if (g2_plugin_load_patch(patchPath, 0) == false) {
+        fprintf(stderr, "error: could not load %s\n", patchPath);
+        return 1;
+    }
+    sound_engine_start_hosted(RENDER_DEVICE_RATE);
+    sound_engine_update_from_patch();
+
+    for (uint32_t i = 0; i < (sizeof(chord) / sizeof(chord[0])); i++) {
+        sound_engine_note(chord[i], true);
+    }
+
+    for (uint32_t call = 0; call < (warmup + calls); call++) {
+        if (call == warmup) {
+            sound_engine_timing_reset(0);
+        }
+        sound_engine_render(buffer, block, 2);
+    }
+
+    for (uint32_t i = 0; i < (sizeof(chord) / sizeof(chord[0])); i++) {
+        sound_engine_note(chord[i], false);
+    }
+    sound_engine_timing_stats(&timing);
+    sound_engine_timing_histogram(counts, upperUs);
+    sound_engine_stop_hosted();
+
+    printf("%s, %u-frame blocks (period %.1f us), %llu callbacks\n", patchPath, block, timing.periodUs,
+           (unsigned long long)timing.callbacks);
+    printf("p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us, %llu over %u %% of the period\n",
+           timing.p50Us, timing.p90Us, timing.p99Us, timing.p999Us, timing.maxUs,
+           (unsigned long long)timing.misses, timing.missPercent);
+
+    file = fopen(csvPath, "w");
+
+    if (file == NULL) {
+        fprintf(stderr, "error: cannot write %s\n", csvPath);
+        return 1;
+    }
+    // Empty buckets are kept, so two dumps always have the same rows.
+    fprintf(file, "bucket,upper_us,callbacks\n");
+
+    for (uint32_t b = 0; b < SOUND_ENGINE_TIMING_BUCKETS; b++) {
+        fprintf(file, "%u,%.3f,%llu\n", b, upperUs[b], (unsigned long long)counts[b]);
+    }
+
+    if (fclose(file) != 0) {
+        fprintf(stderr, "error: cannot write %s\n", csvPath);
+        return 1;
+    }
+    printf("wrote %s\n", csvPath);
+    return 0;
+}
+
 int main(int argc, char ** argv) {
     const char * outPath  = "engine.wav";
     const char * sweep    = "type";
@@ -147,6 +249,10 @@ int main(int argc, char ** argv) {
     int          timeValue = 127;
     int          bright    = 64;
     double       period    = 20.0;      // seconds per impulse; must exceed the decay being measured
+    const char * csvPath   = NULL;
+    const char * patchPath = "PatchTestFiles/SimpleLead.pch2";
+    uint32_t     block     = 256;
+    double       seconds   = 5.0;
 
     for (int i = 1; i < argc; i++) {
         if ((strcmp(argv[i], "--out") == 0) && ((i + 1) < argc)) {
@@ -163,19 +269,33 @@ int main(int argc, char ** argv) {
             bright = atoi(argv[++i]);
         } else if ((strcmp(argv[i], "--period") == 0) && ((i + 1) < argc)) {
             period = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--csv") == 0) && ((i + 1) < argc)) {
+            csvPath = argv[++i];
+        } else if ((strcmp(argv[i], "--patch") == 0) && ((i + 1) < argc)) {
+            patchPath = argv[++i];
+        } else if ((strcmp(argv[i], "--block") == 0) && ((i + 1) < argc)) {
+            block = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
         } else {
             fprintf(stderr,
                     "usage: %s [--out f.wav] [--sweep type|time|bright] [--settings 0,1,2,3]\n"
                     "          [--type N] [--time N] [--bright N] [--period S]\n"
+                    "       %s --csv f.csv [--patch f.pch2] [--block frames] [--seconds n]\n"
                     "\n"
                     "Renders the engine's reverb impulse response into a file shaped like a hardware\n"
                     "capture, so analyse_ir.py compares the two directly. --sweep names which of the\n"
-                    "three the --settings list steps; the other two are held at --type/--time/--bright.\n",
-                    argv[0]);
+                    "three the --settings list steps; the other two are held at --type/--time/--bright.\n"
+                    "With --csv, renders a patch instead and writes the engine's callback-time histogram.\n",
+                    argv[0], argv[0]);
             return 2;
         }
     }
 
+    if (csvPath != NULL) {
+        return render_timing_csv(csvPath, patchPath, block, seconds);
+    }
+
     if ((strcmp(sweep, "type") != 0) && (strcmp(sweep, "time") != 0) && (strcmp(sweep, "bright") != 0)) {
         fprintf(stderr, "error: --sweep must be type, time or bright\n");
         return 2;
@@ -218,10 +338,20 @@ int main(int argc, char ** argv) {
         int useTime   = (strcmp(sweep, "time") == 0) ? values[s] : timeValue;
         int useBright = (strcmp(sweep, "bright") == 0) ? values[s] : bright;
 
+        // TIMED, because this is the reverb kernel and nothing else: no voices, no smoothing, no
+        // output stage. The figure is the per-sample cost of reverb_step() at the engine's rate, and
+        // it is the number to quote before and after touching that function.
+        struct timespec started = {0};
+        struct timespec stopped = {0};
+
+        clock_gettime(CLOCK_MONOTONIC, &started);
         sound_engine_render_reverb_ir(RENDER_DEVICE_RATE, (uint32_t)useType, (uint32_t)useTime,
                                       (uint32_t)useBright, wet, (uint32_t)perSetting);
+        clock_gettime(CLOCK_MONOTONIC, &stopped);
 
-        double peak = 0.0;
+        double elapsed = (double)(stopped.tv_sec - started.tv_sec)
+                         + ((double)(stopped.tv_nsec - started.tv_nsec) / 1e9);
+        double peak    = 0.0;
 
         for (size_t i = 0; i < perSetting; i++) {
             size_t at = ((size_t)s * perSetting) + i;
@@ -237,8 +367,8 @@ int main(int argc, char ** argv) {
                 peak = wet[i * 2];
             }
         }
-        printf("  %s = %-3d  (type %d, time %d, bright %d)  wet peak %.4f\n",
-               sweep, values[s], useType, useTime, useBright, peak);
+        printf("  %s = %-3d  (type %d, time %d, bright %d)  wet peak %.4f  %.1f ns/sample\n",
+               sweep, values[s], useType, useTime, useBright, peak, (elapsed * 1e9) / (double)perSetting);
     }
 
     if (!write_wav32(outPath, file, frames, RENDER_CHANNELS, engineRate)) {
@@ -0,0 +1,310 @@
+/*
+ * soak — run the engine on a clocked null device for minutes while other threads edit, morph and play.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// Every other tool here calls sound_engine_render() from its own loop, one thread, nothing else going
+// on. The application is never like that: the audio callback arrives on its own clock while the UI
+// thread rebuilds the parameter snapshot on every edit, the MIDI thread rebuilds it on every mod wheel
+// move, and notes land from both. The seqlock between them (soundEngine.c, read_params()) is the part
+// with no other test, and a torn read there is a click once a week, not a failure anyone can repeat.
+//
+// So this runs the real arrangement for as long as asked, on tools/audioOutputNull.c — a device thread
+// on an absolute clock_nanosleep() schedule — with four threads leaning on the engine meanwhile:
+//
+//     editor   writes a parameter of a random module, as a dial drag does, and rebuilds the snapshot
+//     morph    moves a random morph group, as midiInput.c does for the mod wheel, and rebuilds
+//     notes ×2 strike and release random notes and bend the pitch, through the MPSC note queue
+//
+// The editor only ever writes a value the same parameter already has in one of the patch's
+// variations, so every value it writes is one the module can take.
+//
+// At the end it reports the engine's callback-time percentiles, the deadlines missed, the device's late
+// wakes, and the snapshot check's count (sound_engine_set_snapshot_check()): reads the seqlock passed
+// that did not match what was published. A deadline is missed three ways: a render that took longer
+// than the period, a wake a whole period or more after its deadline, and each period that wake jumped
+// over, which a real device would have played as silence. Torn snapshots and the last two are audible
+// and make the exit status 1 on their own. Render misses depend on the machine as much as the engine,
+// so they only count against --max-misses, which bounds the total.
+//
+//     ./soak                                            SimpleLead, 256-frame blocks, one minute
+//     ./soak --minutes 30 --block 64 --realtime         what a release should survive
+//     ./soak --seconds 20 --patch f.pch2 --max-misses 0
+//
+// --realtime asks for SCHED_FIFO, which needs root or an rtprio limit (ulimit -r). Without it the
+// device thread runs at normal priority, which is fine for finding torn snapshots and pessimistic for
+// misses; the report says which it got.
+//
+// Build: see tools/do-soak.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "moduleResourcesAccess.h"
+#include "../src/soundEngine.h"
+#include "../src/audioOutput.h"
+#include "audioOutputNull.h"
+#include "../src/rtLog.h"
+#include "../vst3/g2Patch.h"
+
+#define SOAK_EDIT_US       (250U)     // between parameter writes
+#define SOAK_MORPH_US      (500U)     // between morph moves: a fast mod wheel
+#define SOAK_NOTE_MIN_MS   (5U)
+#define SOAK_NOTE_MAX_MS   (120U)
+
+// The same two references fxbench answers, for the same reason. Nothing here goes through protocol.c's
+// edit path — the editor thread writes the database directly, as a dial drag does before it sends.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// What vst3/g2HostIo.c would answer; that file also carries an audio_output_start(), so this tool links
+// audioOutputNull.c instead of it.
+uint32_t midi_input_connected_count(void) {
+    return 0;
+}
+
+uint32_t midi_input_pressure_count(void) {
+    return 0;
+}
+
+static _Atomic bool     gSoaking = false;
+static _Atomic uint64_t gEdits   = 0;
+static _Atomic uint64_t gMorphs  = 0;
+static _Atomic uint64_t gNotes   = 0;
+
+static void sleep_us(uint32_t us) {
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(us / 1000000U);
+    ts.tv_nsec = (long)(us % 1000000U) * 1000L;
+    (void)nanosleep(&ts, NULL);
+}
+
+static uint32_t random_below(uint32_t * seed, uint32_t limit) {
+    return (limit > 0) ? ((uint32_t)rand_r(seed) % limit) : 0;
+}
+
+// One parameter write, as canvasDrag.c makes it: the value goes into the active variation and the
+// snapshot is rebuilt. Modules are picked by slot index, so empty ones are just a miss.
+static void * editor_thread(void * unused) {
+    uint32_t seed = 1;
+
+    (void)unused;
+
+    while (atomic_load(&gSoaking) == true) {
+        uint32_t  location = random_below(&seed, 2) ? (uint32_t)locationVa : (uint32_t)locationFx;
+        tModule * module   = get_module_slot(0, location, random_below(&seed, MAX_NUM_MODULES));
+
+        if ((module != NULL) && (module->active == true)) {
+            uint32_t params = module_param_count(module->type);
+
+            if (params > 0) {
+                uint32_t param     = random_below(&seed, params);
+                uint32_t variation = gPatchDescr[0].activeVariation;
+
+                module->param[variation][param].value = module->param[random_below(&seed, NUM_VARIATIONS)][param].value;
+                sound_engine_update_from_patch();
+                atomic_fetch_add(&gEdits, 1);
+            }
+        }
+        sleep_us(SOAK_EDIT_US);
+    }
+    return NULL;
+}
+
+static void * morph_thread(void * unused) {
+    uint32_t seed = 2;
+
+    (void)unused;
+
+    while (atomic_load(&gSoaking) == true) {
+        if (sound_engine_set_morph(random_below(&seed, NUM_MORPHS), (double)random_below(&seed, 128) / 127.0) == true) {
+            sound_engine_update_from_patch();
+        }
+        atomic_fetch_add(&gMorphs, 1);
+        sleep_us(SOAK_MORPH_US);
+    }
+    return NULL;
+}
+
+// Each note thread holds one note at a time, so everything it strikes it also releases.
+static void * note_thread(void * arg) {
+    uint32_t seed = 3 + (uint32_t)(uintptr_t)arg;
+
+    while (atomic_load(&gSoaking) == true) {
+        int32_t note = 36 + (int32_t)random_below(&seed, 49);
+
+        sound_engine_note(note, true);
+        sound_engine_pitch_bend(((double)random_below(&seed, 201) / 100.0) - 1.0);
+        sleep_us(1000U * (SOAK_NOTE_MIN_MS + random_below(&seed, SOAK_NOTE_MAX_MS - SOAK_NOTE_MIN_MS)));
+        sound_engine_note(note, false);
+        atomic_fetch_add(&gNotes, 1);
+    }
+    return NULL;
+}
+
+int main(int argc, char ** argv) {
+    const char *       patchPath = "PatchTestFiles/SimpleLead.pch2";
+    double             seconds   = 60.0;
+    double             rate      = 48000.0;
+    uint32_t           block     = 256;
+    bool               realtime  = false;
+    long long          maxMisses = -1;
+    pthread_t          threads[4];
+    tSoundEngineTiming timing    = {0};
+    tAudioNullStats    device    = {0};
+    uint64_t           torn      = 0;
+    uint64_t           dropped   = 0;
+    uint64_t           missed    = 0;
+    uint32_t           elapsed   = 0;
+    int                result    = 0;
+    int                i         = 0;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--patch") == 0) && ((i + 1) < argc)) {
+            patchPath = argv[++i];
+        } else if ((strcmp(argv[i], "--minutes") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]) * 60.0;
+        } else if ((strcmp(argv[i], "--seconds") == 0) && ((i + 1) < argc)) {
+            seconds = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--block") == 0) && ((i + 1) < argc)) {
+            block = (uint32_t)atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--rate") == 0) && ((i + 1) < argc)) {
+            rate = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "--max-misses") == 0) && ((i + 1) < argc)) {
+            maxMisses = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [--patch f.pch2] [--minutes n | --seconds n] [--block frames] [--rate hz] [--realtime] [--max-misses n]\n"
+                    "  Plays the engine on a clocked null device while other threads edit, morph and play notes.\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if ((block == 0) || (block > 8192) || (seconds < 1.0) || (rate < 8000.0)) {
+        fprintf(stderr, "soak: --block must be 1..8192, --seconds at least 1 and --rate at least 8000\n");
+        return 2;
+    }
+
+    if (g2_plugin_load_patch(patchPath, 0) == false) {
+        fprintf(stderr, "soak: could not load %s\n", patchPath);
+        return 1;
+    }
+    rt_log_start();
+    audio_output_null_configure(rate, realtime);
+    audio_output_select_buffer_frames(block);
+    sound_engine_set_snapshot_check(true);
+    sound_engine_update_from_patch();
+
+    if (sound_engine_start() == false) {
+        fprintf(stderr, "soak: the null device did not start\n");
+        rt_log_stop();
+        return 1;
+    }
+    atomic_store(&gSoaking, true);
+    pthread_create(&threads[0], NULL, editor_thread, NULL);
+    pthread_create(&threads[1], NULL, morph_thread, NULL);
+    pthread_create(&threads[2], NULL, note_thread, (void *)(uintptr_t)0);
+    pthread_create(&threads[3], NULL, note_thread, (void *)(uintptr_t)1);
+
+    // A line a minute, so a long run shows it is alive and a failure can be placed in time.
+    for (elapsed = 0; elapsed < (uint32_t)seconds; elapsed++) {
+        sleep_us(1000000U);
+
+        if ((((elapsed + 1) % 60) == 0) && ((elapsed + 1) < (uint32_t)seconds)) {
+            sound_engine_timing_stats(&timing);
+            audio_output_null_stats(&device);
+            printf("%4u min: %llu callbacks, %llu missed, %llu torn\n", (elapsed + 1) / 60,
+                   (unsigned long long)timing.callbacks,
+                   (unsigned long long)(timing.misses + device.overrunWakes + device.skippedPeriods),
+                   (unsigned long long)sound_engine_torn_snapshots());
+            fflush(stdout);
+        }
+    }
+    atomic_store(&gSoaking, false);
+
+    for (i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    sound_engine_timing_stats(&timing);
+    audio_output_null_stats(&device);
+    torn    = sound_engine_torn_snapshots();
+    dropped = device.overrunWakes + device.skippedPeriods;
+    missed  = timing.misses + dropped;
+    sound_engine_stop();
+    sound_engine_set_snapshot_check(false);
+    rt_log_stop();
+
+    printf("%s, %u-frame blocks at %.0f Hz (period %.1f us), %.0f s, %s\n",
+           patchPath, block, rate, timing.periodUs, seconds, device.realtime ? "SCHED_FIFO" : "normal priority");
+    printf("callbacks  %llu (device %llu), p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+           (unsigned long long)timing.callbacks, (unsigned long long)device.callbacks,
+           timing.p50Us, timing.p99Us, timing.p999Us, timing.maxUs);
+    printf("deadlines  %llu missed: %llu renders over the period, %llu wakes past it, %llu skipped periods\n",
+           (unsigned long long)missed, (unsigned long long)timing.misses,
+           (unsigned long long)device.overrunWakes, (unsigned long long)device.skippedPeriods);
+    printf("wakes      %llu late, worst %.1f us late\n", (unsigned long long)device.lateWakes, device.worstWakeUs);
+    printf("traffic    %llu edits, %llu morph moves, %llu notes\n",
+           (unsigned long long)atomic_load(&gEdits), (unsigned long long)atomic_load(&gMorphs),
+           (unsigned long long)atomic_load(&gNotes));
+    printf("snapshots  %llu torn, %llu stale\n", (unsigned long long)torn,
+           (unsigned long long)sound_engine_stale_snapshots());
+
+    if (torn > 0) {
+        printf("FAIL: torn snapshots reached the audio thread\n");
+        result = 1;
+    }
+
+    if (dropped > 0) {
+        printf("FAIL: the device woke a period late %llu times and skipped %llu periods\n",
+               (unsigned long long)device.overrunWakes, (unsigned long long)device.skippedPeriods);
+        result = 1;
+    }
+
+    if ((maxMisses >= 0) && (missed > (uint64_t)maxMisses)) {
+        printf("FAIL: %llu deadline misses, more than %lld\n", (unsigned long long)missed, maxMisses);
+        result = 1;
+    }
+    return result;
+}
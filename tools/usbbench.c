@@ -0,0 +1,597 @@
+/*
+ * usbbench — time the USB transport against a simulated G2.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// src/usbTransport.c moves every message to and from the G2. This times a request and its reply —
+// the shape of nearly all of the editor's traffic — through it, against a simulated device, and
+// through the path it replaced, against the same device:
+//
+//   PER-CALL   what usbComms.c used to do: allocate a transfer, submit it, run the event loop on the
+//              calling thread until it completes, free it. Once to send, once to read the reply.
+//   POOLED     usb_transport_send() then usb_transport_receive(), with the reads already submitted
+//              and the event loop on the transport's own thread.
+//
+// For each it prints messages per second and the round trip's p50, p99 and worst, and checks every
+// reply is the one its request asked for.
+//
+// THE SIMULATED DEVICE. libusb-free: a backend for the transport whose "device" answers every
+// 16-byte request on endpoint 3 with a 16-byte reply on endpoint 0x81 carrying the request's sequence
+// number. By default everything completes as soon as it can, which measures the transport's own
+// overhead and nothing else. --frame-us models a bus that moves data only at frame boundaries — 1000
+// for the G2's full-speed link — where a read completes at the first boundary at which it is both
+// submitted and has data to take. That is where having the read already waiting shows.
+//
+// READING THE NUMBERS. Unframed, the per-call path wins by a long way, and that is not a flaw in the
+// transport: against this device a "transfer" is a few stores on the calling thread, while the pooled
+// path hands every completion to another thread and back. Real libusb costs a system call or two per
+// submit and per event-loop turn, which the per-call path paid on the caller's thread and this device
+// does not charge. The allocations per message are what the per-call path is charged here. Framed,
+// the pooled round trip should take one frame and the per-call one two — the read that was already
+// waiting against the one submitted after the send came back.
+//
+//     ./do-usbbench
+//     ./usbbench --messages 2000 --frame-us 1000
+//     ./usbbench --commands 500
+//
+// QUEUED COMMANDS. Then the USB thread's idle wait, which the round trips above never reach. A
+// producer thread queues --commands commands (200 by default) at random gaps of up to 20ms — what
+// the UI does — and the bench's main thread serves them as state_handler() does:
+//
+//   POLLED     idle, it reads the IN endpoint with a 50ms timeout and looks at the queue again, so a
+//              command queued just after a poll began waits out the rest of it.
+//   WOKEN      idle, it sleeps in usb_transport_wait(); the producer rings usb_transport_wake() after
+//              each command, as send_usb_command() does.
+//
+// For each it prints the time from a command being queued to its send returning — p50, p99 and
+// worst — and how many times a second the idle wait ended with nothing to do. Polled should show a
+// p50 near 25ms and a worst near 50ms, and twenty idle wakes a second; woken, a p50 of tens of
+// microseconds (under a frame with --frame-us) and no idle wakes at all. Woken's tail is commands
+// queued back to back, each waiting behind the one before it on the wire, not the wait.
+//
+// Exits non-zero if a reply went missing or came back out of order.
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/usbTransport.h"
+
+#define BENCH_MESSAGE_SIZE     (16)
+#define BENCH_EXTENDED_SIZE    (65536)
+#define BENCH_TIMEOUT_MS       (1000U)
+#define BENCH_MAX_PENDING      (32U)
+#define BENCH_MAX_REPLIES      (16U)
+
+#define FAKE_CANCELLED         (-100)    // the simulated device's own result codes
+#define FAKE_NO_ROOM           (-101)
+
+// ── THE SIMULATED DEVICE ─────────────────────────────────────────────────────
+
+typedef struct {
+    tUsbTransfer * transfer;
+    uint64_t       submitted;
+    bool           cancelled;
+} tPending;
+
+typedef struct {
+    uint8_t  data[BENCH_MESSAGE_SIZE];
+    uint64_t ready;
+} tReply;
+
+static pthread_mutex_t gDeviceLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  gDeviceWork = PTHREAD_COND_INITIALIZER;
+static tPending        gPending[BENCH_MAX_PENDING];
+static uint32_t        gPendingCount;
+static tReply          gReplies[BENCH_MAX_REPLIES];
+static uint32_t        gReplyHead;
+static uint32_t        gReplyCount;
+static uint64_t        gFrameNanos;
+static uint64_t        gAllocations;
+static bool            gPooled;          // completions go to the transport, else to the caller
+static bool            gInterrupted;     // fake_interrupt() since handle_events last looked
+
+typedef struct {
+    tUsbTransfer * transfer;
+    int            result;
+    int            actual;
+} tCompletion;
+
+static uint64_t now_nanos(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+// The first frame boundary at or after t. Without frames, t itself.
+static uint64_t frame_at(uint64_t t) {
+    if (gFrameNanos == 0) {
+        return t;
+    }
+    return ((t + gFrameNanos - 1) / gFrameNanos) * gFrameNanos;
+}
+
+static bool fake_alloc(void * ctx, tUsbTransfer * transfer) {
+    gAllocations++;
+    transfer->handle = transfer;    // nothing of its own to hold, but the transport checks it is set
+    return true;
+}
+
+static void fake_release(void * ctx, tUsbTransfer * transfer) {
+    transfer->handle = NULL;
+}
+
+static int fake_submit(void * ctx, tUsbTransfer * transfer) {
+    int result = USB_TRANSPORT_OK;
+
+    pthread_mutex_lock(&gDeviceLock);
+
+    if (gPendingCount < BENCH_MAX_PENDING) {
+        gPending[gPendingCount].transfer  = transfer;
+        gPending[gPendingCount].submitted = now_nanos();
+        gPending[gPendingCount].cancelled = false;
+        gPendingCount++;
+        pthread_cond_signal(&gDeviceWork);
+    } else {
+        result = FAKE_NO_ROOM;
+    }
+    pthread_mutex_unlock(&gDeviceLock);
+    return result;
+}
+
+static void fake_cancel(void * ctx, tUsbTransfer * transfer) {
+    pthread_mutex_lock(&gDeviceLock);
+
+    for (uint32_t p = 0; p < gPendingCount; p++) {
+        if (gPending[p].transfer == transfer) {
+            gPending[p].cancelled = true;
+        }
+    }
+    pthread_cond_signal(&gDeviceWork);
+    pthread_mutex_unlock(&gDeviceLock);
+}
+
+static void remove_pending(uint32_t p) {
+    memmove(&gPending[p], &gPending[p + 1], sizeof(gPending[0]) * (gPendingCount - p - 1));
+    gPendingCount--;
+}
+
+static void complete(const tCompletion * done) {
+    if (gPooled) {
+        usb_transport_completed(done->transfer, done->result, done->actual);
+    } else {
+        done->transfer->result = done->result;
+        done->transfer->actual = done->actual;
+        done->transfer->busy   = false;
+    }
+}
+
+// Everything that can complete now, in submission order, then the callbacks with the lock dropped —
+// as libusb does. Otherwise waits for a submission, the next due time or the timeout.
+static void fake_handle_events(void * ctx, uint32_t timeoutMs) {
+    tCompletion done[BENCH_MAX_PENDING];
+    uint32_t    doneCount = 0;
+    uint64_t    giveUp    = now_nanos() + ((uint64_t)timeoutMs * 1000000ULL);
+
+    pthread_mutex_lock(&gDeviceLock);
+
+    while (true) {
+        uint64_t now  = now_nanos();
+        uint64_t next = giveUp;
+
+        for (uint32_t p = 0; p < gPendingCount;) {
+            tPending *     pending  = &gPending[p];
+            tUsbTransfer * transfer = pending->transfer;
+            uint64_t       due      = 0;
+
+            if (pending->cancelled) {
+                done[doneCount++] = (tCompletion){transfer, FAKE_CANCELLED, 0};
+                remove_pending(p);
+                continue;
+            }
+
+            if ((transfer->endpoint & 0x80) == 0) {
+                // A request: it goes at the next frame, and the reply is ready as it lands.
+                due = frame_at(pending->submitted);
+
+                if (due <= now) {
+                    if (gReplyCount < BENCH_MAX_REPLIES) {
+                        tReply * reply = &gReplies[(gReplyHead + gReplyCount) % BENCH_MAX_REPLIES];
+
+                        memcpy(reply->data, transfer->buffer, BENCH_MESSAGE_SIZE);
+                        reply->ready = due;
+                        gReplyCount++;
+                    }
+                    done[doneCount++] = (tCompletion){transfer, USB_TRANSPORT_OK, transfer->length};
+                    remove_pending(p);
+                    continue;
+                }
+            } else if ((transfer->endpoint == 0x81) && (gReplyCount > 0)) {
+                // A read takes the oldest reply at the first frame it is both waiting and has one.
+                tReply * reply = &gReplies[gReplyHead];
+
+                due = frame_at((pending->submitted > reply->ready) ? pending->submitted : reply->ready);
+
+                if (due <= now) {
+                    memcpy(transfer->buffer, reply->data, BENCH_MESSAGE_SIZE);
+                    gReplyHead        = (gReplyHead + 1) % BENCH_MAX_REPLIES;
+                    gReplyCount--;
+                    done[doneCount++] = (tCompletion){transfer, USB_TRANSPORT_OK, BENCH_MESSAGE_SIZE};
+                    remove_pending(p);
+                    continue;
+                }
+            } else {
+                p++;
+                continue;    // a read with nothing to read, or the extended endpoint, which stays quiet
+            }
+            next = (due < next) ? due : next;
+            p++;
+        }
+
+        if ((doneCount > 0) || (now >= giveUp) || gInterrupted) {
+            gInterrupted = false;
+            break;
+        }
+        struct timespec until;
+
+        // pthread_cond_timedwait() measures CLOCK_REALTIME; convert the monotonic deadline to it.
+        clock_gettime(CLOCK_REALTIME, &until);
+        uint64_t        wait  = next - now;
+
+        until.tv_sec  += (time_t)(wait / 1000000000ULL);
+        until.tv_nsec += (long)(wait % 1000000000ULL);
+
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        (void)pthread_cond_timedwait(&gDeviceWork, &gDeviceLock, &until);
+    }
+    pthread_mutex_unlock(&gDeviceLock);
+
+    for (uint32_t d = 0; d < doneCount; d++) {
+        complete(&done[d]);
+    }
+}
+
+static void fake_interrupt(void * ctx) {
+    pthread_mutex_lock(&gDeviceLock);
+    gInterrupted = true;
+    pthread_cond_signal(&gDeviceWork);
+    pthread_mutex_unlock(&gDeviceLock);
+}
+
+static const tUsbBackend kFakeBackend = {
+    fake_alloc,
+    fake_release,
+    fake_submit,
+    fake_cancel,
+    fake_handle_events,
+    fake_interrupt,
+};
+
+// ── THE TWO PATHS ────────────────────────────────────────────────────────────
+
+// The old usb_bulk_transfer_sync(), less its timeout handling, which the simulated device never needs.
+static int per_call_transfer(uint8_t endpoint, uint8_t * buffer, int length, int * actual) {
+    tUsbTransfer * transfer = calloc(1, sizeof(*transfer));
+    int            result   = USB_TRANSPORT_OK;
+
+    if ((transfer == NULL) || (fake_alloc(NULL, transfer) == false)) {
+        free(transfer);
+        return FAKE_NO_ROOM;
+    }
+    transfer->endpoint = endpoint;
+    transfer->buffer   = buffer;
+    transfer->size     = length;
+    transfer->length   = length;
+    transfer->busy     = true;
+    result             = fake_submit(NULL, transfer);
+
+    while ((result == USB_TRANSPORT_OK) && transfer->busy) {
+        fake_handle_events(NULL, 50U);
+    }
+
+    if (result == USB_TRANSPORT_OK) {
+        result = transfer->result;
+    }
+    *actual = transfer->actual;
+    fake_release(NULL, transfer);
+    free(transfer);
+    return result;
+}
+
+static int compare_u64(const void * a, const void * b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Sends `count` requests, each waiting for its reply. Prints one line; false if a reply was wrong.
+static bool run(const char * name, bool pooled, uint32_t count) {
+    static tUsbTransport transport;
+    static const uint8_t inEndpoints[] = {0x81, 0x82};
+    static const int     inSizes[]     = {BENCH_MESSAGE_SIZE, BENCH_EXTENDED_SIZE};
+    uint64_t *           trips         = calloc(count, sizeof(uint64_t));
+    uint64_t             allocations   = 0;
+    uint32_t             wrong         = 0;
+    uint64_t             began         = 0;
+    uint64_t             total         = 0;
+
+    if (trips == NULL) {
+        return false;
+    }
+    gPooled       = pooled;
+    gReplyCount   = 0;
+    gPendingCount = 0;
+
+    if (pooled) {
+        usb_transport_init(&transport);
+
+        if (usb_transport_start(&transport, &kFakeBackend, NULL, inEndpoints, inSizes, 2,
+                                BENCH_MESSAGE_SIZE) == false) {
+            printf("%-10s could not start the transport\n", name);
+            free(trips);
+            return false;
+        }
+    }
+    allocations = gAllocations;
+    began       = now_nanos();
+
+    for (uint32_t m = 0; m < count; m++) {
+        uint8_t  request[BENCH_MESSAGE_SIZE] = {0};
+        uint8_t  reply[BENCH_MESSAGE_SIZE]   = {0};
+        int      actual                      = 0;
+        int      sent                        = 0;
+        int      got                         = 0;
+        uint64_t start                       = now_nanos();
+
+        memcpy(request, &m, sizeof(m));
+
+        if (pooled) {
+            sent = usb_transport_send(&transport, 3, request, BENCH_MESSAGE_SIZE, &actual, BENCH_TIMEOUT_MS);
+            got  = usb_transport_receive(&transport, 0x81, reply, BENCH_MESSAGE_SIZE, &actual, BENCH_TIMEOUT_MS);
+        } else {
+            sent = per_call_transfer(3, request, BENCH_MESSAGE_SIZE, &actual);
+            got  = per_call_transfer(0x81, reply, BENCH_MESSAGE_SIZE, &actual);
+        }
+        trips[m] = now_nanos() - start;
+
+        if ((sent != USB_TRANSPORT_OK) || (got != USB_TRANSPORT_OK) || (memcmp(request, reply, sizeof(m)) != 0)) {
+            wrong++;
+        }
+    }
+    total       = now_nanos() - began;
+    allocations = gAllocations - allocations;
+
+    if (pooled) {
+        if (usb_transport_stop(&transport) == false) {
+            printf("%-10s transfers were still in flight at stop\n", name);
+            wrong++;
+        }
+    }
+    qsort(trips, count, sizeof(trips[0]), compare_u64);
+
+    printf("%-10s %10.0f msg/s   p50 %8.1f us   p99 %8.1f us   worst %8.1f us   %5.2f allocs/msg   %s\n",
+           name, (double)count / ((double)total / 1e9),
+           (double)trips[count / 2] / 1e3, (double)trips[(count * 99) / 100] / 1e3,
+           (double)trips[count - 1] / 1e3, (double)allocations / (double)count,
+           (wrong == 0) ? "ok" : "REPLIES WRONG");
+
+    if (wrong > 0) {
+        printf("    %u of %u round trips failed or came back with another request's reply\n",
+               (unsigned)wrong, (unsigned)count);
+    }
+    free(trips);
+    return wrong == 0;
+}
+
+// ── QUEUED COMMANDS ──────────────────────────────────────────────────────────
+
+// The UI's side: commands queued at uneven gaps, each stamped as it is queued. The queue stands in for
+// gToUsbThread, and ringing the doorbell for what send_usb_command() does after it.
+typedef struct {
+    pthread_mutex_t lock;
+    uint64_t *      queued;       // when each command was queued, in order
+    uint32_t        count;        // how many there will be
+    uint32_t        produced;
+    uint32_t        consumed;
+    bool            doorbell;
+    tUsbTransport * transport;
+} tCommandQueue;
+
+static void * produce(void * arg) {
+    tCommandQueue * queue = arg;
+    uint32_t        seed  = 2;
+
+    for (uint32_t c = 0; c < queue->count; c++) {
+        struct timespec gap;
+
+        // 0-20ms apart: a hand on a dial, a menu click, then nothing for a while.
+        seed         = (seed * 1103515245U) + 12345U;
+        gap.tv_sec   = 0;
+        gap.tv_nsec  = (long)((seed >> 8) % 20000U) * 1000L;
+        nanosleep(&gap, NULL);
+
+        pthread_mutex_lock(&queue->lock);
+        queue->queued[queue->produced++] = now_nanos();
+        pthread_mutex_unlock(&queue->lock);
+
+        if (queue->doorbell) {
+            usb_transport_wake(queue->transport);
+        }
+    }
+    return NULL;
+}
+
+// The USB thread's side, as state_handler() runs it: send what is queued, each as a request and its
+// reply, and when there is nothing, idle — before, by polling the IN endpoint for 50ms at a time; after,
+// by sleeping in usb_transport_wait() until the device or the doorbell ends it. Measures each command
+// from being queued to its send returning, and how often the idle wait came back with nothing.
+static bool run_commands(const char * name, bool doorbell, uint32_t count) {
+    static tUsbTransport transport;
+    static const uint8_t inEndpoints[] = {0x81, 0x82};
+    static const int     inSizes[]     = {BENCH_MESSAGE_SIZE, BENCH_EXTENDED_SIZE};
+    tCommandQueue        queue         = {0};
+    pthread_t            producer;
+    uint64_t *           latency       = calloc(count, sizeof(uint64_t));
+    uint64_t *           queued        = calloc(count, sizeof(uint64_t));
+    uint64_t             idleWakes     = 0;
+    uint64_t             began         = 0;
+    uint64_t             total         = 0;
+    uint32_t             wrong         = 0;
+
+    if ((latency == NULL) || (queued == NULL)) {
+        free(latency);
+        free(queued);
+        return false;
+    }
+    gPooled       = true;
+    gReplyCount   = 0;
+    gPendingCount = 0;
+    usb_transport_init(&transport);
+
+    if (usb_transport_start(&transport, &kFakeBackend, NULL, inEndpoints, inSizes, 2,
+                            BENCH_MESSAGE_SIZE) == false) {
+        printf("%-10s could not start the transport\n", name);
+        free(latency);
+        free(queued);
+        return false;
+    }
+    pthread_mutex_init(&queue.lock, NULL);
+    queue.queued    = queued;
+    queue.count     = count;
+    queue.doorbell  = doorbell;
+    queue.transport = &transport;
+    began           = now_nanos();
+    pthread_create(&producer, NULL, produce, &queue);
+
+    while (queue.consumed < count) {
+        uint32_t pending = 0;
+
+        pthread_mutex_lock(&queue.lock);
+        pending = queue.produced - queue.consumed;
+        pthread_mutex_unlock(&queue.lock);
+
+        if (pending > 0) {
+            uint8_t  request[BENCH_MESSAGE_SIZE] = {0};
+            uint8_t  reply[BENCH_MESSAGE_SIZE]   = {0};
+            int      actual                      = 0;
+            int      sent                        = 0;
+            int      got                         = 0;
+            uint32_t c                           = queue.consumed;
+
+            memcpy(request, &c, sizeof(c));
+            sent       = usb_transport_send(&transport, 3, request, BENCH_MESSAGE_SIZE, &actual, BENCH_TIMEOUT_MS);
+            latency[c] = now_nanos() - queued[c];
+            got        = usb_transport_receive(&transport, 0x81, reply, BENCH_MESSAGE_SIZE, &actual, BENCH_TIMEOUT_MS);
+
+            if ((sent != USB_TRANSPORT_OK) || (got != USB_TRANSPORT_OK) || (memcmp(request, reply, sizeof(c)) != 0)) {
+                wrong++;
+            }
+            queue.consumed++;
+            continue;
+        }
+
+        if (doorbell) {
+            if (usb_transport_wait(&transport, 0x81, 1000U) == USB_TRANSPORT_TIMEOUT) {
+                idleWakes++;
+            }
+        } else {
+            uint8_t reply[BENCH_MESSAGE_SIZE];
+            int     actual = 0;
+
+            if (usb_transport_receive(&transport, 0x81, reply, BENCH_MESSAGE_SIZE, &actual, 50U) == USB_TRANSPORT_TIMEOUT) {
+                idleWakes++;
+            }
+        }
+    }
+    total = now_nanos() - began;
+    pthread_join(producer, NULL);
+    pthread_mutex_destroy(&queue.lock);
+
+    if (usb_transport_stop(&transport) == false) {
+        printf("%-10s transfers were still in flight at stop\n", name);
+        wrong++;
+    }
+    qsort(latency, count, sizeof(latency[0]), compare_u64);
+
+    printf("%-10s queued to sent: p50 %8.1f us   p99 %8.1f us   worst %8.1f us   %6.1f idle wakes/s   %s\n",
+           name, (double)latency[count / 2] / 1e3, (double)latency[(count * 99) / 100] / 1e3,
+           (double)latency[count - 1] / 1e3, (double)idleWakes / ((double)total / 1e9),
+           (wrong == 0) ? "ok" : "REPLIES WRONG");
+    free(latency);
+    free(queued);
+    return wrong == 0;
+}
+
+int main(int argc, char ** argv) {
+    uint32_t messages = 20000;
+    uint32_t commands = 200;
+    uint32_t frameUs  = 0;
+    bool     ok       = true;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--messages") == 0) && ((i + 1) < argc)) {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--commands") == 0) && ((i + 1) < argc)) {
+            commands = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--frame-us") == 0) && ((i + 1) < argc)) {
+            frameUs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--messages N] [--commands N] [--frame-us N]\n"
+                            "  Times request/reply round trips through the USB transport and through\n"
+                            "  the per-call path it replaced, against a simulated device, then how long\n"
+                            "  a queued command waits for an idle USB thread, polled and woken.\n", argv[0]);
+            return 126;
+        }
+    }
+
+    if (messages == 0) {
+        messages = 1;
+    }
+
+    if (commands == 0) {
+        commands = 1;
+    }
+    gFrameNanos = (uint64_t)frameUs * 1000ULL;
+
+    printf("%u round trips of a %d-byte request and reply, ", (unsigned)messages, BENCH_MESSAGE_SIZE);
+
+    if (frameUs == 0) {
+        printf("completing as soon as possible\n\n");
+    } else {
+        printf("on a bus framed every %u us\n\n", (unsigned)frameUs);
+    }
+    ok = run("per-call", false, messages) && ok;
+    ok = run("pooled", true, messages) && ok;
+
+    printf("\n%u commands queued 0-20ms apart to an otherwise idle USB thread\n\n", (unsigned)commands);
+    ok = run_commands("polled", false, commands) && ok;
+    ok = run_commands("woken", true, commands) && ok;
+
+    return ok ? 0 : 1;
+}
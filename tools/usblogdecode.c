@@ -0,0 +1,536 @@
+/*
+ * usblogdecode — turn the binary USB traffic log back into text, and check the logger that writes it.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// With ENABLE_USB_LOG, the editor records every USB message to ~/G2_usb.bin in the binary format
+// described in src/usbLog.h, from a ring its writer thread drains, so that logging costs the USB
+// thread a copy and nothing else. This reads that file and prints what the log used to write itself:
+//
+//     --- session start 2026-10-19 14:02:11 ---
+//     [14:02:11.204] TX 4 bytes: 01 20 41 71
+//     [14:02:11.209] RX 16 bytes: 82 01 0c 00 ...
+//     --- session end ---
+//
+// plus a line wherever the logger had to drop records, and the totals on stderr. Times are local, as
+// they were, taken from each record's CLOCK_REALTIME stamp — so decode on the machine that logged, or
+// set TZ to match it.
+//
+//     ./do-usblogdecode                     ~/G2_usb.bin
+//     ./usblogdecode capture.bin > capture.txt
+//
+// --selftest checks the logger itself, src/usbLog.c built with ENABLE_USB_LOG, in a scratch HOME:
+//
+//   ROUND TRIP. A paced run of messages of every direction and of sizes up to the largest extended
+//   message, enough in all to wrap the ring several times, and a text line. Each must come back in
+//   order, byte for byte, with nothing dropped.
+//
+//   DROPPING. Messages posted far faster than the writer drains. Some must be dropped, never blocked
+//   on, and the session's dropped records must account for every message that is not in the file.
+//
+//   THE COST. Times usb_log_message() per call, mean and worst, against the fprintf-and-fflush logger
+//   it replaced (copied here as it was), for an interrupt-sized and a 1 KB message.
+//
+// Exits non-zero if the file is damaged or, with --selftest, if a check failed.
+//
+// Build: see tools/do-usblogdecode. Only libc and pthreads.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "defs.h"
+#include "usbLog.h"
+
+#define DECODE_PAYLOAD_MAX       (1U << 24)      // a length past this is damage, not a message
+#define SELFTEST_MESSAGES        (400U)
+#define SELFTEST_FLOOD           (200U)
+#define SELFTEST_BIG             (EXTENDED_MESSAGE_SIZE - 4)
+#define SELFTEST_TIMED           (20000U)
+#define SELFTEST_TIMED_BATCH     (500U)          // calls between pauses, so the ring never fills while timed
+
+typedef struct {
+    uint8_t  type;
+    uint8_t  direction;
+    uint8_t  endpoint;
+    uint32_t length;
+    uint64_t nanos;
+    uint8_t * payload;        // length bytes, owned by the reader
+    uint32_t capacity;
+} tLogRecord;
+
+typedef struct {
+    uint64_t sessions;
+    uint64_t messages;
+    uint64_t texts;
+    uint64_t dropped;
+    uint64_t ends;
+    bool     truncated;       // the file stops part way through a record
+    bool     damaged;         // a record that cannot be one
+} tLogTotals;
+
+static uint32_t read_le32(const uint8_t * p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t read_le64(const uint8_t * p) {
+    return (uint64_t)read_le32(p) | ((uint64_t)read_le32(p + 4) << 32);
+}
+
+// The next record. False at the end of the file, or at a record that is cut short or malformed, which
+// totals says.
+static bool read_record(FILE * file, tLogRecord * record, tLogTotals * totals) {
+    uint8_t header[USB_LOG_HEADER_BYTES];
+    size_t  got = fread(header, 1, sizeof(header), file);
+
+    if (got == 0) {
+        return false;
+    }
+
+    if (got < sizeof(header)) {
+        totals->truncated = true;
+        return false;
+    }
+    record->type      = header[0];
+    record->direction = header[1];
+    record->endpoint  = header[2];
+    record->length    = read_le32(&header[4]);
+    record->nanos     = read_le64(&header[8]);
+
+    if ((record->type > eUsbLogRecordEnd) || (record->length > DECODE_PAYLOAD_MAX)) {
+        totals->damaged = true;
+        return false;
+    }
+
+    if (record->length > record->capacity) {
+        uint8_t * grown = realloc(record->payload, record->length);
+
+        if (grown == NULL) {
+            totals->damaged = true;
+            return false;
+        }
+        record->payload  = grown;
+        record->capacity = record->length;
+    }
+
+    if (fread(record->payload, 1, record->length, file) < record->length) {
+        totals->truncated = true;
+        return false;
+    }
+
+    if ((record->type == eUsbLogRecordSession)
+        && ((record->length < (USB_LOG_MAGIC_BYTES + 4))
+            || (memcmp(record->payload, USB_LOG_MAGIC, USB_LOG_MAGIC_BYTES) != 0))) {
+        totals->damaged = true;
+        return false;
+    }
+    return true;
+}
+
+static const char * direction_name(uint8_t direction) {
+    switch (direction) {
+        case eUsbLogRx:
+        {
+            return "RX";
+        }
+        case eUsbLogTx:
+        {
+            return "TX";
+        }
+        case eUsbLogExtended:
+        {
+            return "EX";
+        }
+        default:
+        {
+            return "??";
+        }
+    }
+}
+
+static void print_time(FILE * out, uint64_t nanos) {
+    time_t    seconds = (time_t)(nanos / 1000000000ULL);
+    struct tm tmInfo;
+
+    localtime_r(&seconds, &tmInfo);
+    fprintf(out, "[%02d:%02d:%02d.%03d] ", tmInfo.tm_hour, tmInfo.tm_min, tmInfo.tm_sec,
+            (int)((nanos % 1000000000ULL) / 1000000ULL));
+}
+
+// The whole file as the log used to write it. Returns false if it is damaged; a file cut short at the
+// end — the editor stopped mid-write — decodes as far as it goes.
+static bool decode(FILE * in, FILE * out, tLogTotals * totals) {
+    tLogRecord record = {0};
+
+    while (read_record(in, &record, totals) == true) {
+        switch (record.type) {
+            case eUsbLogRecordSession:
+            {
+                time_t    seconds  = (time_t)(record.nanos / 1000000000ULL);
+                struct tm tmInfo;
+                char      when[64] = {0};
+
+                localtime_r(&seconds, &tmInfo);
+                strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tmInfo);
+                fprintf(out, "\n--- session start %s ---\n", when);
+                totals->sessions++;
+                break;
+            }
+            case eUsbLogRecordMessage:
+            {
+                print_time(out, record.nanos);
+                fprintf(out, "%s %u bytes:", direction_name(record.direction), (unsigned)record.length);
+
+                for (uint32_t i = 0; i < record.length; i++) {
+                    fprintf(out, " %02x", record.payload[i]);
+                }
+                fprintf(out, "\n");
+                totals->messages++;
+                break;
+            }
+            case eUsbLogRecordText:
+            {
+                print_time(out, record.nanos);
+                fwrite(record.payload, 1, record.length, out);
+                totals->texts++;
+                break;
+            }
+            case eUsbLogRecordDropped:
+            {
+                uint64_t count = (record.length >= 8) ? read_le64(record.payload) : 0;
+
+                print_time(out, record.nanos);
+                fprintf(out, "--- %llu records dropped here: the logger's ring was full ---\n", (unsigned long long)count);
+                totals->dropped += count;
+                break;
+            }
+            default:
+            {
+                fprintf(out, "--- session end ---\n");
+                totals->ends++;
+                break;
+            }
+        }
+    }
+    free(record.payload);
+    return totals->damaged == false;
+}
+
+// ── SELFTEST ─────────────────────────────────────────────────────────────────────────────────────
+
+static uint64_t now_nanos(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void pause_ms(uint32_t ms) {
+    const struct timespec period = {0, (long)ms * 1000000L};
+
+    nanosleep(&period, NULL);
+}
+
+// Message n of a run: its size, direction and bytes all follow from n, so the reader can check each
+// one without keeping what was sent.
+static uint32_t message_length(uint32_t n) {
+    static const uint32_t kLengths[] = {4, INTERRUPT_MESSAGE_SIZE, 200, 1024, 8000, SELFTEST_BIG};
+
+    return kLengths[n % (sizeof(kLengths) / sizeof(kLengths[0]))];
+}
+
+static void fill_message(uint32_t n, uint8_t * data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)((n * 131U) + (i * 7U));
+    }
+    memcpy(data, &n, (length >= sizeof(n)) ? sizeof(n) : length);
+}
+
+static bool message_is(const tLogRecord * record, uint32_t n) {
+    static uint8_t expected[EXTENDED_MESSAGE_SIZE];
+    uint32_t       length = message_length(n);
+
+    if ((record->length != length) || (record->direction != (n % 3U)) || (record->endpoint != (uint8_t)(0x80U + (n % 3U)))) {
+        return false;
+    }
+    fill_message(n, expected, length);
+    return memcmp(record->payload, expected, length) == 0;
+}
+
+static void post_message(uint32_t n) {
+    static uint8_t data[EXTENDED_MESSAGE_SIZE];
+    uint32_t       length = message_length(n);
+
+    fill_message(n, data, length);
+    usb_log_message((tUsbLogDirection)(n % 3U), (uint8_t)(0x80U + (n % 3U)), data, length);
+}
+
+static FILE * open_log(const char * home) {
+    char path[1024];
+
+    snprintf(path, sizeof(path), "%s/G2_usb.bin", home);
+    return fopen(path, "rb");
+}
+
+static bool check_round_trip(const char * home) {
+    tLogRecord record  = {0};
+    tLogTotals totals  = {0};
+    uint32_t   next    = 0;
+    bool       text    = false;
+    bool       ok      = true;
+    uint64_t   bytes   = 0;
+    FILE *     file    = NULL;
+
+    usb_log_open();
+
+    for (uint32_t n = 0; n < SELFTEST_MESSAGES; n++) {
+        post_message(n);
+        bytes += message_length(n);
+
+        if ((n % 8U) == 7U) {
+            pause_ms(30);    // past one drain, so the ring is emptied and wraps rather than fills
+        }
+    }
+    usb_log_text("selftest %d\n", 42);
+    usb_log_close();
+
+    file = open_log(home);
+
+    if (file == NULL) {
+        printf("round trip   FAIL  no log file written\n");
+        return false;
+    }
+
+    while (read_record(file, &record, &totals) == true) {
+        if (record.type == eUsbLogRecordMessage) {
+            if ((next >= SELFTEST_MESSAGES) || (message_is(&record, next) == false)) {
+                printf("round trip   FAIL  message %u is not what was sent\n", (unsigned)next);
+                ok = false;
+                break;
+            }
+            next++;
+        } else if (record.type == eUsbLogRecordText) {
+            text = (record.length == 12) && (memcmp(record.payload, "selftest 42\n", 12) == 0);
+        } else if (record.type == eUsbLogRecordDropped) {
+            totals.dropped += read_le64(record.payload);
+        } else if (record.type == eUsbLogRecordEnd) {
+            totals.ends++;
+        }
+    }
+    fclose(file);
+    free(record.payload);
+
+    ok = ok && (next == SELFTEST_MESSAGES) && text && (totals.dropped == 0) && (totals.ends == 1)
+         && (totals.truncated == false) && (totals.damaged == false);
+    printf("round trip   %s  %u of %u messages back in order, %.1f MB through the ring, %llu dropped\n",
+           ok ? "ok  " : "FAIL", (unsigned)next, SELFTEST_MESSAGES, (double)bytes / 1e6,
+           (unsigned long long)totals.dropped);
+    return ok;
+}
+
+// Appends a second session to the same file, without pausing: the ring fills within a few messages.
+static bool check_dropping(const char * home) {
+    tLogRecord record   = {0};
+    tLogTotals totals   = {0};
+    uint32_t   sessions = 0;
+    uint32_t   seen     = 0;
+    uint32_t   last     = 0;
+    bool       ordered  = true;
+    uint64_t   worst    = 0;
+    FILE *     file     = NULL;
+
+    usb_log_open();
+
+    for (uint32_t n = 0; n < SELFTEST_FLOOD; n++) {
+        uint64_t began = now_nanos();
+        uint64_t took  = 0;
+
+        post_message((n / 6U) * 6U + 5U);    // always the largest size
+        took  = now_nanos() - began;
+        worst = (took > worst) ? took : worst;
+    }
+    usb_log_close();
+
+    file = open_log(home);
+
+    if (file == NULL) {
+        printf("dropping     FAIL  no log file\n");
+        return false;
+    }
+
+    while (read_record(file, &record, &totals) == true) {
+        if (record.type == eUsbLogRecordSession) {
+            sessions++;
+        } else if ((sessions == 2) && (record.type == eUsbLogRecordMessage)) {
+            uint32_t n = 0;
+
+            memcpy(&n, record.payload, sizeof(n));
+            ordered = ordered && (message_is(&record, n) == true) && ((seen == 0) || (n >= last));
+            last    = n;
+            seen++;
+        } else if ((sessions == 2) && (record.type == eUsbLogRecordDropped)) {
+            totals.dropped += read_le64(record.payload);
+        }
+    }
+    fclose(file);
+    free(record.payload);
+
+    bool ok = (sessions == 2) && ordered && (totals.dropped > 0) && ((seen + totals.dropped) == SELFTEST_FLOOD)
+              && (totals.damaged == false);
+
+    printf("dropping     %s  %u of %u kept, %llu reported dropped, worst call %.1f us\n",
+           ok ? "ok  " : "FAIL", (unsigned)seen, SELFTEST_FLOOD, (unsigned long long)totals.dropped,
+           (double)worst / 1000.0);
+    return ok;
+}
+
+// What usb_log_message() was before the ring, as it was but for the file it writes.
+static void fprintf_log_message(FILE * logFile, const char * direction, const uint8_t * data, size_t length) {
+    struct timespec ts;
+    struct tm       tmInfo;
+    size_t          i;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tmInfo);
+
+    fprintf(logFile, "[%02d:%02d:%02d.%03d] %s %zu bytes:",
+            tmInfo.tm_hour, tmInfo.tm_min, tmInfo.tm_sec,
+            (int)(ts.tv_nsec / 1000000),
+            direction, length);
+
+    for (i = 0; i < length; i++) {
+        fprintf(logFile, " %02x", data[i]);
+    }
+
+    fprintf(logFile, "\n");
+    fflush(logFile);
+}
+
+static void time_logger(const char * home, uint32_t length) {
+    static uint8_t data[1024];
+    char           path[1024];
+    FILE *         text       = NULL;
+    uint64_t       total[2]   = {0};
+    uint64_t       worst[2]   = {0};
+
+    fill_message(1, data, length);
+    snprintf(path, sizeof(path), "%s/G2_usb.txt", home);
+    text = fopen(path, "a");
+
+    if (text == NULL) {
+        return;
+    }
+    usb_log_open();
+
+    for (uint32_t n = 0; n < SELFTEST_TIMED; n++) {
+        for (uint32_t which = 0; which < 2; which++) {
+            uint64_t began = now_nanos();
+            uint64_t took  = 0;
+
+            if (which == 0) {
+                fprintf_log_message(text, "RX", data, length);
+            } else {
+                usb_log_message(eUsbLogRx, 0x81, data, length);
+            }
+            took          = now_nanos() - began;
+            total[which] += took;
+            worst[which]  = (took > worst[which]) ? took : worst[which];
+        }
+
+        if ((n % SELFTEST_TIMED_BATCH) == (SELFTEST_TIMED_BATCH - 1U)) {
+            pause_ms(30);
+        }
+    }
+    usb_log_close();
+    fclose(text);
+
+    printf("cost %4u B  fprintf+fflush mean %8.1f ns worst %7.1f us   ring mean %6.1f ns worst %6.1f us\n",
+           (unsigned)length, (double)total[0] / SELFTEST_TIMED, (double)worst[0] / 1000.0,
+           (double)total[1] / SELFTEST_TIMED, (double)worst[1] / 1000.0);
+}
+
+static int selftest(void) {
+    char home[] = "/tmp/usblogdecode.XXXXXX";
+    char path[1024];
+    bool ok     = true;
+
+    if (mkdtemp(home) == NULL) {
+        fprintf(stderr, "selftest: no scratch directory\n");
+        return 1;
+    }
+    setenv("HOME", home, 1);
+
+    ok = check_round_trip(home) && ok;
+    ok = check_dropping(home) && ok;
+    snprintf(path, sizeof(path), "%s/G2_usb.bin", home);
+    remove(path);
+
+    time_logger(home, INTERRUPT_MESSAGE_SIZE);
+    time_logger(home, 1024);
+    remove(path);
+    snprintf(path, sizeof(path), "%s/G2_usb.txt", home);
+    remove(path);
+    rmdir(home);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char ** argv) {
+    tLogTotals   totals = {0};
+    char         path[1024];
+    const char * name   = NULL;
+    const char * home   = getenv("HOME");
+    FILE *       in     = NULL;
+    bool         ok     = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--selftest") == 0) {
+            return selftest();
+        } else if ((argv[i][0] != '-') && (name == NULL)) {
+            name = argv[i];
+        } else {
+            fprintf(stderr, "usage: %s [log.bin] | --selftest\n"
+                            "  Prints the binary USB traffic log (default ~/G2_usb.bin) as text. --selftest\n"
+                            "  checks and times the logger instead.\n", argv[0]);
+            return 126;
+        }
+    }
+
+    if (name == NULL) {
+        snprintf(path, sizeof(path), "%s/G2_usb.bin", (home != NULL) ? home : "/tmp");
+        name = path;
+    }
+    in = fopen(name, "rb");
+
+    if (in == NULL) {
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], name);
+        return 1;
+    }
+    ok = decode(in, stdout, &totals);
+    fclose(in);
+
+    fprintf(stderr, "%llu sessions, %llu cleanly ended; %llu messages, %llu text lines, %llu records dropped%s%s\n",
+            (unsigned long long)totals.sessions, (unsigned long long)totals.ends, (unsigned long long)totals.messages,
+            (unsigned long long)totals.texts, (unsigned long long)totals.dropped,
+            totals.truncated ? "; the last record is cut short" : "", totals.damaged ? "; DAMAGED, stopped there" : "");
+    return ok ? 0 : 1;
+}
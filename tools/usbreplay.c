@@ -0,0 +1,898 @@
+/*
+ * usbreplay — put recorded G2 traffic through the editor's own inbound parsers, without a G2.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// parse_incoming(), parse_command_response() and everything under them in usbComms.c only ever ran on
+// what a real G2 sent. This links usbComms.c whole, with protocol.c and the module database, and lets
+// a capture stand in for the transport: each inbound record goes to the entry point its endpoint's
+// read would have handed it to — usb_comms_parse_interrupt() for 0x81, usb_comms_parse_extended()
+// for 0x82 (usbComms.h). No thread is started and libusb is never initialised; it is linked only
+// because usbComms.c is.
+//
+// A capture is either the binary log ENABLE_USB_LOG writes (src/usbLog.h) or the text it used to write,
+// and tools/usblogdecode.c still prints — "[hh:mm:ss.mmm] RX 16 bytes: 21 01 ..." — one message a
+// line. Only RX and EX records are replayed; TX is what the editor said, and is skipped.
+//
+// WITH NO CAPTURE, it makes its own, from each patch file, and checks the round trip:
+//
+//   THE DATABASE. Loads the patch into slot 0 from the file, as the plug-in does, and keeps a copy of
+//   every module, cable and patch-level table. Then builds the traffic a G2 holding that patch would
+//   send — the patch dump, as an extended message behind its header, some parameter changes as
+//   embedded messages, and a meter and an LED message — clears the slot, writes the traffic out in
+//   both capture formats, and replays each file into the cleared slot. Every module and cable must
+//   come back exactly as the file loaded it, with the parameter changes applied. Any difference is a
+//   failure and says which field.
+//
+//   THE THROUGHPUT. Replays the capture --passes times more, from memory, and prints messages per
+//   second overall and nanoseconds per message of each kind — so a change to the parsing hot path
+//   shows up without hardware.
+//
+// WITH --capture FILE, it replays the file into an empty database and reports what arrived, slot by
+// slot, and the throughput. Add --expect PATCH (and --slot N, default 0) to require that slot to hold
+// exactly what PATCH loads as. A message the parsers do not know ends the run, as it would end the
+// editor (parse_command_response()'s default).
+//
+// Run from the repository root:
+//
+//     ./do-usbreplay
+//     ./usbreplay --capture ~/G2_usb.bin --expect PatchTestFiles/SimpleLead.pch2 --slot 1
+//
+// Exits non-zero if a capture could not be read, a message failed to parse, or a database differed.
+//
+// Build: see tools/do-usbreplay. libusb and the GLFW headers are needed to compile usbComms.c; neither
+// is called.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "utils.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "globalVars.h"
+#include "protocol.h"
+#include "graphics.h"
+#include "deviceSync.h"
+#include "paramPages.h"
+#include "usbComms.h"
+#include "usbLog.h"
+#include "../vst3/g2Patch.h"
+
+#define REPLAY_PASSES            (200U)
+#define REPLAY_MAX_RECORDS       (1U << 16)
+#define REPLAY_PARAM_CHANGES     (24U)
+#define REPLAY_EMBEDDED_MAX      (13U)          // content bytes an interrupt message can carry, less the CRC
+#define REPLAY_TEXT_LINE         (8U * EXTENDED_MESSAGE_SIZE)
+#define REPLAY_MAX_PATCHES       (256U)
+
+// ── STUBS ──────────────────────────────────────────────────────────────────────────────────────────
+
+// As ledbench.c: the parsers may post to the GUI and the undo stack, and there is neither. The queues
+// are SynthLib's, which this does not link beyond its bit-stream and CRC helpers.
+void msg_init(tMessageQueue * msgQueue, const char * name, size_t size) {
+    (void)msgQueue;
+    (void)name;
+    (void)size;
+}
+
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+int msg_receive(tMessageQueue * msgQueue, eRcv mode, void * content) {
+    (void)msgQueue;
+    (void)mode;
+    (void)content;
+    return EXIT_FAILURE;
+}
+
+bool synthlib_quit_requested(void) {
+    return true;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+// What usbComms.c reaches of the UI, for bank backups and the offline queue — neither of which a
+// replay gets near.
+tParamPagesEdit gParamPages = {0};
+
+int write_database_to_file(const char * filepath, uint32_t slot) {
+    (void)filepath;
+    (void)slot;
+    return EXIT_FAILURE;
+}
+
+int write_perf_to_file(const char * filepath) {
+    (void)filepath;
+    return EXIT_FAILURE;
+}
+
+uint32_t device_sync_drain_offline_edits(void) {
+    return 0;
+}
+
+// The parsers wake the UI to redraw, and stop the editor if nobody has registered to be woken. There
+// is no UI.
+static void no_ui(void) {
+}
+
+// ── CAPTURES ───────────────────────────────────────────────────────────────────────────────────────
+
+typedef struct {
+    uint8_t   direction;    // a tUsbLogDirection
+    uint32_t  length;
+    uint8_t * data;
+} tReplayRecord;
+
+typedef struct {
+    tReplayRecord record[REPLAY_MAX_RECORDS];
+    uint32_t      count;
+    uint64_t      skipped;  // TX, text and anything unreadable
+    uint64_t      dropped;  // records the logger itself reported dropping
+} tCapture;
+
+static uint64_t now_nanos(void) {
+    struct timespec now = {0};
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec;
+}
+
+static void capture_free(tCapture * capture) {
+    for (uint32_t r = 0; r < capture->count; r++) {
+        free(capture->record[r].data);
+    }
+    memset(capture, 0, sizeof(*capture));
+}
+
+static bool capture_add(tCapture * capture, uint8_t direction, const uint8_t * data, uint32_t length) {
+    tReplayRecord * record = NULL;
+
+    if (direction == eUsbLogTx) {
+        capture->skipped++;
+        return true;
+    }
+
+    if (capture->count >= REPLAY_MAX_RECORDS) {
+        return false;
+    }
+    record            = &capture->record[capture->count];
+    record->direction = direction;
+    record->length    = length;
+    record->data      = malloc((length > 0) ? length : 1);
+
+    if (record->data == NULL) {
+        return false;
+    }
+    memcpy(record->data, data, length);
+    capture->count++;
+    return true;
+}
+
+static uint32_t read_le32(const uint8_t * p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// The binary log: a run of 16-byte headers each followed by its payload. See usbLog.h.
+static bool load_binary(FILE * file, tCapture * capture) {
+    static uint8_t payload[EXTENDED_MESSAGE_SIZE];
+    uint8_t        header[USB_LOG_HEADER_BYTES];
+
+    while (fread(header, 1, sizeof(header), file) == sizeof(header)) {
+        uint32_t length = read_le32(&header[4]);
+
+        if ((header[0] > eUsbLogRecordEnd) || (length > sizeof(payload))) {
+            fprintf(stderr, "capture: a record that cannot be one — damaged file?\n");
+            return false;
+        }
+
+        if (fread(payload, 1, length, file) != length) {
+            break;    // cut short at the end: the editor stopped mid-write
+        }
+
+        if (header[0] == eUsbLogRecordMessage) {
+            if (capture_add(capture, header[1], payload, length) == false) {
+                return false;
+            }
+        } else if ((header[0] == eUsbLogRecordDropped) && (length >= 8)) {
+            capture->dropped += (uint64_t)read_le32(payload) | ((uint64_t)read_le32(&payload[4]) << 32);
+        } else if (header[0] == eUsbLogRecordText) {
+            capture->skipped++;
+        }
+    }
+    return true;
+}
+
+// The text form: "[time] RX 16 bytes: 21 01 ...". Lines that are not a message are skipped.
+static bool load_text(FILE * file, tCapture * capture) {
+    static char    line[REPLAY_TEXT_LINE];
+    static uint8_t data[EXTENDED_MESSAGE_SIZE];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        const char * p         = strstr(line, "] ");
+        char         name[3]   = {0};
+        unsigned     announced = 0;
+        int          used      = 0;
+        uint32_t     length    = 0;
+        uint8_t      direction = 0;
+
+        if ((p == NULL) || (sscanf(p + 2, "%2s %u bytes:%n", name, &announced, &used) != 2)) {
+            continue;
+        }
+
+        if (strcmp(name, "RX") == 0) {
+            direction = eUsbLogRx;
+        } else if (strcmp(name, "EX") == 0) {
+            direction = eUsbLogExtended;
+        } else if (strcmp(name, "TX") == 0) {
+            direction = eUsbLogTx;
+        } else {
+            capture->skipped++;
+            continue;
+        }
+
+        for (p += 2 + used; length < sizeof(data); ) {
+            unsigned byte = 0;
+            int      step = 0;
+
+            if (sscanf(p, " %2x%n", &byte, &step) != 1) {
+                break;
+            }
+            data[length++]  = (uint8_t)byte;
+            p              += step;
+        }
+
+        if (length != announced) {
+            fprintf(stderr, "capture: a line says %u bytes and has %u\n", announced, (unsigned)length);
+            return false;
+        }
+
+        if (capture_add(capture, direction, data, length) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool load_capture(const char * path, tCapture * capture) {
+    uint8_t magic[USB_LOG_HEADER_BYTES + USB_LOG_MAGIC_BYTES] = {0};
+    FILE *  file                                             = fopen(path, "rb");
+    bool    binary                                           = false;
+    bool    ok                                               = false;
+
+    if (file == NULL) {
+        fprintf(stderr, "capture: cannot open %s\n", path);
+        return false;
+    }
+    binary = (fread(magic, 1, sizeof(magic), file) == sizeof(magic))
+             && (memcmp(&magic[USB_LOG_HEADER_BYTES], USB_LOG_MAGIC, USB_LOG_MAGIC_BYTES) == 0);
+    rewind(file);
+    ok = binary ? load_binary(file, capture) : load_text(file, capture);
+    fclose(file);
+    return ok;
+}
+
+// ── REPLAY ─────────────────────────────────────────────────────────────────────────────────────────
+
+typedef struct {
+    uint64_t messages;
+    uint64_t failures;
+    uint64_t orphans;          // an extended message with no header before it, or the wrong length
+    uint64_t count[256];       // by the sub-command each message answered
+    uint64_t nanos[256];
+} tReplayStats;
+
+// Every record in order, as the receive path would have had them. timed adds each message's parse time
+// to its sub-command.
+static void replay(const tCapture * capture, tReplayStats * stats, bool timed) {
+    int expected = 0;    // the length the last extended header announced
+
+    for (uint32_t r = 0; r < capture->count; r++) {
+        const tReplayRecord * record   = &capture->record[r];
+        int                   result   = EXIT_SUCCESS;
+        int                   response = SUB_RESPONSE_ERROR;
+        int                   length   = 0;
+        uint64_t              began    = timed ? now_nanos() : 0;
+        bool                  parsed   = false;
+
+        if (record->direction == eUsbLogRx) {
+            parsed   = usb_comms_parse_interrupt(record->data, (int)record->length, &result, &response, &length);
+            expected = length;
+            parsed   = parsed && (length == 0);    // a header alone is not a message
+        } else if (record->direction == eUsbLogExtended) {
+            if ((expected == 0) || ((uint32_t)expected != record->length)) {
+                stats->orphans++;
+            }
+            expected = 0;
+            result   = usb_comms_parse_extended(record->data, (int)record->length, &response);
+            parsed   = true;
+        }
+
+        if (parsed == false) {
+            continue;
+        }
+        stats->messages++;
+        stats->failures += (result != EXIT_SUCCESS) ? 1U : 0U;
+
+        if ((response >= 0) && (response < 256)) {
+            stats->count[response]++;
+
+            if (timed == true) {
+                stats->nanos[response] += now_nanos() - began;
+            }
+        }
+    }
+}
+
+static const char * kind_name(int subCommand) {
+    switch (subCommand) {
+        case SUB_RESPONSE_PATCH_DESCRIPTION:
+        {
+            return "patch dump";
+        }
+        case SUB_RESPONSE_PARAM_CHANGE:
+        {
+            return "param change";
+        }
+        case SUB_RESPONSE_VOLUME_INDICATOR:
+        {
+            return "meters";
+        }
+        case SUB_RESPONSE_LED_DATA:
+        {
+            return "LEDs";
+        }
+        default:
+        {
+            return NULL;
+        }
+    }
+}
+
+// The capture `passes` times, timed. Prints messages per second and each kind's cost.
+static void report_throughput(const tCapture * capture, uint32_t passes) {
+    tReplayStats stats = {0};
+    uint64_t     began = now_nanos();
+    double       total = 0.0;
+
+    for (uint32_t p = 0; p < passes; p++) {
+        replay(capture, &stats, true);
+    }
+    total = (double)(now_nanos() - began) / 1e9;
+
+    printf("    %llu messages in %.3f s: %.0f messages/s", (unsigned long long)stats.messages, total,
+           (total > 0.0) ? (double)stats.messages / total : 0.0);
+
+    for (int s = 0; s < 256; s++) {
+        const char * name = kind_name(s);
+
+        if (stats.count[s] == 0) {
+            continue;
+        }
+        printf("   %s %.0f ns", (name != NULL) ? name : "other", (double)stats.nanos[s] / (double)stats.count[s]);
+    }
+    printf("\n");
+}
+
+// ── THE DATABASE ───────────────────────────────────────────────────────────────────────────────────
+
+// One slot's worth of what the parsers write, copied out so the slot can be cleared and refilled.
+typedef struct {
+    tModule     module[locationMax][MAX_NUM_MODULES];
+    tCable      cable[locationMax][MAX_NUM_CABLES];
+    tPatchDescr descr;
+    uint32_t    morphCount;
+} tSlotCopy;
+
+static void copy_slot(uint32_t slot, tSlotCopy * copy) {
+    memset(copy, 0, sizeof(*copy));
+
+    for (uint32_t l = 0; l < locationMax; l++) {
+        for (uint32_t i = 0; i < MAX_NUM_MODULES; i++) {
+            tModule * module = get_module_slot(slot, l, i);
+
+            if ((module != NULL) && (module->active == true)) {
+                memcpy(&copy->module[l][i], module, sizeof(*module));
+            }
+        }
+
+        for (uint32_t i = 0; i < MAX_NUM_CABLES; i++) {
+            tCable * cable = get_cable_slot(slot, l, i);
+
+            if ((cable != NULL) && (cable->active == true)) {
+                copy->cable[l][i] = *cable;
+            }
+        }
+    }
+    copy->descr      = gPatchDescr[slot];
+    copy->morphCount = gMorphCount[slot];
+}
+
+// The first field of `slot` that differs from `want`, said in `where`; false if none does. Only what
+// the patch dump carries is compared — layout, caches and the live meters and LEDs are the UI's.
+static bool slot_differs(uint32_t slot, const tSlotCopy * want, char * where, size_t size) {
+    static tSlotCopy have;
+
+    copy_slot(slot, &have);
+
+    for (uint32_t l = 0; l < locationMax; l++) {
+        for (uint32_t i = 0; i < MAX_NUM_MODULES; i++) {
+            const tModule * a = &want->module[l][i];
+            const tModule * b = &have.module[l][i];
+
+            if (a->active != b->active) {
+                snprintf(where, size, "module %u:%u is %s", l, i, a->active ? "missing" : "extra");
+                return true;
+            }
+
+            if (a->active == false) {
+                continue;
+            }
+
+            if ((a->type != b->type) || (a->row != b->row) || (a->column != b->column) || (a->colour != b->colour)
+                || (a->upRate != b->upRate) || (a->excludeFromMutation != b->excludeFromMutation)
+                || (a->modeCount != b->modeCount)) {
+                snprintf(where, size, "module %u:%u type/position/colour/uprate/modes", l, i);
+                return true;
+            }
+
+            for (uint32_t m = 0; (m < a->modeCount) && (m < MAX_NUM_MODES); m++) {
+                if (a->mode[m].value != b->mode[m].value) {
+                    snprintf(where, size, "module %u:%u mode %u: %u, want %u", l, i, m, b->mode[m].value, a->mode[m].value);
+                    return true;
+                }
+            }
+
+            if (strcmp(a->name, b->name) != 0) {
+                snprintf(where, size, "module %u:%u name '%s', want '%s'", l, i, b->name, a->name);
+                return true;
+            }
+
+            for (uint32_t v = 0; v < NUM_VARIATIONS_USB; v++) {
+                for (uint32_t p = 0; p < MAX_NUM_PARAMETERS; p++) {
+                    if ((a->param[v][p].value != b->param[v][p].value)
+                        || (memcmp(a->param[v][p].morphRange, b->param[v][p].morphRange, sizeof(a->param[v][p].morphRange)) != 0)) {
+                        snprintf(where, size, "module %u:%u variation %u param %u: %u, want %u", l, i, v, p,
+                                 b->param[v][p].value, a->param[v][p].value);
+                        return true;
+                    }
+                }
+            }
+
+            // The dump has no parameter names for the patch settings (push_slot_to_device()).
+            for (uint32_t p = 0; (l != locationMorph) && (p < MAX_NUM_PARAMETERS); p++) {
+                if (a->paramNumLabels[p] != b->paramNumLabels[p]) {
+                    snprintf(where, size, "module %u:%u param %u labels", l, i, p);
+                    return true;
+                }
+
+                for (uint32_t n = 0; (n < a->paramNumLabels[p]) && (n < MAX_NUM_LABELS); n++) {
+                    if (strcmp(a->paramName[p][n], b->paramName[p][n]) != 0) {
+                        snprintf(where, size, "module %u:%u param %u label %u '%s', want '%s'", l, i, p, n,
+                                 b->paramName[p][n], a->paramName[p][n]);
+                        return true;
+                    }
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < MAX_NUM_CABLES; i++) {
+            const tCable * a = &want->cable[l][i];
+            const tCable * b = &have.cable[l][i];
+
+            if ((a->active != b->active)
+                || ((a->active == true) && ((memcmp(&a->key, &b->key, sizeof(a->key)) != 0) || (a->colour != b->colour)))) {
+                snprintf(where, size, "cable %u:%u", l, i);
+                return true;
+            }
+        }
+    }
+
+    if (memcmp(&want->descr, &have.descr, sizeof(want->descr)) != 0) {
+        snprintf(where, size, "patch description");
+        return true;
+    }
+
+    if (want->morphCount != have.morphCount) {
+        snprintf(where, size, "morph count %u, want %u", have.morphCount, want->morphCount);
+        return true;
+    }
+    return false;
+}
+
+// ── MAKING A CAPTURE FROM A PATCH ──────────────────────────────────────────────────────────────────
+
+// A reply as the G2 frames it: the [type][slot][version][sub-command] header is in content already,
+// the CRC is added here. Up to REPLAY_EMBEDDED_MAX bytes go embedded in one interrupt message; more go
+// as an extended header on 0x81 and the message itself on 0x82.
+static bool add_reply(tCapture * capture, const uint8_t * content, uint32_t length) {
+    static uint8_t message[EXTENDED_MESSAGE_SIZE];
+    uint32_t       bitPos = 0;
+
+    if ((length + CRC_BYTES) > sizeof(message)) {
+        return false;
+    }
+
+    if (length <= REPLAY_EMBEDDED_MAX) {
+        uint8_t interrupt[INTERRUPT_MESSAGE_SIZE] = {0};
+
+        write_bit_stream(interrupt, &bitPos, 4, length + CRC_BYTES);
+        write_bit_stream(interrupt, &bitPos, 4, RESPONSE_TYPE_EMBEDDED);
+        memcpy(&interrupt[1], content, length);
+        bitPos = BYTE_TO_BIT(1 + length);
+        write_bit_stream(interrupt, &bitPos, 16, calc_crc16(content, length));
+        return capture_add(capture, eUsbLogRx, interrupt, sizeof(interrupt));
+    }
+    uint8_t header[INTERRUPT_MESSAGE_SIZE] = {0};
+
+    write_bit_stream(header, &bitPos, 4, 0);
+    write_bit_stream(header, &bitPos, 4, RESPONSE_TYPE_EXTENDED);
+    write_bit_stream(header, &bitPos, 16, length + CRC_BYTES);
+
+    memcpy(message, content, length);
+    bitPos = BYTE_TO_BIT(length);
+    write_bit_stream(message, &bitPos, 16, calc_crc16(content, length));
+    return capture_add(capture, eUsbLogRx, header, sizeof(header))
+           && capture_add(capture, eUsbLogExtended, message, length + CRC_BYTES);
+}
+
+static void reply_header(uint8_t * buff, uint32_t * bitPos, uint32_t slot, uint8_t subCommand) {
+    write_bit_stream(buff, bitPos, 8, RESPONSE_TYPE_COMMAND);
+    write_bit_stream(buff, bitPos, 8, COMMAND_SLOT | slot);
+    write_bit_stream(buff, bitPos, 8, 0);
+    write_bit_stream(buff, bitPos, 8, subCommand);
+}
+
+// What a G2 holding `slot`'s patch would send: the dump, then REPLAY_PARAM_CHANGES knob moves (applied
+// to *want as well, since they are part of what the slot must end up holding), then one meter and one
+// LED message.
+static bool make_capture(uint32_t slot, tSlotCopy * want, tCapture * capture) {
+    static uint8_t buff[EXTENDED_MESSAGE_SIZE];
+    uint32_t       bitPos  = 0;
+    uint32_t       changes = 0;
+
+    // The dump is a slot reply whose sub-command is its first section's type, so the header's last byte
+    // is written by write_patch_descr() — the same sections, in the same order, push_slot_to_device()
+    // sends the other way.
+    memset(buff, 0, sizeof(buff));
+    reply_header(buff, &bitPos, slot, 0);
+    bitPos -= 8;
+    write_patch_descr(slot, buff, &bitPos);
+    write_module_list(slot, locationVa, buff, &bitPos);
+    write_module_list(slot, locationFx, buff, &bitPos);
+    write_current_note_2(slot, buff, &bitPos);
+    write_cable_list(slot, locationVa, buff, &bitPos);
+    write_cable_list(slot, locationFx, buff, &bitPos);
+    write_param_list(slot, locationMorph, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationVa, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_param_list(slot, locationFx, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_morph_params(slot, buff, &bitPos, NUM_VARIATIONS_USB);
+    write_knobs(slot, buff, &bitPos);
+    write_controllers(slot, buff, &bitPos);
+    write_param_names(slot, locationVa, buff, &bitPos);
+    write_param_names(slot, locationFx, buff, &bitPos);
+    write_module_names(slot, locationVa, buff, &bitPos);
+    write_module_names(slot, locationFx, buff, &bitPos);
+    write_patch_notes(slot, buff, &bitPos);
+
+    if (add_reply(capture, buff, BIT_TO_BYTE_ROUND_UP(bitPos)) == false) {
+        return false;
+    }
+
+    for (uint32_t l = locationFx; (l <= locationVa) && (changes < REPLAY_PARAM_CHANGES); l++) {
+        for (uint32_t i = 0; (i < MAX_NUM_MODULES) && (changes < REPLAY_PARAM_CHANGES); i++) {
+            tModule * module = &want->module[l][i];
+
+            if ((module->active == false) || (module->actualParamCount == 0)) {
+                continue;
+            }
+            uint32_t param     = changes % module->actualParamCount;
+            uint32_t variation = changes % NUM_VARIATIONS_USB;
+            uint32_t value     = (module->param[variation][param].value + 37U) % 128U;
+
+            bitPos = 0;
+            reply_header(buff, &bitPos, slot, SUB_RESPONSE_PARAM_CHANGE);
+            write_bit_stream(buff, &bitPos, 8, l);
+            write_bit_stream(buff, &bitPos, 8, i);
+            write_bit_stream(buff, &bitPos, 8, param);
+            write_bit_stream(buff, &bitPos, 8, value);
+            write_bit_stream(buff, &bitPos, 8, variation);
+
+            if (add_reply(capture, buff, BIT_TO_BYTE_ROUND_UP(bitPos)) == false) {
+                return false;
+            }
+            module->param[variation][param].value = (uint8_t)value;
+            changes++;
+        }
+    }
+
+    // Meters and LEDs: the values do not matter here (tools/ledbench.c checks where they land), only
+    // that the messages go through the same entry points at the rate the G2 sends them.
+    bitPos = 0;
+    reply_header(buff, &bitPos, slot, SUB_RESPONSE_VOLUME_INDICATOR);
+    write_bit_stream(buff, &bitPos, 8, 0);
+
+    for (uint32_t m = 0; m < 48; m++) {
+        write_bit_stream(buff, &bitPos, 16, (m * 29U) & 0x7f);
+    }
+
+    if (add_reply(capture, buff, BIT_TO_BYTE_ROUND_UP(bitPos)) == false) {
+        return false;
+    }
+    bitPos = 0;
+    reply_header(buff, &bitPos, slot, SUB_RESPONSE_LED_DATA);
+    write_bit_stream(buff, &bitPos, 8, 0);
+
+    for (uint32_t b = 0; b < (LED_STREAM_SIZE / 4); b++) {
+        write_bit_stream(buff, &bitPos, 8, (b * 0x5bU) & 0xff);
+    }
+    return add_reply(capture, buff, BIT_TO_BYTE_ROUND_UP(bitPos));
+}
+
+// The capture through the real logger into a binary file, and as text, for the replays to read back.
+static bool write_capture_files(const tCapture * capture, const char * dir, char * binaryPath, char * textPath,
+                                size_t size) {
+    static const char * kNames[] = {"RX", "TX", "EX"};
+    FILE *              text     = NULL;
+
+    setenv("HOME", dir, 1);
+    snprintf(binaryPath, size, "%s/G2_usb.bin", dir);
+    snprintf(textPath, size, "%s/G2_usb.txt", dir);
+    remove(binaryPath);
+    text = fopen(textPath, "w");
+
+    if (text == NULL) {
+        return false;
+    }
+    usb_log_open();
+
+    for (uint32_t r = 0; r < capture->count; r++) {
+        const tReplayRecord * record = &capture->record[r];
+
+        usb_log_message((tUsbLogDirection)record->direction, (record->direction == eUsbLogExtended) ? 0x82 : 0x81,
+                        record->data, record->length);
+        fprintf(text, "[00:00:00.%03u] %s %u bytes:", (unsigned)(r % 1000), kNames[record->direction % 3],
+                (unsigned)record->length);
+
+        for (uint32_t b = 0; b < record->length; b++) {
+            fprintf(text, " %02x", record->data[b]);
+        }
+        fprintf(text, "\n");
+    }
+    usb_log_close();
+    fclose(text);
+    return true;
+}
+
+static bool run_patch(const char * path, const char * dir, uint32_t passes) {
+    static tSlotCopy want;
+    static tCapture  made;
+    static tCapture  loaded;
+    char             binaryPath[1024];
+    char             textPath[1024];
+    char             where[256]       = {0};
+    const char *     name             = strrchr(path, '/');
+    bool             ok               = true;
+
+    name = (name != NULL) ? name + 1 : path;
+
+    if (g2_plugin_load_patch(path, 0) == false) {
+        printf("%-24s did not load — skipped\n", name);
+        return true;
+    }
+    copy_slot(0, &want);
+    capture_free(&made);
+
+    if ((make_capture(0, &want, &made) == false)
+        || (write_capture_files(&made, dir, binaryPath, textPath, sizeof(binaryPath)) == false)) {
+        printf("%-24s FAIL  could not make its capture\n", name);
+        return false;
+    }
+
+    for (uint32_t format = 0; format < 2; format++) {
+        tReplayStats stats = {0};
+
+        capture_free(&loaded);
+
+        if (load_capture((format == 0) ? binaryPath : textPath, &loaded) == false) {
+            printf("%-24s FAIL  could not read back its %s capture\n", name, (format == 0) ? "binary" : "text");
+            ok = false;
+            continue;
+        }
+        clear_slot_data(0);
+        replay(&loaded, &stats, false);
+
+        // Every record read back, and every message parsed where its header said it would be.
+        bool differs = slot_differs(0, &want, where, sizeof(where));
+        bool arrived = (loaded.count == made.count) && (loaded.dropped == 0) && (stats.failures == 0)
+                       && (stats.orphans == 0);
+        bool good    = (differs == false) && (arrived == true);
+
+        printf("%-24s %-6s %4u records  %llu messages  %s%s\n", name, (format == 0) ? "binary" : "text",
+               (unsigned)loaded.count, (unsigned long long)stats.messages, good ? "ok" : "FAIL  ",
+               differs ? where : (arrived ? "" : "a record lost, or a message did not parse"));
+        ok = ok && good;
+    }
+
+    if (ok == true) {
+        report_throughput(&made, passes);
+    }
+    return ok;
+}
+
+static uint32_t default_patches(char names[][1024], uint32_t max) {
+    DIR *           dir   = opendir("PatchTestFiles");
+    struct dirent * entry = NULL;
+    uint32_t        count = 0;
+
+    if (dir == NULL) {
+        return 0;
+    }
+
+    while (((entry = readdir(dir)) != NULL) && (count < max)) {
+        size_t length = strlen(entry->d_name);
+
+        if ((length > 5) && (strcmp(&entry->d_name[length - 5], ".pch2") == 0)) {
+            snprintf(names[count++], 1024, "PatchTestFiles/%s", entry->d_name);
+        }
+    }
+    closedir(dir);
+    qsort(names, count, 1024, (int (*)(const void *, const void *))strcmp);
+    return count;
+}
+
+// ── A REAL CAPTURE ─────────────────────────────────────────────────────────────────────────────────
+
+static bool run_capture(const char * path, const char * expect, uint32_t slot, uint32_t passes) {
+    static tCapture  capture;
+    static tSlotCopy want;
+    tReplayStats     stats      = {0};
+    char             where[256] = {0};
+    bool             ok         = true;
+
+    if (load_capture(path, &capture) == false) {
+        return false;
+    }
+
+    // What the slot should end up holding is taken from the file first, and the slot emptied again, so
+    // the capture is replayed into the same empty database either way.
+    if (expect != NULL) {
+        if (g2_plugin_load_patch(expect, slot) == false) {
+            printf("%s did not load\n", expect);
+            capture_free(&capture);
+            return false;
+        }
+        copy_slot(slot, &want);
+        clear_slot_data(slot);
+    }
+    replay(&capture, &stats, false);
+
+    printf("%s: %u inbound records, %llu skipped, %llu reported dropped by the logger\n", path,
+           (unsigned)capture.count, (unsigned long long)capture.skipped, (unsigned long long)capture.dropped);
+    printf("    %llu messages, %llu failed to parse, %llu extended messages without a matching header\n",
+           (unsigned long long)stats.messages, (unsigned long long)stats.failures, (unsigned long long)stats.orphans);
+
+    for (uint32_t s = 0; s < MAX_SLOTS; s++) {
+        uint32_t cables = 0;
+
+        for (uint32_t l = 0; l < locationMax; l++) {
+            for (uint32_t i = 0; i < MAX_NUM_CABLES; i++) {
+                tCable * cable = get_cable_slot(s, l, i);
+
+                cables += ((cable != NULL) && (cable->active == true)) ? 1U : 0U;
+            }
+        }
+        printf("    slot %c: %u modules, %u cables\n", 'A' + s, (unsigned)count_active_modules(s), (unsigned)cables);
+    }
+    ok = (stats.failures == 0);
+
+    if (expect != NULL) {
+        bool differs = slot_differs(slot, &want, where, sizeof(where));
+
+        printf("    slot %c against %s: %s%s\n", 'A' + slot, expect, differs ? "FAIL  " : "ok", differs ? where : "");
+        ok = ok && (differs == false);
+    }
+    report_throughput(&capture, passes);
+    capture_free(&capture);
+    return ok;
+}
+
+int main(int argc, char ** argv) {
+    static char  patches[REPLAY_MAX_PATCHES][1024];
+    uint32_t     patchCount = 0;
+    uint32_t     passes     = REPLAY_PASSES;
+    uint32_t     slot       = 0;
+    const char * capture    = NULL;
+    const char * expect     = NULL;
+    char         dir[]      = "/tmp/usbreplay.XXXXXX";
+    bool         ok         = true;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--passes") == 0) && ((i + 1) < argc)) {
+            passes = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--capture") == 0) && ((i + 1) < argc)) {
+            capture = argv[++i];
+        } else if ((strcmp(argv[i], "--expect") == 0) && ((i + 1) < argc)) {
+            expect = argv[++i];
+        } else if ((strcmp(argv[i], "--slot") == 0) && ((i + 1) < argc)) {
+            slot = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if ((argv[i][0] != '-') && (patchCount < REPLAY_MAX_PATCHES)) {
+            snprintf(patches[patchCount++], sizeof(patches[0]), "%s", argv[i]);
+        } else {
+            fprintf(stderr, "usage: %s [--passes N] [patch.pch2 ...]\n"
+                            "       %s --capture FILE [--expect patch.pch2 [--slot N]] [--passes N]\n"
+                            "  Replays G2 traffic through the editor's inbound parsers: made from each patch and\n"
+                            "  checked against it, or recorded (binary log or text) and reported.\n", argv[0], argv[0]);
+            return 126;
+        }
+    }
+
+    if ((slot >= MAX_SLOTS) || ((expect != NULL) && (capture == NULL))) {
+        fprintf(stderr, "%s: --expect goes with --capture, and --slot is 0 to %u\n", argv[0], MAX_SLOTS - 1);
+        return 126;
+    }
+    init_database();
+    register_glfw_wake_cb(no_ui);
+    register_full_patch_change_notify_cb(no_ui);
+
+    if (capture != NULL) {
+        return run_capture(capture, expect, slot, (passes > 0) ? passes : 1) ? 0 : 1;
+    }
+
+    if (patchCount == 0) {
+        patchCount = default_patches(patches, REPLAY_MAX_PATCHES);
+    }
+
+    if (mkdtemp(dir) == NULL) {
+        fprintf(stderr, "%s: no scratch directory\n", argv[0]);
+        return 1;
+    }
+    printf("each patch: its dump, %u parameter changes, a meter and an LED message, replayed from both capture\n"
+           "formats into a cleared slot and compared with the file; then %u timed passes\n\n",
+           REPLAY_PARAM_CHANGES, (unsigned)passes);
+
+    for (uint32_t p = 0; p < patchCount; p++) {
+        ok = run_patch(patches[p], dir, (passes > 0) ? passes : 1) && ok;
+    }
+    char path[1100];
+
+    snprintf(path, sizeof(path), "%s/G2_usb.bin", dir);
+    remove(path);
+    snprintf(path, sizeof(path), "%s/G2_usb.txt", dir);
+    remove(path);
+    rmdir(dir);
+    return ok ? 0 : 1;
+}
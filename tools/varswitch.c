@@ -0,0 +1,537 @@
+/*
+ * varswitch — switch variations every block and check that nothing is rebuilt to do it.
+ *
+ * Copyright (C) 2026 Chris Turner <chris_purusha@icloud.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// WHAT THIS IS FOR.
+//
+// The engine resolves every variation of a slot when it builds it, one snapshot — a lane — each, and a
+// variation switch is then a single store (sound_engine_select_variation() in soundEngine.h). This
+// holds it to that, for every PatchTestFiles/*.pch2:
+//
+//   NO REBUILDS. With a chord held, the variation is switched on every block for two seconds, round all
+//   nine, and sound_engine_lane_builds() must not move. Every block must render finite samples.
+//
+//   THE RIGHT LANE. After switching to each variation, the snapshot being played must be exactly the
+//   one a full build for that variation gives, compared through sound_engine_debug_text(). And the
+//   update that follows the switch, which finds the patch unchanged, may resolve at most one lane of
+//   its own — the selected one, to compare — and one other, to keep it fresh.
+//
+//   EDITS COST THE LANES THEY TOUCH. A parameter that moves the sound is found and edited. Reported
+//   through sound_engine_lane_edited() for a variation not on screen, the next update must resolve
+//   exactly two lanes, that one and the selected one. Written to every variation without being
+//   reported, as a reload or a morph would move them, the next update may resolve at most two, and a
+//   switch to each variation straight after must still play exactly what a full build for it gives.
+//   With one more update between that edit and the switches — the redraw that finds nothing new —
+//   every lane must be caught up ahead of time, and the switches must resolve nothing.
+//
+//   THE CROSSFADE. The same switch, between two variations that play different snapshots, is rendered
+//   with no crossfade and with VARSWITCH_FADE_MS of one (sound_engine_set_variation_crossfade()). Up
+//   to the switch the two renders must be identical, sample for sample: the setting alone changes
+//   nothing. After it they must differ. A patch whose variations differ only in stepped settings has
+//   nothing to glide, and is marked so.
+//
+// A patch whose variations all resolve to the same snapshot passes trivially, and is marked so; the
+// summary says how many did not, and fails if a crossfade changed none of them.
+//
+// Run from the repository root, or name patches. Exits non-zero if any check failed.
+//
+// Build: see tools/do-varswitch. Only libc and libm.
+
+#include <dirent.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "defs.h"
+#include "synthlibDefs.h"
+#include "types.h"
+#include "msgQueue.h"
+#include "undo.h"
+#include "dataBase.h"
+#include "moduleResourcesAccess.h"
+#include "globalVars.h"
+#include "../src/soundEngine.h"
+#include "../vst3/g2Patch.h"
+
+#define VARSWITCH_RATE          (48000.0)
+#define VARSWITCH_BLOCK         (64U)
+#define VARSWITCH_CHANNELS      (2U)
+#define VARSWITCH_SECONDS       (2.0)
+#define VARSWITCH_PATCH_DIR     "PatchTestFiles"
+#define VARSWITCH_MAX_PATCHES   (256U)
+#define VARSWITCH_TEXT          (12288U)
+#define VARSWITCH_EDITED        (1U)         // the variation the reported edit goes to; 0 is on screen
+#define VARSWITCH_FADE_MS       (250U)
+#define VARSWITCH_FADE_AT       (12288U)     // frames held on the first variation; a whole number of blocks
+#define VARSWITCH_FADE_FRAMES   (36864U)     // in all: about half a second after the switch
+#define VARSWITCH_FADE_DIFFERS  (1.0e-4)     // the largest difference after the switch that is "the same"
+
+// As golden.c: loading a patch may report to the undo stack and post to the GUI, and there is neither.
+void msg_send(tMessageQueue * msgQueue, const void * content) {
+    (void)msgQueue;
+    (void)content;
+}
+
+void undo_push_param_change(tModuleKey key, uint32_t paramIndex, uint32_t variation, uint32_t oldValue, uint32_t newValue) {
+    (void)key;
+    (void)paramIndex;
+    (void)variation;
+    (void)oldValue;
+    (void)newValue;
+}
+
+static const int32_t kChord[] = {48, 55, 60, 64};
+
+static float gBlock[VARSWITCH_BLOCK * VARSWITCH_CHANNELS];
+static float gFade[3][VARSWITCH_FADE_FRAMES * VARSWITCH_CHANNELS];
+
+static bool has_suffix(const char * name, const char * suffix) {
+    size_t n = strlen(name);
+    size_t s = strlen(suffix);
+
+    return (n >= s) && (strcmp(name + n - s, suffix) == 0);
+}
+
+static int compare_names(const void * a, const void * b) {
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+// The engine's listing of the snapshot being played, less its first line, which carries the status,
+// the variation on screen and a peak that reading resets — none of them part of the snapshot.
+static void played_snapshot(char * text) {
+    const char * listing = sound_engine_debug_text();
+    const char * nodes   = strchr(listing, '\n');
+
+    snprintf(text, VARSWITCH_TEXT, "%s", (nodes != NULL) ? nodes : "");
+}
+
+static bool render_block(void) {
+    sound_engine_render(gBlock, VARSWITCH_BLOCK, VARSWITCH_CHANNELS);
+
+    for (uint32_t i = 0; i < (VARSWITCH_BLOCK * VARSWITCH_CHANNELS); i++) {
+        if (isfinite(gBlock[i]) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void start(void) {
+    gPatchDescr[0].activeVariation = 0;
+    sound_engine_start_hosted(VARSWITCH_RATE);
+    sound_engine_pitch_bend(0.0);
+    sound_engine_update_from_patch();
+
+    for (uint32_t k = 0; k < (sizeof(kChord) / sizeof(kChord[0])); k++) {
+        sound_engine_note(kChord[k], true);
+    }
+}
+
+static void stop(void) {
+    sound_engine_note(-1, false);
+    sound_engine_stop_hosted();
+}
+
+// A value one step from `value`, and still in range for any parameter that has more than one.
+static uint8_t nudged(uint8_t value) {
+    return (value == 0) ? 1 : (uint8_t)(value - 1);
+}
+
+// Resolves the snapshot for whichever variation is on screen, and lists it.
+static void built_snapshot(uint32_t variation, char * text) {
+    gPatchDescr[0].activeVariation = variation;
+    sound_engine_update_from_patch();
+    played_snapshot(text);
+}
+
+// The edit checks. A patch in which no parameter of variation 0 moves the snapshot has nothing to edit,
+// and passes; *found says whether one was.
+static uint32_t check_edits(const char * path, bool * found) {
+    static char    before[VARSWITCH_TEXT];
+    static char    switched[NUM_VARIATIONS][VARSWITCH_TEXT];
+    static char    built[VARSWITCH_TEXT];
+    static uint8_t saved[NUM_VARIATIONS];
+    tModule *      module   = NULL;
+    uint32_t       param    = 0;
+    uint32_t       failures = 0;
+    uint64_t       lanes    = 0;
+
+    *found = false;
+    built_snapshot(0, before);
+
+    for (uint32_t i = 0; (i < MAX_NUM_MODULES) && (*found == false); i++) {
+        tModule * candidate = get_module_slot(0, (uint32_t)locationVa, i);
+
+        if (candidate->active == false) {
+            continue;
+        }
+
+        for (uint32_t p = 0; (p < module_param_count(candidate->type)) && (*found == false); p++) {
+            uint8_t value = candidate->param[0][p].value;
+
+            candidate->param[0][p].value = nudged(value);
+            built_snapshot(0, built);
+            candidate->param[0][p].value = value;
+
+            if (strcmp(before, built) != 0) {
+                module = candidate;
+                param  = p;
+                *found = true;
+            }
+        }
+    }
+
+    if (module == NULL) {
+        return 0;
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        saved[v] = module->param[v][param].value;
+    }
+    built_snapshot(0, before);
+
+    // Reported, to a variation not on screen.
+    module->param[VARSWITCH_EDITED][param].value = nudged(saved[VARSWITCH_EDITED]);
+    sound_engine_lane_edited(0, VARSWITCH_EDITED);
+    lanes = sound_engine_lane_builds();
+    sound_engine_update_from_patch();
+    lanes = sound_engine_lane_builds() - lanes;
+
+    if (lanes != 2) {
+        printf("  %s: the update after an edit to variation %u resolved %llu lanes, expected 2\n",
+               path, (unsigned)VARSWITCH_EDITED, (unsigned long long)lanes);
+        failures++;
+    }
+    sound_engine_select_variation(0, VARSWITCH_EDITED);
+    played_snapshot(switched[0]);
+    built_snapshot(VARSWITCH_EDITED, built);
+
+    if (strcmp(switched[0], built) != 0) {
+        printf("  %s: variation %u plays a different snapshot after an edit and a switch than after a build\n",
+               path, (unsigned)VARSWITCH_EDITED);
+        failures++;
+    }
+
+    // Unreported, to every variation.
+    built_snapshot(0, before);
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        module->param[v][param].value = nudged(module->param[v][param].value);
+    }
+    lanes = sound_engine_lane_builds();
+    sound_engine_update_from_patch();
+    lanes = sound_engine_lane_builds() - lanes;
+
+    if (lanes > 2) {
+        printf("  %s: the update after an edit to every variation resolved %llu lanes, expected at most 2\n",
+               path, (unsigned long long)lanes);
+        failures++;
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        sound_engine_select_variation(0, v);
+        played_snapshot(switched[v]);
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        built_snapshot(v, built);
+
+        if (strcmp(switched[v], built) != 0) {
+            printf("  %s: variation %u plays a different snapshot after an unreported edit and a switch than after a build\n",
+                   path, (unsigned)v);
+            failures++;
+        }
+    }
+
+    // Unreported once more, from where the search found it moves the sound, but with a redraw that
+    // finds nothing new between the edit and the switches, as there nearly always is when a person
+    // makes them. That idle update must catch every lane up, so that each switch is the store alone.
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        module->param[v][param].value = saved[v];
+    }
+    built_snapshot(0, before);
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        module->param[v][param].value = nudged(saved[v]);
+    }
+    sound_engine_update_from_patch();
+    sound_engine_update_from_patch();
+    lanes = sound_engine_lane_builds();
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        sound_engine_select_variation(0, v);
+        played_snapshot(switched[v]);
+    }
+    lanes = sound_engine_lane_builds() - lanes;
+
+    if (lanes != 0) {
+        printf("  %s: switching after an idle update resolved %llu lanes, expected none\n",
+               path, (unsigned long long)lanes);
+        failures++;
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        built_snapshot(v, built);
+
+        if (strcmp(switched[v], built) != 0) {
+            printf("  %s: variation %u plays a different snapshot after an idle update and a switch than after a build\n",
+                   path, (unsigned)v);
+            failures++;
+        }
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        module->param[v][param].value = saved[v];
+    }
+    built_snapshot(0, built);
+
+    return failures;
+}
+
+// One take of the crossfade check: the chord held on variation 0, then switched to `to`, with a
+// crossfade of `ms`. False if a sample was not finite.
+static bool render_switch(uint32_t to, uint32_t ms, float * out) {
+    const uint32_t at = VARSWITCH_FADE_AT;
+    bool           ok = true;
+
+    sound_engine_set_variation_crossfade((double)ms * 1.0e-3);
+    start();
+
+    for (uint32_t frame = 0; frame < VARSWITCH_FADE_FRAMES; frame += VARSWITCH_BLOCK) {
+        uint32_t count = ((frame + VARSWITCH_BLOCK) > VARSWITCH_FADE_FRAMES) ? (VARSWITCH_FADE_FRAMES - frame) : VARSWITCH_BLOCK;
+
+        if (frame == at) {
+            sound_engine_select_variation(0, to);
+        }
+        sound_engine_render(&out[frame * VARSWITCH_CHANNELS], count, VARSWITCH_CHANNELS);
+    }
+    stop();
+    sound_engine_set_variation_crossfade(0.0);
+
+    for (uint32_t i = 0; i < (VARSWITCH_FADE_FRAMES * VARSWITCH_CHANNELS); i++) {
+        ok = ok && (isfinite(out[i]) != 0);
+    }
+    return ok;
+}
+
+// The largest difference between two takes over [from, to) frames.
+static double take_difference(const float * a, const float * b, uint32_t from, uint32_t to) {
+    double worst = 0.0;
+
+    for (uint32_t i = from * VARSWITCH_CHANNELS; i < (to * VARSWITCH_CHANNELS); i++) {
+        worst = fmax(worst, fabs((double)a[i] - (double)b[i]));
+    }
+    return worst;
+}
+
+// The crossfade check, on the first variation that plays a different snapshot from variation 0. *faded
+// says whether the crossfade changed the switch; a patch whose variations all play alike, or whose
+// renders are not repeatable, has nothing to show and passes.
+static uint32_t check_crossfade(const char * path, bool * faded) {
+    static char    first[VARSWITCH_TEXT];
+    static char    other[VARSWITCH_TEXT];
+    const uint32_t at       = VARSWITCH_FADE_AT;
+    uint32_t       to       = NUM_VARIATIONS;
+    uint32_t       failures = 0;
+
+    *faded = false;
+    start();
+    sound_engine_select_variation(0, 0);
+    played_snapshot(first);
+
+    for (uint32_t v = 1; (v < NUM_VARIATIONS) && (to == NUM_VARIATIONS); v++) {
+        sound_engine_select_variation(0, v);
+        played_snapshot(other);
+
+        if (strcmp(first, other) != 0) {
+            to = v;
+        }
+    }
+    stop();
+
+    if (to == NUM_VARIATIONS) {
+        return 0;
+    }
+
+    if ((render_switch(to, 0, gFade[0]) == false) || (render_switch(to, 0, gFade[1]) == false)
+        || (render_switch(to, VARSWITCH_FADE_MS, gFade[2]) == false)) {
+        printf("  %s: the switch to variation %u rendered a non-finite sample\n", path, (unsigned)to);
+        return 1;
+    }
+
+    if (take_difference(gFade[0], gFade[1], 0, VARSWITCH_FADE_FRAMES) != 0.0) {
+        return 0;
+    }
+
+    if (take_difference(gFade[0], gFade[2], 0, at) != 0.0) {
+        printf("  %s: a crossfade changed the sound before any switch\n", path);
+        failures++;
+    }
+    *faded = take_difference(gFade[0], gFade[2], at, VARSWITCH_FADE_FRAMES) > VARSWITCH_FADE_DIFFERS;
+
+    return failures;
+}
+
+// All the checks on one patch. *differs says whether any two of its variations play different
+// snapshots, *edited whether it had a parameter for the edit checks, *faded whether a crossfade
+// changed a switch.
+static uint32_t check_patch(const char * path, bool * differs, bool * edited, bool * faded) {
+    static char    first[VARSWITCH_TEXT];
+    static char    switched[VARSWITCH_TEXT];
+    static char    built[VARSWITCH_TEXT];
+    const uint32_t blocks   = (uint32_t)((VARSWITCH_SECONDS * VARSWITCH_RATE) / VARSWITCH_BLOCK);
+    uint32_t       failures = 0;
+    uint64_t       before   = 0;
+    uint64_t       after    = 0;
+
+    *differs = false;
+    start();
+    before = sound_engine_lane_builds();
+
+    for (uint32_t b = 0; b < blocks; b++) {
+        sound_engine_select_variation(0, b % NUM_VARIATIONS);
+
+        if (render_block() == false) {
+            printf("  %s: block %u rendered a non-finite sample\n", path, (unsigned)b);
+            failures++;
+            break;
+        }
+    }
+    after = sound_engine_lane_builds();
+
+    if (after != before) {
+        printf("  %s: %llu lanes resolved while switching, expected none\n", path,
+               (unsigned long long)(after - before));
+        failures++;
+    }
+
+    for (uint32_t v = 0; v < NUM_VARIATIONS; v++) {
+        // Back to variation 0 as the UI has it, then switch the engine alone...
+        gPatchDescr[0].activeVariation = 0;
+        sound_engine_update_from_patch();
+        sound_engine_select_variation(0, v);
+        played_snapshot(switched);
+
+        if (v == 0) {
+            snprintf(first, sizeof(first), "%s", switched);
+        } else if (strcmp(first, switched) != 0) {
+            *differs = true;
+        }
+
+        // ...then let the UI catch up, which is what a click on a variation button does next.
+        before                         = sound_engine_lane_builds();
+        gPatchDescr[0].activeVariation = v;
+        sound_engine_update_from_patch();
+        after                          = sound_engine_lane_builds();
+        played_snapshot(built);
+
+        if (strcmp(switched, built) != 0) {
+            printf("  %s: variation %u plays a different snapshot after a switch than after a build\n",
+                   path, (unsigned)v);
+            failures++;
+        }
+
+        if ((after - before) > 2) {
+            printf("  %s: the update after switching to variation %u resolved %llu lanes, expected at most 2\n",
+                   path, (unsigned)v, (unsigned long long)(after - before));
+            failures++;
+        }
+    }
+    failures += check_edits(path, edited);
+    stop();
+    failures += check_crossfade(path, faded);
+
+    return failures;
+}
+
+int main(int argc, char ** argv) {
+    char *   names[VARSWITCH_MAX_PATCHES];
+    uint32_t count    = 0;
+    uint32_t failures = 0;
+    uint32_t differ   = 0;
+    uint32_t editable = 0;
+    uint32_t fadeable = 0;
+
+    for (int i = 1; (i < argc) && (count < VARSWITCH_MAX_PATCHES); i++) {
+        if (argv[i][0] == '-') {
+            fprintf(stderr, "usage: %s [patch.pch2 ...]\n"
+                            "  Switches variations every block and checks nothing is rebuilt.\n", argv[0]);
+            return 126;
+        }
+        names[count++] = strdup(argv[i]);
+    }
+
+    if (count == 0) {
+        DIR *           handle = opendir(VARSWITCH_PATCH_DIR);
+        struct dirent * entry  = NULL;
+
+        if (handle != NULL) {
+            while (((entry = readdir(handle)) != NULL) && (count < VARSWITCH_MAX_PATCHES)) {
+                if (has_suffix(entry->d_name, ".pch2")) {
+                    char * full = malloc(strlen(VARSWITCH_PATCH_DIR) + strlen(entry->d_name) + 2);
+
+                    sprintf(full, "%s/%s", VARSWITCH_PATCH_DIR, entry->d_name);
+                    names[count++] = full;
+                }
+            }
+            closedir(handle);
+        }
+        qsort(names, count, sizeof(names[0]), compare_names);
+    }
+
+    if (count == 0) {
+        fprintf(stderr, "varswitch: no patches (run from the repository root, or name them)\n");
+        return 126;
+    }
+
+    for (uint32_t p = 0; p < count; p++) {
+        bool     differs = false;
+        bool     edited  = false;
+        bool     faded   = false;
+        uint32_t failed  = 0;
+
+        if (g2_plugin_load_patch(names[p], 0) == false) {
+            printf("%-40s not loadable, skipped\n", names[p]);
+            continue;
+        }
+        failed    = check_patch(names[p], &differs, &edited, &faded);
+        failures += failed;
+        differ   += differs ? 1 : 0;
+        editable += edited ? 1 : 0;
+        fadeable += faded ? 1 : 0;
+        printf("%-40s %s%s%s%s\n", names[p], (failed == 0) ? "ok" : "FAILED",
+               differs ? "" : "   (its variations all play alike)",
+               edited ? "" : "   (no parameter in it to edit)",
+               (differs && !faded) ? "   (nothing in its switch to crossfade)" : "");
+    }
+    if ((differ > 0) && (fadeable == 0)) {
+        printf("\nno switch was changed by a crossfade\n");
+        failures++;
+    }
+    printf("\n%u patches, %u with variations that differ, %u with a parameter to edit, %u with a switch "
+           "a crossfade changed, %u failures\n",
+           (unsigned)count, (unsigned)differ, (unsigned)editable, (unsigned)fadeable, (unsigned)failures);
+
+    for (uint32_t p = 0; p < count; p++) {
+        free(names[p]);
+    }
+    return (failures > 0) ? 1 : 0;
+}
@@ -59,6 +59,7 @@
 
 extern "C" {
 #include "soundEngine.h"
+#include "rtLog.h"
 #include "g2Patch.h"
 #include "noteStack.h"
 }
@@ -93,6 +94,16 @@ static std::string default_patch_path(void) {
     return std::string(home ? home : ".") + "/Documents/G2-Edit/plugin.pch2";
 }
 
+// The FX pipeline (see soundEngine.h) is opt-in, by $G2_VST3_FX_PIPELINE=1 for now. It trades a
+// block of latency for running the FX Area on a second core, which is only worth it on a patch heavy
+// enough to be short of time — and the host has to be told, so the choice belongs to whoever is
+// setting up the session rather than being made silently.
+static bool fx_pipeline_wanted(void) {
+    const char * env = getenv("G2_VST3_FX_PIPELINE");
+
+    return (env != nullptr) && (env[0] == '1');
+}
+
 // A MORPH DOES NOT REACH THE AUDIO THREAD BY ITSELF, and this flag is how the plug-in copes.
 //
 // sound_engine_set_morph() only records the position. Unlike pitch bend, which the audio thread
@@ -111,6 +122,10 @@ static std::string default_patch_path(void) {
 // the only writer.
 static std::atomic<bool> gMorphSnapshotDirty{false};
 
+// Whether this thread has claimed its rt_log ring: per thread, since a host may call process() from
+// more than one.
+static thread_local bool gAudioThreadLogs = false;
+
 // Processor and controller are SEPARATE CLASSES, both registered with the factory.
 //
 // VST3 also permits one object to implement both, and that is what this was — it is simpler, and a
@@ -121,7 +136,7 @@ static std::atomic<bool> gMorphSnapshotDirty{false};
 // expects, so it is the shape used here.
 class G2EditPlugin : public IComponent, public IAudioProcessor {
 public:
-    G2EditPlugin(void) : refCount(1), sampleRate(44100.0), active(false) {
+    G2EditPlugin(void) : refCount(1), sampleRate(44100.0), active(false), auxActive(false) {
         // params[] otherwise zero-initialises, and zero is FULL BEND DOWN rather than centre. It
         // would only be read back, not applied — nothing calls the engine until the host sends a
         // value — but a plug-in reporting a two-semitone-flat bend it is not applying is a trap.
@@ -161,12 +176,14 @@ public:
         if (patchPath.empty()) {
             patchPath = default_patch_path();
         }
+        rt_log_start();     // counted, so every instance in the host can start and stop it
         load_patch();
         return kResultOk;
     }
 
     tresult PLUGIN_API terminate(void) SMTG_OVERRIDE {
         sound_engine_stop_hosted();
+        rt_log_stop();
         return kResultOk;
     }
 
@@ -185,7 +202,7 @@ public:
 
     int32 PLUGIN_API getBusCount(MediaType type, BusDirection dir) SMTG_OVERRIDE {
         if ((type == kAudio) && (dir == kOutput)) {
-            return 1;               // one stereo out
+            return 2;               // Out 1/2 as the main bus, Out 3/4 as an aux the host may switch on
         }
 
         if ((type == kEvent) && (dir == kInput)) {
@@ -205,6 +222,19 @@ public:
             return kResultOk;
         }
 
+        // Off until the host switches it on, because a patch that sends anything to Out 3/4 has to
+        // keep sounding in a project that only listens to the main bus — so while it is off, the main
+        // bus carries both pairs summed, exactly as the application's stereo device does.
+        if ((type == kAudio) && (dir == kOutput) && (index == 1)) {
+            bus.mediaType    = kAudio;
+            bus.direction    = kOutput;
+            bus.channelCount = 2;
+            bus.busType      = kAux;
+            bus.flags        = 0;
+            copy_name(bus.name, "Out 3/4");
+            return kResultOk;
+        }
+
         if ((type == kEvent) && (dir == kInput) && (index == 0)) {
             bus.mediaType    = kEvent;
             bus.direction    = kInput;
@@ -224,10 +254,10 @@ public:
     }
 
     tresult PLUGIN_API activateBus(MediaType type, BusDirection dir, int32 index, TBool state) SMTG_OVERRIDE {
-        (void)type;
-        (void)dir;
-        (void)index;
-        (void)state;
+        // Called with processing stopped, so process() never sees this change under it.
+        if ((type == kAudio) && (dir == kOutput) && (index == 1)) {
+            auxActive = (state != 0);
+        }
         return kResultOk;
     }
 
@@ -284,14 +314,15 @@ public:
                                           SpeakerArrangement * outputs, int32 numOuts) SMTG_OVERRIDE {
         (void)inputs;
 
-        if ((numIns == 0) && (numOuts == 1) && (outputs[0] == SpeakerArr::kStereo)) {
+        if ((numIns == 0) && (numOuts >= 1) && (numOuts <= 2) && (outputs[0] == SpeakerArr::kStereo)
+            && ((numOuts == 1) || (outputs[1] == SpeakerArr::kStereo))) {
             return kResultOk;
         }
         return kResultFalse;
     }
 
     tresult PLUGIN_API getBusArrangement(BusDirection dir, int32 index, SpeakerArrangement & arr) SMTG_OVERRIDE {
-        if ((dir == kOutput) && (index == 0)) {
+        if ((dir == kOutput) && ((index == 0) || (index == 1))) {
             arr = SpeakerArr::kStereo;
             return kResultOk;
         }
@@ -303,13 +334,21 @@ public:
         return (symbolicSampleSize == kSample32) ? kResultTrue : kResultFalse;
     }
 
+    // Zero unless the FX pipeline is on, in which case it is the host's largest block — see
+    // setupProcessing(). A host reads this after setupProcessing() and compensates for it.
     uint32 PLUGIN_API getLatencySamples(void) SMTG_OVERRIDE {
-        return 0;
+        return sound_engine_latency_frames();
     }
 
     tresult PLUGIN_API setupProcessing(ProcessSetup & setup) SMTG_OVERRIDE {
         sampleRate = setup.sampleRate;
         sound_engine_set_sample_rate(sampleRate);
+
+        // Always called inactive, which is when the engine accepts this. The latency is the largest
+        // block the host will send, capped at what process() renders in one go anyway.
+        int32 block = (setup.maxSamplesPerBlock > kMaxBlock) ? kMaxBlock : setup.maxSamplesPerBlock;
+
+        (void)sound_engine_set_fx_pipeline(fx_pipeline_wanted(), (block > 0) ? (uint32_t)block : (uint32_t)kMaxBlock);
         return kResultOk;
     }
 
@@ -323,6 +362,13 @@ public:
     }
 
     tresult PLUGIN_API process(ProcessData & data) SMTG_OVERRIDE {
+        // The host's audio thread — or threads: some render offline on another. Each claims its own
+        // ring, the first time only, and gives it back when the host ends the thread. See rtLog.h.
+        if (gAudioThreadLogs == false) {
+            gAudioThreadLogs = true;
+            (void)rt_log_register_thread("audio");
+        }
+
         // Automation, before anything is rendered. Only the LAST point in each queue is taken: the
         // engine has no notion of a parameter ramping within a block, so interpolating between
         // points would be inventing a resolution it cannot use. Same block-granularity trade as the
@@ -413,30 +459,49 @@ public:
             return kResultOk;
         }
         float ** out = data.outputs[0].channelBuffers32;
+        float ** aux = (data.numOutputs >= 2) && (data.outputs[1].numChannels >= 2)
+                       ? data.outputs[1].channelBuffers32 : nullptr;
 
         if ((out == nullptr) || (out[0] == nullptr) || (out[1] == nullptr)) {
             return kResultOk;
         }
-        // sound_engine_render() writes INTERLEAVED frames; VST3 hands us one buffer per channel, so
-        // it renders into a scratch block and is de-interleaved out. The block is bounded by
-        // kMaxBlock and looped, so an unusually large buffer size cannot overrun it.
-        int32 done = 0;
+
+        // Straight into the host's buffers, one per channel: four when the aux bus is on, so each
+        // pair of the G2's outputs goes to its own bus, and two otherwise, with the pairs summed.
+        // Rendered in pieces of at most kMaxBlock, the most the FX pipeline was set up for.
+        bool     separate = auxActive && (aux != nullptr) && (aux[0] != nullptr) && (aux[1] != nullptr);
+        uint32_t count    = separate ? 4 : 2;
+        int32    done     = 0;
 
         while (done < data.numSamples) {
-            int32 chunk = data.numSamples - done;
+            int32   chunk   = data.numSamples - done;
+            float * outs[4] = {out[0] + done, out[1] + done, nullptr, nullptr};
 
             if (chunk > kMaxBlock) {
                 chunk = kMaxBlock;
             }
-            sound_engine_render(scratch, (uint32_t)chunk, 2);
 
-            for (int32 i = 0; i < chunk; i++) {
-                out[0][done + i] = scratch[i * 2];
-                out[1][done + i] = scratch[i * 2 + 1];
+            if (separate) {
+                outs[2] = aux[0] + done;
+                outs[3] = aux[1] + done;
             }
+            sound_engine_render_planar(outs, count, (uint32_t)chunk);
             done += chunk;
         }
         data.outputs[0].silenceFlags = 0;
+
+        // An aux bus the host handed buffers for but has not switched on is given silence, not
+        // whatever its buffers held.
+        if ((aux != nullptr) && !separate) {
+            for (int32 c = 0; c < 2; c++) {
+                if (aux[c] != nullptr) {
+                    memset(aux[c], 0, (size_t)data.numSamples * sizeof(float));
+                }
+            }
+            data.outputs[1].silenceFlags = 3;
+        } else if (separate) {
+            data.outputs[1].silenceFlags = 0;
+        }
         return kResultOk;
     }
 
@@ -520,8 +585,8 @@ private:
     ParamValue         params[kNumParams] = {0};
     double             sampleRate;
     bool               active;
+    bool               auxActive;    // the Out 3/4 bus; see getBusInfo()
     std::string        patchPath;
-    float              scratch[kMaxBlock * 2];
 };
 
 